@@ -79,6 +79,14 @@ typedef struct EbBufferHeaderType
     uint32_t qp;
     uint32_t pic_type;
 
+    // pic effort, set with speed_control_flag 2
+    uint32_t effort_level;      // effort reduction of the picture, 0 for none
+    uint32_t late_sb_count;     // SBs coded at the lowest effort to meet the deadline
+
+    // pic encode pass reuse of the mode decision luma, 8-bit only
+    uint32_t luma_txb_count;        // luma transform blocks coded by the encode pass
+    uint32_t reused_luma_txb_count; // of which committed from mode decision
+
     // pic flags
     uint32_t flags;
 } EbBufferHeaderType;
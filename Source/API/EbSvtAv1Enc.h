@@ -12,6 +12,7 @@ extern "C" {
 
 #include "stdint.h"
 #include "EbSvtAv1.h"
+#include "EbSvtAv1ExtFrameBuf.h"
 
 #define  TILES    1
 
@@ -231,6 +232,13 @@ typedef struct EbSvtAv1EncConfiguration
     * Default is 1. */
     EbBool                   in_loop_me_flag;
 
+    /* Flag to let the encode pass reuse the luma transform results of mode
+    * decision when it builds the same prediction. The bitstream is the same
+    * either way.
+    *
+    * Default is 1. */
+    EbBool                   md_recon_cache_flag;
+
     // ME Parameters
     /* Number of search positions in the horizontal direction.
      *
@@ -329,6 +337,11 @@ typedef struct EbSvtAv1EncConfiguration
     * encoding speed defined by dynamically changing the encoding preset to meet
     * the average speed defined in injectorFrameRate. When this parameter is set
     * to 1 it forces -inj to be 1 -inj-frm-rt to be set to the -fps.
+    * When set to 2 the pictures are output by a deadline derived from
+    * frame_rate: the preset is kept and the effort within it (NFL, NSQ, ME
+    * search area, CDEF and restoration search) is lowered when the encoder
+    * falls behind and raised again when it catches up. The effort of each
+    * picture is reported in the output buffer headers.
     *
     * Default is 0. */
     uint32_t                 speed_control_flag;
@@ -355,8 +368,36 @@ typedef struct EbSvtAv1EncConfiguration
      * Default is -1. */
     int32_t                 target_socket;
 
+    /* Threading of the picture analysis, motion estimation, encdec, deblocking,
+     * cdef, restoration and entropy coding stages.
+     *
+     * 0 = Each stage runs its own fixed set of threads.
+     * 1 = The stages run as tasks on one work-stealing pool of
+     *     logical_processors threads.
+     *
+     * Default is 0. */
+    uint32_t                thread_pool_mode;
+
+    // Memory management
+
+    /* Construct the picture control sets, reference pictures and pipeline
+     * results on demand instead of at init. Each pool starts with a few objects
+     * and grows, when the encoder runs out of them, up to the size derived from
+     * the frame rate and look_ahead_distance. See eb_svt_enc_get_memory_usage().
+     * Set through LazyPools (-lazy-pools).
+     *
+     * Default is 0. */
+    EbBool                  lazy_pool_allocation;
+
     // Debug tools
 
+    /* Instrument the pipeline: per-picture timestamps of every stage, fifo
+     * depths and thread busy time, see eb_svt_enc_get_stats() and
+     * eb_svt_enc_write_trace(). Set through PipelineStats (-pipeline-stats).
+     *
+     * Default is 0. */
+    EbBool                  enable_pipeline_stats;
+
     /* Output reconstructed yuv used for debug purposes. The value is set through
      * ReconFile token (-o) and using the feature will affect the speed of encoder.
      *
@@ -409,6 +450,141 @@ typedef struct EbSvtAv1EncConfiguration
 
 } EbSvtAv1EncConfiguration;
 
+#define EB_MAX_STAGE_UTILIZATION_COUNT  8
+
+    /* Utilization counters of one pipeline stage, see
+     * eb_svt_enc_get_stage_utilization(). The busy time of a stage divided by
+     * the wall time is the average number of its contexts doing work. */
+    typedef struct EbStageUtilization
+    {
+        const char              *stage_name;
+
+        // Number of threads (thread_pool_mode 0) or contexts (thread_pool_mode 1)
+        uint32_t                 context_count;
+
+        // Objects processed by the stage
+        uint64_t                 task_count;
+
+        // Time spent processing, summed over the contexts
+        uint64_t                 busy_time_us;
+
+        // Time since the encoder was initialized
+        uint64_t                 wall_time_us;
+
+        // Tasks delayed because every context of the stage was busy
+        uint64_t                 starved_count;
+
+    } EbStageUtilization;
+
+#define EB_MAX_PIPELINE_STAGE_COUNT     16
+#define EB_MAX_PIPELINE_THREAD_COUNT    256
+
+    /* Counters of one pipeline stage, see eb_svt_enc_get_stats(). An object is
+     * processed from the time a thread takes it from the input fifo of the
+     * stage until the thread waits for its next input. */
+    typedef struct EbPipelineStageStats
+    {
+        const char              *stage_name;
+
+        // Objects taken from the input fifo
+        uint64_t                 object_count;
+
+        // Wall time spent processing the objects, without the time spent in
+        // objects of other stages run meanwhile by the same thread
+        uint64_t                 processing_time_us;
+        uint64_t                 processing_time_max_us;
+
+        // CPU time of the threads processing the objects, counted the same
+        // way; unlike the wall time it excludes preemption and blocking
+        uint64_t                 cpu_time_us;
+
+        // Time the objects spent in the input fifo
+        uint64_t                 queue_time_us;
+        uint64_t                 queue_time_max_us;
+
+        // Objects in the input fifo now, and the most seen at once
+        uint32_t                 fifo_depth;
+        uint32_t                 fifo_depth_max;
+
+    } EbPipelineStageStats;
+
+    /* Time split of one encoder thread, see eb_svt_enc_get_stats(). */
+    typedef struct EbPipelineThreadStats
+    {
+        // Stage of the objects processed by the thread, "Pool" when the
+        // thread served several stages
+        const char              *stage_name;
+
+        // Processing objects
+        uint64_t                 busy_time_us;
+
+        // Waiting for an input object
+        uint64_t                 idle_time_us;
+
+        // Waiting for an empty object of a downstream stage
+        uint64_t                 blocked_time_us;
+
+    } EbPipelineThreadStats;
+
+    /* Pipeline counters, see eb_svt_enc_get_stats(). */
+    typedef struct EbSvtEncStats
+    {
+        // Time since the encoder was initialized
+        uint64_t                 wall_time_us;
+
+        uint32_t                 stage_count;
+        EbPipelineStageStats     stage_array[EB_MAX_PIPELINE_STAGE_COUNT];
+
+        // Threads that processed at least one object
+        uint32_t                 thread_count;
+        EbPipelineThreadStats    thread_array[EB_MAX_PIPELINE_THREAD_COUNT];
+
+    } EbSvtEncStats;
+
+#define EB_MAX_MEMORY_POOL_COUNT        32
+#define EB_MAX_MEMORY_TYPE_COUNT        32
+
+    /* Memory committed by one pool of the encoder, see
+     * eb_svt_enc_get_memory_usage(). */
+    typedef struct EbMemoryPoolUsage
+    {
+        const char              *pool_name;
+
+        // Objects constructed so far, and the size the pool can grow to
+        uint32_t                 object_count;
+        uint32_t                 object_max_count;
+
+        // Bytes allocated by the constructed objects
+        uint64_t                 committed_bytes;
+
+    } EbMemoryPoolUsage;
+
+    /* Memory committed by the allocations of one type, e.g.
+     * "EbPictureBufferDesc_t*". */
+    typedef struct EbMemoryTypeUsage
+    {
+        const char              *type_name;
+        uint64_t                 allocation_count;
+        uint64_t                 committed_bytes;
+
+    } EbMemoryTypeUsage;
+
+    typedef struct EbSvtMemoryUsage
+    {
+        // Bytes allocated by the encoder instance, pools included, and
+        // bytes mapped to serve them
+        uint64_t                 total_committed_bytes;
+        uint64_t                 total_reserved_bytes;
+
+        uint32_t                 pool_count;
+        EbMemoryPoolUsage        pool_array[EB_MAX_MEMORY_POOL_COUNT];
+
+        // Biggest types first
+        uint32_t                 type_count;
+        EbMemoryTypeUsage        type_array[EB_MAX_MEMORY_TYPE_COUNT];
+
+    } EbSvtMemoryUsage;
+
 
     /* STEP 1: Call the library to construct a Component Handle.
      *
@@ -439,6 +615,70 @@ typedef struct EbSvtAv1EncConfiguration
     EB_API EbErrorType eb_init_encoder(
         EbComponentType *svt_enc_component);
 
+    /* OPTIONAL: Encode svt_enc_component as a rendition of the ABR ladder led by
+     * lead_component. The lead publishes its scene change decisions and its HME
+     * search centers; the rendition takes the scene changes of the lead, so the
+     * renditions switch GOP at the same pictures, and starts its motion search
+     * from the scaled search centers instead of running HME. Called after
+     * eb_svt_enc_set_parameter() on both handles, before eb_init_encoder() on
+     * svt_enc_component and before any picture is sent to either.
+     *
+     * Both handles must be sent the same pictures in the same order, the lead at
+     * the largest resolution and with the same intra period, hierarchical levels
+     * and prediction structure. The rendition holds each input until the lead
+     * analysed the picture, and the lead keeps the analysis of a picture until
+     * every rendition ran motion estimation on it, so the output of a rendition
+     * does not depend on thread timing. A rendition has extra input buffers for
+     * the pictures the lead has queued or in flight; eb_svt_enc_send_picture()
+     * on it blocks while the lead has not analysed them, and the lead waits for
+     * its slowest rendition rather than drop analysis it still needs. A
+     * rendition only analyses pictures on its own, and logs how many at
+     * eb_deinit_encoder(), when the lead is deinitialized first.
+     *
+     * Picture analysis (decimation and statistics) and the motion search around
+     * the shared centers still run in every rendition, at its own resolution.
+     *
+     * Parameter:
+     * @ *lead_component     Encoder handler of the top rendition.
+     * @ *svt_enc_component  Encoder handler of the rendition. */
+    EB_API EbErrorType eb_svt_enc_share_analysis(
+        EbComponentType *lead_component,
+        EbComponentType *svt_enc_component);
+
+    /* OPTIONAL: Let the application allocate the input frames, which the encoder
+     * then references instead of copying them. Called after
+     * eb_svt_enc_set_parameter() and before eb_init_encoder(). Supported for 8 bit
+     * input and for compressed 10 bit input (compressed_ten_bit_format 1).
+     *
+     * Every picture sent must then come from eb_svt_enc_allocate_input_frame().
+     * The encoder writes the padding of the frame, and release_buffer is called,
+     * on an encoder thread, once the last stage using the frame is done with it.
+     *
+     * Parameter:
+     * @ *svt_enc_component     Encoder handler.
+     * @ allocate_buffer        callback function to allocate frame buffer
+     * @ release_buffer         callback function to release frame buffer
+     * @ priv_data              private data used by the allocator */
+    EB_API EbErrorType eb_svt_enc_set_frame_buffer_callbacks(
+        EbComponentType             *svt_enc_component,
+        eb_allocate_frame_buffer    allocate_buffer,
+        eb_release_frame_buffer     release_buffer,
+        void                        *priv_data);
+
+    /* OPTIONAL: Allocate an input frame through allocate_buffer, laid out like the
+     * encoder input pictures. Called after eb_init_encoder().
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ *frame              Filled with the planes of the frame, which point at the
+     *                       top-left sample, origin_x / origin_y samples inside the
+     *                       padding. The 2 bit planes of compressed 10 bit input have
+     *                       rows of width / 4 bytes. Sent as the p_buffer of an
+     *                       EbBufferHeaderType. */
+    EB_API EbErrorType eb_svt_enc_allocate_input_frame(
+        EbComponentType             *svt_enc_component,
+        EbSvtIOFormat               *frame);
+
     /* OPTIONAL: Get stream headers at init time.
      *
      * Parameter:
@@ -493,6 +733,49 @@ typedef struct EbSvtAv1EncConfiguration
         EbComponentType      *svt_enc_component,
         EbBufferHeaderType   *p_buffer);
 
+    /* OPTIONAL: Get the utilization counters of the pipeline stages.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ *stage_array        Array of EB_MAX_STAGE_UTILIZATION_COUNT entries to fill.
+     * @ *stage_count        Number of entries filled. */
+    EB_API EbErrorType eb_svt_enc_get_stage_utilization(
+        EbComponentType      *svt_enc_component,
+        EbStageUtilization   *stage_array,
+        uint32_t             *stage_count);
+
+    /* OPTIONAL: Get the pipeline counters. Requires enable_pipeline_stats,
+     * stage_count and thread_count are 0 otherwise.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ *stats              Filled with the counters. */
+    EB_API EbErrorType eb_svt_enc_get_stats(
+        EbComponentType      *svt_enc_component,
+        EbSvtEncStats        *stats);
+
+    /* OPTIONAL: Write the latest pipeline events of every thread (objects processed
+     * per stage and picture, fifo depths) as a Chrome trace event JSON file, which
+     * chrome://tracing or Perfetto can load. Requires enable_pipeline_stats; meant
+     * to be called once the last packet is out.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ *file_name          Path of the file to write. */
+    EB_API EbErrorType eb_svt_enc_write_trace(
+        EbComponentType      *svt_enc_component,
+        const char           *file_name);
+
+    /* OPTIONAL: Get the memory committed by the encoder, by each of its pools,
+     * which grow at run time with lazy_pool_allocation, and by each type.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ *usage              Filled with the memory usage. */
+    EB_API EbErrorType eb_svt_enc_get_memory_usage(
+        EbComponentType      *svt_enc_component,
+        EbSvtMemoryUsage     *usage);
+
     /* STEP 6: Deinitialize encoder library.
      *
      * Parameter:
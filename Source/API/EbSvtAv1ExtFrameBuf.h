@@ -14,7 +14,8 @@ extern "C" {
 
 /*!\brief External frame buffer
  *
- * This structure holds allocated frame buffers used by the decoder.
+ * This structure holds allocated frame buffers used by the decoder, or
+ * the input frames of the encoder.
  */
 typedef struct EbExtFrameBuf {
     
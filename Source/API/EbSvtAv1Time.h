@@ -12,6 +12,7 @@ void EbStartTime(uint64_t *Startseconds, uint64_t *Startuseconds);
 void EbFinishTime(uint64_t *Finishseconds, uint64_t *Finishuseconds);
 void EbComputeOverallElapsedTime(uint64_t Startseconds, uint64_t Startuseconds, uint64_t Finishseconds, uint64_t Finishuseconds, double *duration);
 void EbComputeOverallElapsedTimeMs(uint64_t Startseconds, uint64_t Startuseconds, uint64_t Finishseconds, uint64_t Finishuseconds, double *duration);
+void EbProcessCpuTimeMs(double *duration);
 void EbSleep(uint64_t milliSeconds);
 void EbInjector(uint64_t processedFrameCount, uint32_t injector_frame_rate);
 
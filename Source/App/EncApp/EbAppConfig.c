@@ -9,6 +9,7 @@
 
 #include "EbAppConfig.h"
 #include "EbAppInputy4m.h"
+#include "EbAppInputMap.h"
 
 #ifdef _WIN32
 #else
@@ -31,6 +32,7 @@
 #define HEIGHT_TOKEN                    "-h"
 #define NUMBER_OF_PICTURES_TOKEN        "-n"
 #define BUFFERED_INPUT_TOKEN            "-nb"
+#define MMAP_INPUT_TOKEN                "-mmap"
 #define BASE_LAYER_SWITCH_MODE_TOKEN    "-base-layer-switch-mode" // no Eval
 #define QP_TOKEN                        "-q"
 #define USE_QP_FILE_TOKEN               "-use-q-file"
@@ -61,6 +63,7 @@
 #define HME_L2_ENABLE_TOKEN             "-hme-l2"
 #define EXT_BLOCK                       "-ext-block"
 #define IN_LOOP_ME                      "-in-loop-me"
+#define MD_RECON_CACHE                  "-md-recon-cache"
 #define SEARCH_AREA_WIDTH_TOKEN         "-search-w"
 #define SEARCH_AREA_HEIGHT_TOKEN        "-search-h"
 #define NUM_HME_SEARCH_WIDTH_TOKEN      "-num-hme-w"
@@ -93,6 +96,12 @@
 #define ASM_TYPE_TOKEN                  "-asm"
 #define THREAD_MGMNT                    "-lp"
 #define TARGET_SOCKET                   "-ss"
+#define THREAD_POOL_MODE_TOKEN          "-thread-pool"
+#define LAZY_POOLS_TOKEN                "-lazy-pools"
+#define MEMORY_STATS_TOKEN              "-memory-stats"
+#define PIPELINE_STATS_TOKEN            "-pipeline-stats"
+#define PIPELINE_TRACE_TOKEN            "-pipeline-trace"
+#define SHARE_ANALYSIS_TOKEN            "-share-analysis"
 #define CONFIG_FILE_COMMENT_CHAR    '#'
 #define CONFIG_FILE_NEWLINE_CHAR    '\n'
 #define CONFIG_FILE_RETURN_CHAR     '\r'
@@ -162,6 +171,7 @@ static void SetSeperateFields                   (const char *value, EbConfig *cf
 static void SetCfgSourceHeight                  (const char *value, EbConfig *cfg) {cfg->source_height = strtoul(value, NULL, 0) >> cfg->separate_fields;};
 static void SetCfgFramesToBeEncoded             (const char *value, EbConfig *cfg) {cfg->frames_to_be_encoded = strtol(value,  NULL, 0) << cfg->separate_fields;};
 static void SetBufferedInput                    (const char *value, EbConfig *cfg) {cfg->buffered_input = (strtol(value, NULL, 0) != -1 && cfg->separate_fields) ? strtol(value, NULL, 0) << cfg->separate_fields : strtol(value, NULL, 0);};
+static void SetMmapInput                        (const char *value, EbConfig *cfg) {cfg->mmap_input = strtoul(value, NULL, 0);};
 static void SetFrameRate                        (const char *value, EbConfig *cfg) {
     cfg->frame_rate = strtoul(value, NULL, 0);
     if (cfg->frame_rate > 1000 ){
@@ -209,6 +219,7 @@ static void SetCfgHmeLevel0TotalSearchAreaHeight(const char *value, EbConfig *cf
 static void SetCfgUseDefaultMeHme               (const char *value, EbConfig *cfg) {cfg->use_default_me_hme = (EbBool)strtol(value, NULL, 0); };
 static void SetEnableExtBlockFlag(const char *value, EbConfig *cfg) { cfg->ext_block_flag = (EbBool)strtoul(value, NULL, 0); };
 static void SetEnableInLoopMeFlag(const char *value, EbConfig *cfg) { cfg->in_loop_me_flag = (EbBool)strtoul(value, NULL, 0); };
+static void SetEnableMdReconCacheFlag(const char *value, EbConfig *cfg) { cfg->md_recon_cache_flag = (EbBool)strtoul(value, NULL, 0); };
 static void SetHmeLevel0SearchAreaInWidthArray  (const char *value, EbConfig *cfg) {cfg->hme_level0_search_area_in_width_array[cfg->hme_level0_column_index++] = strtoul(value, NULL, 0);};
 static void SetHmeLevel0SearchAreaInHeightArray (const char *value, EbConfig *cfg) {cfg->hme_level0_search_area_in_height_array[cfg->hme_level0_row_index++] = strtoul(value, NULL, 0);};
 static void SetHmeLevel1SearchAreaInWidthArray  (const char *value, EbConfig *cfg) {cfg->hme_level1_search_area_in_width_array[cfg->hme_level1_column_index++] = strtoul(value, NULL, 0);};
@@ -241,6 +252,17 @@ static void SetLatencyMode                      (const char *value, EbConfig *cf
 static void SetAsmType                          (const char *value, EbConfig *cfg)  {cfg->asm_type                   = (uint32_t)strtoul(value, NULL, 0);};
 static void SetLogicalProcessors                (const char *value, EbConfig *cfg)  {cfg->logical_processors         = (uint32_t)strtoul(value, NULL, 0);};
 static void SetTargetSocket                     (const char *value, EbConfig *cfg)  {cfg->target_socket              = (int32_t)strtol(value, NULL, 0);};
+static void SetThreadPoolMode                   (const char *value, EbConfig *cfg)  {cfg->thread_pool_mode           = (uint32_t)strtoul(value, NULL, 0);};
+static void SetLazyPools                        (const char *value, EbConfig *cfg)  {cfg->lazy_pools                 = (EbBool)strtoul(value, NULL, 0);};
+static void SetMemoryStats                      (const char *value, EbConfig *cfg)  {cfg->memory_stats               = (EbBool)strtoul(value, NULL, 0);};
+static void SetPipelineStats                    (const char *value, EbConfig *cfg)  {cfg->pipeline_stats             = (EbBool)strtoul(value, NULL, 0);};
+static void SetShareAnalysis                    (const char *value, EbConfig *cfg)  {cfg->share_analysis             = (EbBool)strtoul(value, NULL, 0);};
+static void SetPipelineTraceFile                (const char *value, EbConfig *cfg)
+{
+    if (cfg->pipeline_trace_file) { free(cfg->pipeline_trace_file); }
+    cfg->pipeline_trace_file = (char*)malloc(strlen(value) + 1);
+    if (cfg->pipeline_trace_file) { strcpy(cfg->pipeline_trace_file, value); }
+};
 
 enum cfg_type{
     SINGLE_INPUT,   // Configuration parameters that have only 1 value input
@@ -280,6 +302,7 @@ config_entry_t config_entry[] = {
     // Prediction Structure
     { SINGLE_INPUT, NUMBER_OF_PICTURES_TOKEN, "FrameToBeEncoded", SetCfgFramesToBeEncoded },
     { SINGLE_INPUT, BUFFERED_INPUT_TOKEN, "buffered_input", SetBufferedInput },
+    { SINGLE_INPUT, MMAP_INPUT_TOKEN, "MmapInput", SetMmapInput },
     { SINGLE_INPUT, BASE_LAYER_SWITCH_MODE_TOKEN, "BaseLayerSwitchMode", SetBaseLayerSwitchMode },
     { SINGLE_INPUT, ENCMODE_TOKEN, "EncoderMode", SetencMode},
     { SINGLE_INPUT, INTRA_PERIOD_TOKEN, "IntraPeriod", SetCfgIntraPeriod },
@@ -320,6 +343,7 @@ config_entry_t config_entry[] = {
     { SINGLE_INPUT, HME_L2_ENABLE_TOKEN, "HMELevel2", SetEnableHmeLevel2Flag },
     { SINGLE_INPUT, EXT_BLOCK, "ExtBlockFlag", SetEnableExtBlockFlag },
     { SINGLE_INPUT, IN_LOOP_ME, "InLoopMeFlag", SetEnableInLoopMeFlag },
+    { SINGLE_INPUT, MD_RECON_CACHE, "MdReconCacheFlag", SetEnableMdReconCacheFlag },
 
     // ME Parameters
     { SINGLE_INPUT, SEARCH_AREA_WIDTH_TOKEN, "search_area_width", SetCfgSearchAreaWidth },
@@ -337,6 +361,12 @@ config_entry_t config_entry[] = {
     // Thread Management
     { SINGLE_INPUT, THREAD_MGMNT, "logical_processors", SetLogicalProcessors },
     { SINGLE_INPUT, TARGET_SOCKET, "target_socket", SetTargetSocket },
+    { SINGLE_INPUT, THREAD_POOL_MODE_TOKEN, "ThreadPoolMode", SetThreadPoolMode },
+    { SINGLE_INPUT, LAZY_POOLS_TOKEN, "LazyPools", SetLazyPools },
+    { SINGLE_INPUT, MEMORY_STATS_TOKEN, "MemoryStats", SetMemoryStats },
+    { SINGLE_INPUT, PIPELINE_STATS_TOKEN, "PipelineStats", SetPipelineStats },
+    { SINGLE_INPUT, PIPELINE_TRACE_TOKEN, "PipelineTraceFile", SetPipelineTraceFile },
+    { SINGLE_INPUT, SHARE_ANALYSIS_TOKEN, "ShareAnalysis", SetShareAnalysis },
 
     // Optional Features
 
@@ -394,6 +424,8 @@ void eb_config_ctor(EbConfig *config_ptr)
     config_ptr->frames_to_be_encoded                 = 0;
     config_ptr->buffered_input                        = -1;
     config_ptr->sequence_buffer                       = 0;
+    config_ptr->mmap_input                            = INPUT_MAP_OFF;
+    config_ptr->input_map                             = NULL;
     config_ptr->latency_mode                          = 0;
 
     // Interlaced Video
@@ -422,6 +454,7 @@ void eb_config_ctor(EbConfig *config_ptr)
     config_ptr->enable_warped_motion                 = EB_FALSE;
     config_ptr->ext_block_flag                       = EB_FALSE;
     config_ptr->in_loop_me_flag                      = EB_TRUE;
+    config_ptr->md_recon_cache_flag                  = EB_TRUE;
     config_ptr->use_default_me_hme                   = EB_TRUE;
     config_ptr->enable_hme_flag                        = EB_TRUE;
     config_ptr->enable_hme_level0_flag                  = EB_TRUE;
@@ -482,6 +515,8 @@ void eb_config_ctor(EbConfig *config_ptr)
 
     config_ptr->performance_context.total_execution_time = 0;
     config_ptr->performance_context.total_encode_time    = 0;
+    config_ptr->performance_context.total_input_time     = 0;
+    config_ptr->performance_context.total_send_time      = 0;
 
     config_ptr->performance_context.frame_count        = 0;
     config_ptr->performance_context.average_speed      = 0;
@@ -497,6 +532,12 @@ void eb_config_ctor(EbConfig *config_ptr)
     config_ptr->stop_encoder                          = 0;
     config_ptr->logical_processors                    = 0;
     config_ptr->target_socket                         = -1;
+    config_ptr->thread_pool_mode                      = 0;
+    config_ptr->lazy_pools                            = EB_FALSE;
+    config_ptr->memory_stats                          = EB_FALSE;
+    config_ptr->pipeline_stats                        = EB_FALSE;
+    config_ptr->pipeline_trace_file                   = (char*)NULL;
+    config_ptr->share_analysis                        = EB_FALSE;
     config_ptr->processed_frame_count                  = 0;
     config_ptr->processed_byte_count                   = 0;
     config_ptr->tile_rows                            = 0;
@@ -513,6 +554,9 @@ void eb_config_ctor(EbConfig *config_ptr)
 void eb_config_dtor(EbConfig *config_ptr)
 {
 
+    // Unmap the input before closing it
+    input_map_close(config_ptr);
+
     // Close any files that are open
     if (config_ptr->config_file) {
         fclose(config_ptr->config_file);
@@ -544,6 +588,11 @@ void eb_config_dtor(EbConfig *config_ptr)
         config_ptr->qp_file = (FILE *)NULL;
     }
 
+    if (config_ptr->pipeline_trace_file) {
+        free(config_ptr->pipeline_trace_file);
+        config_ptr->pipeline_trace_file = (char *)NULL;
+    }
+
     return;
 }
 
@@ -783,6 +832,16 @@ static EbErrorType VerifySettings(EbConfig *config, uint32_t channelNumber)
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->mmap_input > INPUT_MAP_PREFETCH) {
+        fprintf(config->error_log_file, "Error instance %u: Invalid MmapInput. MmapInput must be [0 - 2]\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->mmap_input != INPUT_MAP_OFF && config->buffered_input != -1) {
+        fprintf(config->error_log_file, "Error instance %u: MmapInput cannot be used with buffered_input\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (config->use_qp_file == EB_TRUE && config->qp_file == NULL) {
         fprintf(config->error_log_file, "Error instance %u: Could not find QP file, UseQpFile is set to 1\n", channelNumber + 1);
         return_error = EB_ErrorBadParameter;
@@ -824,6 +883,36 @@ static EbErrorType VerifySettings(EbConfig *config, uint32_t channelNumber)
         return_error = EB_ErrorBadParameter;
     }
 
+    // thread_pool_mode
+    if (config->thread_pool_mode > 1) {
+        fprintf(config->error_log_file, "Error instance %u: Invalid thread_pool_mode [0 - 1], your input: %u\n", channelNumber + 1, config->thread_pool_mode);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    // lazy_pools
+    if (config->lazy_pools != 0 && config->lazy_pools != 1) {
+        fprintf(config->error_log_file, "Error instance %u: Invalid lazy_pools [0 - 1], your input: %d\n", channelNumber + 1, config->lazy_pools);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    // memory_stats
+    if (config->memory_stats != 0 && config->memory_stats != 1) {
+        fprintf(config->error_log_file, "Error instance %u: Invalid memory_stats [0 - 1], your input: %d\n", channelNumber + 1, config->memory_stats);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    // pipeline_stats
+    if (config->pipeline_stats != 0 && config->pipeline_stats != 1) {
+        fprintf(config->error_log_file, "Error instance %u: Invalid pipeline_stats [0 - 1], your input: %d\n", channelNumber + 1, config->pipeline_stats);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    // share_analysis
+    if (config->share_analysis != 0 && config->share_analysis != 1) {
+        fprintf(config->error_log_file, "Error instance %u: Invalid share_analysis [0 - 1], your input: %d\n", channelNumber + 1, config->share_analysis);
+        return_error = EB_ErrorBadParameter;
+    }
+
     // Local Warped Motion
     if (config->enable_warped_motion != 0 && config->enable_warped_motion != 1) {
         fprintf(config->error_log_file, "Error instance %u: Invalid warped motion flag [0 - 1], your input: %d\n", channelNumber + 1, config->target_socket);
@@ -10,11 +10,14 @@
 
 #include "EbSvtAv1Enc.h"
 
-#ifdef __GNUC__
+// Define Cross-Platform 64-bit fseek() and ftell()
+#if defined(__GNUC__) && !defined(_WIN32)
+#define fseeko64 fseeko
+#define ftello64 ftello
+#elif defined(__GNUC__)
 #define fseeko64 fseek
 #define ftello64 ftell
 #endif
-// Define Cross-Platform 64-bit fseek() and ftell()
 #ifdef _MSC_VER
 typedef __int64 off64_t;
 #define fseeko64 _fseeki64
@@ -180,6 +183,8 @@ typedef struct EbPerformanceContext {
 
     double                    total_execution_time;    // includes init
     double                    total_encode_time;       // not including init
+    double                    total_input_time;        // reading the input frames, in ms
+    double                    total_send_time;         // waiting for an input buffer of the library, in ms
 
     uint64_t                  total_latency;
     uint32_t                  max_latency;
@@ -212,6 +217,9 @@ typedef struct EbConfig
     EbBool                  y4m_input;
     unsigned char           y4m_buf[9];
 
+    uint32_t                mmap_input;
+    struct EbInputMap      *input_map;
+
     EbBool                  use_qp_file;
 
     uint32_t                 frame_rate;
@@ -282,6 +290,7 @@ typedef struct EbConfig
     EbBool                  enable_hme_level2_flag;
     EbBool                  ext_block_flag;
     EbBool                  in_loop_me_flag;
+    EbBool                  md_recon_cache_flag;
 
     /****************************************
      * ME Parameters
@@ -364,6 +373,12 @@ typedef struct EbConfig
     uint32_t                active_channel_count;
     uint32_t                logical_processors;
     int32_t                 target_socket;
+    uint32_t                thread_pool_mode;
+    EbBool                  lazy_pools;
+    EbBool                  memory_stats;
+    EbBool                  pipeline_stats;
+    char                   *pipeline_trace_file;
+    EbBool                  share_analysis;       // channels > 0 follow the analysis of channel 0
     EbBool                 stop_encoder;         // to signal CTRL+C Event, need to stop encoding.
 
     uint64_t                processed_frame_count;
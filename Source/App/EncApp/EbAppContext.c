@@ -11,6 +11,7 @@
 
 #include "EbAppContext.h"
 #include "EbAppConfig.h"
+#include "EbAppInputMap.h"
 
 
 #define INPUT_SIZE_576p_TH                0x90000        // 0.58 Million
@@ -172,6 +173,7 @@ EbErrorType CopyConfigurationParameters(
     callback_data->eb_enc_parameters.hierarchical_levels = config->hierarchical_levels;
     callback_data->eb_enc_parameters.pred_structure = (uint8_t)config->pred_structure;
     callback_data->eb_enc_parameters.in_loop_me_flag = config->in_loop_me_flag;
+    callback_data->eb_enc_parameters.md_recon_cache_flag = config->md_recon_cache_flag;
     callback_data->eb_enc_parameters.ext_block_flag = config->ext_block_flag;
     callback_data->eb_enc_parameters.tile_rows = config->tile_rows;
     callback_data->eb_enc_parameters.tile_columns = config->tile_columns;
@@ -214,6 +216,9 @@ EbErrorType CopyConfigurationParameters(
     callback_data->eb_enc_parameters.asm_type = config->asm_type;
     callback_data->eb_enc_parameters.logical_processors = config->logical_processors;
     callback_data->eb_enc_parameters.target_socket = config->target_socket;
+    callback_data->eb_enc_parameters.thread_pool_mode = config->thread_pool_mode;
+    callback_data->eb_enc_parameters.lazy_pool_allocation = config->lazy_pools;
+    callback_data->eb_enc_parameters.enable_pipeline_stats = (config->pipeline_stats || config->pipeline_trace_file) ? EB_TRUE : EB_FALSE;
     callback_data->eb_enc_parameters.recon_enabled = config->recon_file ? EB_TRUE : EB_FALSE;
 
     for (hmeRegionIndex = 0; hmeRegionIndex < callback_data->eb_enc_parameters.number_hme_search_region_in_width; ++hmeRegionIndex) {
@@ -317,7 +322,8 @@ EbErrorType AllocateInputBuffers(
 
         EB_APP_MALLOC(uint8_t*, callback_data->input_buffer_pool->p_buffer, sizeof(EbSvtIOFormat), EB_N_PTR, EB_ErrorInsufficientResources);
 
-        if (config->buffered_input == -1) {
+        // The planes of mapped frames point into the input file
+        if (config->buffered_input == -1 && config->input_map == NULL) {
 
             // Allocate frame buffer for the p_buffer
             AllocateFrameBuffer(
@@ -560,7 +566,8 @@ EbErrorType PreloadFramesIntoRam(
 EbErrorType init_encoder(
     EbConfig              *config,
     EbAppContext          *callback_data,
-    uint32_t                 instance_idx)
+    uint32_t                 instance_idx,
+    EbAppContext          *lead_callback_data)
 {
     EbErrorType        return_error = EB_ErrorNone;
 
@@ -595,6 +602,17 @@ EbErrorType init_encoder(
         return return_error;
     }
 
+    // Encode as a rendition of the ladder led by lead_callback_data
+    if (lead_callback_data) {
+        return_error = eb_svt_enc_share_analysis(
+            lead_callback_data->svt_encoder_handle,
+            callback_data->svt_encoder_handle);
+        if (return_error != EB_ErrorNone) {
+            fprintf(config->error_log_file, "Error instance %u: the rendition cannot share the analysis of channel 1\n", instance_idx + 1);
+            return return_error;
+        }
+    }
+
     // STEP 5: Init Encoder
     return_error = eb_init_encoder(callback_data->svt_encoder_handle);
     if (return_error != EB_ErrorNone) { return return_error; }
@@ -603,6 +621,12 @@ EbErrorType init_encoder(
 
     ///********************** APPLICATION INIT [START] ******************///
 
+    // Map the input file, or read it if it cannot be mapped (e.g. a pipe)
+    if (config->mmap_input != INPUT_MAP_OFF && input_map_open(config) != EB_ErrorNone) {
+        fprintf(config->error_log_file, "Warning instance %u: could not map the input file, reading it instead\n", instance_idx + 1);
+        config->mmap_input = INPUT_MAP_OFF;
+    }
+
     // STEP 6: Allocate input buffers carrying the yuv frames in
     return_error = AllocateInputBuffers(
         config,
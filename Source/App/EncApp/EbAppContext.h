@@ -36,7 +36,7 @@ typedef struct EbAppContext {
 /********************************
  * External Function
  ********************************/
-extern EbErrorType init_encoder(EbConfig *config, EbAppContext *callback_data, uint32_t instance_idx);
+extern EbErrorType init_encoder(EbConfig *config, EbAppContext *callback_data, uint32_t instance_idx, EbAppContext *lead_callback_data);
 extern EbErrorType de_init_encoder(EbAppContext *callback_data_ptr, uint32_t instance_index);
 
 #endif // EbAppContext_h
\ No newline at end of file
@@ -0,0 +1,457 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbAppInputMap.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**********************************
+ * Prefetch Event
+ *   Auto reset event waking the prefetch
+ *   thread. The frame to prefetch from and
+ *   the stop request are handed over under
+ *   the same lock as the event.
+ **********************************/
+typedef struct EbPrefetchEvent
+{
+#ifdef _WIN32
+    CRITICAL_SECTION        mutex;
+    CONDITION_VARIABLE      cond;
+#else
+    pthread_mutex_t         mutex;
+    pthread_cond_t          cond;
+#endif
+    int32_t                 signaled;
+    int32_t                 stop_flag;
+    uint64_t                next_frame;
+
+} EbPrefetchEvent;
+
+static EbPrefetchEvent* CreatePrefetchEvent(void)
+{
+    EbPrefetchEvent *eventPtr = (EbPrefetchEvent*)calloc(1, sizeof(EbPrefetchEvent));
+
+    if (eventPtr == NULL)
+        return NULL;
+#ifdef _WIN32
+    InitializeCriticalSection(&eventPtr->mutex);
+    InitializeConditionVariable(&eventPtr->cond);
+#else
+    pthread_mutex_init(&eventPtr->mutex, NULL);
+    pthread_cond_init(&eventPtr->cond, NULL);
+#endif
+    return eventPtr;
+}
+
+static void DestroyPrefetchEvent(EbPrefetchEvent *eventPtr)
+{
+#ifdef _WIN32
+    DeleteCriticalSection(&eventPtr->mutex);
+#else
+    pthread_mutex_destroy(&eventPtr->mutex);
+    pthread_cond_destroy(&eventPtr->cond);
+#endif
+    free(eventPtr);
+}
+
+static void LockPrefetchEvent(EbPrefetchEvent *eventPtr)
+{
+#ifdef _WIN32
+    EnterCriticalSection(&eventPtr->mutex);
+#else
+    pthread_mutex_lock(&eventPtr->mutex);
+#endif
+}
+
+static void UnlockPrefetchEvent(EbPrefetchEvent *eventPtr)
+{
+#ifdef _WIN32
+    LeaveCriticalSection(&eventPtr->mutex);
+#else
+    pthread_mutex_unlock(&eventPtr->mutex);
+#endif
+}
+
+// Publishes nextFrame, or the stop request, and wakes the prefetch thread
+static void SetPrefetchEvent(
+    EbPrefetchEvent         *eventPtr,
+    uint64_t                 nextFrame,
+    int32_t                  stop)
+{
+    LockPrefetchEvent(eventPtr);
+    if (stop)
+        eventPtr->stop_flag = 1;
+    else
+        eventPtr->next_frame = nextFrame;
+    eventPtr->signaled = 1;
+#ifdef _WIN32
+    WakeConditionVariable(&eventPtr->cond);
+#else
+    pthread_cond_signal(&eventPtr->cond);
+#endif
+    UnlockPrefetchEvent(eventPtr);
+}
+
+// Returns the stop request, and the last published frame in nextFramePtr
+static int32_t WaitPrefetchEvent(
+    EbPrefetchEvent         *eventPtr,
+    uint64_t                *nextFramePtr)
+{
+    int32_t stop;
+
+    LockPrefetchEvent(eventPtr);
+    while (!eventPtr->signaled)
+#ifdef _WIN32
+        SleepConditionVariableCS(&eventPtr->cond, &eventPtr->mutex, INFINITE);
+#else
+        pthread_cond_wait(&eventPtr->cond, &eventPtr->mutex);
+#endif
+    eventPtr->signaled = 0;
+    *nextFramePtr = eventPtr->next_frame;
+    stop = eventPtr->stop_flag;
+    UnlockPrefetchEvent(eventPtr);
+
+    return stop;
+}
+
+static int32_t PrefetchStopRequested(
+    EbPrefetchEvent         *eventPtr)
+{
+    int32_t stop;
+
+    LockPrefetchEvent(eventPtr);
+    stop = eventPtr->stop_flag;
+    UnlockPrefetchEvent(eventPtr);
+
+    return stop;
+}
+
+/**********************************
+ * Page Advice
+ *   Hints the kernel about the pages of
+ *   one frame of the mapping.
+ **********************************/
+#ifndef _WIN32
+static void AdviseFramePages(
+    EbInputMap              *input_map,
+    uint64_t                 frameIndex,
+    int32_t                  advice)
+{
+    uint64_t start = input_map->data_offset + frameIndex * input_map->frame_stride;
+    uint64_t end = start + input_map->frame_stride;
+
+    // madvise wants a page aligned address
+    start &= ~(uint64_t)(input_map->page_size - 1);
+    madvise(input_map->base_ptr + start, (size_t)(end - start), advice);
+}
+#endif
+
+/**********************************
+ * Touch Frame Pages
+ *   Faults in the pages of a frame, so that
+ *   the disk reads happen on the prefetch
+ *   thread rather than in the main loop.
+ **********************************/
+static void TouchFramePages(
+    EbInputMap              *input_map,
+    uint64_t                 frameIndex)
+{
+    const volatile uint8_t *framePtr = input_map->base_ptr + input_map->data_offset + frameIndex * input_map->frame_stride;
+    uint64_t                offset;
+    uint8_t                 sum = 0;
+
+#ifndef _WIN32
+    AdviseFramePages(input_map, frameIndex, MADV_WILLNEED);
+#endif
+
+    for (offset = 0; offset < input_map->frame_stride; offset += input_map->page_size)
+        sum += framePtr[offset];
+    sum += framePtr[input_map->frame_stride - 1];
+    (void)sum;
+}
+
+/**********************************
+ * Prefetch Kernel
+ *   Keeps the INPUT_MAP_PREFETCH_FRAMES
+ *   frames following next_frame resident
+ *   and drops the frames already sent.
+ **********************************/
+#ifdef _WIN32
+static DWORD WINAPI PrefetchKernel(LPVOID input_ptr)
+#else
+static void* PrefetchKernel(void *input_ptr)
+#endif
+{
+    EbInputMap      *input_map = (EbInputMap*)input_ptr;
+    EbPrefetchEvent *eventPtr = (EbPrefetchEvent*)input_map->event_handle;
+    uint64_t         touchedFrame = 0;   // frames up to this sequence number are resident
+    uint64_t         nextFrame;
+
+    for (;;) {
+        if (WaitPrefetchEvent(eventPtr, &nextFrame))
+            break;
+
+        if (touchedFrame < nextFrame)
+            touchedFrame = nextFrame;
+
+        for (; touchedFrame < nextFrame + INPUT_MAP_PREFETCH_FRAMES && !PrefetchStopRequested(eventPtr); ++touchedFrame)
+            TouchFramePages(input_map, touchedFrame % input_map->frame_count);
+
+#ifndef _WIN32
+        // The library copied the previous frames, keep the resident set small
+        if (nextFrame >= 2 && input_map->frame_count > INPUT_MAP_PREFETCH_FRAMES + 2)
+            AdviseFramePages(input_map, (nextFrame - 2) % input_map->frame_count, MADV_DONTNEED);
+#endif
+    }
+
+    return 0;
+}
+
+/**********************************
+ * Input Frame Size
+ *   Size in the file of the planes of one
+ *   frame, as read by ReadInputFrames.
+ **********************************/
+static uint64_t InputFrameSize(
+    EbConfig                *config,
+    uint8_t                  is16bit)
+{
+    const uint64_t lumaSize = (uint64_t)config->input_padded_width * config->input_padded_height;
+    const uint8_t  color_format = (uint8_t)config->encoder_color_format;
+
+    if (is16bit && config->compressed_ten_bit_format == 1) {
+        const uint64_t nbitLumaSize = (uint64_t)(config->input_padded_width / 4) * config->input_padded_height;
+        return lumaSize + nbitLumaSize + 2 * ((lumaSize >> (3 - color_format)) + (nbitLumaSize >> (3 - color_format)));
+    }
+
+    return (lumaSize + 2 * (lumaSize >> (3 - color_format))) << is16bit;
+}
+
+/**********************************
+ * input_map_open
+ **********************************/
+EbErrorType input_map_open(
+    EbConfig                *config)
+{
+    EbInputMap *input_map;
+    uint8_t     is16bit = (uint8_t)(config->encoder_bit_depth > 8);
+    int64_t     dataOffset;
+
+    if (config->input_file == NULL || config->input_file == stdin)
+        return EB_ErrorBadParameter;
+
+    // The y4m header has been parsed, the file is at the first frame
+    dataOffset = ftello64(config->input_file);
+    if (dataOffset < 0)
+        return EB_ErrorBadParameter;
+
+    input_map = (EbInputMap*)calloc(1, sizeof(EbInputMap));
+    if (input_map == NULL)
+        return EB_ErrorInsufficientResources;
+
+    input_map->data_offset = (uint64_t)dataOffset;
+    input_map->frame_offset = config->y4m_input ? INPUT_MAP_Y4M_DELIMITER_SIZE : 0;
+    input_map->frame_size = InputFrameSize(config, is16bit) << config->separate_fields;
+    input_map->frame_stride = input_map->frame_offset + input_map->frame_size;
+    input_map->mode = config->mmap_input;
+
+#ifdef _WIN32
+    {
+        HANDLE          fileHandle = (HANDLE)_get_osfhandle(_fileno(config->input_file));
+        LARGE_INTEGER   fileSize;
+        SYSTEM_INFO     systemInfo;
+
+        GetSystemInfo(&systemInfo);
+        input_map->page_size = systemInfo.dwPageSize;
+
+        if (fileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(fileHandle, &fileSize)) {
+            free(input_map);
+            return EB_ErrorBadParameter;
+        }
+        input_map->file_size = (uint64_t)fileSize.QuadPart;
+
+        input_map->mapping_handle = CreateFileMapping(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (input_map->mapping_handle == NULL) {
+            free(input_map);
+            return EB_ErrorBadParameter;
+        }
+        input_map->base_ptr = (uint8_t*)MapViewOfFile(input_map->mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        if (input_map->base_ptr == NULL) {
+            CloseHandle(input_map->mapping_handle);
+            free(input_map);
+            return EB_ErrorBadParameter;
+        }
+    }
+#else
+    {
+        struct stat fileStat;
+        void       *mapPtr;
+
+        input_map->page_size = (uint32_t)sysconf(_SC_PAGESIZE);
+
+        if (fstat(fileno(config->input_file), &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size == 0) {
+            free(input_map);
+            return EB_ErrorBadParameter;
+        }
+        input_map->file_size = (uint64_t)fileStat.st_size;
+
+        mapPtr = mmap(NULL, (size_t)input_map->file_size, PROT_READ, MAP_SHARED, fileno(config->input_file), 0);
+        if (mapPtr == MAP_FAILED) {
+            free(input_map);
+            return EB_ErrorBadParameter;
+        }
+        input_map->base_ptr = (uint8_t*)mapPtr;
+
+        // Let the kernel read ahead aggressively and drop pages behind
+        madvise(input_map->base_ptr, (size_t)input_map->file_size, MADV_SEQUENTIAL);
+    }
+#endif
+
+    input_map->frame_count = input_map->file_size > input_map->data_offset ?
+        (input_map->file_size - input_map->data_offset) / input_map->frame_stride : 0;
+    config->input_map = input_map;
+
+    if (input_map->frame_count == 0) {
+        input_map_close(config);
+        return EB_ErrorBadParameter;
+    }
+
+    if (input_map->mode == INPUT_MAP_PREFETCH) {
+        input_map->event_handle = CreatePrefetchEvent();
+#ifdef _WIN32
+        input_map->thread_handle = input_map->event_handle ? (void*)CreateThread(NULL, 0, PrefetchKernel, input_map, 0, NULL) : NULL;
+#else
+        {
+            pthread_t *threadPtr = (pthread_t*)malloc(sizeof(pthread_t));
+
+            if (input_map->event_handle && threadPtr && pthread_create(threadPtr, NULL, PrefetchKernel, input_map) == 0)
+                input_map->thread_handle = threadPtr;
+            else
+                free(threadPtr);
+        }
+#endif
+        // Without the thread, fall back to the kernel read-ahead
+        if (input_map->thread_handle == NULL)
+            input_map->mode = INPUT_MAP_ON;
+        else
+            SetPrefetchEvent((EbPrefetchEvent*)input_map->event_handle, 0, 0);
+    }
+
+    return EB_ErrorNone;
+}
+
+/**********************************
+ * input_map_close
+ **********************************/
+void input_map_close(
+    EbConfig                *config)
+{
+    EbInputMap *input_map = config->input_map;
+
+    if (input_map == NULL)
+        return;
+
+    if (input_map->thread_handle) {
+        SetPrefetchEvent((EbPrefetchEvent*)input_map->event_handle, 0, 1);
+#ifdef _WIN32
+        WaitForSingleObject((HANDLE)input_map->thread_handle, INFINITE);
+        CloseHandle((HANDLE)input_map->thread_handle);
+#else
+        pthread_join(*(pthread_t*)input_map->thread_handle, NULL);
+        free(input_map->thread_handle);
+#endif
+    }
+
+    if (input_map->event_handle)
+        DestroyPrefetchEvent((EbPrefetchEvent*)input_map->event_handle);
+
+#ifdef _WIN32
+    UnmapViewOfFile(input_map->base_ptr);
+    CloseHandle(input_map->mapping_handle);
+#else
+    munmap(input_map->base_ptr, (size_t)input_map->file_size);
+#endif
+
+    free(input_map);
+    config->input_map = (EbInputMap*)NULL;
+}
+
+/**********************************
+ * input_map_read_frame
+ *   Fields are taken in place by doubling
+ *   the strides.
+ **********************************/
+EbErrorType input_map_read_frame(
+    EbConfig                *config,
+    uint8_t                  is16bit,
+    EbBufferHeaderType      *headerPtr)
+{
+    EbInputMap      *input_map = config->input_map;
+    EbSvtIOFormat   *inputPtr = (EbSvtIOFormat*)headerPtr->p_buffer;
+    const uint64_t   input_padded_width = config->input_padded_width;
+    const uint64_t   input_padded_height = config->input_padded_height;
+    const uint8_t    color_format = (uint8_t)config->encoder_color_format;
+    const uint8_t    subsampling_x = (color_format == EB_YUV444 ? 1 : 2) - 1;
+    const uint64_t   sequenceIndex = config->processed_frame_count >> config->separate_fields;
+    const uint64_t   frameIndex = sequenceIndex % input_map->frame_count;
+    const uint64_t   bottomField = config->separate_fields ? (config->processed_frame_count & 1) : 0;
+    const uint64_t   lumaRowSize = input_padded_width << is16bit;
+    const uint64_t   chromaRowSize = lumaRowSize >> subsampling_x;
+    const uint64_t   lumaSize = (input_padded_width * input_padded_height << is16bit) << config->separate_fields;
+    const uint64_t   chromaSize = lumaSize >> (3 - color_format);
+    uint8_t         *framePtr = input_map->base_ptr + input_map->data_offset + frameIndex * input_map->frame_stride;
+
+    if (config->y4m_input && memcmp(framePtr, "FRAME\n", INPUT_MAP_Y4M_DELIMITER_SIZE) != 0) {
+        fprintf(config->error_log_file, "Failed to read proper y4m frame delimeter. Read broken.\n");
+        return EB_ErrorBadParameter;
+    }
+    framePtr += input_map->frame_offset;
+
+    // The strides are in samples
+    inputPtr->y_stride = (uint32_t)(input_padded_width << config->separate_fields);
+    inputPtr->cb_stride = (uint32_t)((input_padded_width >> subsampling_x) << config->separate_fields);
+    inputPtr->cr_stride = inputPtr->cb_stride;
+
+    inputPtr->luma = framePtr + bottomField * lumaRowSize;
+    inputPtr->cb = framePtr + lumaSize + bottomField * chromaRowSize;
+    inputPtr->cr = framePtr + lumaSize + chromaSize + bottomField * chromaRowSize;
+
+    if (is16bit && config->compressed_ten_bit_format == 1) {
+        const uint64_t nbitLumaSize = lumaSize >> 2;
+        const uint64_t nbitChromaSize = nbitLumaSize >> (3 - color_format);
+
+        inputPtr->luma_ext = framePtr + lumaSize + 2 * chromaSize;
+        inputPtr->cb_ext = inputPtr->luma_ext + nbitLumaSize;
+        inputPtr->cr_ext = inputPtr->cb_ext + nbitChromaSize;
+    }
+    else {
+        inputPtr->luma_ext = NULL;
+        inputPtr->cb_ext = NULL;
+        inputPtr->cr_ext = NULL;
+    }
+
+    headerPtr->n_filled_len = (uint32_t)(input_map->frame_size >> config->separate_fields);
+
+    if (input_map->mode == INPUT_MAP_PREFETCH)
+        SetPrefetchEvent((EbPrefetchEvent*)input_map->event_handle, sequenceIndex + 1, 0);
+#ifndef _WIN32
+    else
+        AdviseFramePages(input_map, (frameIndex + 1) % input_map->frame_count, MADV_WILLNEED);
+#endif
+
+    return EB_ErrorNone;
+}
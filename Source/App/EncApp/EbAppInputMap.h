@@ -0,0 +1,67 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbAppInputMap_h
+#define EbAppInputMap_h
+
+#include "EbAppConfig.h"
+
+/**********************************
+ * Defines
+ **********************************/
+#define INPUT_MAP_OFF                   0   // read the input file with fread
+#define INPUT_MAP_ON                    1   // map the input file
+#define INPUT_MAP_PREFETCH              2   // map the input file and fault the next frames in on a thread
+
+#define INPUT_MAP_PREFETCH_FRAMES       8   // frames touched ahead of the encoder
+#define INPUT_MAP_Y4M_DELIMITER_SIZE    6   // "FRAME\n"
+
+/**********************************
+ * Input Map
+ *   The input file mapped read only. The
+ *   planes sent to the encoder point into
+ *   the mapping, which the library copies
+ *   from in eb_svt_enc_send_picture.
+ *
+ *   frame_stride is the distance between
+ *   two frames, frame_size the size of the
+ *   planes of one frame (two fields with
+ *   separate_fields).
+ **********************************/
+typedef struct EbInputMap
+{
+    uint8_t                *base_ptr;
+    uint64_t                file_size;
+    uint64_t                data_offset;
+    uint64_t                frame_offset;
+    uint64_t                frame_size;
+    uint64_t                frame_stride;
+    uint64_t                frame_count;
+    uint32_t                page_size;
+#ifdef _WIN32
+    void                   *mapping_handle;
+#endif
+
+    // Prefetch thread, the next frame and the stop request are passed
+    // through event_handle under its lock
+    uint32_t                mode;
+    void                   *thread_handle;
+    void                   *event_handle;
+
+} EbInputMap;
+
+/**********************************
+ * Extern Function Declarations
+ **********************************/
+extern EbErrorType input_map_open(EbConfig *config);
+extern void input_map_close(EbConfig *config);
+
+// Points the planes of headerPtr at the next frame (or field) of the mapping
+extern EbErrorType input_map_read_frame(
+    EbConfig                *config,
+    uint8_t                  is16bit,
+    EbBufferHeaderType      *headerPtr);
+
+#endif // EbAppInputMap_h
@@ -76,6 +76,92 @@ void AssignAppThreadGroup(uint8_t target_socket) {
 #endif
 }
 
+/***************************************
+ * Pipeline Stats
+ ***************************************/
+static void PrintPipelineStats(
+    EbConfig             *config,
+    EbAppContext         *appCallBack,
+    uint32_t              instance_index)
+{
+    static EbSvtEncStats stats;
+    uint32_t             stageIndex;
+    uint32_t             threadIndex;
+    double               wallTime;
+
+    if (config->pipeline_stats && eb_svt_enc_get_stats(appCallBack->svt_encoder_handle, &stats) == EB_ErrorNone && stats.stage_count) {
+        wallTime = stats.wall_time_us ? (double)stats.wall_time_us : 1.0;
+
+        printf("\nChannel %u Pipeline\n", instance_index + 1);
+        printf("%-26s %8s %10s %10s %10s %10s %10s %6s %6s\n", "Stage", "Objects", "Proc ms", "Max ms", "CPU ms", "Queue ms", "Max ms", "Depth", "Max");
+        for (stageIndex = 0; stageIndex < stats.stage_count; ++stageIndex) {
+            EbPipelineStageStats *stagePtr = &stats.stage_array[stageIndex];
+            printf("%-26s %8llu %10.3f %10.3f %10.3f %10.3f %10.3f %6u %6u\n",
+                stagePtr->stage_name,
+                (unsigned long long)stagePtr->object_count,
+                stagePtr->object_count ? (double)stagePtr->processing_time_us / stagePtr->object_count / 1000 : 0.0,
+                (double)stagePtr->processing_time_max_us / 1000,
+                stagePtr->object_count ? (double)stagePtr->cpu_time_us / stagePtr->object_count / 1000 : 0.0,
+                stagePtr->object_count ? (double)stagePtr->queue_time_us / stagePtr->object_count / 1000 : 0.0,
+                (double)stagePtr->queue_time_max_us / 1000,
+                stagePtr->fifo_depth,
+                stagePtr->fifo_depth_max);
+        }
+
+        printf("%-26s %8s %7s %7s %7s\n", "Thread", "", "Busy %", "Idle %", "Block %");
+        for (threadIndex = 0; threadIndex < stats.thread_count; ++threadIndex) {
+            EbPipelineThreadStats *threadPtr = &stats.thread_array[threadIndex];
+            printf("%-26s %8u %7.1f %7.1f %7.1f\n",
+                threadPtr->stage_name,
+                threadIndex,
+                100.0 * threadPtr->busy_time_us / wallTime,
+                100.0 * threadPtr->idle_time_us / wallTime,
+                100.0 * threadPtr->blocked_time_us / wallTime);
+        }
+    }
+
+    if (config->pipeline_trace_file &&
+        eb_svt_enc_write_trace(appCallBack->svt_encoder_handle, config->pipeline_trace_file) != EB_ErrorNone)
+        fprintf(config->error_log_file, "Error instance %u: could not write the pipeline trace to %s\n", instance_index + 1, config->pipeline_trace_file);
+}
+
+/***************************************
+ * Memory Stats
+ ***************************************/
+static void PrintMemoryStats(
+    EbAppContext         *appCallBack,
+    uint32_t              instance_index)
+{
+    static EbSvtMemoryUsage usage;
+    uint32_t                poolIndex;
+    uint32_t                typeIndex;
+
+    if (eb_svt_enc_get_memory_usage(appCallBack->svt_encoder_handle, &usage) != EB_ErrorNone)
+        return;
+
+    printf("\nChannel %u Memory: %.2f MB (%.2f MB mapped)\n", instance_index + 1,
+        (double)usage.total_committed_bytes / (1 << 20),
+        (double)usage.total_reserved_bytes / (1 << 20));
+    printf("%-28s %8s %8s %10s\n", "Pool", "Objects", "Max", "MB");
+    for (poolIndex = 0; poolIndex < usage.pool_count; ++poolIndex) {
+        EbMemoryPoolUsage *poolPtr = &usage.pool_array[poolIndex];
+        printf("%-28s %8u %8u %10.2f\n",
+            poolPtr->pool_name,
+            poolPtr->object_count,
+            poolPtr->object_max_count,
+            (double)poolPtr->committed_bytes / (1 << 20));
+    }
+    printf("%-28s %8s %8s %10s\n", "Type", "Allocs", "", "MB");
+    for (typeIndex = 0; typeIndex < usage.type_count; ++typeIndex) {
+        EbMemoryTypeUsage *typePtr = &usage.type_array[typeIndex];
+        printf("%-28s %8llu %8s %10.2f\n",
+            typePtr->type_name,
+            (unsigned long long)typePtr->allocation_count,
+            "",
+            (double)typePtr->committed_bytes / (1 << 20));
+    }
+}
+
 /***************************************
  * Encoder App Main
  ***************************************/
@@ -103,6 +189,8 @@ int32_t main(int32_t argc, char* argv[])
     uint32_t                num_channels = 0;
     uint32_t                instanceCount=0;
     EbAppContext         *appCallbacks[MAX_CHANNEL_NUMBER];   // Instances App callback data
+    double                  cpuStartTime = 0;                 // CPU time of the process, all channels
+    double                  cpuFinishTime = 0;
     signal(SIGINT, EventHandler);
     printf("-------------------------------------------\n");
     printf("SVT-AV1 Encoder\n");
@@ -158,7 +246,12 @@ int32_t main(int32_t argc, char* argv[])
 
                     EbStartTime((uint64_t*)&configs[instanceCount]->performance_context.lib_start_time[0], (uint64_t*)&configs[instanceCount]->performance_context.lib_start_time[1]);
 
-                    return_errors[instanceCount] = init_encoder(configs[instanceCount], appCallbacks[instanceCount], instanceCount);
+                    // With share_analysis, channel 1 leads the ladder the other channels encode
+                    return_errors[instanceCount] = init_encoder(
+                        configs[instanceCount],
+                        appCallbacks[instanceCount],
+                        instanceCount,
+                        (instanceCount > 0 && configs[instanceCount]->share_analysis && return_errors[0] == EB_ErrorNone) ? appCallbacks[0] : (EbAppContext*)NULL);
                     return_error = (EbErrorType)(return_error | return_errors[instanceCount]);
                 }
                 else {
@@ -192,6 +285,7 @@ int32_t main(int32_t argc, char* argv[])
                 }
                 printf("Encoding          ");
                 fflush(stdout);
+                EbProcessCpuTimeMs(&cpuStartTime);
 
                 while (exitCondition == APP_ExitConditionNone) {
                     exitCondition = APP_ExitConditionFinished;
@@ -261,6 +355,7 @@ int32_t main(int32_t argc, char* argv[])
                         }
                     }
                 }
+                EbProcessCpuTimeMs(&cpuFinishTime);
                 printf("\n");
                 fflush(stdout);
             }
@@ -289,6 +384,19 @@ int32_t main(int32_t argc, char* argv[])
                                 (uint32_t)(configs[instanceCount]->performance_context.max_latency));
 
                         }
+                        printf("Input Read Time:\t%.0f ms\nInput Send Time:\t%.0f ms\n",
+                            configs[instanceCount]->performance_context.total_input_time,
+                            configs[instanceCount]->performance_context.total_send_time);
+
+                        PrintPipelineStats(
+                            configs[instanceCount],
+                            appCallbacks[instanceCount],
+                            instanceCount);
+
+                        if (configs[instanceCount]->memory_stats)
+                            PrintMemoryStats(
+                                appCallbacks[instanceCount],
+                                instanceCount);
                     }
                     else {
                         printf("\nChannel %u Encoding Interrupted\n", (uint32_t)(instanceCount + 1));
@@ -301,6 +409,9 @@ int32_t main(int32_t argc, char* argv[])
                     printf("Error encoding at channel %u! Check error log file for more details ... \n", instanceCount + 1);
                 }
             }
+            // The channels of an ABR ladder run in this process: the CPU they took together
+            printf("\nTotal CPU Time:\t\t%.0f ms (%u channels)\n", cpuFinishTime - cpuStartTime, num_channels);
+
             // DeInit Encoder
             for (instanceCount = num_channels; instanceCount > 0; --instanceCount) {
                 if (return_errors[instanceCount - 1] == EB_ErrorNone)
@@ -14,6 +14,7 @@
 #include "EbAppConfig.h"
 #include "EbSvtAv1ErrorCodes.h"
 #include "EbAppInputy4m.h"
+#include "EbAppInputMap.h"
 
 #include "EbSvtAv1Time.h"
 
@@ -756,7 +757,7 @@ int32_t GetNextQpFromQpFile(
     return qp;
 }
 
-void ReadInputFrames(
+EbErrorType ReadInputFrames(
     EbConfig                  *config,
     uint8_t                      is16bit,
     EbBufferHeaderType         *headerPtr)
@@ -772,6 +773,14 @@ void ReadInputFrames(
     const uint8_t color_format = config->encoder_color_format;
     const uint8_t subsampling_x = (color_format == EB_YUV444 ? 1 : 2) - 1;
 
+    // Mapped input: the planes point into the file
+    if (config->input_map) {
+        return input_map_read_frame(
+            config,
+            is16bit,
+            headerPtr);
+    }
+
     inputPtr->y_stride  = input_padded_width;
     inputPtr->cr_stride = input_padded_width >> subsampling_x;
     inputPtr->cb_stride = input_padded_width >> subsampling_x;
@@ -919,7 +928,7 @@ void ReadInputFrames(
         fseek(input_file, 0, SEEK_SET);
     }
 
-    return;
+    return EB_ErrorNone;
 }
 
 void SendQpOnTheFly(
@@ -981,6 +990,10 @@ AppExitConditionType ProcessInputBuffer(
     const int64_t frames_to_be_encoded = config->frames_to_be_encoded;
     int64_t totalBytesToProcessCount;
     int64_t remainingByteCount;
+    uint64_t startSeconds, startuSeconds;
+    uint64_t finishSeconds, finishuSeconds;
+    double   elapsedTime;
+    EbErrorType readError;
     uint32_t compressed10bitFrameSize = (input_padded_width*input_padded_height) + 2 * ((input_padded_width*input_padded_width) >> (3 - color_format));
     compressed10bitFrameSize += compressed10bitFrameSize / 4;
 
@@ -997,10 +1010,21 @@ AppExitConditionType ProcessInputBuffer(
 
     // If there are bytes left to encode, configure the header
     if (remainingByteCount != 0 && config->stop_encoder == EB_FALSE) {
-        ReadInputFrames(
+        // Time the app spends on its input, to tell I/O stalls from encoder stalls
+        EbStartTime(&startSeconds, &startuSeconds);
+        readError = ReadInputFrames(
             config,
             is16bit,
             headerPtr);
+        EbFinishTime(&finishSeconds, &finishuSeconds);
+        EbComputeOverallElapsedTimeMs(startSeconds, startuSeconds, finishSeconds, finishuSeconds, &elapsedTime);
+        config->performance_context.total_input_time += elapsedTime;
+
+        // Stop at a broken frame, which is not sent
+        if (readError != EB_ErrorNone) {
+            config->stop_encoder = EB_TRUE;
+            return APP_ExitConditionError;
+        }
 
         // Update the context parameters
         config->processed_byte_count += headerPtr->n_filled_len;
@@ -1023,8 +1047,12 @@ AppExitConditionType ProcessInputBuffer(
 
         headerPtr->flags = 0;
 
-        // Send the picture
+        // Send the picture, blocking while the library has no free input buffer
+        EbStartTime(&startSeconds, &startuSeconds);
         eb_svt_enc_send_picture(componentHandle, headerPtr);
+        EbFinishTime(&finishSeconds, &finishuSeconds);
+        EbComputeOverallElapsedTimeMs(startSeconds, startuSeconds, finishSeconds, finishuSeconds, &elapsedTime);
+        config->performance_context.total_send_time += elapsedTime;
 
         if ((config->processed_frame_count == (uint64_t)config->frames_to_be_encoded) || config->stop_encoder) {
 
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 //#if   (LINUX_ENCODER_TIMING || LINUX_DECODER_TIMING)
 #include <sys/time.h>
+#include <sys/resource.h>
 #include <time.h>
 //#endif
 
@@ -87,6 +88,49 @@ void EbComputeOverallElapsedTime(
 
 #endif
 
+}
+void EbComputeOverallElapsedTimeMs(
+    uint64_t Startseconds,
+    uint64_t Startuseconds,
+    uint64_t Finishseconds,
+    uint64_t Finishuseconds,
+    double *duration){
+#if defined(__linux__) || defined(__APPLE__)
+    *duration = (double)(Finishseconds - Startseconds) * 1000 +
+        ((double)Finishuseconds - (double)Startuseconds) / 1000;
+#elif _WIN32
+    *duration = (double)(Finishseconds - Startseconds) * 1000 / CLOCKS_PER_SEC;
+    (void) (Startuseconds);
+    (void) (Finishuseconds);
+#else
+    (void) (Startuseconds);
+    (void) (Startseconds);
+    (void) (Finishuseconds);
+    (void) (Finishseconds);
+#endif
+}
+/* CPU time of every thread of the process, user and system, in ms */
+void EbProcessCpuTimeMs(
+    double *duration){
+#if defined(__linux__) || defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    *duration = (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 +
+        (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#elif _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    ULARGE_INTEGER kernel100ns, user100ns;
+    *duration = 0;
+    if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        kernel100ns.LowPart = kernelTime.dwLowDateTime;
+        kernel100ns.HighPart = kernelTime.dwHighDateTime;
+        user100ns.LowPart = userTime.dwLowDateTime;
+        user100ns.HighPart = userTime.dwHighDateTime;
+        *duration = (double)(kernel100ns.QuadPart + user100ns.QuadPart) / 10000;
+    }
+#else
+    *duration = 0;
+#endif
 }
 void EbSleep(
     uint64_t milliSeconds){
@@ -0,0 +1,118 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "EbDefinitions.h"
+#include <immintrin.h>
+
+// Rows y and y + 1 of a 16 wide block
+static INLINE __m256i load_rows_16x2(const uint8_t *src, int32_t stride)
+{
+    const __m128i row0 = _mm_loadu_si128((const __m128i *)src);
+    const __m128i row1 = _mm_loadu_si128((const __m128i *)(src + stride));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(row0), row1, 1);
+}
+
+// Raster position in the block of the first sample not matched yet, -1
+// when all the samples are matched
+static INLINE int32_t find_unmatched_16x16(const __m256i *matched)
+{
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+        uint32_t unmatched = ~(uint32_t)_mm256_movemask_epi8(matched[i]);
+        if (unmatched) {
+            int32_t pos = 0;
+            while (!(unmatched & 1)) {
+                unmatched >>= 1;
+                pos++;
+            }
+            // low lane is row 2 * i, high lane row 2 * i + 1
+            return (int32_t)(i << 5) + pos;
+        }
+    }
+    return -1;
+}
+
+/*********************************************************************
+ * eb_count_colors_16x16_avx2
+ *   The block stays in registers: each pass marks the samples equal to
+ *   the first unmatched sample, so a block of n colors takes n passes.
+ *********************************************************************/
+uint32_t eb_count_colors_16x16_avx2(
+    const uint8_t *src,
+    int32_t        stride,
+    uint32_t       limit)
+{
+    __m256i  rows[8];
+    __m256i  matched[8];
+    uint32_t count = 0;
+    int32_t  pos = 0;
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+        rows[i] = load_rows_16x2(src + 2 * i * stride, stride);
+        matched[i] = _mm256_setzero_si256();
+    }
+
+    do {
+        const __m256i color = _mm256_set1_epi8((char)src[(pos >> 4) * stride + (pos & 15)]);
+
+        if (count == limit)
+            return limit + 1;
+        count++;
+
+        for (i = 0; i < 8; i++)
+            matched[i] = _mm256_or_si256(matched[i], _mm256_cmpeq_epi8(rows[i], color));
+
+        pos = find_unmatched_16x16(matched);
+    } while (pos >= 0);
+
+    return count;
+}
+
+/*********************************************************************
+ * eb_count_colors_16x16_highbd_avx2
+ *   Same as eb_count_colors_16x16_avx2, a color is the pair of the
+ *   8-bit sample and of its 2 extra bits.
+ *********************************************************************/
+uint32_t eb_count_colors_16x16_highbd_avx2(
+    const uint8_t *src,
+    int32_t        stride,
+    const uint8_t *src_bit_inc,
+    int32_t        bit_inc_stride,
+    uint32_t       limit)
+{
+    const __m256i bit_inc_mask = _mm256_set1_epi8((char)0xC0);
+    __m256i  rows[8];
+    __m256i  rows_bit_inc[8];
+    __m256i  matched[8];
+    uint32_t count = 0;
+    int32_t  pos = 0;
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+        rows[i] = load_rows_16x2(src + 2 * i * stride, stride);
+        rows_bit_inc[i] = _mm256_and_si256(load_rows_16x2(src_bit_inc + 2 * i * bit_inc_stride, bit_inc_stride), bit_inc_mask);
+        matched[i] = _mm256_setzero_si256();
+    }
+
+    do {
+        const __m256i color = _mm256_set1_epi8((char)src[(pos >> 4) * stride + (pos & 15)]);
+        const __m256i color_bit_inc = _mm256_set1_epi8((char)(src_bit_inc[(pos >> 4) * bit_inc_stride + (pos & 15)] & 0xC0));
+
+        if (count == limit)
+            return limit + 1;
+        count++;
+
+        for (i = 0; i < 8; i++)
+            matched[i] = _mm256_or_si256(matched[i], _mm256_and_si256(
+                _mm256_cmpeq_epi8(rows[i], color),
+                _mm256_cmpeq_epi8(rows_bit_inc[i], color_bit_inc)));
+
+        pos = find_unmatched_16x16(matched);
+    } while (pos >= 0);
+
+    return count;
+}
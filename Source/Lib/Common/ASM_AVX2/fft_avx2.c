@@ -12,6 +12,7 @@
 #include <immintrin.h>
 
 #include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
 #include "fft_common.h"
 
 extern void aom_transpose_float_sse2(const float *A, float *B, int32_t n);
@@ -71,3 +72,38 @@ void aom_ifft32x32_float_avx2(const float *input, float *temp, float *output) {
         aom_fft1d_32_avx2, aom_ifft1d_32_avx2,
         aom_transpose_float_sse2, 8);
 }
+
+// Wiener filter of 8 complex coefficients per iteration, matches
+// aom_noise_tx_filter_block_c
+void aom_noise_tx_filter_block_avx2(float *tx_block, const float *psd,
+    int32_t n) {
+    const __m256 beta = _mm256_set1_ps(1.1f);
+    const __m256 eps = _mm256_set1_ps(1e-6f);
+    const __m256 attenuation = _mm256_set1_ps((1.1f - 1.0f) / 1.1f);
+    const __m256i lo_idx = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i hi_idx = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+    int32_t i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        const __m256 c_lo = _mm256_loadu_ps(tx_block + 2 * i);
+        const __m256 c_hi = _mm256_loadu_ps(tx_block + 2 * i + 8);
+        const __m256 psd_v = _mm256_loadu_ps(psd + i);
+        // Power of coefficients 0 1 4 5 2 3 6 7, reordered to 0..7
+        const __m256 sum = _mm256_hadd_ps(_mm256_mul_ps(c_lo, c_lo),
+            _mm256_mul_ps(c_hi, c_hi));
+        const __m256 p = _mm256_castsi256_ps(_mm256_permute4x64_epi64(
+            _mm256_castps_si256(sum), 0xd8));
+        const __m256 pass = _mm256_and_ps(
+            _mm256_cmp_ps(p, _mm256_mul_ps(beta, psd_v), _CMP_GT_OQ),
+            _mm256_cmp_ps(p, eps, _CMP_GT_OQ));
+        const __m256 gain = _mm256_div_ps(_mm256_sub_ps(p, psd_v),
+            _mm256_max_ps(p, eps));
+        const __m256 scale = _mm256_blendv_ps(attenuation, gain, pass);
+        _mm256_storeu_ps(tx_block + 2 * i,
+            _mm256_mul_ps(c_lo, _mm256_permutevar8x32_ps(scale, lo_idx)));
+        _mm256_storeu_ps(tx_block + 2 * i + 8,
+            _mm256_mul_ps(c_hi, _mm256_permutevar8x32_ps(scale, hi_idx)));
+    }
+    if (i < n)
+        aom_noise_tx_filter_block_c(tx_block + 2 * i, psd + i, n - i);
+}
@@ -0,0 +1,264 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <immintrin.h>
+
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+
+// Scaling function of 8 samples. The LUT has 257 entries, so that the
+// interpolation of the last entry adds 0 like the C LUT lookup.
+static INLINE __m256i scale_lut_avx2(const int32_t *scaling_lut,
+    const __m256i index, int32_t bit_depth) {
+    if (bit_depth == 8)
+        return _mm256_i32gather_epi32(scaling_lut, index, 4);
+
+    const __m128i shift = _mm_cvtsi32_si128(bit_depth - 8);
+    const __m256i x = _mm256_srl_epi32(index, shift);
+    const __m256i frac =
+        _mm256_and_si256(index, _mm256_set1_epi32((1 << (bit_depth - 8)) - 1));
+    const __m256i s0 = _mm256_i32gather_epi32(scaling_lut, x, 4);
+    const __m256i s1 = _mm256_i32gather_epi32(scaling_lut + 1, x, 4);
+    const __m256i delta = _mm256_add_epi32(
+        _mm256_mullo_epi32(_mm256_sub_epi32(s1, s0), frac),
+        _mm256_set1_epi32(1 << (bit_depth - 9)));
+    return _mm256_add_epi32(s0, _mm256_sra_epi32(delta, shift));
+}
+
+// clamp(pixel + ((scale * grain + round) >> scaling_shift), min, max)
+static INLINE __m256i add_noise_avx2(const __m256i pixel, const __m256i scale,
+    const int32_t *grain, const __m256i round, const __m128i scaling_shift,
+    const __m256i min, const __m256i max) {
+    const __m256i noise = _mm256_sra_epi32(
+        _mm256_add_epi32(
+            _mm256_mullo_epi32(scale, _mm256_loadu_si256((const __m256i *)grain)),
+            round),
+        scaling_shift);
+    return _mm256_min_epi32(
+        _mm256_max_epi32(_mm256_add_epi32(pixel, noise), min), max);
+}
+
+static INLINE void store_u8_8x32(uint8_t *dst, const __m256i src) {
+    const __m128i s16 = _mm_packus_epi32(_mm256_castsi256_si128(src),
+        _mm256_extracti128_si256(src, 1));
+    _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(s16, s16));
+}
+
+static INLINE void store_u16_8x32(uint16_t *dst, const __m256i src) {
+    _mm_storeu_si128((__m128i *)dst,
+        _mm_packus_epi32(_mm256_castsi256_si128(src),
+            _mm256_extracti128_si256(src, 1)));
+}
+
+void fgn_ar_row_sum_avx2(const int32_t *grain, int32_t grain_stride,
+    const int32_t *ar_coeffs, int32_t lag, int32_t width, int32_t *wsum) {
+    int32_t j;
+
+    for (j = 0; j + 8 <= width; j += 8) {
+        __m256i sum = _mm256_setzero_si256();
+        int32_t pos = 0;
+        for (int32_t row = -lag; row < 0; row++) {
+            const int32_t *src = grain + row * grain_stride + j;
+            for (int32_t col = -lag; col <= lag; col++) {
+                sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(
+                    _mm256_set1_epi32(ar_coeffs[pos++]),
+                    _mm256_loadu_si256((const __m256i *)(src + col))));
+            }
+        }
+        _mm256_storeu_si256((__m256i *)(wsum + j), sum);
+    }
+    if (j < width)
+        fgn_ar_row_sum_c(grain + j, grain_stride, ar_coeffs, lag, width - j,
+            wsum + j);
+}
+
+void fgn_luma_noise_row_avx2(uint8_t *luma, const int32_t *grain, int32_t width,
+    const int32_t *scaling_lut, int32_t scaling_shift, int32_t min_luma,
+    int32_t max_luma) {
+    const __m256i round = _mm256_set1_epi32(1 << (scaling_shift - 1));
+    const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+    const __m256i min = _mm256_set1_epi32(min_luma);
+    const __m256i max = _mm256_set1_epi32(max_luma);
+    int32_t j;
+
+    for (j = 0; j + 8 <= width; j += 8) {
+        const __m256i l =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(luma + j)));
+        const __m256i scale = scale_lut_avx2(scaling_lut, l, 8);
+        store_u8_8x32(luma + j,
+            add_noise_avx2(l, scale, grain + j, round, shift, min, max));
+    }
+    if (j < width)
+        fgn_luma_noise_row_c(luma + j, grain + j, width - j, scaling_lut,
+            scaling_shift, min_luma, max_luma);
+}
+
+void fgn_luma_noise_row_hbd_avx2(uint16_t *luma, const int32_t *grain,
+    int32_t width, const int32_t *scaling_lut, int32_t bit_depth,
+    int32_t scaling_shift, int32_t min_luma, int32_t max_luma) {
+    const __m256i round = _mm256_set1_epi32(1 << (scaling_shift - 1));
+    const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+    const __m256i min = _mm256_set1_epi32(min_luma);
+    const __m256i max = _mm256_set1_epi32(max_luma);
+    int32_t j;
+
+    for (j = 0; j + 8 <= width; j += 8) {
+        const __m256i l =
+            _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(luma + j)));
+        const __m256i scale = scale_lut_avx2(scaling_lut, l, bit_depth);
+        store_u16_8x32(luma + j,
+            add_noise_avx2(l, scale, grain + j, round, shift, min, max));
+    }
+    if (j < width)
+        fgn_luma_noise_row_hbd_c(luma + j, grain + j, width - j, scaling_lut,
+            bit_depth, scaling_shift, min_luma, max_luma);
+}
+
+// Scaling function index of the chroma:
+// clamp(((average_luma * luma_mult + mult * chroma) >> 6) + offset, 0, max)
+static INLINE __m256i chroma_index_avx2(const __m256i average_luma,
+    const __m256i chroma, const __m256i mult, const __m256i luma_mult,
+    const __m256i offset, const __m256i max) {
+    const __m256i combined = _mm256_add_epi32(
+        _mm256_srai_epi32(
+            _mm256_add_epi32(_mm256_mullo_epi32(average_luma, luma_mult),
+                _mm256_mullo_epi32(mult, chroma)),
+            6),
+        offset);
+    return _mm256_min_epi32(
+        _mm256_max_epi32(combined, _mm256_setzero_si256()), max);
+}
+
+// (luma[2j] + luma[2j + 1] + 1) >> 1 of 16 samples widened to 16 bits
+static INLINE __m256i average_luma_avx2(const __m256i luma16) {
+    return _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_madd_epi16(luma16, _mm256_set1_epi16(1)),
+            _mm256_set1_epi32(1)),
+        1);
+}
+
+void fgn_chroma_noise_row_avx2(uint8_t *chroma, const uint8_t *luma,
+    const int32_t *grain, int32_t width, const int32_t *scaling_lut,
+    int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset,
+    int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma) {
+    const __m256i round = _mm256_set1_epi32(1 << (scaling_shift - 1));
+    const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+    const __m256i min = _mm256_set1_epi32(min_chroma);
+    const __m256i max = _mm256_set1_epi32(max_chroma);
+    const __m256i mult_v = _mm256_set1_epi32(mult);
+    const __m256i luma_mult_v = _mm256_set1_epi32(luma_mult);
+    const __m256i offset_v = _mm256_set1_epi32(offset);
+    const __m256i max_index = _mm256_set1_epi32(255);
+    int32_t j;
+
+    for (j = 0; j + 8 <= width; j += 8) {
+        const __m256i c =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(chroma + j)));
+        __m256i average_luma;
+        if (chroma_subsamp_x)
+            average_luma = average_luma_avx2(_mm256_cvtepu8_epi16(
+                _mm_loadu_si128((const __m128i *)(luma + (j << 1)))));
+        else
+            average_luma = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((const __m128i *)(luma + j)));
+
+        const __m256i index = chroma_index_avx2(average_luma, c, mult_v,
+            luma_mult_v, offset_v, max_index);
+        const __m256i scale = scale_lut_avx2(scaling_lut, index, 8);
+        store_u8_8x32(chroma + j,
+            add_noise_avx2(c, scale, grain + j, round, shift, min, max));
+    }
+    if (j < width)
+        fgn_chroma_noise_row_c(chroma + j, luma + (j << chroma_subsamp_x),
+            grain + j, width - j, scaling_lut, chroma_subsamp_x, mult,
+            luma_mult, offset, scaling_shift, min_chroma, max_chroma);
+}
+
+void fgn_chroma_noise_row_hbd_avx2(uint16_t *chroma, const uint16_t *luma,
+    const int32_t *grain, int32_t width, const int32_t *scaling_lut,
+    int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset,
+    int32_t bit_depth, int32_t scaling_shift, int32_t min_chroma,
+    int32_t max_chroma) {
+    const __m256i round = _mm256_set1_epi32(1 << (scaling_shift - 1));
+    const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+    const __m256i min = _mm256_set1_epi32(min_chroma);
+    const __m256i max = _mm256_set1_epi32(max_chroma);
+    const __m256i mult_v = _mm256_set1_epi32(mult);
+    const __m256i luma_mult_v = _mm256_set1_epi32(luma_mult);
+    const __m256i offset_v = _mm256_set1_epi32(offset);
+    const __m256i max_index = _mm256_set1_epi32((256 << (bit_depth - 8)) - 1);
+    int32_t j;
+
+    for (j = 0; j + 8 <= width; j += 8) {
+        const __m256i c = _mm256_cvtepu16_epi32(
+            _mm_loadu_si128((const __m128i *)(chroma + j)));
+        __m256i average_luma;
+        if (chroma_subsamp_x)
+            average_luma = average_luma_avx2(
+                _mm256_loadu_si256((const __m256i *)(luma + (j << 1))));
+        else
+            average_luma = _mm256_cvtepu16_epi32(
+                _mm_loadu_si128((const __m128i *)(luma + j)));
+
+        const __m256i index = chroma_index_avx2(average_luma, c, mult_v,
+            luma_mult_v, offset_v, max_index);
+        const __m256i scale = scale_lut_avx2(scaling_lut, index, bit_depth);
+        store_u16_8x32(chroma + j,
+            add_noise_avx2(c, scale, grain + j, round, shift, min, max));
+    }
+    if (j < width)
+        fgn_chroma_noise_row_hbd_c(chroma + j, luma + (j << chroma_subsamp_x),
+            grain + j, width - j, scaling_lut, chroma_subsamp_x, mult,
+            luma_mult, offset, bit_depth, scaling_shift, min_chroma,
+            max_chroma);
+}
+
+// clamp((a * wa + b * wb + 16) >> 5, min, max) of 8 grain samples
+static INLINE void blend_grain_avx2(const int32_t *a, const int32_t *b,
+    int32_t *dst, const __m256i wa, const __m256i wb, const __m256i min,
+    const __m256i max) {
+    const __m256i sum = _mm256_add_epi32(
+        _mm256_add_epi32(
+            _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)a), wa),
+            _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)b), wb)),
+        _mm256_set1_epi32(16));
+    _mm256_storeu_si256((__m256i *)dst, _mm256_min_epi32(
+        _mm256_max_epi32(_mm256_srai_epi32(sum, 5), min), max));
+}
+
+void fgn_hor_boundary_overlap_avx2(const int32_t *top_block,
+    int32_t top_stride, const int32_t *bottom_block, int32_t bottom_stride,
+    int32_t *dst_block, int32_t dst_stride, int32_t width, int32_t height,
+    int32_t grain_min, int32_t grain_max) {
+    const __m256i min = _mm256_set1_epi32(grain_min);
+    const __m256i max = _mm256_set1_epi32(grain_max);
+    int32_t j;
+
+    if (height == 1) {
+        const __m256i w0 = _mm256_set1_epi32(23);
+        const __m256i w1 = _mm256_set1_epi32(22);
+        for (j = 0; j + 8 <= width; j += 8)
+            blend_grain_avx2(top_block + j, bottom_block + j, dst_block + j,
+                w0, w1, min, max);
+    }
+    else if (height == 2) {
+        const __m256i w0 = _mm256_set1_epi32(27);
+        const __m256i w1 = _mm256_set1_epi32(17);
+        for (j = 0; j + 8 <= width; j += 8) {
+            blend_grain_avx2(top_block + j, bottom_block + j, dst_block + j,
+                w0, w1, min, max);
+            blend_grain_avx2(top_block + top_stride + j,
+                bottom_block + bottom_stride + j, dst_block + dst_stride + j,
+                w1, w0, min, max);
+        }
+    }
+    else
+        return;
+
+    if (j < width)
+        fgn_hor_boundary_overlap_c(top_block + j, top_stride, bottom_block + j,
+            bottom_stride, dst_block + j, dst_stride, width - j, height,
+            grain_min, grain_max);
+}
@@ -0,0 +1,293 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include "EbDefinitions.h"
+#include "immintrin.h"
+#include "aom_dsp_rtcd.h"
+
+#if NSQ_ME_OPT
+
+/*******************************************************************************
+* ext_all_sad_calculation_8x8_16x16_avx512
+*   Same results as the AVX2 version. The four 8x8 blocks of a 16x16 block
+*   take one 128-bit lane each, so a vdbpsadbw pair covers the eight search
+*   positions of all of them for one row.
+*******************************************************************************/
+void ext_all_sad_calculation_8x8_16x16_avx512(
+    uint8_t   *src,
+    uint32_t   src_stride,
+    uint8_t   *ref,
+    uint32_t   ref_stride,
+    uint32_t   mv,
+    uint32_t  *p_best_sad8x8,
+    uint32_t  *p_best_sad16x16,
+    uint32_t  *p_best_mv8x8,
+    uint32_t  *p_best_mv16x16,
+    uint32_t   p_eight_sad16x16[16][8],
+    uint32_t   p_eight_sad8x8[64][8])
+{
+    static const char offsets[16] = {
+        0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15
+    };
+    // Source dwords 0 and 1 of each 8x8 block row, broadcast to its lane
+    const __m512i src_idx0 = _mm512_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2, 4, 4, 4, 4, 6, 6, 6, 6);
+    const __m512i src_idx1 = _mm512_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3, 5, 5, 5, 5, 7, 7, 7, 7);
+    const __m128i mvs = _mm_set1_epi32(mv);
+
+    //---- 16x16 : 0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            const uint32_t start_16x16_pos = offsets[4 * y + x];
+            const uint32_t start_8x8_pos = 4 * start_16x16_pos;
+            const uint8_t *s = src + 16 * y * src_stride + 16 * x;
+            const uint8_t *r = ref + 16 * y * ref_stride + 16 * x;
+            __m512i sad = _mm512_setzero_si512();
+
+            for (int i = 0; i < 4; i++)
+            {
+                const __m128i src01 = _mm_loadu_si128((__m128i *)(s + 0 * src_stride));
+                const __m128i src23 = _mm_loadu_si128((__m128i *)(s + 8 * src_stride));
+                const __m512i src0123 = _mm512_castsi256_si512(
+                    _mm256_inserti128_si256(_mm256_castsi128_si256(src01), src23, 1));
+                const __m512i src_lo = _mm512_permutexvar_epi32(src_idx0, src0123);
+                const __m512i src_hi = _mm512_permutexvar_epi32(src_idx1, src0123);
+
+                // Lane k holds the 16 reference pixels of block k
+                __m512i ref0123 = _mm512_castsi128_si512(_mm_loadu_si128((__m128i *)(r + 0 * ref_stride + 0)));
+                ref0123 = _mm512_inserti32x4(ref0123, _mm_loadu_si128((__m128i *)(r + 0 * ref_stride + 8)), 1);
+                ref0123 = _mm512_inserti32x4(ref0123, _mm_loadu_si128((__m128i *)(r + 8 * ref_stride + 0)), 2);
+                ref0123 = _mm512_inserti32x4(ref0123, _mm_loadu_si128((__m128i *)(r + 8 * ref_stride + 8)), 3);
+
+                // Pixels 0..3 against ref dwords 0,1,1,2 and 4..7 against 1,2,2,3
+                sad = _mm512_add_epi16(sad, _mm512_dbsad_epu8(src_lo, ref0123, 0x94));
+                sad = _mm512_add_epi16(sad, _mm512_dbsad_epu8(src_hi, ref0123, 0xE9));
+                s += 2 * src_stride;
+                r += 2 * ref_stride;
+            }
+
+            sad = _mm512_slli_epi16(sad, 1);
+
+            const __m256i sad01 = _mm512_castsi512_si256(sad);
+            const __m256i sad23 = _mm512_extracti64x4_epi64(sad, 1);
+            _mm512_storeu_si512((__m512i*)(p_eight_sad8x8[0 + start_8x8_pos]), _mm512_cvtepu16_epi32(sad01));
+            _mm512_storeu_si512((__m512i*)(p_eight_sad8x8[2 + start_8x8_pos]), _mm512_cvtepu16_epi32(sad23));
+
+            const __m128i sad0 = _mm256_castsi256_si128(sad01);
+            const __m128i sad1 = _mm256_extracti128_si256(sad01, 1);
+            const __m128i sad2 = _mm256_castsi256_si128(sad23);
+            const __m128i sad3 = _mm256_extracti128_si256(sad23, 1);
+
+            const __m128i minpos0 = _mm_minpos_epu16(sad0);
+            const __m128i minpos1 = _mm_minpos_epu16(sad1);
+            const __m128i minpos2 = _mm_minpos_epu16(sad2);
+            const __m128i minpos3 = _mm_minpos_epu16(sad3);
+
+            const __m128i minpos01 = _mm_unpacklo_epi16(minpos0, minpos1);
+            const __m128i minpos23 = _mm_unpacklo_epi16(minpos2, minpos3);
+            const __m128i minpos0123 = _mm_unpacklo_epi32(minpos01, minpos23);
+            const __m128i sad8x8 = _mm_unpacklo_epi16(minpos0123, _mm_setzero_si128());
+            const __m128i pos0123 = _mm_unpackhi_epi16(minpos0123, _mm_setzero_si128());
+            const __m128i pos8x8 = _mm_slli_epi32(pos0123, 2);
+
+            __m128i best_sad8x8 = _mm_loadu_si128((__m128i *)(p_best_sad8x8 + start_8x8_pos));
+            const __mmask8 mask = _mm_cmplt_epu32_mask(sad8x8, best_sad8x8);
+            best_sad8x8 = _mm_min_epu32(best_sad8x8, sad8x8);
+            _mm_storeu_si128((__m128i *)(p_best_sad8x8 + start_8x8_pos), best_sad8x8);
+
+            __m128i best_mv8x8 = _mm_loadu_si128((__m128i *)(p_best_mv8x8 + start_8x8_pos));
+            const __m128i mv8x8 = _mm_add_epi16(mvs, pos8x8);
+            best_mv8x8 = _mm_mask_mov_epi32(best_mv8x8, mask, mv8x8);
+            _mm_storeu_si128((__m128i *)(p_best_mv8x8 + start_8x8_pos), best_mv8x8);
+
+            const __m256i sum0123 = _mm256_add_epi16(sad01, sad23);
+            const __m128i sad16x16_16 = _mm_add_epi16(
+                _mm256_castsi256_si128(sum0123), _mm256_extracti128_si256(sum0123, 1));
+            _mm256_storeu_si256((__m256i*)(p_eight_sad16x16[start_16x16_pos]), _mm256_cvtepu16_epi32(sad16x16_16));
+
+            const __m128i minpos16x16 = _mm_minpos_epu16(sad16x16_16);
+            const uint32_t min16x16 = _mm_extract_epi16(minpos16x16, 0);
+
+            if (min16x16 < p_best_sad16x16[start_16x16_pos]) {
+                p_best_sad16x16[start_16x16_pos] = min16x16;
+
+                const __m128i pos = _mm_srli_si128(minpos16x16, 2);
+                const __m128i pos16x16 = _mm_slli_epi32(pos, 2);
+                const __m128i mv16x16 = _mm_add_epi16(mvs, pos16x16);
+                p_best_mv16x16[start_16x16_pos] = _mm_extract_epi32(mv16x16, 0);
+            }
+        }
+    }
+}
+
+/* Minimum of (x << 3 | idx) within each 256-bit half, in dword 0 of
+   lanes 0 and 2. SADs must fit in 29 bits. */
+static INLINE __m512i avx512_min_pos_x2(const __m512i in) {
+    const __m512i idx = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512i x = _mm512_add_epi32(_mm512_slli_epi32(in, 3), idx);
+    const __m512i m1 = _mm512_min_epu32(x, _mm512_shuffle_epi32(x, 0x4E));
+    const __m512i m2 = _mm512_min_epu32(m1, _mm512_shuffle_epi32(m1, 0xB1));
+    return _mm512_min_epu32(m2, _mm512_shuffle_i64x2(m2, m2, 0xB1));
+}
+
+void ext_eight_sad_calculation_32x32_64x64_avx512(
+    uint32_t  p_sad16x16[16][8],
+    uint32_t *p_best_sad32x32,
+    uint32_t *p_best_sad64x64,
+    uint32_t *p_best_mv32x32,
+    uint32_t *p_best_mv64x64,
+    uint32_t  mv,
+    uint32_t p_sad32x32[4][8]) {
+    // Each register holds two 16x16 rows, each 32x32 sums four consecutive rows
+    const __m512i sum01 = _mm512_add_epi32(
+        _mm512_loadu_si512((__m512i const *)p_sad16x16[0]),
+        _mm512_loadu_si512((__m512i const *)p_sad16x16[2]));
+    const __m512i sum23 = _mm512_add_epi32(
+        _mm512_loadu_si512((__m512i const *)p_sad16x16[4]),
+        _mm512_loadu_si512((__m512i const *)p_sad16x16[6]));
+    const __m512i sum45 = _mm512_add_epi32(
+        _mm512_loadu_si512((__m512i const *)p_sad16x16[8]),
+        _mm512_loadu_si512((__m512i const *)p_sad16x16[10]));
+    const __m512i sum67 = _mm512_add_epi32(
+        _mm512_loadu_si512((__m512i const *)p_sad16x16[12]),
+        _mm512_loadu_si512((__m512i const *)p_sad16x16[14]));
+
+    const __m512i sad32_ab = _mm512_add_epi32(
+        _mm512_shuffle_i64x2(sum01, sum23, 0x44),
+        _mm512_shuffle_i64x2(sum01, sum23, 0xEE));
+    const __m512i sad32_cd = _mm512_add_epi32(
+        _mm512_shuffle_i64x2(sum45, sum67, 0x44),
+        _mm512_shuffle_i64x2(sum45, sum67, 0xEE));
+    _mm512_storeu_si512((__m512i *)p_sad32x32[0], sad32_ab);
+    _mm512_storeu_si512((__m512i *)p_sad32x32[2], sad32_cd);
+
+    const __m512i sum_abcd = _mm512_add_epi32(sad32_ab, sad32_cd);
+    const __m512i sad64x64 = _mm512_add_epi32(sum_abcd, _mm512_shuffle_i64x2(sum_abcd, sum_abcd, 0x4E));
+
+    // Best (sad << 3 | idx) of 32x32 blocks a, b, c, d and of the 64x64
+    const __m512i min_ab = avx512_min_pos_x2(sad32_ab);
+    const __m512i min_cd = avx512_min_pos_x2(sad32_cd);
+    const __m512i min_64 = avx512_min_pos_x2(sad64x64);
+    const __m128i min_abcd = _mm512_castsi512_si128(_mm512_permutex2var_epi32(
+        min_ab, _mm512_setr_epi32(0, 8, 16, 24, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0), min_cd));
+    const __m128i min_e = _mm512_castsi512_si128(min_64);
+
+    const __m128i mvs = _mm_set1_epi32(mv);
+    const __m128i idx7 = _mm_set1_epi32(7);
+
+    // mv advances by 4 per search position, in the x component only
+    const __m128i sad32x32 = _mm_srli_epi32(min_abcd, 3);
+    const __m128i mv32x32 = _mm_add_epi16(mvs, _mm_slli_epi32(_mm_and_si128(min_abcd, idx7), 2));
+    __m128i best_sad32x32 = _mm_loadu_si128((__m128i *)p_best_sad32x32);
+    const __mmask8 mask = _mm_cmplt_epu32_mask(sad32x32, best_sad32x32);
+    best_sad32x32 = _mm_mask_mov_epi32(best_sad32x32, mask, sad32x32);
+    _mm_storeu_si128((__m128i *)p_best_sad32x32, best_sad32x32);
+    _mm_storeu_si128((__m128i *)p_best_mv32x32, _mm_mask_mov_epi32(
+        _mm_loadu_si128((__m128i *)p_best_mv32x32), mask, mv32x32));
+
+    const uint32_t sad_e = (uint32_t)_mm_cvtsi128_si32(min_e) >> 3;
+    if (sad_e < p_best_sad64x64[0]) {
+        const __m128i mv64x64 = _mm_add_epi16(mvs, _mm_slli_epi32(_mm_and_si128(min_e, idx7), 2));
+        p_best_sad64x64[0] = sad_e;
+        p_best_mv64x64[0] = _mm_cvtsi128_si32(mv64x64);
+    }
+}
+#endif /* NSQ_ME_OPT */
+
+/*******************************************************************************
+* sad_loop_kernel_avx512_intrin
+*   Same results as the C version, for widths that are multiples of 4 up to
+*   64; the other widths go to the AVX2 version. Each pass covers 32 search
+*   positions of a search row: every 128-bit lane takes 8 positions, and one
+*   vdbpsadbw pair matches 8 source pixels of a row against all of them. The
+*   reference reads are masked to the pixels the C version reads.
+*******************************************************************************/
+void sad_loop_kernel_avx512_intrin(
+    uint8_t  *src,                            // input parameter, source samples Ptr
+    uint32_t  src_stride,                      // input parameter, source stride
+    uint8_t  *ref,                            // input parameter, reference samples Ptr
+    uint32_t  ref_stride,                      // input parameter, reference stride
+    uint32_t  height,                         // input parameter, block height (M)
+    uint32_t  width,                          // input parameter, block width (N)
+    uint64_t *best_sad,
+    int16_t *x_search_center,
+    int16_t *y_search_center,
+    uint32_t  src_stride_raw,                   // input parameter, source stride (no line skipping)
+    int16_t search_area_width,
+    int16_t search_area_height)
+{
+    // Lane l holds reference bytes 8 * l to 8 * l + 15 of the pass
+    const __m512i lane_idx = _mm512_setr_epi64(0, 1, 1, 2, 2, 3, 3, 4);
+    const __m512i pos_lo = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i pos_hi = _mm512_add_epi32(pos_lo, _mm512_set1_epi32(16));
+    const uint32_t dword_count = width >> 2;
+    int16_t x_best = *x_search_center, y_best = *y_search_center;
+    uint32_t low_sum = 0xffffff;
+    int16_t i, j;
+    uint32_t k, g;
+
+    if (width == 0 || (width & 3) || width > 64) {
+        sad_loop_kernel_avx2_intrin(src, src_stride, ref, ref_stride, height, width,
+            best_sad, x_search_center, y_search_center, src_stride_raw,
+            search_area_width, search_area_height);
+        return;
+    }
+    // Each row adds up to 255 * width to a 16-bit sum
+    const uint32_t flush_rows = 257 / width;
+
+    for (i = 0; i < search_area_height; i++) {
+        for (j = 0; j < search_area_width; j += 32) {
+            const uint32_t pos_count = search_area_width - j < 32 ? search_area_width - j : 32;
+            const __mmask32 valid = (__mmask32)(pos_count == 32 ? 0xffffffff : ((1u << pos_count) - 1));
+            __m512i sum_lo = _mm512_setzero_si512();
+            __m512i sum_hi = _mm512_setzero_si512();
+            __m512i sum16 = _mm512_setzero_si512();
+            const uint8_t *p_src = src;
+            const uint8_t *p_ref = ref + j;
+
+            for (k = 0; k < height; k++) {
+                for (g = 0; 2 * g < dword_count; g++) {
+                    const EbBool has_odd = (EbBool)(2 * g + 1 < dword_count);
+                    const uint32_t byte_count = pos_count + (has_odd ? 7 : 3);
+                    const __mmask64 load_mask = ((__mmask64)1 << byte_count) - 1;
+                    const __m512i r = _mm512_permutexvar_epi64(lane_idx,
+                        _mm512_maskz_loadu_epi8(load_mask, p_ref + 8 * g));
+
+                    // Positions 0-3 and 4-7 of a lane use reference dwords 0, 1 and 1, 2
+                    sum16 = _mm512_add_epi16(sum16, _mm512_dbsad_epu8(
+                        _mm512_set1_epi32(*(int32_t *)(p_src + 8 * g)), r, 0x94));
+                    if (has_odd)
+                        sum16 = _mm512_add_epi16(sum16, _mm512_dbsad_epu8(
+                            _mm512_set1_epi32(*(int32_t *)(p_src + 8 * g + 4)), r, 0xE9));
+                }
+                p_src += src_stride;
+                p_ref += ref_stride;
+
+                if ((k + 1) % flush_rows == 0 || k + 1 == height) {
+                    sum_lo = _mm512_add_epi32(sum_lo, _mm512_cvtepu16_epi32(_mm512_castsi512_si256(sum16)));
+                    sum_hi = _mm512_add_epi32(sum_hi, _mm512_cvtepu16_epi32(_mm512_extracti64x4_epi64(sum16, 1)));
+                    sum16 = _mm512_setzero_si512();
+                }
+            }
+
+            // The lowest (sad << 5 | position) is the first position of the lowest SAD
+            sum_lo = _mm512_mask_mov_epi32(_mm512_set1_epi32(-1), (__mmask16)valid,
+                _mm512_or_si512(_mm512_slli_epi32(sum_lo, 5), pos_lo));
+            sum_hi = _mm512_mask_mov_epi32(_mm512_set1_epi32(-1), (__mmask16)(valid >> 16),
+                _mm512_or_si512(_mm512_slli_epi32(sum_hi, 5), pos_hi));
+            const uint32_t min_pos = _mm512_reduce_min_epu32(_mm512_min_epu32(sum_lo, sum_hi));
+            if ((min_pos >> 5) < low_sum) {
+                low_sum = min_pos >> 5;
+                x_best = (int16_t)(j + (min_pos & 31));
+                y_best = i;
+            }
+        }
+        ref += src_stride_raw;
+    }
+
+    *best_sad = low_sum;
+    *x_search_center = x_best;
+    *y_search_center = y_best;
+}
+
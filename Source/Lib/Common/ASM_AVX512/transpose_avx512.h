@@ -0,0 +1,61 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef TRANSPOSE_AVX512_H
+#define TRANSPOSE_AVX512_H
+
+#include <immintrin.h>
+#include "EbDefinitions.h"
+
+/* Transposes a 16x16 block of int32, rows are stride registers apart. */
+static INLINE void transpose_16x16_avx512(int32_t stride, const __m512i *in,
+    __m512i *out) {
+    __m512i u[16];
+    int32_t i, k;
+
+    // 4x4 transposes inside each 128-bit lane
+    for (i = 0; i < 16; i += 4) {
+        const __m512i x0 = _mm512_loadu_si512(in + (i + 0) * stride);
+        const __m512i x1 = _mm512_loadu_si512(in + (i + 1) * stride);
+        const __m512i x2 = _mm512_loadu_si512(in + (i + 2) * stride);
+        const __m512i x3 = _mm512_loadu_si512(in + (i + 3) * stride);
+        const __m512i t0 = _mm512_unpacklo_epi32(x0, x1);
+        const __m512i t1 = _mm512_unpackhi_epi32(x0, x1);
+        const __m512i t2 = _mm512_unpacklo_epi32(x2, x3);
+        const __m512i t3 = _mm512_unpackhi_epi32(x2, x3);
+        u[i + 0] = _mm512_unpacklo_epi64(t0, t2);
+        u[i + 1] = _mm512_unpackhi_epi64(t0, t2);
+        u[i + 2] = _mm512_unpacklo_epi64(t1, t3);
+        u[i + 3] = _mm512_unpackhi_epi64(t1, t3);
+    }
+
+    // Lane l of u[k] goes to row 4 * l + k
+    for (k = 0; k < 4; k++) {
+        const __m512i a = _mm512_shuffle_i32x4(u[k], u[4 + k], 0x88);
+        const __m512i b = _mm512_shuffle_i32x4(u[k], u[4 + k], 0xDD);
+        const __m512i c = _mm512_shuffle_i32x4(u[8 + k], u[12 + k], 0x88);
+        const __m512i d = _mm512_shuffle_i32x4(u[8 + k], u[12 + k], 0xDD);
+        _mm512_storeu_si512(out + (0 + k) * stride, _mm512_shuffle_i32x4(a, c, 0x88));
+        _mm512_storeu_si512(out + (4 + k) * stride, _mm512_shuffle_i32x4(b, d, 0x88));
+        _mm512_storeu_si512(out + (8 + k) * stride, _mm512_shuffle_i32x4(a, c, 0xDD));
+        _mm512_storeu_si512(out + (12 + k) * stride, _mm512_shuffle_i32x4(b, d, 0xDD));
+    }
+}
+
+static INLINE void transpose_16nx16n_avx512(int32_t txfm_size,
+    const __m512i *input, __m512i *output) {
+    const int32_t num_per_512 = 16;
+    const int32_t col_size = txfm_size / num_per_512;
+    int32_t r, c;
+
+    for (r = 0; r < txfm_size; r += 16) {
+        for (c = 0; c < col_size; c++) {
+            transpose_16x16_avx512(col_size, &input[r * col_size + c],
+                &output[c * 16 * col_size + r / 16]);
+        }
+    }
+}
+
+#endif // TRANSPOSE_AVX512_H
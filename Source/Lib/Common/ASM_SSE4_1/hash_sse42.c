@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2018, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+#include <nmmintrin.h>
+
+#include "EbDefinitions.h"
+
+// Hardware CRC-32C, bit exact with av1_get_crc32c_value_c. The calculator
+// only holds the tables of the C version, it is not used here.
+uint32_t av1_get_crc32c_value_sse4_2(void *crc_calculator, uint8_t *p,
+                                     size_t length) {
+  const uint8_t *buf = p;
+  uint32_t crc = 0xFFFFFFFF;
+  (void)crc_calculator;
+
+#if defined(__x86_64__) || defined(_M_X64)
+  uint64_t crc64 = crc;
+  while (length >= sizeof(uint64_t)) {
+    uint64_t value;
+    memcpy(&value, buf, sizeof(value));
+    crc64 = _mm_crc32_u64(crc64, value);
+    buf += sizeof(value);
+    length -= sizeof(value);
+  }
+  crc = (uint32_t)crc64;
+#endif
+  while (length >= sizeof(uint32_t)) {
+    uint32_t value;
+    memcpy(&value, buf, sizeof(value));
+    crc = _mm_crc32_u32(crc, value);
+    buf += sizeof(value);
+    length -= sizeof(value);
+  }
+  if (length >= sizeof(uint16_t)) {
+    uint16_t value;
+    memcpy(&value, buf, sizeof(value));
+    crc = _mm_crc32_u16(crc, value);
+    buf += sizeof(value);
+    length -= sizeof(value);
+  }
+  if (length)
+    crc = _mm_crc32_u8(crc, *buf);
+
+  return crc ^ 0xFFFFFFFF;
+}
@@ -69,7 +69,7 @@ uint32_t fast_loop_nx_m_sad_kernel(
     return sad;
 }
 
-void sad_loop_kernel(
+void sad_loop_kernel_c(
     uint8_t  *src,                            // input parameter, source samples Ptr
     uint32_t  src_stride,                      // input parameter, source stride
     uint8_t  *ref,                            // input parameter, reference samples Ptr
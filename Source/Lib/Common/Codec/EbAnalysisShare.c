@@ -0,0 +1,440 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbAnalysisShare.h"
+#include "EbUtility.h"
+
+/**************************************
+ * AnalysisShareTag
+ *   Record tag of a picture, never 0.
+ **************************************/
+static int32_t AnalysisShareTag(
+    uint64_t             picture_number)
+{
+    return (int32_t)(picture_number & 0x3FFFFFFF) + 1;
+}
+
+static EbAnalysisShareRecord *AnalysisShareRecord(
+    EbAnalysisShare     *share_ptr,
+    uint64_t             picture_number)
+{
+    return &share_ptr->record_array[picture_number & (share_ptr->record_count - 1)];
+}
+
+/**************************************
+ * AnalysisShareAnalysed
+ *   Whether the lead is done with the
+ *   picture: its record holds the seeds of
+ *   all its SBs. The record is kept for
+ *   the followers registered when the lead
+ *   opened it, so it is not reused before.
+ **************************************/
+static EbBool AnalysisShareAnalysed(
+    EbAnalysisShare     *share_ptr,
+    uint64_t             picture_number)
+{
+    EbAnalysisShareRecord *record_ptr = AnalysisShareRecord(share_ptr, picture_number);
+
+    return (EbBool)(eb_atomic_load_32(&record_ptr->picture_tag) == AnalysisShareTag(picture_number) &&
+        eb_atomic_load_32(&record_ptr->hme_sb_count) >= (int32_t)(share_ptr->picture_width_in_sb * share_ptr->picture_height_in_sb));
+}
+
+/**************************************
+ * AnalysisShareReleaseFollower
+ *   Posts the inputs of the follower the
+ *   lead is done with, in input order.
+ *   Called with the follower mutex held.
+ **************************************/
+static void AnalysisShareReleaseFollower(
+    EbAnalysisShare          *share_ptr,
+    EbAnalysisShareFollower  *follower_ptr)
+{
+    EbAnalysisSharePending *pendingPtr;
+
+    while (follower_ptr->pending_count) {
+        pendingPtr = &follower_ptr->pending_array[follower_ptr->pending_head];
+        if (!pendingPtr->end_of_sequence_flag && !eb_atomic_load_32(&share_ptr->lead_closed) &&
+            !AnalysisShareAnalysed(share_ptr, pendingPtr->picture_number))
+            break;
+
+        eb_post_full_object(pendingPtr->wrapper_ptr);
+        follower_ptr->pending_head = (follower_ptr->pending_head + 1) % follower_ptr->pending_capacity;
+        --follower_ptr->pending_count;
+    }
+}
+
+static void AnalysisShareReleaseFollowers(
+    EbAnalysisShare     *share_ptr)
+{
+    uint32_t followerIndex;
+
+    eb_block_on_mutex(share_ptr->follower_mutex);
+    for (followerIndex = 0; followerIndex < share_ptr->follower_count; ++followerIndex) {
+        if (share_ptr->follower_array[followerIndex]->active)
+            AnalysisShareReleaseFollower(share_ptr, share_ptr->follower_array[followerIndex]);
+    }
+    eb_release_mutex(share_ptr->follower_mutex);
+}
+
+/**************************************
+ * AnalysisShareWakeLead
+ *   Wakes the lead when the record it
+ *   waits for is released. Called with the
+ *   follower mutex held.
+ **************************************/
+static void AnalysisShareWakeLead(
+    EbAnalysisShare     *share_ptr)
+{
+    if (share_ptr->lead_wait_record_ptr &&
+        (share_ptr->lead_wait_record_ptr->follower_refs == 0 || eb_atomic_load_32(&share_ptr->lead_closed))) {
+        share_ptr->lead_wait_record_ptr = (EbAnalysisShareRecord*)EB_NULL;
+        eb_post_semaphore(share_ptr->record_released_semaphore);
+    }
+}
+
+/**************************************
+ * eb_analysis_share_ctor
+ **************************************/
+EbErrorType eb_analysis_share_ctor(
+    EbAnalysisShare    **share_dbl_ptr,
+    uint32_t             luma_width,
+    uint32_t             luma_height,
+    uint32_t             lead_picture_count)
+{
+    EbAnalysisShare *share_ptr;
+    uint32_t         seedCount;
+    uint32_t         recordIndex;
+
+    *share_dbl_ptr = (EbAnalysisShare*)EB_NULL;
+
+    share_ptr = (EbAnalysisShare*)calloc(1, sizeof(EbAnalysisShare));
+    if (share_ptr == (EbAnalysisShare*)EB_NULL)
+        return EB_ErrorInsufficientResources;
+
+    share_ptr->ref_count = 1;
+    share_ptr->luma_width = luma_width;
+    share_ptr->luma_height = luma_height;
+    share_ptr->picture_width_in_sb = (luma_width + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+    share_ptr->picture_height_in_sb = (luma_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+
+    // A picture the lead waits to open is then past the Motion Estimation
+    // of the picture it replaces, the one the followers wait for
+    share_ptr->record_count = 1;
+    while (share_ptr->record_count <= lead_picture_count)
+        share_ptr->record_count <<= 1;
+
+    share_ptr->follower_mutex = eb_create_mutex();
+    share_ptr->record_released_semaphore = eb_create_semaphore(0, 1);
+    share_ptr->record_array = (EbAnalysisShareRecord*)calloc(share_ptr->record_count, sizeof(EbAnalysisShareRecord));
+    if (share_ptr->follower_mutex == (EbHandle)EB_NULL ||
+        share_ptr->record_released_semaphore == (EbHandle)EB_NULL ||
+        share_ptr->record_array == (EbAnalysisShareRecord*)EB_NULL) {
+        eb_analysis_share_release(share_ptr);
+        return EB_ErrorInsufficientResources;
+    }
+
+    seedCount = share_ptr->picture_width_in_sb * share_ptr->picture_height_in_sb * MAX_NUM_OF_REF_PIC_LIST;
+    for (recordIndex = 0; recordIndex < share_ptr->record_count; ++recordIndex) {
+        share_ptr->record_array[recordIndex].seed_array = (EbAnalysisShareSeed*)calloc(seedCount, sizeof(EbAnalysisShareSeed));
+        if (share_ptr->record_array[recordIndex].seed_array == (EbAnalysisShareSeed*)EB_NULL) {
+            eb_analysis_share_release(share_ptr);
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
+    *share_dbl_ptr = share_ptr;
+
+    return EB_ErrorNone;
+}
+
+void eb_analysis_share_retain(
+    EbAnalysisShare     *share_ptr)
+{
+    eb_atomic_fetch_add_32(&share_ptr->ref_count, 1);
+}
+
+void eb_analysis_share_release(
+    EbAnalysisShare     *share_ptr)
+{
+    uint32_t recordIndex;
+    uint32_t followerIndex;
+
+    if (eb_atomic_fetch_add_32(&share_ptr->ref_count, -1) != 1)
+        return;
+
+    if (share_ptr->record_array) {
+        for (recordIndex = 0; recordIndex < share_ptr->record_count; ++recordIndex)
+            free(share_ptr->record_array[recordIndex].seed_array);
+        free(share_ptr->record_array);
+    }
+    for (followerIndex = 0; followerIndex < share_ptr->follower_count; ++followerIndex) {
+        free(share_ptr->follower_array[followerIndex]->pending_array);
+        free(share_ptr->follower_array[followerIndex]);
+    }
+    if (share_ptr->record_released_semaphore)
+        eb_destroy_semaphore(share_ptr->record_released_semaphore);
+    if (share_ptr->follower_mutex)
+        eb_destroy_mutex(share_ptr->follower_mutex);
+    free(share_ptr);
+}
+
+void eb_analysis_share_close_lead(
+    EbAnalysisShare     *share_ptr)
+{
+    eb_atomic_store_32(&share_ptr->lead_closed, 1);
+
+    AnalysisShareReleaseFollowers(share_ptr);
+
+    eb_block_on_mutex(share_ptr->follower_mutex);
+    AnalysisShareWakeLead(share_ptr);
+    eb_release_mutex(share_ptr->follower_mutex);
+}
+
+/**************************************
+ * eb_analysis_share_add_follower
+ **************************************/
+EbErrorType eb_analysis_share_add_follower(
+    EbAnalysisShare     *share_ptr,
+    uint32_t             input_count,
+    uint32_t            *follower_index)
+{
+    EbAnalysisShareFollower *follower_ptr;
+
+    if (share_ptr->follower_count == ANALYSIS_SHARE_MAX_FOLLOWERS || input_count == 0)
+        return EB_ErrorBadParameter;
+
+    follower_ptr = (EbAnalysisShareFollower*)calloc(1, sizeof(EbAnalysisShareFollower));
+    if (follower_ptr == (EbAnalysisShareFollower*)EB_NULL)
+        return EB_ErrorInsufficientResources;
+    follower_ptr->pending_array = (EbAnalysisSharePending*)calloc(input_count, sizeof(EbAnalysisSharePending));
+    if (follower_ptr->pending_array == (EbAnalysisSharePending*)EB_NULL) {
+        free(follower_ptr);
+        return EB_ErrorInsufficientResources;
+    }
+    follower_ptr->pending_capacity = input_count;
+    follower_ptr->active = EB_TRUE;
+
+    eb_block_on_mutex(share_ptr->follower_mutex);
+    *follower_index = share_ptr->follower_count;
+    share_ptr->follower_mask |= 1u << share_ptr->follower_count;
+    share_ptr->follower_array[share_ptr->follower_count++] = follower_ptr;
+    eb_release_mutex(share_ptr->follower_mutex);
+
+    return EB_ErrorNone;
+}
+
+void eb_analysis_share_remove_follower(
+    EbAnalysisShare     *share_ptr,
+    uint32_t             follower_index)
+{
+    uint32_t recordIndex;
+
+    eb_block_on_mutex(share_ptr->follower_mutex);
+    share_ptr->follower_array[follower_index]->active = EB_FALSE;
+    share_ptr->follower_array[follower_index]->pending_count = 0;
+    share_ptr->follower_mask &= ~(1u << follower_index);
+    for (recordIndex = 0; recordIndex < share_ptr->record_count; ++recordIndex)
+        share_ptr->record_array[recordIndex].follower_refs &= ~(1u << follower_index);
+    AnalysisShareWakeLead(share_ptr);
+    eb_release_mutex(share_ptr->follower_mutex);
+}
+
+/**************************************
+ * eb_analysis_share_send_picture
+ *   The input buffer pool of the follower
+ *   bounds the inputs held.
+ **************************************/
+void eb_analysis_share_send_picture(
+    EbAnalysisShare     *share_ptr,
+    uint32_t             follower_index,
+    EbObjectWrapper     *wrapper_ptr,
+    EbBool               end_of_sequence_flag)
+{
+    EbAnalysisShareFollower *follower_ptr = share_ptr->follower_array[follower_index];
+    EbAnalysisSharePending  *pendingPtr;
+
+    eb_block_on_mutex(share_ptr->follower_mutex);
+
+    pendingPtr = &follower_ptr->pending_array[(follower_ptr->pending_head + follower_ptr->pending_count) % follower_ptr->pending_capacity];
+    pendingPtr->wrapper_ptr = wrapper_ptr;
+    pendingPtr->picture_number = follower_ptr->next_picture_number++;
+    pendingPtr->end_of_sequence_flag = end_of_sequence_flag;
+    ++follower_ptr->pending_count;
+
+    AnalysisShareReleaseFollower(share_ptr, follower_ptr);
+
+    eb_release_mutex(share_ptr->follower_mutex);
+}
+
+/**************************************
+ * eb_analysis_share_open_picture
+ **************************************/
+EbAnalysisShareRecord *eb_analysis_share_open_picture(
+    EbAnalysisShare     *share_ptr,
+    uint64_t             picture_number)
+{
+    EbAnalysisShareRecord *record_ptr = AnalysisShareRecord(share_ptr, picture_number);
+    uint32_t               followerIndex;
+
+    // Wait for the slowest follower to be done with the picture the record holds
+    eb_block_on_mutex(share_ptr->follower_mutex);
+    while (record_ptr->follower_refs && !eb_atomic_load_32(&share_ptr->lead_closed)) {
+        share_ptr->lead_wait_record_ptr = record_ptr;
+        eb_release_mutex(share_ptr->follower_mutex);
+        eb_block_on_semaphore(share_ptr->record_released_semaphore);
+        eb_block_on_mutex(share_ptr->follower_mutex);
+    }
+    share_ptr->lead_wait_record_ptr = (EbAnalysisShareRecord*)EB_NULL;
+
+    eb_atomic_store_32(&record_ptr->picture_tag, 0);
+    record_ptr->follower_refs = share_ptr->follower_mask;
+    eb_release_mutex(share_ptr->follower_mutex);
+
+    eb_atomic_store_32(&record_ptr->scene_ready, 0);
+    eb_atomic_store_32(&record_ptr->hme_sb_count, 0);
+    for (followerIndex = 0; followerIndex < ANALYSIS_SHARE_MAX_FOLLOWERS; ++followerIndex)
+        eb_atomic_store_32(&record_ptr->follower_sb_count[followerIndex], 0);
+    record_ptr->scene_change_flag = EB_FALSE;
+    record_ptr->ref_poc[REF_LIST_0] = ~0ull;
+    record_ptr->ref_poc[REF_LIST_1] = ~0ull;
+    eb_atomic_store_32(&record_ptr->picture_tag, AnalysisShareTag(picture_number));
+
+    return record_ptr;
+}
+
+EbAnalysisShareRecord *eb_analysis_share_get_record(
+    EbAnalysisShare     *share_ptr,
+    uint64_t             picture_number)
+{
+    EbAnalysisShareRecord *record_ptr = AnalysisShareRecord(share_ptr, picture_number);
+
+    return (eb_atomic_load_32(&record_ptr->picture_tag) == AnalysisShareTag(picture_number)) ?
+        record_ptr :
+        (EbAnalysisShareRecord*)EB_NULL;
+}
+
+void eb_analysis_share_set_scene_change(
+    EbAnalysisShare     *share_ptr,
+    uint64_t             picture_number,
+    EbBool               scene_change_flag)
+{
+    EbAnalysisShareRecord *record_ptr = eb_analysis_share_get_record(share_ptr, picture_number);
+
+    if (record_ptr) {
+        record_ptr->scene_change_flag = scene_change_flag;
+        eb_atomic_store_32(&record_ptr->scene_ready, 1);
+    }
+}
+
+void eb_analysis_share_add_hme_sbs(
+    EbAnalysisShare     *share_ptr,
+    uint64_t             picture_number,
+    uint32_t             sb_count)
+{
+    EbAnalysisShareRecord *record_ptr = eb_analysis_share_get_record(share_ptr, picture_number);
+    int32_t                sbTotalCount = (int32_t)(share_ptr->picture_width_in_sb * share_ptr->picture_height_in_sb);
+
+    // The last segment of the picture releases the inputs held for it
+    if (record_ptr && eb_atomic_fetch_add_32(&record_ptr->hme_sb_count, (int32_t)sb_count) + (int32_t)sb_count >= sbTotalCount)
+        AnalysisShareReleaseFollowers(share_ptr);
+}
+
+/**************************************
+ * eb_analysis_share_get_scene_change
+ **************************************/
+EbBool eb_analysis_share_get_scene_change(
+    EbAnalysisShare     *share_ptr,
+    uint64_t             picture_number,
+    EbBool              *scene_change_flag)
+{
+    EbAnalysisShareRecord *record_ptr = eb_analysis_share_get_record(share_ptr, picture_number);
+
+    if (record_ptr == (EbAnalysisShareRecord*)EB_NULL || !eb_atomic_load_32(&record_ptr->scene_ready))
+        return EB_FALSE;
+
+    *scene_change_flag = record_ptr->scene_change_flag;
+
+    // The record may have been reused while it was read
+    return eb_atomic_load_32(&record_ptr->picture_tag) == AnalysisShareTag(picture_number);
+}
+
+/**************************************
+ * eb_analysis_share_get_hme
+ **************************************/
+EbAnalysisShareRecord *eb_analysis_share_get_hme(
+    EbAnalysisShare     *share_ptr,
+    uint64_t             picture_number)
+{
+    EbAnalysisShareRecord *record_ptr = eb_analysis_share_get_record(share_ptr, picture_number);
+    int32_t                sbTotalCount = (int32_t)(share_ptr->picture_width_in_sb * share_ptr->picture_height_in_sb);
+
+    return (record_ptr && eb_atomic_load_32(&record_ptr->hme_sb_count) >= sbTotalCount) ?
+        record_ptr :
+        (EbAnalysisShareRecord*)EB_NULL;
+}
+
+/**************************************
+ * eb_analysis_share_get_seed
+ **************************************/
+EbBool eb_analysis_share_get_seed(
+    EbAnalysisShare         *share_ptr,
+    EbAnalysisShareRecord   *record_ptr,
+    uint64_t                 picture_number,
+    uint32_t                 list_index,
+    uint32_t                 sb_origin_x,
+    uint32_t                 sb_origin_y,
+    uint32_t                 luma_width,
+    uint32_t                 luma_height,
+    int16_t                 *x_search_center,
+    int16_t                 *y_search_center)
+{
+    EbAnalysisShareSeed seed;
+    uint32_t            leadSbX;
+    uint32_t            leadSbY;
+
+    // Lead SB covering the center of the SB
+    leadSbX = (uint32_t)(((uint64_t)(sb_origin_x + (BLOCK_SIZE_64 >> 1)) * share_ptr->luma_width / luma_width) / BLOCK_SIZE_64);
+    leadSbY = (uint32_t)(((uint64_t)(sb_origin_y + (BLOCK_SIZE_64 >> 1)) * share_ptr->luma_height / luma_height) / BLOCK_SIZE_64);
+    leadSbX = MIN(leadSbX, share_ptr->picture_width_in_sb - 1);
+    leadSbY = MIN(leadSbY, share_ptr->picture_height_in_sb - 1);
+
+    seed = record_ptr->seed_array[(leadSbY * share_ptr->picture_width_in_sb + leadSbX) * MAX_NUM_OF_REF_PIC_LIST + list_index];
+
+    // The record may have been reused while it was read
+    if (!seed.valid || eb_atomic_load_32(&record_ptr->picture_tag) != AnalysisShareTag(picture_number))
+        return EB_FALSE;
+
+    *x_search_center = (int16_t)((int32_t)seed.x_search_center * (int32_t)luma_width / (int32_t)share_ptr->luma_width);
+    *y_search_center = (int16_t)((int32_t)seed.y_search_center * (int32_t)luma_height / (int32_t)share_ptr->luma_height);
+
+    return EB_TRUE;
+}
+
+/**************************************
+ * eb_analysis_share_follower_hme_sbs
+ **************************************/
+void eb_analysis_share_follower_hme_sbs(
+    EbAnalysisShare     *share_ptr,
+    uint32_t             follower_index,
+    uint64_t             picture_number,
+    uint32_t             sb_count,
+    uint32_t             sb_total_count)
+{
+    EbAnalysisShareRecord *record_ptr = eb_analysis_share_get_record(share_ptr, picture_number);
+
+    // The record is only reused once released, so it still holds the picture
+    // unless the lead closed before analysing it
+    if (record_ptr == (EbAnalysisShareRecord*)EB_NULL ||
+        eb_atomic_fetch_add_32(&record_ptr->follower_sb_count[follower_index], (int32_t)sb_count) + (int32_t)sb_count < (int32_t)sb_total_count)
+        return;
+
+    eb_block_on_mutex(share_ptr->follower_mutex);
+    record_ptr->follower_refs &= ~(1u << follower_index);
+    AnalysisShareWakeLead(share_ptr);
+    eb_release_mutex(share_ptr->follower_mutex);
+}
@@ -0,0 +1,253 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbAnalysisShare_h
+#define EbAnalysisShare_h
+
+#include "EbDefinitions.h"
+#include "EbThreads.h"
+#include "EbSystemResourceManager.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+    /*********************************
+     * Defines
+     *********************************/
+#define ANALYSIS_SHARE_MAX_FOLLOWERS        16          // bits of follower_refs
+
+    /*********************************************************************
+     * AnalysisShareSeed
+     *   HME search center the lead found for one SB and reference list,
+     *   in full pel at the lead resolution.
+     *********************************************************************/
+    typedef struct EbAnalysisShareSeed
+    {
+        int16_t                  x_search_center;
+        int16_t                  y_search_center;
+        uint8_t                  valid;
+
+    } EbAnalysisShareSeed;
+
+    /*********************************************************************
+     * AnalysisShareRecord
+     *   Analysis of one picture of the lead. picture_tag is stored last
+     *   when the record is reused, scene_ready and hme_sb_count are set
+     *   once the fields they guard are written.
+     *
+     *   follower_refs holds a bit per follower that has not run Motion
+     *   Estimation on the picture yet; the lead only reuses the record
+     *   once it is 0, so a follower never misses the analysis of a
+     *   picture because the lead moved on.
+     *********************************************************************/
+    typedef struct EbAnalysisShareRecord
+    {
+        volatile int32_t         picture_tag;           // picture_number + 1, 0 while being reset
+        volatile int32_t         scene_ready;
+        EbBool                   scene_change_flag;
+
+        uint64_t                 ref_poc[MAX_NUM_OF_REF_PIC_LIST];
+        volatile int32_t         hme_sb_count;          // lead SBs through ME
+        EbAnalysisShareSeed     *seed_array;            // [sb_index][list]
+
+        uint32_t                 follower_refs;         // under follower_mutex
+        volatile int32_t         follower_sb_count[ANALYSIS_SHARE_MAX_FOLLOWERS];
+
+    } EbAnalysisShareRecord;
+
+    /*********************************************************************
+     * AnalysisSharePending
+     *   Input of a follower held until the lead analysed the picture.
+     *********************************************************************/
+    typedef struct EbAnalysisSharePending
+    {
+        EbObjectWrapper         *wrapper_ptr;
+        uint64_t                 picture_number;
+        EbBool                   end_of_sequence_flag;
+
+    } EbAnalysisSharePending;
+
+    typedef struct EbAnalysisShareFollower
+    {
+        EbBool                   active;
+        uint64_t                 next_picture_number;   // of the next input, numbered as Resource Coordination does
+        uint32_t                 pending_head;
+        uint32_t                 pending_count;
+        uint32_t                 pending_capacity;      // input buffers of the follower
+        EbAnalysisSharePending  *pending_array;
+
+    } EbAnalysisShareFollower;
+
+    /*********************************************************************
+     * AnalysisShare
+     *   Analysis the encoder of the top rendition of a ladder (the lead)
+     *   publishes for the encoders of the other renditions (the
+     *   followers): the scene change decisions of Picture Decision and
+     *   the HME search centers of Motion Estimation, per picture number.
+     *
+     *   The lead is the only writer. The inputs of a follower are held
+     *   here, and posted to its pipeline once the lead analysed the
+     *   picture, so the pipeline threads of the follower never wait for
+     *   the lead and always find its analysis: the record of a picture
+     *   is kept until every follower ran Motion Estimation on it, the
+     *   lead waiting for the slowest follower before reusing it. The
+     *   follower only analyses pictures on its own once the lead closed.
+     *
+     *   Picture Analysis (decimation, statistics) and the open loop
+     *   search around the HME centers still run in every rendition, at
+     *   its own resolution; only scene change detection and HME are
+     *   shared.
+     *
+     *   Allocated outside the memory arenas since it outlives the
+     *   encoder that created it; freed with the last reference.
+     *********************************************************************/
+    typedef struct EbAnalysisShare
+    {
+        volatile int32_t         ref_count;
+        volatile int32_t         lead_closed;
+
+        uint32_t                 luma_width;
+        uint32_t                 luma_height;
+        uint32_t                 picture_width_in_sb;
+        uint32_t                 picture_height_in_sb;
+
+        uint32_t                 record_count;          // power of 2, more than the pictures the lead has in flight
+        EbAnalysisShareRecord   *record_array;
+
+        EbHandle                 follower_mutex;
+        EbHandle                 record_released_semaphore;
+        EbAnalysisShareRecord   *lead_wait_record_ptr;  // record the lead waits for, under follower_mutex
+        uint32_t                 follower_mask;         // active followers, under follower_mutex
+        uint32_t                 follower_count;
+        EbAnalysisShareFollower *follower_array[ANALYSIS_SHARE_MAX_FOLLOWERS];
+
+    } EbAnalysisShare;
+
+    /*********************************************************************
+     * eb_analysis_share_ctor
+     *   luma_width, luma_height
+     *      Size of the pictures of the lead. The share is created with
+     *      one reference, held by the lead.
+     *   lead_picture_count
+     *      Pictures the lead has in flight at most (its picture control
+     *      set pool); the record of a picture outlives them.
+     *********************************************************************/
+    extern EbErrorType eb_analysis_share_ctor(
+        EbAnalysisShare    **share_dbl_ptr,
+        uint32_t             luma_width,
+        uint32_t             luma_height,
+        uint32_t             lead_picture_count);
+
+    extern void eb_analysis_share_retain(
+        EbAnalysisShare     *share_ptr);
+
+    extern void eb_analysis_share_release(
+        EbAnalysisShare     *share_ptr);
+
+    /*********************************************************************
+     * eb_analysis_share_close_lead
+     *   Called when the lead is deinitialized; the inputs held for the
+     *   followers are posted to their pipelines.
+     *********************************************************************/
+    extern void eb_analysis_share_close_lead(
+        EbAnalysisShare     *share_ptr);
+
+    /*********************************************************************
+     * eb_analysis_share_add_follower
+     *   Registers a follower, whose inputs are then sent through
+     *   eb_analysis_share_send_picture; input_count is the size of its
+     *   input buffer pool. remove_follower drops the inputs still held
+     *   and its references on the records, before the follower is
+     *   deinitialized.
+     *********************************************************************/
+    extern EbErrorType eb_analysis_share_add_follower(
+        EbAnalysisShare     *share_ptr,
+        uint32_t             input_count,
+        uint32_t            *follower_index);
+
+    extern void eb_analysis_share_remove_follower(
+        EbAnalysisShare     *share_ptr,
+        uint32_t             follower_index);
+
+    /*********************************************************************
+     * eb_analysis_share_send_picture
+     *   Holds the input of a follower until the lead analysed the
+     *   picture, in input order; the end of sequence is posted once the
+     *   inputs before it are.
+     *********************************************************************/
+    extern void eb_analysis_share_send_picture(
+        EbAnalysisShare     *share_ptr,
+        uint32_t             follower_index,
+        EbObjectWrapper     *wrapper_ptr,
+        EbBool               end_of_sequence_flag);
+
+    /*********************************************************************
+     * Lead side
+     *   open_picture resets the record of a picture when it enters
+     *   Picture Decision, first waiting until the followers are done
+     *   with the picture it held. Motion Estimation writes the seeds of
+     *   its SBs in the record open_picture returns, then adds the SB
+     *   count.
+     *********************************************************************/
+    extern EbAnalysisShareRecord *eb_analysis_share_open_picture(
+        EbAnalysisShare     *share_ptr,
+        uint64_t             picture_number);
+
+    extern EbAnalysisShareRecord *eb_analysis_share_get_record(
+        EbAnalysisShare     *share_ptr,
+        uint64_t             picture_number);
+
+    extern void eb_analysis_share_set_scene_change(
+        EbAnalysisShare     *share_ptr,
+        uint64_t             picture_number,
+        EbBool               scene_change_flag);
+
+    extern void eb_analysis_share_add_hme_sbs(
+        EbAnalysisShare     *share_ptr,
+        uint64_t             picture_number,
+        uint32_t             sb_count);
+
+    /*********************************************************************
+     * Follower side
+     *   get_scene_change returns the scene change decision of the lead,
+     *   get_hme the record holding the seeds of all its SBs; neither
+     *   waits, both fail when the lead has not analysed the picture.
+     *   get_seed scales the seed of the lead SB covering the center of
+     *   the SB at sb_origin_x, sb_origin_y of a luma_width x luma_height
+     *   picture; fails when the lead has no seed there.
+     *   follower_hme_sbs adds the SBs of the follower through Motion
+     *   Estimation, and releases the record once they are all through.
+     *********************************************************************/
+    extern EbBool eb_analysis_share_get_scene_change(
+        EbAnalysisShare     *share_ptr,
+        uint64_t             picture_number,
+        EbBool              *scene_change_flag);
+
+    extern EbAnalysisShareRecord *eb_analysis_share_get_hme(
+        EbAnalysisShare     *share_ptr,
+        uint64_t             picture_number);
+
+    extern EbBool eb_analysis_share_get_seed(
+        EbAnalysisShare         *share_ptr,
+        EbAnalysisShareRecord   *record_ptr,
+        uint64_t                 picture_number,
+        uint32_t                 list_index,
+        uint32_t                 sb_origin_x,
+        uint32_t                 sb_origin_y,
+        uint32_t                 luma_width,
+        uint32_t                 luma_height,
+        int16_t                 *x_search_center,
+        int16_t                 *y_search_center);
+
+    extern void eb_analysis_share_follower_hme_sbs(
+        EbAnalysisShare     *share_ptr,
+        uint32_t             follower_index,
+        uint64_t             picture_number,
+        uint32_t             sb_count,
+        uint32_t             sb_total_count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //EbAnalysisShare_h
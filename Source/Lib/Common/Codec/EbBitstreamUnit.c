@@ -108,8 +108,27 @@ EbErrorType output_bitstream_rbsp_to_payload(
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
 // daalaboolwriter.c
+EbErrorType eb_tile_overflow_reserve(EbTileOverflow *overflow_ptr, uint32_t size) {
+    uint8_t *buffer;
+    uint32_t capacity;
+
+    if (overflow_ptr->capacity >= size)
+        return EB_ErrorNone;
+
+    // The arena only frees at encoder close, grow geometrically to bound
+    // what the replaced buffers waste
+    capacity = AOMMAX(size, 2 * overflow_ptr->capacity);
+    EB_MALLOC(uint8_t*, buffer, capacity, EB_N_PTR);
+    overflow_ptr->buffer = buffer;
+    overflow_ptr->capacity = capacity;
+
+    return EB_ErrorNone;
+}
+
 void aom_daala_start_encode(daala_writer *br, uint8_t *source) {
     br->buffer = source;
+    br->buffer_size = 0;
+    br->overflow_ptr = (EbTileOverflow*)EB_NULL;
     br->pos = 0;
     od_ec_enc_init(&br->ec, 62025);
 }
@@ -120,7 +139,15 @@ int32_t aom_daala_stop_encode(daala_writer *br) {
     uint8_t *daala_data;
     daala_data = od_ec_enc_done(&br->ec, &daala_bytes);
     nb_bits = od_ec_enc_tell(&br->ec);
-    memcpy(br->buffer, daala_data, daala_bytes);
+    if (br->buffer_size && daala_bytes > br->buffer_size) {
+        // pos is 0 when the overflow buffer cannot hold the stream
+        if (br->overflow_ptr && eb_tile_overflow_reserve(br->overflow_ptr, daala_bytes) == EB_ErrorNone)
+            memcpy(br->overflow_ptr->buffer, daala_data, daala_bytes);
+        else
+            daala_bytes = 0;
+    }
+    else
+        memcpy(br->buffer, daala_data, daala_bytes);
     br->pos = daala_bytes;
     od_ec_enc_clear(&br->ec);
     return nb_bits;
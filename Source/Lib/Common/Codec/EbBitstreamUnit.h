@@ -242,9 +242,26 @@ on a larger type, you can speed up the decoder by using it here.*/
 
     /********************************************************************************************************************************/
     //daalaboolwriter.h
+    // Overflow buffer of one tile. It is kept by the owner of the tile
+    // slices and reused from picture to picture; it only grows, from the
+    // memory arena of the calling thread.
+    typedef struct EbTileOverflow {
+        uint8_t *buffer;
+        uint32_t capacity;
+    } EbTileOverflow;
+
+    extern EbErrorType eb_tile_overflow_reserve(
+        EbTileOverflow *overflow_ptr,
+        uint32_t        size);
+
+    // buffer_size, when not 0, is the room left at buffer. A longer stream
+    // is written to overflow_ptr instead, or dropped (pos 0) when there is
+    // no overflow buffer or it cannot grow.
     struct daala_writer {
         uint32_t pos;
         uint8_t *buffer;
+        uint32_t buffer_size;
+        EbTileOverflow *overflow_ptr;
         od_ec_enc ec;
         uint8_t allow_update_cdf;
     };
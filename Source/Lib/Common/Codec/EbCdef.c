@@ -468,40 +468,113 @@ static INLINE void copy_rect(uint16_t *dst, int32_t dstride, const uint16_t *src
     }
 }
 
-void av1_cdef_frame(
-    EncDecContext_t                *context_ptr,
-    SequenceControlSet           *sequence_control_set_ptr,
-    PictureControlSet_t            *pCs
-)
-{
-    (void)context_ptr;
-
-    struct PictureParentControlSet_s     *pPcs = pCs->parent_pcs_ptr;
-    Av1Common*   cm = pPcs->av1_cm;
+/* Copies a rectangle of the 8-bit or 16-bit deblocked recon to 16 bits. */
+static void copy_sb_16(uint16_t *dst, int32_t dstride,
+    const EbByte src, int32_t src_voffset, int32_t src_hoffset,
+    int32_t sstride, int32_t vsize, int32_t hsize, EbBool is16bit) {
 
+    if (is16bit)
+        copy_sb16_16(dst, dstride, (const uint16_t*)src, src_voffset, src_hoffset, sstride, vsize, hsize);
+    else
+        copy_sb8_16(dst, dstride, src, src_voffset, src_hoffset, sstride, vsize, hsize);
+}
 
+/******************************************************
+ * CDEF Recon Buffer
+ *
+ * Points buf at the origin of each plane of the
+ *   deblocked recon, which CDEF filters in place.
+ ******************************************************/
+static EbPictureBufferDesc_t *cdef_recon_buffer(
+    PictureControlSet_t            *pCs,
+    EbBool                          is16bit,
+    EbByte                          buf[3])
+{
+    struct PictureParentControlSet_s     *pPcs = pCs->parent_pcs_ptr;
     EbPictureBufferDesc_t  * recon_picture_ptr;
-
+    const uint32_t bytes = is16bit ? sizeof(uint16_t) : sizeof(uint8_t);
 
     if (pPcs->is_used_as_reference_flag == EB_TRUE)
-        recon_picture_ptr = ((EbReferenceObject*)pCs->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture;
+        recon_picture_ptr = is16bit ?
+            ((EbReferenceObject*)pPcs->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit :
+            ((EbReferenceObject*)pPcs->reference_picture_wrapper_ptr->object_ptr)->reference_picture;
     else
-        recon_picture_ptr = pCs->recon_picture_ptr;
+        recon_picture_ptr = is16bit ? pCs->recon_picture16bit_ptr : pCs->recon_picture_ptr;
 
+    buf[0] = recon_picture_ptr->buffer_y + bytes * (recon_picture_ptr->origin_x + recon_picture_ptr->origin_y * recon_picture_ptr->stride_y);
+    buf[1] = recon_picture_ptr->bufferCb + bytes * (recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCb);
+    buf[2] = recon_picture_ptr->bufferCr + bytes * (recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCr);
 
-    EbByte  reconBufferY = &((recon_picture_ptr->buffer_y)[recon_picture_ptr->origin_x + recon_picture_ptr->origin_y * recon_picture_ptr->stride_y]);
-    EbByte  reconBufferCb = &((recon_picture_ptr->bufferCb)[recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCb]);
-    EbByte  reconBufferCr = &((recon_picture_ptr->bufferCr)[recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCr]);
+    return recon_picture_ptr;
+}
 
+/******************************************************
+ * CDEF Save Boundary Lines
+ *
+ * A filter block reads CDEF_VBORDER deblocked lines
+ *   above and below it, which belong to the filter
+ *   block rows above and below. The lines around every
+ *   row boundary are saved before any row is filtered,
+ *   so the rows can then be filtered in any order, on
+ *   any thread. Boundary fbr (1 to nvfb - 1) holds the
+ *   last CDEF_VBORDER lines of row fbr - 1 followed by
+ *   the first CDEF_VBORDER lines of row fbr.
+ ******************************************************/
+void av1_cdef_save_boundary_lines(
+    SequenceControlSet           *sequence_control_set_ptr,
+    PictureControlSet_t            *pCs)
+{
+    Av1Common*   cm = pCs->parent_pcs_ptr->av1_cm;
+    EbBool       is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    const int32_t nvfb = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+    const int32_t stride = cm->mi_cols << MI_SIZE_LOG2;
+    EbByte       recBuff[3];
+    EbPictureBufferDesc_t  * recon_picture_ptr = cdef_recon_buffer(pCs, is16bit, recBuff);
+    const int32_t recStride[3] = { recon_picture_ptr->stride_y, recon_picture_ptr->strideCb, recon_picture_ptr->strideCr };
+
+    for (int32_t pli = 0; pli < 3; pli++) {
+        const int32_t mi_high_l2 = MI_SIZE_LOG2 - (pli ? 1 : 0);
+        const int32_t mi_wide_l2 = MI_SIZE_LOG2 - (pli ? 1 : 0);
+
+        for (int32_t fbr = 1; fbr < nvfb; fbr++) {
+            copy_sb_16(
+                &pCs->cdef_line_buf[pli][fbr * 2 * CDEF_VBORDER * stride], stride,
+                recBuff[pli],
+                (MI_SIZE_64X64 << mi_high_l2) * fbr - CDEF_VBORDER, 0,
+                recStride[pli], 2 * CDEF_VBORDER, cm->mi_cols << mi_wide_l2,
+                is16bit);
+        }
+    }
+}
 
+/******************************************************
+ * CDEF Frame Row
+ *
+ * Filters the 64x64 filter blocks of one filter block
+ *   row in place. The borders outside the row come from
+ *   the lines saved by av1_cdef_save_boundary_lines and
+ *   the borders between the blocks of the row from the
+ *   copy of the unfiltered columns (colbuf), so a row
+ *   only writes its own pixels and reads no pixel written
+ *   by another row.
+ ******************************************************/
+void av1_cdef_frame_row(
+    SequenceControlSet           *sequence_control_set_ptr,
+    PictureControlSet_t            *pCs,
+    int32_t                         fbr)
+{
+    struct PictureParentControlSet_s     *pPcs = pCs->parent_pcs_ptr;
+    Av1Common*   cm = pPcs->av1_cm;
+    EbBool       is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
 
+    EbByte       recBuff[3];
+    EbPictureBufferDesc_t  * recon_picture_ptr = cdef_recon_buffer(pCs, is16bit, recBuff);
+    const int32_t recStride[3] = { recon_picture_ptr->stride_y, recon_picture_ptr->strideCb, recon_picture_ptr->strideCr };
 
     const int32_t num_planes = 3;// av1_num_planes(cm);
     DECLARE_ALIGNED(16, uint16_t, src[CDEF_INBUF_SIZE]);
-    uint16_t *linebuf[3];
-    uint16_t *colbuf[3];
+    uint16_t colbuf[3][((MI_SIZE_64X64 << MI_SIZE_LOG2) + 2 * CDEF_VBORDER) * CDEF_HBORDER];
     cdef_list dlist[MI_SIZE_64X64 * MI_SIZE_64X64];
-    uint8_t *row_cdef, *prev_row_cdef, *curr_row_cdef;
     int32_t cdef_count;
     int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS] = { { 0 } };
     int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS] = { { 0 } };
@@ -512,12 +585,8 @@ void av1_cdef_frame(
     int32_t coeff_shift = AOMMAX(sequence_control_set_ptr->static_config.encoder_bit_depth/*cm->bit_depth*/ - 8, 0);
     const int32_t nvfb = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
     const int32_t nhfb = (cm->mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
-    //av1_setup_dst_planes(xd->plane, cm->seq_params.sb_size, frame, 0, 0, 0, num_planes);
-    row_cdef = (uint8_t *)aom_malloc(sizeof(*row_cdef) * (nhfb + 2) * 2);
-    ASSERT(row_cdef != NULL);
-    memset(row_cdef, 1, sizeof(*row_cdef) * (nhfb + 2) * 2);
-    prev_row_cdef = row_cdef + 1;
-    curr_row_cdef = prev_row_cdef + nhfb + 2;
+    const int32_t stride = cm->mi_cols << MI_SIZE_LOG2;
+
     for (int32_t pli = 0; pli < num_planes; pli++) {
 
         int32_t subsampling_x = (pli == 0) ? 0 : 1;
@@ -527,615 +596,234 @@ void av1_cdef_frame(
         ydec[pli] = subsampling_y; //CHKN  xd->plane[pli].subsampling_y;
         mi_wide_l2[pli] = MI_SIZE_LOG2 - subsampling_x; //CHKN xd->plane[pli].subsampling_x;
         mi_high_l2[pli] = MI_SIZE_LOG2 - subsampling_y; //CHKN xd->plane[pli].subsampling_y;
-    }
 
-    const int32_t stride = (cm->mi_cols << MI_SIZE_LOG2) + 2 * CDEF_HBORDER;
-    for (int32_t pli = 0; pli < num_planes; pli++) {
-        linebuf[pli] = (uint16_t *)aom_malloc(sizeof(*linebuf) * CDEF_VBORDER * stride);
-        colbuf[pli] = (uint16_t *)aom_malloc(sizeof(*colbuf)  * ((CDEF_BLOCKSIZE << mi_high_l2[pli]) + 2 * CDEF_VBORDER) * CDEF_HBORDER);
+        const int32_t block_height =
+            (MI_SIZE_64X64 << mi_high_l2[pli]) + 2 * CDEF_VBORDER;
+        fill_rect(colbuf[pli], CDEF_HBORDER, block_height, CDEF_HBORDER,
+            CDEF_VERY_LARGE);
     }
 
-    for (int32_t fbr = 0; fbr < nvfb; fbr++) {
+    int32_t cdef_left = 1;
+    for (int32_t fbc = 0; fbc < nhfb; fbc++) {
+        int32_t level, sec_strength;
+        int32_t uv_level, uv_sec_strength;
+        int32_t nhb, nvb;
+        int32_t cstart = 0;
+
+        //WAHT IS THIS  ?? CHKN -->for
+        if (pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc] == NULL ||
+            pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc]->mbmi.cdef_strength == -1) {
+            cdef_left = 0;
+            printf("\n\n\nCDEF ERROR: Skipping Current FB\n\n\n");
+            continue;
+        }
 
-        for (int32_t pli = 0; pli < num_planes; pli++) {
-            const int32_t block_height =
-                (MI_SIZE_64X64 << mi_high_l2[pli]) + 2 * CDEF_VBORDER;
-            fill_rect(colbuf[pli], CDEF_HBORDER, block_height, CDEF_HBORDER,
-                CDEF_VERY_LARGE);
+        if (!cdef_left) cstart = -CDEF_HBORDER;  //CHKN if the left block has not been filtered, then we can use samples on the left as input.
+
+        nhb = AOMMIN(MI_SIZE_64X64, cm->mi_cols - MI_SIZE_64X64 * fbc);
+        nvb = AOMMIN(MI_SIZE_64X64, cm->mi_rows - MI_SIZE_64X64 * fbr);
+        int32_t frame_top, frame_left, frame_bottom, frame_right;
+
+        int32_t mi_row = MI_SIZE_64X64 * fbr;
+        int32_t mi_col = MI_SIZE_64X64 * fbc;
+        // for the current filter block, it's top left corner mi structure (mi_tl)
+        // is first accessed to check whether the top and left boundaries are
+        // frame boundaries. Then bottom-left and top-right mi structures are
+        // accessed to check whether the bottom and right boundaries
+        // (respectively) are frame boundaries.
+        //
+        // Note that we can't just check the bottom-right mi structure - eg. if
+        // we're at the right-hand edge of the frame but not the bottom, then
+        // the bottom-right mi is NULL but the bottom-left is not.
+        frame_top = (mi_row == 0) ? 1 : 0;
+        frame_left = (mi_col == 0) ? 1 : 0;
+
+        if (fbr != nvfb - 1)
+            frame_bottom = (mi_row + MI_SIZE_64X64 == cm->mi_rows) ? 1 : 0;
+        else
+            frame_bottom = 1;
+
+        if (fbc != nhfb - 1)
+            frame_right = (mi_col + MI_SIZE_64X64 == cm->mi_cols) ? 1 : 0;
+        else
+            frame_right = 1;
+
+        const int32_t mbmi_cdef_strength = pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc]->mbmi.cdef_strength;
+        level = pPcs->cdef_strengths[mbmi_cdef_strength] / CDEF_SEC_STRENGTHS;
+        sec_strength = pPcs->cdef_strengths[mbmi_cdef_strength] % CDEF_SEC_STRENGTHS;
+        sec_strength += sec_strength == 3;
+        uv_level = pPcs->cdef_uv_strengths[mbmi_cdef_strength] / CDEF_SEC_STRENGTHS;
+        uv_sec_strength = pPcs->cdef_uv_strengths[mbmi_cdef_strength] % CDEF_SEC_STRENGTHS;
+        uv_sec_strength += uv_sec_strength == 3;
+        if ((level == 0 && sec_strength == 0 && uv_level == 0 && uv_sec_strength == 0) ||
+            (cdef_count = sb_compute_cdef_list(pCs, cm, fbr * MI_SIZE_64X64, fbc * MI_SIZE_64X64, dlist, BLOCK_64X64)) == 0) {
+            cdef_left = 0;
+            continue;
         }
 
-        int32_t cdef_left = 1;
-        for (int32_t fbc = 0; fbc < nhfb; fbc++) {
-            int32_t level, sec_strength;
-            int32_t uv_level, uv_sec_strength;
-            int32_t nhb, nvb;
-            int32_t cstart = 0;
-            curr_row_cdef[fbc] = 0;
-
-            //WAHT IS THIS  ?? CHKN -->for
-            if (pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc] == NULL ||
-                pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc]->mbmi.cdef_strength == -1) {
-                cdef_left = 0;
-                printf("\n\n\nCDEF ERROR: Skipping Current FB\n\n\n");
-                continue;
+        for (int32_t pli = 0; pli < num_planes; pli++) {
+            int32_t coffset;
+            int32_t rend, cend;
+            int32_t pri_damping = pPcs->cdef_pri_damping;
+            int32_t sec_damping = pPcs->cdef_sec_damping;
+            int32_t hsize = nhb << mi_wide_l2[pli];
+            int32_t vsize = nvb << mi_high_l2[pli];
+            // Lines of the row above, saved before filtering
+            const uint16_t *above_lines = &pCs->cdef_line_buf[pli][fbr * 2 * CDEF_VBORDER * stride];
+
+            if (pli) {
+                level = uv_level;
+                sec_strength = uv_sec_strength;
             }
 
-            if (!cdef_left) cstart = -CDEF_HBORDER;  //CHKN if the left block has not been filtered, then we can use samples on the left as input.
-
-            nhb = AOMMIN(MI_SIZE_64X64, cm->mi_cols - MI_SIZE_64X64 * fbc);
-            nvb = AOMMIN(MI_SIZE_64X64, cm->mi_rows - MI_SIZE_64X64 * fbr);
-            int32_t frame_top, frame_left, frame_bottom, frame_right;
-
-            int32_t mi_row = MI_SIZE_64X64 * fbr;
-            int32_t mi_col = MI_SIZE_64X64 * fbc;
-            // for the current filter block, it's top left corner mi structure (mi_tl)
-            // is first accessed to check whether the top and left boundaries are
-            // frame boundaries. Then bottom-left and top-right mi structures are
-            // accessed to check whether the bottom and right boundaries
-            // (respectively) are frame boundaries.
-            //
-            // Note that we can't just check the bottom-right mi structure - eg. if
-            // we're at the right-hand edge of the frame but not the bottom, then
-            // the bottom-right mi is NULL but the bottom-left is not.
-            frame_top = (mi_row == 0) ? 1 : 0;
-            frame_left = (mi_col == 0) ? 1 : 0;
-
-            if (fbr != nvfb - 1)
-                frame_bottom = (mi_row + MI_SIZE_64X64 == cm->mi_rows) ? 1 : 0;
+            if (fbc == nhfb - 1)
+                cend = hsize;
             else
-                frame_bottom = 1;
+                cend = hsize + CDEF_HBORDER;
 
-            if (fbc != nhfb - 1)
-                frame_right = (mi_col + MI_SIZE_64X64 == cm->mi_cols) ? 1 : 0;
+            if (fbr == nvfb - 1)
+                rend = vsize;
             else
-                frame_right = 1;
-
-            const int32_t mbmi_cdef_strength = pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc]->mbmi.cdef_strength;
-            level = pCs->parent_pcs_ptr->cdef_strengths[mbmi_cdef_strength] / CDEF_SEC_STRENGTHS;
-            sec_strength = pCs->parent_pcs_ptr->cdef_strengths[mbmi_cdef_strength] % CDEF_SEC_STRENGTHS;
-            sec_strength += sec_strength == 3;
-            uv_level = pCs->parent_pcs_ptr->cdef_uv_strengths[mbmi_cdef_strength] / CDEF_SEC_STRENGTHS;
-            uv_sec_strength = pCs->parent_pcs_ptr->cdef_uv_strengths[mbmi_cdef_strength] % CDEF_SEC_STRENGTHS;
-            uv_sec_strength += uv_sec_strength == 3;
-            if ((level == 0 && sec_strength == 0 && uv_level == 0 && uv_sec_strength == 0) ||
-                (cdef_count = sb_compute_cdef_list(pCs, cm, fbr * MI_SIZE_64X64, fbc * MI_SIZE_64X64, dlist, BLOCK_64X64)) == 0) {
-                cdef_left = 0;
-                continue;
+                rend = vsize + CDEF_VBORDER;
+
+            coffset = fbc * MI_SIZE_64X64 << mi_wide_l2[pli];
+            if (fbc == nhfb - 1) {
+                /* On the last superblock column, fill in the right border with
+                   CDEF_VERY_LARGE to avoid filtering with the outside. */
+                fill_rect(&src[cend + CDEF_HBORDER], CDEF_BSTRIDE,
+                    rend + CDEF_VBORDER, hsize + CDEF_HBORDER - cend,
+                    CDEF_VERY_LARGE);
+            }
+            if (fbr == nvfb - 1) {
+                /* On the last superblock row, fill in the bottom border with
+                   CDEF_VERY_LARGE to avoid filtering with the outside. */
+                fill_rect(&src[(rend + CDEF_VBORDER) * CDEF_BSTRIDE], CDEF_BSTRIDE,
+                    CDEF_VBORDER, hsize + 2 * CDEF_HBORDER, CDEF_VERY_LARGE);
             }
 
-            curr_row_cdef[fbc] = 1;
-            for (int32_t pli = 0; pli < num_planes; pli++) {
-                int32_t coffset;
-                int32_t rend, cend;
-                int32_t pri_damping = pCs->parent_pcs_ptr->cdef_pri_damping;
-                int32_t sec_damping = pCs->parent_pcs_ptr->cdef_sec_damping;
-                int32_t hsize = nhb << mi_wide_l2[pli];
-                int32_t vsize = nvb << mi_high_l2[pli];
-
-                if (pli) {
-                    level = uv_level;
-                    sec_strength = uv_sec_strength;
-                }
-
-                if (fbc == nhfb - 1)
-                    cend = hsize;
-                else
-                    cend = hsize + CDEF_HBORDER;
-
-                if (fbr == nvfb - 1)
-                    rend = vsize;
-                else
-                    rend = vsize + CDEF_VBORDER;
-
-                coffset = fbc * MI_SIZE_64X64 << mi_wide_l2[pli];
-                if (fbc == nhfb - 1) {
-                    /* On the last superblock column, fill in the right border with
-                       CDEF_VERY_LARGE to avoid filtering with the outside. */
-                    fill_rect(&src[cend + CDEF_HBORDER], CDEF_BSTRIDE,
-                        rend + CDEF_VBORDER, hsize + CDEF_HBORDER - cend,
-                        CDEF_VERY_LARGE);
-                }
-                if (fbr == nvfb - 1) {
-                    /* On the last superblock row, fill in the bottom border with
-                       CDEF_VERY_LARGE to avoid filtering with the outside. */
-                    fill_rect(&src[(rend + CDEF_VBORDER) * CDEF_BSTRIDE], CDEF_BSTRIDE,
-                        CDEF_VBORDER, hsize + 2 * CDEF_HBORDER, CDEF_VERY_LARGE);
-                }
-
-
-                uint8_t* recBuff = 0;
-                uint32_t recStride = 0;
-
-                switch (pli) {
-                case 0:
-                    recBuff = reconBufferY;
-                    recStride = recon_picture_ptr->stride_y;
-                    break;
-                case 1:
-                    recBuff = reconBufferCb;
-                    recStride = recon_picture_ptr->strideCb;
-
-                    break;
-                case 2:
-                    recBuff = reconBufferCr;
-                    recStride = recon_picture_ptr->strideCr;
-                    break;
-                }
-
-
-                /* Copy in the pixels we need from the current superblock for
-                   deringing.*/
-                copy_sb8_16(//cm,
-                    &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER + cstart],
-                    CDEF_BSTRIDE, recBuff/*xd->plane[pli].dst.buf*/,
-                    (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr, coffset + cstart,
-                    recStride/*xd->plane[pli].dst.stride*/, rend, cend - cstart);
-                if (!prev_row_cdef[fbc]) {
-                    copy_sb8_16(//cm,
-                        &src[CDEF_HBORDER], CDEF_BSTRIDE,
-                        recBuff/*xd->plane[pli].dst.buf*/,
-                        (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr - CDEF_VBORDER,
-                        coffset, recStride/*xd->plane[pli].dst.stride*/, CDEF_VBORDER, hsize);
-                }
-                else if (fbr > 0) {
-                    copy_rect(&src[CDEF_HBORDER], CDEF_BSTRIDE, &linebuf[pli][coffset],
-                        stride, CDEF_VBORDER, hsize);
-                }
-                else {
-                    fill_rect(&src[CDEF_HBORDER], CDEF_BSTRIDE, CDEF_VBORDER, hsize,
-                        CDEF_VERY_LARGE);
-                }
-
+            /* Copy in the pixels we need from the current superblock for
+               deringing, the lines below come from the next row.*/
+            copy_sb_16(
+                &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER + cstart],
+                CDEF_BSTRIDE, recBuff[pli],
+                (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr, coffset + cstart,
+                recStride[pli], vsize, cend - cstart, is16bit);
+            if (fbr < nvfb - 1) {
+                const uint16_t *below_lines = &pCs->cdef_line_buf[pli][((fbr + 1) * 2 + 1) * CDEF_VBORDER * stride];
+                copy_rect(&src[(CDEF_VBORDER + vsize) * CDEF_BSTRIDE + CDEF_HBORDER + cstart],
+                    CDEF_BSTRIDE, &below_lines[coffset + cstart], stride,
+                    CDEF_VBORDER, cend - cstart);
+            }
 
-                if (!prev_row_cdef[fbc - 1]) {
-                    copy_sb8_16(//cm,
-                        src, CDEF_BSTRIDE, recBuff/*xd->plane[pli].dst.buf*/,
-                        (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr - CDEF_VBORDER,
-                        coffset - CDEF_HBORDER, recStride/*xd->plane[pli].dst.stride*/,
-                        CDEF_VBORDER, CDEF_HBORDER);
-                }
-                else if (fbr > 0 && fbc > 0) {
-                    copy_rect(src, CDEF_BSTRIDE, &linebuf[pli][coffset - CDEF_HBORDER],
-                        stride, CDEF_VBORDER, CDEF_HBORDER);
-                }
-                else {
-                    fill_rect(src, CDEF_BSTRIDE, CDEF_VBORDER, CDEF_HBORDER,
-                        CDEF_VERY_LARGE);
-                }
+            if (fbr > 0) {
+                copy_rect(&src[CDEF_HBORDER], CDEF_BSTRIDE, &above_lines[coffset],
+                    stride, CDEF_VBORDER, hsize);
+            }
+            else {
+                fill_rect(&src[CDEF_HBORDER], CDEF_BSTRIDE, CDEF_VBORDER, hsize,
+                    CDEF_VERY_LARGE);
+            }
 
+            if (fbr > 0 && fbc > 0) {
+                copy_rect(src, CDEF_BSTRIDE, &above_lines[coffset - CDEF_HBORDER],
+                    stride, CDEF_VBORDER, CDEF_HBORDER);
+            }
+            else {
+                fill_rect(src, CDEF_BSTRIDE, CDEF_VBORDER, CDEF_HBORDER,
+                    CDEF_VERY_LARGE);
+            }
 
-                if (!prev_row_cdef[fbc + 1]) {
-                    copy_sb8_16(//cm,
-                        &src[CDEF_HBORDER + (nhb << mi_wide_l2[pli])],
-                        CDEF_BSTRIDE, recBuff/*xd->plane[pli].dst.buf*/,
-                        (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr - CDEF_VBORDER,
-                        coffset + hsize, recStride/*xd->plane[pli].dst.stride*/, CDEF_VBORDER,
-                        CDEF_HBORDER);
-                }
-                else if (fbr > 0 && fbc < nhfb - 1) {
-                    copy_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE,
-                        &linebuf[pli][coffset + hsize], stride, CDEF_VBORDER,
-                        CDEF_HBORDER);
-                }
-                else {
-                    fill_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE, CDEF_VBORDER,
-                        CDEF_HBORDER, CDEF_VERY_LARGE);
-                }
+            if (fbr > 0 && fbc < nhfb - 1) {
+                copy_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE,
+                    &above_lines[coffset + hsize], stride, CDEF_VBORDER,
+                    CDEF_HBORDER);
+            }
+            else {
+                fill_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE, CDEF_VBORDER,
+                    CDEF_HBORDER, CDEF_VERY_LARGE);
+            }
 
+            if (cdef_left) {
+                /* If we deringed the superblock on the left then we need to copy in
+                   saved pixels. */
+                copy_rect(src, CDEF_BSTRIDE, colbuf[pli], CDEF_HBORDER,
+                    rend + CDEF_VBORDER, CDEF_HBORDER);
+            }
 
-                if (cdef_left) {
-                    /* If we deringed the superblock on the left then we need to copy in
-                       saved pixels. */
-                    copy_rect(src, CDEF_BSTRIDE, colbuf[pli], CDEF_HBORDER,
-                        rend + CDEF_VBORDER, CDEF_HBORDER);
-                }
+            /* Saving pixels in case we need to dering the superblock on the
+                right. */
+            if (fbc < nhfb - 1)
+                copy_rect(colbuf[pli], CDEF_HBORDER, src + hsize, CDEF_BSTRIDE,
+                    rend + CDEF_VBORDER, CDEF_HBORDER);
 
-                /* Saving pixels in case we need to dering the superblock on the
-                    right. */
-                if (fbc < nhfb - 1)
-                    copy_rect(colbuf[pli], CDEF_HBORDER, src + hsize, CDEF_BSTRIDE,
-                        rend + CDEF_VBORDER, CDEF_HBORDER);
-
-                if (fbr < nvfb - 1)
-                    copy_sb8_16(
-                        //cm,
-                        &linebuf[pli][coffset], stride, recBuff/*xd->plane[pli].dst.buf*/,
-                        (MI_SIZE_64X64 << mi_high_l2[pli]) * (fbr + 1) - CDEF_VBORDER,
-                        coffset, recStride/*xd->plane[pli].dst.stride*/, CDEF_VBORDER, hsize);
-
-                if (frame_top) {
-                    fill_rect(src, CDEF_BSTRIDE, CDEF_VBORDER, hsize + 2 * CDEF_HBORDER,
-                        CDEF_VERY_LARGE);
-                }
-                if (frame_left) {
-                    fill_rect(src, CDEF_BSTRIDE, vsize + 2 * CDEF_VBORDER, CDEF_HBORDER,
-                        CDEF_VERY_LARGE);
-                }
-                if (frame_bottom) {
-                    fill_rect(&src[(vsize + CDEF_VBORDER) * CDEF_BSTRIDE], CDEF_BSTRIDE,
-                        CDEF_VBORDER, hsize + 2 * CDEF_HBORDER, CDEF_VERY_LARGE);
-                }
-                if (frame_right) {
-                    fill_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE,
-                        vsize + 2 * CDEF_VBORDER, CDEF_HBORDER, CDEF_VERY_LARGE);
-                }
+            if (frame_top) {
+                fill_rect(src, CDEF_BSTRIDE, CDEF_VBORDER, hsize + 2 * CDEF_HBORDER,
+                    CDEF_VERY_LARGE);
+            }
+            if (frame_left) {
+                fill_rect(src, CDEF_BSTRIDE, vsize + 2 * CDEF_VBORDER, CDEF_HBORDER,
+                    CDEF_VERY_LARGE);
+            }
+            if (frame_bottom) {
+                fill_rect(&src[(vsize + CDEF_VBORDER) * CDEF_BSTRIDE], CDEF_BSTRIDE,
+                    CDEF_VBORDER, hsize + 2 * CDEF_HBORDER, CDEF_VERY_LARGE);
+            }
+            if (frame_right) {
+                fill_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE,
+                    vsize + 2 * CDEF_VBORDER, CDEF_HBORDER, CDEF_VERY_LARGE);
+            }
 
-                //if (cm->use_highbitdepth) {
-                //  cdef_filter_fb(
-                //      NULL,
-                //      &CONVERT_TO_SHORTPTR(
-                //          xd->plane[pli]
-                //              .dst.buf)[xd->plane[pli].dst.stride *
-                //                            (MI_SIZE_64X64 * fbr << mi_high_l2[pli]) +
-                //                        (fbc * MI_SIZE_64X64 << mi_wide_l2[pli])],
-                //      xd->plane[pli].dst.stride,
-                //      &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER], xdec[pli],
-                //      ydec[pli], dir, NULL, var, pli, dlist, cdef_count, level,
-                //      sec_strength, pri_damping, sec_damping, coeff_shift);
-                //} else
-                {
-                    cdef_filter_fb(
-                        &recBuff[recStride *(MI_SIZE_64X64 * fbr << mi_high_l2[pli]) + (fbc * MI_SIZE_64X64 << mi_wide_l2[pli])],
-                        //&xd->plane[pli].dst.buf[xd->plane[pli].dst.stride *(MI_SIZE_64X64 * fbr << mi_high_l2[pli]) +(fbc * MI_SIZE_64X64 << mi_wide_l2[pli])],
-                        NULL, recStride/*xd->plane[pli].dst.stride*/,
-                        &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER], xdec[pli],
-                        ydec[pli], dir, NULL, var, pli, dlist, cdef_count, level,
-                        sec_strength, pri_damping, sec_damping, coeff_shift);
-                }
+            {
+                const int32_t dst_offset = recStride[pli] * (MI_SIZE_64X64 * fbr << mi_high_l2[pli]) + (fbc * MI_SIZE_64X64 << mi_wide_l2[pli]);
+
+                cdef_filter_fb(
+                    is16bit ? NULL : &recBuff[pli][dst_offset],
+                    is16bit ? &((uint16_t*)recBuff[pli])[dst_offset] : NULL,
+                    recStride[pli],
+                    &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER], xdec[pli],
+                    ydec[pli], dir, NULL, var, pli, dlist, cdef_count, level,
+                    sec_strength, pri_damping, sec_damping, coeff_shift);
             }
-            cdef_left = 1;  //CHKN filtered data is written back directy to recFrame.
-        }
-        {
-            uint8_t *tmp = prev_row_cdef;
-            prev_row_cdef = curr_row_cdef;
-            curr_row_cdef = tmp;
         }
-    }
-    aom_free(row_cdef);
-    for (int32_t pli = 0; pli < num_planes; pli++) {
-        aom_free(linebuf[pli]);
-        aom_free(colbuf[pli]);
+        cdef_left = 1;  //CHKN filtered data is written back directy to recFrame.
     }
 }
 
-void av1_cdef_frame16bit(
+void av1_cdef_frame(
     EncDecContext_t                *context_ptr,
     SequenceControlSet           *sequence_control_set_ptr,
     PictureControlSet_t            *pCs
 )
 {
     (void)context_ptr;
-    struct PictureParentControlSet_s     *pPcs = pCs->parent_pcs_ptr;
-    Av1Common*   cm = pPcs->av1_cm;
-
-
-    EbPictureBufferDesc_t  * recon_picture_ptr;
-
-
-    if (pPcs->is_used_as_reference_flag == EB_TRUE)
-        recon_picture_ptr = ((EbReferenceObject*)pCs->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
-
-    else
-        recon_picture_ptr = pCs->recon_picture16bit_ptr;
-
-    uint16_t*  reconBufferY = (uint16_t*)recon_picture_ptr->buffer_y + (recon_picture_ptr->origin_x + recon_picture_ptr->origin_y     * recon_picture_ptr->stride_y);
-    uint16_t*  reconBufferCb = (uint16_t*)recon_picture_ptr->bufferCb + (recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCb);
-    uint16_t*  reconBufferCr = (uint16_t*)recon_picture_ptr->bufferCr + (recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCr);
-
-
-
-    const int32_t num_planes = 3;// av1_num_planes(cm);
-    DECLARE_ALIGNED(16, uint16_t, src[CDEF_INBUF_SIZE]);
-    uint16_t *linebuf[3];
-    uint16_t *colbuf[3];
-    cdef_list dlist[MI_SIZE_64X64 * MI_SIZE_64X64];
-    uint8_t *row_cdef, *prev_row_cdef, *curr_row_cdef;
-    int32_t cdef_count;
-    int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS] = { { 0 } };
-    int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS] = { { 0 } };
-    int32_t mi_wide_l2[3];
-    int32_t mi_high_l2[3];
-    int32_t xdec[3];
-    int32_t ydec[3];
-    int32_t coeff_shift = AOMMAX(sequence_control_set_ptr->static_config.encoder_bit_depth/*cm->bit_depth*/ - 8, 0);
+    Av1Common*   cm = pCs->parent_pcs_ptr->av1_cm;
     const int32_t nvfb = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
-    const int32_t nhfb = (cm->mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
-    //av1_setup_dst_planes(xd->plane, cm->seq_params.sb_size, frame, 0, 0, 0, num_planes);
-    row_cdef = (uint8_t *)aom_malloc(sizeof(*row_cdef) * (nhfb + 2) * 2);
-    ASSERT(row_cdef);
-    memset(row_cdef, 1, sizeof(*row_cdef) * (nhfb + 2) * 2);
-    prev_row_cdef = row_cdef + 1;
-    curr_row_cdef = prev_row_cdef + nhfb + 2;
-    for (int32_t pli = 0; pli < num_planes; pli++) {
-
-        int32_t subsampling_x = (pli == 0) ? 0 : 1;
-        int32_t subsampling_y = (pli == 0) ? 0 : 1;
 
-        xdec[pli] = subsampling_x; //CHKN xd->plane[pli].subsampling_x;
-        ydec[pli] = subsampling_y; //CHKN  xd->plane[pli].subsampling_y;
-        mi_wide_l2[pli] = MI_SIZE_LOG2 - subsampling_x; //CHKN xd->plane[pli].subsampling_x;
-        mi_high_l2[pli] = MI_SIZE_LOG2 - subsampling_y; //CHKN xd->plane[pli].subsampling_y;
-    }
-
-    const int32_t stride = (cm->mi_cols << MI_SIZE_LOG2) + 2 * CDEF_HBORDER;
-    for (int32_t pli = 0; pli < num_planes; pli++) {
-        linebuf[pli] = (uint16_t *)aom_malloc(sizeof(*linebuf) * CDEF_VBORDER * stride);
-        colbuf[pli] = (uint16_t *)aom_malloc(sizeof(*colbuf)  * ((CDEF_BLOCKSIZE << mi_high_l2[pli]) + 2 * CDEF_VBORDER) * CDEF_HBORDER);
-    }
+    av1_cdef_save_boundary_lines(
+        sequence_control_set_ptr,
+        pCs);
 
     for (int32_t fbr = 0; fbr < nvfb; fbr++) {
-
-        for (int32_t pli = 0; pli < num_planes; pli++) {
-            const int32_t block_height =
-                (MI_SIZE_64X64 << mi_high_l2[pli]) + 2 * CDEF_VBORDER;
-            fill_rect(colbuf[pli], CDEF_HBORDER, block_height, CDEF_HBORDER,
-                CDEF_VERY_LARGE);
-        }
-
-        int32_t cdef_left = 1;
-        for (int32_t fbc = 0; fbc < nhfb; fbc++) {
-            int32_t level, sec_strength;
-            int32_t uv_level, uv_sec_strength;
-            int32_t nhb, nvb;
-            int32_t cstart = 0;
-            curr_row_cdef[fbc] = 0;
-
-            //WAHT IS THIS  ?? CHKN -->for
-            if (pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc] == NULL ||
-                pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc]->mbmi.cdef_strength == -1) {
-                cdef_left = 0;
-                printf("\n\n\nCDEF ERROR: Skipping Current FB\n\n\n");
-                continue;
-            }
-
-            if (!cdef_left) cstart = -CDEF_HBORDER;  //CHKN if the left block has not been filtered, then we can use samples on the left as input.
-
-            nhb = AOMMIN(MI_SIZE_64X64, cm->mi_cols - MI_SIZE_64X64 * fbc);
-            nvb = AOMMIN(MI_SIZE_64X64, cm->mi_rows - MI_SIZE_64X64 * fbr);
-            int32_t frame_top, frame_left, frame_bottom, frame_right;
-
-            int32_t mi_row = MI_SIZE_64X64 * fbr;
-            int32_t mi_col = MI_SIZE_64X64 * fbc;
-            // for the current filter block, it's top left corner mi structure (mi_tl)
-            // is first accessed to check whether the top and left boundaries are
-            // frame boundaries. Then bottom-left and top-right mi structures are
-            // accessed to check whether the bottom and right boundaries
-            // (respectively) are frame boundaries.
-            //
-            // Note that we can't just check the bottom-right mi structure - eg. if
-            // we're at the right-hand edge of the frame but not the bottom, then
-            // the bottom-right mi is NULL but the bottom-left is not.
-            frame_top = (mi_row == 0) ? 1 : 0;
-            frame_left = (mi_col == 0) ? 1 : 0;
-
-            if (fbr != nvfb - 1)
-                frame_bottom = (mi_row + MI_SIZE_64X64 == cm->mi_rows) ? 1 : 0;
-            else
-                frame_bottom = 1;
-
-            if (fbc != nhfb - 1)
-                frame_right = (mi_col + MI_SIZE_64X64 == cm->mi_cols) ? 1 : 0;
-            else
-                frame_right = 1;
-
-            const int32_t mbmi_cdef_strength = pCs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride + MI_SIZE_64X64 * fbc]->mbmi.cdef_strength;
-            level = pCs->parent_pcs_ptr->cdef_strengths[mbmi_cdef_strength] / CDEF_SEC_STRENGTHS;
-            sec_strength = pCs->parent_pcs_ptr->cdef_strengths[mbmi_cdef_strength] % CDEF_SEC_STRENGTHS;
-            sec_strength += sec_strength == 3;
-            uv_level = pCs->parent_pcs_ptr->cdef_uv_strengths[mbmi_cdef_strength] / CDEF_SEC_STRENGTHS;
-            uv_sec_strength = pCs->parent_pcs_ptr->cdef_uv_strengths[mbmi_cdef_strength] % CDEF_SEC_STRENGTHS;
-            uv_sec_strength += uv_sec_strength == 3;
-            if ((level == 0 && sec_strength == 0 && uv_level == 0 && uv_sec_strength == 0) ||
-                (cdef_count = sb_compute_cdef_list(pCs, cm, fbr * MI_SIZE_64X64, fbc * MI_SIZE_64X64, dlist, BLOCK_64X64)) == 0) {
-                cdef_left = 0;
-                continue;
-            }
-
-            curr_row_cdef[fbc] = 1;
-            for (int32_t pli = 0; pli < num_planes; pli++) {
-                int32_t coffset;
-                int32_t rend, cend;
-                int32_t pri_damping = pCs->parent_pcs_ptr->cdef_pri_damping;
-                int32_t sec_damping = pCs->parent_pcs_ptr->cdef_sec_damping;
-                int32_t hsize = nhb << mi_wide_l2[pli];
-                int32_t vsize = nvb << mi_high_l2[pli];
-
-                if (pli) {
-                    level = uv_level;
-                    sec_strength = uv_sec_strength;
-                }
-
-                if (fbc == nhfb - 1)
-                    cend = hsize;
-                else
-                    cend = hsize + CDEF_HBORDER;
-
-                if (fbr == nvfb - 1)
-                    rend = vsize;
-                else
-                    rend = vsize + CDEF_VBORDER;
-
-                coffset = fbc * MI_SIZE_64X64 << mi_wide_l2[pli];
-                if (fbc == nhfb - 1) {
-                    /* On the last superblock column, fill in the right border with
-                    CDEF_VERY_LARGE to avoid filtering with the outside. */
-                    fill_rect(&src[cend + CDEF_HBORDER], CDEF_BSTRIDE,
-                        rend + CDEF_VBORDER, hsize + CDEF_HBORDER - cend,
-                        CDEF_VERY_LARGE);
-                }
-                if (fbr == nvfb - 1) {
-                    /* On the last superblock row, fill in the bottom border with
-                    CDEF_VERY_LARGE to avoid filtering with the outside. */
-                    fill_rect(&src[(rend + CDEF_VBORDER) * CDEF_BSTRIDE], CDEF_BSTRIDE,
-                        CDEF_VBORDER, hsize + 2 * CDEF_HBORDER, CDEF_VERY_LARGE);
-                }
-
-
-                uint16_t* recBuff = 0;
-                uint32_t recStride = 0;
-
-                switch (pli) {
-                case 0:
-                    recBuff = reconBufferY;
-                    recStride = recon_picture_ptr->stride_y;
-                    break;
-                case 1:
-                    recBuff = reconBufferCb;
-                    recStride = recon_picture_ptr->strideCb;
-
-                    break;
-                case 2:
-                    recBuff = reconBufferCr;
-                    recStride = recon_picture_ptr->strideCr;
-                    break;
-                }
-
-                //--ok
-                                /* Copy in the pixels we need from the current superblock for
-                                deringing.*/
-
-                copy_sb16_16(//cm,
-                    &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER + cstart],
-                    CDEF_BSTRIDE, recBuff/*xd->plane[pli].dst.buf*/,
-                    (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr, coffset + cstart,
-                    recStride/*xd->plane[pli].dst.stride*/, rend, cend - cstart);
-
-
-
-
-                if (!prev_row_cdef[fbc]) {
-                    copy_sb16_16(//cm,
-                        &src[CDEF_HBORDER], CDEF_BSTRIDE,
-                        recBuff/*xd->plane[pli].dst.buf*/,
-                        (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr - CDEF_VBORDER,
-                        coffset, recStride/*xd->plane[pli].dst.stride*/, CDEF_VBORDER, hsize);
-                }
-                else if (fbr > 0) {
-                    copy_rect(&src[CDEF_HBORDER], CDEF_BSTRIDE, &linebuf[pli][coffset],
-                        stride, CDEF_VBORDER, hsize);
-                }
-                else {
-                    fill_rect(&src[CDEF_HBORDER], CDEF_BSTRIDE, CDEF_VBORDER, hsize,
-                        CDEF_VERY_LARGE);
-                }
-
-
-                if (!prev_row_cdef[fbc - 1]) {
-                    copy_sb16_16(//cm,
-                        src, CDEF_BSTRIDE, recBuff/*xd->plane[pli].dst.buf*/,
-                        (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr - CDEF_VBORDER,
-                        coffset - CDEF_HBORDER, recStride/*xd->plane[pli].dst.stride*/,
-                        CDEF_VBORDER, CDEF_HBORDER);
-                }
-                else if (fbr > 0 && fbc > 0) {
-                    copy_rect(src, CDEF_BSTRIDE, &linebuf[pli][coffset - CDEF_HBORDER],
-                        stride, CDEF_VBORDER, CDEF_HBORDER);
-                }
-                else {
-                    fill_rect(src, CDEF_BSTRIDE, CDEF_VBORDER, CDEF_HBORDER,
-                        CDEF_VERY_LARGE);
-                }
-
-
-
-
-                if (!prev_row_cdef[fbc + 1]) {
-                    copy_sb16_16(//cm,
-                        &src[CDEF_HBORDER + (nhb << mi_wide_l2[pli])],
-                        CDEF_BSTRIDE, recBuff/*xd->plane[pli].dst.buf*/,
-                        (MI_SIZE_64X64 << mi_high_l2[pli]) * fbr - CDEF_VBORDER,
-                        coffset + hsize, recStride/*xd->plane[pli].dst.stride*/, CDEF_VBORDER,
-                        CDEF_HBORDER);
-                }
-                else if (fbr > 0 && fbc < nhfb - 1) {
-                    copy_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE,
-                        &linebuf[pli][coffset + hsize], stride, CDEF_VBORDER,
-                        CDEF_HBORDER);
-                }
-                else {
-                    fill_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE, CDEF_VBORDER,
-                        CDEF_HBORDER, CDEF_VERY_LARGE);
-                }
-
-
-                if (cdef_left) {
-                    /* If we deringed the superblock on the left then we need to copy in
-                    saved pixels. */
-                    copy_rect(src, CDEF_BSTRIDE, colbuf[pli], CDEF_HBORDER,
-                        rend + CDEF_VBORDER, CDEF_HBORDER);
-                }
-
-
-                /* Saving pixels in case we need to dering the superblock on the
-                right. */
-                if (fbc < nhfb - 1)
-                    copy_rect(colbuf[pli], CDEF_HBORDER, src + hsize, CDEF_BSTRIDE,
-                        rend + CDEF_VBORDER, CDEF_HBORDER);
-                if (fbr < nvfb - 1)
-                    copy_sb16_16(
-                        //cm,
-                        &linebuf[pli][coffset], stride, recBuff/*xd->plane[pli].dst.buf*/,
-                        (MI_SIZE_64X64 << mi_high_l2[pli]) * (fbr + 1) - CDEF_VBORDER,
-                        coffset, recStride/*xd->plane[pli].dst.stride*/, CDEF_VBORDER, hsize);
-                if (frame_top) {
-                    fill_rect(src, CDEF_BSTRIDE, CDEF_VBORDER, hsize + 2 * CDEF_HBORDER,
-                        CDEF_VERY_LARGE);
-                }
-                if (frame_left) {
-                    fill_rect(src, CDEF_BSTRIDE, vsize + 2 * CDEF_VBORDER, CDEF_HBORDER,
-                        CDEF_VERY_LARGE);
-                }
-                if (frame_bottom) {
-                    fill_rect(&src[(vsize + CDEF_VBORDER) * CDEF_BSTRIDE], CDEF_BSTRIDE,
-                        CDEF_VBORDER, hsize + 2 * CDEF_HBORDER, CDEF_VERY_LARGE);
-                }
-                if (frame_right) {
-                    fill_rect(&src[hsize + CDEF_HBORDER], CDEF_BSTRIDE,
-                        vsize + 2 * CDEF_VBORDER, CDEF_HBORDER, CDEF_VERY_LARGE);
-                }
-
-
-
-
-                //if (cm->use_highbitdepth) {
-                //  cdef_filter_fb(
-                //      NULL,
-                //      &CONVERT_TO_SHORTPTR(
-                //          xd->plane[pli]
-                //              .dst.buf)[xd->plane[pli].dst.stride *
-                //                            (MI_SIZE_64X64 * fbr << mi_high_l2[pli]) +
-                //                        (fbc * MI_SIZE_64X64 << mi_wide_l2[pli])],
-                //      xd->plane[pli].dst.stride,
-                //      &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER], xdec[pli],
-                //      ydec[pli], dir, NULL, var, pli, dlist, cdef_count, level,
-                //      sec_strength, pri_damping, sec_damping, coeff_shift);
-                //} else
-                {
-                    cdef_filter_fb(
-                        NULL,
-                        &recBuff[recStride *(MI_SIZE_64X64 * fbr << mi_high_l2[pli]) + (fbc * MI_SIZE_64X64 << mi_wide_l2[pli])],
-                        //&xd->plane[pli].dst.buf[xd->plane[pli].dst.stride *(MI_SIZE_64X64 * fbr << mi_high_l2[pli]) +(fbc * MI_SIZE_64X64 << mi_wide_l2[pli])],
-                        recStride/*xd->plane[pli].dst.stride*/,
-                        &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER], xdec[pli],
-                        ydec[pli], dir, NULL, var, pli, dlist, cdef_count, level,
-                        sec_strength, pri_damping, sec_damping, coeff_shift);
-                }
-            }
-            cdef_left = 1;  //CHKN filtered data is written back directy to recFrame.
-        }
-        {
-            uint8_t *tmp = prev_row_cdef;
-            prev_row_cdef = curr_row_cdef;
-            curr_row_cdef = tmp;
-        }
-    }
-    aom_free(row_cdef);
-    for (int32_t pli = 0; pli < num_planes; pli++) {
-        aom_free(linebuf[pli]);
-        aom_free(colbuf[pli]);
+        av1_cdef_frame_row(
+            sequence_control_set_ptr,
+            pCs,
+            fbr);
     }
 }
 
+void av1_cdef_frame16bit(
+    EncDecContext_t                *context_ptr,
+    SequenceControlSet           *sequence_control_set_ptr,
+    PictureControlSet_t            *pCs
+)
+{
+    // av1_cdef_frame_row follows the bit depth of the sequence
+    av1_cdef_frame(
+        context_ptr,
+        sequence_control_set_ptr,
+        pCs);
+}
+
 ///-------search
 
 static int32_t priconv[REDUCED_PRI_STRENGTHS] = { 0, 1, 2, 3, 5, 7, 10, 13 };
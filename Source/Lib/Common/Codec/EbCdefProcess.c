@@ -46,14 +46,13 @@ void finish_cdef_search(
     ,int32_t                         selected_strength_cnt[64]
 
    );
-void av1_cdef_frame16bit(
-    EncDecContext_t                *context_ptr,
+void av1_cdef_save_boundary_lines(
     SequenceControlSet           *sequence_control_set_ptr,
     PictureControlSet_t            *pCs);
-void av1_cdef_frame(
-    EncDecContext_t                *context_ptr,
+void av1_cdef_frame_row(
     SequenceControlSet           *sequence_control_set_ptr,
-    PictureControlSet_t            *pCs);
+    PictureControlSet_t            *pCs,
+    int32_t                         fbr);
 void av1_loop_restoration_save_boundary_lines(const Yv12BufferConfig *frame, Av1Common *cm, int32_t after_cdef);
 
 
@@ -64,6 +63,7 @@ EbErrorType cdef_context_ctor(
     CdefContext_t          **context_dbl_ptr,
     EbFifo                *cdef_input_fifo_ptr,
     EbFifo                *cdef_output_fifo_ptr ,
+    EbFifo                *cdef_feedback_fifo_ptr,
     EbBool                  is16bit,
     uint32_t                max_input_luma_width,
     uint32_t                max_input_luma_height){
@@ -80,6 +80,7 @@ EbErrorType cdef_context_ctor(
     // Input/Output System Resource Manager FIFOs
     context_ptr->cdef_input_fifo_ptr = cdef_input_fifo_ptr;
     context_ptr->cdef_output_fifo_ptr = cdef_output_fifo_ptr;
+    context_ptr->cdef_feedback_fifo_ptr = cdef_feedback_fifo_ptr;
 
 
     return EB_ErrorNone;
@@ -430,10 +431,81 @@ void cdef_seg_search16bit(
 }
 
 
+/******************************************************
+ * Cdef Picture Done
+ *
+ * Prepares restoration and posts the restoration
+ *   segments once every filter block row is filtered.
+ ******************************************************/
+static void cdef_picture_done(
+    CdefContext_t                  *context_ptr,
+    PictureControlSet_t            *picture_control_set_ptr,
+    SequenceControlSet             *sequence_control_set_ptr,
+    EbObjectWrapper                *picture_control_set_wrapper_ptr)
+{
+    EbBool  is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common* cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
+
+    //// Output
+    EbObjectWrapper                       *cdef_results_wrapper_ptr;
+    CdefResults_t                           *cdef_results_ptr;
+
+    //restoration prep
+
+    if (sequence_control_set_ptr->enable_restoration)
+    {
+        av1_loop_restoration_save_boundary_lines(
+            cm->frame_to_show,
+            cm,
+            1);
+
+        //are these still needed here?/!!!
+        extend_frame(cm->frame_to_show->buffers[0], cm->frame_to_show->crop_widths[0], cm->frame_to_show->crop_heights[0],
+            cm->frame_to_show->strides[0], RESTORATION_BORDER, RESTORATION_BORDER, is16bit);
+        extend_frame(cm->frame_to_show->buffers[1], cm->frame_to_show->crop_widths[1], cm->frame_to_show->crop_heights[1],
+            cm->frame_to_show->strides[1], RESTORATION_BORDER, RESTORATION_BORDER, is16bit);
+        extend_frame(cm->frame_to_show->buffers[2], cm->frame_to_show->crop_widths[1], cm->frame_to_show->crop_heights[1],
+            cm->frame_to_show->strides[1], RESTORATION_BORDER, RESTORATION_BORDER, is16bit);
+
+    }
+
+
+
+    picture_control_set_ptr->rest_segments_column_count = sequence_control_set_ptr->rest_segment_column_count;
+    picture_control_set_ptr->rest_segments_row_count =   sequence_control_set_ptr->rest_segment_row_count;
+    picture_control_set_ptr->rest_segments_total_count = (uint16_t)(picture_control_set_ptr->rest_segments_column_count  * picture_control_set_ptr->rest_segments_row_count);
+    picture_control_set_ptr->tot_seg_searched_rest = 0;
+    uint32_t segment_index;
+    for (segment_index = 0; segment_index < picture_control_set_ptr->rest_segments_total_count; ++segment_index)
+    {
+        // Get Empty Cdef Results to Rest
+        eb_get_empty_object(
+            context_ptr->cdef_output_fifo_ptr,
+            &cdef_results_wrapper_ptr);
+        cdef_results_ptr = (struct CdefResults_s*)cdef_results_wrapper_ptr->object_ptr;
+        cdef_results_ptr->picture_control_set_wrapper_ptr = picture_control_set_wrapper_ptr;
+        cdef_results_ptr->segment_index = segment_index;
+        // Post Cdef Results
+        eb_post_full_object(cdef_results_wrapper_ptr);
+
+    }
+}
+
 /******************************************************
  * CDEF Kernel
+ *
+ * DLF posts one result per search segment. The thread
+ *   searching the last segment picks the strengths,
+ *   saves the deblocked lines around the filter block
+ *   rows and publishes the rows, joined by the other
+ *   CDEF threads through feedback results. Each kernel
+ *   call filters the rows it claims; the thread
+ *   completing the last row hands the picture to
+ *   restoration.
  ******************************************************/
-void* cdef_kernel(void *input_ptr)
+void cdef_kernel(
+    void            *input_ptr,
+    EbObjectWrapper *dlf_results_wrapper_ptr)
 {
     // Context & SCS & PCS
     CdefContext_t                            *context_ptr = (CdefContext_t*)input_ptr;
@@ -441,31 +513,27 @@ void* cdef_kernel(void *input_ptr)
     SequenceControlSet                    *sequence_control_set_ptr;
 
     //// Input
-    EbObjectWrapper                       *dlf_results_wrapper_ptr;
     DlfResults_t                            *dlf_results_ptr;
 
-    //// Output
-    EbObjectWrapper                       *cdef_results_wrapper_ptr;
-    CdefResults_t                           *cdef_results_ptr;
-
-    // SB Loop variables
-
-
-    for (;;) {
+    // Filter block row variables
+    SbRowSync_t                             *row_sync_ptr;
+    uint32_t                                 fbr;
+    EbBool                                   search_done_flag = EB_FALSE;
 
-        // Get DLF Results
-        eb_get_full_object(
-            context_ptr->cdef_input_fifo_ptr,
-            &dlf_results_wrapper_ptr);
+    dlf_results_ptr = (DlfResults_t*)dlf_results_wrapper_ptr->object_ptr;
+    picture_control_set_ptr = (PictureControlSet_t*)dlf_results_ptr->picture_control_set_wrapper_ptr->object_ptr;
+    eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
+    sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    row_sync_ptr = picture_control_set_ptr->cdef_row_sync;
+    uint64_t workStartTime = eb_deadline_work_start(sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr);
 
-        dlf_results_ptr = (DlfResults_t*)dlf_results_wrapper_ptr->object_ptr;
-        picture_control_set_ptr = (PictureControlSet_t*)dlf_results_ptr->picture_control_set_wrapper_ptr->object_ptr;
-        sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    EbBool  is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common* cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
 
-        EbBool  is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
-        Av1Common* cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
+    int32_t selected_strength_cnt[64] = { 0 };
 
-        int32_t selected_strength_cnt[64] = { 0 };
+    // Feedback results (no segment) only join the rows of the picture
+    if (dlf_results_ptr->segment_index != CDEF_FEEDBACK_SEGMENT_INDEX) {
 
         if (sequence_control_set_ptr->enable_cdef && picture_control_set_ptr->parent_pcs_ptr->cdef_filter_mode)
         {
@@ -482,42 +550,34 @@ void* cdef_kernel(void *input_ptr)
                     dlf_results_ptr->segment_index);
         }
 
-
         //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
         eb_block_on_mutex(picture_control_set_ptr->cdef_search_mutex);
-
         picture_control_set_ptr->tot_seg_searched_cdef++;
-        if (picture_control_set_ptr->tot_seg_searched_cdef == picture_control_set_ptr->cdef_segments_total_count)
-        {
-
-
-           // printf("    CDEF all seg here  %i\n", picture_control_set_ptr->picture_number);
-
+        search_done_flag = (EbBool)(picture_control_set_ptr->tot_seg_searched_cdef == picture_control_set_ptr->cdef_segments_total_count);
+        eb_release_mutex(picture_control_set_ptr->cdef_search_mutex);
+    }
 
+    if (search_done_flag)
+    {
+        uint32_t row_count = 0;
 
 #if CDEF_REF_ONLY
         if (sequence_control_set_ptr->enable_cdef && picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
 #else
         if (sequence_control_set_ptr->enable_cdef && picture_control_set_ptr->parent_pcs_ptr->cdef_filter_mode) {
 #endif
-                finish_cdef_search(
-                    0,
-                    sequence_control_set_ptr,
-                    picture_control_set_ptr
-                    ,selected_strength_cnt
-                );
-
-                if (is16bit)
-                    av1_cdef_frame16bit(
-                        0,
-                        sequence_control_set_ptr,
-                        picture_control_set_ptr);
-                else
-                    av1_cdef_frame(
-                        0,
-                        sequence_control_set_ptr,
-                        picture_control_set_ptr);
-
+            finish_cdef_search(
+                0,
+                sequence_control_set_ptr,
+                picture_control_set_ptr
+                ,selected_strength_cnt
+            );
+
+            av1_cdef_save_boundary_lines(
+                sequence_control_set_ptr,
+                picture_control_set_ptr);
+
+            row_count = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
         }
         else {
 
@@ -531,60 +591,77 @@ void* cdef_kernel(void *input_ptr)
 
             picture_control_set_ptr->parent_pcs_ptr->nb_cdef_strengths = 0;
 #endif
-
-
         }
 
-
-        //restoration prep
-
-        if (sequence_control_set_ptr->enable_restoration)
-        {
-            av1_loop_restoration_save_boundary_lines(
-                cm->frame_to_show,
-                cm,
-                1);
-
-            //are these still needed here?/!!!
-            extend_frame(cm->frame_to_show->buffers[0], cm->frame_to_show->crop_widths[0], cm->frame_to_show->crop_heights[0],
-                cm->frame_to_show->strides[0], RESTORATION_BORDER, RESTORATION_BORDER, is16bit);
-            extend_frame(cm->frame_to_show->buffers[1], cm->frame_to_show->crop_widths[1], cm->frame_to_show->crop_heights[1],
-                cm->frame_to_show->strides[1], RESTORATION_BORDER, RESTORATION_BORDER, is16bit);
-            extend_frame(cm->frame_to_show->buffers[2], cm->frame_to_show->crop_widths[1], cm->frame_to_show->crop_heights[1],
-                cm->frame_to_show->strides[1], RESTORATION_BORDER, RESTORATION_BORDER, is16bit);
-
+        if (row_count == 0) {
+            cdef_picture_done(
+                context_ptr,
+                picture_control_set_ptr,
+                sequence_control_set_ptr,
+                dlf_results_ptr->picture_control_set_wrapper_ptr);
         }
-
-
-
-        picture_control_set_ptr->rest_segments_column_count = sequence_control_set_ptr->rest_segment_column_count;
-        picture_control_set_ptr->rest_segments_row_count =   sequence_control_set_ptr->rest_segment_row_count;
-        picture_control_set_ptr->rest_segments_total_count = (uint16_t)(picture_control_set_ptr->rest_segments_column_count  * picture_control_set_ptr->rest_segments_row_count);
-        picture_control_set_ptr->tot_seg_searched_rest = 0;
-        uint32_t segment_index;
-        for (segment_index = 0; segment_index < picture_control_set_ptr->rest_segments_total_count; ++segment_index)
-        {
-            // Get Empty Cdef Results to Rest
-            eb_get_empty_object(
-                context_ptr->cdef_output_fifo_ptr,
-                &cdef_results_wrapper_ptr);
-            cdef_results_ptr = (struct CdefResults_s*)cdef_results_wrapper_ptr->object_ptr;
-            cdef_results_ptr->picture_control_set_wrapper_ptr = dlf_results_ptr->picture_control_set_wrapper_ptr;
-            cdef_results_ptr->segment_index = segment_index;
-            // Post Cdef Results
-            eb_post_full_object(cdef_results_wrapper_ptr);
-
+        else {
+            uint32_t helper_count = MIN(row_count, sequence_control_set_ptr->cdef_process_init_count) - 1;
+            uint32_t helper_index;
+
+            // Publish the rows, the strengths and boundary lines are final
+            eb_block_on_mutex(row_sync_ptr->mutex);
+            SbRowSyncInit(row_sync_ptr, row_count, (cm->mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64);
+            row_sync_ptr->readyRowCount = row_count;
+            eb_release_mutex(row_sync_ptr->mutex);
+
+            // Let the other CDEF threads filter rows of the picture; the feedback
+            // is skipped rather than waited for when the DLF results are all in
+            // use, as only the CDEF threads release them.
+            for (helper_index = 0; helper_index < helper_count; ++helper_index) {
+                EbObjectWrapper *feedback_wrapper_ptr;
+                DlfResults_t    *feedback_ptr;
+
+                eb_try_get_empty_object(
+                    context_ptr->cdef_feedback_fifo_ptr,
+                    &feedback_wrapper_ptr);
+                if (feedback_wrapper_ptr == (EbObjectWrapper*)EB_NULL)
+                    break;
+
+                // The helper releases the picture once done with it
+                eb_object_inc_live_count(
+                    dlf_results_ptr->picture_control_set_wrapper_ptr,
+                    1);
+
+                feedback_ptr = (DlfResults_t*)feedback_wrapper_ptr->object_ptr;
+                feedback_ptr->picture_control_set_wrapper_ptr = dlf_results_ptr->picture_control_set_wrapper_ptr;
+                feedback_ptr->segment_index = CDEF_FEEDBACK_SEGMENT_INDEX;
+                eb_post_full_object(feedback_wrapper_ptr);
+            }
         }
+    }
 
+    // Filter block row loop
+    while (SbRowSyncClaimRow(row_sync_ptr, &fbr) == EB_TRUE) {
 
-        }
-        eb_release_mutex(picture_control_set_ptr->cdef_search_mutex);
+        av1_cdef_frame_row(
+            sequence_control_set_ptr,
+            picture_control_set_ptr,
+            (int32_t)fbr);
 
+        if (SbRowSyncCompleteRow(row_sync_ptr) == EB_TRUE) {
+            cdef_picture_done(
+                context_ptr,
+                picture_control_set_ptr,
+                sequence_control_set_ptr,
+                dlf_results_ptr->picture_control_set_wrapper_ptr);
+        }
+    }
 
-        // Release Dlf Results
-        eb_release_object(dlf_results_wrapper_ptr);
+    eb_deadline_work_end(
+        sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr,
+        &picture_control_set_ptr->parent_pcs_ptr->encode_time_us,
+        workStartTime);
 
-    }
+    // Release the picture held for the feedback
+    if (dlf_results_ptr->segment_index == CDEF_FEEDBACK_SEGMENT_INDEX)
+        eb_release_object(dlf_results_ptr->picture_control_set_wrapper_ptr);
 
-    return EB_NULL;
+    // Release Dlf Results
+    eb_release_object(dlf_results_wrapper_ptr);
 }
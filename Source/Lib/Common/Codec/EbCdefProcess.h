@@ -22,6 +22,9 @@ typedef struct CdefContext_s
 {
     EbFifo                       *cdef_input_fifo_ptr;
     EbFifo                       *cdef_output_fifo_ptr;
+    // Posts to the CDEF input to let the other CDEF threads join
+    // the filter block rows of a picture once its strengths are picked
+    EbFifo                       *cdef_feedback_fifo_ptr;
 } CdefContext_t;
 
 /**************************************
@@ -31,11 +34,14 @@ extern EbErrorType cdef_context_ctor(
     CdefContext_t **context_dbl_ptr,
     EbFifo                       *cdef_input_fifo_ptr,
     EbFifo                       *cdef_output_fifo_ptr,
+    EbFifo                       *cdef_feedback_fifo_ptr,
     EbBool                  is16bit,
     uint32_t                max_input_luma_width,
     uint32_t                max_input_luma_height
    );
 
-extern void* cdef_kernel(void *input_ptr);
+extern void cdef_kernel(
+    void            *input_ptr,
+    EbObjectWrapper *dlf_results_wrapper_ptr);
 
 #endif
\ No newline at end of file
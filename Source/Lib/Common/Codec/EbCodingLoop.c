@@ -524,6 +524,70 @@ void encode_pass_tx_search(
     uint16_t                       *eob,
     MacroblockPlane                *candidate_plane);
 
+/**********************************************************
+* MD recon cache
+*   A luma txb is committed from MD when MD kept it for the block and the
+*   encode pass builds the same prediction and quantizes with the same
+*   qindex: the source being the same, the residual, coefficients and
+*   recon are then the same.
+**********************************************************/
+static const MdReconCacheTxb_t *md_recon_cache_txb(
+    const MdReconCache_t *cache,
+    const BlockGeom      *blk_geom,
+    uint32_t              txb_itr)
+{
+    return &cache->txb[(blk_geom->tx_org_y[txb_itr] >> 2) * MD_RECON_CACHE_TXB_STRIDE + (blk_geom->tx_org_x[txb_itr] >> 2)];
+}
+
+static const MdReconCache_t *md_recon_cache_lookup(
+    PictureControlSet_t *picture_control_set_ptr,
+    EncDecContext_t     *context_ptr,
+    const uint8_t       *pred,
+    uint32_t             pred_stride)
+{
+    const BlockGeom         *blk_geom = context_ptr->blk_geom;
+    ModeDecisionContext_t   *md_context = context_ptr->md_context;
+    TransformUnit           *txb_ptr = &context_ptr->cu_ptr->transform_unit_array[context_ptr->txb_itr];
+    uint8_t                  slot = md_context->md_ep_pipe_sb[context_ptr->cu_ptr->mds_idx].recon_cache_slot;
+    const MdReconCache_t    *cache;
+    const MdReconCacheTxb_t *cache_txb;
+    uint32_t                 cache_offset;
+    uint32_t                 j;
+
+    if (slot == MD_RECON_CACHE_SLOT_NONE)
+        return NULL;
+
+    cache = &md_context->md_recon_cache[LOG2F(blk_geom->sq_size) - 2][slot];
+    cache_txb = md_recon_cache_txb(cache, blk_geom, context_ptr->txb_itr);
+    if (!cache_txb->valid ||
+        cache_txb->tx_size != blk_geom->txsize[context_ptr->txb_itr] ||
+        cache_txb->tx_type != txb_ptr->transform_type[PLANE_TYPE_Y] ||
+        cache_txb->qindex != md_recon_cache_qindex(picture_control_set_ptr, context_ptr->cu_ptr->qp))
+        return NULL;
+
+    cache_offset = blk_geom->tx_org_x[context_ptr->txb_itr] + blk_geom->tx_org_y[context_ptr->txb_itr] * MD_RECON_CACHE_STRIDE;
+    for (j = 0; j < blk_geom->tx_height[context_ptr->txb_itr]; j++) {
+        if (memcmp(pred + j * pred_stride, cache->pred + cache_offset + j * MD_RECON_CACHE_STRIDE, blk_geom->tx_width[context_ptr->txb_itr]))
+            return NULL;
+    }
+
+    return cache;
+}
+
+static void md_recon_cache_copy_recon(
+    const MdReconCache_t *cache,
+    const BlockGeom      *blk_geom,
+    uint32_t              txb_itr,
+    uint8_t              *recon,
+    uint32_t              recon_stride)
+{
+    uint32_t cache_offset = blk_geom->tx_org_x[txb_itr] + blk_geom->tx_org_y[txb_itr] * MD_RECON_CACHE_STRIDE;
+    uint32_t j;
+
+    for (j = 0; j < blk_geom->tx_height[txb_itr]; j++)
+        memcpy(recon + j * recon_stride, cache->recon + cache_offset + j * MD_RECON_CACHE_STRIDE, blk_geom->tx_width[txb_itr]);
+}
+
 /**********************************************************
 * Encode Loop
 *
@@ -613,86 +677,109 @@ static void Av1EncodeLoop(
     //**********************************
     if (component_mask == PICTURE_BUFFER_DESC_FULL_MASK || component_mask == PICTURE_BUFFER_DESC_LUMA_MASK)
     {
-
-        ResidualKernel(
-            input_samples->buffer_y + inputLumaOffset,
-            input_samples->stride_y,
-            predSamples->buffer_y + predLumaOffset,
-            predSamples->stride_y,
-            ((int16_t*)residual16bit->buffer_y) + scratchLumaOffset,
-            residual16bit->stride_y,
-            context_ptr->blk_geom->tx_width[context_ptr->txb_itr],
-            context_ptr->blk_geom->tx_height[context_ptr->txb_itr]);
-        
         uint8_t  tx_search_skip_fag = picture_control_set_ptr->parent_pcs_ptr->tx_search_level == TX_SEARCH_ENC_DEC ? get_skip_tx_search_flag(
             context_ptr->blk_geom->sq_size,
             MAX_MODE_COST,
             0,
             1) : 1;
 
-        if (!tx_search_skip_fag) {
+        // Commit the MD txb when the prediction did not change
+        const MdReconCache_t *recon_cache = tx_search_skip_fag ? md_recon_cache_lookup(
+            picture_control_set_ptr,
+            context_ptr,
+            predSamples->buffer_y + predLumaOffset,
+            predSamples->stride_y) : NULL;
+        context_ptr->md_recon_cache_hit[context_ptr->txb_itr] = recon_cache;
+        context_ptr->tot_luma_txb_count++;
+
+        if (recon_cache) {
+            const MdReconCacheTxb_t *cache_txb = md_recon_cache_txb(recon_cache, context_ptr->blk_geom, context_ptr->txb_itr);
+            uint32_t cache_offset = context_ptr->blk_geom->tx_org_x[context_ptr->txb_itr] + context_ptr->blk_geom->tx_org_y[context_ptr->txb_itr] * MD_RECON_CACHE_STRIDE;
+            uint32_t tx_width = context_ptr->blk_geom->tx_width[context_ptr->txb_itr];
+            uint32_t j;
+
+            for (j = 0; j < context_ptr->blk_geom->tx_height[context_ptr->txb_itr]; j++)
+                memcpy(((int32_t*)coeffSamplesTB->buffer_y) + coeff1dOffset + j * tx_width, recon_cache->coeff + cache_offset + j * MD_RECON_CACHE_STRIDE, tx_width * sizeof(int32_t));
+
+            eob[0] = cache_txb->eob;
+            count_non_zero_coeffs[0] = cache_txb->eob;
+            context_ptr->reused_luma_txb_count++;
+        }
+        else {
+            ResidualKernel(
+                input_samples->buffer_y + inputLumaOffset,
+                input_samples->stride_y,
+                predSamples->buffer_y + predLumaOffset,
+                predSamples->stride_y,
+                ((int16_t*)residual16bit->buffer_y) + scratchLumaOffset,
+                residual16bit->stride_y,
+                context_ptr->blk_geom->tx_width[context_ptr->txb_itr],
+                context_ptr->blk_geom->tx_height[context_ptr->txb_itr]);
 
-                encode_pass_tx_search(
-                    picture_control_set_ptr,
-                    context_ptr,
-                    sb_ptr,
-                    cbQp,
-                    coeffSamplesTB,
-                    residual16bit,
-                    transform16bit,
-                    inverse_quant_buffer,
-                    transformScratchBuffer,
-                    asm_type,
-                    count_non_zero_coeffs,
-                    component_mask,
-                    use_delta_qp,
-                    dZoffset,
-                    eob,
-                    candidate_plane);
+            if (!tx_search_skip_fag) {
 
-        }
+                    encode_pass_tx_search(
+                        picture_control_set_ptr,
+                        context_ptr,
+                        sb_ptr,
+                        cbQp,
+                        coeffSamplesTB,
+                        residual16bit,
+                        transform16bit,
+                        inverse_quant_buffer,
+                        transformScratchBuffer,
+                        asm_type,
+                        count_non_zero_coeffs,
+                        component_mask,
+                        use_delta_qp,
+                        dZoffset,
+                        eob,
+                        candidate_plane);
 
-        av1_estimate_transform(
-            ((int16_t*)residual16bit->buffer_y) + scratchLumaOffset,
-            residual16bit->stride_y,
-            ((tran_low_t*)transform16bit->buffer_y) + coeff1dOffset,
-            NOT_USED_VALUE,
-            context_ptr->blk_geom->txsize[context_ptr->txb_itr],
-            &context_ptr->three_quad_energy,
-            transformScratchBuffer,
-            BIT_INCREMENT_8BIT,
-            txb_ptr->transform_type[PLANE_TYPE_Y],
-            asm_type,
-            PLANE_TYPE_Y,
+            }
+
+            av1_estimate_transform(
+                ((int16_t*)residual16bit->buffer_y) + scratchLumaOffset,
+                residual16bit->stride_y,
+                ((tran_low_t*)transform16bit->buffer_y) + coeff1dOffset,
+                NOT_USED_VALUE,
+                context_ptr->blk_geom->txsize[context_ptr->txb_itr],
+                &context_ptr->three_quad_energy,
+                transformScratchBuffer,
+                BIT_INCREMENT_8BIT,
+                txb_ptr->transform_type[PLANE_TYPE_Y],
+                asm_type,
+                PLANE_TYPE_Y,
 #if PF_N2_32X32
-            DEFAULT_SHAPE);
+                DEFAULT_SHAPE);
 #else
-            context_ptr->trans_coeff_shape_luma);
+                context_ptr->trans_coeff_shape_luma);
 #endif
 
-        av1_quantize_inv_quantize(
-            sb_ptr->picture_control_set_ptr,
-            ((tran_low_t*)transform16bit->buffer_y) + coeff1dOffset,
-            NOT_USED_VALUE,
-            ((int32_t*)coeffSamplesTB->buffer_y) + coeff1dOffset,
-            ((int32_t*)inverse_quant_buffer->buffer_y) + coeff1dOffset,
-            qp,
-            context_ptr->blk_geom->tx_width[context_ptr->txb_itr],
-            context_ptr->blk_geom->tx_height[context_ptr->txb_itr],
-            context_ptr->blk_geom->txsize[context_ptr->txb_itr],
-            &eob[0],
-            candidate_plane[0],
-            asm_type,
-            &(count_non_zero_coeffs[0]),
+            av1_quantize_inv_quantize(
+                sb_ptr->picture_control_set_ptr,
+                ((tran_low_t*)transform16bit->buffer_y) + coeff1dOffset,
+                NOT_USED_VALUE,
+                ((int32_t*)coeffSamplesTB->buffer_y) + coeff1dOffset,
+                ((int32_t*)inverse_quant_buffer->buffer_y) + coeff1dOffset,
+                qp,
+                context_ptr->blk_geom->tx_width[context_ptr->txb_itr],
+                context_ptr->blk_geom->tx_height[context_ptr->txb_itr],
+                context_ptr->blk_geom->txsize[context_ptr->txb_itr],
+                &eob[0],
+                candidate_plane[0],
+                asm_type,
+                &(count_non_zero_coeffs[0]),
 #if !PF_N2_32X32
-            0,
+                0,
 #endif
-            0,
-            COMPONENT_LUMA,
-            BIT_INCREMENT_8BIT,
+                0,
+                COMPONENT_LUMA,
+                BIT_INCREMENT_8BIT,
 
-            txb_ptr->transform_type[PLANE_TYPE_Y],
-            clean_sparse_coeff_flag);
+                txb_ptr->transform_type[PLANE_TYPE_Y],
+                clean_sparse_coeff_flag);
+        }
 
         txb_ptr->y_has_coeff = count_non_zero_coeffs[0] ? EB_TRUE : EB_FALSE;
 
@@ -720,7 +807,14 @@ static void Av1EncodeLoop(
 
                 uint8_t     *predBuffer = predSamples->buffer_y + predLumaOffset;
 
-
+                if (recon_cache)
+                    md_recon_cache_copy_recon(
+                        recon_cache,
+                        context_ptr->blk_geom,
+                        context_ptr->txb_itr,
+                        predBuffer,
+                        predSamples->stride_y);
+                else
                 av1_inv_transform_recon8bit(
                     ((int32_t*)inverse_quant_buffer->buffer_y) + coeff1dOffset,
                     predBuffer,
@@ -1436,6 +1530,14 @@ static void Av1EncodeGenerateRecon(
                 (void)asm_type;
                 (void)transformScratchBuffer;
                 uint8_t     *predBuffer = predSamples->buffer_y + predLumaOffset;
+                if (context_ptr->md_recon_cache_hit[context_ptr->txb_itr])
+                    md_recon_cache_copy_recon(
+                        context_ptr->md_recon_cache_hit[context_ptr->txb_itr],
+                        context_ptr->blk_geom,
+                        context_ptr->txb_itr,
+                        predBuffer,
+                        predSamples->stride_y);
+                else
                 av1_inv_transform_recon8bit(
                     ((int32_t*)residual16bit->buffer_y) + context_ptr->coded_area_sb,
                     predBuffer,
@@ -2618,6 +2720,7 @@ EB_EXTERN void AV1EncodePass(
                     context_ptr->blk_geom->bheight == 4) ? EB_TRUE : EB_FALSE;
                 // Evaluate cfl @ EP if applicable, and not done @ MD 
                 context_ptr->evaluate_cfl_ep = (disable_cfl_flag == EB_FALSE && context_ptr->md_context->chroma_level == CHROMA_MODE_1);
+                memset(context_ptr->md_recon_cache_hit, 0, sizeof(context_ptr->md_recon_cache_hit));
 
 
 #if ADD_DELTA_QP_SUPPORT
@@ -2798,7 +2901,7 @@ EB_EXTERN void AV1EncodePass(
                                         if (context_ptr->cu_origin_x != 0)
                                             memcpy(leftNeighArray + 1, (uint16_t*)(ep_luma_recon_neighbor_array->leftArray) + context_ptr->cu_origin_y, blk_geom->bheight * 2 * sizeof(uint16_t));
                                         if (context_ptr->cu_origin_y != 0 && context_ptr->cu_origin_x != 0)
-                                            topNeighArray[0] = leftNeighArray[0] = ((uint16_t*)(ep_luma_recon_neighbor_array->topLeftArray) + MAX_PICTURE_HEIGHT_SIZE + context_ptr->cu_origin_x - context_ptr->cu_origin_y)[0];
+                                            topNeighArray[0] = leftNeighArray[0] = ((uint16_t*)(ep_luma_recon_neighbor_array->topLeftArray) + ep_luma_recon_neighbor_array->leftArraySize + context_ptr->cu_origin_x - context_ptr->cu_origin_y)[0];
                                     }
 
                                     else if (plane == 1) {
@@ -2807,7 +2910,7 @@ EB_EXTERN void AV1EncodePass(
                                         if (cu_originx_uv != 0)
                                             memcpy(leftNeighArray + 1, (uint16_t*)(ep_cb_recon_neighbor_array->leftArray) + cu_originy_uv, blk_geom->bheight_uv * 2 * sizeof(uint16_t));
                                         if (cu_originy_uv != 0 && cu_originx_uv != 0)
-                                            topNeighArray[0] = leftNeighArray[0] = ((uint16_t*)(ep_cb_recon_neighbor_array->topLeftArray) + MAX_PICTURE_HEIGHT_SIZE / 2 + cu_originx_uv - cu_originy_uv)[0];
+                                            topNeighArray[0] = leftNeighArray[0] = ((uint16_t*)(ep_cb_recon_neighbor_array->topLeftArray) + ep_cb_recon_neighbor_array->leftArraySize + cu_originx_uv - cu_originy_uv)[0];
                                     }
                                     else {
                                         if (cu_originy_uv != 0)
@@ -2815,7 +2918,7 @@ EB_EXTERN void AV1EncodePass(
                                         if (cu_originx_uv != 0)
                                             memcpy(leftNeighArray + 1, (uint16_t*)(ep_cr_recon_neighbor_array->leftArray) + cu_originy_uv, blk_geom->bheight_uv * 2 * sizeof(uint16_t));
                                         if (cu_originy_uv != 0 && cu_originx_uv != 0)
-                                            topNeighArray[0] = leftNeighArray[0] = ((uint16_t*)(ep_cr_recon_neighbor_array->topLeftArray) + MAX_PICTURE_HEIGHT_SIZE / 2 + cu_originx_uv - cu_originy_uv)[0];
+                                            topNeighArray[0] = leftNeighArray[0] = ((uint16_t*)(ep_cr_recon_neighbor_array->topLeftArray) + ep_cr_recon_neighbor_array->leftArraySize + cu_originx_uv - cu_originy_uv)[0];
 
                                     }
 
@@ -2868,7 +2971,7 @@ EB_EXTERN void AV1EncodePass(
                                             memcpy(leftNeighArray + 1, ep_luma_recon_neighbor_array->leftArray + context_ptr->cu_origin_y, blk_geom->bheight * 2);
 
                                         if (context_ptr->cu_origin_y != 0 && context_ptr->cu_origin_x != 0)
-                                            topNeighArray[0] = leftNeighArray[0] = ep_luma_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE + context_ptr->cu_origin_x - context_ptr->cu_origin_y];
+                                            topNeighArray[0] = leftNeighArray[0] = ep_luma_recon_neighbor_array->topLeftArray[ep_luma_recon_neighbor_array->leftArraySize + context_ptr->cu_origin_x - context_ptr->cu_origin_y];
                                     }
 
                                     else if (plane == 1) {
@@ -2879,7 +2982,7 @@ EB_EXTERN void AV1EncodePass(
                                             memcpy(leftNeighArray + 1, ep_cb_recon_neighbor_array->leftArray + cu_originy_uv, blk_geom->bheight_uv * 2);
 
                                         if (cu_originy_uv != 0 && cu_originx_uv != 0)
-                                            topNeighArray[0] = leftNeighArray[0] = ep_cb_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE / 2 + cu_originx_uv - cu_originy_uv];
+                                            topNeighArray[0] = leftNeighArray[0] = ep_cb_recon_neighbor_array->topLeftArray[ep_cb_recon_neighbor_array->leftArraySize + cu_originx_uv - cu_originy_uv];
                                     }
                                     else {
                                         if (cu_originy_uv != 0)
@@ -2889,7 +2992,7 @@ EB_EXTERN void AV1EncodePass(
                                             memcpy(leftNeighArray + 1, ep_cr_recon_neighbor_array->leftArray + cu_originy_uv, blk_geom->bheight_uv * 2);
 
                                         if (cu_originy_uv != 0 && cu_originx_uv != 0)
-                                            topNeighArray[0] = leftNeighArray[0] = ep_cr_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE / 2 + cu_originx_uv - cu_originy_uv];
+                                            topNeighArray[0] = leftNeighArray[0] = ep_cr_recon_neighbor_array->topLeftArray[ep_cr_recon_neighbor_array->leftArraySize + cu_originx_uv - cu_originy_uv];
                                     }
 
                                     if (plane)
@@ -3266,7 +3369,12 @@ EB_EXTERN void AV1EncodePass(
                             if (context_ptr->trans_coeff_shape_luma != ONLY_DC_SHAPE) {
 #endif
                                 // Compute Tu distortion
-                                if (!zeroLumaCbfMD)
+                                if (!zeroLumaCbfMD && context_ptr->md_recon_cache_hit[tuIt]) {
+                                    const MdReconCacheTxb_t *cache_txb = md_recon_cache_txb(context_ptr->md_recon_cache_hit[tuIt], blk_geom, tuIt);
+                                    yTuFullDistortion[DIST_CALC_RESIDUAL] = cache_txb->y_distortion[DIST_CALC_RESIDUAL];
+                                    yTuFullDistortion[DIST_CALC_PREDICTION] = cache_txb->y_distortion[DIST_CALC_PREDICTION];
+                                }
+                                else if (!zeroLumaCbfMD)
 
                                     // LUMA DISTORTION
                                     picture_full_distortion32_bits(
@@ -3626,23 +3734,7 @@ EB_EXTERN void AV1EncodePass(
     } // CU Loop
 
     sb_ptr->tot_final_cu = final_cu_itr;
-#if AV1_LF
-    // First Pass Deblocking
-    if (dlfEnableFlag && picture_control_set_ptr->parent_pcs_ptr->loop_filter_mode == 1) {
-        if (picture_control_set_ptr->parent_pcs_ptr->lf.filter_level[0] || picture_control_set_ptr->parent_pcs_ptr->lf.filter_level[1]) {
-            uint8_t LastCol = ((sb_origin_x)+sb_width == sequence_control_set_ptr->luma_width) ? 1 : 0;
-            loop_filter_sb(
-                recon_buffer,
-                picture_control_set_ptr,
-                NULL,
-                sb_origin_y >> 2,
-                sb_origin_x >> 2,
-                0,
-                3,
-                LastCol);
-        }
-    }
-#endif
+    // Deblocking of the SB is done by DLF, as soon as its SB row is coded
 
     return;
 }
@@ -311,8 +311,8 @@ extern "C" {
         // [two buffers used ping-pong]
         uint32_t *hash_value_buffer[2][2];
         uint8_t  is_exhaustive_allowed;
-        CRC_CALCULATOR crc_calculator1;
-        CRC_CALCULATOR crc_calculator2;
+        // tables of the C version of the CRC-32C, shared with the picture
+        CRC32C *crc_calculator;
 
     } IntraBcContext;
 
@@ -196,14 +196,6 @@ extern "C" {
     };
 
 
-    static EB_SADLOOPKERNELNxM_TYPE FUNC_TABLE NxMSadLoopKernel_funcPtrArray[ASM_TYPE_TOTAL] =
-    {
-        // NON_AVX2
-        sad_loop_kernel_sse4_1_intrin,
-        // AVX2
-        sad_loop_kernel_avx2_intrin,
-    };
-
     static EB_GETEIGHTSAD8x8 FUNC_TABLE GetEightHorizontalSearchPointResults_8x8_16x16_funcPtrArray[ASM_TYPE_TOTAL] =
     {
         // NON_AVX2
@@ -0,0 +1,171 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+
+#include "EbDeadlineControl.h"
+
+/**************************************
+ * Effort levels
+ **************************************/
+static const EbDeadlineEffort deadline_effort_array[DEADLINE_EFFORT_LEVEL_COUNT] = {
+    // nfl  nsq  me   cdef sg   wn
+    {  0,   6,   0,   5,   4,   3 },
+    {  1,   3,   0,   2,   3,   2 },
+    {  1,   1,   0,   2,   2,   2 },
+    {  2,   0,   1,   1,   1,   2 },
+    {  3,   0,   1,   1,   1,   0 },
+    {  4,   0,   2,   1,   1,   0 }
+};
+
+/**************************************
+ * eb_deadline_control_ctor
+ **************************************/
+EbErrorType eb_deadline_control_ctor(
+    EbDeadlineControl  **control_dbl_ptr,
+    uint32_t             frame_rate,
+    uint32_t             core_count)
+{
+    EbDeadlineControl *control_ptr;
+
+    if (frame_rate == 0)
+        return EB_ErrorBadParameter;
+
+    EB_MALLOC(EbDeadlineControl*, control_ptr, sizeof(EbDeadlineControl), EB_N_PTR);
+    *control_dbl_ptr = control_ptr;
+
+    // frame_rate is in Q16 above 1000 fps
+    control_ptr->picture_budget_us = (frame_rate > 1000) ?
+        ((uint64_t)1000000 << 16) / frame_rate :
+        (uint64_t)1000000 / frame_rate;
+    control_ptr->core_count = core_count ? core_count : 1;
+
+    control_ptr->effort_level = 0;
+    control_ptr->anchor_time_us = 0;
+    control_ptr->base_latency_us = 0;
+    control_ptr->started_picture_number = 0;
+    control_ptr->change_picture_number = 0;
+    control_ptr->change_lateness_us = 0;
+    control_ptr->work_us = 0;
+
+    EB_CREATEMUTEX(EbHandle, control_ptr->timeline_mutex, sizeof(EbHandle), EB_MUTEX);
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * eb_deadline_control_start_picture
+ **************************************/
+uint8_t eb_deadline_control_start_picture(
+    EbDeadlineControl   *control_ptr,
+    uint64_t             picture_number)
+{
+    eb_block_on_mutex(control_ptr->timeline_mutex);
+    control_ptr->started_picture_number = picture_number;
+    eb_release_mutex(control_ptr->timeline_mutex);
+
+    return (uint8_t)eb_atomic_load_32(&control_ptr->effort_level);
+}
+
+/**************************************
+ * eb_deadline_control_output_picture
+ **************************************/
+void eb_deadline_control_output_picture(
+    EbDeadlineControl   *control_ptr,
+    uint64_t             picture_number,
+    uint64_t             decode_order,
+    uint64_t             arrival_time_us,
+    uint64_t             work_us)
+{
+    uint64_t  timeStamp = eb_get_time_stamp_us();
+    uint64_t  coreBudget = control_ptr->picture_budget_us * control_ptr->core_count;
+    int64_t   decodeTime = (int64_t)(decode_order * control_ptr->picture_budget_us);
+    int64_t   dueTime;
+    int64_t   lateness;
+    uint64_t  utilization;
+    int32_t   effortLevel;
+
+    eb_block_on_mutex(control_ptr->timeline_mutex);
+
+    // The first picture is on time, whatever the look ahead it waited for
+    if (control_ptr->anchor_time_us == 0) {
+        control_ptr->base_latency_us = timeStamp - arrival_time_us;
+        control_ptr->anchor_time_us = (int64_t)timeStamp - decodeTime;
+        control_ptr->work_us = work_us;
+        eb_release_mutex(control_ptr->timeline_mutex);
+        return;
+    }
+
+    control_ptr->work_us = (uint64_t)((int64_t)control_ptr->work_us +
+        (((int64_t)work_us - (int64_t)control_ptr->work_us) >> DEADLINE_WORK_SMOOTHING_LOG2));
+
+    // A picture that arrived after its predecessor was due cannot be
+    // late because of the encoder: restart the timeline from its arrival
+    dueTime = control_ptr->anchor_time_us + decodeTime;
+    if ((int64_t)(arrival_time_us + control_ptr->base_latency_us) > dueTime) {
+        dueTime = (int64_t)(arrival_time_us + control_ptr->base_latency_us);
+        control_ptr->anchor_time_us = dueTime - decodeTime;
+    }
+    lateness = (int64_t)timeStamp - dueTime;
+    utilization = control_ptr->work_us * 100 / coreBudget;
+
+    // Wait for the pictures started with the current level to be output
+    if (picture_number < control_ptr->change_picture_number) {
+        eb_release_mutex(control_ptr->timeline_mutex);
+        return;
+    }
+
+    effortLevel = eb_atomic_load_32(&control_ptr->effort_level);
+    if (effortLevel + 1 < DEADLINE_EFFORT_LEVEL_COUNT &&
+        ((lateness > (int64_t)(control_ptr->picture_budget_us * DEADLINE_TOLERANCE_PICTURES) && lateness >= control_ptr->change_lateness_us) ||
+        utilization > DEADLINE_UTILIZATION_HIGH))
+        ++effortLevel;
+    else if (effortLevel > 0 && lateness <= 0 && utilization < DEADLINE_UTILIZATION_LOW)
+        --effortLevel;
+
+    if (effortLevel != eb_atomic_load_32(&control_ptr->effort_level)) {
+        eb_atomic_store_32(&control_ptr->effort_level, effortLevel);
+        control_ptr->change_picture_number = control_ptr->started_picture_number;
+        control_ptr->change_lateness_us = lateness;
+    }
+
+    eb_release_mutex(control_ptr->timeline_mutex);
+}
+
+/**************************************
+ * eb_deadline_control_get_deadline
+ **************************************/
+uint64_t eb_deadline_control_get_deadline(
+    EbDeadlineControl   *control_ptr,
+    uint64_t             decode_order,
+    uint64_t             arrival_time_us)
+{
+    int64_t  anchorTime;
+    uint64_t baseLatency;
+    int64_t  dueTime;
+
+    eb_block_on_mutex(control_ptr->timeline_mutex);
+    anchorTime = control_ptr->anchor_time_us;
+    baseLatency = control_ptr->base_latency_us;
+    eb_release_mutex(control_ptr->timeline_mutex);
+
+    if (anchorTime == 0)
+        return 0;
+
+    dueTime = anchorTime + (int64_t)(decode_order * control_ptr->picture_budget_us);
+    if ((int64_t)(arrival_time_us + baseLatency) > dueTime)
+        dueTime = (int64_t)(arrival_time_us + baseLatency);
+
+    return (uint64_t)dueTime + control_ptr->picture_budget_us * DEADLINE_TOLERANCE_PICTURES;
+}
+
+/**************************************
+ * eb_deadline_control_get_effort
+ **************************************/
+const EbDeadlineEffort *eb_deadline_control_get_effort(
+    uint8_t              effort_level)
+{
+    return &deadline_effort_array[effort_level < DEADLINE_EFFORT_LEVEL_COUNT ? effort_level : DEADLINE_EFFORT_LEVEL_COUNT - 1];
+}
@@ -0,0 +1,150 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbDeadlineControl_h
+#define EbDeadlineControl_h
+
+#include "EbDefinitions.h"
+#include "EbThreads.h"
+#include "EbUtility.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+    /*********************************
+     * Defines
+     *********************************/
+#define DEADLINE_EFFORT_LEVEL_COUNT         6       // level 0 keeps the preset settings
+#define DEADLINE_LATE_NFL_LEVEL             7       // NFL level of the SBs coded past the deadline
+#define DEADLINE_TOLERANCE_PICTURES         2       // lateness tolerated before lowering the effort
+#define DEADLINE_UTILIZATION_LOW            75      // % of the core budget below which the effort is raised
+#define DEADLINE_UTILIZATION_HIGH           100     // % of the core budget above which the effort is lowered
+#define DEADLINE_WORK_SMOOTHING_LOG2        3       // weight of a new picture in the work average is 1/8
+
+    /*********************************************************************
+     * DeadlineEffort
+     *   Settings of one effort level, applied on top of the settings the
+     *   enc_mode of the picture selects. Caps only lower the effort.
+     *********************************************************************/
+    typedef struct EbDeadlineEffort
+    {
+        uint8_t                  nfl_level_delta;       // added to the NFL level of the SBs
+        uint8_t                  nsq_max_shapes;        // NSQ shapes tested at most, 0 for NSQ off
+        uint8_t                  me_search_area_shift;  // ME search area width and height shift
+        uint8_t                  cdef_filter_mode_max;
+        uint8_t                  sg_filter_mode_max;
+        uint8_t                  wn_filter_mode_max;
+
+    } EbDeadlineEffort;
+
+    /*********************************************************************
+     * DeadlineControl
+     *   Real-time speed control of speed_control_flag 2. Pictures must be
+     *   output at the target frame rate: each picture is due one picture
+     *   budget after the previous one in decode order, or base latency
+     *   after its arrival when the input stalled.
+     *   The effort level is lowered when the output falls behind or the
+     *   encoding work exceeds what the cores can do in the picture budget,
+     *   and raised again when the output is on time with spare cores.
+     *
+     *   Packetization changes effort_level atomically and the timeline
+     *   under timeline_mutex, which Resource Coordination and EncDec
+     *   take to read it.
+     *********************************************************************/
+    typedef struct EbDeadlineControl
+    {
+        uint64_t                 picture_budget_us;
+        uint32_t                 core_count;
+
+        volatile int32_t         effort_level;
+
+        EbHandle                 timeline_mutex;
+
+        // Due time of decode order 0 on the current timeline, 0 until
+        // the first picture is output
+        int64_t                  anchor_time_us;
+        uint64_t                 base_latency_us;
+
+        // Picture number of the last started picture, and of the last
+        // started picture when the effort level changed
+        uint64_t                 started_picture_number;
+        uint64_t                 change_picture_number;
+        int64_t                  change_lateness_us;
+
+        // Busy time of the stages per picture, averaged
+        uint64_t                 work_us;
+
+    } EbDeadlineControl;
+
+    /*********************************************************************
+     * eb_deadline_control_ctor
+     *   frame_rate
+     *      Target frame rate, in fps or in Q16 fps when above 1000.
+     *   core_count
+     *      Number of logical processors the encoder threads run on.
+     *********************************************************************/
+    extern EbErrorType eb_deadline_control_ctor(
+        EbDeadlineControl  **control_dbl_ptr,
+        uint32_t             frame_rate,
+        uint32_t             core_count);
+
+    /*********************************************************************
+     * eb_deadline_control_start_picture
+     *   Called by Resource Coordination when a picture enters the
+     *   pipeline; returns the effort level of the picture.
+     *********************************************************************/
+    extern uint8_t eb_deadline_control_start_picture(
+        EbDeadlineControl   *control_ptr,
+        uint64_t             picture_number);
+
+    /*********************************************************************
+     * eb_deadline_control_output_picture
+     *   Called by Packetization when a picture is output, in decode
+     *   order. arrival_time_us is the eb_get_time_stamp_us() time the
+     *   picture started at, work_us the busy time the stages spent on it.
+     *********************************************************************/
+    extern void eb_deadline_control_output_picture(
+        EbDeadlineControl   *control_ptr,
+        uint64_t             picture_number,
+        uint64_t             decode_order,
+        uint64_t             arrival_time_us,
+        uint64_t             work_us);
+
+    /*********************************************************************
+     * eb_deadline_control_get_deadline
+     *   Time the picture must be output by, tolerance included; 0 while
+     *   no picture was output.
+     *********************************************************************/
+    extern uint64_t eb_deadline_control_get_deadline(
+        EbDeadlineControl   *control_ptr,
+        uint64_t             decode_order,
+        uint64_t             arrival_time_us);
+
+    extern const EbDeadlineEffort *eb_deadline_control_get_effort(
+        uint8_t              effort_level);
+
+    /*********************************************************************
+     * Work accounting
+     *   Brackets the processing of an object by a stage; no-op when the
+     *   deadline control is off.
+     *********************************************************************/
+    static INLINE uint64_t eb_deadline_work_start(
+        EbDeadlineControl   *control_ptr)
+    {
+        return control_ptr ? eb_get_time_stamp_us() : 0;
+    }
+
+    static INLINE void eb_deadline_work_end(
+        EbDeadlineControl   *control_ptr,
+        volatile int64_t    *work_us,
+        uint64_t             start_time_us)
+    {
+        if (control_ptr)
+            eb_atomic_fetch_add_64(work_us, (int64_t)(eb_get_time_stamp_us() - start_time_us));
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif //EbDeadlineControl_h
@@ -1467,166 +1467,248 @@ void EbCopyBuffer(
 //    }
 //}
 
-uint64_t PictureSseCalculations(
+/******************************************************
+ * Picture Sse Rows
+ *
+ * SSE between the recon and the input over the luma
+ *   rows [rowStart, rowEnd) of the plane, the chroma
+ *   planes covering the matching half rows.
+ ******************************************************/
+static uint64_t PictureSseRows(
     PictureControlSet_t    *picture_control_set_ptr,
-    EbPictureBufferDesc_t *recon_ptr,
-    int32_t plane)
-
+    EbPictureBufferDesc_t  *recon_ptr,
+    int32_t                 plane,
+    uint32_t                rowStart,
+    uint32_t                rowEnd)
 {
     SequenceControlSet   *sequence_control_set_ptr = picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_ptr;
     EbBool is16bit = (sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    EbPictureBufferDesc_t *input_picture_ptr = is16bit ?
+        picture_control_set_ptr->input_frame16bit :
+        (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+
+    uint32_t   columnIndex;
+    uint32_t   row_index;
+    uint32_t   width;
+    uint32_t   height;
+    uint64_t   residualDistortion = 0;
+    uint32_t   inputOffset;
+    uint32_t   reconOffset;
+    uint16_t   inputStride;
+    uint16_t   reconStride;
+    EbByte     inputBuffer;
+    EbByte     reconCoeffBuffer;
 
-    if (!is16bit) {
-
-        EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-
-        uint32_t   columnIndex;
-        uint32_t   row_index = 0;
-        uint64_t   residualDistortion = 0;
-        EbByte  inputBuffer;
-        EbByte  reconCoeffBuffer;
-        if (plane == 0) {
-            reconCoeffBuffer = &((recon_ptr->buffer_y)[recon_ptr->origin_x + recon_ptr->origin_y * recon_ptr->stride_y]);
-            inputBuffer = &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-
-            residualDistortion = 0;
+    if (plane == 0) {
+        width = sequence_control_set_ptr->luma_width;
+        height = sequence_control_set_ptr->luma_height;
+        inputStride = input_picture_ptr->stride_y;
+        reconStride = recon_ptr->stride_y;
+        inputOffset = input_picture_ptr->origin_x + input_picture_ptr->origin_y * inputStride;
+        reconOffset = recon_ptr->origin_x + recon_ptr->origin_y * reconStride;
+        inputBuffer = input_picture_ptr->buffer_y;
+        reconCoeffBuffer = recon_ptr->buffer_y;
+    }
+    else {
+        width = sequence_control_set_ptr->chroma_width;
+        height = sequence_control_set_ptr->chroma_height;
+        inputStride = (plane == 1) ? input_picture_ptr->strideCb : input_picture_ptr->strideCr;
+        reconStride = (plane == 1) ? recon_ptr->strideCb : recon_ptr->strideCr;
+        inputOffset = input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * inputStride;
+        reconOffset = recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * reconStride;
+        inputBuffer = (plane == 1) ? input_picture_ptr->bufferCb : input_picture_ptr->bufferCr;
+        reconCoeffBuffer = (plane == 1) ? recon_ptr->bufferCb : recon_ptr->bufferCr;
+        rowStart >>= 1;
+        rowEnd = (rowEnd + 1) >> 1;
+    }
+    rowEnd = MIN(rowEnd, height);
 
-            while (row_index < sequence_control_set_ptr->luma_height) {
+    if (!is16bit) {
+        inputBuffer += inputOffset + rowStart * inputStride;
+        reconCoeffBuffer += reconOffset + rowStart * reconStride;
 
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->luma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-                inputBuffer += input_picture_ptr->stride_y;
-                reconCoeffBuffer += recon_ptr->stride_y;
-                ++row_index;
+        for (row_index = rowStart; row_index < rowEnd; ++row_index) {
+            for (columnIndex = 0; columnIndex < width; ++columnIndex) {
+                residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
             }
-
-            return residualDistortion;
+            inputBuffer += inputStride;
+            reconCoeffBuffer += reconStride;
         }
+    }
+    else {
+        uint16_t *inputBuffer16 = (uint16_t*)inputBuffer + inputOffset + rowStart * inputStride;
+        uint16_t *reconCoeffBuffer16 = (uint16_t*)reconCoeffBuffer + reconOffset + rowStart * reconStride;
 
-        else if (plane == 1) {
-
-            reconCoeffBuffer = &((recon_ptr->bufferCb)[recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCb]);
-            inputBuffer = &((input_picture_ptr->bufferCb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb]);
-
-            residualDistortion = 0;
-            row_index = 0;
-            while (row_index < sequence_control_set_ptr->chroma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->strideCb;
-                reconCoeffBuffer += recon_ptr->strideCb;
-                ++row_index;
-            }
-
-            return residualDistortion;
-        }
-        else if (plane == 2) {
-            reconCoeffBuffer = &((recon_ptr->bufferCr)[recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCr]);
-            inputBuffer = &((input_picture_ptr->bufferCr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr]);
-            residualDistortion = 0;
-            row_index = 0;
-
-            while (row_index < sequence_control_set_ptr->chroma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->strideCr;
-                reconCoeffBuffer += recon_ptr->strideCr;
-                ++row_index;
+        for (row_index = rowStart; row_index < rowEnd; ++row_index) {
+            for (columnIndex = 0; columnIndex < width; ++columnIndex) {
+                residualDistortion += (int64_t)SQR(((int64_t)inputBuffer16[columnIndex]) - (int64_t)(reconCoeffBuffer16[columnIndex]));
             }
-
-            return residualDistortion;
+            inputBuffer16 += inputStride;
+            reconCoeffBuffer16 += reconStride;
         }
-        return 0;
     }
-    else {
-        EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->input_frame16bit;
 
-        uint32_t   columnIndex;
-        uint32_t   row_index = 0;
-        uint64_t   residualDistortion = 0;
-        uint16_t*  inputBuffer;
-        uint16_t*  reconCoeffBuffer;
-        if (plane == 0) {
-            reconCoeffBuffer = (uint16_t*)&((recon_ptr->buffer_y)[(recon_ptr->origin_x + recon_ptr->origin_y * recon_ptr->stride_y) << is16bit]);
-            inputBuffer = (uint16_t*)&((input_picture_ptr->buffer_y)[(input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y) << is16bit]);
+    return residualDistortion;
+}
 
-            residualDistortion = 0;
+uint64_t PictureSseCalculations(
+    PictureControlSet_t    *picture_control_set_ptr,
+    EbPictureBufferDesc_t *recon_ptr,
+    int32_t plane)
 
-            while (row_index < sequence_control_set_ptr->luma_height) {
+{
+    return PictureSseRows(
+        picture_control_set_ptr,
+        recon_ptr,
+        plane,
+        0,
+        picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_ptr->luma_height);
+}
 
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->luma_width) {
-                    residualDistortion += (int64_t)SQR(((int64_t)inputBuffer[columnIndex]) - (int64_t)(reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
+/******************************************************
+ * Copy Buffer Rows
+ *
+ * EbCopyBuffer restricted to the luma rows
+ *   [rowStart, rowEnd) of the plane.
+ ******************************************************/
+static void CopyBufferRows(
+    EbPictureBufferDesc_t  *srcBuffer,
+    EbPictureBufferDesc_t  *dstBuffer,
+    PictureControlSet_t    *pcsPtr,
+    int32_t                 plane,
+    uint32_t                rowStart,
+    uint32_t                rowEnd)
+{
+    EbBool is16bit = (EbBool)(pcsPtr->parent_pcs_ptr->sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    uint16_t   luma_width = (uint16_t)(srcBuffer->width - pcsPtr->parent_pcs_ptr->sequence_control_set_ptr->pad_right) << is16bit;
+    uint16_t   luma_height = (uint16_t)(srcBuffer->height - pcsPtr->parent_pcs_ptr->sequence_control_set_ptr->pad_bottom);
+    uint32_t   width = luma_width;
+    uint32_t   stride = srcBuffer->stride_y << is16bit;
+    uint32_t   bufferOffset = (srcBuffer->origin_x + srcBuffer->origin_y * srcBuffer->stride_y) << is16bit;
+    EbByte     srcPtr = srcBuffer->buffer_y;
+    EbByte     dstPtr = dstBuffer->buffer_y;
+    uint32_t   inputRowIndex;
+
+    rowEnd = MIN(rowEnd, luma_height);
+    if (plane) {
+        uint16_t strideC = (plane == 1) ? srcBuffer->strideCb : srcBuffer->strideCr;
+        width = luma_width >> 1;
+        stride = strideC << is16bit;
+        bufferOffset = (srcBuffer->origin_x / 2 + srcBuffer->origin_y / 2 * strideC) << is16bit;
+        srcPtr = (plane == 1) ? srcBuffer->bufferCb : srcBuffer->bufferCr;
+        dstPtr = (plane == 1) ? dstBuffer->bufferCb : dstBuffer->bufferCr;
+        rowStart >>= 1;
+        rowEnd = MIN(rowEnd >> 1, (uint32_t)(luma_height >> 1));
+    }
 
-                inputBuffer += input_picture_ptr->stride_y;
-                reconCoeffBuffer += recon_ptr->stride_y;
-                ++row_index;
-            }
+    for (inputRowIndex = rowStart; inputRowIndex < rowEnd; inputRowIndex++) {
+        EB_MEMCPY((dstPtr + bufferOffset + stride * inputRowIndex),
+            (srcPtr + bufferOffset + stride * inputRowIndex),
+            width);
+    }
+}
 
-            return residualDistortion;
+/******************************************************
+ * Lf Search Row
+ *
+ * Filters one SB row of a trial of the level search,
+ *   then takes the SSE of the rows that are final and
+ *   restores them from the unfiltered copy. The rows of
+ *   a full image trial follow the wavefront of
+ *   av1_loop_filter_frame, so the SB row above is final
+ *   once a row is filtered and the search returns the
+ *   same levels as the frame loop. The rows of a sampled
+ *   trial are filtered on their own, which only touches
+ *   the row itself and the bottom of the row above.
+ ******************************************************/
+static void LfSearchRow(
+    PictureControlSet_t    *pcsPtr,
+    uint32_t                trialRowIndex)
+{
+    SequenceControlSet     *scsPtr = pcsPtr->parent_pcs_ptr->sequence_control_set_ptr;
+    SbRowSync_t            *rowSyncPtr = pcsPtr->dlf_search_row_sync;
+    EbPictureBufferDesc_t  *recon_buffer = pcsPtr->dlf_search_recon_ptr;
+    EbPictureBufferDesc_t  *tempLfReconBuffer = pcsPtr->dlf_search_backup_ptr;
+    int32_t                 plane = pcsPtr->dlf_search_plane;
+    uint32_t                rowStep = pcsPtr->dlf_search_row_step;
+    uint8_t                 sb_size_Log2 = (uint8_t)Log2f(scsPtr->sb_size_pix);
+    uint32_t                picture_width_in_sb = rowSyncPtr->colCount;
+    uint32_t                picture_height_in_sb = (scsPtr->luma_height + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
+    uint32_t                yLcuIndex = trialRowIndex * rowStep;
+    uint32_t                xLcuIndex;
+
+    for (xLcuIndex = 0; xLcuIndex < picture_width_in_sb; ++xLcuIndex) {
+
+        if (rowStep == 1 && trialRowIndex > 0) {
+            SbRowSyncWait(
+                rowSyncPtr,
+                trialRowIndex - 1,
+                MIN(xLcuIndex + 2, picture_width_in_sb));
         }
 
-        else if (plane == 1) {
+        loop_filter_sb(
+            recon_buffer,
+            pcsPtr,
+            NULL,
+            (yLcuIndex << sb_size_Log2) >> 2,
+            (xLcuIndex << sb_size_Log2) >> 2,
+            plane,
+            plane + 1,
+            (xLcuIndex == picture_width_in_sb - 1) ? EB_TRUE : EB_FALSE);
+
+        SbRowSyncAddProgress(rowSyncPtr, trialRowIndex, 1);
+    }
 
-            reconCoeffBuffer = (uint16_t*)&((recon_ptr->bufferCb)[(recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCb) << is16bit]);
-            inputBuffer = (uint16_t*)&((input_picture_ptr->bufferCb)[(input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb) << is16bit]);
+    if (rowStep == 1) {
+        if (yLcuIndex > 0) {
+            pcsPtr->dlf_search_row_sse[yLcuIndex - 1] = PictureSseRows(pcsPtr, recon_buffer, plane,
+                (yLcuIndex - 1) << sb_size_Log2, yLcuIndex << sb_size_Log2);
+            CopyBufferRows(tempLfReconBuffer, recon_buffer, pcsPtr, plane,
+                (yLcuIndex - 1) << sb_size_Log2, yLcuIndex << sb_size_Log2);
+        }
+        if (yLcuIndex == picture_height_in_sb - 1) {
+            pcsPtr->dlf_search_row_sse[yLcuIndex] = PictureSseRows(pcsPtr, recon_buffer, plane,
+                yLcuIndex << sb_size_Log2, (yLcuIndex + 1) << sb_size_Log2);
+            CopyBufferRows(tempLfReconBuffer, recon_buffer, pcsPtr, plane,
+                yLcuIndex << sb_size_Log2, (yLcuIndex + 1) << sb_size_Log2);
+        }
+    }
+    else {
+        pcsPtr->dlf_search_row_sse[trialRowIndex] = PictureSseRows(pcsPtr, recon_buffer, plane,
+            yLcuIndex << sb_size_Log2, (yLcuIndex + 1) << sb_size_Log2);
+        CopyBufferRows(tempLfReconBuffer, recon_buffer, pcsPtr, plane,
+            (yLcuIndex ? yLcuIndex - 1 : 0) << sb_size_Log2, (yLcuIndex + 1) << sb_size_Log2);
+    }
 
-            residualDistortion = 0;
-            row_index = 0;
-            while (row_index < sequence_control_set_ptr->chroma_height) {
+    SbRowSyncCompleteRow(rowSyncPtr);
 
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR(((int64_t)inputBuffer[columnIndex]) - (int64_t)(reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
+    return;
+}
 
-                inputBuffer += input_picture_ptr->strideCb;
-                reconCoeffBuffer += recon_ptr->strideCb;
-                ++row_index;
-            }
+/******************************************************
+ * av1_pick_filter_level_join
+ *
+ * Called by the DLF threads joining the level search
+ *   of a picture: runs SB rows of its trials until the
+ *   search is over.
+ ******************************************************/
+void av1_pick_filter_level_join(
+    PictureControlSet_t     *pcsPtr)
+{
+    uint32_t spinCount = 0;
+    uint32_t trialRowIndex;
 
-            return residualDistortion;
+    while (eb_atomic_load_32(&pcsPtr->dlf_search_active)) {
+        if (SbRowSyncClaimRow(pcsPtr->dlf_search_row_sync, &trialRowIndex) == EB_TRUE) {
+            LfSearchRow(pcsPtr, trialRowIndex);
+            spinCount = 0;
         }
-        else if (plane == 2) {
-            reconCoeffBuffer = (uint16_t*)&((recon_ptr->bufferCr)[(recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCr) << is16bit]);
-            inputBuffer = (uint16_t*)&((input_picture_ptr->bufferCr)[(input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr) << is16bit]);
-            residualDistortion = 0;
-            row_index = 0;
-
-            while (row_index < sequence_control_set_ptr->chroma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR(((int64_t)inputBuffer[columnIndex]) - (int64_t)(reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->strideCr;
-                reconCoeffBuffer += recon_ptr->strideCr;
-                ++row_index;
-            }
-
-            return residualDistortion;
+        else {
+            SbRowSyncPause(&spinCount);
         }
-
-        return 0;
     }
+
+    return;
 }
 
 static int64_t try_filter_frame(
@@ -1638,30 +1720,21 @@ static int64_t try_filter_frame(
     int32_t filt_level,
     int32_t partial_frame, int32_t plane, int32_t dir) {
     (void)sd;
-    (void)partial_frame;
     (void)sd;
-    int64_t filt_err;
+    int64_t filt_err = 0;
 
     assert(plane >= 0 && plane <= 2);
     int32_t filter_level[2] = { filt_level, filt_level };
     if (plane == 0 && dir == 0) filter_level[1] = pcsPtr->parent_pcs_ptr->lf.filter_level[1];
     if (plane == 0 && dir == 1) filter_level[0] = pcsPtr->parent_pcs_ptr->lf.filter_level[0];
 
-    EbBool is16bit = (EbBool)(pcsPtr->parent_pcs_ptr->sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
-    EbPictureBufferDesc_t  *recon_buffer = is16bit ? pcsPtr->recon_picture16bit_ptr : pcsPtr->recon_picture_ptr;
-    if (pcsPtr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
-
-        //get the 16bit form of the input LCU
-        if (is16bit) {
-            recon_buffer = ((EbReferenceObject*)pcsPtr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
-        }
-        else {
-            recon_buffer = ((EbReferenceObject*)pcsPtr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture;
-        }
-    }
-    else { // non ref pictures
-        recon_buffer = is16bit ? pcsPtr->recon_picture16bit_ptr : pcsPtr->recon_picture_ptr;
-    }
+    SequenceControlSet *scsPtr = pcsPtr->parent_pcs_ptr->sequence_control_set_ptr;
+    SbRowSync_t *rowSyncPtr = pcsPtr->dlf_search_row_sync;
+    uint32_t picture_width_in_sb = (scsPtr->luma_width + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
+    uint32_t picture_height_in_sb = (scsPtr->luma_height + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
+    uint32_t rowStep = partial_frame ? DLF_SEARCH_SAMPLE_ROW_STEP : 1;
+    uint32_t trialRowCount = (picture_height_in_sb + rowStep - 1) / rowStep;
+    uint32_t trialRowIndex;
 
     // set base filters for use of get_filter_level when in DELTA_Q_LF mode
     switch (plane) {
@@ -1673,14 +1746,28 @@ static int64_t try_filter_frame(
     case 2: pcsPtr->parent_pcs_ptr->lf.filter_level_v = filter_level[0]; break;
     }
 
-    av1_loop_filter_frame(recon_buffer, pcsPtr, plane, plane + 1);
+    av1_loop_filter_frame_init(pcsPtr, plane, plane + 1);
 
-    filt_err = PictureSseCalculations(pcsPtr, recon_buffer, plane);
+    pcsPtr->dlf_search_backup_ptr = tempLfReconBuffer;
+    pcsPtr->dlf_search_plane = plane;
+    pcsPtr->dlf_search_row_step = rowStep;
 
+    // Publish the rows of the trial to the threads of the search
+    eb_block_on_mutex(rowSyncPtr->mutex);
+    SbRowSyncInit(rowSyncPtr, trialRowCount, picture_width_in_sb);
+    rowSyncPtr->readyRowCount = trialRowCount;
+    eb_release_mutex(rowSyncPtr->mutex);
 
+    while (SbRowSyncClaimRow(rowSyncPtr, &trialRowIndex) == EB_TRUE) {
+        LfSearchRow(pcsPtr, trialRowIndex);
+    }
 
-    // Re-instate the unfiltered frame
-    EbCopyBuffer(tempLfReconBuffer/*cpi->last_frame_uf*/, recon_buffer /*cm->frame_to_show*/, pcsPtr, (uint8_t)plane);
+    // The rows are restored from tempLfReconBuffer once measured
+    SbRowSyncWaitDone(rowSyncPtr);
+
+    for (trialRowIndex = 0; trialRowIndex < trialRowCount; ++trialRowIndex) {
+        filt_err += pcsPtr->dlf_search_row_sse[trialRowIndex];
+    }
 
     return filt_err;
 }
@@ -1734,6 +1821,7 @@ static int32_t search_filter_level(
     memset(ss_err, 0xFF, sizeof(ss_err));
     // make a copy of recon_buffer
     EbCopyBuffer(recon_buffer/*cm->frame_to_show*/, tempLfReconBuffer/*&cpi->last_frame_uf*/, pcsPtr, (uint8_t)plane);
+    pcsPtr->dlf_search_recon_ptr = recon_buffer;
 
     best_err = try_filter_frame(sd, tempLfReconBuffer, pcsPtr, filt_mid, partial_frame, plane, dir);
     filt_best = filt_mid;
@@ -48,6 +48,8 @@ extern "C" {
 #define MAX_QP_VALUE_PLUS_INTRA_TC_OFFSET   53
 #define BETA_OFFSET_VALUE                   12 // range -12 to 12
 #define TC_OFFSET_VALUE                     12//12 // range -12 to 12
+    // One SB row out of DLF_SEARCH_SAMPLE_ROW_STEP is tried by LPF_PICK_FROM_SUBIMAGE
+#define DLF_SEARCH_SAMPLE_ROW_STEP          2
 
 #if AV1_LF
     typedef enum {
@@ -110,6 +112,9 @@ extern "C" {
         PictureControlSet_t     *pcsPtr,
         LPF_PICK_METHOD          method);
 
+    void av1_pick_filter_level_join(
+        PictureControlSet_t     *pcsPtr);
+
 
     void av1_filter_block_plane_vert(
         const PictureControlSet_t *const  pcsPtr,
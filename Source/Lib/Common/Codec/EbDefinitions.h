@@ -134,6 +134,12 @@ extern "C" {
 #define RC_FEEDBACK                                     1 // Feedback from previous base layer is received before starting the next base layer frame
 #endif
 
+// Inter-process FIFOs: lock-free EbRingQueue (spin then park) instead of semaphore + mutex EbFifo/EbMuxingQueue.
+// Set from CMake with -DSVT_AV1_LOCK_FREE_FIFO=ON
+#ifndef LOCK_FREE_FIFO
+#define LOCK_FREE_FIFO                                  0
+#endif
+
 struct buf_2d {
     uint8_t *buf;
     uint8_t *buf0;
@@ -2187,7 +2193,6 @@ typedef struct EbMemoryMapEntry
 #define OIS_COMPLEX_MODE         3
 #define OIS_VERY_COMPLEX_MODE    4
 
-#define MAX_NUM_PTR                                 (0x1312D00 << 2) //0x4C4B4000            // Maximum number of pointers to be allocated for the library
 // Display Total Memory at the end of the memory allocations
 #define DISPLAY_MEMORY                                  0
 
@@ -2195,9 +2200,12 @@ extern    EbMemoryMapEntry        *app_memory_map;            // App Memory tabl
 extern    uint32_t                  *app_memory_map_index;       // App Memory index
 extern    uint64_t                  *total_app_memory;          // App Memory malloc'd
 
-extern    EbMemoryMapEntry        *memory_map;               // library Memory table
-extern    uint32_t                  *memory_map_index;          // library memory index
-extern    uint64_t                  *total_lib_memory;          // library Memory malloc'd
+// The library allocates from the memory arena of the encoder instance the
+// calling thread works for, see EbMemoryArena.h. type_name is the type
+// the allocation is accounted to.
+extern    EbPtr                      eb_memory_arena_malloc(size_t size, EbPtrType ptr_type, const char *type_name);
+extern    EbErrorType                eb_memory_arena_add_handle(EbHandle handle, EbPtrType ptr_type, const char *type_name, size_t size);
+extern    uint64_t                   eb_memory_arena_committed_size(void);
 
 extern    uint32_t                   libMallocCount;
 extern    uint32_t                   lib_thread_count;
@@ -2253,88 +2261,26 @@ app_malloc_count++;
 
 #define ALVALUE 32
 
-#ifdef _MSC_VER
 #define EB_ALLIGN_MALLOC(type, pointer, n_elements, pointer_class) \
-pointer = (type) _aligned_malloc(n_elements,ALVALUE); \
+pointer = (type) eb_memory_arena_malloc(n_elements, EB_A_PTR, #type); \
 if (pointer == (type)EB_NULL) { \
     return EB_ErrorInsufficientResources; \
-    } \
-    else { \
-    memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-    memory_map[(*(memory_map_index))++].ptr = pointer; \
-    if (n_elements % 8 == 0) { \
-        *total_lib_memory += (n_elements); \
-    } \
-    else { \
-        *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
-    } \
-} \
-if (*(memory_map_index) >= MAX_NUM_PTR) { \
-    return EB_ErrorInsufficientResources; \
 } \
 libMallocCount++;
 
-#else
-#define EB_ALLIGN_MALLOC(type, pointer, n_elements, pointer_class) \
-if (posix_memalign((void**)(&(pointer)), ALVALUE, n_elements) != 0) { \
-    return EB_ErrorInsufficientResources; \
-        } \
-            else { \
-    pointer = (type) pointer;  \
-    memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-    memory_map[(*(memory_map_index))++].ptr = pointer; \
-    if (n_elements % 8 == 0) { \
-        *total_lib_memory += (n_elements); \
-            } \
-            else { \
-        *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
-    } \
-} \
-if (*(memory_map_index) >= MAX_NUM_PTR) { \
-    return EB_ErrorInsufficientResources; \
-    } \
-libMallocCount++;
-#endif
-
-
 #define EB_MALLOC(type, pointer, n_elements, pointer_class) \
-pointer = (type) malloc(n_elements); \
+pointer = (type) eb_memory_arena_malloc(n_elements, pointer_class, #type); \
 if (pointer == (type)EB_NULL) { \
     return EB_ErrorInsufficientResources; \
-    } \
-    else { \
-    memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-    memory_map[(*(memory_map_index))++].ptr = pointer; \
-    if (n_elements % 8 == 0) { \
-        *total_lib_memory += (n_elements); \
-    } \
-    else { \
-        *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
-    } \
-} \
-if (*(memory_map_index) >= MAX_NUM_PTR) { \
-    return EB_ErrorInsufficientResources; \
 } \
 libMallocCount++;
 
+// Arena memory is zeroed
 #define EB_CALLOC(type, pointer, count, size, pointer_class) \
-pointer = (type) calloc(count, size); \
+pointer = (type) eb_memory_arena_malloc((size_t)(count) * (size), pointer_class, #type); \
 if (pointer == (type)EB_NULL) { \
     return EB_ErrorInsufficientResources; \
 } \
-else { \
-    memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-    memory_map[(*(memory_map_index))++].ptr = pointer; \
-    if (count % 8 == 0) { \
-        *total_lib_memory += (count); \
-    } \
-    else { \
-        *total_lib_memory += ((count) + (8 - ((count) % 8))); \
-    } \
-} \
-if (*(memory_map_index) >= MAX_NUM_PTR) { \
-    return EB_ErrorInsufficientResources; \
-} \
 libMallocCount++;
 
 #define EB_CREATESEMAPHORE(type, pointer, n_elements, pointer_class, initial_count, max_count) \
@@ -2342,17 +2288,8 @@ pointer = eb_create_semaphore(initial_count, max_count); \
 if (pointer == (type)EB_NULL) { \
     return EB_ErrorInsufficientResources; \
 } \
-else { \
-    memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-    memory_map[(*(memory_map_index))++].ptr = pointer; \
-    if (n_elements % 8 == 0) { \
-        *total_lib_memory += (n_elements); \
-    } \
-    else { \
-        *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
-    } \
-} \
-if (*(memory_map_index) >= MAX_NUM_PTR) { \
+if (eb_memory_arena_add_handle(pointer, pointer_class, "EbSemaphore", n_elements) != EB_ErrorNone) { \
+    eb_destroy_semaphore(pointer); \
     return EB_ErrorInsufficientResources; \
 } \
 libSemaphoreCount++;
@@ -2362,17 +2299,8 @@ pointer = eb_create_mutex(); \
 if (pointer == (type)EB_NULL){ \
     return EB_ErrorInsufficientResources; \
 } \
-else { \
-    memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-    memory_map[(*(memory_map_index))++].ptr = pointer; \
-    if (n_elements % 8 == 0) { \
-        *total_lib_memory += (n_elements); \
-    } \
-    else { \
-        *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
-    } \
-} \
-if (*(memory_map_index) >= MAX_NUM_PTR) { \
+if (eb_memory_arena_add_handle(pointer, pointer_class, "EbMutex", n_elements) != EB_ErrorNone) { \
+    eb_destroy_mutex(pointer); \
     return EB_ErrorInsufficientResources; \
 } \
 libMutexCount++;
@@ -2382,7 +2310,7 @@ printf("Total Number of Mallocs in Library: %d\n", libMallocCount); \
 printf("Total Number of Threads in Library: %d\n", lib_thread_count); \
 printf("Total Number of Semaphore in Library: %d\n", libSemaphoreCount); \
 printf("Total Number of Mutex in Library: %d\n", libMutexCount); \
-printf("Total Library Memory: %.2lf KB\n\n",*total_lib_memory/(double)1024);
+printf("Total Library Memory: %.2lf KB\n\n",eb_memory_arena_committed_size()/(double)1024);
 
 
 #define EB_APP_MEMORY() \
@@ -2584,8 +2512,10 @@ void(*ErrorHandler)(
 #define TOTAL_LEVEL_COUNT                           13
 
 //***Encoding Parameters***
-#define MAX_PICTURE_WIDTH_SIZE                      4672u
+#define MAX_PICTURE_WIDTH_SIZE                      4672u   // sizes the ME search area buffers (larger than any search window), per picture arrays are sized from the actual picture
 #define MAX_PICTURE_HEIGHT_SIZE                     2560u
+#define MAX_SOURCE_WIDTH                            8192u
+#define MAX_SOURCE_HEIGHT                           4352u
 #define INTERNAL_BIT_DEPTH                          8 // to be modified
 #define MAX_SAMPLE_VALUE                            ((1 << INTERNAL_BIT_DEPTH) - 1)
 #define MAX_SAMPLE_VALUE_10BIT                      0x3FF
@@ -2610,10 +2540,6 @@ void(*ErrorHandler)(
 #define MIN_CU_BLK_COUNT                            ((BLOCK_SIZE_64 / MIN_BLOCK_SIZE) * (BLOCK_SIZE_64 / MIN_BLOCK_SIZE))
 #define MAX_NUM_OF_TU_PER_CU                        21
 #define MIN_NUM_OF_TU_PER_CU                        5
-#define MAX_LCU_ROWS                                ((MAX_PICTURE_HEIGHT_SIZE) / (BLOCK_SIZE_64))
-
-#define MAX_NUMBER_OF_TREEBLOCKS_PER_PICTURE       ((MAX_PICTURE_WIDTH_SIZE + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64) * \
-                                                ((MAX_PICTURE_HEIGHT_SIZE + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64)
 
 //***Prediction Structure***
 #define MAX_TEMPORAL_LAYERS                         6
@@ -2931,6 +2857,10 @@ static const uint8_t INTRA_AREA_TH_CLASS_1[MAX_HIERARCHICAL_LEVEL][MAX_TEMPORAL_
 #define BLOCK_MEAN_PREC_FULL 0
 #define BLOCK_MEAN_PREC_SUB  1
 
+#define EbScDetectionMode uint8_t
+#define SC_DETECTION_FULL     0     // Screen content detection on all the SBs
+#define SC_DETECTION_SAMPLED  1     // Screen content detection on every other SB (checkerboard)
+
 #define EbPmMode uint8_t
 #define PM_MODE_0  0     // 1-stage PM
 #define PM_MODE_1  1     // 2-stage PM 4K
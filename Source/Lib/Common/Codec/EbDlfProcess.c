@@ -33,6 +33,7 @@ EbErrorType dlf_context_ctor(
     DlfContext_t **context_dbl_ptr,
     EbFifo                *dlf_input_fifo_ptr,
     EbFifo                *dlf_output_fifo_ptr ,
+    EbFifo                *dlf_feedback_fifo_ptr,
     EbBool                  is16bit,
     EbColorFormat           color_format,
     uint32_t                max_input_luma_width,
@@ -47,6 +48,7 @@ EbErrorType dlf_context_ctor(
     // Input/Output System Resource Manager FIFOs
     context_ptr->dlf_input_fifo_ptr = dlf_input_fifo_ptr;
     context_ptr->dlf_output_fifo_ptr = dlf_output_fifo_ptr;
+    context_ptr->dlf_feedback_fifo_ptr = dlf_feedback_fifo_ptr;
 
 
 
@@ -83,185 +85,355 @@ EbErrorType dlf_context_ctor(
 }
 
 /******************************************************
- * Dlf Kernel
+ * Dlf Recon Buffer
  ******************************************************/
-void* dlf_kernel(void *input_ptr)
+static EbPictureBufferDesc_t *DlfReconBuffer(
+    PictureControlSet_t     *picture_control_set_ptr,
+    EbBool                   is16bit)
 {
-    // Context & SCS & PCS
-    DlfContext_t                            *context_ptr = (DlfContext_t*)input_ptr;
-    PictureControlSet_t                     *picture_control_set_ptr;
-    SequenceControlSet                    *sequence_control_set_ptr;
+    if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
 
-    //// Input
-    EbObjectWrapper                       *enc_dec_results_wrapper_ptr;
-    EncDecResults_t                         *enc_dec_results_ptr;
+        //get the 16bit form of the input LCU
+        if (is16bit) {
+            return ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
+        }
+        else {
+            return ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture;
+        }
+    }
+    else { // non ref pictures
+        return is16bit ? picture_control_set_ptr->recon_picture16bit_ptr : picture_control_set_ptr->recon_picture_ptr;
+    }
+}
 
-    //// Output
-    EbObjectWrapper                       *dlf_results_wrapper_ptr;
-    struct DlfResults_s*                     dlf_results_ptr;
+/******************************************************
+ * Dlf Filter Row
+ *
+ * Deblocks one SB row in the raster order of
+ *   av1_loop_filter_frame. An SB filters edges that
+ *   reach into the SB above and the SB on its left, and
+ *   the SB above-right filters edges that reach into the
+ *   SB above, so SB x of a row waits for SBs 0 to x+1 of
+ *   the row above. This gives the output of the frame
+ *   loop whatever the number of threads.
+ ******************************************************/
+static void DlfFilterRow(
+    PictureControlSet_t     *picture_control_set_ptr,
+    SequenceControlSet      *sequence_control_set_ptr,
+    EbPictureBufferDesc_t   *recon_buffer,
+    uint32_t                 yLcuIndex)
+{
+    SbRowSync_t *rowSyncPtr = picture_control_set_ptr->dlf_row_sync;
+    uint8_t      sb_size_Log2 = (uint8_t)Log2f(sequence_control_set_ptr->sb_size_pix);
+    uint32_t     picture_width_in_sb = rowSyncPtr->colCount;
+    uint32_t     xLcuIndex;
+
+    for (xLcuIndex = 0; xLcuIndex < picture_width_in_sb; ++xLcuIndex) {
+
+        if (yLcuIndex > 0) {
+            SbRowSyncWait(
+                rowSyncPtr,
+                yLcuIndex - 1,
+                MIN(xLcuIndex + 2, picture_width_in_sb));
+        }
 
-    // SB Loop variables
-    for (;;) {
+        loop_filter_sb(
+            recon_buffer,
+            picture_control_set_ptr,
+            NULL,
+            (yLcuIndex << sb_size_Log2) >> 2,
+            (xLcuIndex << sb_size_Log2) >> 2,
+            0,
+            3,
+            (xLcuIndex == picture_width_in_sb - 1) ? EB_TRUE : EB_FALSE);
+
+        SbRowSyncAddProgress(rowSyncPtr, yLcuIndex, 1);
+    }
 
-        // Get EncDec Results
-        eb_get_full_object(
-            context_ptr->dlf_input_fifo_ptr,
-            &enc_dec_results_wrapper_ptr);
+    return;
+}
 
-        enc_dec_results_ptr         = (EncDecResults_t*)enc_dec_results_wrapper_ptr->object_ptr;
-        picture_control_set_ptr     = (PictureControlSet_t*)enc_dec_results_ptr->picture_control_set_wrapper_ptr->object_ptr;
-        sequence_control_set_ptr    = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+/******************************************************
+ * Dlf Pick Filter Level
+ *
+ * The search filters the whole picture, so it can only
+ *   run once EncDec has coded every SB row. With
+ *   loop_filter_mode 2 the levels are tried on a sample
+ *   of the SB rows, starting from the levels derived
+ *   from the QP.
+ ******************************************************/
+static void DlfPickFilterLevel(
+    DlfContext_t            *context_ptr,
+    PictureControlSet_t     *picture_control_set_ptr)
+{
+    av1_loop_filter_init(picture_control_set_ptr);
 
-        EbBool is16bit       = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
-        EbBool dlfEnableFlag = (EbBool)(picture_control_set_ptr->parent_pcs_ptr->loop_filter_mode &&
-            (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag ||
-                sequence_control_set_ptr->static_config.recon_enabled ||
-                sequence_control_set_ptr->static_config.stat_report));
+    if (picture_control_set_ptr->parent_pcs_ptr->loop_filter_mode == 2) {
 
-        if (dlfEnableFlag && picture_control_set_ptr->parent_pcs_ptr->loop_filter_mode >= 2) {
+        av1_pick_filter_level(
+            context_ptr,
+            (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+            picture_control_set_ptr,
+            LPF_PICK_FROM_Q);
+    }
 
-            EbPictureBufferDesc_t  *recon_buffer = is16bit ? picture_control_set_ptr->recon_picture16bit_ptr : picture_control_set_ptr->recon_picture_ptr;
-            if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+    av1_pick_filter_level(
+        context_ptr,
+        (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+        picture_control_set_ptr,
+        picture_control_set_ptr->parent_pcs_ptr->loop_filter_mode == 2 ? LPF_PICK_FROM_SUBIMAGE : LPF_PICK_FROM_FULL_IMAGE);
 
-                //get the 16bit form of the input LCU
-                if (is16bit) {
-                    recon_buffer = ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
-                }
-                else {
-                    recon_buffer = ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture;
-                }
-            }
-            else { // non ref pictures
-                recon_buffer = is16bit ? picture_control_set_ptr->recon_picture16bit_ptr : picture_control_set_ptr->recon_picture_ptr;
-            }
+#if NO_ENCDEC
+    //NO DLF
+    picture_control_set_ptr->parent_pcs_ptr->lf.filter_level[0] = 0;
+    picture_control_set_ptr->parent_pcs_ptr->lf.filter_level[1] = 0;
+    picture_control_set_ptr->parent_pcs_ptr->lf.filter_level_u = 0;
+    picture_control_set_ptr->parent_pcs_ptr->lf.filter_level_v = 0;
+#endif
 
-            av1_loop_filter_init(picture_control_set_ptr);
+    av1_loop_filter_frame_init(picture_control_set_ptr, 0, 3);
 
-            if (picture_control_set_ptr->parent_pcs_ptr->loop_filter_mode == 2) {
+    return;
+}
 
-                av1_pick_filter_level(
-                    context_ptr,
-                    (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr,
-                    picture_control_set_ptr,
-                    LPF_PICK_FROM_Q);
-            }
+/******************************************************
+ * Dlf Picture Done
+ *
+ * Prepares CDEF and posts the CDEF segments once
+ *   every SB row of the picture is deblocked.
+ ******************************************************/
+static void DlfPictureDone(
+    DlfContext_t            *context_ptr,
+    PictureControlSet_t     *picture_control_set_ptr,
+    SequenceControlSet      *sequence_control_set_ptr,
+    EbObjectWrapper         *picture_control_set_wrapper_ptr)
+{
+    EbBool                   is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
 
-            av1_pick_filter_level(
-                context_ptr,
-                (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr,
-                picture_control_set_ptr,
-                LPF_PICK_FROM_FULL_IMAGE);
+    //// Output
+    EbObjectWrapper                       *dlf_results_wrapper_ptr;
+    struct DlfResults_s*                     dlf_results_ptr;
 
-#if NO_ENCDEC
-            //NO DLF
-            picture_control_set_ptr->parent_pcs_ptr->lf.filter_level[0] = 0;
-            picture_control_set_ptr->parent_pcs_ptr->lf.filter_level[1] = 0;
-            picture_control_set_ptr->parent_pcs_ptr->lf.filter_level_u = 0;
-            picture_control_set_ptr->parent_pcs_ptr->lf.filter_level_v = 0;
-#endif
-                av1_loop_filter_frame(
-                    recon_buffer,
-                    picture_control_set_ptr,
-                    0,
-                    3);
-            }
+    //pre-cdef prep
+    {
+        Av1Common* cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
+        EbPictureBufferDesc_t  * recon_picture_ptr = DlfReconBuffer(picture_control_set_ptr, is16bit);
 
-        //pre-cdef prep
-        {
-            Av1Common* cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
-            EbPictureBufferDesc_t  * recon_picture_ptr;
-            if (is16bit) {
-                if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                    recon_picture_ptr = ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
-                else
-                    recon_picture_ptr = picture_control_set_ptr->recon_picture16bit_ptr;
-            }
-            else {
-                if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                    recon_picture_ptr = ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture;
-                else
-                    recon_picture_ptr = picture_control_set_ptr->recon_picture_ptr;
-            }
+        LinkEbToAomBufferDesc(
+            recon_picture_ptr,
+            cm->frame_to_show);
 
-            LinkEbToAomBufferDesc(
-                recon_picture_ptr,
-                cm->frame_to_show);
+        if (sequence_control_set_ptr->enable_restoration) {
+            av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 0);
+        }
 
-            if (sequence_control_set_ptr->enable_restoration) {
-                av1_loop_restoration_save_boundary_lines(cm->frame_to_show, cm, 0);
-            }
+        if (sequence_control_set_ptr->enable_cdef && picture_control_set_ptr->parent_pcs_ptr->cdef_filter_mode)
+        {
 
-            if (sequence_control_set_ptr->enable_cdef && picture_control_set_ptr->parent_pcs_ptr->cdef_filter_mode)
+            if (is16bit)
             {
+                picture_control_set_ptr->src[0] = (uint16_t*)recon_picture_ptr->buffer_y + (recon_picture_ptr->origin_x + recon_picture_ptr->origin_y     * recon_picture_ptr->stride_y);
+                picture_control_set_ptr->src[1] = (uint16_t*)recon_picture_ptr->bufferCb + (recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCb);
+                picture_control_set_ptr->src[2] = (uint16_t*)recon_picture_ptr->bufferCr + (recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCr);
 
-                if (is16bit)
-                {
-                    picture_control_set_ptr->src[0] = (uint16_t*)recon_picture_ptr->buffer_y + (recon_picture_ptr->origin_x + recon_picture_ptr->origin_y     * recon_picture_ptr->stride_y);
-                    picture_control_set_ptr->src[1] = (uint16_t*)recon_picture_ptr->bufferCb + (recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCb);
-                    picture_control_set_ptr->src[2] = (uint16_t*)recon_picture_ptr->bufferCr + (recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCr);
+                EbPictureBufferDesc_t *input_picture_ptr = picture_control_set_ptr->input_frame16bit;
+                picture_control_set_ptr->ref_coeff[0] = (uint16_t*)input_picture_ptr->buffer_y + (input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y);
+                picture_control_set_ptr->ref_coeff[1] = (uint16_t*)input_picture_ptr->bufferCb + (input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb);
+                picture_control_set_ptr->ref_coeff[2] = (uint16_t*)input_picture_ptr->bufferCr + (input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr);
 
-                    EbPictureBufferDesc_t *input_picture_ptr = picture_control_set_ptr->input_frame16bit;
-                    picture_control_set_ptr->ref_coeff[0] = (uint16_t*)input_picture_ptr->buffer_y + (input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y);
-                    picture_control_set_ptr->ref_coeff[1] = (uint16_t*)input_picture_ptr->bufferCb + (input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb);
-                    picture_control_set_ptr->ref_coeff[2] = (uint16_t*)input_picture_ptr->bufferCr + (input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr);
-
-                }
-                else
-                {
-                    //these copies should go!
-                    EbByte  rec_ptr = &((recon_picture_ptr->buffer_y)[recon_picture_ptr->origin_x + recon_picture_ptr->origin_y * recon_picture_ptr->stride_y]);
-                    EbByte  rec_ptr_cb = &((recon_picture_ptr->bufferCb)[recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCb]);
-                    EbByte  rec_ptr_cr = &((recon_picture_ptr->bufferCr)[recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCr]);
-
-                    EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-                    EbByte  enh_ptr = &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-                    EbByte  enh_ptr_cb = &((input_picture_ptr->bufferCb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb]);
-                    EbByte  enh_ptr_cr = &((input_picture_ptr->bufferCr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr]);
-
-                    for (int r = 0; r < sequence_control_set_ptr->luma_height; ++r) {
-                        for (int c = 0; c < sequence_control_set_ptr->luma_width; ++c) {
-                        picture_control_set_ptr->src[0]      [r * sequence_control_set_ptr->luma_width + c] = rec_ptr[r * recon_picture_ptr->stride_y + c];
-                        picture_control_set_ptr->ref_coeff[0][r * sequence_control_set_ptr->luma_width + c] = enh_ptr[r * input_picture_ptr->stride_y + c];
-                        }
+            }
+            else
+            {
+                //these copies should go!
+                EbByte  rec_ptr = &((recon_picture_ptr->buffer_y)[recon_picture_ptr->origin_x + recon_picture_ptr->origin_y * recon_picture_ptr->stride_y]);
+                EbByte  rec_ptr_cb = &((recon_picture_ptr->bufferCb)[recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCb]);
+                EbByte  rec_ptr_cr = &((recon_picture_ptr->bufferCr)[recon_picture_ptr->origin_x / 2 + recon_picture_ptr->origin_y / 2 * recon_picture_ptr->strideCr]);
+
+                EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+                EbByte  enh_ptr = &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
+                EbByte  enh_ptr_cb = &((input_picture_ptr->bufferCb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb]);
+                EbByte  enh_ptr_cr = &((input_picture_ptr->bufferCr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr]);
+
+                for (int r = 0; r < sequence_control_set_ptr->luma_height; ++r) {
+                    for (int c = 0; c < sequence_control_set_ptr->luma_width; ++c) {
+                    picture_control_set_ptr->src[0]      [r * sequence_control_set_ptr->luma_width + c] = rec_ptr[r * recon_picture_ptr->stride_y + c];
+                    picture_control_set_ptr->ref_coeff[0][r * sequence_control_set_ptr->luma_width + c] = enh_ptr[r * input_picture_ptr->stride_y + c];
                     }
+                }
 
-                for (int r = 0; r < sequence_control_set_ptr->luma_height/2; ++r) {
-                    for (int c = 0; c < sequence_control_set_ptr->luma_width/2; ++c) {
-                        picture_control_set_ptr->src[1][r * sequence_control_set_ptr->luma_width/2 + c] = rec_ptr_cb[r * recon_picture_ptr->strideCb + c];
-                        picture_control_set_ptr->ref_coeff[1][r * sequence_control_set_ptr->luma_width/2 + c] = enh_ptr_cb[r * input_picture_ptr->strideCb + c];
-                            picture_control_set_ptr->src[2][r * sequence_control_set_ptr->luma_width / 2 + c] = rec_ptr_cr[r * recon_picture_ptr->strideCr + c];
-                            picture_control_set_ptr->ref_coeff[2][r * sequence_control_set_ptr->luma_width / 2 + c] = enh_ptr_cr[r * input_picture_ptr->strideCr + c];
-                        }
+            for (int r = 0; r < sequence_control_set_ptr->luma_height/2; ++r) {
+                for (int c = 0; c < sequence_control_set_ptr->luma_width/2; ++c) {
+                    picture_control_set_ptr->src[1][r * sequence_control_set_ptr->luma_width/2 + c] = rec_ptr_cb[r * recon_picture_ptr->strideCb + c];
+                    picture_control_set_ptr->ref_coeff[1][r * sequence_control_set_ptr->luma_width/2 + c] = enh_ptr_cb[r * input_picture_ptr->strideCb + c];
+                        picture_control_set_ptr->src[2][r * sequence_control_set_ptr->luma_width / 2 + c] = rec_ptr_cr[r * recon_picture_ptr->strideCr + c];
+                        picture_control_set_ptr->ref_coeff[2][r * sequence_control_set_ptr->luma_width / 2 + c] = enh_ptr_cr[r * input_picture_ptr->strideCr + c];
                     }
                 }
             }
-
         }
 
-        picture_control_set_ptr->cdef_segments_column_count =  sequence_control_set_ptr->cdef_segment_column_count;
-        picture_control_set_ptr->cdef_segments_row_count    = sequence_control_set_ptr->cdef_segment_row_count;
-        picture_control_set_ptr->cdef_segments_total_count  = (uint16_t)(picture_control_set_ptr->cdef_segments_column_count  * picture_control_set_ptr->cdef_segments_row_count);
-        picture_control_set_ptr->tot_seg_searched_cdef      = 0;
-        uint32_t segment_index;
+    }
 
-        for (segment_index = 0; segment_index < picture_control_set_ptr->cdef_segments_total_count; ++segment_index)
-        {
-            // Get Empty DLF Results to Cdef
-            eb_get_empty_object(
-                context_ptr->dlf_output_fifo_ptr,
-                &dlf_results_wrapper_ptr);
-            dlf_results_ptr = (struct DlfResults_s*)dlf_results_wrapper_ptr->object_ptr;
-            dlf_results_ptr->picture_control_set_wrapper_ptr = enc_dec_results_ptr->picture_control_set_wrapper_ptr;
-            dlf_results_ptr->segment_index = segment_index;
-            // Post DLF Results
-            eb_post_full_object(dlf_results_wrapper_ptr);
+    picture_control_set_ptr->cdef_segments_column_count =  sequence_control_set_ptr->cdef_segment_column_count;
+    picture_control_set_ptr->cdef_segments_row_count    = sequence_control_set_ptr->cdef_segment_row_count;
+    picture_control_set_ptr->cdef_segments_total_count  = (uint16_t)(picture_control_set_ptr->cdef_segments_column_count  * picture_control_set_ptr->cdef_segments_row_count);
+    picture_control_set_ptr->tot_seg_searched_cdef      = 0;
+    uint32_t segment_index;
+
+    for (segment_index = 0; segment_index < picture_control_set_ptr->cdef_segments_total_count; ++segment_index)
+    {
+        // Get Empty DLF Results to Cdef
+        eb_get_empty_object(
+            context_ptr->dlf_output_fifo_ptr,
+            &dlf_results_wrapper_ptr);
+        dlf_results_ptr = (struct DlfResults_s*)dlf_results_wrapper_ptr->object_ptr;
+        dlf_results_ptr->picture_control_set_wrapper_ptr = picture_control_set_wrapper_ptr;
+        dlf_results_ptr->segment_index = segment_index;
+        // Post DLF Results
+        eb_post_full_object(dlf_results_wrapper_ptr);
+    }
+
+    return;
+}
+
+/******************************************************
+ * Dlf Kernel
+ *
+ * EncDec posts one result per SB row, in the order the
+ *   rows of the picture become complete. The rows are
+ *   deblocked as soon as they are coded when the filter
+ *   levels are derived from the QP, or once the whole
+ *   picture is coded when the levels are searched. The
+ *   search is run by the thread receiving the last row,
+ *   joined by the other DLF threads through feedback
+ *   results, which split the SB rows of each trial. Each
+ *   kernel call claims the next rows that are ready, so
+ *   the rows of a picture are spread over the DLF
+ *   threads; the thread completing the last row hands
+ *   the picture to CDEF.
+ ******************************************************/
+void dlf_kernel(
+    void            *input_ptr,
+    EbObjectWrapper *enc_dec_results_wrapper_ptr)
+{
+    // Context & SCS & PCS
+    DlfContext_t                            *context_ptr = (DlfContext_t*)input_ptr;
+    PictureControlSet_t                     *picture_control_set_ptr;
+    SequenceControlSet                    *sequence_control_set_ptr;
+
+    //// Input
+    EncDecResults_t                         *enc_dec_results_ptr;
+
+    // SB Row variables
+    SbRowSync_t                             *rowSyncPtr;
+    uint32_t                                 codedRowCount;
+    uint32_t                                 yLcuIndex;
+    EbBool                                   searchFlag = EB_FALSE;
+    uint64_t                                 workStartTime;
+
+    enc_dec_results_ptr         = (EncDecResults_t*)enc_dec_results_wrapper_ptr->object_ptr;
+    picture_control_set_ptr     = (PictureControlSet_t*)enc_dec_results_ptr->picture_control_set_wrapper_ptr->object_ptr;
+    eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
+    sequence_control_set_ptr    = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    rowSyncPtr                  = picture_control_set_ptr->dlf_row_sync;
+    workStartTime               = eb_deadline_work_start(sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr);
+
+    EbBool is16bit       = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    EbBool dlfEnableFlag = (EbBool)(picture_control_set_ptr->parent_pcs_ptr->loop_filter_mode &&
+        (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag ||
+            sequence_control_set_ptr->static_config.recon_enabled ||
+            sequence_control_set_ptr->static_config.stat_report));
+    // With loop_filter_mode 1 EncDec derives the filter levels from the QP
+    // before coding the first SB
+    EbBool dlfSearchFlag = (EbBool)(dlfEnableFlag && picture_control_set_ptr->parent_pcs_ptr->loop_filter_mode >= 2);
+
+    // Feedback results (no rows) only join the rows of the picture
+    codedRowCount = enc_dec_results_ptr->completedLcuRowIndexStart + enc_dec_results_ptr->completedLcuRowCount;
+
+    eb_block_on_mutex(rowSyncPtr->mutex);
+    if (dlfSearchFlag == EB_FALSE) {
+        rowSyncPtr->readyRowCount = MAX(rowSyncPtr->readyRowCount, codedRowCount);
+    }
+    else if (enc_dec_results_ptr->completedLcuRowCount && codedRowCount == rowSyncPtr->rowCount) {
+        // The result of the last row is posted once every row is coded
+        searchFlag = EB_TRUE;
+    }
+    eb_release_mutex(rowSyncPtr->mutex);
+
+    if (searchFlag) {
+        uint32_t helperCount = MIN(rowSyncPtr->rowCount, sequence_control_set_ptr->dlf_process_init_count) - 1;
+        uint32_t helperIndex;
+
+        eb_atomic_store_32(&picture_control_set_ptr->dlf_search_active, 1);
+
+        // Let the other DLF threads join the search, then filter rows of the picture;
+        // the feedback is skipped rather than waited for when the EncDec results are
+        // all in use, as only the DLF threads release them.
+        for (helperIndex = 0; helperIndex < helperCount; ++helperIndex) {
+            EbObjectWrapper *feedback_wrapper_ptr;
+            EncDecResults_t *feedback_ptr;
+
+            eb_try_get_empty_object(
+                context_ptr->dlf_feedback_fifo_ptr,
+                &feedback_wrapper_ptr);
+            if (feedback_wrapper_ptr == (EbObjectWrapper*)EB_NULL)
+                break;
+
+            // The helper releases the picture once done with it
+            eb_object_inc_live_count(
+                enc_dec_results_ptr->picture_control_set_wrapper_ptr,
+                1);
+
+            feedback_ptr = (EncDecResults_t*)feedback_wrapper_ptr->object_ptr;
+            feedback_ptr->picture_control_set_wrapper_ptr = enc_dec_results_ptr->picture_control_set_wrapper_ptr;
+            feedback_ptr->completedLcuRowIndexStart = 0;
+            feedback_ptr->completedLcuRowCount = 0;
+            eb_post_full_object(feedback_wrapper_ptr);
         }
 
+        DlfPickFilterLevel(
+            context_ptr,
+            picture_control_set_ptr);
+
+        eb_block_on_mutex(rowSyncPtr->mutex);
+        rowSyncPtr->readyRowCount = rowSyncPtr->rowCount;
+        eb_release_mutex(rowSyncPtr->mutex);
 
-            // Release EncDec Results
-            eb_release_object(enc_dec_results_wrapper_ptr);
+        eb_atomic_store_32(&picture_control_set_ptr->dlf_search_active, 0);
+    }
+    else if (enc_dec_results_ptr->completedLcuRowCount == 0) {
+        av1_pick_filter_level_join(picture_control_set_ptr);
+    }
+
+    // SB Row loop
+    while (SbRowSyncClaimRow(rowSyncPtr, &yLcuIndex) == EB_TRUE) {
 
+        if (dlfEnableFlag) {
+            DlfFilterRow(
+                picture_control_set_ptr,
+                sequence_control_set_ptr,
+                DlfReconBuffer(picture_control_set_ptr, is16bit),
+                yLcuIndex);
         }
 
-    return EB_NULL;
+        if (SbRowSyncCompleteRow(rowSyncPtr) == EB_TRUE) {
+            DlfPictureDone(
+                context_ptr,
+                picture_control_set_ptr,
+                sequence_control_set_ptr,
+                enc_dec_results_ptr->picture_control_set_wrapper_ptr);
+        }
+    }
+
+    eb_deadline_work_end(
+        sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr,
+        &picture_control_set_ptr->parent_pcs_ptr->encode_time_us,
+        workStartTime);
+
+    // Release the picture held for the feedback
+    if (enc_dec_results_ptr->completedLcuRowCount == 0)
+        eb_release_object(enc_dec_results_ptr->picture_control_set_wrapper_ptr);
+
+    // Release EncDec Results
+    eb_release_object(enc_dec_results_wrapper_ptr);
 }
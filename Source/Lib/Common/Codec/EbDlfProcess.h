@@ -22,7 +22,9 @@ typedef struct DlfContext_s
 {
     EbFifo                       *dlf_input_fifo_ptr;
     EbFifo                       *dlf_output_fifo_ptr;
-
+    // Posts to the DLF input to let the other DLF threads join
+    // the SB rows of a picture once its filter levels are picked
+    EbFifo                       *dlf_feedback_fifo_ptr;
 
     EbPictureBufferDesc_t                 *temp_lf_recon_picture_ptr;
     EbPictureBufferDesc_t                 *temp_lf_recon_picture16bit_ptr;
@@ -37,12 +39,15 @@ extern EbErrorType dlf_context_ctor(
     DlfContext_t **context_dbl_ptr,
     EbFifo                       *dlf_input_fifo_ptr,
     EbFifo                       *dlf_output_fifo_ptr,
+    EbFifo                       *dlf_feedback_fifo_ptr,
     EbBool                  is16bit,
     EbColorFormat           color_format,
     uint32_t                max_input_luma_width,
     uint32_t                max_input_luma_height
    );
 
-extern void* dlf_kernel(void *input_ptr);
+extern void dlf_kernel(
+    void            *input_ptr,
+    EbObjectWrapper *enc_dec_results_wrapper_ptr);
 
 #endif // EbEntropyCodingProcess_h
@@ -47,10 +47,6 @@ void av1_cdef_frame16bit(
     PictureControlSet_t            *pCs
 );
 
-void av1_add_film_grain(EbPictureBufferDesc_t *src,
-    EbPictureBufferDesc_t *dst,
-    aom_film_grain_t *film_grain_ptr);
-
 void av1_loop_restoration_save_boundary_lines(const Yv12BufferConfig *frame, Av1Common *cm, int32_t after_cdef);
 void av1_pick_filter_restoration(const Yv12BufferConfig *src, Yv12BufferConfig * trial_frame_rst /*AV1_COMP *cpi*/, Macroblock *x, Av1Common *const cm);
 void av1_loop_restoration_filter_frame(Yv12BufferConfig *frame, Av1Common *cm, int32_t optimized_lr);
@@ -88,8 +84,6 @@ EbErrorType enc_dec_context_ctor(
     uint32_t                max_input_luma_width,
     uint32_t                max_input_luma_height){
 
-    (void)max_input_luma_width;
-    (void)max_input_luma_height;
     EbErrorType return_error = EB_ErrorNone;
     EncDecContext_t *context_ptr;
     EB_MALLOC(EncDecContext_t*, context_ptr, sizeof(EncDecContext_t), EB_N_PTR);
@@ -98,6 +92,11 @@ EbErrorType enc_dec_context_ctor(
     context_ptr->is16bit = is16bit;
     context_ptr->color_format = color_format;
 
+    // SB based intra coded area, sized from the actual picture
+    EB_MALLOC(uint32_t*, context_ptr->intra_coded_area_sb, sizeof(uint32_t) *
+        ((max_input_luma_width + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64) *
+        ((max_input_luma_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64), EB_N_PTR);
+
     // Input/Output System Resource Manager FIFOs
     context_ptr->mode_decision_input_fifo_ptr = mode_decision_configuration_input_fifo_ptr;
     context_ptr->enc_dec_output_fifo_ptr = packetization_output_fifo_ptr;
@@ -106,8 +105,8 @@ EbErrorType enc_dec_context_ctor(
 
     // Trasform Scratch Memory
     EB_MALLOC(int16_t*, context_ptr->transform_inner_array_ptr, 3152, EB_N_PTR); //refer to EbInvTransform_SSE2.as. case 32x32
-    // MD rate Estimation tables
-    EB_MALLOC(MdRateEstimationContext_t*, context_ptr->md_rate_estimation_ptr, sizeof(MdRateEstimationContext_t), EB_N_PTR);
+    // MD rate Estimation tables, set to the picture tables at each picture
+    context_ptr->md_rate_estimation_ptr = (MdRateEstimationContext_t*)EB_NULL;
 
 
     // Prediction Buffer
@@ -250,8 +249,6 @@ static void ResetEncDec(
     SequenceControlSet    *sequence_control_set_ptr,
     uint32_t                   segment_index)
 {
-    EB_SLICE                     slice_type;
-    MdRateEstimationContext_t   *md_rate_estimation_array;
     context_ptr->is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
 
 
@@ -278,22 +275,8 @@ static void ResetEncDec(
         (uint8_t)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr->bit_depth,
         context_ptr->qp_index);
 
-    // Slice Type
-    slice_type =
-        (picture_control_set_ptr->parent_pcs_ptr->idr_flag == EB_TRUE) ? I_SLICE :
-        picture_control_set_ptr->slice_type;
-
-    // Increment the MD Rate Estimation array pointer to point to the right address based on the QP and slice type
-    md_rate_estimation_array = (MdRateEstimationContext_t*)sequence_control_set_ptr->encode_context_ptr->md_rate_estimation_array;
-#if ADD_DELTA_QP_SUPPORT
-    md_rate_estimation_array += slice_type * TOTAL_NUMBER_OF_QP_VALUES + picture_control_set_ptr->parent_pcs_ptr->picture_qp;
-#else
-    md_rate_estimation_array += slice_type * TOTAL_NUMBER_OF_QP_VALUES + context_ptr->qp;
-#endif
-
-    // Reset MD rate Estimation table to initial values by copying from md_rate_estimation_array
-
-    context_ptr->md_rate_estimation_ptr = md_rate_estimation_array;
+    // MD Rate Estimation table of the picture, built by the mode decision configuration
+    context_ptr->md_rate_estimation_ptr = picture_control_set_ptr->md_rate_estimation_ptr;
 
     // TMVP Map Writer pointer
     if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
@@ -572,26 +555,13 @@ void ReconOutput(
             }
         }
 
-        // FGN: Create a buffer if needed, copy the reconstructed picture and run the film grain synthesis algorithm
-
-        if (sequence_control_set_ptr->film_grain_params_present) {
-            EbPictureBufferDesc_t  *intermediateBufferPtr;
-            {
-                if (is16bit)
-                    intermediateBufferPtr = picture_control_set_ptr->film_grain_picture16bit_ptr;
-                else
-                    intermediateBufferPtr = picture_control_set_ptr->film_grain_picture_ptr;
-            }
-
-            aom_film_grain_t *film_grain_ptr;
+        // FGN: the rest threads synthesized the film grain of the recon into the film grain picture
 
-            if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                film_grain_ptr = &((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->film_grain_params;
+        if (picture_control_set_ptr->film_grain_recon_flag) {
+            if (is16bit)
+                recon_ptr = picture_control_set_ptr->film_grain_picture16bit_ptr;
             else
-                film_grain_ptr = &picture_control_set_ptr->parent_pcs_ptr->film_grain_params;
-
-            av1_add_film_grain(recon_ptr, intermediateBufferPtr, film_grain_ptr);
-            recon_ptr = intermediateBufferPtr;
+                recon_ptr = picture_control_set_ptr->film_grain_picture_ptr;
         }
 
         // End running the film grain
@@ -1027,6 +997,9 @@ void PsnrCalculations(
     }
 }
 
+void SetRefFlags(
+    PictureControlSet_t    *picture_control_set_ptr);
+
 void PadRefAndSetFlags(
     PictureControlSet_t    *picture_control_set_ptr,
     SequenceControlSet   *sequence_control_set_ptr
@@ -1098,6 +1071,16 @@ void PadRefAndSetFlags(
 
     }
 
+    SetRefFlags(
+        picture_control_set_ptr);
+}
+
+void SetRefFlags(
+    PictureControlSet_t    *picture_control_set_ptr
+)
+{
+    EbReferenceObject   *referenceObject = (EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr;
+
     // set up TMVP flag for the reference picture
 
     referenceObject->tmvp_enable_flag = (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag) ? EB_TRUE : EB_FALSE;
@@ -1295,6 +1278,10 @@ EbErrorType signal_derivation_enc_dec_kernel_oq(
 #if SCENE_CONTENT_SETTINGS
     }
 #endif
+    // Deadline speed control
+    context_ptr->nfl_level = (uint8_t)MIN(DEADLINE_LATE_NFL_LEVEL,
+        context_ptr->nfl_level + eb_deadline_control_get_effort(picture_control_set_ptr->parent_pcs_ptr->effort_level)->nfl_level_delta);
+
     // Set Chroma Mode
     // Level                Settings
     // CHROMA_MODE_0  0     Chroma @ MD
@@ -1442,10 +1429,57 @@ void move_cu_data(
     CodingUnit_t *src_cu,
     CodingUnit_t *dst_cu);
 
+/******************************************************
+ * EncDec Post Coded Rows
+ *
+ * Posts one EncDec Results per SB row that became
+ *   complete, so that DLF can start on the rows while
+ *   the rest of the picture is coded. Segments complete
+ *   rows out of order; the results only cover the rows
+ *   of the picture whose SBs above are all coded.
+ ******************************************************/
+static void EncDecPostCodedRows(
+    EncDecContext_t         *context_ptr,
+    PictureControlSet_t     *picture_control_set_ptr,
+    EbObjectWrapper         *picture_control_set_wrapper_ptr)
+{
+    SbRowSync_t     *rowSyncPtr = picture_control_set_ptr->enc_dec_row_sync;
+    EbObjectWrapper *encDecResultsWrapperPtr;
+    EncDecResults_t *encDecResultsPtr;
+    uint32_t         rowIndexStart;
+    uint32_t         rowCount;
+    uint32_t         rowIndex;
+
+    eb_block_on_mutex(rowSyncPtr->mutex);
+    rowIndexStart = rowSyncPtr->readyRowCount;
+    rowCount = SbRowSyncUpdateReadyRows(rowSyncPtr);
+    eb_release_mutex(rowSyncPtr->mutex);
+
+    // Posted outside of the mutex, the empty object may have to wait for DLF
+    for (rowIndex = rowIndexStart; rowIndex < rowIndexStart + rowCount; ++rowIndex) {
+
+        // Get Empty EncDec Results
+        eb_get_empty_object(
+            context_ptr->enc_dec_output_fifo_ptr,
+            &encDecResultsWrapperPtr);
+        encDecResultsPtr = (EncDecResults_t*)encDecResultsWrapperPtr->object_ptr;
+        encDecResultsPtr->picture_control_set_wrapper_ptr = picture_control_set_wrapper_ptr;
+        encDecResultsPtr->completedLcuRowIndexStart = rowIndex;
+        encDecResultsPtr->completedLcuRowCount = 1;
+
+        // Post EncDec Results
+        eb_post_full_object(encDecResultsWrapperPtr);
+    }
+
+    return;
+}
+
 /******************************************************
  * EncDec Kernel
  ******************************************************/
-void* EncDecKernel(void *input_ptr)
+void EncDecKernel(
+    void            *input_ptr,
+    EbObjectWrapper *encDecTasksWrapperPtr)
 {
     // Context & SCS & PCS
     EncDecContext_t                         *context_ptr = (EncDecContext_t*)input_ptr;
@@ -1453,12 +1487,8 @@ void* EncDecKernel(void *input_ptr)
     SequenceControlSet                    *sequence_control_set_ptr;
 
     // Input
-    EbObjectWrapper                       *encDecTasksWrapperPtr;
     EncDecTasks_t                           *encDecTasksPtr;
 
-    // Output
-    EbObjectWrapper                       *encDecResultsWrapperPtr;
-    EncDecResults_t                         *encDecResultsPtr;
     // SB Loop variables
     LargestCodingUnit_t                     *sb_ptr;
     uint16_t                                 sb_index;
@@ -1490,234 +1520,254 @@ void* EncDecKernel(void *input_ptr)
     uint32_t                                 segmentBandIndex;
     uint32_t                                 segmentBandSize;
     EncDecSegments_t                        *segmentsPtr;
-    for (;;) {
-
-        // Get Mode Decision Results
-        eb_get_full_object(
-            context_ptr->mode_decision_input_fifo_ptr,
-            &encDecTasksWrapperPtr);
-
-        encDecTasksPtr = (EncDecTasks_t*)encDecTasksWrapperPtr->object_ptr;
-        picture_control_set_ptr = (PictureControlSet_t*)encDecTasksPtr->picture_control_set_wrapper_ptr->object_ptr;
-        sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
-        segmentsPtr = picture_control_set_ptr->enc_dec_segment_ctrl;
-        lastLcuFlag = EB_FALSE;
-        is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
-        (void)is16bit;
-        (void)endOfRowFlag;
-
-        // EncDec Kernel Signal(s) derivation
 
-        signal_derivation_enc_dec_kernel_oq(
+    // Deadline speed control
+    EbDeadlineControl                       *deadlineControlPtr;
+    uint64_t                                 deadlineTime;
+    uint64_t                                 workStartTime;
+    EbBool                                   lateFlag = EB_FALSE;
+    uint32_t                                 lateSbCount = 0;
+
+    encDecTasksPtr = (EncDecTasks_t*)encDecTasksWrapperPtr->object_ptr;
+    picture_control_set_ptr = (PictureControlSet_t*)encDecTasksPtr->picture_control_set_wrapper_ptr->object_ptr;
+    eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
+    sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    segmentsPtr = picture_control_set_ptr->enc_dec_segment_ctrl;
+    lastLcuFlag = EB_FALSE;
+    is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    (void)is16bit;
+    (void)endOfRowFlag;
+
+    // EncDec Kernel Signal(s) derivation
+
+    signal_derivation_enc_dec_kernel_oq(
+        sequence_control_set_ptr,
+        picture_control_set_ptr,
+        context_ptr->md_context);
+
+    // Deadline speed control: the SBs coded once the picture is past its
+    // deadline get the lowest effort
+    deadlineControlPtr = sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr;
+    workStartTime = eb_deadline_work_start(deadlineControlPtr);
+    deadlineTime = deadlineControlPtr ? eb_deadline_control_get_deadline(
+        deadlineControlPtr,
+        picture_control_set_ptr->parent_pcs_ptr->decode_order,
+        picture_control_set_ptr->parent_pcs_ptr->arrival_time_us) : 0;
+
+    // SB Constants
+    sb_sz = (uint8_t)sequence_control_set_ptr->sb_size_pix;
+    lcuSizeLog2 = (uint8_t)Log2f(sb_sz);
+    context_ptr->sb_sz = sb_sz;
+    picture_width_in_sb = (sequence_control_set_ptr->luma_width + sb_sz - 1) >> lcuSizeLog2;
+    endOfRowFlag = EB_FALSE;
+    lcuRowIndexStart = lcuRowIndexCount = 0;
+    context_ptr->tot_intra_coded_area = 0;
+    context_ptr->tot_luma_txb_count = 0;
+    context_ptr->reused_luma_txb_count = 0;
+
+    // Segment-loop
+    while (AssignEncDecSegments(segmentsPtr, &segment_index, encDecTasksPtr, context_ptr->enc_dec_feedback_fifo_ptr) == EB_TRUE)
+    {
+        xLcuStartIndex = segmentsPtr->xStartArray[segment_index];
+        yLcuStartIndex = segmentsPtr->yStartArray[segment_index];
+        lcuStartIndex = yLcuStartIndex * picture_width_in_sb + xLcuStartIndex;
+        lcuSegmentCount = segmentsPtr->validLcuCountArray[segment_index];
+
+        segmentRowIndex = segment_index / segmentsPtr->segmentBandCount;
+        segmentBandIndex = segment_index - segmentRowIndex * segmentsPtr->segmentBandCount;
+        segmentBandSize = (segmentsPtr->lcuBandCount * (segmentBandIndex + 1) + segmentsPtr->segmentBandCount - 1) / segmentsPtr->segmentBandCount;
+
+        // Reset Coding Loop State
+        reset_mode_decision( // HT done
+            context_ptr->md_context,
+            picture_control_set_ptr,
             sequence_control_set_ptr,
+            segment_index);
+
+        // Reset EncDec Coding State
+        ResetEncDec(    // HT done
+            context_ptr,
             picture_control_set_ptr,
-            context_ptr->md_context);
-
-        // SB Constants
-        sb_sz = (uint8_t)sequence_control_set_ptr->sb_size_pix;
-        lcuSizeLog2 = (uint8_t)Log2f(sb_sz);
-        context_ptr->sb_sz = sb_sz;
-        picture_width_in_sb = (sequence_control_set_ptr->luma_width + sb_sz - 1) >> lcuSizeLog2;
-        endOfRowFlag = EB_FALSE;
-        lcuRowIndexStart = lcuRowIndexCount = 0;
-        context_ptr->tot_intra_coded_area = 0;
+            sequence_control_set_ptr,
+            segment_index);
 
-        // Segment-loop
-        while (AssignEncDecSegments(segmentsPtr, &segment_index, encDecTasksPtr, context_ptr->enc_dec_feedback_fifo_ptr) == EB_TRUE)
-        {
-            xLcuStartIndex = segmentsPtr->xStartArray[segment_index];
-            yLcuStartIndex = segmentsPtr->yStartArray[segment_index];
-            lcuStartIndex = yLcuStartIndex * picture_width_in_sb + xLcuStartIndex;
-            lcuSegmentCount = segmentsPtr->validLcuCountArray[segment_index];
-
-            segmentRowIndex = segment_index / segmentsPtr->segmentBandCount;
-            segmentBandIndex = segment_index - segmentRowIndex * segmentsPtr->segmentBandCount;
-            segmentBandSize = (segmentsPtr->lcuBandCount * (segmentBandIndex + 1) + segmentsPtr->segmentBandCount - 1) / segmentsPtr->segmentBandCount;
-
-            // Reset Coding Loop State
-            reset_mode_decision( // HT done
-                context_ptr->md_context,
-                picture_control_set_ptr,
-                sequence_control_set_ptr,
-                segment_index);
+        if (picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
+            ((EbReferenceObject  *)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->average_intensity = picture_control_set_ptr->parent_pcs_ptr->average_intensity[0];
+        }
 
-            // Reset EncDec Coding State
-            ResetEncDec(    // HT done
-                context_ptr,
+        if (sequence_control_set_ptr->static_config.improve_sharpness) {
+            QpmDeriveWeightsMinAndMax(
                 picture_control_set_ptr,
-                sequence_control_set_ptr,
-                segment_index);
-
-            if (picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
-                ((EbReferenceObject  *)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->average_intensity = picture_control_set_ptr->parent_pcs_ptr->average_intensity[0];
-            }
+                context_ptr);
+        }
+        for (yLcuIndex = yLcuStartIndex, lcuSegmentIndex = lcuStartIndex; lcuSegmentIndex < lcuStartIndex + lcuSegmentCount; ++yLcuIndex) {
+            for (xLcuIndex = xLcuStartIndex; xLcuIndex < picture_width_in_sb && (xLcuIndex + yLcuIndex < segmentBandSize) && lcuSegmentIndex < lcuStartIndex + lcuSegmentCount; ++xLcuIndex, ++lcuSegmentIndex) {
+
+                sb_index = (uint16_t)(yLcuIndex * picture_width_in_sb + xLcuIndex);
+                sb_ptr = picture_control_set_ptr->sb_ptr_array[sb_index];
+                sb_origin_x = xLcuIndex << lcuSizeLog2;
+                sb_origin_y = yLcuIndex << lcuSizeLog2;
+                lastLcuFlag = (sb_index == sequence_control_set_ptr->sb_tot_cnt - 1) ? EB_TRUE : EB_FALSE;
+                endOfRowFlag = (xLcuIndex == picture_width_in_sb - 1) ? EB_TRUE : EB_FALSE;
+                lcuRowIndexStart = (xLcuIndex == picture_width_in_sb - 1 && lcuRowIndexCount == 0) ? yLcuIndex : lcuRowIndexStart;
+                lcuRowIndexCount = (xLcuIndex == picture_width_in_sb - 1) ? lcuRowIndexCount + 1 : lcuRowIndexCount;
+                mdcPtr = &picture_control_set_ptr->mdc_sb_array[sb_index];
+                context_ptr->sb_index = sb_index;
+                if (deadlineTime && !lateFlag && eb_get_time_stamp_us() > deadlineTime) {
+                    context_ptr->md_context->nfl_level = DEADLINE_LATE_NFL_LEVEL;
+                    lateFlag = EB_TRUE;
+                }
+                lateSbCount += lateFlag;
+                context_ptr->md_context->cu_use_ref_src_flag = (picture_control_set_ptr->parent_pcs_ptr->use_src_ref) && (picture_control_set_ptr->parent_pcs_ptr->edge_results_ptr[sb_index].edge_block_num == EB_FALSE || picture_control_set_ptr->parent_pcs_ptr->sb_flat_noise_array[sb_index]) ? EB_TRUE : EB_FALSE;
 
-            if (sequence_control_set_ptr->static_config.improve_sharpness) {
-                QpmDeriveWeightsMinAndMax(
+                // Configure the LCU
+                ModeDecisionConfigureLcu(
+                    context_ptr->md_context,
+                    sb_ptr,
                     picture_control_set_ptr,
-                    context_ptr);
-            }
-            for (yLcuIndex = yLcuStartIndex, lcuSegmentIndex = lcuStartIndex; lcuSegmentIndex < lcuStartIndex + lcuSegmentCount; ++yLcuIndex) {
-                for (xLcuIndex = xLcuStartIndex; xLcuIndex < picture_width_in_sb && (xLcuIndex + yLcuIndex < segmentBandSize) && lcuSegmentIndex < lcuStartIndex + lcuSegmentCount; ++xLcuIndex, ++lcuSegmentIndex) {
-
-                    sb_index = (uint16_t)(yLcuIndex * picture_width_in_sb + xLcuIndex);
-                    sb_ptr = picture_control_set_ptr->sb_ptr_array[sb_index];
-                    sb_origin_x = xLcuIndex << lcuSizeLog2;
-                    sb_origin_y = yLcuIndex << lcuSizeLog2;
-                    lastLcuFlag = (sb_index == sequence_control_set_ptr->sb_tot_cnt - 1) ? EB_TRUE : EB_FALSE;
-                    endOfRowFlag = (xLcuIndex == picture_width_in_sb - 1) ? EB_TRUE : EB_FALSE;
-                    lcuRowIndexStart = (xLcuIndex == picture_width_in_sb - 1 && lcuRowIndexCount == 0) ? yLcuIndex : lcuRowIndexStart;
-                    lcuRowIndexCount = (xLcuIndex == picture_width_in_sb - 1) ? lcuRowIndexCount + 1 : lcuRowIndexCount;
-                    mdcPtr = &picture_control_set_ptr->mdc_sb_array[sb_index];
-                    context_ptr->sb_index = sb_index;
-                    context_ptr->md_context->cu_use_ref_src_flag = (picture_control_set_ptr->parent_pcs_ptr->use_src_ref) && (picture_control_set_ptr->parent_pcs_ptr->edge_results_ptr[sb_index].edge_block_num == EB_FALSE || picture_control_set_ptr->parent_pcs_ptr->sb_flat_noise_array[sb_index]) ? EB_TRUE : EB_FALSE;
-
-                    // Configure the LCU
-                    ModeDecisionConfigureLcu(
-                        context_ptr->md_context,
-                        sb_ptr,
-                        picture_control_set_ptr,
-                        sequence_control_set_ptr,
-                        (uint8_t)context_ptr->qp,
-                        (uint8_t)sb_ptr->qp);
-
-                    uint32_t lcuRow;
-                    if (picture_control_set_ptr->parent_pcs_ptr->enable_in_loop_motion_estimation_flag) {
+                    sequence_control_set_ptr,
+                    (uint8_t)context_ptr->qp,
+                    (uint8_t)sb_ptr->qp);
 
-                        EbPictureBufferDesc_t       *input_picture_ptr;
+                uint32_t lcuRow;
+                if (picture_control_set_ptr->parent_pcs_ptr->enable_in_loop_motion_estimation_flag) {
 
-                        input_picture_ptr = picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+                    EbPictureBufferDesc_t       *input_picture_ptr;
 
-                        // Load the SB from the input to the intermediate SB buffer
-                        uint32_t bufferIndex = (input_picture_ptr->origin_y + sb_origin_y) * input_picture_ptr->stride_y + input_picture_ptr->origin_x + sb_origin_x;
+                    input_picture_ptr = picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
 
-                        // Copy the source superblock to the me local buffer
-                        uint32_t sb_height = (sequence_control_set_ptr->luma_height - sb_origin_y) < MAX_SB_SIZE ? sequence_control_set_ptr->luma_height - sb_origin_y : MAX_SB_SIZE;
-                        uint32_t sb_width = (sequence_control_set_ptr->luma_width - sb_origin_x) < MAX_SB_SIZE ? sequence_control_set_ptr->luma_width - sb_origin_x : MAX_SB_SIZE;
-                        uint32_t is_complete_sb = sequence_control_set_ptr->sb_geom[sb_index].is_complete_sb;
+                    // Load the SB from the input to the intermediate SB buffer
+                    uint32_t bufferIndex = (input_picture_ptr->origin_y + sb_origin_y) * input_picture_ptr->stride_y + input_picture_ptr->origin_x + sb_origin_x;
 
-                        if (!is_complete_sb) {
-                            memset(context_ptr->ss_mecontext->sb_buffer, 0, MAX_SB_SIZE*MAX_SB_SIZE);
-                        }
-                        for (lcuRow = 0; lcuRow < sb_height; lcuRow++) {
-                            EB_MEMCPY((&(context_ptr->ss_mecontext->sb_buffer[lcuRow * MAX_SB_SIZE])), (&(input_picture_ptr->buffer_y[bufferIndex + lcuRow * input_picture_ptr->stride_y])), sb_width * sizeof(uint8_t));
-                        }
+                    // Copy the source superblock to the me local buffer
+                    uint32_t sb_height = (sequence_control_set_ptr->luma_height - sb_origin_y) < MAX_SB_SIZE ? sequence_control_set_ptr->luma_height - sb_origin_y : MAX_SB_SIZE;
+                    uint32_t sb_width = (sequence_control_set_ptr->luma_width - sb_origin_x) < MAX_SB_SIZE ? sequence_control_set_ptr->luma_width - sb_origin_x : MAX_SB_SIZE;
+                    uint32_t is_complete_sb = sequence_control_set_ptr->sb_geom[sb_index].is_complete_sb;
 
-                        context_ptr->ss_mecontext->sb_src_ptr = &(context_ptr->ss_mecontext->sb_buffer[0]);
-                        context_ptr->ss_mecontext->sb_src_stride = context_ptr->ss_mecontext->sb_buffer_stride;
-                        // Set in-loop ME Search Area
-                        int16_t mv_l0_x;
-                        int16_t mv_l0_y;
-                        int16_t mv_l1_x;
-                        int16_t mv_l1_y;
-                        uint32_t me_sb_addr;
-
-                        if (sequence_control_set_ptr->sb_size == BLOCK_128X128) {
-
-                            uint32_t me_sb_size = sequence_control_set_ptr->sb_sz;
-                            uint32_t me_pic_width_in_sb = (sequence_control_set_ptr->luma_width + me_sb_size - 1) / me_sb_size;
-                            uint32_t me_pic_height_in_sb = (sequence_control_set_ptr->luma_height + me_sb_size - 1) / me_sb_size;
-                            uint32_t me_sb_x = (sb_origin_x / me_sb_size);
-                            uint32_t me_sb_y = (sb_origin_y / me_sb_size);
-                            uint32_t me_sb_addr_0 = me_sb_x + me_sb_y * me_pic_width_in_sb;
-                            uint32_t me_sb_addr_1 = (me_sb_x + 1) < me_pic_width_in_sb ? (me_sb_x + 1) + ((me_sb_y + 0) * me_pic_width_in_sb) : me_sb_addr_0;
-                            uint32_t me_sb_addr_2 = (me_sb_y + 1) < me_pic_height_in_sb ? (me_sb_x + 0) + ((me_sb_y + 1) * me_pic_width_in_sb) : me_sb_addr_0;
-                            uint32_t me_sb_addr_3 = ((me_sb_x + 1) < me_pic_width_in_sb) && ((me_sb_y + 1) < me_pic_height_in_sb) ? (me_sb_x + 1) + ((me_sb_y + 1) * me_pic_width_in_sb) : me_sb_addr_0;
-
-                            MeCuResults_t * me_block_results_0 = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr_0][0];
-                            MeCuResults_t * me_block_results_1 = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr_1][0];
-                            MeCuResults_t * me_block_results_2 = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr_2][0];
-                            MeCuResults_t * me_block_results_3 = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr_3][0];
-
-                            // Compute average open_loop 64x64 MVs
-                            mv_l0_x = ((me_block_results_0->xMvL0 + me_block_results_1->xMvL0 + me_block_results_2->xMvL0 + me_block_results_3->xMvL0) >> 2) >> 2;
-                            mv_l0_y = ((me_block_results_0->yMvL0 + me_block_results_1->yMvL0 + me_block_results_2->yMvL0 + me_block_results_3->yMvL0) >> 2) >> 2;
-                            mv_l1_x = ((me_block_results_0->xMvL1 + me_block_results_1->xMvL1 + me_block_results_2->xMvL1 + me_block_results_3->xMvL1) >> 2) >> 2;
-                            mv_l1_y = ((me_block_results_0->yMvL1 + me_block_results_1->yMvL1 + me_block_results_2->yMvL1 + me_block_results_3->yMvL1) >> 2) >> 2;
+                    if (!is_complete_sb) {
+                        memset(context_ptr->ss_mecontext->sb_buffer, 0, MAX_SB_SIZE*MAX_SB_SIZE);
+                    }
+                    for (lcuRow = 0; lcuRow < sb_height; lcuRow++) {
+                        EB_MEMCPY((&(context_ptr->ss_mecontext->sb_buffer[lcuRow * MAX_SB_SIZE])), (&(input_picture_ptr->buffer_y[bufferIndex + lcuRow * input_picture_ptr->stride_y])), sb_width * sizeof(uint8_t));
+                    }
 
-                        }
-                        else {
-                            me_sb_addr = sb_index;
-                            MeCuResults_t * mePuResult = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr][0];
-
-                            mv_l0_x = mePuResult->xMvL0 >> 2;
-                            mv_l0_y = mePuResult->yMvL0 >> 2;
-                            mv_l1_x = mePuResult->xMvL1 >> 2;
-                            mv_l1_y = mePuResult->yMvL1 >> 2;
-                        }
+                    context_ptr->ss_mecontext->sb_src_ptr = &(context_ptr->ss_mecontext->sb_buffer[0]);
+                    context_ptr->ss_mecontext->sb_src_stride = context_ptr->ss_mecontext->sb_buffer_stride;
+                    // Set in-loop ME Search Area
+                    int16_t mv_l0_x;
+                    int16_t mv_l0_y;
+                    int16_t mv_l1_x;
+                    int16_t mv_l1_y;
+                    uint32_t me_sb_addr;
+
+                    if (sequence_control_set_ptr->sb_size == BLOCK_128X128) {
+
+                        uint32_t me_sb_size = sequence_control_set_ptr->sb_sz;
+                        uint32_t me_pic_width_in_sb = (sequence_control_set_ptr->luma_width + me_sb_size - 1) / me_sb_size;
+                        uint32_t me_pic_height_in_sb = (sequence_control_set_ptr->luma_height + me_sb_size - 1) / me_sb_size;
+                        uint32_t me_sb_x = (sb_origin_x / me_sb_size);
+                        uint32_t me_sb_y = (sb_origin_y / me_sb_size);
+                        uint32_t me_sb_addr_0 = me_sb_x + me_sb_y * me_pic_width_in_sb;
+                        uint32_t me_sb_addr_1 = (me_sb_x + 1) < me_pic_width_in_sb ? (me_sb_x + 1) + ((me_sb_y + 0) * me_pic_width_in_sb) : me_sb_addr_0;
+                        uint32_t me_sb_addr_2 = (me_sb_y + 1) < me_pic_height_in_sb ? (me_sb_x + 0) + ((me_sb_y + 1) * me_pic_width_in_sb) : me_sb_addr_0;
+                        uint32_t me_sb_addr_3 = ((me_sb_x + 1) < me_pic_width_in_sb) && ((me_sb_y + 1) < me_pic_height_in_sb) ? (me_sb_x + 1) + ((me_sb_y + 1) * me_pic_width_in_sb) : me_sb_addr_0;
+
+                        MeCuResults_t * me_block_results_0 = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr_0][0];
+                        MeCuResults_t * me_block_results_1 = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr_1][0];
+                        MeCuResults_t * me_block_results_2 = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr_2][0];
+                        MeCuResults_t * me_block_results_3 = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr_3][0];
+
+                        // Compute average open_loop 64x64 MVs
+                        mv_l0_x = ((me_block_results_0->xMvL0 + me_block_results_1->xMvL0 + me_block_results_2->xMvL0 + me_block_results_3->xMvL0) >> 2) >> 2;
+                        mv_l0_y = ((me_block_results_0->yMvL0 + me_block_results_1->yMvL0 + me_block_results_2->yMvL0 + me_block_results_3->yMvL0) >> 2) >> 2;
+                        mv_l1_x = ((me_block_results_0->xMvL1 + me_block_results_1->xMvL1 + me_block_results_2->xMvL1 + me_block_results_3->xMvL1) >> 2) >> 2;
+                        mv_l1_y = ((me_block_results_0->yMvL1 + me_block_results_1->yMvL1 + me_block_results_2->yMvL1 + me_block_results_3->yMvL1) >> 2) >> 2;
 
+                    }
+                    else {
+                        me_sb_addr = sb_index;
+                        MeCuResults_t * mePuResult = &picture_control_set_ptr->parent_pcs_ptr->me_results[me_sb_addr][0];
+
+                        mv_l0_x = mePuResult->xMvL0 >> 2;
+                        mv_l0_y = mePuResult->yMvL0 >> 2;
+                        mv_l1_x = mePuResult->xMvL1 >> 2;
+                        mv_l1_y = mePuResult->yMvL1 >> 2;
+                    }
 
-                        context_ptr->ss_mecontext->search_area_width = 64;
-                        context_ptr->ss_mecontext->search_area_height = 64;
 
-                        // perform in-loop ME
-                        in_loop_motion_estimation_sblock(
-                            picture_control_set_ptr,
-                            sb_origin_x,
-                            sb_origin_y,
-                            mv_l0_x,
-                            mv_l0_y,
-                            mv_l1_x,
-                            mv_l1_y,
-                            context_ptr->ss_mecontext);
-                    }
+                    context_ptr->ss_mecontext->search_area_width = 64;
+                    context_ptr->ss_mecontext->search_area_height = 64;
 
-                    mode_decision_sb(
-                        sequence_control_set_ptr,
+                    // perform in-loop ME
+                    in_loop_motion_estimation_sblock(
                         picture_control_set_ptr,
-                        mdcPtr,
-                        sb_ptr,
                         sb_origin_x,
                         sb_origin_y,
-                        sb_index,
-                        context_ptr->ss_mecontext,
-                        context_ptr->md_context);
-
+                        mv_l0_x,
+                        mv_l0_y,
+                        mv_l1_x,
+                        mv_l1_y,
+                        context_ptr->ss_mecontext);
+                }
 
-                    // Configure the LCU
-                    EncDecConfigureLcu(
-                        context_ptr,
-                        sb_ptr,
-                        picture_control_set_ptr,
-                        sequence_control_set_ptr,
-                        (uint8_t)context_ptr->qp,
-                        (uint8_t)sb_ptr->qp);
+                mode_decision_sb(
+                    sequence_control_set_ptr,
+                    picture_control_set_ptr,
+                    mdcPtr,
+                    sb_ptr,
+                    sb_origin_x,
+                    sb_origin_y,
+                    sb_index,
+                    context_ptr->ss_mecontext,
+                    context_ptr->md_context);
+
+
+                // Configure the LCU
+                EncDecConfigureLcu(
+                    context_ptr,
+                    sb_ptr,
+                    picture_control_set_ptr,
+                    sequence_control_set_ptr,
+                    (uint8_t)context_ptr->qp,
+                    (uint8_t)sb_ptr->qp);
 
 #if NO_ENCDEC
-                    no_enc_dec_pass(
-                        sequence_control_set_ptr,
-                        picture_control_set_ptr,
-                        sb_ptr,
-                        sb_index,
-                        sb_origin_x,
-                        sb_origin_y,
-                        sb_ptr->qp,
-                        context_ptr);
+                no_enc_dec_pass(
+                    sequence_control_set_ptr,
+                    picture_control_set_ptr,
+                    sb_ptr,
+                    sb_index,
+                    sb_origin_x,
+                    sb_origin_y,
+                    sb_ptr->qp,
+                    context_ptr);
 #else
-                    // Encode Pass
-                    AV1EncodePass(
-                        sequence_control_set_ptr,
-                        picture_control_set_ptr,
-                        sb_ptr,
-                        sb_index,
-                        sb_origin_x,
-                        sb_origin_y,
-                        sb_ptr->qp,
-                        context_ptr);
+                // Encode Pass
+                AV1EncodePass(
+                    sequence_control_set_ptr,
+                    picture_control_set_ptr,
+                    sb_ptr,
+                    sb_index,
+                    sb_origin_x,
+                    sb_origin_y,
+                    sb_ptr->qp,
+                    context_ptr);
 #endif
 
-                    if (picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
-                        ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->intra_coded_area_sb[sb_index] = (uint8_t)((100 * context_ptr->intra_coded_area_sb[sb_index]) / (64 * 64));
-                    }
-
+                if (picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
+                    ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->intra_coded_area_sb[sb_index] = (uint8_t)((100 * context_ptr->intra_coded_area_sb[sb_index]) / (64 * 64));
                 }
-                xLcuStartIndex = (xLcuStartIndex > 0) ? xLcuStartIndex - 1 : 0;
+
             }
-        }
 
-        eb_block_on_mutex(picture_control_set_ptr->intra_mutex);
-        picture_control_set_ptr->intra_coded_area += (uint32_t)context_ptr->tot_intra_coded_area;
-        eb_release_mutex(picture_control_set_ptr->intra_mutex);
+            // SB row progress of the DLF wavefront
+            SbRowSyncAddProgress(
+                picture_control_set_ptr->enc_dec_row_sync,
+                yLcuIndex,
+                xLcuIndex - xLcuStartIndex);
+
+            xLcuStartIndex = (xLcuStartIndex > 0) ? xLcuStartIndex - 1 : 0;
+        }
 
         if (lastLcuFlag) {
 
@@ -1736,40 +1786,44 @@ void* EncDecKernel(void *input_ptr)
             EB_MEMCPY(picture_control_set_ptr->parent_pcs_ptr->av1x->switchable_restore_cost, context_ptr->md_rate_estimation_ptr->switchableRestoreFacBits, 3 * sizeof(int32_t));
             EB_MEMCPY(picture_control_set_ptr->parent_pcs_ptr->av1x->wiener_restore_cost, context_ptr->md_rate_estimation_ptr->wienerRestoreFacBits, 2 * sizeof(int32_t));
             picture_control_set_ptr->parent_pcs_ptr->av1x->rdmult = context_ptr->full_lambda;
-
-
         }
 
+        // The rows posted below may be the last ones of the picture, after
+        // which the later stages read the picture totals: add the segment
+        // first
+        eb_block_on_mutex(picture_control_set_ptr->intra_mutex);
+        picture_control_set_ptr->intra_coded_area += (uint32_t)context_ptr->tot_intra_coded_area;
+        eb_release_mutex(picture_control_set_ptr->intra_mutex);
+        context_ptr->tot_intra_coded_area = 0;
 
-
-        if (lastLcuFlag)
-        {
-
-            // Get Empty EncDec Results
-            eb_get_empty_object(
-                context_ptr->enc_dec_output_fifo_ptr,
-                &encDecResultsWrapperPtr);
-            encDecResultsPtr = (EncDecResults_t*)encDecResultsWrapperPtr->object_ptr;
-            encDecResultsPtr->picture_control_set_wrapper_ptr = encDecTasksPtr->picture_control_set_wrapper_ptr;
-            //CHKN these are not needed for DLF
-            encDecResultsPtr->completedLcuRowIndexStart = 0;
-            encDecResultsPtr->completedLcuRowCount = ((sequence_control_set_ptr->luma_height + sequence_control_set_ptr->sb_size_pix - 1) >> lcuSizeLog2);
-            // Post EncDec Results
-            eb_post_full_object(encDecResultsWrapperPtr);
-
+        eb_deadline_work_end(deadlineControlPtr, &picture_control_set_ptr->parent_pcs_ptr->encode_time_us, workStartTime);
+        if (lateSbCount)
+            eb_atomic_fetch_add_32(&picture_control_set_ptr->parent_pcs_ptr->late_sb_count, (int32_t)lateSbCount);
+        if (context_ptr->tot_luma_txb_count) {
+            eb_atomic_fetch_add_32(&picture_control_set_ptr->parent_pcs_ptr->luma_txb_count, (int32_t)context_ptr->tot_luma_txb_count);
+            eb_atomic_fetch_add_32(&picture_control_set_ptr->parent_pcs_ptr->reused_luma_txb_count, (int32_t)context_ptr->reused_luma_txb_count);
         }
-        // Release Mode Decision Results
-        eb_release_object(encDecTasksWrapperPtr);
+        lateSbCount = 0;
+        context_ptr->tot_luma_txb_count = 0;
+        context_ptr->reused_luma_txb_count = 0;
+
+        // Hand the SB rows completed by this segment to DLF
+        EncDecPostCodedRows(
+            context_ptr,
+            picture_control_set_ptr,
+            encDecTasksPtr->picture_control_set_wrapper_ptr);
 
+        workStartTime = eb_deadline_work_start(deadlineControlPtr);
     }
-    return EB_NULL;
+
+    // Release Mode Decision Results
+    eb_release_object(encDecTasksWrapperPtr);
 }
 
-void av1_add_film_grain(EbPictureBufferDesc_t *src,
+void av1_add_film_grain_init(EbPictureBufferDesc_t *src,
     EbPictureBufferDesc_t *dst,
-    aom_film_grain_t *film_grain_ptr) {
-    uint8_t *luma, *cb, *cr;
-    int32_t height, width, luma_stride, chroma_stride;
+    aom_film_grain_t *film_grain_ptr,
+    aom_film_grain_synth_t *fgs) {
     int32_t use_high_bit_depth = 0;
     int32_t chroma_subsamp_x = 0;
     int32_t chroma_subsamp_y = 0;
@@ -1799,22 +1853,43 @@ void av1_add_film_grain(EbPictureBufferDesc_t *src,
     dst->maxWidth = src->maxWidth;
     dst->maxHeight = src->maxHeight;
 
-    fgn_copy_rect(src->buffer_y + ((src->origin_y * src->stride_y + src->origin_x) << use_high_bit_depth), src->stride_y,
-        dst->buffer_y + ((dst->origin_y * dst->stride_y + dst->origin_x) << use_high_bit_depth), dst->stride_y,
-        dst->width, dst->height, use_high_bit_depth);
+    av1_film_grain_synth_init(fgs, &params, dst->height, dst->width,
+        use_high_bit_depth, chroma_subsamp_y, chroma_subsamp_x);
+}
 
-    fgn_copy_rect(src->bufferCb + ((src->strideCb * (src->origin_y >> chroma_subsamp_y)
+EbErrorType av1_add_film_grain_rows(EbPictureBufferDesc_t *src,
+    EbPictureBufferDesc_t *dst,
+    const aom_film_grain_synth_t *fgs,
+    int32_t stripe) {
+    uint8_t *luma, *cb, *cr;
+    int32_t luma_stride, chroma_stride;
+    int32_t use_high_bit_depth = fgs->use_high_bit_depth;
+    int32_t chroma_subsamp_x = fgs->chroma_subsamp_x;
+    int32_t chroma_subsamp_y = fgs->chroma_subsamp_y;
+
+    // Rows of the stripe, the last stripe also takes the odd last row
+    int32_t row_start = stripe * FILM_GRAIN_STRIPE_HEIGHT;
+    int32_t row_end = stripe == av1_film_grain_stripe_count(dst->height) - 1 ?
+        dst->height : row_start + FILM_GRAIN_STRIPE_HEIGHT;
+    int32_t chroma_row_start = row_start >> chroma_subsamp_y;
+    int32_t chroma_row_end = row_end >> chroma_subsamp_y;
+
+    fgn_copy_rect(src->buffer_y + (((src->origin_y + row_start) * src->stride_y + src->origin_x) << use_high_bit_depth), src->stride_y,
+        dst->buffer_y + (((dst->origin_y + row_start) * dst->stride_y + dst->origin_x) << use_high_bit_depth), dst->stride_y,
+        dst->width, row_end - row_start, use_high_bit_depth);
+
+    fgn_copy_rect(src->bufferCb + ((src->strideCb * ((src->origin_y >> chroma_subsamp_y) + chroma_row_start)
         + (src->origin_x >> chroma_subsamp_x)) << use_high_bit_depth), src->strideCb,
-        dst->bufferCb + ((dst->strideCb * (dst->origin_y >> chroma_subsamp_y)
+        dst->bufferCb + ((dst->strideCb * ((dst->origin_y >> chroma_subsamp_y) + chroma_row_start)
             + (dst->origin_x >> chroma_subsamp_x)) << use_high_bit_depth), dst->strideCb,
-        dst->width >> chroma_subsamp_x, dst->height >> chroma_subsamp_y,
+        dst->width >> chroma_subsamp_x, chroma_row_end - chroma_row_start,
         use_high_bit_depth);
 
-    fgn_copy_rect(src->bufferCr + ((src->strideCr * (src->origin_y >> chroma_subsamp_y)
+    fgn_copy_rect(src->bufferCr + ((src->strideCr * ((src->origin_y >> chroma_subsamp_y) + chroma_row_start)
         + (src->origin_x >> chroma_subsamp_x)) << use_high_bit_depth), src->strideCr,
-        dst->bufferCr + ((dst->strideCr * (dst->origin_y >> chroma_subsamp_y)
+        dst->bufferCr + ((dst->strideCr * ((dst->origin_y >> chroma_subsamp_y) + chroma_row_start)
             + (dst->origin_x >> chroma_subsamp_x)) << use_high_bit_depth), dst->strideCr,
-        dst->width >> chroma_subsamp_x, dst->height >> chroma_subsamp_y,
+        dst->width >> chroma_subsamp_x, chroma_row_end - chroma_row_start,
         use_high_bit_depth);
 
     luma = dst->buffer_y + ((dst->origin_y * dst->stride_y + dst->origin_x) << use_high_bit_depth);
@@ -1826,11 +1901,9 @@ void av1_add_film_grain(EbPictureBufferDesc_t *src,
     luma_stride = dst->stride_y;
     chroma_stride = dst->strideCb;
 
-    width = dst->width;
-    height = dst->height;
-
-    av1_add_film_grain_run(&params, luma, cb, cr, height, width, luma_stride,
-        chroma_stride, use_high_bit_depth, chroma_subsamp_y,
-        chroma_subsamp_x);
-    return;
+    // The copied rows are left without grain when the stripe fails
+    if (av1_add_film_grain_stripe(fgs, luma, cb, cr, luma_stride,
+        chroma_stride, stripe))
+        return EB_ErrorInsufficientResources;
+    return EB_ErrorNone;
 }
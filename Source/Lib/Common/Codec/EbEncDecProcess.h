@@ -94,7 +94,7 @@ extern "C" {
         EbBool                                 is16bit; //enable 10 bit encode in CL
         EbColorFormat                          color_format;
         uint64_t                               tot_intra_coded_area;
-        uint8_t                                intra_coded_area_sb[MAX_NUMBER_OF_TREEBLOCKS_PER_PICTURE];//percentage of intra coded area 0-100%
+        uint32_t                              *intra_coded_area_sb;//intra coded area of each SB in samples
         uint8_t                                pmp_masking_level_enc_dec;
         EbBool                                 skip_qpm_flag;
         int16_t                                min_delta_qp_weight;
@@ -133,6 +133,11 @@ extern "C" {
         uint8_t                                reduced_tx_set_used;
 #endif
         EbBool                                 evaluate_cfl_ep; // 0: CFL is evaluated @ mode decision, 1: CFL is evaluated @ encode pass
+
+        // MD recon cache
+        const MdReconCache_t                  *md_recon_cache_hit[MAX_TXB_COUNT]; // MD slot the luma txb is committed from, NULL when coded again
+        uint32_t                               tot_luma_txb_count;
+        uint32_t                               reused_luma_txb_count;
     } EncDecContext_t;
 
     /**************************************
@@ -149,7 +154,9 @@ extern "C" {
         uint32_t                 max_input_luma_width,
         uint32_t                 max_input_luma_height);
 
-    extern void* EncDecKernel(void *input_ptr);
+    extern void EncDecKernel(
+        void            *input_ptr,
+        EbObjectWrapper *encDecTasksWrapperPtr);
 
 #ifdef __cplusplus
 }
@@ -22,6 +22,14 @@ extern "C" {
 
     } EncDecResults_t;
 
+    // segment_index of the feedback results a CDEF thread posts to let the
+    // other CDEF threads join the filter block rows of a picture
+#define CDEF_FEEDBACK_SEGMENT_INDEX     (~0u)
+
+    // segment_index of the feedback results a rest thread posts to let the
+    // other rest threads join the stripe rows of a picture
+#define REST_FEEDBACK_SEGMENT_INDEX     (~0u)
+
     typedef struct DlfResults_s
     {
         EbObjectWrapper      *picture_control_set_wrapper_ptr;
@@ -42,6 +50,7 @@ extern "C" {
         EbObjectWrapper      *picture_control_set_wrapper_ptr;
         uint32_t                  completed_lcu_row_index_start;
         uint32_t                  completed_lcu_row_count;
+        uint16_t                  tile_index;               // tile to code, for pictures with several tiles
 
     } RestResults_t;
 
@@ -8,6 +8,14 @@
 
 #include "EbEncDecSegments.h"
 #include "EbThreads.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+// Polling iterations before a waiting thread yields its time slice
+#define SB_ROW_SYNC_SPIN_COUNT  1024
 
 EbErrorType EncDecSegmentsCtor(
     EncDecSegments_t **segmentsDblPtr,
@@ -121,3 +129,178 @@ void EncDecSegmentsInit(
     return;
 }
 
+EbErrorType SbRowSyncCtor(
+    SbRowSync_t       **rowSyncDblPtr,
+    uint32_t            maxRowCount)
+{
+    SbRowSync_t *rowSyncPtr;
+    EB_MALLOC(SbRowSync_t*, rowSyncPtr, sizeof(SbRowSync_t), EB_N_PTR);
+
+    *rowSyncDblPtr = rowSyncPtr;
+
+    rowSyncPtr->maxRowCount = maxRowCount;
+    EB_MALLOC(int32_t*, rowSyncPtr->progressArray, sizeof(int32_t) * maxRowCount, EB_N_PTR);
+
+    EB_CREATEMUTEX(EbHandle, rowSyncPtr->mutex, sizeof(EbHandle), EB_MUTEX);
+
+    SbRowSyncInit(rowSyncPtr, 0, 0);
+
+    return EB_ErrorNone;
+}
+
+void SbRowSyncInit(
+    SbRowSync_t        *rowSyncPtr,
+    uint32_t            rowCount,
+    uint32_t            colCount)
+{
+    uint32_t rowIndex;
+
+    rowSyncPtr->rowCount = rowCount;
+    rowSyncPtr->colCount = colCount;
+    rowSyncPtr->readyRowCount = 0;
+    rowSyncPtr->nextRowIndex = 0;
+    rowSyncPtr->doneRowCount = 0;
+
+    for (rowIndex = 0; rowIndex < rowSyncPtr->maxRowCount; ++rowIndex) {
+        rowSyncPtr->progressArray[rowIndex] = 0;
+    }
+
+    return;
+}
+
+/**************************************
+ * SbRowSyncAddProgress
+ *   Returns the SBs completed in the row.
+ **************************************/
+uint32_t SbRowSyncAddProgress(
+    SbRowSync_t        *rowSyncPtr,
+    uint32_t            rowIndex,
+    uint32_t            sbCount)
+{
+    return (uint32_t)eb_atomic_fetch_add_32(&rowSyncPtr->progressArray[rowIndex], (int32_t)sbCount) + sbCount;
+}
+
+/**************************************
+ * SbRowSyncWait
+ *   Waits until sbCount SBs of the row are
+ *   completed. The row must be owned by a
+ *   running thread.
+ **************************************/
+void SbRowSyncWait(
+    SbRowSync_t        *rowSyncPtr,
+    uint32_t            rowIndex,
+    uint32_t            sbCount)
+{
+    uint32_t spinCount = 0;
+
+    while ((uint32_t)eb_atomic_load_32(&rowSyncPtr->progressArray[rowIndex]) < sbCount) {
+        SbRowSyncPause(&spinCount);
+    }
+
+    return;
+}
+
+/**************************************
+ * SbRowSyncPause
+ *   Backs off one iteration of a polling
+ *   loop, giving the processor away after
+ *   SB_ROW_SYNC_SPIN_COUNT iterations.
+ **************************************/
+void SbRowSyncPause(
+    uint32_t           *spinCountPtr)
+{
+    if (++*spinCountPtr < SB_ROW_SYNC_SPIN_COUNT) {
+        eb_cpu_pause();
+    }
+    else {
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+
+    return;
+}
+
+/**************************************
+ * SbRowSyncUpdateReadyRows
+ *   Moves readyRowCount past the rows whose
+ *   SBs are all completed. Returns the number
+ *   of rows that became ready. Called with the
+ *   mutex held.
+ **************************************/
+uint32_t SbRowSyncUpdateReadyRows(
+    SbRowSync_t        *rowSyncPtr)
+{
+    uint32_t readyRowCount = rowSyncPtr->readyRowCount;
+
+    while (rowSyncPtr->readyRowCount < rowSyncPtr->rowCount &&
+        (uint32_t)eb_atomic_load_32(&rowSyncPtr->progressArray[rowSyncPtr->readyRowCount]) == rowSyncPtr->colCount) {
+        ++rowSyncPtr->readyRowCount;
+    }
+
+    return rowSyncPtr->readyRowCount - readyRowCount;
+}
+
+/**************************************
+ * SbRowSyncClaimRow
+ *   Rows are claimed in order, so the row above
+ *   a claimed row is always owned by a thread
+ *   that does not wait on a later row.
+ **************************************/
+EbBool SbRowSyncClaimRow(
+    SbRowSync_t        *rowSyncPtr,
+    uint32_t           *rowIndexPtr)
+{
+    EbBool claimedFlag = EB_FALSE;
+
+    eb_block_on_mutex(rowSyncPtr->mutex);
+    if (rowSyncPtr->nextRowIndex < rowSyncPtr->readyRowCount) {
+        *rowIndexPtr = rowSyncPtr->nextRowIndex++;
+        claimedFlag = EB_TRUE;
+    }
+    eb_release_mutex(rowSyncPtr->mutex);
+
+    return claimedFlag;
+}
+
+/**************************************
+ * SbRowSyncCompleteRow
+ *   Returns EB_TRUE for the last row of the
+ *   picture.
+ **************************************/
+EbBool SbRowSyncCompleteRow(
+    SbRowSync_t        *rowSyncPtr)
+{
+    EbBool lastRowFlag;
+
+    eb_block_on_mutex(rowSyncPtr->mutex);
+    lastRowFlag = (EbBool)(++rowSyncPtr->doneRowCount == rowSyncPtr->rowCount);
+    eb_release_mutex(rowSyncPtr->mutex);
+
+    return lastRowFlag;
+}
+
+/**************************************
+ * SbRowSyncWaitDone
+ *   Waits until every row is completed.
+ **************************************/
+void SbRowSyncWaitDone(
+    SbRowSync_t        *rowSyncPtr)
+{
+    uint32_t spinCount = 0;
+    EbBool   doneFlag = EB_FALSE;
+
+    while (doneFlag == EB_FALSE) {
+        eb_block_on_mutex(rowSyncPtr->mutex);
+        doneFlag = (EbBool)(rowSyncPtr->doneRowCount == rowSyncPtr->rowCount);
+        eb_release_mutex(rowSyncPtr->mutex);
+
+        if (doneFlag == EB_FALSE) {
+            SbRowSyncPause(&spinCount);
+        }
+    }
+
+    return;
+}
@@ -71,6 +71,33 @@ extern "C" {
 
     } EncDecSegments_t;
 
+    /**************************************
+     * SB Row Sync
+     *   Tracks the SB rows of a picture from a
+     *   stage that completes them in any order to
+     *   a stage that filters them by SB row on
+     *   several threads.
+     *
+     *   progressArray    - SBs completed in each row
+     *   readyRowCount    - rows, in order, whose input is available
+     *   nextRowIndex     - next row to be claimed by a thread
+     *   doneRowCount     - rows completed by the threads
+     *
+     *   The counts are protected by mutex, the
+     *   progress is updated atomically so that a
+     *   thread can follow the row above it SB by SB.
+     **************************************/
+    typedef struct {
+        EbHandle            mutex;
+        uint32_t            rowCount;
+        uint32_t            colCount;
+        uint32_t            maxRowCount;
+        int32_t            *progressArray;
+        uint32_t            readyRowCount;
+        uint32_t            nextRowIndex;
+        uint32_t            doneRowCount;
+    } SbRowSync_t;
+
     /**************************************
      * Extern Function Declarations
      **************************************/
@@ -86,6 +113,41 @@ extern "C" {
         uint32_t            row_count,
         uint32_t            picWidthLcu,
         uint32_t            picHeightLcu);
+
+    extern EbErrorType SbRowSyncCtor(
+        SbRowSync_t       **rowSyncDblPtr,
+        uint32_t            maxRowCount);
+
+    extern void SbRowSyncInit(
+        SbRowSync_t        *rowSyncPtr,
+        uint32_t            rowCount,
+        uint32_t            colCount);
+
+    extern uint32_t SbRowSyncAddProgress(
+        SbRowSync_t        *rowSyncPtr,
+        uint32_t            rowIndex,
+        uint32_t            sbCount);
+
+    extern void SbRowSyncWait(
+        SbRowSync_t        *rowSyncPtr,
+        uint32_t            rowIndex,
+        uint32_t            sbCount);
+
+    extern void SbRowSyncPause(
+        uint32_t           *spinCountPtr);
+
+    extern uint32_t SbRowSyncUpdateReadyRows(
+        SbRowSync_t        *rowSyncPtr);
+
+    extern EbBool SbRowSyncClaimRow(
+        SbRowSync_t        *rowSyncPtr,
+        uint32_t           *rowIndexPtr);
+
+    extern EbBool SbRowSyncCompleteRow(
+        SbRowSync_t        *rowSyncPtr);
+
+    extern void SbRowSyncWaitDone(
+        SbRowSync_t        *rowSyncPtr);
 #ifdef __cplusplus
 }
 #endif
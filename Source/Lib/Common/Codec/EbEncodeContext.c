@@ -186,12 +186,8 @@ EbErrorType encode_context_ctor(
     // Prediction Structure Group
     encode_context_ptr->prediction_structure_group_ptr = (PredictionStructureGroup_t*)EB_NULL;
 
-    // MD Rate Estimation Array
-    EB_MALLOC(MdRateEstimationContext_t*, encode_context_ptr->md_rate_estimation_array, sizeof(MdRateEstimationContext_t) * TOTAL_NUMBER_OF_MD_RATE_ESTIMATION_CASE_BUFFERS, EB_N_PTR);
-
-    memset(encode_context_ptr->md_rate_estimation_array, 0, sizeof(MdRateEstimationContext_t) * TOTAL_NUMBER_OF_MD_RATE_ESTIMATION_CASE_BUFFERS);
-
-    return_error = MdRateEstimationContextCtor(encode_context_ptr->md_rate_estimation_array);
+    // MD Rate Estimation Cache
+    return_error = md_rate_estimation_cache_ctor(&encode_context_ptr->md_rate_estimation_cache_ptr);
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
@@ -214,6 +210,12 @@ EbErrorType encode_context_ctor(
     encode_context_ptr->sc_buffer = 0;
     encode_context_ptr->sc_frame_in = 0;
     encode_context_ptr->sc_frame_out = 0;
+    encode_context_ptr->deadline_control_ptr = (EbDeadlineControl*)EB_NULL;
+    encode_context_ptr->analysis_share_ptr = (EbAnalysisShare*)EB_NULL;
+    encode_context_ptr->analysis_share_lead = EB_FALSE;
+    encode_context_ptr->analysis_share_follower_index = 0;
+    encode_context_ptr->analysis_share_scene_fallback_count = 0;
+    encode_context_ptr->analysis_share_hme_fallback_count = 0;
 
     encode_context_ptr->enc_mode = SPEED_CONTROL_INIT_MOD;
 
@@ -221,15 +223,7 @@ EbErrorType encode_context_ctor(
     encode_context_ptr->max_coded_poc = 0;
     encode_context_ptr->max_coded_poc_selected_ref_qp = 32;
 
-    encode_context_ptr->shared_reference_mutex = eb_create_mutex();
-    if (encode_context_ptr->shared_reference_mutex == (EbHandle)EB_NULL) {
-        return EB_ErrorInsufficientResources;
-    }
-    else {
-        memory_map[*(memory_map_index)].ptr_type = EB_MUTEX;
-        memory_map[(*(memory_map_index))++].ptr = encode_context_ptr->shared_reference_mutex;
-        *total_lib_memory += (sizeof(EbHandle));
-    }
+    EB_CREATEMUTEX(EbHandle, encode_context_ptr->shared_reference_mutex, sizeof(EbHandle), EB_MUTEX);
 
 
     return EB_ErrorNone;
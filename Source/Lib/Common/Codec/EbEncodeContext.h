@@ -21,6 +21,8 @@
 #include "EbMdRateEstimation.h"
 #include "EbPredictionStructure.h"
 #include "EbRateControlTables.h"
+#include "EbDeadlineControl.h"
+#include "EbAnalysisShare.h"
 
 // *Note - the queues are small for testing purposes.  They should be increased when they are done.
 #define PRE_ASSIGNMENT_MAX_DEPTH                            128     // should be large enough to hold an entire prediction period
@@ -121,8 +123,8 @@ typedef struct EncodeContext_s
     // Prediction Structure
     PredictionStructureGroup_t                       *prediction_structure_group_ptr;
                                                      
-    // MD Rate Estimation Table                      
-    MdRateEstimationContext_t                        *md_rate_estimation_array;
+    // MD Rate Estimation Tables, cached by CDF content
+    MdRateEstimationCache_t                          *md_rate_estimation_cache_ptr;
 
     // Rate Control Bit Tables
     RateControlTables                              *rate_control_tables_array;
@@ -135,6 +137,14 @@ typedef struct EncodeContext_s
     int64_t                                           sc_frame_out;
     EbHandle                                          sc_buffer_mutex;
     EbEncMode                                         enc_mode;
+    EbDeadlineControl                                *deadline_control_ptr;    // speed_control_flag 2 only
+                                                     
+    // Analysis shared with the encoders of the other renditions of a ladder
+    EbAnalysisShare                                  *analysis_share_ptr;
+    EbBool                                            analysis_share_lead;
+    uint32_t                                          analysis_share_follower_index;
+    volatile int32_t                                  analysis_share_scene_fallback_count;  // followers: pictures analysed on their own
+    volatile int32_t                                  analysis_share_hme_fallback_count;
                                                      
     // Rate Control                                  
     uint32_t                                          previous_selected_ref_qp;
@@ -1509,8 +1509,84 @@ EbErrorType EntropyCoderCtor(
     return return_error;
 }
 
+EbErrorType entropy_coder_tile_overflow_ctor(
+    EntropyCoder_t *entropy_coder_ptr,
+    uint32_t        tile_count)
+{
+    EB_CALLOC(EbTileOverflow*, entropy_coder_ptr->tile_overflow_array, tile_count, sizeof(EbTileOverflow), EB_N_PTR);
+    entropy_coder_ptr->tile_overflow_count = tile_count;
+
+    return EB_ErrorNone;
+}
+
+
+/**************************************************
+ * Tile Bitstream Buffer
+ *   Tiles coded in parallel each own an equal slice
+ *   of the entropy coder buffer, holding the tile
+ *   size field followed by the tile data. A tile
+ *   longer than its slice is written to its entry
+ *   of tile_overflow_array instead; the slice then
+ *   only holds the size field.
+ **************************************************/
+uint8_t *get_tile_bitstream_buffer(
+    EntropyCoder_t *entropy_coder_ptr,
+    uint32_t        tile_count,
+    uint32_t        tile_idx)
+{
+    OutputBitstreamUnit_t *ecOutputBitstreamPtr = (OutputBitstreamUnit_t*)entropy_coder_ptr->ecOutputBitstreamPtr;
 
+    return ecOutputBitstreamPtr->bufferBeginAv1 + (ecOutputBitstreamPtr->size / tile_count) * tile_idx;
+}
 
+uint32_t get_tile_bitstream_size(
+    const uint8_t  *tile_buffer)
+{
+    return ((uint32_t)tile_buffer[0] | ((uint32_t)tile_buffer[1] << 8) |
+        ((uint32_t)tile_buffer[2] << 16) | ((uint32_t)tile_buffer[3] << 24)) + AV1_MIN_TILE_SIZE_BYTES;
+}
+
+uint32_t get_tile_bitstream_capacity(
+    EntropyCoder_t *entropy_coder_ptr,
+    uint32_t        tile_count)
+{
+    OutputBitstreamUnit_t *ecOutputBitstreamPtr = (OutputBitstreamUnit_t*)entropy_coder_ptr->ecOutputBitstreamPtr;
+
+    assert(ecOutputBitstreamPtr->size / tile_count > AV1_TILE_SIZE_BYTES);
+    return ecOutputBitstreamPtr->size / tile_count - AV1_TILE_SIZE_BYTES;
+}
+
+void set_tile_bitstream_size(
+    uint8_t          *tile_buffer,
+    const aom_writer *tile_writer)
+{
+    mem_put_le32(tile_buffer, tile_writer->pos - AV1_MIN_TILE_SIZE_BYTES);
+}
+
+uint32_t copy_tile_bitstream(
+    EntropyCoder_t *entropy_coder_ptr,
+    uint32_t        tile_count,
+    uint32_t        tile_idx,
+    EbBool          size_field,
+    uint8_t        *dst)
+{
+    uint8_t  *tileBuffer = get_tile_bitstream_buffer(entropy_coder_ptr, tile_count, tile_idx);
+    uint32_t  tileSize = get_tile_bitstream_size(tileBuffer);
+    uint8_t  *tileData = tileBuffer + AV1_TILE_SIZE_BYTES;
+
+    if (tileSize > get_tile_bitstream_capacity(entropy_coder_ptr, tile_count)) {
+        assert(tile_idx < entropy_coder_ptr->tile_overflow_count);
+        tileData = entropy_coder_ptr->tile_overflow_array[tile_idx].buffer;
+    }
+
+    if (size_field) {
+        memcpy(dst, tileBuffer, AV1_TILE_SIZE_BYTES);
+        dst += AV1_TILE_SIZE_BYTES;
+    }
+    memcpy(dst, tileData, tileSize);
+
+    return size_field ? AV1_TILE_SIZE_BYTES + tileSize : tileSize;
+}
 
 EbPtr EntropyCoderGetBitstreamPtr(
     EntropyCoder_t *entropy_coder_ptr)
@@ -4274,14 +4350,30 @@ EbErrorType WriteFrameHeaderAv1(
         0, n_log2_tiles, tile_start_and_end_present_flag);
 
     if (!showExisting) {
-        // Add data from EC stream to Picture Stream.
-        int32_t frameSize = parentPcsPtr->av1_cm->tile_cols*parentPcsPtr->av1_cm->tile_rows==1 ? pcsPtr->entropy_coder_ptr->ecWriter.pos : pcsPtr->entropy_coder_ptr->ec_frame_size;
+        const uint32_t tileCount = parentPcsPtr->av1_cm->tile_cols * parentPcsPtr->av1_cm->tile_rows;
 
-        OutputBitstreamUnit_t *ecOutputBitstreamPtr = (OutputBitstreamUnit_t*)pcsPtr->entropy_coder_ptr->ecOutputBitstreamPtr;
-        //****************************************************************//
-        // Copy from EC stream to frame stream
-        memcpy(data + currDataSize, ecOutputBitstreamPtr->bufferBeginAv1, frameSize);
-        currDataSize += (frameSize);
+        if (tileCount == 1) {
+            // Add data from EC stream to Picture Stream.
+            int32_t frameSize = pcsPtr->entropy_coder_ptr->ecWriter.pos;
+
+            OutputBitstreamUnit_t *ecOutputBitstreamPtr = (OutputBitstreamUnit_t*)pcsPtr->entropy_coder_ptr->ecOutputBitstreamPtr;
+            //****************************************************************//
+            // Copy from EC stream to frame stream
+            memcpy(data + currDataSize, ecOutputBitstreamPtr->bufferBeginAv1, frameSize);
+            currDataSize += (frameSize);
+        }
+        else {
+            // Stitch the tiles in tile group order. Every tile but the
+            // last one is preceded by its size field.
+            for (uint32_t tileIdx = 0; tileIdx < tileCount; ++tileIdx) {
+                currDataSize += copy_tile_bitstream(
+                    pcsPtr->entropy_coder_ptr,
+                    tileCount,
+                    tileIdx,
+                    (EbBool)(tileIdx < tileCount - 1),
+                    data + currDataSize);
+            }
+        }
     }
     const uint32_t obuPayloadSize = currDataSize - obuHeaderSize;
     const size_t lengthFieldSize =
@@ -4388,6 +4480,7 @@ static void Av1writeDeltaQindex(
 static void write_cdef(
     SequenceControlSet     *seqCSetPtr,
     PictureControlSet_t     *p_pcs_ptr,
+    EntropyCodingContext_t  *context_ptr,
     //Av1Common *cm,
     MacroBlockD *const xd,
     aom_writer *w,
@@ -4415,8 +4508,8 @@ static void write_cdef(
 // Initialise when at top left part of the superblock
     if (!(mi_row & (seqCSetPtr->mib_size - 1)) &&
         !(mi_col & (seqCSetPtr->mib_size - 1))) {  // Top left?
-        p_pcs_ptr->cdef_preset[0] = p_pcs_ptr->cdef_preset[1] = p_pcs_ptr->cdef_preset[2] =
-            p_pcs_ptr->cdef_preset[3] = -1;
+        context_ptr->cdef_preset[0] = context_ptr->cdef_preset[1] = context_ptr->cdef_preset[2] =
+            context_ptr->cdef_preset[3] = -1;
     }
 
     // Emit CDEF param at first non-skip coding block
@@ -4425,9 +4518,9 @@ static void write_cdef(
         ? !!(mi_col & mask) + 2 * !!(mi_row & mask)
         : 0;
 
-    if (p_pcs_ptr->cdef_preset[index] == -1 && !skip) {
+    if (context_ptr->cdef_preset[index] == -1 && !skip) {
         aom_write_literal(w, mi->mbmi.cdef_strength, p_pcs_ptr->parent_pcs_ptr->cdef_bits);
-        p_pcs_ptr->cdef_preset[index] = mi->mbmi.cdef_strength;
+        context_ptr->cdef_preset[index] = mi->mbmi.cdef_strength;
 
 
     }
@@ -4435,10 +4528,10 @@ static void write_cdef(
 }
 
 
-void av1_reset_loop_restoration(PictureControlSet_t     *piCSetPtr) {
+void av1_reset_loop_restoration(EntropyCodingContext_t *context_ptr) {
     for (int32_t p = 0; p < 3; ++p) {
-        set_default_wiener(piCSetPtr->wiener_info + p);
-        set_default_sgrproj(piCSetPtr->sgrproj_info + p);
+        set_default_wiener(context_ptr->wiener_info + p);
+        set_default_sgrproj(context_ptr->sgrproj_info + p);
     }
 }
 static void write_wiener_filter(int32_t wiener_win, const WienerInfo *wiener_info,
@@ -4516,7 +4609,7 @@ static void write_sgrproj_filter(const SgrprojInfo *sgrproj_info,
 
     memcpy(ref_sgrproj_info, sgrproj_info, sizeof(*sgrproj_info));
 }
-static void loop_restoration_write_sb_coeffs(PictureControlSet_t     *piCSetPtr, FRAME_CONTEXT           *frameContext, const Av1Common *const cm,
+static void loop_restoration_write_sb_coeffs(EntropyCodingContext_t  *context_ptr, FRAME_CONTEXT           *frameContext, const Av1Common *const cm,
     //MacroBlockD *xd,
     const RestorationUnitInfo *rui,
     aom_writer *const w, int32_t plane/*,
@@ -4530,8 +4623,8 @@ static void loop_restoration_write_sb_coeffs(PictureControlSet_t     *piCSetPtr,
 //    assert(!cm->all_lossless);
 
     const int32_t wiener_win = (plane > 0) ? WIENER_WIN_CHROMA : WIENER_WIN;
-    WienerInfo *wiener_info = piCSetPtr->wiener_info + plane;
-    SgrprojInfo *sgrproj_info = piCSetPtr->sgrproj_info + plane;
+    WienerInfo *wiener_info = context_ptr->wiener_info + plane;
+    SgrprojInfo *sgrproj_info = context_ptr->sgrproj_info + plane;
     RestorationType unit_rtype = rui->restoration_type;
 
 
@@ -4593,17 +4686,18 @@ EbErrorType ec_update_neighbors(
     EbPictureBufferDesc_t   *coeffPtr)
 {
     UNUSED(coeffPtr);
+    UNUSED(picture_control_set_ptr);
     EbErrorType return_error = EB_ErrorNone;
-    NeighborArrayUnit_t     *mode_type_neighbor_array = picture_control_set_ptr->mode_type_neighbor_array;
-    NeighborArrayUnit_t     *partition_context_neighbor_array = picture_control_set_ptr->partition_context_neighbor_array;
-    NeighborArrayUnit_t     *skip_flag_neighbor_array = picture_control_set_ptr->skip_flag_neighbor_array;
-    NeighborArrayUnit_t     *skip_coeff_neighbor_array = picture_control_set_ptr->skip_coeff_neighbor_array;
-    NeighborArrayUnit_t     *luma_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->luma_dc_sign_level_coeff_neighbor_array;
-    NeighborArrayUnit_t     *cr_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->cr_dc_sign_level_coeff_neighbor_array;
-    NeighborArrayUnit_t     *cb_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->cb_dc_sign_level_coeff_neighbor_array;
-    NeighborArrayUnit_t     *inter_pred_dir_neighbor_array = picture_control_set_ptr->inter_pred_dir_neighbor_array;
-    NeighborArrayUnit_t     *ref_frame_type_neighbor_array = picture_control_set_ptr->ref_frame_type_neighbor_array;
-    NeighborArrayUnit32_t   *interpolation_type_neighbor_array = picture_control_set_ptr->interpolation_type_neighbor_array;
+    NeighborArrayUnit_t     *mode_type_neighbor_array = context_ptr->neighbor_arrays.mode_type_neighbor_array;
+    NeighborArrayUnit_t     *partition_context_neighbor_array = context_ptr->neighbor_arrays.partition_context_neighbor_array;
+    NeighborArrayUnit_t     *skip_flag_neighbor_array = context_ptr->neighbor_arrays.skip_flag_neighbor_array;
+    NeighborArrayUnit_t     *skip_coeff_neighbor_array = context_ptr->neighbor_arrays.skip_coeff_neighbor_array;
+    NeighborArrayUnit_t     *luma_dc_sign_level_coeff_neighbor_array = context_ptr->neighbor_arrays.luma_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t     *cr_dc_sign_level_coeff_neighbor_array = context_ptr->neighbor_arrays.cr_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t     *cb_dc_sign_level_coeff_neighbor_array = context_ptr->neighbor_arrays.cb_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t     *inter_pred_dir_neighbor_array = context_ptr->neighbor_arrays.inter_pred_dir_neighbor_array;
+    NeighborArrayUnit_t     *ref_frame_type_neighbor_array = context_ptr->neighbor_arrays.ref_frame_type_neighbor_array;
+    NeighborArrayUnit32_t   *interpolation_type_neighbor_array = context_ptr->neighbor_arrays.interpolation_type_neighbor_array;
     const BlockGeom         *blk_geom = get_blk_geom_mds(cu_ptr->mds_idx);
     EbBool                   skipCoeff = EB_FALSE;
     PartitionContext         partition;
@@ -4859,16 +4953,16 @@ EbErrorType write_modes_b(
     aom_writer              *ecWriter = &entropy_coder_ptr->ecWriter;
     SequenceControlSet     *sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
 
-    NeighborArrayUnit_t     *mode_type_neighbor_array = picture_control_set_ptr->mode_type_neighbor_array;
-    NeighborArrayUnit_t     *intra_luma_mode_neighbor_array = picture_control_set_ptr->intra_luma_mode_neighbor_array;
-    NeighborArrayUnit_t     *skip_flag_neighbor_array = picture_control_set_ptr->skip_flag_neighbor_array;
-    NeighborArrayUnit_t     *skip_coeff_neighbor_array = picture_control_set_ptr->skip_coeff_neighbor_array;
-    NeighborArrayUnit_t     *luma_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->luma_dc_sign_level_coeff_neighbor_array;
-    NeighborArrayUnit_t     *cr_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->cr_dc_sign_level_coeff_neighbor_array;
-    NeighborArrayUnit_t     *cb_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->cb_dc_sign_level_coeff_neighbor_array;
-    NeighborArrayUnit_t     *inter_pred_dir_neighbor_array = picture_control_set_ptr->inter_pred_dir_neighbor_array;
-    NeighborArrayUnit_t     *ref_frame_type_neighbor_array = picture_control_set_ptr->ref_frame_type_neighbor_array;
-    NeighborArrayUnit32_t   *interpolation_type_neighbor_array = picture_control_set_ptr->interpolation_type_neighbor_array;
+    NeighborArrayUnit_t     *mode_type_neighbor_array = context_ptr->neighbor_arrays.mode_type_neighbor_array;
+    NeighborArrayUnit_t     *intra_luma_mode_neighbor_array = context_ptr->neighbor_arrays.intra_luma_mode_neighbor_array;
+    NeighborArrayUnit_t     *skip_flag_neighbor_array = context_ptr->neighbor_arrays.skip_flag_neighbor_array;
+    NeighborArrayUnit_t     *skip_coeff_neighbor_array = context_ptr->neighbor_arrays.skip_coeff_neighbor_array;
+    NeighborArrayUnit_t     *luma_dc_sign_level_coeff_neighbor_array = context_ptr->neighbor_arrays.luma_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t     *cr_dc_sign_level_coeff_neighbor_array = context_ptr->neighbor_arrays.cr_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t     *cb_dc_sign_level_coeff_neighbor_array = context_ptr->neighbor_arrays.cb_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t     *inter_pred_dir_neighbor_array = context_ptr->neighbor_arrays.inter_pred_dir_neighbor_array;
+    NeighborArrayUnit_t     *ref_frame_type_neighbor_array = context_ptr->neighbor_arrays.ref_frame_type_neighbor_array;
+    NeighborArrayUnit32_t   *interpolation_type_neighbor_array = context_ptr->neighbor_arrays.interpolation_type_neighbor_array;
 
     const BlockGeom          *blk_geom = get_blk_geom_mds(cu_ptr->mds_idx);
     uint32_t blkOriginX = context_ptr->sb_origin_x + blk_geom->origin_x;
@@ -4890,6 +4984,7 @@ EbErrorType write_modes_b(
         write_cdef(
             sequence_control_set_ptr,
             picture_control_set_ptr,
+            context_ptr,
             cu_ptr->av1xd,
             ecWriter,
             skipCoeff,
@@ -5023,6 +5118,7 @@ EbErrorType write_modes_b(
         write_cdef(
             sequence_control_set_ptr,
             picture_control_set_ptr, /*cm,*/
+            context_ptr,
             cu_ptr->av1xd,
             ecWriter,
             cu_ptr->skip_flag ? 1 : skipCoeff,
@@ -5302,7 +5398,7 @@ EB_EXTERN EbErrorType write_sb(
     FRAME_CONTEXT           *frameContext = entropy_coder_ptr->fc;
     aom_writer              *ecWriter = &entropy_coder_ptr->ecWriter;
     SequenceControlSet     *sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
-    NeighborArrayUnit_t     *partition_context_neighbor_array = picture_control_set_ptr->partition_context_neighbor_array;
+    NeighborArrayUnit_t     *partition_context_neighbor_array = context_ptr->neighbor_arrays.partition_context_neighbor_array;
 
     // CU Varaiables
     const BlockGeom          *blk_geom;
@@ -5368,7 +5464,7 @@ EB_EXTERN EbErrorType write_sb(
                                 const int32_t runit_idx = tile_tl_idx + rcol + rrow * rstride;
                                 const RestorationUnitInfo *rui =
                                     &cm->rst_info[plane].unit_info[runit_idx];
-                                loop_restoration_write_sb_coeffs(picture_control_set_ptr, frameContext, cm, /*xd,*/ rui, ecWriter, plane);
+                                loop_restoration_write_sb_coeffs(context_ptr, frameContext, cm, /*xd,*/ rui, ecWriter, plane);
                             }
                         }
                     }
@@ -23,6 +23,11 @@ extern "C" {
         EbPtr           ecOutputBitstreamPtr;
         uint64_t   ec_frame_size;
 
+        // Overflow buffers of the tiles coded into slices of
+        // ecOutputBitstreamPtr, one per tile
+        EbTileOverflow *tile_overflow_array;
+        uint32_t        tile_overflow_count;
+
     } EntropyCoder_t;
 
     extern EbErrorType BitstreamCtor(
@@ -34,10 +39,48 @@ extern "C" {
         EntropyCoder_t **entropyCoderDblPtr,
         uint32_t bufferSize);
 
-
+    // Overflow buffers for up to tile_count tiles, allocated empty
+    extern EbErrorType entropy_coder_tile_overflow_ctor(
+        EntropyCoder_t *entropy_coder_ptr,
+        uint32_t tile_count);
 
     extern EbPtr EntropyCoderGetBitstreamPtr(
         EntropyCoder_t *entropy_coder_ptr);
+
+    /**************************************
+     * Tile Bitstream Buffer
+     **************************************/
+#define AV1_MIN_TILE_SIZE_BYTES         1
+#define AV1_TILE_SIZE_BYTES             4   // size field preceding every tile but the last
+
+    extern uint8_t *get_tile_bitstream_buffer(
+        EntropyCoder_t        *entropy_coder_ptr,
+        uint32_t               tile_count,
+        uint32_t               tile_idx);
+
+    extern uint32_t get_tile_bitstream_size(
+        const uint8_t         *tile_buffer);
+
+    // Room for the data of one tile in its slice
+    extern uint32_t get_tile_bitstream_capacity(
+        EntropyCoder_t        *entropy_coder_ptr,
+        uint32_t               tile_count);
+
+    // Writes the size field of the tile coded by tile_writer, which was
+    // started at tile_buffer + AV1_TILE_SIZE_BYTES
+    extern void set_tile_bitstream_size(
+        uint8_t               *tile_buffer,
+        const aom_writer      *tile_writer);
+
+    // Copies a tile to dst, preceded by its size field if size_field is
+    // set, and returns the bytes written
+    extern uint32_t copy_tile_bitstream(
+        EntropyCoder_t        *entropy_coder_ptr,
+        uint32_t               tile_count,
+        uint32_t               tile_idx,
+        EbBool                 size_field,
+        uint8_t               *dst);
+
 #ifdef __cplusplus
 }
 #endif
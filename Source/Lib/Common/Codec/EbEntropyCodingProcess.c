@@ -20,12 +20,72 @@
 #include "EbEncDecResults.h"
 #include "EbEntropyCodingResults.h"
 #include "EbRateControlTasks.h"
+#include "EbSvtAv1ErrorCodes.h"
 
-#define  AV1_MIN_TILE_SIZE_BYTES 1
-void av1_reset_loop_restoration(PictureControlSet_t     *piCSetPtr);
-void av1_tile_set_col(TileInfo *tile, PictureParentControlSet_t * pcsPtr, int col);
-void av1_tile_set_row(TileInfo *tile, PictureParentControlSet_t * pcsPtr, int row);
+void av1_reset_loop_restoration(EntropyCodingContext_t *context_ptr);
 
+/******************************************************
+ * Entropy Neighbor Arrays Constructor
+ *   Same layout as the picture entropy neighbor arrays
+ ******************************************************/
+static EbErrorType entropy_neighbor_arrays_ctor(
+    EntropyNeighborArrays_t *neighbor_arrays_ptr,
+    uint16_t                 neighbor_array_width,
+    uint16_t                 neighbor_array_height)
+{
+    NeighborArrayUnit_t **byteArrayPtrArray[] = {
+        &neighbor_arrays_ptr->mode_type_neighbor_array,
+        &neighbor_arrays_ptr->skip_flag_neighbor_array,
+        &neighbor_arrays_ptr->skip_coeff_neighbor_array,
+        &neighbor_arrays_ptr->luma_dc_sign_level_coeff_neighbor_array,
+        &neighbor_arrays_ptr->cb_dc_sign_level_coeff_neighbor_array,
+        &neighbor_arrays_ptr->cr_dc_sign_level_coeff_neighbor_array,
+        &neighbor_arrays_ptr->inter_pred_dir_neighbor_array,
+        &neighbor_arrays_ptr->ref_frame_type_neighbor_array,
+        &neighbor_arrays_ptr->intra_luma_mode_neighbor_array };
+    EbErrorType return_error;
+    uint32_t    arrayIndex;
+
+    for (arrayIndex = 0; arrayIndex < sizeof(byteArrayPtrArray) / sizeof(byteArrayPtrArray[0]); ++arrayIndex) {
+        return_error = neighbor_array_unit_ctor(
+            byteArrayPtrArray[arrayIndex],
+            neighbor_array_width,
+            neighbor_array_height,
+            sizeof(uint8_t),
+            PU_NEIGHBOR_ARRAY_GRANULARITY,
+            PU_NEIGHBOR_ARRAY_GRANULARITY,
+            NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
+    return_error = neighbor_array_unit_ctor(
+        &neighbor_arrays_ptr->partition_context_neighbor_array,
+        neighbor_array_width,
+        neighbor_array_height,
+        sizeof(struct PartitionContext),
+        PU_NEIGHBOR_ARRAY_GRANULARITY,
+        PU_NEIGHBOR_ARRAY_GRANULARITY,
+        NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+
+    return_error = neighbor_array_unit_ctor32(
+        &neighbor_arrays_ptr->interpolation_type_neighbor_array,
+        neighbor_array_width,
+        neighbor_array_height,
+        sizeof(uint32_t),
+        PU_NEIGHBOR_ARRAY_GRANULARITY,
+        PU_NEIGHBOR_ARRAY_GRANULARITY,
+        NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+
+    return EB_ErrorNone;
+}
 
 /******************************************************
  * Enc Dec Context Constructor
@@ -35,9 +95,12 @@ EbErrorType entropy_coding_context_ctor(
     EbFifo                *enc_dec_input_fifo_ptr,
     EbFifo                *packetization_output_fifo_ptr,
     EbFifo                *rate_control_output_fifo_ptr,
-    EbBool                  is16bit)
+    EbBool                  is16bit,
+    uint32_t                max_input_luma_width,
+    uint32_t                max_input_luma_height)
 {
     EntropyCodingContext_t *context_ptr;
+    EbErrorType             return_error;
     EB_MALLOC(EntropyCodingContext_t*, context_ptr, sizeof(EntropyCodingContext_t), EB_N_PTR);
     *context_dbl_ptr = context_ptr;
 
@@ -48,32 +111,87 @@ EbErrorType entropy_coding_context_ctor(
     context_ptr->entropy_coding_output_fifo_ptr = packetization_output_fifo_ptr;
     context_ptr->rate_control_output_fifo_ptr = rate_control_output_fifo_ptr;
 
+    // Tile Coding: the tile coder writes into the picture entropy coder
+    // buffer, so it needs no output buffer of its own
+    return_error = EntropyCoderCtor(
+        &context_ptr->tile_entropy_coder_ptr,
+        0);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+
+    return_error = entropy_neighbor_arrays_ctor(
+        &context_ptr->tile_neighbor_arrays,
+        (uint16_t)NEIGHBOR_ARRAY_PICTURE_SIZE(max_input_luma_width),
+        (uint16_t)NEIGHBOR_ARRAY_PICTURE_SIZE(max_input_luma_height));
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+
     return EB_ErrorNone;
 }
 
 /***********************************************
  * Entropy Coding Reset Neighbor Arrays
  ***********************************************/
-static void EntropyCodingResetNeighborArrays(PictureControlSet_t *picture_control_set_ptr)
+static void EntropyCodingResetNeighborArrays(EntropyNeighborArrays_t *neighbor_arrays_ptr)
 {
-    neighbor_array_unit_reset(picture_control_set_ptr->mode_type_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->mode_type_neighbor_array);
 
-    neighbor_array_unit_reset(picture_control_set_ptr->partition_context_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->partition_context_neighbor_array);
 
-    neighbor_array_unit_reset(picture_control_set_ptr->skip_flag_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->skip_flag_neighbor_array);
 
-    neighbor_array_unit_reset(picture_control_set_ptr->skip_coeff_neighbor_array);
-    neighbor_array_unit_reset(picture_control_set_ptr->luma_dc_sign_level_coeff_neighbor_array);
-    neighbor_array_unit_reset(picture_control_set_ptr->cb_dc_sign_level_coeff_neighbor_array);
-    neighbor_array_unit_reset(picture_control_set_ptr->cr_dc_sign_level_coeff_neighbor_array);
-    neighbor_array_unit_reset(picture_control_set_ptr->inter_pred_dir_neighbor_array);
-    neighbor_array_unit_reset(picture_control_set_ptr->ref_frame_type_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->skip_coeff_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->luma_dc_sign_level_coeff_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->cb_dc_sign_level_coeff_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->cr_dc_sign_level_coeff_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->inter_pred_dir_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->ref_frame_type_neighbor_array);
 
-    neighbor_array_unit_reset(picture_control_set_ptr->intra_luma_mode_neighbor_array);
-    neighbor_array_unit_reset32(picture_control_set_ptr->interpolation_type_neighbor_array);
+    neighbor_array_unit_reset(neighbor_arrays_ptr->intra_luma_mode_neighbor_array);
+    neighbor_array_unit_reset32(neighbor_arrays_ptr->interpolation_type_neighbor_array);
     return;
 }
 
+/***********************************************
+ * Entropy Coding Use Picture State
+ *   Points the context at the picture neighbor
+ *   arrays and loop restoration references.
+ ***********************************************/
+static void EntropyCodingUsePictureState(
+    EntropyCodingContext_t  *context_ptr,
+    PictureControlSet_t     *picture_control_set_ptr)
+{
+    EntropyNeighborArrays_t *neighbor_arrays_ptr = &context_ptr->neighbor_arrays;
+
+    neighbor_arrays_ptr->mode_type_neighbor_array = picture_control_set_ptr->mode_type_neighbor_array;
+    neighbor_arrays_ptr->partition_context_neighbor_array = picture_control_set_ptr->partition_context_neighbor_array;
+    neighbor_arrays_ptr->skip_flag_neighbor_array = picture_control_set_ptr->skip_flag_neighbor_array;
+    neighbor_arrays_ptr->skip_coeff_neighbor_array = picture_control_set_ptr->skip_coeff_neighbor_array;
+    neighbor_arrays_ptr->luma_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->luma_dc_sign_level_coeff_neighbor_array;
+    neighbor_arrays_ptr->cb_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->cb_dc_sign_level_coeff_neighbor_array;
+    neighbor_arrays_ptr->cr_dc_sign_level_coeff_neighbor_array = picture_control_set_ptr->cr_dc_sign_level_coeff_neighbor_array;
+    neighbor_arrays_ptr->inter_pred_dir_neighbor_array = picture_control_set_ptr->inter_pred_dir_neighbor_array;
+    neighbor_arrays_ptr->ref_frame_type_neighbor_array = picture_control_set_ptr->ref_frame_type_neighbor_array;
+    neighbor_arrays_ptr->intra_luma_mode_neighbor_array = picture_control_set_ptr->intra_luma_mode_neighbor_array;
+    neighbor_arrays_ptr->interpolation_type_neighbor_array = picture_control_set_ptr->interpolation_type_neighbor_array;
+
+    context_ptr->wiener_info = picture_control_set_ptr->wiener_info;
+    context_ptr->sgrproj_info = picture_control_set_ptr->sgrproj_info;
+}
+
+/***********************************************
+ * Entropy Coding Use Tile State
+ ***********************************************/
+static void EntropyCodingUseTileState(
+    EntropyCodingContext_t  *context_ptr)
+{
+    context_ptr->neighbor_arrays = context_ptr->tile_neighbor_arrays;
+    context_ptr->wiener_info = context_ptr->tile_wiener_info;
+    context_ptr->sgrproj_info = context_ptr->tile_sgrproj_info;
+}
+
 void av1_get_syntax_rate_from_cdf(
     int32_t                      *costs,
     const aom_cdf_prob       *cdf,
@@ -242,7 +360,7 @@ static void ResetEntropyCodingPicture(
         entropyCodingQp,
         picture_control_set_ptr->slice_type);
 
-    EntropyCodingResetNeighborArrays(picture_control_set_ptr);
+    EntropyCodingResetNeighborArrays(&context_ptr->neighbor_arrays);
 
 
     return;
@@ -250,13 +368,15 @@ static void ResetEntropyCodingPicture(
 
 
 static void reset_ec_tile(
-    uint32_t  total_size,
-    uint32_t  is_last_tile_in_tg,
+    uint8_t                 *tile_buffer,
+    uint32_t                 tile_idx,
     EntropyCodingContext_t  *context_ptr,
     PictureControlSet_t     *picture_control_set_ptr,
     SequenceControlSet    *sequence_control_set_ptr)
 {
-    ResetBitstream(EntropyCoderGetBitstreamPtr(picture_control_set_ptr->entropy_coder_ptr));
+    EntropyCoder_t *entropy_coder_ptr = context_ptr->tile_entropy_coder_ptr;
+
+    ResetBitstream(EntropyCoderGetBitstreamPtr(entropy_coder_ptr));
 
     uint32_t                       entropy_coding_qp;
 
@@ -280,10 +400,6 @@ static void reset_ec_tile(
     }
     
     // Reset CABAC Contexts
-    // Reset QP Assignement
-    picture_control_set_ptr->prev_coded_qp = picture_control_set_ptr->picture_qp;
-    picture_control_set_ptr->prev_quant_group_coded_qp = picture_control_set_ptr->picture_qp;
-
 #if ADD_DELTA_QP_SUPPORT //PART 0
     picture_control_set_ptr->parent_pcs_ptr->prev_qindex = picture_control_set_ptr->parent_pcs_ptr->base_qindex;
     if (picture_control_set_ptr->parent_pcs_ptr->allow_intrabc)
@@ -301,30 +417,27 @@ static void reset_ec_tile(
     }
 #endif
 
-    // pass the ent
-    OutputBitstreamUnit_t *outputBitstreamPtr = (OutputBitstreamUnit_t*)(picture_control_set_ptr->entropy_coder_ptr->ecOutputBitstreamPtr);
-    //****************************************************************//
-
-    uint8_t *data = outputBitstreamPtr->bufferAv1 + total_size;
-    picture_control_set_ptr->entropy_coder_ptr->ecWriter.allow_update_cdf = !picture_control_set_ptr->parent_pcs_ptr->large_scale_tile;
-    picture_control_set_ptr->entropy_coder_ptr->ecWriter.allow_update_cdf =
-        picture_control_set_ptr->entropy_coder_ptr->ecWriter.allow_update_cdf && !picture_control_set_ptr->parent_pcs_ptr->disable_cdf_update;
-
+    entropy_coder_ptr->ecWriter.allow_update_cdf = !picture_control_set_ptr->parent_pcs_ptr->large_scale_tile;
+    entropy_coder_ptr->ecWriter.allow_update_cdf =
+        entropy_coder_ptr->ecWriter.allow_update_cdf && !picture_control_set_ptr->parent_pcs_ptr->disable_cdf_update;
 
-    //if not last tile, advance buffer by 4B to leave space for tile Size
-    if (is_last_tile_in_tg == 0)
-        data += 4;
-
-    aom_start_encode(&picture_control_set_ptr->entropy_coder_ptr->ecWriter, data);
+    // advance buffer by 4B to leave space for tile Size
+    aom_start_encode(&entropy_coder_ptr->ecWriter, tile_buffer + AV1_TILE_SIZE_BYTES);
+    entropy_coder_ptr->ecWriter.buffer_size = get_tile_bitstream_capacity(
+        picture_control_set_ptr->entropy_coder_ptr,
+        picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_cols * picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_rows);
+    assert(tile_idx < picture_control_set_ptr->entropy_coder_ptr->tile_overflow_count);
+    entropy_coder_ptr->ecWriter.overflow_ptr = &picture_control_set_ptr->entropy_coder_ptr->tile_overflow_array[tile_idx];
 
     //reset probabilities
     ResetEntropyCoder(
         sequence_control_set_ptr->encode_context_ptr,
-        picture_control_set_ptr->entropy_coder_ptr,
+        entropy_coder_ptr,
         entropy_coding_qp,
         picture_control_set_ptr->slice_type);
 
-    EntropyCodingResetNeighborArrays(picture_control_set_ptr);
+    EntropyCodingUseTileState(context_ptr);
+    EntropyCodingResetNeighborArrays(&context_ptr->neighbor_arrays);
 
 
     return;
@@ -409,6 +522,92 @@ static void EntropyCodingLcu(
     return;
 }
 #endif
+
+/******************************************************
+ * Entropy Coding Tile
+ *
+ * Codes one tile with the tile coder of the context.
+ *   The tile is written in its own slice of the picture
+ *   entropy coder buffer, after its size field, so tiles
+ *   of the same picture can be coded by several threads
+ *   and stitched in tile group order at packetization.
+ *   Every tile starts from the default CDFs and empty
+ *   neighbor arrays, which makes the output identical
+ *   to the one of the serial tile loop.
+ ******************************************************/
+static void EntropyCodingTile(
+    EntropyCodingContext_t  *context_ptr,
+    PictureControlSet_t     *picture_control_set_ptr,
+    SequenceControlSet      *sequence_control_set_ptr,
+    uint32_t                 tile_idx)
+{
+    Av1Common *const cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
+    EntropyCoder_t *entropy_coder_ptr = context_ptr->tile_entropy_coder_ptr;
+    const uint32_t tile_count = cm->tile_cols * cm->tile_rows;
+    const uint32_t tile_row = tile_idx / cm->tile_cols;
+    const uint32_t tile_col = tile_idx % cm->tile_cols;
+    const uint8_t lcuSizeLog2 = (uint8_t)Log2f(context_ptr->sb_sz);
+    const uint32_t picture_width_in_sb = (sequence_control_set_ptr->luma_width + context_ptr->sb_sz - 1) >> lcuSizeLog2;
+    uint8_t *tile_buffer = get_tile_bitstream_buffer(picture_control_set_ptr->entropy_coder_ptr, tile_count, tile_idx);
+    uint64_t tileTotalBits = 0;
+    uint32_t xLcuIndex;
+    uint32_t yLcuIndex;
+    uint32_t tile_size;
+
+    reset_ec_tile(
+        tile_buffer,
+        tile_idx,
+        context_ptr,
+        picture_control_set_ptr,
+        sequence_control_set_ptr);
+
+    av1_reset_loop_restoration(context_ptr);
+
+    for (yLcuIndex = cm->tile_row_start_sb[tile_row]; yLcuIndex < (uint32_t)cm->tile_row_start_sb[tile_row + 1]; ++yLcuIndex)
+    {
+        for (xLcuIndex = cm->tile_col_start_sb[tile_col]; xLcuIndex < (uint32_t)cm->tile_col_start_sb[tile_col + 1]; ++xLcuIndex)
+        {
+            uint16_t sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
+            LargestCodingUnit_t *sb_ptr = picture_control_set_ptr->sb_ptr_array[sb_index];
+            EbPictureBufferDesc_t *coeff_picture_ptr = sb_ptr->quantized_coeff;
+            uint32_t prev_pos = entropy_coder_ptr->ecWriter.ec.offs;
+
+            context_ptr->sb_origin_x = xLcuIndex << lcuSizeLog2;
+            context_ptr->sb_origin_y = yLcuIndex << lcuSizeLog2;
+
+            // Configure the LCU
+            EntropyCodingConfigureLcu(
+                context_ptr,
+                sb_ptr,
+                picture_control_set_ptr);
+
+            write_sb(
+                context_ptr,
+                sb_ptr,
+                picture_control_set_ptr,
+                entropy_coder_ptr,
+                coeff_picture_ptr);
+            sb_ptr->total_bits = (entropy_coder_ptr->ecWriter.ec.offs - prev_pos) << 3;
+            tileTotalBits += sb_ptr->total_bits;
+        }
+    }
+
+    EncodeSliceFinish(entropy_coder_ptr);
+
+    // A tile longer than its slice went to an overflow buffer, empty if it
+    // could not be allocated
+    tile_size = entropy_coder_ptr->ecWriter.pos;
+    CHECK_REPORT_ERROR(
+        (tile_size >= AV1_MIN_TILE_SIZE_BYTES),
+        sequence_control_set_ptr->encode_context_ptr->app_callback_ptr,
+        EB_ENC_EC_ERROR2);
+    set_tile_bitstream_size(tile_buffer, &entropy_coder_ptr->ecWriter);
+
+    eb_block_on_mutex(picture_control_set_ptr->entropy_coding_mutex);
+    picture_control_set_ptr->parent_pcs_ptr->quantized_coeff_num_bits += tileTotalBits;
+    eb_release_mutex(picture_control_set_ptr->entropy_coding_mutex);
+}
+
 /******************************************************
  * Update Entropy Coding Rows
  *
@@ -466,8 +665,8 @@ static EbBool UpdateEntropyCodingRows(
             picture_control_set_ptr->entropy_coding_row_array[i] = EB_TRUE;
         }
 
-        while (picture_control_set_ptr->entropy_coding_row_array[picture_control_set_ptr->entropy_coding_current_available_row] == EB_TRUE &&
-            picture_control_set_ptr->entropy_coding_current_available_row < picture_control_set_ptr->entropy_coding_row_count)
+        while (picture_control_set_ptr->entropy_coding_current_available_row < picture_control_set_ptr->entropy_coding_row_count &&
+            picture_control_set_ptr->entropy_coding_row_array[picture_control_set_ptr->entropy_coding_current_available_row] == EB_TRUE)
         {
             ++picture_control_set_ptr->entropy_coding_current_available_row;
         }
@@ -502,7 +701,9 @@ static EbBool UpdateEntropyCodingRows(
 /******************************************************
  * Entropy Coding Kernel
  ******************************************************/
-void* EntropyCodingKernel(void *input_ptr)
+void EntropyCodingKernel(
+    void            *input_ptr,
+    EbObjectWrapper *restResultsWrapperPtr)
 {
     // Context & SCS & PCS
     EntropyCodingContext_t                  *context_ptr = (EntropyCodingContext_t*)input_ptr;
@@ -510,8 +711,7 @@ void* EntropyCodingKernel(void *input_ptr)
     SequenceControlSet                    *sequence_control_set_ptr;
 
     // Input
-    EbObjectWrapper                       *encDecResultsWrapperPtr;
-    EncDecResults_t                         *encDecResultsPtr;
+    RestResults_t                           *restResultsPtr;
 
     // Output
     EbObjectWrapper                       *entropyCodingResultsWrapperPtr;
@@ -532,306 +732,206 @@ void* EntropyCodingKernel(void *input_ptr)
     uint32_t                                   picture_width_in_sb;
     // Variables
     EbBool                                  initialProcessCall;
-    for (;;) {
-
-        // Get Mode Decision Results
-        eb_get_full_object(
-            context_ptr->enc_dec_input_fifo_ptr,
-            &encDecResultsWrapperPtr);
-        encDecResultsPtr = (EncDecResults_t*)encDecResultsWrapperPtr->object_ptr;
-        picture_control_set_ptr = (PictureControlSet_t*)encDecResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
-        sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+
+    restResultsPtr = (RestResults_t*)restResultsWrapperPtr->object_ptr;
+    picture_control_set_ptr = (PictureControlSet_t*)restResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
+    eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
+    sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
 #if !RC 
-        lastLcuFlag = EB_FALSE;
+    lastLcuFlag = EB_FALSE;
 #endif
-        // SB Constants
+    // SB Constants
 
-        sb_sz = (uint8_t)sequence_control_set_ptr->sb_size_pix;
+    sb_sz = (uint8_t)sequence_control_set_ptr->sb_size_pix;
 
-        lcuSizeLog2 = (uint8_t)Log2f(sb_sz);
-        context_ptr->sb_sz = sb_sz;
-        picture_width_in_sb = (sequence_control_set_ptr->luma_width + sb_sz - 1) >> lcuSizeLog2;
-        if(picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_cols * picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_rows == 1)
+    lcuSizeLog2 = (uint8_t)Log2f(sb_sz);
+    context_ptr->sb_sz = sb_sz;
+    picture_width_in_sb = (sequence_control_set_ptr->luma_width + sb_sz - 1) >> lcuSizeLog2;
+    if(picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_cols * picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_rows == 1)
 
+    {
+        // Rows of a single tile picture share the picture state
+        EntropyCodingUsePictureState(context_ptr, picture_control_set_ptr);
+
+        initialProcessCall = EB_TRUE;
+        yLcuIndex = restResultsPtr->completed_lcu_row_index_start;
+
+        // LCU-loops
+        while (UpdateEntropyCodingRows(picture_control_set_ptr, &yLcuIndex, restResultsPtr->completed_lcu_row_count, &initialProcessCall) == EB_TRUE)
         {
-            initialProcessCall = EB_TRUE;
-            yLcuIndex = encDecResultsPtr->completedLcuRowIndexStart;
+            uint32_t rowTotalBits = 0;
+
+            if (yLcuIndex == 0) {
+                ResetEntropyCodingPicture(
+                    context_ptr,
+                    picture_control_set_ptr,
+                    sequence_control_set_ptr);
+                picture_control_set_ptr->entropy_coding_pic_done = EB_FALSE;
+            }
 
-            // LCU-loops
-            while (UpdateEntropyCodingRows(picture_control_set_ptr, &yLcuIndex, encDecResultsPtr->completedLcuRowCount, &initialProcessCall) == EB_TRUE)
+            for (xLcuIndex = 0; xLcuIndex < picture_width_in_sb; ++xLcuIndex)
             {
-                uint32_t rowTotalBits = 0;
-
-                if (yLcuIndex == 0) {
-                    ResetEntropyCodingPicture(
-                        context_ptr,
-                        picture_control_set_ptr,
-                        sequence_control_set_ptr);
-                    picture_control_set_ptr->entropy_coding_pic_done = EB_FALSE;
-                }
-
-                for (xLcuIndex = 0; xLcuIndex < picture_width_in_sb; ++xLcuIndex)
-                {
 
 
-                    sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
-                    sb_ptr = picture_control_set_ptr->sb_ptr_array[sb_index];
+                sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
+                sb_ptr = picture_control_set_ptr->sb_ptr_array[sb_index];
 
-                    sb_origin_x = xLcuIndex << lcuSizeLog2;
-                    sb_origin_y = yLcuIndex << lcuSizeLog2;
-                    context_ptr->sb_origin_x = sb_origin_x;
-                    context_ptr->sb_origin_y = sb_origin_y;
+                sb_origin_x = xLcuIndex << lcuSizeLog2;
+                sb_origin_y = yLcuIndex << lcuSizeLog2;
+                context_ptr->sb_origin_x = sb_origin_x;
+                context_ptr->sb_origin_y = sb_origin_y;
 #if !RC   
-                    lastLcuFlag = (sb_index == sequence_control_set_ptr->sb_tot_cnt - 1) ? EB_TRUE : EB_FALSE;
+                lastLcuFlag = (sb_index == sequence_control_set_ptr->sb_tot_cnt - 1) ? EB_TRUE : EB_FALSE;
 #endif
-                    if (sb_index == 0)
-                        av1_reset_loop_restoration(picture_control_set_ptr);
-                    // Configure the LCU
-                    EntropyCodingConfigureLcu(
-                        context_ptr,
-                        sb_ptr,
-                        picture_control_set_ptr);
+                if (sb_index == 0)
+                    av1_reset_loop_restoration(context_ptr);
+                // Configure the LCU
+                EntropyCodingConfigureLcu(
+                    context_ptr,
+                    sb_ptr,
+                    picture_control_set_ptr);
 #if RC            
-                    sb_ptr->total_bits = 0;
-                    uint32_t prev_pos = sb_index ? picture_control_set_ptr->entropy_coder_ptr->ecWriter.ec.offs : 0;//residual_bc.pos
-                    EbPictureBufferDesc_t *coeff_picture_ptr = sb_ptr->quantized_coeff;
-                    write_sb(
-                        context_ptr,
-                        sb_ptr,
-                        picture_control_set_ptr,
-                        picture_control_set_ptr->entropy_coder_ptr,
-                        coeff_picture_ptr);
-                    sb_ptr->total_bits = (picture_control_set_ptr->entropy_coder_ptr->ecWriter.ec.offs - prev_pos) << 3;
-                    picture_control_set_ptr->parent_pcs_ptr->quantized_coeff_num_bits += sb_ptr->total_bits;
+                sb_ptr->total_bits = 0;
+                uint32_t prev_pos = sb_index ? picture_control_set_ptr->entropy_coder_ptr->ecWriter.ec.offs : 0;//residual_bc.pos
+                EbPictureBufferDesc_t *coeff_picture_ptr = sb_ptr->quantized_coeff;
+                write_sb(
+                    context_ptr,
+                    sb_ptr,
+                    picture_control_set_ptr,
+                    picture_control_set_ptr->entropy_coder_ptr,
+                    coeff_picture_ptr);
+                sb_ptr->total_bits = (picture_control_set_ptr->entropy_coder_ptr->ecWriter.ec.offs - prev_pos) << 3;
+                picture_control_set_ptr->parent_pcs_ptr->quantized_coeff_num_bits += sb_ptr->total_bits;
 #else
-                    // Entropy Coding
-                    EntropyCodingLcu(
-                        context_ptr,
-                        sb_ptr,
-                        picture_control_set_ptr,
-                        sequence_control_set_ptr,
-                        sb_origin_x,
-                        sb_origin_y,
-                        lastLcuFlag,
-                        0,
-                        0);
+                // Entropy Coding
+                EntropyCodingLcu(
+                    context_ptr,
+                    sb_ptr,
+                    picture_control_set_ptr,
+                    sequence_control_set_ptr,
+                    sb_origin_x,
+                    sb_origin_y,
+                    lastLcuFlag,
+                    0,
+                    0);
 #endif
-                    rowTotalBits += sb_ptr->total_bits;
-                }
-
-                // At the end of each LCU-row, send the updated bit-count to Entropy Coding
-                {
-                    EbObjectWrapper *rateControlTaskWrapperPtr;
-                    RateControlTasks *rateControlTaskPtr;
+                rowTotalBits += sb_ptr->total_bits;
+            }
 
-                    // Get Empty EncDec Results
-                    eb_get_empty_object(
-                        context_ptr->rate_control_output_fifo_ptr,
-                        &rateControlTaskWrapperPtr);
-                    rateControlTaskPtr = (RateControlTasks*)rateControlTaskWrapperPtr->object_ptr;
-                    rateControlTaskPtr->task_type = RC_ENTROPY_CODING_ROW_FEEDBACK_RESULT;
-                    rateControlTaskPtr->picture_number = picture_control_set_ptr->picture_number;
-                    rateControlTaskPtr->row_number = yLcuIndex;
-                    rateControlTaskPtr->bit_count = rowTotalBits;
-
-                    rateControlTaskPtr->picture_control_set_wrapper_ptr = 0;
-                    rateControlTaskPtr->segment_index = ~0u;
-
-                    // Post EncDec Results
-                    eb_post_full_object(rateControlTaskWrapperPtr);
-                }
+            // At the end of each LCU-row, send the updated bit-count to Entropy Coding
+            {
+                EbObjectWrapper *rateControlTaskWrapperPtr;
+                RateControlTasks *rateControlTaskPtr;
+
+                // Get Empty EncDec Results
+                eb_get_empty_object(
+                    context_ptr->rate_control_output_fifo_ptr,
+                    &rateControlTaskWrapperPtr);
+                rateControlTaskPtr = (RateControlTasks*)rateControlTaskWrapperPtr->object_ptr;
+                rateControlTaskPtr->task_type = RC_ENTROPY_CODING_ROW_FEEDBACK_RESULT;
+                rateControlTaskPtr->picture_number = picture_control_set_ptr->picture_number;
+                rateControlTaskPtr->row_number = yLcuIndex;
+                rateControlTaskPtr->bit_count = rowTotalBits;
+
+                rateControlTaskPtr->picture_control_set_wrapper_ptr = 0;
+                rateControlTaskPtr->segment_index = ~0u;
+
+                // Post EncDec Results
+                eb_post_full_object(rateControlTaskWrapperPtr);
+            }
 
-                eb_block_on_mutex(picture_control_set_ptr->entropy_coding_mutex);
-                if (picture_control_set_ptr->entropy_coding_pic_done == EB_FALSE) {
+            eb_block_on_mutex(picture_control_set_ptr->entropy_coding_mutex);
+            if (picture_control_set_ptr->entropy_coding_pic_done == EB_FALSE) {
 
-                    // If the picture is complete, terminate the slice
-                    if (picture_control_set_ptr->entropy_coding_current_row == picture_control_set_ptr->entropy_coding_row_count)
-                    {
-                        uint32_t refIdx;
+                // If the picture is complete, terminate the slice
+                if (picture_control_set_ptr->entropy_coding_current_row == picture_control_set_ptr->entropy_coding_row_count)
+                {
+                    uint32_t refIdx;
 
-                        picture_control_set_ptr->entropy_coding_pic_done = EB_TRUE;
+                    picture_control_set_ptr->entropy_coding_pic_done = EB_TRUE;
 
-                        EncodeSliceFinish(picture_control_set_ptr->entropy_coder_ptr);
+                    EncodeSliceFinish(picture_control_set_ptr->entropy_coder_ptr);
 
-                        // Release the List 0 Reference Pictures
-                        for (refIdx = 0; refIdx < picture_control_set_ptr->parent_pcs_ptr->ref_list0_count; ++refIdx) {
-                            if (picture_control_set_ptr->ref_pic_ptr_array[0] != EB_NULL) {
+                    // Release the List 0 Reference Pictures
+                    for (refIdx = 0; refIdx < picture_control_set_ptr->parent_pcs_ptr->ref_list0_count; ++refIdx) {
+                        if (picture_control_set_ptr->ref_pic_ptr_array[0] != EB_NULL) {
 
-                                eb_release_object(picture_control_set_ptr->ref_pic_ptr_array[0]);
-                            }
+                            eb_release_object(picture_control_set_ptr->ref_pic_ptr_array[0]);
                         }
+                    }
 
-                        // Release the List 1 Reference Pictures
-                        for (refIdx = 0; refIdx < picture_control_set_ptr->parent_pcs_ptr->ref_list1_count; ++refIdx) {
-                            if (picture_control_set_ptr->ref_pic_ptr_array[1] != EB_NULL) {
+                    // Release the List 1 Reference Pictures
+                    for (refIdx = 0; refIdx < picture_control_set_ptr->parent_pcs_ptr->ref_list1_count; ++refIdx) {
+                        if (picture_control_set_ptr->ref_pic_ptr_array[1] != EB_NULL) {
 
-                                eb_release_object(picture_control_set_ptr->ref_pic_ptr_array[1]);
-                            }
+                            eb_release_object(picture_control_set_ptr->ref_pic_ptr_array[1]);
                         }
+                    }
 
-                        // Get Empty Entropy Coding Results
-                        eb_get_empty_object(
-                            context_ptr->entropy_coding_output_fifo_ptr,
-                            &entropyCodingResultsWrapperPtr);
-                        entropyCodingResultsPtr = (EntropyCodingResults_t*)entropyCodingResultsWrapperPtr->object_ptr;
-                        entropyCodingResultsPtr->picture_control_set_wrapper_ptr = encDecResultsPtr->picture_control_set_wrapper_ptr;
-
-                        // Post EntropyCoding Results
-                        eb_post_full_object(entropyCodingResultsWrapperPtr);
-
-                    } // End if(PictureCompleteFlag)
-                }
-                eb_release_mutex(picture_control_set_ptr->entropy_coding_mutex);
+                    // Get Empty Entropy Coding Results
+                    eb_get_empty_object(
+                        context_ptr->entropy_coding_output_fifo_ptr,
+                        &entropyCodingResultsWrapperPtr);
+                    entropyCodingResultsPtr = (EntropyCodingResults_t*)entropyCodingResultsWrapperPtr->object_ptr;
+                    entropyCodingResultsPtr->picture_control_set_wrapper_ptr = restResultsPtr->picture_control_set_wrapper_ptr;
 
+                    // Post EntropyCoding Results
+                    eb_post_full_object(entropyCodingResultsWrapperPtr);
 
+                } // End if(PictureCompleteFlag)
             }
+            eb_release_mutex(picture_control_set_ptr->entropy_coding_mutex);
+
 
         }
-        else
+
+    }
+    else
+    {
+        const uint32_t tile_count = picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_cols * picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_rows;
+        EbBool         pictureDoneFlag;
+
+        EntropyCodingTile(
+            context_ptr,
+            picture_control_set_ptr,
+            sequence_control_set_ptr,
+            restResultsPtr->tile_index);
+
+        eb_block_on_mutex(picture_control_set_ptr->entropy_coding_mutex);
+        pictureDoneFlag = (EbBool)(++picture_control_set_ptr->entropy_coding_tile_done_count == tile_count);
+        eb_release_mutex(picture_control_set_ptr->entropy_coding_mutex);
+
+        // The last tile to finish completes the picture
+        if (pictureDoneFlag)
         {
+            uint32_t refIdx;
 
-             struct PictureParentControlSet_s     *ppcs_ptr = picture_control_set_ptr->parent_pcs_ptr;
-             Av1Common *const cm = ppcs_ptr->av1_cm;           
-             uint32_t total_size = 0;
-             int tile_row, tile_col;
-             const int tile_cols = ppcs_ptr->av1_cm->tile_cols;
-             const int tile_rows = ppcs_ptr->av1_cm->tile_rows;
-
-             //Entropy Tile Loop
-             for (tile_row = 0; tile_row < tile_rows; tile_row++)
-             {
-                 
-                 TileInfo tile_info;
-                 av1_tile_set_row(&tile_info, ppcs_ptr, tile_row);
-
-                 for (tile_col = 0; tile_col < tile_cols; tile_col++)
-                 { 
-                     const int tile_idx = tile_row * tile_cols + tile_col;
-                     uint32_t is_last_tile_in_tg = 0;
-
-                     if ( tile_idx == (tile_cols * tile_rows - 1)) {
-                         is_last_tile_in_tg = 1;                       
-                     }
-                     else {
-                         is_last_tile_in_tg = 0;                        
-                     }
-
-                     reset_ec_tile(
-                         total_size,
-                         is_last_tile_in_tg,
-                         context_ptr,
-                         picture_control_set_ptr,
-                         sequence_control_set_ptr);
-
-                     av1_tile_set_col(&tile_info, ppcs_ptr, tile_col);
-   
-                     av1_reset_loop_restoration(picture_control_set_ptr);
-                   
-                     for (yLcuIndex = cm->tile_row_start_sb[tile_row]; yLcuIndex < (uint32_t)cm->tile_row_start_sb[tile_row + 1]; ++yLcuIndex)
-                     {
-                         for (xLcuIndex = cm->tile_col_start_sb[tile_col]; xLcuIndex < (uint32_t)cm->tile_col_start_sb[tile_col + 1]; ++xLcuIndex)
-                         {
-                             
-                             int sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
-                             sb_ptr = picture_control_set_ptr->sb_ptr_array[sb_index];
-                             sb_origin_x = xLcuIndex << lcuSizeLog2;
-                             sb_origin_y = yLcuIndex << lcuSizeLog2;
-                             context_ptr->sb_origin_x = sb_origin_x;
-                             context_ptr->sb_origin_y = sb_origin_y;
-#if !RC
-                             lastLcuFlag = (sb_index == sequence_control_set_ptr->sb_tot_cnt - 1) ? EB_TRUE : EB_FALSE;
-#endif                            
-                             // Configure the LCU
-                             EntropyCodingConfigureLcu(
-                                 context_ptr,
-                                 sb_ptr,
-                                 picture_control_set_ptr);                           
-#if RC
-                             sb_ptr->total_bits = 0;
-                             uint32_t prev_pos = sb_index ? picture_control_set_ptr->entropy_coder_ptr->ecWriter.ec.offs : 0;//residual_bc.pos
-                             EbPictureBufferDesc_t *coeff_picture_ptr = sb_ptr->quantized_coeff;
-                             write_sb(
-                                 context_ptr,
-                                 sb_ptr,
-                                 picture_control_set_ptr,
-                                 picture_control_set_ptr->entropy_coder_ptr,
-                                 coeff_picture_ptr);
-                             sb_ptr->total_bits = (picture_control_set_ptr->entropy_coder_ptr->ecWriter.ec.offs - prev_pos) << 3;
-                             picture_control_set_ptr->parent_pcs_ptr->quantized_coeff_num_bits += sb_ptr->total_bits;
-#else
-                             // Entropy Coding
-                             EntropyCodingLcu(
-                                 context_ptr,
-                                 sb_ptr,
-                                 picture_control_set_ptr,
-                                 sequence_control_set_ptr,
-                                 sb_origin_x,
-                                 sb_origin_y,
-                                 lastLcuFlag,
-                                 0,
-                                 0);
-#endif
-                         }
-                     }
-                                         
-                     EncodeSliceFinish(picture_control_set_ptr->entropy_coder_ptr);
-                    
-                     int tile_size = picture_control_set_ptr->entropy_coder_ptr->ecWriter.pos;
-                     assert(tile_size >= AV1_MIN_TILE_SIZE_BYTES);
-                    
-                     if (!is_last_tile_in_tg) {
-                         
-                         OutputBitstreamUnit_t *outputBitstreamPtr = (OutputBitstreamUnit_t*)(picture_control_set_ptr->entropy_coder_ptr->ecOutputBitstreamPtr);
-                         uint8_t *buf_data = outputBitstreamPtr->bufferAv1 + total_size;
-                         mem_put_le32(buf_data, tile_size - AV1_MIN_TILE_SIZE_BYTES);
-                     }                   
-
-                     if (is_last_tile_in_tg==0)                     
-                         total_size += 4;                     
-
-                     total_size += tile_size;
-
-                 }
-
-             }
-
-             //the picture is complete, terminate the slice            
-             {
-                 uint32_t refIdx;         
-                 picture_control_set_ptr->entropy_coder_ptr->ec_frame_size = total_size;
-
-                 // Release the List 0 Reference Pictures
-                 for (refIdx = 0; refIdx < picture_control_set_ptr->parent_pcs_ptr->ref_list0_count; ++refIdx) {
-                     if (picture_control_set_ptr->ref_pic_ptr_array[0] != EB_NULL) {
-                         eb_release_object(picture_control_set_ptr->ref_pic_ptr_array[0]);
-                     }
-                 }
-
-                 // Release the List 1 Reference Pictures
-                 for (refIdx = 0; refIdx < picture_control_set_ptr->parent_pcs_ptr->ref_list1_count; ++refIdx) {
-                     if (picture_control_set_ptr->ref_pic_ptr_array[1] != EB_NULL) {
-                         eb_release_object(picture_control_set_ptr->ref_pic_ptr_array[1]);
-                     }
-                 }
-
-                 // Get Empty Entropy Coding Results
-                 eb_get_empty_object(
-                     context_ptr->entropy_coding_output_fifo_ptr,
-                     &entropyCodingResultsWrapperPtr);
-                 entropyCodingResultsPtr = (EntropyCodingResults_t*)entropyCodingResultsWrapperPtr->object_ptr;
-                 entropyCodingResultsPtr->picture_control_set_wrapper_ptr = encDecResultsPtr->picture_control_set_wrapper_ptr;
-
-                 // Post EntropyCoding Results
-                 eb_post_full_object(entropyCodingResultsWrapperPtr);
-
-             } 
+            // Release the List 0 Reference Pictures
+            for (refIdx = 0; refIdx < picture_control_set_ptr->parent_pcs_ptr->ref_list0_count; ++refIdx) {
+                if (picture_control_set_ptr->ref_pic_ptr_array[0] != EB_NULL) {
+                    eb_release_object(picture_control_set_ptr->ref_pic_ptr_array[0]);
+                }
+            }
 
-        }
+            // Release the List 1 Reference Pictures
+            for (refIdx = 0; refIdx < picture_control_set_ptr->parent_pcs_ptr->ref_list1_count; ++refIdx) {
+                if (picture_control_set_ptr->ref_pic_ptr_array[1] != EB_NULL) {
+                    eb_release_object(picture_control_set_ptr->ref_pic_ptr_array[1]);
+                }
+            }
 
-        // Release Mode Decision Results
-        eb_release_object(encDecResultsWrapperPtr);
+            // Get Empty Entropy Coding Results
+            eb_get_empty_object(
+                context_ptr->entropy_coding_output_fifo_ptr,
+                &entropyCodingResultsWrapperPtr);
+            entropyCodingResultsPtr = (EntropyCodingResults_t*)entropyCodingResultsWrapperPtr->object_ptr;
+            entropyCodingResultsPtr->picture_control_set_wrapper_ptr = restResultsPtr->picture_control_set_wrapper_ptr;
 
+            // Post EntropyCoding Results
+            eb_post_full_object(entropyCodingResultsWrapperPtr);
+        }
     }
 
-    return EB_NULL;
+    // Release Rest Results
+    eb_release_object(restResultsWrapperPtr);
 }
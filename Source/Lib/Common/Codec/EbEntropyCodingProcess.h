@@ -19,6 +19,24 @@
 #include "EbNeighborArrays.h"
 #include "EbCodingUnit.h"
 
+/**************************************
+ * Entropy Coding Neighbor Arrays
+ **************************************/
+typedef struct EntropyNeighborArrays_s
+{
+    NeighborArrayUnit_t          *mode_type_neighbor_array;
+    NeighborArrayUnit_t          *partition_context_neighbor_array;
+    NeighborArrayUnit_t          *skip_flag_neighbor_array;
+    NeighborArrayUnit_t          *skip_coeff_neighbor_array;
+    NeighborArrayUnit_t          *luma_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t          *cb_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t          *cr_dc_sign_level_coeff_neighbor_array;
+    NeighborArrayUnit_t          *inter_pred_dir_neighbor_array;
+    NeighborArrayUnit_t          *ref_frame_type_neighbor_array;
+    NeighborArrayUnit_t          *intra_luma_mode_neighbor_array;
+    NeighborArrayUnit32_t        *interpolation_type_neighbor_array;
+} EntropyNeighborArrays_t;
+
 /**************************************
  * Enc Dec Context
  **************************************/
@@ -71,6 +89,20 @@ typedef struct EntropyCodingContext_s
     EbBool                            is16bit; //enable 10 bit encode in CL
     int32_t                           coded_area_sb;
     int32_t                           coded_area_sb_uv;
+
+    // Coding state of the area being coded. SB rows of an untiled picture
+    // use the picture control set arrays, as consecutive rows can be coded
+    // by different contexts; a tile is coded by one context with its own.
+    EntropyNeighborArrays_t           neighbor_arrays;
+    WienerInfo                       *wiener_info;
+    SgrprojInfo                      *sgrproj_info;
+    int32_t                           cdef_preset[4];
+
+    // Tile Coding
+    EntropyCoder_t                   *tile_entropy_coder_ptr;
+    EntropyNeighborArrays_t           tile_neighbor_arrays;
+    WienerInfo                        tile_wiener_info[MAX_MB_PLANE];
+    SgrprojInfo                       tile_sgrproj_info[MAX_MB_PLANE];
 } EntropyCodingContext_t;
 
 /**************************************
@@ -81,8 +113,12 @@ extern EbErrorType entropy_coding_context_ctor(
     EbFifo                *enc_dec_input_fifo_ptr,
     EbFifo                *packetization_output_fifo_ptr,
     EbFifo                *rate_control_output_fifo_ptr,
-    EbBool                   is16bit);
+    EbBool                   is16bit,
+    uint32_t                 max_input_luma_width,
+    uint32_t                 max_input_luma_height);
 
-extern void* EntropyCodingKernel(void *input_ptr);
+extern void EntropyCodingKernel(
+    void            *input_ptr,
+    EbObjectWrapper *restResultsWrapperPtr);
 
 #endif // EbEntropyCodingProcess_h
\ No newline at end of file
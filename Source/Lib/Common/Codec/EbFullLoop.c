@@ -743,6 +743,7 @@ void ProductFullLoop(
     context_ptr->three_quad_energy = 0;
     uint32_t  txb_1d_offset = 0;
     uint32_t txb_itr = 0;
+    candidateBuffer->candidate_ptr->y_txb_full_shape = 0;
     for (txb_itr = 0; txb_itr < context_ptr->blk_geom->txb_count; txb_itr++)
     {
         uint16_t tx_org_x = context_ptr->blk_geom->tx_org_x[txb_itr];
@@ -825,6 +826,15 @@ void ProductFullLoop(
             COMPONENT_LUMA,
             asm_type);
 
+        // Kept for the encode pass, which computes the same distortion when it reuses the txb
+        candidateBuffer->candidate_ptr->y_txb_distortion[txb_itr][DIST_CALC_RESIDUAL] = tuFullDistortion[0][DIST_CALC_RESIDUAL];
+        candidateBuffer->candidate_ptr->y_txb_distortion[txb_itr][DIST_CALC_PREDICTION] = tuFullDistortion[0][DIST_CALC_PREDICTION];
+#if PF_N2_32X32
+        if (pf_md_mode == DEFAULT_SHAPE)
+#else
+        if (context_ptr->pf_md_mode == DEFAULT_SHAPE)
+#endif
+            candidateBuffer->candidate_ptr->y_txb_full_shape |= (uint8_t)(1 << txb_itr);
 
         tuFullDistortion[0][DIST_CALC_RESIDUAL] += context_ptr->three_quad_energy;
         tuFullDistortion[0][DIST_CALC_PREDICTION] += context_ptr->three_quad_energy;
@@ -1892,6 +1902,11 @@ void  d1_non_square_block_decision(
         context_ptr->md_local_cu_unit[context_ptr->blk_geom->sqi_mds].cost = tot_cost;
         context_ptr->md_cu_arr_nsq[context_ptr->blk_geom->sqi_mds].part = from_shape_to_part[context_ptr->blk_geom->shape];
         context_ptr->md_cu_arr_nsq[context_ptr->blk_geom->sqi_mds].best_d1_blk = first_blk_idx;
+        // keep the recon cache slot of the best partition
+        if (context_ptr->blk_geom->sq_size <= (int32_t)BLOCK_SIZE_64) {
+            uint8_t depth = (uint8_t)(LOG2F(context_ptr->blk_geom->sq_size) - 2);
+            context_ptr->md_recon_cache_best_slot[depth] = context_ptr->md_recon_cache_write_slot[depth];
+        }
     }
 
 
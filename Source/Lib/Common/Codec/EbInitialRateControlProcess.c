@@ -1676,6 +1676,7 @@ void* InitialRateControlKernel(void *input_ptr)
 
         inputResultsPtr = (MotionEstimationResults_t*)inputResultsWrapperPtr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
+        eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
 
         segment_index = inputResultsPtr->segment_index;
 
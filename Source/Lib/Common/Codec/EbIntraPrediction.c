@@ -4638,7 +4638,7 @@ EbErrorType AV1IntraPredictionCL(
             if (md_context_ptr->cu_origin_x != 0)
                 memcpy(leftNeighArray + 1, md_context_ptr->luma_recon_neighbor_array->leftArray + md_context_ptr->cu_origin_y, md_context_ptr->blk_geom->bheight * 2);
             if (md_context_ptr->cu_origin_y != 0 && md_context_ptr->cu_origin_x != 0)
-                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->luma_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE + md_context_ptr->cu_origin_x - md_context_ptr->cu_origin_y];
+                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->luma_recon_neighbor_array->topLeftArray[md_context_ptr->luma_recon_neighbor_array->leftArraySize + md_context_ptr->cu_origin_x - md_context_ptr->cu_origin_y];
         }
 
         else if (plane == 1) {
@@ -4650,7 +4650,7 @@ EbErrorType AV1IntraPredictionCL(
                 memcpy(leftNeighArray + 1, md_context_ptr->cb_recon_neighbor_array->leftArray + md_context_ptr->round_origin_y / 2, md_context_ptr->blk_geom->bheight_uv * 2);
 
             if (md_context_ptr->round_origin_y != 0 && md_context_ptr->round_origin_x != 0)
-                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->cb_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE / 2 + md_context_ptr->round_origin_x / 2 - md_context_ptr->round_origin_y / 2];
+                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->cb_recon_neighbor_array->topLeftArray[md_context_ptr->cb_recon_neighbor_array->leftArraySize + md_context_ptr->round_origin_x / 2 - md_context_ptr->round_origin_y / 2];
         }
         else {
             if (md_context_ptr->round_origin_y != 0)
@@ -4662,7 +4662,7 @@ EbErrorType AV1IntraPredictionCL(
                 memcpy(leftNeighArray + 1, md_context_ptr->cr_recon_neighbor_array->leftArray + md_context_ptr->round_origin_y / 2, md_context_ptr->blk_geom->bheight_uv * 2);
 
             if (md_context_ptr->round_origin_y != 0 && md_context_ptr->round_origin_x != 0)
-                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->cr_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE / 2 + md_context_ptr->round_origin_x / 2 - md_context_ptr->round_origin_y / 2];
+                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->cr_recon_neighbor_array->topLeftArray[md_context_ptr->cr_recon_neighbor_array->leftArraySize + md_context_ptr->round_origin_x / 2 - md_context_ptr->round_origin_y / 2];
 
 
         }
@@ -267,6 +267,64 @@ void generate_padding16_bit(
 }
 
 
+/** generate_padding_rows()
+        is used to pad the rows [row_start, row_end) of the target picture, horizontally, then vertically
+        when the rows include the first or the last row of the picture. Padding every row once, in any
+        split of the rows, gives the padding of generate_padding() (generate_padding16_bit() when is16bit).
+ */
+void generate_padding_rows(
+    EbByte  src_pic,                    //output paramter, pointer to the source picture to be padded.
+    uint32_t   src_stride,                 //input paramter, the stride of the source picture to be padded (bytes).
+    uint32_t   original_src_width,          //input paramter, the width of the source picture which excludes the padding (bytes).
+    uint32_t   original_src_height,         //input paramter, the height of the source picture which excludes the padding.
+    uint32_t   padding_width,              //input paramter, the padding width (bytes).
+    uint32_t   padding_height,             //input paramter, the padding height.
+    uint32_t   row_start,                  //input paramter, the first row to pad.
+    uint32_t   row_end,                    //input paramter, the row after the last row to pad.
+    EbBool     is16bit)                    //input paramter, the samples are 16 bit.
+{
+    uint32_t   verticalIdx = row_end - row_start;
+    EbByte  tempSrcPic0;
+    EbByte  tempSrcPic1;
+
+    tempSrcPic0 = src_pic + padding_width + (padding_height + row_start) * src_stride;
+    while (verticalIdx)
+    {
+        // horizontal padding
+        if (is16bit) {
+            memset16bit((uint16_t*)(tempSrcPic0 - padding_width), ((uint16_t*)(tempSrcPic0))[0], padding_width >> 1);
+            memset16bit((uint16_t*)(tempSrcPic0 + original_src_width), ((uint16_t*)(tempSrcPic0 + original_src_width - 2))[0], padding_width >> 1);
+        }
+        else {
+            EB_MEMSET(tempSrcPic0 - padding_width, *tempSrcPic0, padding_width);
+            EB_MEMSET(tempSrcPic0 + original_src_width, *(tempSrcPic0 + original_src_width - 1), padding_width);
+        }
+
+        tempSrcPic0 += src_stride;
+        --verticalIdx;
+    }
+
+    // vertical padding
+    if (row_start == 0) {
+        tempSrcPic0 = src_pic + padding_height * src_stride;
+        tempSrcPic1 = tempSrcPic0;
+        for (verticalIdx = padding_height; verticalIdx; --verticalIdx) {
+            tempSrcPic1 -= src_stride;
+            EB_MEMCPY(tempSrcPic1, tempSrcPic0, sizeof(uint8_t)*src_stride);
+        }
+    }
+    if (row_end == original_src_height) {
+        tempSrcPic0 = src_pic + (padding_height + original_src_height - 1)*src_stride;
+        tempSrcPic1 = tempSrcPic0;
+        for (verticalIdx = padding_height; verticalIdx; --verticalIdx) {
+            tempSrcPic1 += src_stride;
+            EB_MEMCPY(tempSrcPic1, tempSrcPic0, sizeof(uint8_t)*src_stride);
+        }
+    }
+
+    return;
+}
+
 /** pad_input_picture()
 is used to pad the input picture in order to get . The horizontal padding happens first and then the vertical padding.
 */
@@ -124,6 +124,17 @@ extern "C" {
         uint32_t            padding_width,
         uint32_t            padding_height);
 
+    extern void generate_padding_rows(
+        EbByte              src_pic,
+        uint32_t            src_stride,
+        uint32_t            original_src_width,
+        uint32_t            original_src_height,
+        uint32_t            padding_width,
+        uint32_t            padding_height,
+        uint32_t            row_start,
+        uint32_t            row_end,
+        EbBool              is16bit);
+
     extern void pad_input_picture(
         EbByte              src_pic,
         uint32_t            src_stride,
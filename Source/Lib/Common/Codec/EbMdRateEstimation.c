@@ -15,9 +15,11 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "EbDefinitions.h"
 #include "EbMdRateEstimation.h"
+#include "EbThreads.h"
 
 #include "EbBitstreamUnit.h"
 
@@ -80,8 +82,6 @@ void av1_estimate_syntax_rate(
 {
     int32_t i, j;
 
-    md_rate_estimation_array->initialized = 1;
-
     for (i = 0; i < PARTITION_CONTEXTS; ++i)
         av1_get_syntax_rate_from_cdf(md_rate_estimation_array->partitionFacBits[i], fc->partition_cdf[i], NULL);
 
@@ -358,16 +358,14 @@ void av1_estimate_mv_rate(
 {
 
     int32_t *nmvcost[2];
-    int32_t *nmvcost_hp[2];
 
     nmvcost[0] = &md_rate_estimation_array->nmv_costs[0][MV_MAX];
     nmvcost[1] = &md_rate_estimation_array->nmv_costs[1][MV_MAX];
-    nmvcost_hp[0] = &md_rate_estimation_array->nmv_costs_hp[0][MV_MAX];
-    nmvcost_hp[1] = &md_rate_estimation_array->nmv_costs_hp[1][MV_MAX];
 
+    // NM - High precision MVs are hardcoded to off
     av1_build_nmv_cost_table(
         md_rate_estimation_array->nmv_vec_cost,//out
-        /*picture_control_set_ptr->parent_pcs_ptr->allow_high_precision_mv */0 ? nmvcost_hp : nmvcost, //out
+        nmvcost, //out
         nmv_ctx,
         MV_SUBPEL_LOW_PRECISION);
 
@@ -466,49 +464,234 @@ void av1_estimate_coefficients_rate(
     }
 }
 
+/**************************************************************************
+* md_rate_estimation_ctor()
+***************************************************************************/
+EbErrorType md_rate_estimation_ctor(MdRateEstimationContext_t **md_rate_estimation_dbl_ptr)
+{
+    EB_MALLOC(MdRateEstimationContext_t*, *md_rate_estimation_dbl_ptr, sizeof(MdRateEstimationContext_t), EB_N_PTR);
 
+    return EB_ErrorNone;
+}
 
+/**************************************************************************
+* md_rate_estimation_size()
+*   Size of the rates built for a picture, see MdRateEstimationContext_t
+***************************************************************************/
+size_t md_rate_estimation_size(
+    EbBool is_i_slice,
+    EbBool allow_intrabc)
+{
+    if (allow_intrabc)
+        return sizeof(MdRateEstimationContext_t);
+    if (is_i_slice)
+        return offsetof(MdRateEstimationContext_t, nmv_vec_cost);
+    return offsetof(MdRateEstimationContext_t, dv_cost);
+}
 
-EbErrorType MdRateEstimationContextCtor(MdRateEstimationContext_t *md_rate_estimation_array)
+/**************************************************************************
+* md_rate_estimation_cache_ctor()
+***************************************************************************/
+EbErrorType md_rate_estimation_cache_ctor(MdRateEstimationCache_t **cache_dbl_ptr)
 {
-    uint32_t                      caseIndex1;
-    uint32_t                      caseIndex2;
-    uint32_t                      sliceIndex;
-    uint32_t                      qp_index;
-    MdRateEstimationContext_t  *mdRateEstimationTemp;
-
-    uint32_t                      cabacContextModelArrayOffset1 = 0;
-    uint32_t                      cabacContextModelArrayOffset2;
-
-    // Loop over all slice types
-    for (sliceIndex = 0; sliceIndex < TOTAL_NUMBER_OF_SLICE_TYPES; sliceIndex++) {
-
-        cabacContextModelArrayOffset1 = sliceIndex * TOTAL_NUMBER_OF_QP_VALUES;
-        // Loop over all Qps
-        for (qp_index = 0; qp_index < TOTAL_NUMBER_OF_QP_VALUES; qp_index++) {
-
-            cabacContextModelArrayOffset2 = qp_index;
-            mdRateEstimationTemp = (&md_rate_estimation_array[cabacContextModelArrayOffset1 + cabacContextModelArrayOffset2]);
-
-            // Split Flag Bits Table
-            // 0: Symbol = 0 & CtxSplit = 0
-            // 1: Symbol = 0 & CtxSplit = 1
-            // 2: Symbol = 0 & CtxSplit = 2
-            // 3: Symbol = 1 & CtxSplit = 0
-            // 4: Symbol = 1 & CtxSplit = 1
-            // 5: Symbol = 1 & CtxSplit = 2
-            for (caseIndex1 = 0; caseIndex1 < 2; caseIndex1++) {
-                for (caseIndex2 = 0; caseIndex2 < (NUMBER_OF_SPLIT_FLAG_CASES >> 1); caseIndex2++) {
-                    mdRateEstimationTemp->splitFlagBits[(NUMBER_OF_SPLIT_FLAG_CASES >> 1)*caseIndex1 + caseIndex2] = 0;
-                }
-            }
-            for (caseIndex1 = 0; caseIndex1 < NUMBER_OF_MVD_CASES; caseIndex1++) {
-                mdRateEstimationTemp->mvdBits[caseIndex1] = 0;
-            }
+    uint32_t                     entry_index;
+    MdRateEstimationCache_t     *cache_ptr;
+
+    EB_MALLOC(MdRateEstimationCache_t*, cache_ptr, sizeof(MdRateEstimationCache_t), EB_N_PTR);
+    *cache_dbl_ptr = cache_ptr;
+
+    cache_ptr->use_count = 0;
+    cache_ptr->memory_arena = eb_memory_arena_get_current();
+    for (entry_index = 0; entry_index < MD_RATE_ESTIMATION_CACHE_SIZE; ++entry_index) {
+        MdRateEstimationCacheEntry_t *entry_ptr = &cache_ptr->entry_array[entry_index];
+        entry_ptr->key = 0;
+        entry_ptr->last_use = 0;
+        entry_ptr->valid = EB_FALSE;
+        entry_ptr->is_i_slice = EB_FALSE;
+        entry_ptr->allow_intrabc = EB_FALSE;
+        entry_ptr->fc = (FRAME_CONTEXT*)EB_NULL;
+        entry_ptr->md_rate_estimation_ptr = (MdRateEstimationContext_t*)EB_NULL;
+    }
 
-            mdRateEstimationTemp->initialized = 0;
+    EB_CREATEMUTEX(EbHandle, cache_ptr->mutex, sizeof(EbHandle), EB_MUTEX);
 
-        }
+    return EB_ErrorNone;
+}
+
+/**************************************************************************
+* md_rate_estimation_hash()
+*   FNV-1a hash of the frame CDF and of the flags the rates depend on
+***************************************************************************/
+static uint64_t md_rate_estimation_hash(
+    const FRAME_CONTEXT *fc,
+    EbBool               is_i_slice,
+    EbBool               allow_intrabc)
+{
+    const uint8_t   *data = (const uint8_t*)fc;
+    const size_t     size = sizeof(FRAME_CONTEXT);
+    uint64_t         hash = 0xcbf29ce484222325ull;
+    uint64_t         word;
+    size_t           offset;
+
+    for (offset = 0; offset + sizeof(word) <= size; offset += sizeof(word)) {
+        memcpy(&word, data + offset, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ull;
     }
+    for (; offset < size; ++offset)
+        hash = (hash ^ data[offset]) * 0x100000001b3ull;
+
+    hash = (hash ^ (uint64_t)is_i_slice) * 0x100000001b3ull;
+    hash = (hash ^ (uint64_t)allow_intrabc) * 0x100000001b3ull;
+
+    return hash;
+}
+
+/**************************************************************************
+* md_rate_estimation_copy()
+*   Copies the rates built for the picture, and points the MV cost stack
+*   to the copied rates when they include the MV rates
+***************************************************************************/
+static void md_rate_estimation_copy(
+    MdRateEstimationContext_t       *dst,
+    const MdRateEstimationContext_t *src,
+    EbBool                           is_i_slice,
+    EbBool                           allow_intrabc)
+{
+    memcpy(dst, src, md_rate_estimation_size(is_i_slice, allow_intrabc));
+    if (!is_i_slice || allow_intrabc) {
+        dst->nmvcoststack[0] = &dst->nmv_costs[0][MV_MAX];
+        dst->nmvcoststack[1] = &dst->nmv_costs[1][MV_MAX];
+    }
+}
+
+/**************************************************************************
+* md_rate_estimation_cache_entry_alloc()
+*   Allocates the fc and the table of an entry filled for the first time.
+*   Called with the cache mutex held and the memory arena of the cache
+*   current.
+***************************************************************************/
+static EbErrorType md_rate_estimation_cache_entry_alloc(
+    MdRateEstimationCacheEntry_t   *entry_ptr)
+{
+    if (entry_ptr->fc == (FRAME_CONTEXT*)EB_NULL) {
+        EB_MALLOC(FRAME_CONTEXT*, entry_ptr->fc, sizeof(FRAME_CONTEXT), EB_N_PTR);
+    }
+    if (entry_ptr->md_rate_estimation_ptr == (MdRateEstimationContext_t*)EB_NULL)
+        return md_rate_estimation_ctor(&entry_ptr->md_rate_estimation_ptr);
+
     return EB_ErrorNone;
 }
+
+/**************************************************************************
+* md_rate_estimation_cache_find()
+*   Entry built from the same CDF and flags, or NULL. Called with the
+*   cache mutex held.
+***************************************************************************/
+static MdRateEstimationCacheEntry_t *md_rate_estimation_cache_find(
+    MdRateEstimationCache_t        *cache_ptr,
+    uint64_t                        key,
+    EbBool                          is_i_slice,
+    EbBool                          allow_intrabc,
+    const FRAME_CONTEXT            *fc)
+{
+    uint32_t entry_index;
+
+    for (entry_index = 0; entry_index < MD_RATE_ESTIMATION_CACHE_SIZE; ++entry_index) {
+        MdRateEstimationCacheEntry_t *entry_ptr = &cache_ptr->entry_array[entry_index];
+        if (entry_ptr->valid &&
+            entry_ptr->key == key &&
+            entry_ptr->is_i_slice == is_i_slice &&
+            entry_ptr->allow_intrabc == allow_intrabc &&
+            memcmp(entry_ptr->fc, fc, sizeof(FRAME_CONTEXT)) == 0)
+            return entry_ptr;
+    }
+    return NULL;
+}
+
+/**************************************************************************
+* av1_estimate_picture_rate()
+* Estimate the rates of a picture from its frame CDF, or copy them
+* from the cache when a picture with the same CDF built them. fc is
+* the CDF of the coefficient estimation entropy coder, which the intra
+* block copy rates are built from.
+*
+* A miss only builds the rates the picture reads: the MV rates are
+* skipped for the intra pictures without intra block copy, and the intra
+* block copy rates for the other pictures. Within those, the whole table
+* is built up front rather than each field on its first read: MD and
+* EncDec read the rates of the picture from all of their segment threads
+* without any check, so a field built on demand would need a built flag
+* and a lock on every rate lookup.
+***************************************************************************/
+void av1_estimate_picture_rate(
+    MdRateEstimationCache_t        *cache_ptr,
+    PictureControlSet_t            *picture_control_set_ptr,
+    MdRateEstimationContext_t      *md_rate_estimation_array,
+    FRAME_CONTEXT                  *fc)
+{
+    const EbBool    is_i_slice = picture_control_set_ptr->slice_type == I_SLICE ? EB_TRUE : EB_FALSE;
+    const EbBool    allow_intrabc = picture_control_set_ptr->parent_pcs_ptr->allow_intrabc ? EB_TRUE : EB_FALSE;
+    const uint64_t  key = md_rate_estimation_hash(fc, is_i_slice, allow_intrabc);
+    MdRateEstimationCacheEntry_t *entry_ptr;
+    uint32_t        entry_index;
+    EbMemoryArena  *savedArenaPtr;
+    EbErrorType     allocError;
+
+    assert(fc == picture_control_set_ptr->coeff_est_entropy_coder_ptr->fc);
+
+    eb_block_on_mutex(cache_ptr->mutex);
+    entry_ptr = md_rate_estimation_cache_find(cache_ptr, key, is_i_slice, allow_intrabc, fc);
+    if (entry_ptr) {
+        entry_ptr->last_use = ++cache_ptr->use_count;
+        md_rate_estimation_copy(md_rate_estimation_array, entry_ptr->md_rate_estimation_ptr, is_i_slice, allow_intrabc);
+        eb_release_mutex(cache_ptr->mutex);
+        return;
+    }
+    eb_release_mutex(cache_ptr->mutex);
+
+    // Miss: build the rates outside of the lock
+    av1_estimate_syntax_rate(
+        md_rate_estimation_array,
+        is_i_slice,
+        fc);
+    if (!is_i_slice || allow_intrabc) {
+        av1_estimate_mv_rate(
+            picture_control_set_ptr,
+            md_rate_estimation_array,
+            &fc->nmvc);
+    }
+    av1_estimate_coefficients_rate(
+        md_rate_estimation_array,
+        fc);
+
+    eb_block_on_mutex(cache_ptr->mutex);
+    // Another picture with the same CDF may have inserted its rates meanwhile
+    entry_ptr = md_rate_estimation_cache_find(cache_ptr, key, is_i_slice, allow_intrabc, fc);
+    if (entry_ptr)
+        entry_ptr->last_use = ++cache_ptr->use_count;
+    else {
+        // Replace the least recently used entry
+        entry_ptr = &cache_ptr->entry_array[0];
+        for (entry_index = 1; entry_index < MD_RATE_ESTIMATION_CACHE_SIZE; ++entry_index) {
+            MdRateEstimationCacheEntry_t *candidate_ptr = &cache_ptr->entry_array[entry_index];
+            if (!candidate_ptr->valid || (entry_ptr->valid && candidate_ptr->last_use < entry_ptr->last_use))
+                entry_ptr = candidate_ptr;
+        }
+        // The rates are not cached when the entry cannot be allocated
+        savedArenaPtr = eb_memory_arena_set_current(cache_ptr->memory_arena);
+        allocError = md_rate_estimation_cache_entry_alloc(entry_ptr);
+        eb_memory_arena_set_current(savedArenaPtr);
+        if (allocError != EB_ErrorNone) {
+            eb_release_mutex(cache_ptr->mutex);
+            return;
+        }
+        entry_ptr->key = key;
+        entry_ptr->last_use = ++cache_ptr->use_count;
+        entry_ptr->valid = EB_TRUE;
+        entry_ptr->is_i_slice = is_i_slice;
+        entry_ptr->allow_intrabc = allow_intrabc;
+        memcpy(entry_ptr->fc, fc, sizeof(FRAME_CONTEXT));
+        md_rate_estimation_copy(entry_ptr->md_rate_estimation_ptr, md_rate_estimation_array, is_i_slice, allow_intrabc);
+    }
+    eb_release_mutex(cache_ptr->mutex);
+}
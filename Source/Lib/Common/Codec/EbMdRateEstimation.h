@@ -7,6 +7,7 @@
 #define EbMdRateEstimation_h
 
 #include "EbDefinitions.h"
+#include "EbMemoryArena.h"
 #include "EbCabacContextModel.h"
 #include "EbPictureControlSet.h"
 #ifdef __cplusplus
@@ -17,8 +18,7 @@ extern "C" {
      **************************************/
 #define MV_COST_WEIGHT_SUB 120
 
-#define TOTAL_NUMBER_OF_MD_RATE_ESTIMATION_CASE_BUFFERS (TOTAL_NUMBER_OF_QP_VALUES * TOTAL_NUMBER_OF_SLICE_TYPES)
-#define NUMBER_OF_SPLIT_FLAG_CASES                            6       // number of cases for bit estimation for split flag
+#define MD_RATE_ESTIMATION_CACHE_SIZE                         4       // rate tables cached by CDF content
 #define NUMBER_OF_MVD_CASES                                  12       // number of cases for bit estimation for motion vector difference
      // Set to (1 << 5) if the 32-ary codebooks are used for any bock size
 #define MAX_WEDGE_TYPES                                      (1 << 4)
@@ -48,10 +48,15 @@ extern "C" {
 
     /**************************************
      * MD Rate Estimation Structure
+     *   Rates of a picture, built from its CDFs.
+     *   The MV rates and the intra block copy
+     *   rates are last, so the tables of intra
+     *   pictures without intra block copy stop
+     *   before the MV rates, and the tables of
+     *   inter pictures before the intra block
+     *   copy rates. See md_rate_estimation_size.
      **************************************/
     typedef struct MdRateEstimationContext_s {
-        EB_BitFraction  splitFlagBits[NUMBER_OF_SPLIT_FLAG_CASES];
-        EB_BitFraction  mvdBits[NUMBER_OF_MVD_CASES];
         // Partition
         int32_t partitionFacBits[PARTITION_CONTEXTS][CDF_SIZE(EXT_PARTITION_TYPES)];
 
@@ -62,13 +67,6 @@ extern "C" {
         int32_t refMvModeFacBits[REFMV_MODE_CONTEXTS][CDF_SIZE(2)];
         int32_t drlModeFacBits[DRL_MODE_CONTEXTS][CDF_SIZE(2)];
 
-        int32_t nmv_vec_cost[MV_JOINTS];
-        int32_t nmv_costs[2][MV_VALS];
-        int32_t nmv_costs_hp[2][MV_VALS];
-        int32_t *nmvcoststack[2];
-        int dv_cost[2][MV_VALS];
-        int dv_joint_cost[MV_JOINTS];
-
         // Compouned Mode
         int32_t interCompoundModeFacBits[INTER_MODE_CONTEXTS][CDF_SIZE(INTER_COMPOUND_MODES)];
         int32_t compoundTypeFacBits[BlockSizeS_ALL][CDF_SIZE(COMPOUND_TYPES - 1)];
@@ -120,14 +118,49 @@ extern "C" {
         int32_t intraTxTypeFacBits[EXT_TX_SETS_INTRA][EXT_TX_SIZES][INTRA_MODES][CDF_SIZE(TX_TYPES)];
         int32_t interTxTypeFacBits[EXT_TX_SETS_INTER][EXT_TX_SIZES][CDF_SIZE(TX_TYPES)];
         int32_t switchable_interp_FacBitss[SWITCHABLE_FILTER_CONTEXTS][SWITCHABLE_FILTERS];
-        int32_t initialized;
+
+        // Motion Vectors, built for the inter pictures and for the intra
+        // block copy search
+        int32_t nmv_vec_cost[MV_JOINTS];
+        int32_t nmv_costs[2][MV_VALS];
+        int32_t *nmvcoststack[2];
+
+        // Intra Block Copy, built when the picture allows it
+        int dv_cost[2][MV_VALS];
+        int dv_joint_cost[MV_JOINTS];
 
     } MdRateEstimationContext_t;
 
+    /**************************************
+     * MD Rate Estimation Cache
+     *   Tables built last, keyed by the CDFs and
+     *   the picture flags they were built from.
+     *   The fc and the table of an entry are
+     *   allocated when the entry is first filled.
+     **************************************/
+    typedef struct MdRateEstimationCacheEntry_s {
+        uint64_t                        key;            // hash of fc and of the flags
+        uint64_t                        last_use;
+        EbBool                          valid;
+        EbBool                          is_i_slice;
+        EbBool                          allow_intrabc;
+        FRAME_CONTEXT                  *fc;
+        MdRateEstimationContext_t      *md_rate_estimation_ptr;
+    } MdRateEstimationCacheEntry_t;
+
+    typedef struct MdRateEstimationCache_s {
+        EbHandle                        mutex;
+        uint64_t                        use_count;
+        EbMemoryArena                  *memory_arena;   // arena the entries are allocated from
+        MdRateEstimationCacheEntry_t    entry_array[MD_RATE_ESTIMATION_CACHE_SIZE];
+    } MdRateEstimationCache_t;
+
     /**************************************
     * Extern Function Declarations
     **************************************/
-    extern EbErrorType MdRateEstimationContextCtor(MdRateEstimationContext_t *md_rate_estimation_array);
+    extern EbErrorType md_rate_estimation_ctor(MdRateEstimationContext_t **md_rate_estimation_dbl_ptr);
+    extern EbErrorType md_rate_estimation_cache_ctor(MdRateEstimationCache_t **cache_dbl_ptr);
+    extern size_t md_rate_estimation_size(EbBool is_i_slice, EbBool allow_intrabc);
     /***************************************************************************
     * AV1 Probability table
     * // round(-log2(i/256.) * (1 << AV1_PROB_COST_SHIFT)); i = 128~255.
@@ -323,6 +356,16 @@ extern "C" {
         struct PictureControlSet_s     *picture_control_set_ptr,
         MdRateEstimationContext_t  *md_rate_estimation_array,
         nmv_context                *nmv_ctx);
+    /**************************************************************************
+    * av1_estimate_picture_rate()
+    * Estimate the rates of a picture from its frame CDF, or copy them
+    * from the cache when a picture with the same CDF built them
+    ***************************************************************************/
+    extern void av1_estimate_picture_rate(
+        MdRateEstimationCache_t        *cache_ptr,
+        struct PictureControlSet_s     *picture_control_set_ptr,
+        MdRateEstimationContext_t      *md_rate_estimation_array,
+        FRAME_CONTEXT                  *fc);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,409 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "EbMemoryArena.h"
+#include "EbThreads.h"
+
+#define MEMORY_ARENA_CHUNK_HEADER_SIZE  64          // keeps the first allocation aligned
+#define MEMORY_ARENA_MIN_ALIGNMENT      16          // as malloc on x86-64
+
+// Arena the allocation macros use on the calling thread
+static EB_THREAD_LOCAL EbMemoryArena *current_arena = (EbMemoryArena*)EB_NULL;
+static EB_THREAD_LOCAL uint64_t       thread_allocated_size = 0;
+
+/**************************************
+ * ArenaLock
+ **************************************/
+static void ArenaLock(
+    EbMemoryArena *arena_ptr)
+{
+    while (!eb_atomic_cas_32(&arena_ptr->lock, 0, 1))
+        eb_cpu_pause();
+}
+
+static void ArenaUnlock(
+    EbMemoryArena *arena_ptr)
+{
+    eb_atomic_store_32(&arena_ptr->lock, 0);
+}
+
+/**************************************
+ * ArenaMap
+ *   Maps map_size bytes, a multiple of
+ *   MEMORY_ARENA_HUGE_PAGE_SIZE, aligned
+ *   on MEMORY_ARENA_HUGE_PAGE_SIZE so that
+ *   transparent huge pages can back it.
+ *   The memory is zeroed.
+ **************************************/
+static EbByte ArenaMap(
+    size_t map_size)
+{
+#ifdef _WIN32
+    // Large pages need SeLockMemoryPrivilege, which encoders rarely run with
+    return (EbByte)VirtualAlloc(NULL, map_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    EbByte    mapPtr;
+    size_t    headSize;
+    size_t    tailSize;
+    uintptr_t alignedAddress;
+
+    // Over map by one huge page, then trim to an aligned range
+    mapPtr = (EbByte)mmap(NULL, map_size + MEMORY_ARENA_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapPtr == (EbByte)MAP_FAILED)
+        return (EbByte)EB_NULL;
+
+    alignedAddress = ((uintptr_t)mapPtr + MEMORY_ARENA_HUGE_PAGE_SIZE - 1) & ~((uintptr_t)MEMORY_ARENA_HUGE_PAGE_SIZE - 1);
+    headSize = (size_t)(alignedAddress - (uintptr_t)mapPtr);
+    tailSize = MEMORY_ARENA_HUGE_PAGE_SIZE - headSize;
+    if (headSize)
+        munmap(mapPtr, headSize);
+    if (tailSize)
+        munmap((EbByte)alignedAddress + map_size, tailSize);
+
+#ifdef MADV_HUGEPAGE
+    madvise((void*)alignedAddress, map_size, MADV_HUGEPAGE);
+#endif
+    return (EbByte)alignedAddress;
+#endif
+}
+
+static void ArenaUnmap(
+    EbByte map_ptr,
+    size_t map_size)
+{
+#ifdef _WIN32
+    (void)map_size;
+    VirtualFree(map_ptr, 0, MEM_RELEASE);
+#else
+    munmap(map_ptr, map_size);
+#endif
+}
+
+/**************************************
+ * ArenaAddChunk
+ *   Maps a chunk with room for size
+ *   bytes. Chunks for one big allocation
+ *   are linked after the current chunk,
+ *   which stays current.
+ **************************************/
+static EbMemoryArenaChunk *ArenaAddChunk(
+    EbMemoryArena *arena_ptr,
+    size_t         size,
+    EbBool         dedicated)
+{
+    EbMemoryArenaChunk *chunkPtr;
+    size_t              mapSize;
+
+    mapSize = MEMORY_ARENA_CHUNK_HEADER_SIZE + size;
+    if (!dedicated && mapSize < MEMORY_ARENA_CHUNK_SIZE)
+        mapSize = MEMORY_ARENA_CHUNK_SIZE;
+    mapSize = (mapSize + MEMORY_ARENA_HUGE_PAGE_SIZE - 1) & ~((size_t)MEMORY_ARENA_HUGE_PAGE_SIZE - 1);
+
+    chunkPtr = (EbMemoryArenaChunk*)ArenaMap(mapSize);
+    if (chunkPtr == (EbMemoryArenaChunk*)EB_NULL)
+        return (EbMemoryArenaChunk*)EB_NULL;
+
+    chunkPtr->map_size = mapSize;
+    chunkPtr->used_size = MEMORY_ARENA_CHUNK_HEADER_SIZE;
+
+    if (dedicated && arena_ptr->chunk_ptr) {
+        chunkPtr->next_ptr = arena_ptr->chunk_ptr->next_ptr;
+        arena_ptr->chunk_ptr->next_ptr = chunkPtr;
+    }
+    else {
+        chunkPtr->next_ptr = arena_ptr->chunk_ptr;
+        arena_ptr->chunk_ptr = chunkPtr;
+    }
+
+    arena_ptr->reserved_size += mapSize;
+
+    return chunkPtr;
+}
+
+/**************************************
+ * ArenaAccount
+ *   Adds an allocation to the accounting
+ *   of its type.
+ **************************************/
+static void ArenaAccount(
+    EbMemoryArena *arena_ptr,
+    const char    *type_name,
+    uint64_t       size)
+{
+    uint32_t    hash = 2166136261u;
+    uint32_t    typeIndex;
+    const char *namePtr;
+
+    for (namePtr = type_name; *namePtr; ++namePtr)
+        hash = (hash ^ (uint8_t)*namePtr) * 16777619u;
+
+    // Open addressing; the types past the table size share the last lookup slot
+    for (typeIndex = 0; typeIndex < MEMORY_ARENA_TYPE_COUNT; ++typeIndex) {
+        EbMemoryArenaType *typePtr = &arena_ptr->type_array[(hash + typeIndex) & (MEMORY_ARENA_TYPE_COUNT - 1)];
+
+        if (typePtr->type_name == (const char*)EB_NULL) {
+            typePtr->type_name = type_name;
+            ++arena_ptr->type_count;
+        }
+        if (typePtr->type_name == type_name || strcmp(typePtr->type_name, type_name) == 0 || typeIndex == MEMORY_ARENA_TYPE_COUNT - 1) {
+            ++typePtr->allocation_count;
+            typePtr->size += size;
+            break;
+        }
+    }
+}
+
+/**************************************
+ * eb_memory_arena_ctor
+ **************************************/
+EbErrorType eb_memory_arena_ctor(
+    EbMemoryArena  **arena_dbl_ptr)
+{
+    EbMemoryArena *arena_ptr = (EbMemoryArena*)calloc(1, sizeof(EbMemoryArena));
+
+    *arena_dbl_ptr = arena_ptr;
+    if (arena_ptr == (EbMemoryArena*)EB_NULL)
+        return EB_ErrorInsufficientResources;
+
+    arena_ptr->committed_size = sizeof(EbMemoryArena);
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * eb_memory_arena_dtor
+ **************************************/
+void eb_memory_arena_dtor(
+    EbMemoryArena   *arena_ptr)
+{
+    EbMemoryArenaHandleBlock *blockPtr;
+    EbMemoryArenaChunk       *chunkPtr;
+    EbMemoryArenaChunk       *nextChunkPtr;
+    int32_t                   handleIndex;
+
+    if (arena_ptr == (EbMemoryArena*)EB_NULL)
+        return;
+
+    // The threads may still wait on the semaphores and mutexes
+    for (blockPtr = arena_ptr->handle_block_ptr; blockPtr; blockPtr = blockPtr->next_ptr) {
+        for (handleIndex = (int32_t)blockPtr->handle_count - 1; handleIndex >= 0; --handleIndex) {
+            if (blockPtr->type_array[handleIndex] == EB_THREAD)
+                eb_destroy_thread(blockPtr->handle_array[handleIndex]);
+        }
+    }
+    for (blockPtr = arena_ptr->handle_block_ptr; blockPtr; blockPtr = blockPtr->next_ptr) {
+        for (handleIndex = (int32_t)blockPtr->handle_count - 1; handleIndex >= 0; --handleIndex) {
+            if (blockPtr->type_array[handleIndex] == EB_SEMAPHORE)
+                eb_destroy_semaphore(blockPtr->handle_array[handleIndex]);
+            else if (blockPtr->type_array[handleIndex] == EB_MUTEX)
+                eb_destroy_mutex(blockPtr->handle_array[handleIndex]);
+        }
+    }
+
+    // The handle blocks live in the chunks
+    for (chunkPtr = arena_ptr->chunk_ptr; chunkPtr; chunkPtr = nextChunkPtr) {
+        nextChunkPtr = chunkPtr->next_ptr;
+        ArenaUnmap((EbByte)chunkPtr, chunkPtr->map_size);
+    }
+
+    if (current_arena == arena_ptr)
+        current_arena = (EbMemoryArena*)EB_NULL;
+
+    free(arena_ptr);
+}
+
+/**************************************
+ * eb_memory_arena_set_current
+ **************************************/
+EbMemoryArena *eb_memory_arena_set_current(
+    EbMemoryArena   *arena_ptr)
+{
+    EbMemoryArena *previousArenaPtr = current_arena;
+
+    current_arena = arena_ptr;
+
+    return previousArenaPtr;
+}
+
+EbMemoryArena *eb_memory_arena_get_current(void)
+{
+    return current_arena;
+}
+
+uint64_t eb_memory_arena_thread_size(void)
+{
+    return thread_allocated_size;
+}
+
+/**************************************
+ * ArenaAlloc
+ *   Called with the arena locked.
+ **************************************/
+static EbPtr ArenaAlloc(
+    EbMemoryArena *arena_ptr,
+    size_t         size,
+    size_t         alignment)
+{
+    EbMemoryArenaChunk *chunkPtr = arena_ptr->chunk_ptr;
+    size_t              offset;
+
+    if (size > MEMORY_ARENA_CHUNK_SIZE / 4) {
+        chunkPtr = ArenaAddChunk(arena_ptr, size, EB_TRUE);
+        if (chunkPtr == (EbMemoryArenaChunk*)EB_NULL)
+            return EB_NULL;
+    }
+    else if (chunkPtr == (EbMemoryArenaChunk*)EB_NULL ||
+        ((chunkPtr->used_size + alignment - 1) & ~(alignment - 1)) + size > chunkPtr->map_size) {
+        chunkPtr = ArenaAddChunk(arena_ptr, size, EB_FALSE);
+        if (chunkPtr == (EbMemoryArenaChunk*)EB_NULL)
+            return EB_NULL;
+    }
+
+    offset = (chunkPtr->used_size + alignment - 1) & ~(alignment - 1);
+    chunkPtr->used_size = offset + size;
+
+    return (EbByte)chunkPtr + offset;
+}
+
+/**************************************
+ * eb_memory_arena_malloc
+ *   Backs EB_MALLOC, EB_CALLOC and
+ *   EB_ALLIGN_MALLOC. The memory of a new
+ *   mapping is zeroed and never reused,
+ *   so EB_CALLOC needs no memset.
+ **************************************/
+EbPtr eb_memory_arena_malloc(
+    size_t         size,
+    EbPtrType      ptr_type,
+    const char    *type_name)
+{
+    EbMemoryArena *arena_ptr = current_arena;
+    EbPtr          ptr;
+    uint64_t       accountedSize = (size + 7) & ~(size_t)7;
+
+    if (arena_ptr == (EbMemoryArena*)EB_NULL)
+        return EB_NULL;
+
+    ArenaLock(arena_ptr);
+
+    ptr = ArenaAlloc(
+        arena_ptr,
+        size ? size : 1,
+        ptr_type == EB_A_PTR ? ALVALUE : MEMORY_ARENA_MIN_ALIGNMENT);
+    if (ptr) {
+        arena_ptr->committed_size += accountedSize;
+        ArenaAccount(arena_ptr, type_name, accountedSize);
+    }
+
+    ArenaUnlock(arena_ptr);
+
+    if (ptr)
+        thread_allocated_size += accountedSize;
+
+    return ptr;
+}
+
+/**************************************
+ * eb_memory_arena_add_handle
+ *   Backs EB_CREATETHREAD, EB_CREATEMUTEX
+ *   and EB_CREATESEMAPHORE.
+ **************************************/
+EbErrorType eb_memory_arena_add_handle(
+    EbHandle       handle,
+    EbPtrType      ptr_type,
+    const char    *type_name,
+    size_t         size)
+{
+    EbMemoryArena            *arena_ptr = current_arena;
+    EbMemoryArenaHandleBlock *blockPtr;
+    EbErrorType               return_error = EB_ErrorNone;
+    uint64_t                  accountedSize = (size + 7) & ~(size_t)7;
+
+    if (arena_ptr == (EbMemoryArena*)EB_NULL)
+        return EB_ErrorInsufficientResources;
+
+    ArenaLock(arena_ptr);
+
+    blockPtr = arena_ptr->handle_block_ptr;
+    if (blockPtr == (EbMemoryArenaHandleBlock*)EB_NULL || blockPtr->handle_count == MEMORY_ARENA_HANDLE_COUNT) {
+        blockPtr = (EbMemoryArenaHandleBlock*)ArenaAlloc(arena_ptr, sizeof(EbMemoryArenaHandleBlock), MEMORY_ARENA_MIN_ALIGNMENT);
+        if (blockPtr) {
+            blockPtr->handle_count = 0;
+            blockPtr->next_ptr = arena_ptr->handle_block_ptr;
+            arena_ptr->handle_block_ptr = blockPtr;
+            arena_ptr->committed_size += sizeof(EbMemoryArenaHandleBlock);
+        }
+    }
+
+    if (blockPtr) {
+        blockPtr->handle_array[blockPtr->handle_count] = handle;
+        blockPtr->type_array[blockPtr->handle_count] = ptr_type;
+        ++blockPtr->handle_count;
+        arena_ptr->committed_size += accountedSize;
+        ArenaAccount(arena_ptr, type_name, accountedSize);
+    }
+    else
+        return_error = EB_ErrorInsufficientResources;
+
+    ArenaUnlock(arena_ptr);
+
+    if (blockPtr)
+        thread_allocated_size += accountedSize;
+
+    return return_error;
+}
+
+/**************************************
+ * eb_memory_arena_committed_size
+ **************************************/
+uint64_t eb_memory_arena_committed_size(void)
+{
+    return current_arena ? current_arena->committed_size : 0;
+}
+
+/**************************************
+ * eb_memory_arena_get_types
+ **************************************/
+uint32_t eb_memory_arena_get_types(
+    EbMemoryArena      *arena_ptr,
+    EbMemoryArenaType  *type_array,
+    uint32_t            max_count)
+{
+    uint32_t typeIndex;
+    uint32_t typeCount = 0;
+    uint32_t insertIndex;
+
+    ArenaLock(arena_ptr);
+
+    // Insertion sort, biggest first, of the max_count biggest types
+    for (typeIndex = 0; typeIndex < MEMORY_ARENA_TYPE_COUNT; ++typeIndex) {
+        const EbMemoryArenaType *typePtr = &arena_ptr->type_array[typeIndex];
+
+        if (typePtr->type_name == (const char*)EB_NULL)
+            continue;
+
+        insertIndex = typeCount < max_count ? typeCount++ : max_count;
+        while (insertIndex > 0 && type_array[insertIndex - 1].size < typePtr->size) {
+            if (insertIndex < max_count)
+                type_array[insertIndex] = type_array[insertIndex - 1];
+            --insertIndex;
+        }
+        if (insertIndex < max_count)
+            type_array[insertIndex] = *typePtr;
+    }
+
+    ArenaUnlock(arena_ptr);
+
+    return typeCount;
+}
@@ -0,0 +1,130 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbMemoryArena_h
+#define EbMemoryArena_h
+
+#include "EbDefinitions.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+    /*********************************
+     * Defines
+     *********************************/
+#define MEMORY_ARENA_CHUNK_SIZE         (64 << 20)  // bytes mapped at once
+#define MEMORY_ARENA_HUGE_PAGE_SIZE     (2 << 20)   // chunk size and alignment granularity
+#define MEMORY_ARENA_TYPE_COUNT         512         // distinct allocation types, power of 2
+#define MEMORY_ARENA_HANDLE_COUNT       1024        // handles per handle block
+
+    /*********************************************************************
+     * MemoryArenaChunk
+     *   Header at the start of each mapping. Allocations bigger than a
+     *   quarter of MEMORY_ARENA_CHUNK_SIZE get a chunk of their own.
+     *********************************************************************/
+    typedef struct EbMemoryArenaChunk
+    {
+        struct EbMemoryArenaChunk *next_ptr;
+        size_t                     map_size;
+        size_t                     used_size;
+
+    } EbMemoryArenaChunk;
+
+    /*********************************************************************
+     * MemoryArenaHandleBlock
+     *   Threads, semaphores and mutexes to destroy with the arena.
+     *********************************************************************/
+    typedef struct EbMemoryArenaHandleBlock
+    {
+        struct EbMemoryArenaHandleBlock *next_ptr;
+        uint32_t                         handle_count;
+        EbHandle                         handle_array[MEMORY_ARENA_HANDLE_COUNT];
+        EbPtrType                        type_array[MEMORY_ARENA_HANDLE_COUNT];
+
+    } EbMemoryArenaHandleBlock;
+
+    /*********************************************************************
+     * MemoryArenaType
+     *   Accounting of the allocations made for one type, keyed by the
+     *   type name the allocation macros pass (e.g. "EbPictureBufferDesc_t*").
+     *********************************************************************/
+    typedef struct EbMemoryArenaType
+    {
+        const char              *type_name;
+        uint64_t                 allocation_count;
+        uint64_t                 size;
+
+    } EbMemoryArenaType;
+
+    /*********************************************************************
+     * MemoryArena
+     *   Owns every allocation and handle of one encoder instance. Memory
+     *   is bump allocated from huge page backed chunks and never freed
+     *   individually: eb_memory_arena_dtor releases it all at once.
+     *********************************************************************/
+    typedef struct EbMemoryArena
+    {
+        // Concurrent allocations, i.e. pools growing from encoder threads
+        volatile int32_t           lock;
+
+        EbMemoryArenaChunk        *chunk_ptr;          // current chunk first
+        EbMemoryArenaHandleBlock  *handle_block_ptr;   // current block first
+
+        uint64_t                   committed_size;     // bytes handed out
+        uint64_t                   reserved_size;      // bytes mapped
+
+        uint32_t                   type_count;
+        EbMemoryArenaType          type_array[MEMORY_ARENA_TYPE_COUNT];
+
+    } EbMemoryArena;
+
+    /*********************************************************************
+     * eb_memory_arena_ctor
+     *   The arena itself is malloc'd, its chunks are mapped on demand.
+     *********************************************************************/
+    extern EbErrorType eb_memory_arena_ctor(
+        EbMemoryArena  **arena_dbl_ptr);
+
+    /*********************************************************************
+     * eb_memory_arena_dtor
+     *   Destroys the threads, then the semaphores and mutexes, then
+     *   unmaps the chunks and frees the arena. The cost depends on the
+     *   number of chunks and handles, not on the number of allocations.
+     *********************************************************************/
+    extern void eb_memory_arena_dtor(
+        EbMemoryArena   *arena_ptr);
+
+    /*********************************************************************
+     * eb_memory_arena_set_current
+     *   Selects the arena the allocation macros use on the calling
+     *   thread and returns the previous one. Threads created with
+     *   eb_create_thread start with the arena of their creator.
+     *********************************************************************/
+    extern EbMemoryArena *eb_memory_arena_set_current(
+        EbMemoryArena   *arena_ptr);
+
+    extern EbMemoryArena *eb_memory_arena_get_current(void);
+
+    /*********************************************************************
+     * eb_memory_arena_thread_size
+     *   Bytes allocated so far by the calling thread, from any arena.
+     *   The difference of two calls is the size of what the thread
+     *   allocated in between, whatever the other threads did.
+     *********************************************************************/
+    extern uint64_t eb_memory_arena_thread_size(void);
+
+    /*********************************************************************
+     * eb_memory_arena_get_types
+     *   Copies the accounting of up to max_count types, biggest first,
+     *   and returns the number of types copied.
+     *********************************************************************/
+    extern uint32_t eb_memory_arena_get_types(
+        EbMemoryArena      *arena_ptr,
+        EbMemoryArenaType  *type_array,
+        uint32_t            max_count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //EbMemoryArena_h
@@ -116,6 +116,8 @@ extern "C" {
         TxType                                 transform_type[PLANE_TYPES];
         MacroblockPlane                        candidate_plane[MAX_MB_PLANE];
         uint16_t                               eob[MAX_MB_PLANE][MAX_TXB_COUNT];
+        uint64_t                               y_txb_distortion[MAX_TXB_COUNT][DIST_CALC_TOTAL]; // full loop luma distortion before the tx scale shift
+        uint8_t                                y_txb_full_shape;           // bit per txb, set when the txb was transformed at DEFAULT_SHAPE
         int32_t                                quantized_dc[3];
         uint32_t                               interp_filters;
         uint8_t                                tu_width;
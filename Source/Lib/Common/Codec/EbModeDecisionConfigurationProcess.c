@@ -27,6 +27,8 @@
 #include "EbReferenceObject.h"
 #include "EbModeDecisionProcess.h"
 #include "av1me.h"
+#include "EbEncDecSegments.h"
+#include "EbSvtAv1ErrorCodes.h"
 
 
 #define MAX_MESH_SPEED 5  // Max speed setting for mesh motion method
@@ -726,7 +728,8 @@ void AdaptiveDlfParameterComputation(
 EbErrorType ModeDecisionConfigurationContextCtor(
     ModeDecisionConfigurationContext_t **context_dbl_ptr,
     EbFifo                            *rateControlInputFifoPtr,
-
+    EbFifo                            *mdcFeedbackFifoPtr,
+    EbFifo                            *intrabcHashBuffersFifoPtr,
     EbFifo                            *modeDecisionConfigurationOutputFifoPtr,
     uint16_t                                 sb_total_count)
 
@@ -739,9 +742,11 @@ EbErrorType ModeDecisionConfigurationContextCtor(
 
     // Input/Output System Resource Manager FIFOs
     context_ptr->rateControlInputFifoPtr = rateControlInputFifoPtr;
+    context_ptr->mdcFeedbackFifoPtr = mdcFeedbackFifoPtr;
+    context_ptr->intrabcHashBuffersFifoPtr = intrabcHashBuffersFifoPtr;
     context_ptr->modeDecisionConfigurationOutputFifoPtr = modeDecisionConfigurationOutputFifoPtr;
-    // Rate estimation
-    EB_MALLOC(MdRateEstimationContext_t*, context_ptr->md_rate_estimation_ptr, sizeof(MdRateEstimationContext_t), EB_N_PTR);
+    // Rate estimation, the table of the picture being processed
+    context_ptr->md_rate_estimation_ptr = (MdRateEstimationContext_t*)EB_NULL;
 
     // Adaptive Depth Partitioning
     EB_MALLOC(uint32_t*, context_ptr->sb_score_array, sizeof(uint32_t) * sb_total_count, EB_N_PTR);
@@ -2082,6 +2087,206 @@ void forward_all_c_blocks_to_md(
 
     picture_control_set_ptr->parent_pcs_ptr->average_qp = (uint8_t)picture_control_set_ptr->parent_pcs_ptr->picture_qp;
 }
+/******************************************************
+ * Intra Block Copy Hash
+ *   The hash of a block is derived from the hash of its
+ *   4 blocks of half size, so the levels (2x2 to 128x128)
+ *   are generated one after the other. The rows of each
+ *   level are split by SB row over the MDC threads: the
+ *   thread configuring the picture publishes the levels,
+ *   the other MDC threads join it through feedback rate
+ *   control results.
+ *
+ *   Level n writes the hash buffer n & 1 and reads the
+ *   other one. The configuring thread adds level n - 1 to
+ *   the hash map while level n is generated, so a level
+ *   is only published once the level it overwrites is in
+ *   the map.
+ ******************************************************/
+#define INTRABC_HASH_ROW_HEIGHT     BLOCK_SIZE_64
+
+static void GenerateIntraBcHashRows(
+    PictureControlSet_t                    *picture_control_set_ptr,
+    const Yv12BufferConfig                 *cpi_source,
+    uint32_t                                levelIndex)
+{
+    int32_t rowIndex;
+
+    while ((rowIndex = eb_atomic_fetch_add_32(&picture_control_set_ptr->hash_next_row[levelIndex], 1)) < (int32_t)picture_control_set_ptr->hash_row_count) {
+        const int rowStart = rowIndex * INTRABC_HASH_ROW_HEIGHT;
+        const int rowEnd = rowStart + INTRABC_HASH_ROW_HEIGHT;
+
+        if (levelIndex == 0) {
+            av1_generate_block_2x2_hash_value(
+                cpi_source,
+                picture_control_set_ptr->hash_buffers->block_hash_array[0],
+                picture_control_set_ptr->hash_buffers->block_same_array[0],
+                &picture_control_set_ptr->crc_calculator,
+                rowStart,
+                rowEnd);
+        }
+        else {
+            av1_generate_block_hash_value(
+                cpi_source,
+                2 << levelIndex,
+                picture_control_set_ptr->hash_buffers->block_hash_array[(levelIndex - 1) & 1],
+                picture_control_set_ptr->hash_buffers->block_hash_array[levelIndex & 1],
+                picture_control_set_ptr->hash_buffers->block_same_array[(levelIndex - 1) & 1],
+                picture_control_set_ptr->hash_buffers->block_same_array[levelIndex & 1],
+                &picture_control_set_ptr->crc_calculator,
+                rowStart,
+                rowEnd);
+        }
+
+        eb_atomic_fetch_add_32(&picture_control_set_ptr->hash_done_row[levelIndex], 1);
+    }
+
+    return;
+}
+
+static void AddIntraBcHashLevel(
+    PictureControlSet_t                    *picture_control_set_ptr,
+    const Yv12BufferConfig                 *cpi_source,
+    uint32_t                                levelIndex)
+{
+    av1_add_to_hash_map_by_row_with_precal_data(
+        &picture_control_set_ptr->hash_table,
+        picture_control_set_ptr->hash_buffers->block_hash_array[levelIndex & 1],
+        picture_control_set_ptr->hash_buffers->block_same_array[levelIndex & 1][2],
+        cpi_source->y_crop_width,
+        cpi_source->y_crop_height,
+        2 << levelIndex);
+
+    return;
+}
+
+static void GenerateIntraBcHash(
+    ModeDecisionConfigurationContext_t     *context_ptr,
+    SequenceControlSet                     *sequence_control_set_ptr,
+    PictureControlSet_t                    *picture_control_set_ptr,
+    EbObjectWrapper                        *picture_control_set_wrapper_ptr)
+{
+    Yv12BufferConfig    cpi_source;
+    EbObjectWrapper    *hashBuffersWrapperPtr;
+    EbObjectWrapper    *feedbackWrapperPtr;
+    RateControlResults *feedbackPtr;
+    uint32_t            helperCount;
+    uint32_t            helperIndex;
+    uint32_t            levelIndex;
+    uint32_t            spinCount;
+
+    link_Eb_to_aom_buffer_desc_8bit(
+        picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+        &cpi_source);
+
+    // Drop the blocks of the previous picture of this picture control set
+    av1_hash_table_create(&picture_control_set_ptr->hash_table);
+
+    // The pool holds a set of buffers per MDC thread, so the get never waits
+    eb_get_empty_object(
+        context_ptr->intrabcHashBuffersFifoPtr,
+        &hashBuffersWrapperPtr);
+    picture_control_set_ptr->hash_buffers = (IntraBcHashBuffers_t*)hashBuffersWrapperPtr->object_ptr;
+
+    picture_control_set_ptr->hash_row_count = (cpi_source.y_crop_height + INTRABC_HASH_ROW_HEIGHT - 1) / INTRABC_HASH_ROW_HEIGHT;
+    for (levelIndex = 0; levelIndex < INTRABC_HASH_LEVEL_COUNT; ++levelIndex) {
+        eb_atomic_store_32(&picture_control_set_ptr->hash_next_row[levelIndex], 0);
+        eb_atomic_store_32(&picture_control_set_ptr->hash_done_row[levelIndex], 0);
+    }
+    eb_atomic_store_32(&picture_control_set_ptr->hash_level_count, 0);
+    eb_atomic_store_32(&picture_control_set_ptr->hash_active, 1);
+
+    // Let the idle MDC threads join; the feedback is skipped rather than
+    // waited for when the rate control results are all in use, as only
+    // the MDC threads release them.
+    helperCount = MIN(picture_control_set_ptr->hash_row_count, sequence_control_set_ptr->mode_decision_configuration_process_init_count) - 1;
+    for (helperIndex = 0; helperIndex < helperCount; ++helperIndex) {
+        eb_try_get_empty_object(
+            context_ptr->mdcFeedbackFifoPtr,
+            &feedbackWrapperPtr);
+        if (feedbackWrapperPtr == (EbObjectWrapper*)EB_NULL)
+            break;
+
+        // The helper releases the picture once done with it
+        eb_object_inc_live_count(
+            picture_control_set_wrapper_ptr,
+            1);
+
+        feedbackPtr = (RateControlResults*)feedbackWrapperPtr->object_ptr;
+        feedbackPtr->picture_control_set_wrapper_ptr = picture_control_set_wrapper_ptr;
+        feedbackPtr->intrabc_hash_flag = EB_TRUE;
+        eb_post_full_object(feedbackWrapperPtr);
+    }
+
+    for (levelIndex = 0; levelIndex < INTRABC_HASH_LEVEL_COUNT; ++levelIndex) {
+        eb_atomic_store_32(&picture_control_set_ptr->hash_level_count, (int32_t)levelIndex + 1);
+
+        // The 2x2 level is not added to the map
+        if (levelIndex >= 2) {
+            AddIntraBcHashLevel(
+                picture_control_set_ptr,
+                &cpi_source,
+                levelIndex - 1);
+        }
+
+        GenerateIntraBcHashRows(
+            picture_control_set_ptr,
+            &cpi_source,
+            levelIndex);
+
+        spinCount = 0;
+        while ((uint32_t)eb_atomic_load_32(&picture_control_set_ptr->hash_done_row[levelIndex]) < picture_control_set_ptr->hash_row_count) {
+            SbRowSyncPause(&spinCount);
+        }
+    }
+
+    AddIntraBcHashLevel(
+        picture_control_set_ptr,
+        &cpi_source,
+        INTRABC_HASH_LEVEL_COUNT - 1);
+
+    eb_atomic_store_32(&picture_control_set_ptr->hash_active, 0);
+
+    // The helpers have claimed and done every row, so the buffers are free
+    picture_control_set_ptr->hash_buffers = (IntraBcHashBuffers_t*)EB_NULL;
+    eb_release_object(hashBuffersWrapperPtr);
+
+    return;
+}
+
+/******************************************************
+ * JoinIntraBcHash
+ *   Generates rows of the levels published by the thread
+ *   configuring the picture, until the last level or the
+ *   end of the generation.
+ ******************************************************/
+static void JoinIntraBcHash(
+    PictureControlSet_t                    *picture_control_set_ptr)
+{
+    Yv12BufferConfig cpi_source;
+    uint32_t         levelIndex = 0;
+    uint32_t         spinCount = 0;
+
+    link_Eb_to_aom_buffer_desc_8bit(
+        picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr,
+        &cpi_source);
+
+    while (levelIndex < INTRABC_HASH_LEVEL_COUNT && eb_atomic_load_32(&picture_control_set_ptr->hash_active)) {
+        if ((int32_t)levelIndex < eb_atomic_load_32(&picture_control_set_ptr->hash_level_count)) {
+            GenerateIntraBcHashRows(
+                picture_control_set_ptr,
+                &cpi_source,
+                levelIndex);
+            ++levelIndex;
+            spinCount = 0;
+        }
+        else
+            SbRowSyncPause(&spinCount);
+    }
+
+    return;
+}
+
 /******************************************************
  * Mode Decision Configuration Kernel
  ******************************************************/
@@ -2109,7 +2314,17 @@ void* ModeDecisionConfigurationKernel(void *input_ptr)
 
         rateControlResultsPtr = (RateControlResults*)rateControlResultsWrapperPtr->object_ptr;
         picture_control_set_ptr = (PictureControlSet_t*)rateControlResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
+        eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
         sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+
+        // Feedback from another MDC thread
+        if (rateControlResultsPtr->intrabc_hash_flag) {
+            JoinIntraBcHash(picture_control_set_ptr);
+
+            eb_release_object(rateControlResultsPtr->picture_control_set_wrapper_ptr);
+            eb_release_object(rateControlResultsWrapperPtr);
+            continue;
+        }
       
         // Mode Decision Configuration Kernel Signal(s) derivation
         signal_derivation_mode_decision_config_kernel_oq(
@@ -2202,7 +2417,6 @@ void* ModeDecisionConfigurationKernel(void *input_ptr)
             dequantsMd);
 
         // Hsan: collapse spare code 
-        MdRateEstimationContext_t   *md_rate_estimation_array;
         uint32_t                     entropyCodingQp;
 
         // QP
@@ -2223,21 +2437,15 @@ void* ModeDecisionConfigurationKernel(void *input_ptr)
             context_ptr->qp_index);
         context_ptr->lambda = (uint64_t)lambdaSad;
 
-        // Slice Type
-        EB_SLICE slice_type =
-            (picture_control_set_ptr->parent_pcs_ptr->idr_flag == EB_TRUE) ? I_SLICE :
-            picture_control_set_ptr->slice_type;
-
-        // Increment the MD Rate Estimation array pointer to point to the right address based on the QP and slice type
-        md_rate_estimation_array = (MdRateEstimationContext_t*)sequence_control_set_ptr->encode_context_ptr->md_rate_estimation_array;
-#if ADD_DELTA_QP_SUPPORT
-        md_rate_estimation_array += slice_type * TOTAL_NUMBER_OF_QP_VALUES + picture_control_set_ptr->parent_pcs_ptr->picture_qp;
-#else
-        md_rate_estimation_array += slice_type * TOTAL_NUMBER_OF_QP_VALUES + context_ptr->qp;
-#endif
-
-        // Reset MD rate Estimation table to initial values by copying from md_rate_estimation_array
-        context_ptr->md_rate_estimation_ptr = md_rate_estimation_array;
+        // MD Rate Estimation table of the picture, allocated on the first use of the picture control set
+        if (picture_control_set_ptr->md_rate_estimation_ptr == (MdRateEstimationContext_t*)EB_NULL) {
+            EbErrorType rateEstimationError = md_rate_estimation_ctor(&picture_control_set_ptr->md_rate_estimation_ptr);
+            CHECK_REPORT_ERROR(
+                (rateEstimationError == EB_ErrorNone),
+                sequence_control_set_ptr->encode_context_ptr->app_callback_ptr,
+                EB_ENC_MD_ERROR1);
+        }
+        context_ptr->md_rate_estimation_ptr = picture_control_set_ptr->md_rate_estimation_ptr;
 
         entropyCodingQp = picture_control_set_ptr->parent_pcs_ptr->base_qindex;
 
@@ -2248,22 +2456,11 @@ void* ModeDecisionConfigurationKernel(void *input_ptr)
             entropyCodingQp,
             picture_control_set_ptr->slice_type);
 
-        // Initial Rate Estimatimation of the syntax elements
-        if (!md_rate_estimation_array->initialized)
-            av1_estimate_syntax_rate(
-                md_rate_estimation_array,
-                picture_control_set_ptr->slice_type == I_SLICE ? EB_TRUE : EB_FALSE,
-                picture_control_set_ptr->coeff_est_entropy_coder_ptr->fc);
-
-        // Initial Rate Estimatimation of the Motion vectors
-        av1_estimate_mv_rate(
+        // Initial Rate Estimatimation of the syntax elements, the Motion vectors and the quantized coefficients
+        av1_estimate_picture_rate(
+            sequence_control_set_ptr->encode_context_ptr->md_rate_estimation_cache_ptr,
             picture_control_set_ptr,
-            md_rate_estimation_array,
-            &picture_control_set_ptr->coeff_est_entropy_coder_ptr->fc->nmvc);
-
-        // Initial Rate Estimatimation of the quantized coefficients
-        av1_estimate_coefficients_rate(
-            md_rate_estimation_array,
+            picture_control_set_ptr->md_rate_estimation_ptr,
             picture_control_set_ptr->coeff_est_entropy_coder_ptr->fc);
 
         if (picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode == PIC_SB_SWITCH_DEPTH_MODE) {
@@ -2365,84 +2562,13 @@ void* ModeDecisionConfigurationKernel(void *input_ptr)
                 sf->max_exaustive_pct = intrabc_max_mesh_pct[mesh_speed];
             }
 
-            {
-                // add to hash table
-                const int pic_width = picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_ptr->luma_width;
-                const int pic_height = picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_ptr->luma_height;
-                uint32_t *block_hash_values[2][2];
-                int8_t *is_block_same[2][3];
-                int k, j;
-
-                for (k = 0; k < 2; k++) {
-                    for (j = 0; j < 2; j++) {
-                        block_hash_values[k][j] = malloc(sizeof(uint32_t) * pic_width * pic_height);
-                    }
-
-                    for (j = 0; j < 3; j++) {
-                        is_block_same[k][j] = malloc(sizeof(int8_t) * pic_width * pic_height);
-                    }
-                }
-
-                //picture_control_set_ptr->hash_table.p_lookup_table = NULL;
-                //av1_hash_table_create(&picture_control_set_ptr->hash_table);
-
-                Yv12BufferConfig cpi_source;
-                link_Eb_to_aom_buffer_desc_8bit(
-                    picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr,
-                    &cpi_source);
-
-                av1_crc_calculator_init(&picture_control_set_ptr->crc_calculator1, 24, 0x5D6DCB);
-                av1_crc_calculator_init(&picture_control_set_ptr->crc_calculator2, 24, 0x864CFB);
-
-                av1_generate_block_2x2_hash_value(&cpi_source, block_hash_values[0],
-                    is_block_same[0], picture_control_set_ptr);
-                av1_generate_block_hash_value(&cpi_source, 4, block_hash_values[0],
-                    block_hash_values[1], is_block_same[0],
-                    is_block_same[1], picture_control_set_ptr);
-                av1_add_to_hash_map_by_row_with_precal_data(
-                    &picture_control_set_ptr->hash_table, block_hash_values[1], is_block_same[1][2],
-                    pic_width, pic_height, 4);
-                av1_generate_block_hash_value(&cpi_source, 8, block_hash_values[1],
-                    block_hash_values[0], is_block_same[1],
-                    is_block_same[0], picture_control_set_ptr);
-                av1_add_to_hash_map_by_row_with_precal_data(
-                    &picture_control_set_ptr->hash_table, block_hash_values[0], is_block_same[0][2],
-                    pic_width, pic_height, 8);
-                av1_generate_block_hash_value(&cpi_source, 16, block_hash_values[0],
-                    block_hash_values[1], is_block_same[0],
-                    is_block_same[1], picture_control_set_ptr);
-                av1_add_to_hash_map_by_row_with_precal_data(
-                    &picture_control_set_ptr->hash_table, block_hash_values[1], is_block_same[1][2],
-                    pic_width, pic_height, 16);
-                av1_generate_block_hash_value(&cpi_source, 32, block_hash_values[1],
-                    block_hash_values[0], is_block_same[1],
-                    is_block_same[0], picture_control_set_ptr);
-                av1_add_to_hash_map_by_row_with_precal_data(
-                    &picture_control_set_ptr->hash_table, block_hash_values[0], is_block_same[0][2],
-                    pic_width, pic_height, 32);
-                av1_generate_block_hash_value(&cpi_source, 64, block_hash_values[0],
-                    block_hash_values[1], is_block_same[0],
-                    is_block_same[1], picture_control_set_ptr);
-                av1_add_to_hash_map_by_row_with_precal_data(
-                    &picture_control_set_ptr->hash_table, block_hash_values[1], is_block_same[1][2],
-                    pic_width, pic_height, 64);
-
-                av1_generate_block_hash_value(&cpi_source, 128, block_hash_values[1],
-                    block_hash_values[0], is_block_same[1],
-                    is_block_same[0], picture_control_set_ptr);
-                av1_add_to_hash_map_by_row_with_precal_data(
-                    &picture_control_set_ptr->hash_table, block_hash_values[0], is_block_same[0][2],
-                    pic_width, pic_height, 128);
-
-                for (k = 0; k < 2; k++) {
-                    for (j = 0; j < 2; j++) {
-                        free(block_hash_values[k][j]);
-                    }
-
-                    for (j = 0; j < 3; j++) {
-                        free(is_block_same[k][j]);
-                    }
-                }
+            // The buffers pool only exists when intra block copy can be enabled
+            if (context_ptr->intrabcHashBuffersFifoPtr != (EbFifo*)EB_NULL) {
+                GenerateIntraBcHash(
+                    context_ptr,
+                    sequence_control_set_ptr,
+                    picture_control_set_ptr,
+                    rateControlResultsPtr->picture_control_set_wrapper_ptr);
             }
 
             av1_init3smotion_compensation(&picture_control_set_ptr->ss_cfg, picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr->stride_y);
@@ -35,6 +35,8 @@ extern "C" {
     typedef struct ModeDecisionConfigurationContext_s
     {
         EbFifo                            *rateControlInputFifoPtr;
+        EbFifo                            *mdcFeedbackFifoPtr;            // rate control results posted to the MDC threads
+        EbFifo                            *intrabcHashBuffersFifoPtr;     // NULL when intra block copy cannot be enabled
         EbFifo                            *modeDecisionConfigurationOutputFifoPtr;
 
         MdRateEstimationContext_t           *md_rate_estimation_ptr;
@@ -90,7 +92,8 @@ extern "C" {
     extern EbErrorType ModeDecisionConfigurationContextCtor(
         ModeDecisionConfigurationContext_t **context_dbl_ptr,
         EbFifo                            *rateControlInputFifoPtr,
-
+        EbFifo                            *mdcFeedbackFifoPtr,
+        EbFifo                            *intrabcHashBuffersFifoPtr,
         EbFifo                            *modeDecisionConfigurationOutputFifoPtr,
         uint16_t                                 sb_total_count);
 
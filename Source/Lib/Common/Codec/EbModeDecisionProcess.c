@@ -34,8 +34,8 @@ EbErrorType mode_decision_context_ctor(
     // Trasform Scratch Memory
     EB_MALLOC(int16_t*, context_ptr->transform_inner_array_ptr, 3120, EB_N_PTR); //refer to EbInvTransform_SSE2.as. case 32x32
 
-    // MD rate Estimation tables
-    EB_MALLOC(MdRateEstimationContext_t*, context_ptr->md_rate_estimation_ptr, sizeof(MdRateEstimationContext_t), EB_N_PTR);
+    // MD rate Estimation tables, set to the picture tables at each picture
+    context_ptr->md_rate_estimation_ptr = (MdRateEstimationContext_t*)EB_NULL;
 
     // Fast Candidate Array
     EB_MALLOC(ModeDecisionCandidate_t*, context_ptr->fast_candidate_array, sizeof(ModeDecisionCandidate_t) * MODE_DECISION_CANDIDATE_MAX_COUNT, EB_N_PTR);
@@ -95,6 +95,19 @@ EbErrorType mode_decision_context_ctor(
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
+
+    // Recon Cache
+    for (uint32_t depth = 0; depth < MD_RECON_CACHE_DEPTH_COUNT; ++depth) {
+        for (uint32_t slot = 0; slot < MD_RECON_CACHE_SLOT_COUNT; ++slot) {
+            MdReconCache_t *cache = &context_ptr->md_recon_cache[depth][slot];
+            EB_MALLOC(int32_t*, cache->coeff, sizeof(int32_t) * MD_RECON_CACHE_STRIDE * MD_RECON_CACHE_STRIDE, EB_N_PTR);
+            EB_MALLOC(uint8_t*, cache->pred, MD_RECON_CACHE_STRIDE * MD_RECON_CACHE_STRIDE, EB_N_PTR);
+            EB_MALLOC(uint8_t*, cache->recon, MD_RECON_CACHE_STRIDE * MD_RECON_CACHE_STRIDE, EB_N_PTR);
+            memset(cache->txb, 0, sizeof(cache->txb));
+        }
+        context_ptr->md_recon_cache_best_slot[depth] = 0;
+        context_ptr->md_recon_cache_write_slot[depth] = 0;
+    }
     uint32_t codedLeafIndex, tu_index;
 
     for (codedLeafIndex = 0; codedLeafIndex < BLOCK_MAX_COUNT_SB_128; ++codedLeafIndex) {
@@ -357,9 +370,7 @@ void reset_mode_decision(
     SequenceControlSet    *sequence_control_set_ptr,
     uint32_t                   segment_index)
 {
-    EB_SLICE                     slice_type;
     uint32_t                       lcuRowIndex;
-    MdRateEstimationContext_t   *md_rate_estimation_array;
 
     // QP
 #if ADD_DELTA_QP_SUPPORT
@@ -379,28 +390,14 @@ void reset_mode_decision(
         &context_ptr->full_chroma_lambda,
         (uint8_t)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr->bit_depth,
         context_ptr->qp_index);
-    // Slice Type
-    slice_type =
-        (picture_control_set_ptr->parent_pcs_ptr->idr_flag == EB_TRUE) ? I_SLICE :
-        picture_control_set_ptr->slice_type;
-
-    // Increment the MD Rate Estimation array pointer to point to the right address based on the QP and slice type
+    // MD Rate Estimation table of the picture, built by the mode decision configuration
 
     /* Note(CHKN) : Rate estimation will use FrameQP even when Qp modulation is ON */
 
-    md_rate_estimation_array = (MdRateEstimationContext_t*)sequence_control_set_ptr->encode_context_ptr->md_rate_estimation_array;
-#if ADD_DELTA_QP_SUPPORT
-    md_rate_estimation_array += slice_type * TOTAL_NUMBER_OF_QP_VALUES + picture_control_set_ptr->picture_qp;
-#else
-    md_rate_estimation_array += slice_type * TOTAL_NUMBER_OF_QP_VALUES + context_ptr->qp;
-#endif
-
-    // Reset MD rate Estimation table to initial values by copying from md_rate_estimation_array
-
-    context_ptr->md_rate_estimation_ptr = md_rate_estimation_array;
+    context_ptr->md_rate_estimation_ptr = picture_control_set_ptr->md_rate_estimation_ptr;
     uint32_t  candidateIndex;
     for (candidateIndex = 0; candidateIndex < MODE_DECISION_CANDIDATE_MAX_COUNT; ++candidateIndex) {
-        context_ptr->fast_candidate_ptr_array[candidateIndex]->md_rate_estimation_ptr = md_rate_estimation_array;
+        context_ptr->fast_candidate_ptr_array[candidateIndex]->md_rate_estimation_ptr = picture_control_set_ptr->md_rate_estimation_ptr;
     }
 
 
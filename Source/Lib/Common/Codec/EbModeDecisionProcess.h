@@ -30,6 +30,14 @@ extern "C" {
 #define DEPTH_TWO_STEP    5
 #define DEPTH_THREE_STEP  1
 
+// MD recon cache: one SB per square depth (64x64 down to 4x4), ping-pong
+// between the best shape of the square and the shape being tested
+#define MD_RECON_CACHE_DEPTH_COUNT      5
+#define MD_RECON_CACHE_SLOT_COUNT       2
+#define MD_RECON_CACHE_SLOT_NONE        0xFF
+#define MD_RECON_CACHE_STRIDE           BLOCK_SIZE_64
+#define MD_RECON_CACHE_TXB_STRIDE       (MD_RECON_CACHE_STRIDE >> 2)
+
      /**************************************
       * Macros
       **************************************/
@@ -41,6 +49,41 @@ extern "C" {
       /**************************************
        * Coding Loop Context
        **************************************/
+    typedef struct MdReconCacheTxb_s
+    {
+        uint64_t                    y_distortion[DIST_CALC_TOTAL]; // before the tx scale shift
+        uint16_t                    eob;
+        uint8_t                     tx_size;
+        uint8_t                     tx_type;
+        uint8_t                     qindex;
+        uint8_t                     valid;
+    } MdReconCacheTxb_t;
+
+    // Luma of the MD winners, the coefficients of each txb are kept in
+    // raster order at the txb position. Indexed by the 4x4 of the txb origin.
+    typedef struct MdReconCache_s
+    {
+        int32_t                    *coeff;
+        uint8_t                    *pred;
+        uint8_t                    *recon;
+        MdReconCacheTxb_t           txb[MD_RECON_CACHE_TXB_STRIDE * MD_RECON_CACHE_TXB_STRIDE];
+    } MdReconCache_t;
+
+    // Quantizer index av1_quantize_inv_quantize codes a luma txb of a block
+    // of quantizer qp with, in MD and in the encode pass
+    static INLINE uint8_t md_recon_cache_qindex(
+        const PictureControlSet_t  *picture_control_set_ptr,
+        uint32_t                    qp)
+    {
+#if ADD_DELTA_QP_SUPPORT
+        (void)picture_control_set_ptr;
+        return (uint8_t)qp;
+#else
+        (void)qp;
+        return (uint8_t)picture_control_set_ptr->parent_pcs_ptr->base_qindex;
+#endif
+    }
+
     typedef struct MdEncPassCuData_s
     {
         uint64_t                    skip_cost;
@@ -51,6 +94,7 @@ extern "C" {
         uint32_t                    y_has_coeff;
         uint64_t                    fast_luma_rate;
         uint16_t                    y_count_non_zero_coeffs[4];// Store nonzero CoeffNum, per TU. If one TU, stored in 0, otherwise 4 tus stored in 0 to 3
+        uint8_t                     recon_cache_slot;          // MD recon cache slot of the block at its depth, MD_RECON_CACHE_SLOT_NONE if not cached
 
     } MdEncPassCuData_t;
 
@@ -221,6 +265,10 @@ extern "C" {
         uint8_t                           unipred3x3_injection;
         uint8_t                           bipred3x3_injection;
         uint8_t                           interpolation_filter_search_blk_size;
+        // Recon cache, reused by the encode pass
+        MdReconCache_t                    md_recon_cache[MD_RECON_CACHE_DEPTH_COUNT][MD_RECON_CACHE_SLOT_COUNT];
+        uint8_t                           md_recon_cache_best_slot[MD_RECON_CACHE_DEPTH_COUNT];
+        uint8_t                           md_recon_cache_write_slot[MD_RECON_CACHE_DEPTH_COUNT];
     } ModeDecisionContext_t;
 
     typedef void(*EB_AV1_LAMBDA_ASSIGN_FUNC)(
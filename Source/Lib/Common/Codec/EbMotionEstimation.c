@@ -21,6 +21,7 @@
 #include "EbLambdaRateTables.h"
 #include <math.h>
 #include "EbPictureOperators.h"
+#include "aom_dsp_rtcd.h"
 #define OIS_TH_COUNT    4
 
 int32_t OisPointTh[3][MAX_TEMPORAL_LAYERS][OIS_TH_COUNT] = {
@@ -55,19 +56,6 @@ int32_t OisPointTh[3][MAX_TEMPORAL_LAYERS][OIS_TH_COUNT] = {
 };
 
 #if NSQ_ME_OPT
-void ext_all_sad_calculation_8x8_16x16_c(
-    uint8_t   *src,
-    uint32_t   src_stride,
-    uint8_t   *ref,
-    uint32_t   ref_stride,
-    uint32_t   mv,
-    uint32_t  *p_best_sad8x8,
-    uint32_t  *p_best_sad16x16,
-    uint32_t  *p_best_mv8x8,
-    uint32_t  *p_best_mv16x16,
-    uint32_t   p_eight_sad16x16[16][8],
-    uint32_t   p_eight_sad8x8[64][8]);
-
 void ext_eigth_sad_calculation_nsq_c(
     uint32_t   p_sad8x8[64][8],
     uint32_t   p_sad16x16[16][8],
@@ -93,15 +81,6 @@ void ext_eigth_sad_calculation_nsq_c(
     uint32_t  *p_best_sad16x64,
     uint32_t  *p_best_mv16x64,
     uint32_t   mv);
-
-void ext_eight_sad_calculation_32x32_64x64_c(
-    uint32_t   p_sad16x16[16][8],
-    uint32_t  *p_best_sad32x32,
-    uint32_t  *p_best_sad64x64,
-    uint32_t  *p_best_mv32x32,
-    uint32_t  *p_best_mv64x64,
-    uint32_t   mv,
-    uint32_t  p_sad32x32[4][8]);
 #endif
 
 #define AVCCODEL
@@ -178,26 +157,12 @@ static EB_SADCALCULATION32X32AND64X64_TYPE SadCalculation_32x32_64x64_funcPtrArr
 };
 
 #if NSQ_ME_OPT
-static EB_EXT_ALL_SAD_CALCULATION_8x8_16x16_TYPE Ext_ext_all_sad_calculation_8x8_16x16_funcPtrArray[ASM_TYPE_TOTAL] = {
-    // NON_AVX2
-    ext_all_sad_calculation_8x8_16x16_c,
-    // AVX2
-    ext_all_sad_calculation_8x8_16x16_avx2,
-};
-
 static EB_EIGHTSADCALCULATIONNSQ_TYPE Ext_eigth_sad_calculation_nsq_funcPtrArray[ASM_TYPE_TOTAL] = {
     // NON_AVX2
     ext_eigth_sad_calculation_nsq_c,
     // AVX2
     ext_eigth_sad_calculation_nsq_avx2,
 };
-
-static EB_EXT_EIGHT_SAD_CALCULATION_32x32_64x64_TYPE Ext_ext_eight_sad_calculation_32x32_64x64_funcPtrArray[ASM_TYPE_TOTAL] = {
-    // NON_AVX2
-    ext_eight_sad_calculation_32x32_64x64_c,
-    // AVX2
-    ext_eight_sad_calculation_32x32_64x64_avx2,
-};
 #endif
 
 /*******************************************
@@ -2675,14 +2640,14 @@ static void open_loop_me_get_eight_search_point_results_block(
     uint16_t currMV2 = (((uint16_t)xSearchIndex << 2));
     uint32_t currMV = currMV1 | currMV2;
 
-    Ext_ext_all_sad_calculation_8x8_16x16_funcPtrArray[asm_type](
+    ext_all_sad_calculation_8x8_16x16(
         context_ptr->sb_src_ptr, context_ptr->sb_src_stride, refPtr,
         reflumaStride, currMV, context_ptr->p_best_sad8x8,
         context_ptr->p_best_sad16x16, context_ptr->p_best_mv8x8,
         context_ptr->p_best_mv16x16, context_ptr->p_eight_sad16x16,
         context_ptr->p_eight_sad8x8);
 
-    Ext_ext_eight_sad_calculation_32x32_64x64_funcPtrArray[asm_type](
+    ext_eight_sad_calculation_32x32_64x64(
         context_ptr->p_eight_sad16x16, context_ptr->p_best_sad32x32,
         context_ptr->p_best_sad64x64, context_ptr->p_best_mv32x32,
         context_ptr->p_best_mv64x64, currMV, context_ptr->p_eight_sad32x32);
@@ -5658,7 +5623,7 @@ void HmeOneQuadrantLevel0(
         else
         {
             // Put the first search location into level0 results
-            NxMSadLoopKernel_funcPtrArray[asm_type](
+            sad_loop_kernel(
                 &context_ptr->sixteenth_sb_buffer[0],
                 context_ptr->sixteenth_sb_buffer_stride,
                 &sixteenthRefPicPtr->buffer_y[searchRegionIndex],
@@ -5835,7 +5800,7 @@ void HmeLevel0(
         else
         {
             // Put the first search location into level0 results
-            NxMSadLoopKernel_funcPtrArray[asm_type](
+            sad_loop_kernel(
                 &context_ptr->sixteenth_sb_buffer[0],
                 context_ptr->sixteenth_sb_buffer_stride,
                 &sixteenthRefPicPtr->buffer_y[searchRegionIndex],
@@ -5854,7 +5819,7 @@ void HmeLevel0(
     }
     else
     {
-        sad_loop_kernel(
+        sad_loop_kernel_c(
             &context_ptr->sixteenth_sb_buffer[0],
             context_ptr->sixteenth_sb_buffer_stride,
             &sixteenthRefPicPtr->buffer_y[searchRegionIndex],
@@ -5896,7 +5861,7 @@ void HmeLevel1(
     int16_t                  *yLevel1SearchCenter,               // output parameter, Level1 yMV at (searchRegionNumberInWidth, searchRegionNumberInHeight)
     EbAsm                   asm_type)
 {
-
+    (void)asm_type;
 
     int16_t xTopLeftSearchRegion;
     int16_t yTopLeftSearchRegion;
@@ -5969,7 +5934,7 @@ void HmeLevel1(
     if (((sb_width & 7) == 0) || (sb_width == 4))
     {
         // Put the first search location into level0 results
-        NxMSadLoopKernel_funcPtrArray[asm_type](
+        sad_loop_kernel(
             &context_ptr->quarter_sb_buffer[0],
             context_ptr->quarter_sb_buffer_stride * 2,
             &quarterRefPicPtr->buffer_y[searchRegionIndex],
@@ -5987,7 +5952,7 @@ void HmeLevel1(
     }
     else
     {
-        sad_loop_kernel(
+        sad_loop_kernel_c(
             &context_ptr->quarter_sb_buffer[0],
             context_ptr->quarter_sb_buffer_stride * 2,
             &quarterRefPicPtr->buffer_y[searchRegionIndex],
@@ -6030,7 +5995,7 @@ void HmeLevel2(
     int16_t                  *yLevel2SearchCenter,               // output parameter, Level2 yMV at (searchRegionNumberInWidth, searchRegionNumberInHeight)
     EbAsm                   asm_type)
 {
-
+    (void)asm_type;
 
     int16_t xTopLeftSearchRegion;
     int16_t yTopLeftSearchRegion;
@@ -6105,7 +6070,7 @@ void HmeLevel2(
     if ((((sb_width & 7) == 0) && (sb_width != 40) && (sb_width != 56)))
     {
         // Put the first search location into level0 results
-        NxMSadLoopKernel_funcPtrArray[asm_type](
+        sad_loop_kernel(
             context_ptr->sb_src_ptr,
             context_ptr->sb_src_stride * 2,
             &refPicPtr->buffer_y[searchRegionIndex],
@@ -6124,7 +6089,7 @@ void HmeLevel2(
     else
     {
         // Put the first search location into level0 results
-        sad_loop_kernel(
+        sad_loop_kernel_c(
             context_ptr->sb_src_ptr,
             context_ptr->sb_src_stride * 2,
             &refPicPtr->buffer_y[searchRegionIndex],
@@ -7607,6 +7572,9 @@ EbErrorType MotionEstimateLcu(
 
     int16_t                  hmeLevel1SearchAreaInWidth;
     int16_t                  hmeLevel1SearchAreaInHeight;
+
+    EbBool                    analysisShareLead = sequence_control_set_ptr->encode_context_ptr->analysis_share_lead;
+    EbAnalysisShareSeed      *sharedSeedPtr;
 #if !QUICK_ME_CLEANUP
     uint32_t                  adjustSearchAreaDirection = 0;
 #endif
@@ -7652,6 +7620,13 @@ EbErrorType MotionEstimateLcu(
             refPicPtr = (EbPictureBufferDesc_t*)referenceObject->input_padded_picture_ptr;
             quarterRefPicPtr = (EbPictureBufferDesc_t*)referenceObject->quarter_decimated_picture_ptr;
             sixteenthRefPicPtr = (EbPictureBufferDesc_t*)referenceObject->sixteenth_decimated_picture_ptr;
+
+            // Seed of the SB the lead of a ladder publishes
+            sharedSeedPtr = (analysisShareLead && context_ptr->shared_hme_record_ptr) ?
+                &context_ptr->shared_hme_record_ptr->seed_array[sb_index * MAX_NUM_OF_REF_PIC_LIST + listIndex] :
+                (EbAnalysisShareSeed*)EB_NULL;
+            if (sharedSeedPtr)
+                sharedSeedPtr->valid = 0;
 #if BASE_LAYER_REF
             if (picture_control_set_ptr->temporal_layer_index > 0 || listIndex == 0 || ((ref0Poc != ref1Poc) && (listIndex == 1))) {
 #else
@@ -7677,8 +7652,26 @@ EbErrorType MotionEstimateLcu(
                 }
                 // B - NO HME in boundaries
                 // C - Skip HME
+                // D - Followers of a ladder start from the scaled HME search center of the lead
+
+                if (!analysisShareLead && context_ptr->shared_hme_record_ptr && /*B*/sb_height == BLOCK_SIZE_64 &&
+                    context_ptr->shared_hme_record_ptr->ref_poc[listIndex] == picture_control_set_ptr->ref_pic_poc_array[listIndex] &&
+                    eb_analysis_share_get_seed(
+                        sequence_control_set_ptr->encode_context_ptr->analysis_share_ptr,
+                        context_ptr->shared_hme_record_ptr,
+                        picture_control_set_ptr->picture_number,
+                        listIndex,
+                        sb_origin_x,
+                        sb_origin_y,
+                        (uint32_t)picture_width,
+                        (uint32_t)picture_height,
+                        &xHmeSearchCenter,
+                        &yHmeSearchCenter)) {
 
-                if (picture_control_set_ptr->enable_hme_flag && /*B*/sb_height == BLOCK_SIZE_64) {//(searchCenterSad > sequence_control_set_ptr->static_config.skipTier0HmeTh)) {
+                    x_search_center = xHmeSearchCenter;
+                    y_search_center = yHmeSearchCenter;
+                }
+                else if (picture_control_set_ptr->enable_hme_flag && /*B*/sb_height == BLOCK_SIZE_64) {//(searchCenterSad > sequence_control_set_ptr->static_config.skipTier0HmeTh)) {
                     while (searchRegionNumberInHeight < context_ptr->number_hme_search_region_in_height) {
                         while (searchRegionNumberInWidth < context_ptr->number_hme_search_region_in_width) {
 
@@ -7945,6 +7938,12 @@ EbErrorType MotionEstimateLcu(
 
                     x_search_center = xHmeSearchCenter;
                     y_search_center = yHmeSearchCenter;
+
+                    if (sharedSeedPtr) {
+                        sharedSeedPtr->x_search_center = x_search_center;
+                        sharedSeedPtr->y_search_center = y_search_center;
+                        sharedSeedPtr->valid = 1;
+                    }
                         }
                     }
 
@@ -8552,7 +8551,7 @@ uint64_t SixteenthDecimatedSearch(
     else
     {
         // Put the first search location into level0 results
-        NxMSadLoopKernel_funcPtrArray[asm_type](
+        sad_loop_kernel(
             &context_ptr->sixteenth_sb_buffer[0],
             context_ptr->sixteenth_sb_buffer_stride * 2,
             &sixteenthRefPicPtr->buffer_y[searchRegionIndex],
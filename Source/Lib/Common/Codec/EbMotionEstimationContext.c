@@ -49,6 +49,7 @@ EbErrorType MeContextCtor(
 
     EB_MEMSET((*object_dbl_ptr)->sb_buffer, 0, sizeof(uint8_t) * BLOCK_SIZE_64 * (*object_dbl_ptr)->sb_buffer_stride);
     EB_MALLOC(EB_BitFraction *, (*object_dbl_ptr)->mvd_bits_array, sizeof(EB_BitFraction) * NUMBER_OF_MVD_CASES, EB_N_PTR);
+    EB_MEMSET((*object_dbl_ptr)->mvd_bits_array, 0, sizeof(EB_BitFraction) * NUMBER_OF_MVD_CASES);
     // 15 intermediate buffers to retain the interpolated reference samples
 
     //      0    1    2    3
@@ -9,11 +9,17 @@
 #include "EbDefinitions.h"
 #include "EbMdRateEstimation.h"
 #include "EbCodingUnit.h"
+#include "EbAnalysisShare.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
     // Max Search Area
+    // The interpolated search area buffers hold the search window of one SB, at
+    // most the largest search area of the ME tables (640 for screen content)
+    // plus the SB and the filter taps. The window is clipped to the picture,
+    // never widened by it, so these bounds hold up to MAX_SOURCE_WIDTH x
+    // MAX_SOURCE_HEIGHT.
 #if SCENE_CONTENT_SETTINGS
 #define MAX_SEARCH_AREA_WIDTH       MAX_PICTURE_WIDTH_SIZE  + (PAD_VALUE << 1)
 #define MAX_SEARCH_AREA_HEIGHT      MAX_PICTURE_HEIGHT_SIZE + (PAD_VALUE << 1)
@@ -423,6 +429,11 @@ extern "C" {
         uint16_t                      hme_level2_search_area_in_height_array[EB_HME_SEARCH_AREA_ROW_MAX_COUNT];
         uint8_t                       update_hme_search_center_flag;
 
+        // Analysis record of the picture when the encoder is part of a
+        // ladder: the lead writes its HME search centers, followers read
+        // them instead of running HME. NULL otherwise.
+        EbAnalysisShareRecord        *shared_hme_record_ptr;
+
     } MeContext_t;
     typedef struct SsMeContext_s {
 
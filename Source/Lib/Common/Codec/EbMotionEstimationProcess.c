@@ -191,6 +191,12 @@ EbErrorType signal_derivation_me_kernel_oq(
     else
         context_ptr->me_context_ptr->fractionalSearchMethod = FULL_SAD_SEARCH;
 
+    // Deadline speed control
+    const EbDeadlineEffort *deadlineEffort = eb_deadline_control_get_effort(picture_control_set_ptr->effort_level);
+    if (deadlineEffort->me_search_area_shift) {
+        context_ptr->me_context_ptr->search_area_width = MAX(8, context_ptr->me_context_ptr->search_area_width >> deadlineEffort->me_search_area_shift);
+        context_ptr->me_context_ptr->search_area_height = MAX(8, context_ptr->me_context_ptr->search_area_height >> deadlineEffort->me_search_area_shift);
+    }
 
     return return_error;
 };
@@ -371,14 +377,15 @@ EbErrorType ComputeDecimatedZzSad(
  * to the prediction structure pattern.  The Motion Analysis process is multithreaded,
  * so pictures can be processed out of order as long as all inputs are available.
  ************************************************/
-void* MotionEstimationKernel(void *input_ptr)
+void MotionEstimationKernel(
+    void            *input_ptr,
+    EbObjectWrapper *inputResultsWrapperPtr)
 {
     MotionEstimationContext_t   *context_ptr = (MotionEstimationContext_t*)input_ptr;
 
     PictureParentControlSet_t   *picture_control_set_ptr;
     SequenceControlSet        *sequence_control_set_ptr;
 
-    EbObjectWrapper           *inputResultsWrapperPtr;
     PictureDecisionResults_t    *inputResultsPtr;
 
     EbObjectWrapper           *outputResultsWrapperPtr;
@@ -419,338 +426,370 @@ void* MotionEstimationKernel(void *input_ptr)
     uint32_t                      intra_sad_interval_index;
 
     EbAsm                      asm_type;
-    MdRateEstimationContext_t   *md_rate_estimation_array;
-
-
-    for (;;) {
-
-
-        // Get Input Full Object
-        eb_get_full_object(
-            context_ptr->pictureDecisionResultsInputFifoPtr,
-            &inputResultsWrapperPtr);
-
-        inputResultsPtr = (PictureDecisionResults_t*)inputResultsWrapperPtr->object_ptr;
-        picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
-        sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
-        paReferenceObject = (EbPaReferenceObject*)picture_control_set_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
-        quarter_decimated_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->quarter_decimated_picture_ptr;
-        sixteenth_decimated_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->sixteenth_decimated_picture_ptr;
-
-        input_padded_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->input_padded_picture_ptr;
-
-        input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
-
-        // Segments
-        segment_index = inputResultsPtr->segment_index;
-        picture_width_in_sb = (sequence_control_set_ptr->luma_width + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
-        picture_height_in_sb = (sequence_control_set_ptr->luma_height + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
-        SEGMENT_CONVERT_IDX_TO_XY(segment_index, xSegmentIndex, ySegmentIndex, picture_control_set_ptr->me_segments_column_count);
-        xLcuStartIndex = SEGMENT_START_IDX(xSegmentIndex, picture_width_in_sb, picture_control_set_ptr->me_segments_column_count);
-        xLcuEndIndex = SEGMENT_END_IDX(xSegmentIndex, picture_width_in_sb, picture_control_set_ptr->me_segments_column_count);
-        yLcuStartIndex = SEGMENT_START_IDX(ySegmentIndex, picture_height_in_sb, picture_control_set_ptr->me_segments_row_count);
-        yLcuEndIndex = SEGMENT_END_IDX(ySegmentIndex, picture_height_in_sb, picture_control_set_ptr->me_segments_row_count);
-        asm_type = sequence_control_set_ptr->encode_context_ptr->asm_type;
-        // Increment the MD Rate Estimation array pointer to point to the right address based on the QP and slice type
-        md_rate_estimation_array = (MdRateEstimationContext_t*)sequence_control_set_ptr->encode_context_ptr->md_rate_estimation_array;
-        md_rate_estimation_array += picture_control_set_ptr->slice_type * TOTAL_NUMBER_OF_QP_VALUES + picture_control_set_ptr->picture_qp;
-        // Reset MD rate Estimation table to initial values by copying from md_rate_estimation_array
-        EB_MEMCPY(&(context_ptr->me_context_ptr->mvd_bits_array[0]), &(md_rate_estimation_array->mvdBits[0]), sizeof(EB_BitFraction)*NUMBER_OF_MVD_CASES);
-        ///context_ptr->me_context_ptr->lambda = lambdaModeDecisionLdSadQpScaling[picture_control_set_ptr->picture_qp];
-        
-        // ME Kernel Signal(s) derivation
-        signal_derivation_me_kernel_oq(
-            sequence_control_set_ptr,
-            picture_control_set_ptr,
-            context_ptr);
 
-        // Lambda Assignement
-        if (sequence_control_set_ptr->static_config.pred_structure == EB_PRED_RANDOM_ACCESS) {
+    EbAnalysisShare             *analysisSharePtr;
+    EbAnalysisShareRecord       *sharedHmeRecordPtr = (EbAnalysisShareRecord*)EB_NULL;
 
-            if (picture_control_set_ptr->temporal_layer_index == 0) {
-                context_ptr->me_context_ptr->lambda = lambdaModeDecisionRaSad[picture_control_set_ptr->picture_qp];
-            }
-            else if (picture_control_set_ptr->temporal_layer_index < 3) {
-                context_ptr->me_context_ptr->lambda = lambdaModeDecisionRaSadQpScalingL1[picture_control_set_ptr->picture_qp];
-            }
-            else {
-                context_ptr->me_context_ptr->lambda = lambdaModeDecisionRaSadQpScalingL3[picture_control_set_ptr->picture_qp];
-            }
+    inputResultsPtr = (PictureDecisionResults_t*)inputResultsWrapperPtr->object_ptr;
+    picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
+    eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
+    sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    uint64_t workStartTime = eb_deadline_work_start(sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr);
+    paReferenceObject = (EbPaReferenceObject*)picture_control_set_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
+    quarter_decimated_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->quarter_decimated_picture_ptr;
+    sixteenth_decimated_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->sixteenth_decimated_picture_ptr;
+
+    input_padded_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->input_padded_picture_ptr;
+
+    input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+
+    // Segments
+    segment_index = inputResultsPtr->segment_index;
+    picture_width_in_sb = (sequence_control_set_ptr->luma_width + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
+    picture_height_in_sb = (sequence_control_set_ptr->luma_height + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
+    SEGMENT_CONVERT_IDX_TO_XY(segment_index, xSegmentIndex, ySegmentIndex, picture_control_set_ptr->me_segments_column_count);
+    xLcuStartIndex = SEGMENT_START_IDX(xSegmentIndex, picture_width_in_sb, picture_control_set_ptr->me_segments_column_count);
+    xLcuEndIndex = SEGMENT_END_IDX(xSegmentIndex, picture_width_in_sb, picture_control_set_ptr->me_segments_column_count);
+    yLcuStartIndex = SEGMENT_START_IDX(ySegmentIndex, picture_height_in_sb, picture_control_set_ptr->me_segments_row_count);
+    yLcuEndIndex = SEGMENT_END_IDX(ySegmentIndex, picture_height_in_sb, picture_control_set_ptr->me_segments_row_count);
+    asm_type = sequence_control_set_ptr->encode_context_ptr->asm_type;
+    analysisSharePtr = sequence_control_set_ptr->encode_context_ptr->analysis_share_ptr;
+    ///context_ptr->me_context_ptr->lambda = lambdaModeDecisionLdSadQpScaling[picture_control_set_ptr->picture_qp];
+    
+    // ME Kernel Signal(s) derivation
+    signal_derivation_me_kernel_oq(
+        sequence_control_set_ptr,
+        picture_control_set_ptr,
+        context_ptr);
+
+    // Lambda Assignement
+    if (sequence_control_set_ptr->static_config.pred_structure == EB_PRED_RANDOM_ACCESS) {
+
+        if (picture_control_set_ptr->temporal_layer_index == 0) {
+            context_ptr->me_context_ptr->lambda = lambdaModeDecisionRaSad[picture_control_set_ptr->picture_qp];
+        }
+        else if (picture_control_set_ptr->temporal_layer_index < 3) {
+            context_ptr->me_context_ptr->lambda = lambdaModeDecisionRaSadQpScalingL1[picture_control_set_ptr->picture_qp];
         }
         else {
-            if (picture_control_set_ptr->temporal_layer_index == 0) {
-                context_ptr->me_context_ptr->lambda = lambdaModeDecisionLdSad[picture_control_set_ptr->picture_qp];
+            context_ptr->me_context_ptr->lambda = lambdaModeDecisionRaSadQpScalingL3[picture_control_set_ptr->picture_qp];
+        }
+    }
+    else {
+        if (picture_control_set_ptr->temporal_layer_index == 0) {
+            context_ptr->me_context_ptr->lambda = lambdaModeDecisionLdSad[picture_control_set_ptr->picture_qp];
+        }
+        else {
+            context_ptr->me_context_ptr->lambda = lambdaModeDecisionLdSadQpScaling[picture_control_set_ptr->picture_qp];
+        }
+    }
+
+    // *** MOTION ESTIMATION CODE ***
+    if (picture_control_set_ptr->slice_type != I_SLICE) {
+
+        // Ladder: the lead records its HME search centers, followers read them. The
+        // inputs of a follower are held until the lead analysed the picture, and the
+        // record kept until the follower is through, so the centers are only missing
+        // when the lead closed.
+        context_ptr->me_context_ptr->shared_hme_record_ptr = (EbAnalysisShareRecord*)EB_NULL;
+        if (analysisSharePtr) {
+            if (sequence_control_set_ptr->encode_context_ptr->analysis_share_lead) {
+                sharedHmeRecordPtr = eb_analysis_share_get_record(analysisSharePtr, picture_control_set_ptr->picture_number);
+                if (sharedHmeRecordPtr) {
+                    sharedHmeRecordPtr->ref_poc[REF_LIST_0] = picture_control_set_ptr->ref_pic_poc_array[REF_LIST_0];
+                    sharedHmeRecordPtr->ref_poc[REF_LIST_1] = (picture_control_set_ptr->slice_type == P_SLICE) ?
+                        ~0ull :
+                        picture_control_set_ptr->ref_pic_poc_array[REF_LIST_1];
+                }
             }
-            else {
-                context_ptr->me_context_ptr->lambda = lambdaModeDecisionLdSadQpScaling[picture_control_set_ptr->picture_qp];
+            else if (picture_control_set_ptr->enable_hme_flag) {
+                sharedHmeRecordPtr = eb_analysis_share_get_hme(analysisSharePtr, picture_control_set_ptr->picture_number);
+                if (sharedHmeRecordPtr == (EbAnalysisShareRecord*)EB_NULL && segment_index == 0 && !picture_control_set_ptr->end_of_sequence_flag)
+                    eb_atomic_fetch_add_32(&sequence_control_set_ptr->encode_context_ptr->analysis_share_hme_fallback_count, 1);
             }
+            context_ptr->me_context_ptr->shared_hme_record_ptr = sharedHmeRecordPtr;
         }
 
-        // *** MOTION ESTIMATION CODE ***
-        if (picture_control_set_ptr->slice_type != I_SLICE) {
+        // SB Loop
+        for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
+            for (xLcuIndex = xLcuStartIndex; xLcuIndex < xLcuEndIndex; ++xLcuIndex) {
 
-            // SB Loop
-            for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
-                for (xLcuIndex = xLcuStartIndex; xLcuIndex < xLcuEndIndex; ++xLcuIndex) {
+                sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
+                sb_origin_x = xLcuIndex * sequence_control_set_ptr->sb_sz;
+                sb_origin_y = yLcuIndex * sequence_control_set_ptr->sb_sz;
 
-                    sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
-                    sb_origin_x = xLcuIndex * sequence_control_set_ptr->sb_sz;
-                    sb_origin_y = yLcuIndex * sequence_control_set_ptr->sb_sz;
+                sb_width = (sequence_control_set_ptr->luma_width - sb_origin_x) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_width - sb_origin_x : BLOCK_SIZE_64;
+                sb_height = (sequence_control_set_ptr->luma_height - sb_origin_y) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_height - sb_origin_y : BLOCK_SIZE_64;
 
-                    sb_width = (sequence_control_set_ptr->luma_width - sb_origin_x) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_width - sb_origin_x : BLOCK_SIZE_64;
-                    sb_height = (sequence_control_set_ptr->luma_height - sb_origin_y) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_height - sb_origin_y : BLOCK_SIZE_64;
+                // Load the SB from the input to the intermediate SB buffer
+                bufferIndex = (input_picture_ptr->origin_y + sb_origin_y) * input_picture_ptr->stride_y + input_picture_ptr->origin_x + sb_origin_x;
 
-                    // Load the SB from the input to the intermediate SB buffer
-                    bufferIndex = (input_picture_ptr->origin_y + sb_origin_y) * input_picture_ptr->stride_y + input_picture_ptr->origin_x + sb_origin_x;
+                context_ptr->me_context_ptr->hme_search_type = HME_RECTANGULAR;
 
-                    context_ptr->me_context_ptr->hme_search_type = HME_RECTANGULAR;
+                for (lcuRow = 0; lcuRow < BLOCK_SIZE_64; lcuRow++) {
+                    EB_MEMCPY((&(context_ptr->me_context_ptr->sb_buffer[lcuRow * BLOCK_SIZE_64])), (&(input_picture_ptr->buffer_y[bufferIndex + lcuRow * input_picture_ptr->stride_y])), BLOCK_SIZE_64 * sizeof(uint8_t));
 
-                    for (lcuRow = 0; lcuRow < BLOCK_SIZE_64; lcuRow++) {
-                        EB_MEMCPY((&(context_ptr->me_context_ptr->sb_buffer[lcuRow * BLOCK_SIZE_64])), (&(input_picture_ptr->buffer_y[bufferIndex + lcuRow * input_picture_ptr->stride_y])), BLOCK_SIZE_64 * sizeof(uint8_t));
+                }
 
-                    }
+                {
+                    uint8_t * src_ptr = &input_padded_picture_ptr->buffer_y[bufferIndex];
 
+                    //_MM_HINT_T0     //_MM_HINT_T1    //_MM_HINT_T2//_MM_HINT_NTA
+                    uint32_t i;
+                    for (i = 0; i < sb_height; i++)
                     {
-                        uint8_t * src_ptr = &input_padded_picture_ptr->buffer_y[bufferIndex];
-
-                        //_MM_HINT_T0     //_MM_HINT_T1    //_MM_HINT_T2//_MM_HINT_NTA
-                        uint32_t i;
-                        for (i = 0; i < sb_height; i++)
-                        {
-                            char const* p = (char const*)(src_ptr + i * input_padded_picture_ptr->stride_y);
-                            _mm_prefetch(p, _MM_HINT_T2);
-                        }
+                        char const* p = (char const*)(src_ptr + i * input_padded_picture_ptr->stride_y);
+                        _mm_prefetch(p, _MM_HINT_T2);
                     }
+                }
 
 
-                    context_ptr->me_context_ptr->sb_src_ptr = &input_padded_picture_ptr->buffer_y[bufferIndex];
-                    context_ptr->me_context_ptr->sb_src_stride = input_padded_picture_ptr->stride_y;
+                context_ptr->me_context_ptr->sb_src_ptr = &input_padded_picture_ptr->buffer_y[bufferIndex];
+                context_ptr->me_context_ptr->sb_src_stride = input_padded_picture_ptr->stride_y;
 
 
-                    // Load the 1/4 decimated SB from the 1/4 decimated input to the 1/4 intermediate SB buffer
-                    if (picture_control_set_ptr->enable_hme_level1_flag) {
+                // Load the 1/4 decimated SB from the 1/4 decimated input to the 1/4 intermediate SB buffer
+                if (picture_control_set_ptr->enable_hme_level1_flag) {
 
-                        bufferIndex = (quarter_decimated_picture_ptr->origin_y + (sb_origin_y >> 1)) * quarter_decimated_picture_ptr->stride_y + quarter_decimated_picture_ptr->origin_x + (sb_origin_x >> 1);
+                    bufferIndex = (quarter_decimated_picture_ptr->origin_y + (sb_origin_y >> 1)) * quarter_decimated_picture_ptr->stride_y + quarter_decimated_picture_ptr->origin_x + (sb_origin_x >> 1);
 
-                        for (lcuRow = 0; lcuRow < (sb_height >> 1); lcuRow++) {
-                            EB_MEMCPY((&(context_ptr->me_context_ptr->quarter_sb_buffer[lcuRow * context_ptr->me_context_ptr->quarter_sb_buffer_stride])), (&(quarter_decimated_picture_ptr->buffer_y[bufferIndex + lcuRow * quarter_decimated_picture_ptr->stride_y])), (sb_width >> 1) * sizeof(uint8_t));
+                    for (lcuRow = 0; lcuRow < (sb_height >> 1); lcuRow++) {
+                        EB_MEMCPY((&(context_ptr->me_context_ptr->quarter_sb_buffer[lcuRow * context_ptr->me_context_ptr->quarter_sb_buffer_stride])), (&(quarter_decimated_picture_ptr->buffer_y[bufferIndex + lcuRow * quarter_decimated_picture_ptr->stride_y])), (sb_width >> 1) * sizeof(uint8_t));
 
-                        }
                     }
+                }
 
-                    // Load the 1/16 decimated SB from the 1/16 decimated input to the 1/16 intermediate SB buffer
-                    if (picture_control_set_ptr->enable_hme_level0_flag) {
+                // Load the 1/16 decimated SB from the 1/16 decimated input to the 1/16 intermediate SB buffer
+                if (picture_control_set_ptr->enable_hme_level0_flag) {
 
-                        bufferIndex = (sixteenth_decimated_picture_ptr->origin_y + (sb_origin_y >> 2)) * sixteenth_decimated_picture_ptr->stride_y + sixteenth_decimated_picture_ptr->origin_x + (sb_origin_x >> 2);
+                    bufferIndex = (sixteenth_decimated_picture_ptr->origin_y + (sb_origin_y >> 2)) * sixteenth_decimated_picture_ptr->stride_y + sixteenth_decimated_picture_ptr->origin_x + (sb_origin_x >> 2);
 
-                        {
-                            uint8_t  *framePtr = &sixteenth_decimated_picture_ptr->buffer_y[bufferIndex];
-                            uint8_t  *localPtr = context_ptr->me_context_ptr->sixteenth_sb_buffer;
+                    {
+                        uint8_t  *framePtr = &sixteenth_decimated_picture_ptr->buffer_y[bufferIndex];
+                        uint8_t  *localPtr = context_ptr->me_context_ptr->sixteenth_sb_buffer;
 
-                            for (lcuRow = 0; lcuRow < (sb_height >> 2); lcuRow += 2) {
-                                EB_MEMCPY(localPtr, framePtr, (sb_width >> 2) * sizeof(uint8_t));
-                                localPtr += 16;
-                                framePtr += sixteenth_decimated_picture_ptr->stride_y << 1;
-                            }
+                        for (lcuRow = 0; lcuRow < (sb_height >> 2); lcuRow += 2) {
+                            EB_MEMCPY(localPtr, framePtr, (sb_width >> 2) * sizeof(uint8_t));
+                            localPtr += 16;
+                            framePtr += sixteenth_decimated_picture_ptr->stride_y << 1;
                         }
                     }
+                }
 
-                    MotionEstimateLcu(
-                        picture_control_set_ptr,
-                        sb_index,
-                        sb_origin_x,
-                        sb_origin_y,
-                        context_ptr->me_context_ptr,
-                        input_picture_ptr);
+                MotionEstimateLcu(
+                    picture_control_set_ptr,
+                    sb_index,
+                    sb_origin_x,
+                    sb_origin_y,
+                    context_ptr->me_context_ptr,
+                    input_picture_ptr);
 
-                }
             }
         }
+    }
 
-        // *** OPEN LOOP INTRA CANDIDATE SEARCH CODE ***
-        {
+    if (sequence_control_set_ptr->encode_context_ptr->analysis_share_lead) {
+        eb_analysis_share_add_hme_sbs(
+            analysisSharePtr,
+            picture_control_set_ptr->picture_number,
+            (xLcuEndIndex - xLcuStartIndex) * (yLcuEndIndex - yLcuStartIndex));
+    }
+    else if (analysisSharePtr) {
+        eb_analysis_share_follower_hme_sbs(
+            analysisSharePtr,
+            sequence_control_set_ptr->encode_context_ptr->analysis_share_follower_index,
+            picture_control_set_ptr->picture_number,
+            (xLcuEndIndex - xLcuStartIndex) * (yLcuEndIndex - yLcuStartIndex),
+            picture_width_in_sb * picture_height_in_sb);
+    }
 
-            // SB Loop
-            for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
-                for (xLcuIndex = xLcuStartIndex; xLcuIndex < xLcuEndIndex; ++xLcuIndex) {
+    // *** OPEN LOOP INTRA CANDIDATE SEARCH CODE ***
+    {
 
-                    sb_origin_x = xLcuIndex * sequence_control_set_ptr->sb_sz;
-                    sb_origin_y = yLcuIndex * sequence_control_set_ptr->sb_sz;
+        // SB Loop
+        for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
+            for (xLcuIndex = xLcuStartIndex; xLcuIndex < xLcuEndIndex; ++xLcuIndex) {
 
-                    sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
+                sb_origin_x = xLcuIndex * sequence_control_set_ptr->sb_sz;
+                sb_origin_y = yLcuIndex * sequence_control_set_ptr->sb_sz;
 
+                sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
 
-                    open_loop_intra_search_sb(
-                        picture_control_set_ptr,
-                        sb_index,
-                        context_ptr,
-                        input_picture_ptr,
-                        asm_type);
+
+                open_loop_intra_search_sb(
+                    picture_control_set_ptr,
+                    sb_index,
+                    context_ptr,
+                    input_picture_ptr,
+                    asm_type);
 
 
-                }
             }
         }
+    }
 
-        // ZZ SADs Computation
-        // 1 lookahead frame is needed to get valid (0,0) SAD
-        if (sequence_control_set_ptr->static_config.look_ahead_distance != 0) {
-            // when DG is ON, the ZZ SADs are computed @ the PD process
-            {
-                // ZZ SADs Computation using decimated picture
-                if (picture_control_set_ptr->picture_number > 0) {
-
-                    ComputeDecimatedZzSad(
-                        context_ptr,
-                        sequence_control_set_ptr,
-                        picture_control_set_ptr,
-                        sixteenth_decimated_picture_ptr,
-                        xLcuStartIndex,
-                        xLcuEndIndex,
-                        yLcuStartIndex,
-                        yLcuEndIndex);
+    // ZZ SADs Computation
+    // 1 lookahead frame is needed to get valid (0,0) SAD
+    if (sequence_control_set_ptr->static_config.look_ahead_distance != 0) {
+        // when DG is ON, the ZZ SADs are computed @ the PD process
+        {
+            // ZZ SADs Computation using decimated picture
+            if (picture_control_set_ptr->picture_number > 0) {
+
+                ComputeDecimatedZzSad(
+                    context_ptr,
+                    sequence_control_set_ptr,
+                    picture_control_set_ptr,
+                    sixteenth_decimated_picture_ptr,
+                    xLcuStartIndex,
+                    xLcuEndIndex,
+                    yLcuStartIndex,
+                    yLcuEndIndex);
 
-                }
             }
         }
+    }
 
 
-        // Calculate the ME Distortion and OIS Historgrams
+    // Calculate the ME Distortion and OIS Historgrams
 
-        eb_block_on_mutex(picture_control_set_ptr->rc_distortion_histogram_mutex);
+    eb_block_on_mutex(picture_control_set_ptr->rc_distortion_histogram_mutex);
 
-        if (sequence_control_set_ptr->static_config.rate_control_mode) {
-            if (picture_control_set_ptr->slice_type != I_SLICE) {
-                uint16_t sadIntervalIndex;
-                for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
-                    for (xLcuIndex = xLcuStartIndex; xLcuIndex < xLcuEndIndex; ++xLcuIndex) {
+    if (sequence_control_set_ptr->static_config.rate_control_mode) {
+        if (picture_control_set_ptr->slice_type != I_SLICE) {
+            uint16_t sadIntervalIndex;
+            for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
+                for (xLcuIndex = xLcuStartIndex; xLcuIndex < xLcuEndIndex; ++xLcuIndex) {
 
-                        sb_origin_x = xLcuIndex * sequence_control_set_ptr->sb_sz;
-                        sb_origin_y = yLcuIndex * sequence_control_set_ptr->sb_sz;
-                        sb_width = (sequence_control_set_ptr->luma_width - sb_origin_x) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_width - sb_origin_x : BLOCK_SIZE_64;
-                        sb_height = (sequence_control_set_ptr->luma_height - sb_origin_y) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_height - sb_origin_y : BLOCK_SIZE_64;
+                    sb_origin_x = xLcuIndex * sequence_control_set_ptr->sb_sz;
+                    sb_origin_y = yLcuIndex * sequence_control_set_ptr->sb_sz;
+                    sb_width = (sequence_control_set_ptr->luma_width - sb_origin_x) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_width - sb_origin_x : BLOCK_SIZE_64;
+                    sb_height = (sequence_control_set_ptr->luma_height - sb_origin_y) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_height - sb_origin_y : BLOCK_SIZE_64;
 
-                        sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
-                        picture_control_set_ptr->inter_sad_interval_index[sb_index] = 0;
-                        picture_control_set_ptr->intra_sad_interval_index[sb_index] = 0;
+                    sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
+                    picture_control_set_ptr->inter_sad_interval_index[sb_index] = 0;
+                    picture_control_set_ptr->intra_sad_interval_index[sb_index] = 0;
 
-                        if (sb_width == BLOCK_SIZE_64 && sb_height == BLOCK_SIZE_64) {
+                    if (sb_width == BLOCK_SIZE_64 && sb_height == BLOCK_SIZE_64) {
 
 
-                            sadIntervalIndex = (uint16_t)(picture_control_set_ptr->rc_me_distortion[sb_index] >> (12 - SAD_PRECISION_INTERVAL));//change 12 to 2*log2(64)
+                        sadIntervalIndex = (uint16_t)(picture_control_set_ptr->rc_me_distortion[sb_index] >> (12 - SAD_PRECISION_INTERVAL));//change 12 to 2*log2(64)
 
-                            // printf("%d\n", sadIntervalIndex);
+                        // printf("%d\n", sadIntervalIndex);
 
-                            sadIntervalIndex = (uint16_t)(sadIntervalIndex >> 2);
-                            if (sadIntervalIndex > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
-                                uint16_t sadIntervalIndexTemp = sadIntervalIndex - ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
+                        sadIntervalIndex = (uint16_t)(sadIntervalIndex >> 2);
+                        if (sadIntervalIndex > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
+                            uint16_t sadIntervalIndexTemp = sadIntervalIndex - ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
 
-                                sadIntervalIndex = ((NUMBER_OF_SAD_INTERVALS >> 1) - 1) + (sadIntervalIndexTemp >> 3);
+                            sadIntervalIndex = ((NUMBER_OF_SAD_INTERVALS >> 1) - 1) + (sadIntervalIndexTemp >> 3);
 
-                            }
-                            if (sadIntervalIndex >= NUMBER_OF_SAD_INTERVALS - 1)
-                                sadIntervalIndex = NUMBER_OF_SAD_INTERVALS - 1;
+                        }
+                        if (sadIntervalIndex >= NUMBER_OF_SAD_INTERVALS - 1)
+                            sadIntervalIndex = NUMBER_OF_SAD_INTERVALS - 1;
 
 
-                            picture_control_set_ptr->inter_sad_interval_index[sb_index] = sadIntervalIndex;
+                        picture_control_set_ptr->inter_sad_interval_index[sb_index] = sadIntervalIndex;
 
-                            picture_control_set_ptr->me_distortion_histogram[sadIntervalIndex] ++;
+                        picture_control_set_ptr->me_distortion_histogram[sadIntervalIndex] ++;
 #if RC 
 
-                            intra_sad_interval_index = picture_control_set_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64] >> 4;
+                        intra_sad_interval_index = picture_control_set_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64] >> 4;
 #else
-                            uint32_t                       bestOisCuIndex = 0;
+                        uint32_t                       bestOisCuIndex = 0;
 
-                            //DOUBLE CHECK THIS PIECE OF CODE
-                            bestOisCuIndex =  picture_control_set_ptr->ois_sb_results[sb_index]->best_distortion_index[0];
-                            intra_sad_interval_index = (uint32_t) ( picture_control_set_ptr->ois_sb_results[sb_index]->ois_candidate_array[0][bestOisCuIndex].distortion  >> (12 - SAD_PRECISION_INTERVAL));//change 12 to 2*log2(64) ;
+                        //DOUBLE CHECK THIS PIECE OF CODE
+                        bestOisCuIndex =  picture_control_set_ptr->ois_sb_results[sb_index]->best_distortion_index[0];
+                        intra_sad_interval_index = (uint32_t) ( picture_control_set_ptr->ois_sb_results[sb_index]->ois_candidate_array[0][bestOisCuIndex].distortion  >> (12 - SAD_PRECISION_INTERVAL));//change 12 to 2*log2(64) ;
 #endif
-                            intra_sad_interval_index = (uint16_t)(intra_sad_interval_index >> 2);
-                            if (intra_sad_interval_index > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
-                                uint32_t sadIntervalIndexTemp = intra_sad_interval_index - ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
+                        intra_sad_interval_index = (uint16_t)(intra_sad_interval_index >> 2);
+                        if (intra_sad_interval_index > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
+                            uint32_t sadIntervalIndexTemp = intra_sad_interval_index - ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
 
-                                intra_sad_interval_index = ((NUMBER_OF_SAD_INTERVALS >> 1) - 1) + (sadIntervalIndexTemp >> 3);
-
-                            }
-                            if (intra_sad_interval_index >= NUMBER_OF_SAD_INTERVALS - 1)
-                                intra_sad_interval_index = NUMBER_OF_SAD_INTERVALS - 1;
+                            intra_sad_interval_index = ((NUMBER_OF_SAD_INTERVALS >> 1) - 1) + (sadIntervalIndexTemp >> 3);
 
+                        }
+                        if (intra_sad_interval_index >= NUMBER_OF_SAD_INTERVALS - 1)
+                            intra_sad_interval_index = NUMBER_OF_SAD_INTERVALS - 1;
 
-                            picture_control_set_ptr->intra_sad_interval_index[sb_index] = intra_sad_interval_index;
 
-                            picture_control_set_ptr->ois_distortion_histogram[intra_sad_interval_index] ++;
+                        picture_control_set_ptr->intra_sad_interval_index[sb_index] = intra_sad_interval_index;
 
-                            ++picture_control_set_ptr->full_sb_count;
-                        }
+                        picture_control_set_ptr->ois_distortion_histogram[intra_sad_interval_index] ++;
 
+                        ++picture_control_set_ptr->full_sb_count;
                     }
+
                 }
             }
-            else {
-                
+        }
+        else {
+            
 
 
-                for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
-                    for (xLcuIndex = xLcuStartIndex; xLcuIndex < xLcuEndIndex; ++xLcuIndex) {
-                        sb_origin_x = xLcuIndex * sequence_control_set_ptr->sb_sz;
-                        sb_origin_y = yLcuIndex * sequence_control_set_ptr->sb_sz;
-                        sb_width = (sequence_control_set_ptr->luma_width - sb_origin_x) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_width - sb_origin_x : BLOCK_SIZE_64;
-                        sb_height = (sequence_control_set_ptr->luma_height - sb_origin_y) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_height - sb_origin_y : BLOCK_SIZE_64;
+            for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
+                for (xLcuIndex = xLcuStartIndex; xLcuIndex < xLcuEndIndex; ++xLcuIndex) {
+                    sb_origin_x = xLcuIndex * sequence_control_set_ptr->sb_sz;
+                    sb_origin_y = yLcuIndex * sequence_control_set_ptr->sb_sz;
+                    sb_width = (sequence_control_set_ptr->luma_width - sb_origin_x) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_width - sb_origin_x : BLOCK_SIZE_64;
+                    sb_height = (sequence_control_set_ptr->luma_height - sb_origin_y) < BLOCK_SIZE_64 ? sequence_control_set_ptr->luma_height - sb_origin_y : BLOCK_SIZE_64;
 
-                        sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
+                    sb_index = (uint16_t)(xLcuIndex + yLcuIndex * picture_width_in_sb);
 
-                        picture_control_set_ptr->inter_sad_interval_index[sb_index] = 0;
-                        picture_control_set_ptr->intra_sad_interval_index[sb_index] = 0;
+                    picture_control_set_ptr->inter_sad_interval_index[sb_index] = 0;
+                    picture_control_set_ptr->intra_sad_interval_index[sb_index] = 0;
 
-                        if (sb_width == BLOCK_SIZE_64 && sb_height == BLOCK_SIZE_64) {
+                    if (sb_width == BLOCK_SIZE_64 && sb_height == BLOCK_SIZE_64) {
 
 #if RC 
 
-                            intra_sad_interval_index = picture_control_set_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64] >> 4;
+                        intra_sad_interval_index = picture_control_set_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64] >> 4;
 #else
-                            uint32_t                       bestOisCuIndex = 0;
-                            
-                            bestOisCuIndex =  picture_control_set_ptr->ois_sb_results[sb_index]->best_distortion_index[0];
-                            intra_sad_interval_index = (uint32_t) ( picture_control_set_ptr->ois_sb_results[sb_index]->ois_candidate_array[0][bestOisCuIndex].distortion  >> (12 - SAD_PRECISION_INTERVAL));//change 12 to 2*log2(64) ;
+                        uint32_t                       bestOisCuIndex = 0;
+                        
+                        bestOisCuIndex =  picture_control_set_ptr->ois_sb_results[sb_index]->best_distortion_index[0];
+                        intra_sad_interval_index = (uint32_t) ( picture_control_set_ptr->ois_sb_results[sb_index]->ois_candidate_array[0][bestOisCuIndex].distortion  >> (12 - SAD_PRECISION_INTERVAL));//change 12 to 2*log2(64) ;
 #endif
-                            intra_sad_interval_index = (uint16_t)(intra_sad_interval_index >> 2);
-                            if (intra_sad_interval_index > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
-                                uint32_t sadIntervalIndexTemp = intra_sad_interval_index - ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
+                        intra_sad_interval_index = (uint16_t)(intra_sad_interval_index >> 2);
+                        if (intra_sad_interval_index > (NUMBER_OF_SAD_INTERVALS >> 1) - 1) {
+                            uint32_t sadIntervalIndexTemp = intra_sad_interval_index - ((NUMBER_OF_SAD_INTERVALS >> 1) - 1);
 
-                                intra_sad_interval_index = ((NUMBER_OF_SAD_INTERVALS >> 1) - 1) + (sadIntervalIndexTemp >> 3);
+                            intra_sad_interval_index = ((NUMBER_OF_SAD_INTERVALS >> 1) - 1) + (sadIntervalIndexTemp >> 3);
 
-                            }
-                            if (intra_sad_interval_index >= NUMBER_OF_SAD_INTERVALS - 1)
-                                intra_sad_interval_index = NUMBER_OF_SAD_INTERVALS - 1;
-
-                            picture_control_set_ptr->intra_sad_interval_index[sb_index] = intra_sad_interval_index;
+                        }
+                        if (intra_sad_interval_index >= NUMBER_OF_SAD_INTERVALS - 1)
+                            intra_sad_interval_index = NUMBER_OF_SAD_INTERVALS - 1;
 
-                            picture_control_set_ptr->ois_distortion_histogram[intra_sad_interval_index] ++;
+                        picture_control_set_ptr->intra_sad_interval_index[sb_index] = intra_sad_interval_index;
 
-                            ++picture_control_set_ptr->full_sb_count;
-                        }
+                        picture_control_set_ptr->ois_distortion_histogram[intra_sad_interval_index] ++;
 
+                        ++picture_control_set_ptr->full_sb_count;
                     }
+
                 }
             }
         }
+    }
 
-        eb_release_mutex(picture_control_set_ptr->rc_distortion_histogram_mutex);
+    eb_release_mutex(picture_control_set_ptr->rc_distortion_histogram_mutex);
 
-        // Get Empty Results Object
-        eb_get_empty_object(
-            context_ptr->motionEstimationResultsOutputFifoPtr,
-            &outputResultsWrapperPtr);
+    // Get Empty Results Object
+    eb_get_empty_object(
+        context_ptr->motionEstimationResultsOutputFifoPtr,
+        &outputResultsWrapperPtr);
 
-        outputResultsPtr = (MotionEstimationResults_t*)outputResultsWrapperPtr->object_ptr;
-        outputResultsPtr->picture_control_set_wrapper_ptr = inputResultsPtr->picture_control_set_wrapper_ptr;
-        outputResultsPtr->segment_index = segment_index;
+    outputResultsPtr = (MotionEstimationResults_t*)outputResultsWrapperPtr->object_ptr;
+    outputResultsPtr->picture_control_set_wrapper_ptr = inputResultsPtr->picture_control_set_wrapper_ptr;
+    outputResultsPtr->segment_index = segment_index;
 
-        // Release the Input Results
-        eb_release_object(inputResultsWrapperPtr);
+    eb_deadline_work_end(
+        sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr,
+        &picture_control_set_ptr->encode_time_us,
+        workStartTime);
 
-        // Post the Full Results Object
-        eb_post_full_object(outputResultsWrapperPtr);
-    }
-    return EB_NULL;
+    // Release the Input Results
+    eb_release_object(inputResultsWrapperPtr);
+
+    // Post the Full Results Object
+    eb_post_full_object(outputResultsWrapperPtr);
 }
@@ -36,6 +36,8 @@ extern EbErrorType MotionEstimationContextCtor(
     EbFifo                     *motionEstimationResultsOutputFifoPtr);
 
 
-extern void* MotionEstimationKernel(void *input_ptr);
+extern void MotionEstimationKernel(
+    void            *input_ptr,
+    EbObjectWrapper *inputResultsWrapperPtr);
 
 #endif // EbMotionEstimationProcess_h
\ No newline at end of file
@@ -19,6 +19,10 @@ extern "C" {
 #define TU_NEIGHBOR_ARRAY_GRANULARITY                   4
 #define SAMPLE_NEIGHBOR_ARRAY_GRANULARITY               1
 
+    // Size of the neighbor arrays of a picture: its size in whole SBs, plus one SB
+    // for the above right and below left samples read by the blocks at the edges
+#define NEIGHBOR_ARRAY_PICTURE_SIZE(picture_size)       ((((picture_size) + MAX_SB_SIZE - 1) / MAX_SB_SIZE + 1) * MAX_SB_SIZE)
+
     typedef enum NEIGHBOR_ARRAY_TYPE
     {
         NEIGHBOR_ARRAY_LEFT = 0,
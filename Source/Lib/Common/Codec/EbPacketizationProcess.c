@@ -276,6 +276,7 @@ void* PacketizationKernel(void *input_ptr)
             &entropyCodingResultsWrapperPtr);
         entropyCodingResultsPtr = (EntropyCodingResults_t*)entropyCodingResultsWrapperPtr->object_ptr;
         picture_control_set_ptr = (PictureControlSet_t*)entropyCodingResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
+        eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
         sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
         encode_context_ptr = (EncodeContext_t*)sequence_control_set_ptr->encode_context_ptr;
 
@@ -288,6 +289,8 @@ void* PacketizationKernel(void *input_ptr)
         queueEntryPtr = encode_context_ptr->packetization_reorder_queue[queueEntryIndex];
         queueEntryPtr->start_time_seconds = picture_control_set_ptr->parent_pcs_ptr->start_time_seconds;
         queueEntryPtr->start_time_u_seconds = picture_control_set_ptr->parent_pcs_ptr->start_time_u_seconds;
+        queueEntryPtr->arrival_time_us = picture_control_set_ptr->parent_pcs_ptr->arrival_time_us;
+        queueEntryPtr->encode_time_us = (uint64_t)picture_control_set_ptr->parent_pcs_ptr->encode_time_us;
 
         //TODO: The output buffer should be big enough to avoid a deadlock here. Add an assert that make the warning
         // Get  Output Bitstream buffer
@@ -302,6 +305,10 @@ void* PacketizationKernel(void *input_ptr)
             picture_control_set_ptr->parent_pcs_ptr->idr_flag ? EB_AV1_KEY_PICTURE :
             picture_control_set_ptr->slice_type : EB_AV1_NON_REF_PICTURE;
         output_stream_ptr->p_app_private = picture_control_set_ptr->parent_pcs_ptr->input_ptr->p_app_private;
+        output_stream_ptr->effort_level = picture_control_set_ptr->parent_pcs_ptr->effort_level;
+        output_stream_ptr->late_sb_count = (uint32_t)picture_control_set_ptr->parent_pcs_ptr->late_sb_count;
+        output_stream_ptr->luma_txb_count = (uint32_t)picture_control_set_ptr->parent_pcs_ptr->luma_txb_count;
+        output_stream_ptr->reused_luma_txb_count = (uint32_t)picture_control_set_ptr->parent_pcs_ptr->reused_luma_txb_count;
 
         // Get Empty Rate Control Input Tasks
         eb_get_empty_object(
@@ -572,6 +579,16 @@ void* PacketizationKernel(void *input_ptr)
                 &latency);
 
             output_stream_ptr->n_tick_count = (uint32_t)latency;
+
+            // Deadline speed control, in decode order
+            if (encode_context_ptr->deadline_control_ptr) {
+                eb_deadline_control_output_picture(
+                    encode_context_ptr->deadline_control_ptr,
+                    queueEntryPtr->poc,
+                    queueEntryPtr->picture_number,
+                    queueEntryPtr->arrival_time_us,
+                    queueEntryPtr->encode_time_us);
+            }
             output_stream_ptr->p_app_private = queueEntryPtr->outMetaData;
             eb_post_full_object(output_stream_wrapper_ptr);
             queueEntryPtr->outMetaData = (EbLinkedListNode *)EB_NULL;
@@ -25,6 +25,8 @@ extern "C" {
 
         uint64_t                          start_time_seconds;
         uint64_t                          start_time_u_seconds;
+        uint64_t                          arrival_time_us;
+        uint64_t                          encode_time_us;
 
         uint8_t                                 slice_type;
         uint64_t                                refPOCList0;
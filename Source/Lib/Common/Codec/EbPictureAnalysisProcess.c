@@ -23,6 +23,7 @@
 #include "EbMeSadCalculation.h"
 #include "EbComputeMean_SSE2.h"
 #include "EbCombinedAveragingSAD_Intrinsic_AVX2.h"
+#include "aom_dsp_rtcd.h"
 
 #define VARIANCE_PRECISION        16
 #define  LCU_LOW_VAR_TH                5
@@ -37,6 +38,9 @@
 #define DENOISER_BITRATE_TH        14000000
 #define SAMPLE_THRESHOLD_PRECENT_BORDER_LINE      15
 #define SAMPLE_THRESHOLD_PRECENT_TWO_BORDER_LINES 10
+#define SC_BLOCK_SIZE             16
+#define SC_MAX_COLOR_COUNT        4  // experimentally selected
+#define SC_AREA_PERCENTAGE_TH     10
 
 /************************************************
 * Picture Analysis Context Constructor
@@ -46,6 +50,7 @@ EbErrorType picture_analysis_context_ctor(
     EbBool                         denoise_flag,
     PictureAnalysisContext_t **context_dbl_ptr,
     EbFifo *resource_coordination_results_input_fifo_ptr,
+    EbFifo *pa_feedback_fifo_ptr,
     EbFifo *picture_analysis_results_output_fifo_ptr)
 {
     PictureAnalysisContext_t *context_ptr;
@@ -53,6 +58,7 @@ EbErrorType picture_analysis_context_ctor(
     *context_dbl_ptr = context_ptr;
 
     context_ptr->resource_coordination_results_input_fifo_ptr = resource_coordination_results_input_fifo_ptr;
+    context_ptr->pa_feedback_fifo_ptr = pa_feedback_fifo_ptr;
     context_ptr->picture_analysis_results_output_fifo_ptr = picture_analysis_results_output_fifo_ptr;
 
     EbErrorType return_error = EB_ErrorNone;
@@ -93,6 +99,15 @@ EbErrorType picture_analysis_context_ctor(
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
+
+        // film grain denoising rows run on this thread
+        return_error = aom_denoise_row_buffers_ctor(
+            &context_ptr->denoise_row_buffers_ptr,
+            DENOISING_BlockSize);
+
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
     }
     return EB_ErrorNone;
 
@@ -3392,38 +3407,27 @@ EbErrorType DetectInputPictureNoise(
 
 }
 
-static int32_t apply_denoise_2d(SequenceControlSet        *scsPtr,
-    PictureParentControlSet_t   *pcsPtr,
-    EbPictureBufferDesc_t *inputPicturePointer,
-    EbAsm asm_type) {
-
-
-    if (aom_denoise_and_model_run(pcsPtr->denoise_and_model, inputPicturePointer,
-        &pcsPtr->film_grain_params,
-        scsPtr->static_config.encoder_bit_depth > EB_8BIT, asm_type)) {
-    }
-    return 0;
-}
-
-
-EbErrorType denoise_estimate_film_grain(
-    SequenceControlSet        *sequence_control_set_ptr,
-    PictureParentControlSet_t   *picture_control_set_ptr,
-    EbAsm asm_type)
+/************************************************
+ * Start Film Grain Denoising
+ ** Returns EB_TRUE when the picture is denoised by
+ ** rows, else the noise estimate is already reset
+ ************************************************/
+static EbBool StartFilmGrainDenoising(
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbAsm                           asm_type)
 {
-    EbErrorType return_error = EB_ErrorNone;
+    EbPictureBufferDesc_t *input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
 
-    EbPictureBufferDesc_t    *input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
     picture_control_set_ptr->film_grain_params.apply_grain = 0;
-
-    if (sequence_control_set_ptr->film_grain_denoise_strength) {
-        if (apply_denoise_2d(sequence_control_set_ptr, picture_control_set_ptr, input_picture_ptr, asm_type) < 0)
-            return 1;
-    }
-
-    sequence_control_set_ptr->film_grain_params_present |= picture_control_set_ptr->film_grain_params.apply_grain;
-
-    return return_error;  //todo: add proper error handling
+    if (aom_denoise_and_model_start(picture_control_set_ptr->denoise_and_model, input_picture_ptr,
+        sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT, asm_type))
+        return EB_TRUE;
+
+    // Releases the buffers of the failed start
+    aom_denoise_and_model_finish(picture_control_set_ptr->denoise_and_model, input_picture_ptr,
+        &picture_control_set_ptr->film_grain_params, asm_type);
+    return EB_FALSE;
 }
 
 
@@ -4104,36 +4108,20 @@ void SetPictureParametersForStatisticsGathering(
  *** A function that groups all of the Pre proceesing
  * operations performed on the input picture
  *** Operations included at this point:
- ***** Borders preprocessing
- ***** Denoising
+ ***** Noise flags reset without film grain denoising
  ************************************************/
 void PicturePreProcessingOperations(
     PictureParentControlSet_t       *picture_control_set_ptr,
-    EbPictureBufferDesc_t           *input_picture_ptr,
     SequenceControlSet            *sequence_control_set_ptr,
-    EbPictureBufferDesc_t           *quarter_decimated_picture_ptr,
-    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr,
-    uint32_t                           sb_total_count,
-    EbAsm                           asm_type) {
-
-    UNUSED(quarter_decimated_picture_ptr);
-    UNUSED(sixteenth_decimated_picture_ptr);
-    UNUSED(input_picture_ptr);
+    uint32_t                           sb_total_count) {
 
-    if (sequence_control_set_ptr->film_grain_denoise_strength) {
-
-        denoise_estimate_film_grain(
-            sequence_control_set_ptr,
-            picture_control_set_ptr,
-            asm_type);
-    }
-    else {
+    // The film grain denoising is run by rows, see DenoiseRows()
+    if (!sequence_control_set_ptr->film_grain_denoise_strength) {
         //Reset the flat noise flag array to False for both RealTime/HighComplexity Modes
         for (uint32_t lcuCodingOrder = 0; lcuCodingOrder < sb_total_count; ++lcuCodingOrder) {
             picture_control_set_ptr->sb_flat_noise_array[lcuCodingOrder] = 0;
         }
         picture_control_set_ptr->pic_noise_class = PIC_NOISE_CLASS_INV; //this init is for both REAL-TIME and BEST-QUALITY
-        
     }
     return;
 
@@ -4623,17 +4611,66 @@ void DetermineHomogeneousRegionInPicture(
     return;
 }
 /************************************************
- * ComputePictureSpatialStatistics
+ * Count Screen Content Blocks
+ ** Number of 16x16 luma blocks of the SB with 2 to
+ ** SC_MAX_COLOR_COUNT colors
+ ** Runs on the SB the variance calculation just loaded
+ ************************************************/
+static uint32_t CountScreenContentBlocks(
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbPictureBufferDesc_t           *input_padded_picture_ptr,
+    SbParams_t                      *sb_params,
+    uint32_t                           inputLumaOriginIndex)
+{
+    // 10 bit input is split into 8 bit samples and 2 bit increments, the
+    // compressed format packs the increments and is counted on 8 bits
+    EbPictureBufferDesc_t *input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+    const EbBool useHighBitDepth = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT &&
+        !sequence_control_set_ptr->static_config.compressed_ten_bit_format);
+    uint32_t blockCount = 0;
+    uint32_t colorCount;
+
+    for (uint32_t y = 0; y + SC_BLOCK_SIZE <= sb_params->height; y += SC_BLOCK_SIZE) {
+        for (uint32_t x = 0; x + SC_BLOCK_SIZE <= sb_params->width; x += SC_BLOCK_SIZE) {
+            const uint32_t blockIndex = inputLumaOriginIndex + y * input_padded_picture_ptr->stride_y + x;
+
+            if (useHighBitDepth) {
+                const uint32_t bitIncIndex = (input_picture_ptr->origin_y + sb_params->origin_y + y) * input_picture_ptr->strideBitIncY +
+                    input_picture_ptr->origin_x + sb_params->origin_x + x;
+                colorCount = eb_count_colors_16x16_highbd(
+                    &input_padded_picture_ptr->buffer_y[blockIndex],
+                    input_padded_picture_ptr->stride_y,
+                    &input_picture_ptr->bufferBitIncY[bitIncIndex],
+                    input_picture_ptr->strideBitIncY,
+                    SC_MAX_COLOR_COUNT);
+            }
+            else {
+                colorCount = eb_count_colors_16x16(
+                    &input_padded_picture_ptr->buffer_y[blockIndex],
+                    input_padded_picture_ptr->stride_y,
+                    SC_MAX_COLOR_COUNT);
+            }
+            if (colorCount > 1 && colorCount <= SC_MAX_COLOR_COUNT)
+                blockCount++;
+        }
+    }
+    return blockCount;
+}
+
+/************************************************
+ * ComputeSegmentSpatialStatistics
  ** Compute Block Variance
- ** Compute Picture Variance
- ** Compute Block Mean for all blocks in the picture
+ ** Compute Block Mean for the SBs of a segment
+ ** Count the screen content blocks
  ************************************************/
-void ComputePictureSpatialStatistics(
+static void ComputeSegmentSpatialStatistics(
     SequenceControlSet            *sequence_control_set_ptr,
     PictureParentControlSet_t       *picture_control_set_ptr,
     EbPictureBufferDesc_t           *input_picture_ptr,
     EbPictureBufferDesc_t           *input_padded_picture_ptr,
-    uint32_t                           sb_total_count,
+    uint32_t                           sbStartIndex,
+    uint32_t                           sbEndIndex,
     EbAsm                           asm_type)
 {
     uint32_t sb_index;
@@ -4642,12 +4679,10 @@ void ComputePictureSpatialStatistics(
     uint32_t inputLumaOriginIndex;
     uint32_t inputCbOriginIndex;
     uint32_t inputCrOriginIndex;
-    uint64_t picTotVariance;
-
-    // Variance
-    picTotVariance = 0;
+    uint32_t scBlockCount = 0;
+    uint32_t scTestedArea = 0;
 
-    for (sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
+    for (sb_index = sbStartIndex; sb_index < sbEndIndex; ++sb_index) {
         SbParams_t   *sb_params = &sequence_control_set_ptr->sb_params_array[sb_index];
 
         sb_origin_x = sb_params->origin_x;
@@ -4666,6 +4701,18 @@ void ComputePictureSpatialStatistics(
             inputLumaOriginIndex,
             asm_type);
 
+        // Screen content detection, every other SB in SC_DETECTION_SAMPLED
+        if (sequence_control_set_ptr->sc_detection_mode == SC_DETECTION_FULL ||
+            ((sb_params->horizontal_index + sb_params->vertical_index) & 1) == 0) {
+            scBlockCount += CountScreenContentBlocks(
+                sequence_control_set_ptr,
+                picture_control_set_ptr,
+                input_padded_picture_ptr,
+                sb_params,
+                inputLumaOriginIndex);
+            scTestedArea += sb_params->width * sb_params->height;
+        }
+
         if (sb_params->is_complete_sb) {
 
             ComputeChromaBlockMean(
@@ -4682,11 +4729,40 @@ void ComputePictureSpatialStatistics(
                 picture_control_set_ptr,
                 sb_index);
         }
+    }
+
+    eb_atomic_fetch_add_32(&picture_control_set_ptr->sc_block_count, (int32_t)scBlockCount);
+    eb_atomic_fetch_add_32(&picture_control_set_ptr->sc_tested_area, (int32_t)scTestedArea);
 
+    return;
+}
+
+/************************************************
+ * ComputePictureSpatialStatistics
+ ** Compute Picture Variance
+ ** Once the statistics of all the SBs are computed
+ ************************************************/
+void ComputePictureSpatialStatistics(
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    uint32_t                           sb_total_count)
+{
+    uint32_t sb_index;
+    uint64_t picTotVariance;
+    uint64_t scBlockCount = (uint32_t)eb_atomic_load_32(&picture_control_set_ptr->sc_block_count);
+    uint64_t scTestedArea = (uint32_t)eb_atomic_load_32(&picture_control_set_ptr->sc_tested_area);
+
+    // Variance
+    picTotVariance = 0;
+
+    for (sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
         picTotVariance += (picture_control_set_ptr->variance[sb_index][RASTER_SCAN_CU_INDEX_64x64]);
     }
 
     picture_control_set_ptr->pic_avg_variance = (uint16_t)(picTotVariance / sb_total_count);
+    // Screen content when the blocks of few colors cover more than 10% of the tested area
+    picture_control_set_ptr->sc_content_detected = (uint8_t)(
+        scBlockCount * SC_BLOCK_SIZE * SC_BLOCK_SIZE * 100 > scTestedArea * SC_AREA_PERCENTAGE_TH);
     // Calculate the variance of variance to determine Homogeneous regions. Note: Variance calculation should be on.
     DetermineHomogeneousRegionInPicture(
         sequence_control_set_ptr,
@@ -4755,12 +4831,12 @@ void CalculateInputAverageIntensity(
  * Gathering statistics per picture
  ** Calculating the pixel intensity histogram bins per picture needed for SCD
  ** Computing Picture Variance
+ ** Run once the segments computed the SB statistics
  ************************************************/
 void GatheringPictureStatistics(
     SequenceControlSet            *sequence_control_set_ptr,
     PictureParentControlSet_t       *picture_control_set_ptr,
     EbPictureBufferDesc_t           *input_picture_ptr,
-    EbPictureBufferDesc_t           *input_padded_picture_ptr,
     EbPictureBufferDesc_t            *sixteenth_decimated_picture_ptr,
     uint32_t                           sb_total_count,
     EbAsm                           asm_type)
@@ -4804,10 +4880,7 @@ void GatheringPictureStatistics(
     ComputePictureSpatialStatistics(
         sequence_control_set_ptr,
         picture_control_set_ptr,
-        input_picture_ptr,
-        input_padded_picture_ptr,
-        sb_total_count,
-        asm_type);
+        sb_total_count);
 
     return;
 }
@@ -4903,12 +4976,16 @@ void PadPictureToMultipleOfLcuDimensions(
 
 /************************************************
 * 1/4 & 1/16 input picture decimation
+** Of the input rows [rowStart, rowEnd), rowStart
+** multiple of 4
 ************************************************/
 void DecimateInputPicture(
     PictureParentControlSet_t       *picture_control_set_ptr,
     EbPictureBufferDesc_t           *input_padded_picture_ptr,
     EbPictureBufferDesc_t           *quarter_decimated_picture_ptr,
-    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr) {
+    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr,
+    uint32_t                           rowStart,
+    uint32_t                           rowEnd) {
 
 
     // Decimate input picture for HME L0 and L1
@@ -4916,35 +4993,51 @@ void DecimateInputPicture(
 
         if (picture_control_set_ptr->enable_hme_level1_flag) {
             Decimation2D(
-                &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x + input_padded_picture_ptr->origin_y * input_padded_picture_ptr->stride_y],
+                &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x + (input_padded_picture_ptr->origin_y + rowStart) * input_padded_picture_ptr->stride_y],
                 input_padded_picture_ptr->stride_y,
                 input_padded_picture_ptr->width,
-                input_padded_picture_ptr->height,
-                &quarter_decimated_picture_ptr->buffer_y[quarter_decimated_picture_ptr->origin_x + quarter_decimated_picture_ptr->origin_x*quarter_decimated_picture_ptr->stride_y],
+                rowEnd - rowStart,
+                &quarter_decimated_picture_ptr->buffer_y[quarter_decimated_picture_ptr->origin_x + (quarter_decimated_picture_ptr->origin_x + (rowStart >> 1))*quarter_decimated_picture_ptr->stride_y],
                 quarter_decimated_picture_ptr->stride_y,
                 2);
-            generate_padding(
-                &quarter_decimated_picture_ptr->buffer_y[0],
-                quarter_decimated_picture_ptr->stride_y,
-                quarter_decimated_picture_ptr->width,
-                quarter_decimated_picture_ptr->height,
-                quarter_decimated_picture_ptr->origin_x,
-                quarter_decimated_picture_ptr->origin_y);
-
         }
 
         if (picture_control_set_ptr->enable_hme_level0_flag) {
 
             // Sixteenth Input Picture Decimation
             Decimation2D(
-                &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x + input_padded_picture_ptr->origin_y * input_padded_picture_ptr->stride_y],
+                &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x + (input_padded_picture_ptr->origin_y + rowStart) * input_padded_picture_ptr->stride_y],
                 input_padded_picture_ptr->stride_y,
                 input_padded_picture_ptr->width,
-                input_padded_picture_ptr->height,
-                &sixteenth_decimated_picture_ptr->buffer_y[sixteenth_decimated_picture_ptr->origin_x + sixteenth_decimated_picture_ptr->origin_x*sixteenth_decimated_picture_ptr->stride_y],
+                rowEnd - rowStart,
+                &sixteenth_decimated_picture_ptr->buffer_y[sixteenth_decimated_picture_ptr->origin_x + (sixteenth_decimated_picture_ptr->origin_x + (rowStart >> 2))*sixteenth_decimated_picture_ptr->stride_y],
                 sixteenth_decimated_picture_ptr->stride_y,
                 4);
+        }
+    }
+}
 
+/************************************************
+* Pad the 1/4 & 1/16 decimated pictures
+************************************************/
+void PadDecimatedPicture(
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbPictureBufferDesc_t           *quarter_decimated_picture_ptr,
+    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr) {
+
+    if (picture_control_set_ptr->enable_hme_flag) {
+
+        if (picture_control_set_ptr->enable_hme_level1_flag) {
+            generate_padding(
+                &quarter_decimated_picture_ptr->buffer_y[0],
+                quarter_decimated_picture_ptr->stride_y,
+                quarter_decimated_picture_ptr->width,
+                quarter_decimated_picture_ptr->height,
+                quarter_decimated_picture_ptr->origin_x,
+                quarter_decimated_picture_ptr->origin_y);
+        }
+
+        if (picture_control_set_ptr->enable_hme_level0_flag) {
             generate_padding(
                 &sixteenth_decimated_picture_ptr->buffer_y[0],
                 sixteenth_decimated_picture_ptr->stride_y,
@@ -4952,51 +5045,280 @@ void DecimateInputPicture(
                 sixteenth_decimated_picture_ptr->height,
                 sixteenth_decimated_picture_ptr->origin_x,
                 sixteenth_decimated_picture_ptr->origin_y);
-
         }
     }
 }
-int av1_count_colors(const uint8_t *src, int stride, int rows, int cols,
-    int *val_count) {
-    const int max_pix_val = 1 << 8;
-    memset(val_count, 0, max_pix_val * sizeof(val_count[0]));
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            const int this_val = src[r * stride + c];
-            assert(this_val < max_pix_val);
-            ++val_count[this_val];
+/************************************************
+ * Count the colors of a 16x16 block
+ ** Returns limit + 1 as soon as more than limit colors are found
+ ************************************************/
+uint32_t eb_count_colors_16x16_c(
+    const uint8_t *src,
+    int32_t        stride,
+    uint32_t       limit)
+{
+    uint8_t  colors[SC_BLOCK_SIZE * SC_BLOCK_SIZE];
+    uint32_t count = 0;
+    uint32_t i;
+
+    for (int32_t y = 0; y < SC_BLOCK_SIZE; ++y) {
+        for (int32_t x = 0; x < SC_BLOCK_SIZE; ++x) {
+            const uint8_t value = src[y * stride + x];
+            for (i = 0; i < count && colors[i] != value; ++i);
+            if (i == count) {
+                if (count == limit)
+                    return limit + 1;
+                colors[count++] = value;
+            }
         }
     }
-    int n = 0;
-    for (int i = 0; i < max_pix_val; ++i) {
-        if (val_count[i]) ++n;
+    return count;
+}
+
+uint32_t eb_count_colors_16x16_highbd_c(
+    const uint8_t *src,
+    int32_t        stride,
+    const uint8_t *src_bit_inc,
+    int32_t        bit_inc_stride,
+    uint32_t       limit)
+{
+    uint16_t colors[SC_BLOCK_SIZE * SC_BLOCK_SIZE];
+    uint32_t count = 0;
+    uint32_t i;
+
+    for (int32_t y = 0; y < SC_BLOCK_SIZE; ++y) {
+        for (int32_t x = 0; x < SC_BLOCK_SIZE; ++x) {
+            const uint16_t value = (uint16_t)((src[y * stride + x] << 2) | (src_bit_inc[y * bit_inc_stride + x] >> 6));
+            for (i = 0; i < count && colors[i] != value; ++i);
+            if (i == count) {
+                if (count == limit)
+                    return limit + 1;
+                colors[count++] = value;
+            }
+        }
+    }
+    return count;
+}
+
+/************************************************
+ * Analyze Picture Segments
+ ** Claims the segments of the picture until none is
+ ** left: decimation and SB statistics of the SB rows
+ ** of each segment
+ ** Returns EB_TRUE to the thread completing the last
+ ** segment
+ ************************************************/
+EbBool AnalyzePictureSegments(
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbPictureBufferDesc_t           *input_padded_picture_ptr,
+    EbPictureBufferDesc_t           *quarter_decimated_picture_ptr,
+    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr,
+    uint32_t                           picture_width_in_sb,
+    uint32_t                           pictureHeighInLcu,
+    EbAsm                           asm_type)
+{
+    const int32_t segmentCount = picture_control_set_ptr->pa_segments_row_count;
+    EbBool        lastSegmentFlag = EB_FALSE;
+    int32_t       segment_index;
+    uint32_t      yLcuStartIndex;
+    uint32_t      yLcuEndIndex;
+    uint32_t      rowEnd;
+
+    while ((segment_index = eb_atomic_fetch_add_32(&picture_control_set_ptr->pa_next_segment, 1)) < segmentCount) {
+        yLcuStartIndex = SEGMENT_START_IDX(segment_index, pictureHeighInLcu, segmentCount);
+        yLcuEndIndex = SEGMENT_END_IDX(segment_index, pictureHeighInLcu, segmentCount);
+        rowEnd = (segment_index == segmentCount - 1) ?
+            input_padded_picture_ptr->height :
+            yLcuEndIndex * sequence_control_set_ptr->sb_sz;
+
+        // 1/4 & 1/16 input picture decimation
+        DecimateInputPicture(
+            picture_control_set_ptr,
+            input_padded_picture_ptr,
+            quarter_decimated_picture_ptr,
+            sixteenth_decimated_picture_ptr,
+            yLcuStartIndex * sequence_control_set_ptr->sb_sz,
+            rowEnd);
+
+        ComputeSegmentSpatialStatistics(
+            sequence_control_set_ptr,
+            picture_control_set_ptr,
+            picture_control_set_ptr->chroma_downsampled_picture_ptr, //420 input_picture_ptr
+            input_padded_picture_ptr,
+            yLcuStartIndex * picture_width_in_sb,
+            yLcuEndIndex * picture_width_in_sb,
+            asm_type);
+
+        if (eb_atomic_fetch_add_32(&picture_control_set_ptr->pa_done_segment_count, 1) == segmentCount - 1)
+            lastSegmentFlag = EB_TRUE;
+    }
+
+    return lastSegmentFlag;
+}
+
+/************************************************
+ * Post Picture Analysis Feedback
+ ** Lets up to helperCount idle PA threads join the
+ ** denoising rows or the segments of the picture; the
+ ** feedback is skipped rather than waited for when the
+ ** results are all in use, as only the PA threads
+ ** release them.
+ ************************************************/
+static void PostPictureAnalysisFeedback(
+    PictureAnalysisContext_t        *context_ptr,
+    EbObjectWrapper                 *picture_control_set_wrapper_ptr,
+    uint32_t                         helperCount,
+    EbBool                           denoiseFlag)
+{
+    EbObjectWrapper             *feedbackWrapperPtr;
+    ResourceCoordinationResults *feedbackPtr;
+    uint32_t                     helperIndex;
+
+    for (helperIndex = 0; helperIndex < helperCount; ++helperIndex) {
+        eb_try_get_empty_object(
+            context_ptr->pa_feedback_fifo_ptr,
+            &feedbackWrapperPtr);
+        if (feedbackWrapperPtr == (EbObjectWrapper*)EB_NULL)
+            break;
+
+        // The helper releases the picture once done with it
+        eb_object_inc_live_count(
+            picture_control_set_wrapper_ptr,
+            1);
+
+        feedbackPtr = (ResourceCoordinationResults*)feedbackWrapperPtr->object_ptr;
+        feedbackPtr->picture_control_set_wrapper_ptr = picture_control_set_wrapper_ptr;
+        feedbackPtr->segment_join_flag = (EbBool)!denoiseFlag;
+        feedbackPtr->denoise_join_flag = denoiseFlag;
+        eb_post_full_object(feedbackWrapperPtr);
     }
-    return n;
 }
-// Estimate if the source frame is screen content, based on the portion of
-// blocks that have no more than 4 (experimentally selected) luma colors.
-static int is_screen_content(const uint8_t *src, int use_hbd,
-    int stride, int width, int height) {
-    assert(src != NULL);
-    int counts = 0;
-    const int blk_w = 16;
-    const int blk_h = 16;
-    const int limit = 4;
-    for (int r = 0; r + blk_h <= height; r += blk_h) {
-        for (int c = 0; c + blk_w <= width; c += blk_w) {
-            int count_buf[1 << 12];  // Maximum (1 << 12) color levels.
-            const int n_colors =
-                use_hbd ? 0 /*av1_count_colors_highbd(src + r * stride + c, stride, blk_w,
-                    blk_h, bd, count_buf)*/
-                : av1_count_colors(src + r * stride + c, stride, blk_w, blk_h,
-                    count_buf);
-            if (n_colors > 1 && n_colors <= limit) counts++;
+
+/************************************************
+ * Denoise Publish Rows
+ ** Makes the rows of a denoising phase claimable
+ ** and lets idle PA threads join them
+ ************************************************/
+static void DenoisePublishRows(
+    PictureAnalysisContext_t        *context_ptr,
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbObjectWrapper                 *picture_control_set_wrapper_ptr,
+    aom_denoise_phase_t              phase)
+{
+    SbRowSync_t *rowSyncPtr = picture_control_set_ptr->denoise_row_sync[phase];
+    const uint32_t rowCount = (uint32_t)aom_denoise_and_model_row_count(picture_control_set_ptr->denoise_and_model, phase);
+
+    eb_block_on_mutex(rowSyncPtr->mutex);
+    SbRowSyncInit(rowSyncPtr, rowCount, 1);
+    rowSyncPtr->readyRowCount = rowCount;
+    eb_release_mutex(rowSyncPtr->mutex);
+
+    PostPictureAnalysisFeedback(
+        context_ptr,
+        picture_control_set_wrapper_ptr,
+        MIN(rowCount, sequence_control_set_ptr->picture_analysis_process_init_count) - 1,
+        EB_TRUE);
+}
+
+/************************************************
+ * Denoise Rows
+ ** Claims the rows of the film grain denoising and
+ ** noise modeling phases until none is left. The
+ ** thread completing the last row of a phase ends it
+ ** and publishes the next one.
+ ** Returns EB_TRUE to the thread ending the last
+ ** phase, once the noise estimate is set
+ ************************************************/
+static EbBool DenoiseRows(
+    PictureAnalysisContext_t        *context_ptr,
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbObjectWrapper                 *picture_control_set_wrapper_ptr,
+    EbAsm                           asm_type)
+{
+    struct aom_denoise_and_model_t *denoiseAndModelPtr = picture_control_set_ptr->denoise_and_model;
+    EbBool   claimedFlag = EB_TRUE;
+    int32_t  phase;
+    uint32_t row;
+
+    while (claimedFlag) {
+        claimedFlag = EB_FALSE;
+        for (phase = 0; phase < AOM_DENOISE_PHASE_COUNT && !claimedFlag; ++phase) {
+            SbRowSync_t *rowSyncPtr = picture_control_set_ptr->denoise_row_sync[phase];
+            if (SbRowSyncClaimRow(rowSyncPtr, &row) == EB_FALSE)
+                continue;
+            claimedFlag = EB_TRUE;
+
+            aom_denoise_and_model_run_row(denoiseAndModelPtr, context_ptr->denoise_row_buffers_ptr, (aom_denoise_phase_t)phase, (int32_t)row);
+
+            if (SbRowSyncCompleteRow(rowSyncPtr) == EB_TRUE) {
+                aom_denoise_and_model_end_phase(denoiseAndModelPtr, (aom_denoise_phase_t)phase);
+                if (phase + 1 == AOM_DENOISE_PHASE_COUNT) {
+                    aom_denoise_and_model_finish(
+                        denoiseAndModelPtr,
+                        picture_control_set_ptr->enhanced_picture_ptr,
+                        &picture_control_set_ptr->film_grain_params,
+                        asm_type);
+                    sequence_control_set_ptr->film_grain_params_present |= picture_control_set_ptr->film_grain_params.apply_grain;
+                    return EB_TRUE;
+                }
+                DenoisePublishRows(
+                    context_ptr,
+                    sequence_control_set_ptr,
+                    picture_control_set_ptr,
+                    picture_control_set_wrapper_ptr,
+                    (aom_denoise_phase_t)(phase + 1));
+            }
         }
     }
-    // The threshold is 10%.
-    return counts * blk_h * blk_w * 10 > width * height;
+
+    return EB_FALSE;
 }
 
+/************************************************
+ * Prepare Picture Segments
+ ** Finishes the input picture once denoised and lets
+ ** idle PA threads join its analysis segments
+ ************************************************/
+static void PreparePictureSegments(
+    PictureAnalysisContext_t        *context_ptr,
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbObjectWrapper                 *picture_control_set_wrapper_ptr,
+    EbPictureBufferDesc_t           *input_padded_picture_ptr,
+    uint32_t                         pictureHeighInLcu)
+{
+    EbPictureBufferDesc_t *input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+
+    if (input_picture_ptr->color_format >= EB_YUV422) {
+        // Jing: Do the conversion of 422/444=>420 here since it's multi-threaded kernel
+        //       Reuse the Y, only add cb/cr in the newly created buffer desc
+        //       NOTE: since denoise may change the src, so this part is after PicturePreProcessingOperations()
+        picture_control_set_ptr->chroma_downsampled_picture_ptr->buffer_y = input_picture_ptr->buffer_y;
+        DownSampleChroma(input_picture_ptr, picture_control_set_ptr->chroma_downsampled_picture_ptr);
+    } else {
+        picture_control_set_ptr->chroma_downsampled_picture_ptr = input_picture_ptr;
+    }
+
+    // Pad input picture to complete border LCUs
+    PadPictureToMultipleOfLcuDimensions(
+        input_padded_picture_ptr);
+
+    // Initialize Segments
+    picture_control_set_ptr->pa_segments_row_count = (uint16_t)MIN(sequence_control_set_ptr->pa_segment_row_count, pictureHeighInLcu);
+    eb_atomic_store_32(&picture_control_set_ptr->pa_next_segment, 0);
+    eb_atomic_store_32(&picture_control_set_ptr->pa_done_segment_count, 0);
+    eb_atomic_store_32(&picture_control_set_ptr->sc_block_count, 0);
+    eb_atomic_store_32(&picture_control_set_ptr->sc_tested_area, 0);
+
+    PostPictureAnalysisFeedback(
+        context_ptr,
+        picture_control_set_wrapper_ptr,
+        MIN(picture_control_set_ptr->pa_segments_row_count, sequence_control_set_ptr->picture_analysis_process_init_count) - 1,
+        EB_FALSE);
+}
 
 /************************************************
  * Picture Analysis Kernel
@@ -5006,16 +5328,24 @@ static int is_screen_content(const uint8_t *src, int use_hbd,
  * which are used to compute variance.
  * The Picture Analysis process is multithreaded, so pictures can be
  * processed out of order as long as all inputs are available.
+ * Within a picture, the decimation and the SB statistics are split in
+ * SB row segments: the thread receiving the picture pre-processes it,
+ * then posts feedback results so that other PA threads claim segments
+ * with it. The thread completing the last segment gathers the picture
+ * statistics and hands the picture to Picture Decision. With film grain,
+ * the denoising and the noise model rows are claimed the same way first,
+ * and the thread ending them prepares the segments.
  ************************************************/
-void* picture_analysis_kernel(void *input_ptr)
+void picture_analysis_kernel(
+    void            *input_ptr,
+    EbObjectWrapper *inputResultsWrapperPtr)
 {
     PictureAnalysisContext_t        *context_ptr = (PictureAnalysisContext_t*)input_ptr;
     PictureParentControlSet_t       *picture_control_set_ptr;
     SequenceControlSet            *sequence_control_set_ptr;
 
-    EbObjectWrapper               *inputResultsWrapperPtr;
     ResourceCoordinationResults   *inputResultsPtr;
-    EbObjectWrapper               *outputResultsWrapperPtr;
+    EbObjectWrapper               *outputResultsWrapperPtr = (EbObjectWrapper*)EB_NULL;
     PictureAnalysisResults_t        *outputResultsPtr;
     EbPaReferenceObject           *paReferenceObject;
 
@@ -5029,30 +5359,32 @@ void* picture_analysis_kernel(void *input_ptr)
     uint32_t                          pictureHeighInLcu;
     uint32_t                          sb_total_count;
     EbAsm                          asm_type;
+    EbBool                         segmentsFlag;
+    EbBool                         denoiseFlag;
 
-    for (;;) {
-
-        // Get Input Full Object
-        eb_get_full_object(
-            context_ptr->resource_coordination_results_input_fifo_ptr,
-            &inputResultsWrapperPtr);
+    inputResultsPtr = (ResourceCoordinationResults*)inputResultsWrapperPtr->object_ptr;
+    picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
+    eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
+    sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    uint64_t workStartTime = eb_deadline_work_start(sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr);
+    input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
 
-        inputResultsPtr = (ResourceCoordinationResults*)inputResultsWrapperPtr->object_ptr;
-        picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
-        sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
-        input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+    paReferenceObject = (EbPaReferenceObject*)picture_control_set_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
+    input_padded_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->input_padded_picture_ptr;
+    quarter_decimated_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->quarter_decimated_picture_ptr;
+    sixteenth_decimated_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->sixteenth_decimated_picture_ptr;
 
-        paReferenceObject = (EbPaReferenceObject*)picture_control_set_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
-        input_padded_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->input_padded_picture_ptr;
-        quarter_decimated_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->quarter_decimated_picture_ptr;
-        sixteenth_decimated_picture_ptr = (EbPictureBufferDesc_t*)paReferenceObject->sixteenth_decimated_picture_ptr;
+    // Variance
+    picture_width_in_sb = (sequence_control_set_ptr->luma_width + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
+    pictureHeighInLcu = (sequence_control_set_ptr->luma_height + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
+    sb_total_count = picture_width_in_sb * pictureHeighInLcu;
 
-        // Variance
-        picture_width_in_sb = (sequence_control_set_ptr->luma_width + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
-        pictureHeighInLcu = (sequence_control_set_ptr->luma_height + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
-        sb_total_count = picture_width_in_sb * pictureHeighInLcu;
+    asm_type = sequence_control_set_ptr->encode_context_ptr->asm_type;
 
-        asm_type = sequence_control_set_ptr->encode_context_ptr->asm_type;
+    // Feedback from another PA thread joins the denoising rows or the segments
+    segmentsFlag = inputResultsPtr->segment_join_flag;
+    denoiseFlag = inputResultsPtr->denoise_join_flag;
+    if (segmentsFlag == EB_FALSE && denoiseFlag == EB_FALSE) {
 
         // Set picture parameters to account for subpicture, picture scantype, and set regions by resolutions
         SetPictureParametersForStatisticsGathering(
@@ -5068,31 +5400,59 @@ void* picture_analysis_kernel(void *input_ptr)
         // Pre processing operations performed on the input picture
         PicturePreProcessingOperations(
             picture_control_set_ptr,
-            input_picture_ptr,
             sequence_control_set_ptr,
-            quarter_decimated_picture_ptr,
-            sixteenth_decimated_picture_ptr,
-            sb_total_count,
-            asm_type);
+            sb_total_count);
 
-        if (input_picture_ptr->color_format >= EB_YUV422) {
-            // Jing: Do the conversion of 422/444=>420 here since it's multi-threaded kernel
-            //       Reuse the Y, only add cb/cr in the newly created buffer desc
-            //       NOTE: since denoise may change the src, so this part is after PicturePreProcessingOperations()
-            picture_control_set_ptr->chroma_downsampled_picture_ptr->buffer_y = input_picture_ptr->buffer_y;
-            DownSampleChroma(input_picture_ptr, picture_control_set_ptr->chroma_downsampled_picture_ptr);
-        } else {
-            picture_control_set_ptr->chroma_downsampled_picture_ptr = input_picture_ptr;
+        if (sequence_control_set_ptr->film_grain_denoise_strength &&
+            StartFilmGrainDenoising(sequence_control_set_ptr, picture_control_set_ptr, asm_type)) {
+            denoiseFlag = EB_TRUE;
+            DenoisePublishRows(
+                context_ptr,
+                sequence_control_set_ptr,
+                picture_control_set_ptr,
+                inputResultsPtr->picture_control_set_wrapper_ptr,
+                AOM_DENOISE_PHASE_FILTER_EVEN);
         }
+        else {
+            segmentsFlag = EB_TRUE;
+            PreparePictureSegments(
+                context_ptr,
+                sequence_control_set_ptr,
+                picture_control_set_ptr,
+                inputResultsPtr->picture_control_set_wrapper_ptr,
+                input_padded_picture_ptr,
+                pictureHeighInLcu);
+        }
+    }
 
-        // Pad input picture to complete border LCUs
-        PadPictureToMultipleOfLcuDimensions(
-            input_padded_picture_ptr);
-
-        // 1/4 & 1/16 input picture decimation
-        DecimateInputPicture(
+    if (denoiseFlag && DenoiseRows(
+        context_ptr,
+        sequence_control_set_ptr,
+        picture_control_set_ptr,
+        inputResultsPtr->picture_control_set_wrapper_ptr,
+        asm_type)) {
+        segmentsFlag = EB_TRUE;
+        PreparePictureSegments(
+            context_ptr,
+            sequence_control_set_ptr,
             picture_control_set_ptr,
+            inputResultsPtr->picture_control_set_wrapper_ptr,
             input_padded_picture_ptr,
+            pictureHeighInLcu);
+    }
+
+    if (segmentsFlag && AnalyzePictureSegments(
+        sequence_control_set_ptr,
+        picture_control_set_ptr,
+        input_padded_picture_ptr,
+        quarter_decimated_picture_ptr,
+        sixteenth_decimated_picture_ptr,
+        picture_width_in_sb,
+        pictureHeighInLcu,
+        asm_type)) {
+
+        PadDecimatedPicture(
+            picture_control_set_ptr,
             quarter_decimated_picture_ptr,
             sixteenth_decimated_picture_ptr);
 
@@ -5100,17 +5460,12 @@ void* picture_analysis_kernel(void *input_ptr)
         GatheringPictureStatistics(
             sequence_control_set_ptr,
             picture_control_set_ptr,
-			picture_control_set_ptr->chroma_downsampled_picture_ptr, //420 input_picture_ptr
-            input_padded_picture_ptr,
+            picture_control_set_ptr->chroma_downsampled_picture_ptr, //420 input_picture_ptr
             sixteenth_decimated_picture_ptr,
             sb_total_count,
             asm_type);
 
-        picture_control_set_ptr->sc_content_detected = is_screen_content(
-            input_picture_ptr->buffer_y + input_picture_ptr->origin_x + input_picture_ptr->origin_y*input_picture_ptr->stride_y,
-            0,
-            input_picture_ptr->stride_y,
-            sequence_control_set_ptr->luma_width, sequence_control_set_ptr->luma_height);       
+        // sc_content_detected is set by the color count of GatheringPictureStatistics
         if (picture_control_set_ptr->sc_content_detected) {
             if (picture_control_set_ptr->pic_avg_variance > 1000)
                 picture_control_set_ptr->sc_content_detected = 1;
@@ -5118,7 +5473,7 @@ void* picture_analysis_kernel(void *input_ptr)
                 picture_control_set_ptr->sc_content_detected = 0;
         }
 
-        
+
 #if HARD_CODE_SC_SETTING
         picture_control_set_ptr->sc_content_detected = EB_TRUE;
 #endif
@@ -5137,13 +5492,21 @@ void* picture_analysis_kernel(void *input_ptr)
 
         outputResultsPtr = (PictureAnalysisResults_t*)outputResultsWrapperPtr->object_ptr;
         outputResultsPtr->picture_control_set_wrapper_ptr = inputResultsPtr->picture_control_set_wrapper_ptr;
+    }
 
-        // Release the Input Results
-        eb_release_object(inputResultsWrapperPtr);
+    eb_deadline_work_end(
+        sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr,
+        &picture_control_set_ptr->encode_time_us,
+        workStartTime);
 
-        // Post the Full Results Object
-        eb_post_full_object(outputResultsWrapperPtr);
+    // Release the picture held by the feedback
+    if (inputResultsPtr->segment_join_flag || inputResultsPtr->denoise_join_flag)
+        eb_release_object(inputResultsPtr->picture_control_set_wrapper_ptr);
 
-    }
-    return EB_NULL;
+    // Release the Input Results
+    eb_release_object(inputResultsWrapperPtr);
+
+    // Post the Full Results Object
+    if (outputResultsWrapperPtr != (EbObjectWrapper*)EB_NULL)
+        eb_post_full_object(outputResultsWrapperPtr);
 }
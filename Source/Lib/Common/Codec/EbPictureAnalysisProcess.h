@@ -17,9 +17,11 @@ typedef struct PictureAnalysisContext_s
 {
     EB_ALIGN(64) uint8_t            local_cache[64];
     EbFifo                     *resource_coordination_results_input_fifo_ptr;
+    EbFifo                     *pa_feedback_fifo_ptr;
     EbFifo                     *picture_analysis_results_output_fifo_ptr;
     EbPictureBufferDesc_t        *denoised_picture_ptr;
     EbPictureBufferDesc_t        *noise_picture_ptr;
+    struct aom_denoise_row_buffers_t *denoise_row_buffers_ptr;
     double                          picNoiseVarianceFloat;
 } PictureAnalysisContext_t;
 
@@ -31,9 +33,12 @@ extern EbErrorType picture_analysis_context_ctor(
     EbBool                         denoise_flag,
     PictureAnalysisContext_t     **context_dbl_ptr,
     EbFifo                      *resource_coordination_results_input_fifo_ptr,
+    EbFifo                      *pa_feedback_fifo_ptr,
     EbFifo                      *picture_analysis_results_output_fifo_ptr);
 
-extern void* picture_analysis_kernel(void *input_ptr);
+extern void picture_analysis_kernel(
+    void            *input_ptr,
+    EbObjectWrapper *inputResultsWrapperPtr);
 
 void noise_extract_luma_weak(
     EbPictureBufferDesc_t *input_picture_ptr,
@@ -19,6 +19,7 @@
 #include "EbDefinitions.h"
 #include "EbPictureControlSet.h"
 #include "EbPictureBufferDesc.h"
+#include "EbMdRateEstimation.h"
 
 void *aom_memalign(size_t align, size_t size);
 void aom_free(void *memblk);
@@ -184,6 +185,15 @@ EbErrorType picture_control_set_ctor(
         return EB_ErrorInsufficientResources;
     }
 
+    // Tile overflow buffers: at most 1 << 6 tile columns and rows are
+    // configured, and a tile holds at least one superblock
+    return_error = entropy_coder_tile_overflow_ctor(
+        object_ptr->entropy_coder_ptr,
+        MIN(pictureLcuWidth, 1 << 6) * MIN(pictureLcuHeight, 1 << 6));
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+
     // Packetization process Bitstream
     return_error = BitstreamCtor(
         &object_ptr->bitstreamPtr,
@@ -199,6 +209,8 @@ EbErrorType picture_control_set_ctor(
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
+    // MD rate Estimation tables, allocated when the picture first goes through mode decision configuration
+    object_ptr->md_rate_estimation_ptr = (MdRateEstimationContext_t*)EB_NULL;
     // GOP
     object_ptr->picture_number = 0;
     object_ptr->temporal_layer_index = 0;
@@ -253,13 +265,17 @@ EbErrorType picture_control_set_ctor(
     // Allocate memory for cbf array (used by DLF)
     EB_MALLOC(uint8_t*, object_ptr->cbf_map_array, sizeof(uint8_t) * ((initDataPtr->picture_width >> 2) * (initDataPtr->picture_height >> 2)), EB_N_PTR);
 
+    // Neighbor arrays are sized from the actual picture
+    const uint16_t neighbor_array_width = (uint16_t)NEIGHBOR_ARRAY_PICTURE_SIZE(initDataPtr->picture_width);
+    const uint16_t neighbor_array_height = (uint16_t)NEIGHBOR_ARRAY_PICTURE_SIZE(initDataPtr->picture_height);
+
     // Mode Decision Neighbor Arrays
     uint8_t depth;
     for (depth = 0; depth < NEIGHBOR_ARRAY_TOTAL_COUNT; depth++) {
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_intra_luma_mode_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -267,8 +283,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_intra_chroma_mode_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
-            MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
+            neighbor_array_width >> subsampling_x,
+            neighbor_array_height >> subsampling_y,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -279,8 +295,8 @@ EbErrorType picture_control_set_ctor(
         }
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_mv_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(MvUnit_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -291,8 +307,8 @@ EbErrorType picture_control_set_ctor(
         }
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_skip_flag_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -303,8 +319,8 @@ EbErrorType picture_control_set_ctor(
         }
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_mode_type_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -315,8 +331,8 @@ EbErrorType picture_control_set_ctor(
         }
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_leaf_depth_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -328,8 +344,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor(
             &object_ptr->mdleaf_partition_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(struct PartitionContext),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -341,8 +357,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_luma_recon_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -353,8 +369,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_cb_recon_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
-            MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
+            neighbor_array_width >> subsampling_x,
+            neighbor_array_height >> subsampling_y,
             sizeof(uint8_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -366,8 +382,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_cr_recon_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
-            MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
+            neighbor_array_width >> subsampling_x,
+            neighbor_array_height >> subsampling_y,
             sizeof(uint8_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -379,8 +395,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_skip_coeff_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -392,8 +408,8 @@ EbErrorType picture_control_set_ctor(
         // for each 4x4
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_luma_dc_sign_level_coeff_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -405,8 +421,8 @@ EbErrorType picture_control_set_ctor(
         // for each 4x4
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_cr_dc_sign_level_coeff_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -418,8 +434,8 @@ EbErrorType picture_control_set_ctor(
         // for each 4x4
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_cb_dc_sign_level_coeff_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -431,8 +447,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_inter_pred_dir_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -444,8 +460,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor(
             &object_ptr->md_ref_frame_type_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint8_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -454,8 +470,8 @@ EbErrorType picture_control_set_ctor(
 
         return_error = neighbor_array_unit_ctor32(
             &object_ptr->md_interpolation_type_neighbor_array[depth],
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint32_t),
             PU_NEIGHBOR_ARRAY_GRANULARITY,
             PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -473,8 +489,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->md_refinement_intra_luma_mode_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -486,8 +502,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->md_refinement_mode_type_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -499,8 +515,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->md_refinement_luma_recon_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
         SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -512,8 +528,8 @@ EbErrorType picture_control_set_ctor(
     // Encode Pass Neighbor Arrays
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_intra_luma_mode_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -522,8 +538,8 @@ EbErrorType picture_control_set_ctor(
     // Encode Pass Neighbor Arrays
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_intra_chroma_mode_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
-        MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
+        neighbor_array_width >> subsampling_x,
+        neighbor_array_height >> subsampling_y,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -534,8 +550,8 @@ EbErrorType picture_control_set_ctor(
     }
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_mv_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(MvUnit_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -546,8 +562,8 @@ EbErrorType picture_control_set_ctor(
     }
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_skip_flag_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         CU_NEIGHBOR_ARRAY_GRANULARITY,
         CU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -558,8 +574,8 @@ EbErrorType picture_control_set_ctor(
     }
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_mode_type_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -570,8 +586,8 @@ EbErrorType picture_control_set_ctor(
     }
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_leaf_depth_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -584,8 +600,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_luma_recon_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
         SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -596,8 +612,8 @@ EbErrorType picture_control_set_ctor(
     }
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_cb_recon_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
-        MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
+        neighbor_array_width >> subsampling_x,
+        neighbor_array_height >> subsampling_y,
         sizeof(uint8_t),
         SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
         SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -609,8 +625,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ep_cr_recon_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
-        MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
+        neighbor_array_width >> subsampling_x,
+        neighbor_array_height >> subsampling_y,
         sizeof(uint8_t),
         SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
         SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -623,8 +639,8 @@ EbErrorType picture_control_set_ctor(
     if (is16bit) {
         return_error = neighbor_array_unit_ctor(
             &object_ptr->ep_luma_recon_neighbor_array16bit,
-            MAX_PICTURE_WIDTH_SIZE,
-            MAX_PICTURE_HEIGHT_SIZE,
+            neighbor_array_width,
+            neighbor_array_height,
             sizeof(uint16_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -635,8 +651,8 @@ EbErrorType picture_control_set_ctor(
         }
         return_error = neighbor_array_unit_ctor(
             &object_ptr->ep_cb_recon_neighbor_array16bit,
-            MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
-            MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
+            neighbor_array_width >> subsampling_x,
+            neighbor_array_height >> subsampling_y,
             sizeof(uint16_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -647,8 +663,8 @@ EbErrorType picture_control_set_ctor(
         }
         return_error = neighbor_array_unit_ctor(
             &object_ptr->ep_cr_recon_neighbor_array16bit,
-            MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
-            MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
+            neighbor_array_width >> subsampling_x,
+            neighbor_array_height >> subsampling_y,
             sizeof(uint16_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
@@ -665,8 +681,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->amvp_mv_merge_mv_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(MvUnit_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -677,8 +693,8 @@ EbErrorType picture_control_set_ctor(
     }
     return_error = neighbor_array_unit_ctor(
         &object_ptr->amvp_mv_merge_mode_type_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -690,8 +706,8 @@ EbErrorType picture_control_set_ctor(
     // Entropy Coding Neighbor Arrays
     return_error = neighbor_array_unit_ctor(
         &object_ptr->mode_type_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -703,8 +719,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->partition_context_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(struct PartitionContext),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -716,8 +732,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->skip_flag_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -729,8 +745,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->skip_coeff_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -742,8 +758,8 @@ EbErrorType picture_control_set_ctor(
     // for each 4x4
     return_error = neighbor_array_unit_ctor(
         &object_ptr->luma_dc_sign_level_coeff_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -755,8 +771,8 @@ EbErrorType picture_control_set_ctor(
     // for each 4x4
     return_error = neighbor_array_unit_ctor(
         &object_ptr->cr_dc_sign_level_coeff_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -768,8 +784,8 @@ EbErrorType picture_control_set_ctor(
     // for each 4x4
     return_error = neighbor_array_unit_ctor(
         &object_ptr->cb_dc_sign_level_coeff_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -781,8 +797,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->inter_pred_dir_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -794,8 +810,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->ref_frame_type_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -803,8 +819,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor32(
         &object_ptr->interpolation_type_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint32_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -818,8 +834,8 @@ EbErrorType picture_control_set_ctor(
 
     return_error = neighbor_array_unit_ctor(
         &object_ptr->intra_luma_mode_neighbor_array,
-        MAX_PICTURE_WIDTH_SIZE,
-        MAX_PICTURE_HEIGHT_SIZE,
+        neighbor_array_width,
+        neighbor_array_height,
         sizeof(uint8_t),
         PU_NEIGHBOR_ARRAY_GRANULARITY,
         PU_NEIGHBOR_ARRAY_GRANULARITY,
@@ -851,13 +867,56 @@ EbErrorType picture_control_set_ctor(
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
+    // SB Row Sync
+    return_error = SbRowSyncCtor(
+        &object_ptr->enc_dec_row_sync,
+        pictureLcuHeight);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+    return_error = SbRowSyncCtor(
+        &object_ptr->dlf_row_sync,
+        pictureLcuHeight);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+    return_error = SbRowSyncCtor(
+        &object_ptr->dlf_search_row_sync,
+        pictureLcuHeight);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+    EB_MALLOC(uint64_t*, object_ptr->dlf_search_row_sse, sizeof(uint64_t) * pictureLcuHeight, EB_N_PTR);
+    object_ptr->dlf_search_recon_ptr = (EbPictureBufferDesc_t*)EB_NULL;
+    object_ptr->dlf_search_backup_ptr = (EbPictureBufferDesc_t*)EB_NULL;
+    object_ptr->dlf_search_plane = 0;
+    object_ptr->dlf_search_row_step = 1;
+    object_ptr->dlf_search_active = 0;
     // Entropy Rows
+    EB_MALLOC(EbBool*, object_ptr->entropy_coding_row_array, sizeof(EbBool) * pictureLcuHeight, EB_N_PTR);
     EB_CREATEMUTEX(EbHandle, object_ptr->entropy_coding_mutex, sizeof(EbHandle), EB_MUTEX);
 
     EB_CREATEMUTEX(EbHandle, object_ptr->intra_mutex, sizeof(EbHandle), EB_MUTEX);
 
     EB_CREATEMUTEX(EbHandle, object_ptr->cdef_search_mutex, sizeof(EbHandle), EB_MUTEX);
 
+    // CDEF filter block rows, and CDEF_VBORDER lines above and below each
+    // row boundary for every plane
+    {
+        const uint32_t cdefRowCount = (initDataPtr->picture_height + 64 - 1) / 64;
+        const uint32_t cdefLineBufSize = cdefRowCount * 2 * CDEF_VBORDER * initDataPtr->picture_width;
+
+        return_error = SbRowSyncCtor(
+            &object_ptr->cdef_row_sync,
+            cdefRowCount);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+        EB_MALLOC(uint16_t*, object_ptr->cdef_line_buf[0], sizeof(uint16_t) * cdefLineBufSize, EB_N_PTR);
+        EB_MALLOC(uint16_t*, object_ptr->cdef_line_buf[1], sizeof(uint16_t) * cdefLineBufSize, EB_N_PTR);
+        EB_MALLOC(uint16_t*, object_ptr->cdef_line_buf[2], sizeof(uint16_t) * cdefLineBufSize, EB_N_PTR);
+    }
+
     //object_ptr->mse_seg[0] = (uint64_t(*)[64])aom_malloc(sizeof(**object_ptr->mse_seg) *  pictureLcuWidth * pictureLcuHeight);
    // object_ptr->mse_seg[1] = (uint64_t(*)[64])aom_malloc(sizeof(**object_ptr->mse_seg) *  pictureLcuWidth * pictureLcuHeight);
    
@@ -876,6 +935,38 @@ EbErrorType picture_control_set_ctor(
 
 
     EB_CREATEMUTEX(EbHandle, object_ptr->rest_search_mutex, sizeof(EbHandle), EB_MUTEX);
+
+    // Restoration processing stripe rows, 64 rows high offset upwards by 8 rows
+    {
+        const uint32_t restRowCount = (initDataPtr->picture_height + 8 + 64 - 1) / 64;
+
+        return_error = SbRowSyncCtor(
+            &object_ptr->rest_filter_row_sync,
+            restRowCount);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+        return_error = SbRowSyncCtor(
+            &object_ptr->rest_copy_row_sync,
+            restRowCount);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
+    // Film grain synthesis stripes of the recon output
+    object_ptr->film_grain_synth = NULL;
+    object_ptr->rest_grain_row_sync = NULL;
+    object_ptr->film_grain_recon_flag = EB_FALSE;
+    if (initDataPtr->film_grain_noise_level) {
+        EB_MALLOC(aom_film_grain_synth_t*, object_ptr->film_grain_synth, sizeof(aom_film_grain_synth_t), EB_N_PTR);
+        return_error = SbRowSyncCtor(
+            &object_ptr->rest_grain_row_sync,
+            av1_film_grain_stripe_count(initDataPtr->picture_height));
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
      
 
 
@@ -899,10 +990,42 @@ EbErrorType picture_control_set_ctor(
     object_ptr->mi_stride = pictureLcuWidth * (BLOCK_SIZE_64 / 4);
     object_ptr->hash_table.p_lookup_table = NULL;
     av1_hash_table_create(&object_ptr->hash_table);
+    av1_crc32c_calculator_init(&object_ptr->crc_calculator);
+
+    object_ptr->hash_buffers = (IntraBcHashBuffers_t*)EB_NULL;
+    object_ptr->hash_row_count = 0;
+    object_ptr->hash_active = 0;
+    object_ptr->hash_level_count = 0;
+
     return EB_ErrorNone;
 }
 
 
+EbErrorType intrabc_hash_buffers_ctor(
+    EbPtr *object_dbl_ptr,
+    EbPtr  object_init_data_ptr)
+{
+    IntraBcHashBuffers_t         *object_ptr;
+    IntraBcHashBuffersInitData_t *initDataPtr = (IntraBcHashBuffersInitData_t*)object_init_data_ptr;
+    const size_t                  pictureSize = (size_t)initDataPtr->picture_width * initDataPtr->picture_height;
+    uint32_t                      bufferIndex;
+    uint32_t                      hashIndex;
+
+    EB_MALLOC(IntraBcHashBuffers_t*, object_ptr, sizeof(IntraBcHashBuffers_t), EB_N_PTR);
+    *object_dbl_ptr = (EbPtr)object_ptr;
+
+    for (bufferIndex = 0; bufferIndex < 2; ++bufferIndex) {
+        for (hashIndex = 0; hashIndex < 2; ++hashIndex) {
+            EB_MALLOC(uint32_t*, object_ptr->block_hash_array[bufferIndex][hashIndex], sizeof(uint32_t) * pictureSize, EB_N_PTR);
+        }
+        for (hashIndex = 0; hashIndex < 3; ++hashIndex) {
+            EB_MALLOC(int8_t*, object_ptr->block_same_array[bufferIndex][hashIndex], sizeof(int8_t) * pictureSize, EB_N_PTR);
+        }
+    }
+
+    return EB_ErrorNone;
+}
+
 EbErrorType picture_parent_control_set_ctor(
     EbPtr *object_dbl_ptr,
     EbPtr object_init_data_ptr)
@@ -1151,6 +1274,14 @@ EbErrorType picture_parent_control_set_ctor(
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
+        for (int32_t phase = 0; phase < AOM_DENOISE_PHASE_COUNT; ++phase) {
+            return_error = SbRowSyncCtor(
+                &object_ptr->denoise_row_sync[phase],
+                (uint32_t)aom_denoise_and_model_max_row_count(object_ptr->denoise_and_model));
+            if (return_error == EB_ErrorInsufficientResources) {
+                return EB_ErrorInsufficientResources;
+            }
+        }
     }
 
     return return_error;
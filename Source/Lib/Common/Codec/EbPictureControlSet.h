@@ -13696,6 +13696,28 @@ extern "C" {
 
     } SPEED_FEATURES;
 
+    /**************************************
+     * Intra Block Copy Hash Buffers
+     *   Block hash and same-info buffers of the
+     *   hash generation, ping-ponged between the
+     *   hash levels. Taken from a pool by the MDC
+     *   thread hashing a picture, for the time of
+     *   the generation.
+     **************************************/
+    typedef struct IntraBcHashBuffers_s
+    {
+        uint32_t                             *block_hash_array[2][2];
+        int8_t                               *block_same_array[2][3];
+
+    } IntraBcHashBuffers_t;
+
+    typedef struct IntraBcHashBuffersInitData_s
+    {
+        uint16_t                              picture_width;
+        uint16_t                              picture_height;
+
+    } IntraBcHashBuffersInitData_t;
+
     typedef struct PictureControlSet_s
     {
         EbObjectWrapper                    *sequence_control_set_wrapper_ptr;
@@ -13726,14 +13748,28 @@ extern "C" {
         
         EncDecSegments_t                     *enc_dec_segment_ctrl;
 
+        // SB rows coded by EncDec and SB rows deblocked by DLF
+        SbRowSync_t                          *enc_dec_row_sync;
+        SbRowSync_t                          *dlf_row_sync;
+
+        // Loop filter level search: SB rows of the trial passes and their SSE
+        SbRowSync_t                          *dlf_search_row_sync;
+        uint64_t                             *dlf_search_row_sse;
+        EbPictureBufferDesc_t                *dlf_search_recon_ptr;
+        EbPictureBufferDesc_t                *dlf_search_backup_ptr;
+        int32_t                               dlf_search_plane;
+        uint32_t                              dlf_search_row_step;
+        volatile int32_t                      dlf_search_active;
+
         // Entropy Process Rows
         int8_t                                entropy_coding_current_available_row;
-        EbBool                                entropy_coding_row_array[MAX_LCU_ROWS];
+        EbBool                               *entropy_coding_row_array;
         int8_t                                entropy_coding_current_row;
         int8_t                                entropy_coding_row_count;
         EbHandle                              entropy_coding_mutex;
         EbBool                                entropy_coding_in_progress;
         EbBool                                entropy_coding_pic_done;
+        uint32_t                              entropy_coding_tile_done_count;
         EbHandle                              intra_mutex;
         uint32_t                              intra_coded_area;
         uint32_t                              tot_seg_searched_cdef;
@@ -13743,6 +13779,11 @@ extern "C" {
         uint8_t                               cdef_segments_column_count;
         uint8_t                               cdef_segments_row_count;
 
+        // CDEF application: 64x64 filter block rows, filtered by the CDEF
+        // threads, and the deblocked lines around each row boundary
+        SbRowSync_t                          *cdef_row_sync;
+        uint16_t                             *cdef_line_buf[3];
+
         uint64_t(*mse_seg[2])[TOTAL_STRENGTHS];
 
         uint16_t *src[3];        //dlfed recon in 16bit form
@@ -13755,6 +13796,17 @@ extern "C" {
         uint8_t                               rest_segments_column_count;
         uint8_t                               rest_segments_row_count;            
 
+        // Restoration application: processing stripe rows, filtered by the
+        // rest threads, then copied back and padded by the rest threads
+        SbRowSync_t                          *rest_filter_row_sync;
+        SbRowSync_t                          *rest_copy_row_sync;
+
+        // Film grain of the recon output: stripes synthesized by the rest
+        // threads into the film grain picture once the recon is complete
+        aom_film_grain_synth_t               *film_grain_synth;
+        SbRowSync_t                          *rest_grain_row_sync;
+        EbBool                                film_grain_recon_flag;
+
         // Mode Decision Config
         MdcLcuData_t                         *mdc_sb_array;
 
@@ -13793,6 +13845,9 @@ extern "C" {
         // EncDec Entropy Coder (for rate estimation)
         EntropyCoder_t                       *coeff_est_entropy_coder_ptr;
 
+        // MD Rate Estimation tables, built from the CDF of coeff_est_entropy_coder_ptr
+        struct MdRateEstimationContext_s     *md_rate_estimation_ptr;
+
         // Mode Decision Neighbor Arrays
         NeighborArrayUnit_t                  *md_intra_luma_mode_neighbor_array[NEIGHBOR_ARRAY_TOTAL_COUNT];
         NeighborArrayUnit_t                  *md_intra_chroma_mode_neighbor_array[NEIGHBOR_ARRAY_TOTAL_COUNT];
@@ -13873,14 +13928,21 @@ extern "C" {
         uint8_t                               high_intra_slection;
         EB_FRAME_CARACTERICTICS               scene_caracteristic_id;
         EbBool                                limit_intra;
-        int32_t                               cdef_preset[4];
         WienerInfo                            wiener_info[MAX_MB_PLANE];
         SgrprojInfo                           sgrproj_info[MAX_MB_PLANE];
         SPEED_FEATURES sf;
         search_site_config ss_cfg;//CHKN this might be a seq based
         hash_table hash_table;
-        CRC_CALCULATOR crc_calculator1;
-        CRC_CALCULATOR crc_calculator2;
+        CRC32C crc_calculator;
+
+        // Intra block copy hash generation, split by SB row over the MDC
+        // threads. hash_buffers is only set while the hash is generated.
+        IntraBcHashBuffers_t                 *hash_buffers;
+        uint32_t                              hash_row_count;
+        volatile int32_t                      hash_active;
+        volatile int32_t                      hash_level_count;    // levels whose rows can be claimed
+        volatile int32_t                      hash_next_row[INTRABC_HASH_LEVEL_COUNT];
+        volatile int32_t                      hash_done_row[INTRABC_HASH_LEVEL_COUNT];
 
     } PictureControlSet_t;
 
@@ -14012,6 +14074,17 @@ extern "C" {
         uint64_t                              last_idr_picture;
         uint64_t                              start_time_seconds;
         uint64_t                              start_time_u_seconds;
+
+        // Deadline speed control
+        uint8_t                               effort_level;
+        uint64_t                              arrival_time_us;
+        volatile int64_t                      encode_time_us;      // busy time of the stages
+        volatile int32_t                      late_sb_count;       // SBs coded past the deadline
+
+        // MD recon cache
+        volatile int32_t                      luma_txb_count;          // luma txbs of the encode pass
+        volatile int32_t                      reused_luma_txb_count;   // luma txbs committed from MD
+
         uint32_t                              luma_sse;
         uint32_t                              cr_sse;
         uint32_t                              cb_sse;
@@ -14096,6 +14169,11 @@ extern "C" {
         uint8_t                               me_segments_column_count;
         uint8_t                               me_segments_row_count;
         uint64_t                              me_segments_completion_mask;
+        uint16_t                              pa_segments_row_count;
+        volatile int32_t                      pa_next_segment;          // next segment to claim
+        volatile int32_t                      pa_done_segment_count;
+        volatile int32_t                      sc_block_count;           // 16x16 luma blocks of 2 to 4 colors
+        volatile int32_t                      sc_tested_area;
 
         // Motion Estimation Results
         uint8_t                               max_number_of_pus_per_sb;
@@ -14281,6 +14359,7 @@ extern "C" {
         int32_t                               film_grain_params_present; //todo (AN): Do we need this flag at picture level?
         aom_film_grain_t                      film_grain_params;
         struct aom_denoise_and_model_t       *denoise_and_model;
+        SbRowSync_t                          *denoise_row_sync[AOM_DENOISE_PHASE_COUNT]; // rows of each film grain denoising phase
         EbBool                                enable_in_loop_motion_estimation_flag;
         RestUnitSearchInfo                   *rusi_picture[3];//for 3 planes
         int8_t                                cdef_filter_mode;
@@ -14564,6 +14643,10 @@ extern "C" {
         EbPtr *object_dbl_ptr,
         EbPtr  object_init_data_ptr);
 
+    extern EbErrorType intrabc_hash_buffers_ctor(
+        EbPtr *object_dbl_ptr,
+        EbPtr  object_init_data_ptr);
+
 
 #ifdef __cplusplus
 }
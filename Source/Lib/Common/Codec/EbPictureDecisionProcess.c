@@ -749,6 +749,11 @@ EbErrorType signal_derivation_multi_processes_oq(
     else
         picture_control_set_ptr->nsq_search_level = NSQ_SEARCH_OFF;
 
+    // Deadline speed control: NSQ_SEARCH_LEVELn tests n shapes
+    const EbDeadlineEffort *deadlineEffort = eb_deadline_control_get_effort(picture_control_set_ptr->effort_level);
+    if (deadlineEffort->nsq_max_shapes < NSQ_SEARCH_LEVEL6 && picture_control_set_ptr->nsq_search_level > deadlineEffort->nsq_max_shapes)
+        picture_control_set_ptr->nsq_search_level = deadlineEffort->nsq_max_shapes;
+
     switch (picture_control_set_ptr->nsq_search_level) {
     case NSQ_SEARCH_OFF:
         picture_control_set_ptr->nsq_max_shapes_md = 0;
@@ -878,6 +883,8 @@ EbErrorType signal_derivation_multi_processes_oq(
     }
     else
         picture_control_set_ptr->cdef_filter_mode = 0;
+    if (picture_control_set_ptr->cdef_filter_mode > (int8_t)deadlineEffort->cdef_filter_mode_max)
+        picture_control_set_ptr->cdef_filter_mode = (int8_t)deadlineEffort->cdef_filter_mode_max;
 
     // SG Level                                    Settings
     // 0                                            OFF
@@ -903,6 +910,8 @@ EbErrorType signal_derivation_multi_processes_oq(
         cm->sg_filter_mode = 2;
     else
         cm->sg_filter_mode = 1;
+    if (cm->sg_filter_mode > (int8_t)deadlineEffort->sg_filter_mode_max)
+        cm->sg_filter_mode = (int8_t)deadlineEffort->sg_filter_mode_max;
 
 
     // WN Level                                     Settings
@@ -926,6 +935,8 @@ EbErrorType signal_derivation_multi_processes_oq(
         cm->wn_filter_mode = 2;
     else
         cm->wn_filter_mode = 0;
+    if (cm->wn_filter_mode > (int8_t)deadlineEffort->wn_filter_mode_max)
+        cm->wn_filter_mode = (int8_t)deadlineEffort->wn_filter_mode_max;
 
 
     // Tx_search Level                                Settings
@@ -1678,6 +1689,9 @@ void* picture_decision_kernel(void *input_ptr)
     uint32_t                           windowIndex;
     uint32_t                           entryIndex;
     PictureParentControlSet_t        *ParentPcsWindow[FUTURE_WINDOW_WIDTH + 2];
+    EbBool                             analysisShareFollower;
+    EbBool                             sharedSceneChange;
+    EbBool                             sharedSceneChangeFlag;
 
     // Debug
     uint64_t                           loopCount = 0;
@@ -1691,6 +1705,7 @@ void* picture_decision_kernel(void *input_ptr)
 
         inputResultsPtr = (PictureAnalysisResults_t*)inputResultsWrapperPtr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
+        eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
         sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
         encode_context_ptr = (EncodeContext_t*)sequence_control_set_ptr->encode_context_ptr;
 #if BASE_LAYER_REF
@@ -1698,6 +1713,10 @@ void* picture_decision_kernel(void *input_ptr)
 #endif
         loopCount++;
 
+        // The lead of a ladder publishes the analysis of the picture from here on
+        if (encode_context_ptr->analysis_share_lead)
+            eb_analysis_share_open_picture(encode_context_ptr->analysis_share_ptr, picture_control_set_ptr->picture_number);
+
         // Input Picture Analysis Results into the Picture Decision Reordering Queue
         // P.S. Since the prior Picture Analysis processes stage is multithreaded, inputs to the Picture Decision Process
         // can arrive out-of-display-order, so a the Picture Decision Reordering Queue is used to enforce processing of
@@ -1762,7 +1781,21 @@ void* picture_decision_kernel(void *input_ptr)
                 context_ptr->lastSolidColorFramePoc = 0xFFFFFFFF;
 
             if (windowAvail == EB_TRUE) {
-                if (sequence_control_set_ptr->static_config.scene_change_detection) {
+                // Followers of a ladder cut where the lead does, so the renditions stay aligned.
+                // Their inputs are held until the lead analysed the picture, so the decision
+                // is only missing when the lead closed.
+                analysisShareFollower = (EbBool)(encode_context_ptr->analysis_share_ptr && !encode_context_ptr->analysis_share_lead);
+                sharedSceneChange = analysisShareFollower && eb_analysis_share_get_scene_change(
+                    encode_context_ptr->analysis_share_ptr,
+                    picture_control_set_ptr->picture_number,
+                    &sharedSceneChangeFlag);
+                if (analysisShareFollower && !sharedSceneChange && !picture_control_set_ptr->end_of_sequence_flag)
+                    eb_atomic_fetch_add_32(&encode_context_ptr->analysis_share_scene_fallback_count, 1);
+
+                if (sharedSceneChange) {
+                    picture_control_set_ptr->scene_change_flag = sharedSceneChangeFlag;
+                }
+                else if (sequence_control_set_ptr->static_config.scene_change_detection) {
 
                     picture_control_set_ptr->scene_change_flag = SceneTransitionDetector(
                         context_ptr,
@@ -1775,6 +1808,12 @@ void* picture_decision_kernel(void *input_ptr)
                 else {
                     picture_control_set_ptr->scene_change_flag = EB_FALSE;
                 }
+                if (encode_context_ptr->analysis_share_lead) {
+                    eb_analysis_share_set_scene_change(
+                        encode_context_ptr->analysis_share_ptr,
+                        picture_control_set_ptr->picture_number,
+                        picture_control_set_ptr->scene_change_flag);
+                }
                 picture_control_set_ptr->cra_flag = (picture_control_set_ptr->scene_change_flag == EB_TRUE) ?
                     EB_TRUE :
                     picture_control_set_ptr->cra_flag;
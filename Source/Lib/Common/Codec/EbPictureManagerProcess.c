@@ -150,6 +150,7 @@ void* picture_manager_kernel(void *input_ptr)
             &inputPictureDemuxWrapperPtr);
 
         inputPictureDemuxPtr = (PictureDemuxResults_t*)inputPictureDemuxWrapperPtr->object_ptr;
+        eb_pipeline_stats_set_picture(inputPictureDemuxPtr->picture_number);
 
         // *Note - This should be overhauled and/or replaced when we
         //   need hierarchical support.
@@ -714,6 +715,21 @@ void* picture_manager_kernel(void *input_ptr)
                             picture_width_in_sb,
                             picture_height_in_sb);
 
+                        // SB Row Sync
+                        SbRowSyncInit(
+                            ChildPictureControlSetPtr->enc_dec_row_sync,
+                            picture_height_in_sb,
+                            picture_width_in_sb);
+                        SbRowSyncInit(
+                            ChildPictureControlSetPtr->dlf_row_sync,
+                            picture_height_in_sb,
+                            picture_width_in_sb);
+                        SbRowSyncInit(
+                            ChildPictureControlSetPtr->dlf_search_row_sync,
+                            0,
+                            picture_width_in_sb);
+                        ChildPictureControlSetPtr->dlf_search_active = 0;
+
                         // Entropy Coding Rows
                         {
                             unsigned row_index;
@@ -722,8 +738,9 @@ void* picture_manager_kernel(void *input_ptr)
                             ChildPictureControlSetPtr->entropy_coding_current_available_row = 0;
                             ChildPictureControlSetPtr->entropy_coding_row_count = picture_height_in_sb;
                             ChildPictureControlSetPtr->entropy_coding_in_progress = EB_FALSE;
+                            ChildPictureControlSetPtr->entropy_coding_tile_done_count = 0;
 
-                            for (row_index = 0; row_index < MAX_LCU_ROWS; ++row_index) {
+                            for (row_index = 0; row_index < picture_height_in_sb; ++row_index) {
                                 ChildPictureControlSetPtr->entropy_coding_row_array[row_index] = EB_FALSE;
                             }
                         }
@@ -0,0 +1,446 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "EbPipelineStats.h"
+#include "EbThreads.h"
+#include "EbUtility.h"
+
+// Instrumented thread running on the calling thread, if any
+static EB_THREAD_LOCAL EbPipelineThread *current_thread = (EbPipelineThread*)EB_NULL;
+
+/**************************************
+ * PipelineThreadSetState
+ **************************************/
+static void PipelineThreadSetState(
+    EbPipelineThread *thread_ptr,
+    uint32_t          state,
+    uint64_t          time_us)
+{
+    thread_ptr->time_us[thread_ptr->state] += time_us - thread_ptr->state_time_us;
+    thread_ptr->state_time_us = time_us;
+    thread_ptr->state = state;
+}
+
+/**************************************
+ * PipelineThreadAddEvent
+ **************************************/
+static void PipelineThreadAddEvent(
+    EbPipelineThread *thread_ptr,
+    uint32_t          type,
+    uint32_t          stage_index,
+    uint64_t          picture_number,
+    uint64_t          time_us,
+    uint64_t          duration_us,
+    uint32_t          fifo_depth)
+{
+    EbPipelineEvent *event_ptr = &thread_ptr->event_array[thread_ptr->event_count & (PIPELINE_STATS_EVENT_COUNT - 1)];
+
+    event_ptr->time_us = time_us;
+    event_ptr->duration_us = duration_us;
+    event_ptr->picture_number = picture_number;
+    event_ptr->stage_index = (uint16_t)stage_index;
+    event_ptr->type = (uint16_t)type;
+    event_ptr->fifo_depth = fifo_depth;
+
+    ++thread_ptr->event_count;
+}
+
+/**************************************
+ * PipelineThreadRegister
+ *   Takes a thread slot for the calling
+ *   thread. The time since the encoder
+ *   started is idle time.
+ **************************************/
+static EbPipelineThread* PipelineThreadRegister(
+    EbPipelineStats *stats_ptr)
+{
+    EbPipelineThread *thread_ptr;
+    int32_t           threadIndex = eb_atomic_fetch_add_32(&stats_ptr->thread_count, 1);
+
+    if (threadIndex >= (int32_t)stats_ptr->thread_capacity) {
+        eb_atomic_fetch_add_32(&stats_ptr->thread_count, -1);
+        return (EbPipelineThread*)EB_NULL;
+    }
+
+    thread_ptr = &stats_ptr->thread_array[threadIndex];
+    thread_ptr->state = PIPELINE_THREAD_IDLE;
+    thread_ptr->state_time_us = stats_ptr->start_time_us;
+    PipelineThreadSetState(thread_ptr, PIPELINE_THREAD_IDLE, eb_get_time_stamp_us());
+
+    current_thread = thread_ptr;
+
+    return thread_ptr;
+}
+
+/**************************************
+ * PipelineThreadEndObject
+ **************************************/
+static void PipelineThreadEndObject(
+    EbPipelineThread *thread_ptr,
+    uint64_t          time_us)
+{
+    EbPipelineObject        *object_ptr = &thread_ptr->object_stack[--thread_ptr->object_depth];
+    EbPipelineStageCounters *counters_ptr = &thread_ptr->stage_counters[object_ptr->stage_index];
+    uint64_t                 elapsedTime = time_us - object_ptr->start_time_us;
+    uint64_t                 processingTime = elapsedTime - MIN(object_ptr->nested_time_us, elapsedTime);
+    uint64_t                 elapsedCpuTime = eb_get_thread_cpu_time_us() - object_ptr->start_cpu_time_us;
+    uint64_t                 cpuTime = elapsedCpuTime - MIN(object_ptr->nested_cpu_time_us, elapsedCpuTime);
+
+    counters_ptr->processing_time_us += processingTime;
+    counters_ptr->processing_time_max_us = MAX(counters_ptr->processing_time_max_us, processingTime);
+    counters_ptr->cpu_time_us += cpuTime;
+
+    if (thread_ptr->object_depth) {
+        thread_ptr->object_stack[thread_ptr->object_depth - 1].nested_time_us += elapsedTime;
+        thread_ptr->object_stack[thread_ptr->object_depth - 1].nested_cpu_time_us += elapsedCpuTime;
+    }
+
+    PipelineThreadAddEvent(
+        thread_ptr,
+        PIPELINE_EVENT_OBJECT,
+        object_ptr->stage_index,
+        object_ptr->picture_number,
+        object_ptr->start_time_us,
+        elapsedTime,
+        0);
+
+    PipelineThreadSetState(thread_ptr, object_ptr->saved_state, time_us);
+    thread_ptr->picture_number = thread_ptr->object_depth ?
+        thread_ptr->object_stack[thread_ptr->object_depth - 1].picture_number : 0;
+}
+
+/**************************************
+ * eb_pipeline_stats_ctor
+ **************************************/
+EbErrorType eb_pipeline_stats_ctor(
+    EbPipelineStats **stats_dbl_ptr,
+    uint32_t          thread_capacity)
+{
+    EbPipelineStats *stats_ptr;
+    uint32_t         threadIndex;
+
+    EB_MALLOC(EbPipelineStats*, stats_ptr, sizeof(EbPipelineStats), EB_N_PTR);
+    *stats_dbl_ptr = stats_ptr;
+
+    EB_MEMSET(stats_ptr, 0, sizeof(EbPipelineStats));
+    stats_ptr->start_time_us = eb_get_time_stamp_us();
+    stats_ptr->thread_capacity = MIN(thread_capacity, PIPELINE_STATS_MAX_THREADS);
+
+    EB_MALLOC(EbPipelineThread*, stats_ptr->thread_array, sizeof(EbPipelineThread) * stats_ptr->thread_capacity, EB_N_PTR);
+    EB_MEMSET(stats_ptr->thread_array, 0, sizeof(EbPipelineThread) * stats_ptr->thread_capacity);
+
+    for (threadIndex = 0; threadIndex < stats_ptr->thread_capacity; ++threadIndex) {
+        stats_ptr->thread_array[threadIndex].stats_ptr = stats_ptr;
+        stats_ptr->thread_array[threadIndex].thread_index = threadIndex;
+        stats_ptr->thread_array[threadIndex].stage_index = PIPELINE_STATS_MIXED_STAGE;
+        EB_MALLOC(EbPipelineEvent*, stats_ptr->thread_array[threadIndex].event_array, sizeof(EbPipelineEvent) * PIPELINE_STATS_EVENT_COUNT, EB_N_PTR);
+    }
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * eb_pipeline_stats_add_stage
+ **************************************/
+uint32_t eb_pipeline_stats_add_stage(
+    EbPipelineStats  *stats_ptr,
+    const char       *name)
+{
+    if (stats_ptr->stage_count == PIPELINE_STATS_MAX_STAGES)
+        return ~0u;
+
+    stats_ptr->stage_array[stats_ptr->stage_count].name = name;
+
+    return stats_ptr->stage_count++;
+}
+
+/**************************************
+ * eb_pipeline_stats_on_post
+ **************************************/
+uint64_t eb_pipeline_stats_on_post(
+    EbPipelineStats  *stats_ptr,
+    uint32_t          stage_index)
+{
+    EbPipelineStage  *stage_ptr = &stats_ptr->stage_array[stage_index];
+    EbPipelineThread *thread_ptr = current_thread;
+    uint64_t          timeStamp = eb_get_time_stamp_us();
+    int32_t           fifoDepth = eb_atomic_fetch_add_32(&stage_ptr->fifo_depth, 1) + 1;
+    int32_t           fifoDepthMax = eb_atomic_load_32(&stage_ptr->fifo_depth_max);
+
+    while (fifoDepth > fifoDepthMax && !eb_atomic_cas_32(&stage_ptr->fifo_depth_max, fifoDepthMax, fifoDepth))
+        fifoDepthMax = eb_atomic_load_32(&stage_ptr->fifo_depth_max);
+
+    // Objects posted by the application thread are only counted
+    if (thread_ptr && thread_ptr->stats_ptr == stats_ptr)
+        PipelineThreadAddEvent(thread_ptr, PIPELINE_EVENT_POST, stage_index, thread_ptr->picture_number, timeStamp, 0, (uint32_t)fifoDepth);
+
+    return timeStamp;
+}
+
+/**************************************
+ * eb_pipeline_stats_on_get
+ **************************************/
+void eb_pipeline_stats_on_get(
+    EbPipelineStats  *stats_ptr,
+    uint32_t          stage_index,
+    uint64_t          post_time_us)
+{
+    EbPipelineThread        *thread_ptr = current_thread;
+    EbPipelineStageCounters *counters_ptr;
+    EbPipelineObject        *object_ptr;
+    uint64_t                 timeStamp;
+    uint64_t                 queueTime;
+    int32_t                  fifoDepth = eb_atomic_fetch_add_32(&stats_ptr->stage_array[stage_index].fifo_depth, -1) - 1;
+
+    if (thread_ptr == (EbPipelineThread*)EB_NULL) {
+        thread_ptr = PipelineThreadRegister(stats_ptr);
+        if (thread_ptr == (EbPipelineThread*)EB_NULL)
+            return;
+    }
+
+    // As on post, only the objects of the encoder of the thread are counted
+    if (thread_ptr->stats_ptr != stats_ptr)
+        return;
+
+    timeStamp = eb_get_time_stamp_us();
+
+    // Nesting beyond the stack is counted in the enclosing object
+    if (thread_ptr->object_depth == PIPELINE_STATS_MAX_NESTING)
+        return;
+
+    queueTime = timeStamp - MIN(post_time_us, timeStamp);
+    counters_ptr = &thread_ptr->stage_counters[stage_index];
+    ++counters_ptr->object_count;
+    counters_ptr->queue_time_us += queueTime;
+    counters_ptr->queue_time_max_us = MAX(counters_ptr->queue_time_max_us, queueTime);
+
+    if (thread_ptr->stage_index == PIPELINE_STATS_MIXED_STAGE && thread_ptr->event_count == 0)
+        thread_ptr->stage_index = stage_index;
+    else if (thread_ptr->stage_index != stage_index)
+        thread_ptr->stage_index = PIPELINE_STATS_MIXED_STAGE;
+
+    object_ptr = &thread_ptr->object_stack[thread_ptr->object_depth++];
+    object_ptr->stage_index = stage_index;
+    object_ptr->saved_state = thread_ptr->state;
+    object_ptr->picture_number = 0;
+    object_ptr->start_time_us = timeStamp;
+    object_ptr->nested_time_us = 0;
+    object_ptr->start_cpu_time_us = eb_get_thread_cpu_time_us();
+    object_ptr->nested_cpu_time_us = 0;
+    thread_ptr->picture_number = 0;
+
+    PipelineThreadAddEvent(thread_ptr, PIPELINE_EVENT_GET, stage_index, 0, timeStamp, 0, (uint32_t)MAX(fifoDepth, 0));
+    PipelineThreadSetState(thread_ptr, PIPELINE_THREAD_BUSY, timeStamp);
+}
+
+/**************************************
+ * eb_pipeline_stats_on_wait
+ **************************************/
+uint32_t eb_pipeline_stats_on_wait(
+    uint32_t          state)
+{
+    EbPipelineThread *thread_ptr = current_thread;
+    uint64_t          timeStamp;
+    uint32_t          previousState;
+
+    if (thread_ptr == (EbPipelineThread*)EB_NULL)
+        return PIPELINE_THREAD_BUSY;
+
+    timeStamp = eb_get_time_stamp_us();
+
+    if (state == PIPELINE_THREAD_IDLE) {
+        while (thread_ptr->object_depth)
+            PipelineThreadEndObject(thread_ptr, timeStamp);
+    }
+
+    previousState = thread_ptr->state;
+    PipelineThreadSetState(thread_ptr, state, timeStamp);
+
+    return previousState;
+}
+
+/**************************************
+ * eb_pipeline_stats_on_resume
+ **************************************/
+void eb_pipeline_stats_on_resume(
+    uint32_t          state)
+{
+    EbPipelineThread *thread_ptr = current_thread;
+
+    if (thread_ptr)
+        PipelineThreadSetState(thread_ptr, state, eb_get_time_stamp_us());
+}
+
+/**************************************
+ * eb_pipeline_stats_end_object
+ **************************************/
+void eb_pipeline_stats_end_object(void)
+{
+    EbPipelineThread *thread_ptr = current_thread;
+
+    if (thread_ptr && thread_ptr->object_depth)
+        PipelineThreadEndObject(thread_ptr, eb_get_time_stamp_us());
+}
+
+/**************************************
+ * eb_pipeline_stats_set_picture
+ **************************************/
+void eb_pipeline_stats_set_picture(
+    uint64_t          picture_number)
+{
+    EbPipelineThread *thread_ptr = current_thread;
+
+    if (thread_ptr == (EbPipelineThread*)EB_NULL || thread_ptr->object_depth == 0)
+        return;
+
+    thread_ptr->object_stack[thread_ptr->object_depth - 1].picture_number = picture_number;
+    thread_ptr->picture_number = picture_number;
+
+    // Label the GET event of the object
+    thread_ptr->event_array[(thread_ptr->event_count - 1) & (PIPELINE_STATS_EVENT_COUNT - 1)].picture_number = picture_number;
+}
+
+/**************************************
+ * eb_pipeline_stats_get
+ **************************************/
+void eb_pipeline_stats_get(
+    EbPipelineStats  *stats_ptr,
+    EbSvtEncStats    *enc_stats_ptr)
+{
+    EbPipelineThread        *thread_ptr;
+    EbPipelineStageCounters *counters_ptr;
+    EbPipelineStageStats    *stage_stats_ptr;
+    EbPipelineThreadStats   *thread_stats_ptr;
+    uint64_t                 timeStamp = eb_get_time_stamp_us();
+    uint64_t                 stateTime;
+    uint32_t                 threadCount = (uint32_t)MIN(eb_atomic_load_32(&stats_ptr->thread_count), (int32_t)stats_ptr->thread_capacity);
+    uint32_t                 threadIndex;
+    uint32_t                 stageIndex;
+
+    EB_MEMSET(enc_stats_ptr, 0, sizeof(EbSvtEncStats));
+
+    enc_stats_ptr->wall_time_us = timeStamp - stats_ptr->start_time_us;
+    enc_stats_ptr->stage_count = stats_ptr->stage_count;
+    enc_stats_ptr->thread_count = threadCount;
+
+    for (stageIndex = 0; stageIndex < stats_ptr->stage_count; ++stageIndex) {
+        stage_stats_ptr = &enc_stats_ptr->stage_array[stageIndex];
+        stage_stats_ptr->stage_name = stats_ptr->stage_array[stageIndex].name;
+        stage_stats_ptr->fifo_depth = (uint32_t)MAX(eb_atomic_load_32(&stats_ptr->stage_array[stageIndex].fifo_depth), 0);
+        stage_stats_ptr->fifo_depth_max = (uint32_t)eb_atomic_load_32(&stats_ptr->stage_array[stageIndex].fifo_depth_max);
+    }
+
+    // The thread counters are read while the threads update them
+    for (threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+        thread_ptr = &stats_ptr->thread_array[threadIndex];
+
+        for (stageIndex = 0; stageIndex < stats_ptr->stage_count; ++stageIndex) {
+            counters_ptr = &thread_ptr->stage_counters[stageIndex];
+            stage_stats_ptr = &enc_stats_ptr->stage_array[stageIndex];
+            stage_stats_ptr->object_count += counters_ptr->object_count;
+            stage_stats_ptr->processing_time_us += counters_ptr->processing_time_us;
+            stage_stats_ptr->processing_time_max_us = MAX(stage_stats_ptr->processing_time_max_us, counters_ptr->processing_time_max_us);
+            stage_stats_ptr->cpu_time_us += counters_ptr->cpu_time_us;
+            stage_stats_ptr->queue_time_us += counters_ptr->queue_time_us;
+            stage_stats_ptr->queue_time_max_us = MAX(stage_stats_ptr->queue_time_max_us, counters_ptr->queue_time_max_us);
+        }
+
+        thread_stats_ptr = &enc_stats_ptr->thread_array[threadIndex];
+        thread_stats_ptr->stage_name = thread_ptr->stage_index < stats_ptr->stage_count ?
+            stats_ptr->stage_array[thread_ptr->stage_index].name : "Pool";
+        thread_stats_ptr->busy_time_us = thread_ptr->time_us[PIPELINE_THREAD_BUSY];
+        thread_stats_ptr->idle_time_us = thread_ptr->time_us[PIPELINE_THREAD_IDLE];
+        thread_stats_ptr->blocked_time_us = thread_ptr->time_us[PIPELINE_THREAD_BLOCKED];
+
+        // Add the time spent in the current state
+        stateTime = thread_ptr->state_time_us;
+        if (timeStamp > stateTime) {
+            switch (thread_ptr->state) {
+            case PIPELINE_THREAD_BUSY:
+                thread_stats_ptr->busy_time_us += timeStamp - stateTime;
+                break;
+            case PIPELINE_THREAD_IDLE:
+                thread_stats_ptr->idle_time_us += timeStamp - stateTime;
+                break;
+            default:
+                thread_stats_ptr->blocked_time_us += timeStamp - stateTime;
+                break;
+            }
+        }
+    }
+}
+
+/**************************************
+ * eb_pipeline_stats_write_trace
+ *   Objects are complete ("X") events on
+ *   the track of their thread, fifo
+ *   depths are counter ("C") events.
+ **************************************/
+EbErrorType eb_pipeline_stats_write_trace(
+    EbPipelineStats  *stats_ptr,
+    const char       *file_name)
+{
+    FILE                  *trace_file = (FILE*)EB_NULL;
+    EbPipelineThread      *thread_ptr;
+    EbPipelineEvent       *event_ptr;
+    const char            *stageName;
+    uint32_t               threadCount = (uint32_t)MIN(eb_atomic_load_32(&stats_ptr->thread_count), (int32_t)stats_ptr->thread_capacity);
+    uint32_t               threadIndex;
+    uint64_t               eventIndex;
+    uint64_t               eventCount;
+    EbBool                 first = EB_TRUE;
+
+    FOPEN(trace_file, file_name, "w");
+    if (trace_file == (FILE*)EB_NULL)
+        return EB_ErrorBadParameter;
+
+    fprintf(trace_file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+        thread_ptr = &stats_ptr->thread_array[threadIndex];
+        stageName = thread_ptr->stage_index < stats_ptr->stage_count ?
+            stats_ptr->stage_array[thread_ptr->stage_index].name : "Pool";
+
+        fprintf(trace_file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+            first ? "" : ",\n", threadIndex, stageName, threadIndex);
+        first = EB_FALSE;
+
+        // Only the last PIPELINE_STATS_EVENT_COUNT events are kept
+        eventCount = thread_ptr->event_count;
+        eventIndex = eventCount > PIPELINE_STATS_EVENT_COUNT ? eventCount - PIPELINE_STATS_EVENT_COUNT : 0;
+
+        for (; eventIndex < eventCount; ++eventIndex) {
+            event_ptr = &thread_ptr->event_array[eventIndex & (PIPELINE_STATS_EVENT_COUNT - 1)];
+            if (event_ptr->stage_index >= stats_ptr->stage_count)
+                continue;
+            stageName = stats_ptr->stage_array[event_ptr->stage_index].name;
+
+            switch (event_ptr->type) {
+            case PIPELINE_EVENT_OBJECT:
+                fprintf(trace_file, ",\n{\"name\":\"%s\",\"cat\":\"stage\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%llu,\"dur\":%llu,\"args\":{\"picture\":%llu}}",
+                    stageName,
+                    threadIndex,
+                    (unsigned long long)(event_ptr->time_us - stats_ptr->start_time_us),
+                    (unsigned long long)event_ptr->duration_us,
+                    (unsigned long long)event_ptr->picture_number);
+                break;
+            default:
+                fprintf(trace_file, ",\n{\"name\":\"%s fifo\",\"ph\":\"C\",\"pid\":0,\"ts\":%llu,\"args\":{\"depth\":%u}}",
+                    stageName,
+                    (unsigned long long)(event_ptr->time_us - stats_ptr->start_time_us),
+                    event_ptr->fifo_depth);
+                break;
+            }
+        }
+    }
+
+    fprintf(trace_file, "\n]}\n");
+    fclose(trace_file);
+
+    return EB_ErrorNone;
+}
@@ -0,0 +1,220 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbPipelineStats_h
+#define EbPipelineStats_h
+
+#include "EbDefinitions.h"
+#include "EbSvtAv1Enc.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+    /*********************************
+     * Defines
+     *********************************/
+#define PIPELINE_STATS_MAX_STAGES           EB_MAX_PIPELINE_STAGE_COUNT
+#define PIPELINE_STATS_MAX_THREADS          EB_MAX_PIPELINE_THREAD_COUNT
+#define PIPELINE_STATS_EVENT_COUNT          16384   // per thread, power of 2
+#define PIPELINE_STATS_MAX_NESTING          8       // objects open at once on one thread
+#define PIPELINE_STATS_MIXED_STAGE          ~0u     // thread serving several stages
+
+    // Thread states
+#define PIPELINE_THREAD_BUSY                0       // processing an object
+#define PIPELINE_THREAD_IDLE                1       // waiting for an input object
+#define PIPELINE_THREAD_BLOCKED             2       // waiting for an empty object
+#define PIPELINE_THREAD_STATE_COUNT         3
+
+    // Event types
+#define PIPELINE_EVENT_OBJECT               0       // an input object was processed
+#define PIPELINE_EVENT_POST                 1       // an object was posted to a stage
+#define PIPELINE_EVENT_GET                  2       // an object was taken by a stage
+
+    /*********************************************************************
+     * PipelineEvent
+     *   One entry of the trace of a thread. OBJECT events span
+     *   [time_us, time_us + duration_us]; POST and GET events record
+     *   the depth of the input fifo of stage_index after the operation.
+     *********************************************************************/
+    typedef struct EbPipelineEvent
+    {
+        uint64_t                 time_us;
+        uint64_t                 duration_us;
+        uint64_t                 picture_number;
+        uint16_t                 stage_index;
+        uint16_t                 type;
+        uint32_t                 fifo_depth;
+
+    } EbPipelineEvent;
+
+    /*********************************************************************
+     * PipelineStageCounters
+     *   Counters of one stage updated by one thread.
+     *********************************************************************/
+    typedef struct EbPipelineStageCounters
+    {
+        uint64_t                 object_count;
+        uint64_t                 processing_time_us;
+        uint64_t                 processing_time_max_us;
+        uint64_t                 cpu_time_us;
+        uint64_t                 queue_time_us;
+        uint64_t                 queue_time_max_us;
+
+    } EbPipelineStageCounters;
+
+    /*********************************************************************
+     * PipelineObject
+     *   An input object being processed by a thread. Objects nest when
+     *   a task scheduler worker runs tasks while it waits.
+     *********************************************************************/
+    typedef struct EbPipelineObject
+    {
+        uint32_t                 stage_index;
+        uint32_t                 saved_state;
+        uint64_t                 picture_number;
+        uint64_t                 start_time_us;
+        uint64_t                 nested_time_us;
+        uint64_t                 start_cpu_time_us;
+        uint64_t                 nested_cpu_time_us;
+
+    } EbPipelineObject;
+
+    /*********************************************************************
+     * PipelineThread
+     *   Owned by one encoder thread, which is the only writer. Other
+     *   threads read the counters without synchronization.
+     *********************************************************************/
+    typedef struct EbPipelineThread
+    {
+        struct EbPipelineStats  *stats_ptr;
+        uint32_t                 thread_index;
+        uint32_t                 stage_index;
+
+        uint32_t                 state;
+        uint64_t                 state_time_us;
+        uint64_t                 time_us[PIPELINE_THREAD_STATE_COUNT];
+
+        uint32_t                 object_depth;
+        EbPipelineObject         object_stack[PIPELINE_STATS_MAX_NESTING];
+        uint64_t                 picture_number;
+
+        EbPipelineStageCounters  stage_counters[PIPELINE_STATS_MAX_STAGES];
+
+        uint64_t                 event_count;
+        EbPipelineEvent         *event_array;
+
+    } EbPipelineThread;
+
+    /*********************************************************************
+     * PipelineStage
+     *   fifo_depth counts the objects posted to the input fifo of the
+     *   stage and not taken yet.
+     *********************************************************************/
+    typedef struct EbPipelineStage
+    {
+        const char              *name;
+        volatile int32_t         fifo_depth;
+        volatile int32_t         fifo_depth_max;
+
+    } EbPipelineStage;
+
+    /*********************************************************************
+     * PipelineStats
+     *   Instrumentation of the encoder pipeline. Threads register on
+     *   the first object they take from an instrumented fifo.
+     *********************************************************************/
+    typedef struct EbPipelineStats
+    {
+        uint64_t                 start_time_us;
+
+        uint32_t                 stage_count;
+        EbPipelineStage          stage_array[PIPELINE_STATS_MAX_STAGES];
+
+        uint32_t                 thread_capacity;
+        volatile int32_t         thread_count;
+        EbPipelineThread        *thread_array;
+
+    } EbPipelineStats;
+
+    /*********************************************************************
+     * eb_pipeline_stats_ctor
+     *   thread_capacity
+     *      Number of threads that can register, i.e. the number of
+     *      encoder threads taking objects from the stage fifos.
+     *********************************************************************/
+    extern EbErrorType eb_pipeline_stats_ctor(
+        EbPipelineStats **stats_dbl_ptr,
+        uint32_t          thread_capacity);
+
+    /*********************************************************************
+     * eb_pipeline_stats_add_stage
+     *   Registers a stage and returns its index, ~0u when the stage
+     *   table is full. Called before the encoder threads start.
+     *********************************************************************/
+    extern uint32_t eb_pipeline_stats_add_stage(
+        EbPipelineStats  *stats_ptr,
+        const char       *name);
+
+    /*********************************************************************
+     * Fifo hooks
+     *   Called by the system resource manager for instrumented fifos.
+     *   on_post runs before an object is queued to the input fifo of
+     *   stage_index and returns the post time stored in the object
+     *   wrapper; on_get runs after an object is taken from the fifo.
+     *   on_wait marks the calling thread as waiting in state and returns
+     *   the state on_resume restores. Waiting for an input object ends
+     *   the objects the thread was processing.
+     *********************************************************************/
+    extern uint64_t eb_pipeline_stats_on_post(
+        EbPipelineStats  *stats_ptr,
+        uint32_t          stage_index);
+
+    extern void eb_pipeline_stats_on_get(
+        EbPipelineStats  *stats_ptr,
+        uint32_t          stage_index,
+        uint64_t          post_time_us);
+
+    extern uint32_t eb_pipeline_stats_on_wait(
+        uint32_t          state);
+
+    extern void eb_pipeline_stats_on_resume(
+        uint32_t          state);
+
+    /*********************************************************************
+     * eb_pipeline_stats_end_object
+     *   Ends the innermost object of the calling thread. Called by the
+     *   task scheduler when a kernel returns; threads blocking on their
+     *   input fifo end their objects when they call eb_get_full_object.
+     *********************************************************************/
+    extern void eb_pipeline_stats_end_object(void);
+
+    /*********************************************************************
+     * eb_pipeline_stats_set_picture
+     *   Called by the kernels once they know the picture number of the
+     *   object they took; no-op on threads that are not instrumented.
+     *********************************************************************/
+    extern void eb_pipeline_stats_set_picture(
+        uint64_t          picture_number);
+
+    /*********************************************************************
+     * eb_pipeline_stats_get
+     *   Snapshot of the counters, see eb_svt_enc_get_stats().
+     *********************************************************************/
+    extern void eb_pipeline_stats_get(
+        EbPipelineStats  *stats_ptr,
+        EbSvtEncStats    *enc_stats_ptr);
+
+    /*********************************************************************
+     * eb_pipeline_stats_write_trace
+     *   Writes the events kept by every thread to file_name in the
+     *   Chrome trace event JSON format.
+     *********************************************************************/
+    extern EbErrorType eb_pipeline_stats_write_trace(
+        EbPipelineStats  *stats_ptr,
+        const char       *file_name);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //EbPipelineStats_h
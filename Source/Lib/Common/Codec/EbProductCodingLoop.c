@@ -2935,6 +2935,92 @@ uint8_t check_skip_sub_blks(
 #endif
 
 
+/***************************************
+ * MD recon cache
+ *   The luma prediction, quantized coefficients and recon of the MD winner
+ *   are kept per depth so the encode pass can commit them instead of
+ *   running the transform loop again. Each square owns two slots: the
+ *   shape being tested never writes over the best shape so far.
+ ***************************************/
+static void md_recon_cache_init_block(
+    SequenceControlSet       *sequence_control_set_ptr,
+    ModeDecisionContext_t    *context_ptr)
+{
+    const BlockGeom *blk_geom = context_ptr->blk_geom;
+
+    context_ptr->md_ep_pipe_sb[context_ptr->cu_ptr->mds_idx].recon_cache_slot = MD_RECON_CACHE_SLOT_NONE;
+
+    if (sequence_control_set_ptr->sb_size_pix != BLOCK_SIZE_64 || blk_geom->nsi != 0)
+        return;
+
+    uint8_t depth = (uint8_t)(LOG2F(blk_geom->sq_size) - 2);
+    uint8_t slot = blk_geom->shape == PART_N ? 0 : 1 - context_ptr->md_recon_cache_best_slot[depth];
+    context_ptr->md_recon_cache_write_slot[depth] = slot;
+
+    // Drop what the previous shape of the square left in the slot
+    const BlockGeom *sq_geom = get_blk_geom_mds(blk_geom->sqi_mds);
+    MdReconCache_t  *cache = &context_ptr->md_recon_cache[depth][slot];
+    uint32_t         x, y;
+    for (y = sq_geom->origin_y >> 2; y < (uint32_t)(sq_geom->origin_y + blk_geom->sq_size) >> 2; y++)
+        for (x = sq_geom->origin_x >> 2; x < (uint32_t)(sq_geom->origin_x + blk_geom->sq_size) >> 2; x++)
+            cache->txb[y * MD_RECON_CACHE_TXB_STRIDE + x].valid = 0;
+}
+
+static void md_recon_cache_store(
+    SequenceControlSet              *sequence_control_set_ptr,
+    PictureControlSet_t             *picture_control_set_ptr,
+    ModeDecisionContext_t           *context_ptr,
+    ModeDecisionCandidateBuffer_t   *candidateBuffer)
+{
+    const BlockGeom         *blk_geom = context_ptr->blk_geom;
+    ModeDecisionCandidate_t *candidate_ptr = candidateBuffer->candidate_ptr;
+
+    // The luma recon is not built in open loop, and the 16 bit path is not cached
+    if (!sequence_control_set_ptr->static_config.md_recon_cache_flag ||
+        sequence_control_set_ptr->sb_size_pix != BLOCK_SIZE_64 ||
+        sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT ||
+        picture_control_set_ptr->intra_md_open_loop_flag)
+        return;
+
+    uint8_t         depth = (uint8_t)(LOG2F(blk_geom->sq_size) - 2);
+    uint8_t         slot = context_ptr->md_recon_cache_write_slot[depth];
+    MdReconCache_t *cache = &context_ptr->md_recon_cache[depth][slot];
+    uint32_t        txb_1d_offset = 0;
+    uint32_t        txb_itr, j;
+
+    for (txb_itr = 0; txb_itr < blk_geom->txb_count; txb_itr++) {
+        uint32_t tx_org_x = blk_geom->tx_org_x[txb_itr];
+        uint32_t tx_org_y = blk_geom->tx_org_y[txb_itr];
+        uint32_t tx_width = blk_geom->tx_width[txb_itr];
+        uint32_t tx_height = blk_geom->tx_height[txb_itr];
+        uint32_t cache_offset = tx_org_x + tx_org_y * MD_RECON_CACHE_STRIDE;
+        uint32_t pred_offset = tx_org_x + tx_org_y * candidateBuffer->prediction_ptr->stride_y;
+        uint32_t recon_offset = tx_org_x + tx_org_y * candidateBuffer->recon_ptr->stride_y;
+        MdReconCacheTxb_t *txb = &cache->txb[(tx_org_y >> 2) * MD_RECON_CACHE_TXB_STRIDE + (tx_org_x >> 2)];
+        uint16_t eob = candidate_ptr->eob[0][txb_itr];
+
+        for (j = 0; j < tx_height; j++) {
+            memcpy(cache->pred + cache_offset + j * MD_RECON_CACHE_STRIDE, candidateBuffer->prediction_ptr->buffer_y + pred_offset + j * candidateBuffer->prediction_ptr->stride_y, tx_width);
+            memcpy(cache->recon + cache_offset + j * MD_RECON_CACHE_STRIDE, candidateBuffer->recon_ptr->buffer_y + recon_offset + j * candidateBuffer->recon_ptr->stride_y, tx_width);
+            memcpy(cache->coeff + cache_offset + j * MD_RECON_CACHE_STRIDE, ((int32_t*)candidateBuffer->residualQuantCoeffPtr->buffer_y) + txb_1d_offset + j * tx_width, tx_width * sizeof(int32_t));
+        }
+
+        txb->y_distortion[DIST_CALC_RESIDUAL] = candidate_ptr->y_txb_distortion[txb_itr][DIST_CALC_RESIDUAL];
+        txb->y_distortion[DIST_CALC_PREDICTION] = candidate_ptr->y_txb_distortion[txb_itr][DIST_CALC_PREDICTION];
+        txb->eob = eob;
+        txb->tx_size = (uint8_t)blk_geom->txsize[txb_itr];
+        txb->tx_type = (uint8_t)candidate_ptr->transform_type[PLANE_TYPE_Y];
+        txb->qindex = md_recon_cache_qindex(picture_control_set_ptr, context_ptr->cu_ptr->qp);
+        // The recon only holds the residual when the txb kept its coefficients
+        txb->valid = (candidate_ptr->y_txb_full_shape & (1 << txb_itr)) &&
+            (eob == 0 || (candidate_ptr->y_has_coeff & (1 << txb_itr))) ? 1 : 0;
+
+        txb_1d_offset += tx_width * tx_height;
+    }
+
+    context_ptr->md_ep_pipe_sb[context_ptr->cu_ptr->mds_idx].recon_cache_slot = slot;
+}
+
 void md_encode_block(
     SequenceControlSet             *sequence_control_set_ptr,
     PictureControlSet_t              *picture_control_set_ptr,
@@ -2967,6 +3053,12 @@ void md_encode_block(
     const uint32_t cuChromaOriginIndex = ROUND_UV(blk_geom->origin_x) / 2 + ROUND_UV(blk_geom->origin_y) / 2 * SB_STRIDE_UV;
     CodingUnit_t *  cu_ptr = context_ptr->cu_ptr;
     candidate_buffer_ptr_array = &(candidateBufferPtrArrayBase[0]);
+    EbBool recon_cache_flag = EB_TRUE;
+
+    md_recon_cache_init_block(
+        sequence_control_set_ptr,
+        context_ptr);
+
     EbBool is_nsq_table_used = (picture_control_set_ptr->slice_type == !I_SLICE &&
         picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode <= PIC_ALL_C_DEPTH_MODE &&
         picture_control_set_ptr->parent_pcs_ptr->nsq_search_level >= NSQ_SEARCH_LEVEL1 &&
@@ -3179,6 +3271,8 @@ void md_encode_block(
                     candidateBuffer,
                     asm_type);
                 cu_ptr->interp_filters = candidateBuffer->candidate_ptr->interp_filters;
+                // The coefficients are not refreshed for the new prediction
+                recon_cache_flag = EB_FALSE;
             }
         }
         inter_depth_tx_search(
@@ -3237,6 +3331,13 @@ void md_encode_block(
             }
         }
 
+        if (recon_cache_flag)
+            md_recon_cache_store(
+                sequence_control_set_ptr,
+                picture_control_set_ptr,
+                context_ptr,
+                candidateBuffer);
+
 
 #if NO_ENCDEC
         //copy recon
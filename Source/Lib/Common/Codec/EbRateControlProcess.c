@@ -3832,6 +3832,7 @@ void* rate_control_kernel(void *input_ptr)
         case RC_PICTURE_MANAGER_RESULT:
 
             picture_control_set_ptr = (PictureControlSet_t  *)rate_control_tasks_ptr->picture_control_set_wrapper_ptr->object_ptr;
+            eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
             sequence_control_set_ptr = (SequenceControlSet *)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
 
 
@@ -4046,6 +4047,7 @@ void* rate_control_kernel(void *input_ptr)
                 &rate_control_results_wrapper_ptr);
             rate_control_results_ptr = (RateControlResults*)rate_control_results_wrapper_ptr->object_ptr;
             rate_control_results_ptr->picture_control_set_wrapper_ptr = rate_control_tasks_ptr->picture_control_set_wrapper_ptr;
+            rate_control_results_ptr->intrabc_hash_flag = EB_FALSE;
 
             // Post Full Rate Control Results
             eb_post_full_object(rate_control_results_wrapper_ptr);
@@ -4058,6 +4060,7 @@ void* rate_control_kernel(void *input_ptr)
         case RC_PACKETIZATION_FEEDBACK_RESULT:
 
             parentpicture_control_set_ptr = (PictureParentControlSet_t  *)rate_control_tasks_ptr->picture_control_set_wrapper_ptr->object_ptr;
+            eb_pipeline_stats_set_picture(parentpicture_control_set_ptr->picture_number);
             sequence_control_set_ptr = (SequenceControlSet *)parentpicture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
 #if RC_FEEDBACK
             if (sequence_control_set_ptr->static_config.rate_control_mode) {
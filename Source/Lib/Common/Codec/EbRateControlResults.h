@@ -17,6 +17,7 @@ extern "C" {
  **************************************/
 typedef struct RateControlResults {
     EbObjectWrapper *picture_control_set_wrapper_ptr;
+    EbBool           intrabc_hash_flag; // joins the intra block copy hash generation of the picture
 } RateControlResults;
 
 typedef struct RateControlResultsInitData {
@@ -145,7 +145,8 @@ EbErrorType eb_reference_object_ctor(
 {
 
     EbReferenceObject              *referenceObject;
-    EbPictureBufferDescInitData_t    *pictureBufferDescInitDataPtr = (EbPictureBufferDescInitData_t*)object_init_data_ptr;
+    EbReferenceObjectDescInitData    *referenceObjectDescInitDataPtr = (EbReferenceObjectDescInitData*)object_init_data_ptr;
+    EbPictureBufferDescInitData_t    *pictureBufferDescInitDataPtr = &referenceObjectDescInitDataPtr->reference_picture_desc_init_data;
     EbPictureBufferDescInitData_t    pictureBufferDescInitData16BitPtr = *pictureBufferDescInitDataPtr;
     EbErrorType return_error = EB_ErrorNone;
     EB_MALLOC(EbReferenceObject*, referenceObject, sizeof(EbReferenceObject), EB_N_PTR);
@@ -186,6 +187,10 @@ EbErrorType eb_reference_object_ctor(
     // Allocate SB based TMVP map
     EB_MALLOC(TmvpUnit_t *, referenceObject->tmvp_map, (sizeof(TmvpUnit_t) * (((pictureBufferDescInitDataPtr->maxWidth + (64 - 1)) >> 6) * ((pictureBufferDescInitDataPtr->maxHeight + (64 - 1)) >> 6))), EB_N_PTR);
 
+    // SB based statistics, sized from the actual picture
+    EB_MALLOC(uint8_t*, referenceObject->intra_coded_area_sb, sizeof(uint8_t) * referenceObjectDescInitDataPtr->sb_total_count, EB_N_PTR);
+    EB_MALLOC(uint32_t*, referenceObject->non_moving_index_array, sizeof(uint32_t) * referenceObjectDescInitDataPtr->sb_total_count, EB_N_PTR);
+
     //RESTRICT THIS TO M4
     {
         EbPictureBufferDescInitData_t bufDesc;
@@ -224,7 +229,8 @@ EbErrorType eb_pa_reference_object_ctor(
 {
 
     EbPaReferenceObject               *paReferenceObject;
-    EbPictureBufferDescInitData_t       *pictureBufferDescInitDataPtr = (EbPictureBufferDescInitData_t*)object_init_data_ptr;
+    EbPaReferenceObjectDescInitData     *paReferenceObjectDescInitDataPtr = (EbPaReferenceObjectDescInitData*)object_init_data_ptr;
+    EbPictureBufferDescInitData_t       *pictureBufferDescInitDataPtr = &paReferenceObjectDescInitDataPtr->reference_picture_desc_init_data;
     EbErrorType return_error = EB_ErrorNone;
     EB_MALLOC(EbPaReferenceObject*, paReferenceObject, sizeof(EbPaReferenceObject), EB_N_PTR);
     *object_dbl_ptr = (EbPtr)paReferenceObject;
@@ -241,7 +247,7 @@ EbErrorType eb_pa_reference_object_ctor(
     paReferenceObject->quarter_decimated_picture_ptr = (EbPictureBufferDesc_t*)EB_NULL;
     return_error = eb_picture_buffer_desc_ctor(
         (EbPtr*) &(paReferenceObject->quarter_decimated_picture_ptr),
-        (EbPtr)(pictureBufferDescInitDataPtr + 1));
+        (EbPtr)&paReferenceObjectDescInitDataPtr->quarter_picture_desc_init_data);
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
@@ -250,11 +256,15 @@ EbErrorType eb_pa_reference_object_ctor(
     paReferenceObject->sixteenth_decimated_picture_ptr = (EbPictureBufferDesc_t*)EB_NULL;
     return_error = eb_picture_buffer_desc_ctor(
         (EbPtr*) &(paReferenceObject->sixteenth_decimated_picture_ptr),
-        (EbPtr)(pictureBufferDescInitDataPtr + 2));
+        (EbPtr)&paReferenceObjectDescInitDataPtr->sixteenth_picture_desc_init_data);
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
 
+    // SB based statistics, sized from the actual picture
+    EB_MALLOC(uint16_t*, paReferenceObject->variance, sizeof(uint16_t) * paReferenceObjectDescInitDataPtr->sb_total_count, EB_N_PTR);
+    EB_MALLOC(uint8_t*, paReferenceObject->y_mean, sizeof(uint8_t) * paReferenceObjectDescInitDataPtr->sb_total_count, EB_N_PTR);
+
     return EB_ErrorNone;
 }
 
@@ -26,8 +26,8 @@ typedef struct EbReferenceObject
 #endif
     EB_SLICE                        slice_type;
     uint8_t                         intra_coded_area;//percentage of intra coded area 0-100%
-    uint8_t                         intra_coded_area_sb[MAX_NUMBER_OF_TREEBLOCKS_PER_PICTURE];//percentage of intra coded area 0-100%
-    uint32_t                        non_moving_index_array[MAX_NUMBER_OF_TREEBLOCKS_PER_PICTURE];//array to hold non-moving blocks in reference frames
+    uint8_t                        *intra_coded_area_sb;//percentage of intra coded area 0-100%
+    uint32_t                       *non_moving_index_array;//array to hold non-moving blocks in reference frames
     EbBool                          penalize_skipflag;
     uint8_t                         tmp_layer_idx;
     EbBool                          is_scene_change;
@@ -40,6 +40,7 @@ typedef struct EbReferenceObject
 
 typedef struct EbReferenceObjectDescInitData {
     EbPictureBufferDescInitData_t   reference_picture_desc_init_data;
+    uint32_t                        sb_total_count;
 } EbReferenceObjectDescInitData;
 
 typedef struct EbPaReferenceObject 
@@ -47,8 +48,8 @@ typedef struct EbPaReferenceObject
     EbPictureBufferDesc_t          *input_padded_picture_ptr;
     EbPictureBufferDesc_t          *quarter_decimated_picture_ptr;
     EbPictureBufferDesc_t          *sixteenth_decimated_picture_ptr;
-    uint16_t                        variance[MAX_NUMBER_OF_TREEBLOCKS_PER_PICTURE];
-    uint8_t                         y_mean[MAX_NUMBER_OF_TREEBLOCKS_PER_PICTURE];
+    uint16_t                       *variance;
+    uint8_t                        *y_mean;
     EB_SLICE                        slice_type;
     uint32_t                        dependent_pictures_count; //number of pic using this reference frame
     PictureParentControlSet_t      *p_pcs_ptr;
@@ -60,6 +61,7 @@ typedef struct EbPaReferenceObjectDescInitData
     EbPictureBufferDescInitData_t   reference_picture_desc_init_data;
     EbPictureBufferDescInitData_t   quarter_picture_desc_init_data;
     EbPictureBufferDescInitData_t   sixteenth_picture_desc_init_data;
+    uint32_t                        sb_total_count;
 } EbPaReferenceObjectDescInitData;
 
 /**************************************
@@ -577,7 +577,12 @@ void* resource_coordination_kernel(void *input_ptr)
         picture_control_set_ptr->sb_total_count = sequence_control_set_ptr->sb_total_count;
         picture_control_set_ptr->eos_coming = (ebInputPtr->flags & (EB_BUFFERFLAG_EOS << 1)) ? EB_TRUE : EB_FALSE;
 
-        if (sequence_control_set_ptr->static_config.speed_control_flag) {
+        picture_control_set_ptr->effort_level = 0;
+        picture_control_set_ptr->encode_time_us = 0;
+        picture_control_set_ptr->late_sb_count = 0;
+        picture_control_set_ptr->luma_txb_count = 0;
+        picture_control_set_ptr->reused_luma_txb_count = 0;
+        if (sequence_control_set_ptr->static_config.speed_control_flag == 1) {
             SpeedBufferControl(
                 context_ptr,
                 picture_control_set_ptr,
@@ -597,6 +602,9 @@ void* resource_coordination_kernel(void *input_ptr)
 
         // Set the block mean calculation prec
         sequence_control_set_ptr->block_mean_calc_prec = BLOCK_MEAN_PREC_SUB;
+
+        // Set the screen content detection mode
+        sequence_control_set_ptr->sc_detection_mode = SC_DETECTION_FULL;
     
         // Pre-Analysis Signal(s) derivation
         signal_derivation_pre_analysis_oq(
@@ -627,8 +635,17 @@ void* resource_coordination_kernel(void *input_ptr)
 
         // Picture Stats
         picture_control_set_ptr->picture_number = context_ptr->picture_number_array[instance_index]++;
+        eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
         ResetPcsAv1(picture_control_set_ptr);
 
+        // Deadline speed control: keep the preset, lower the effort within it
+        if (sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr) {
+            picture_control_set_ptr->arrival_time_us = eb_get_time_stamp_us();
+            picture_control_set_ptr->effort_level = eb_deadline_control_start_picture(
+                sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr,
+                picture_control_set_ptr->picture_number);
+        }
+
         sequence_control_set_ptr->encode_context_ptr->initial_picture = EB_FALSE;
 
         // Get Empty Reference Picture Object
@@ -657,6 +674,8 @@ void* resource_coordination_kernel(void *input_ptr)
                 &outputWrapperPtr);
             outputResultsPtr = (ResourceCoordinationResults*)outputWrapperPtr->object_ptr;
             outputResultsPtr->picture_control_set_wrapper_ptr = prevPictureControlSetWrapperPtr;
+            outputResultsPtr->segment_join_flag = EB_FALSE;
+            outputResultsPtr->denoise_join_flag = EB_FALSE;
 
             // Post the finished Results Object
             eb_post_full_object(outputWrapperPtr);
@@ -16,6 +16,8 @@ extern "C" {
      **************************************/
     typedef struct ResourceCoordinationResults {
         EbObjectWrapper *picture_control_set_wrapper_ptr;
+        EbBool           segment_join_flag;     // joins the analysis segments of the picture
+        EbBool           denoise_join_flag;     // joins the film grain denoising rows of the picture
     } ResourceCoordinationResults;
 
     typedef struct ResourceCoordinationResultInitData {
@@ -27,24 +27,39 @@
 void ReconOutput(
     PictureControlSet_t    *picture_control_set_ptr,
     SequenceControlSet   *sequence_control_set_ptr);
-void av1_loop_restoration_filter_frame(Yv12BufferConfig *frame,
+int32_t av1_loop_restoration_stripe_row_count(const Av1Common *cm);
+EbErrorType av1_loop_restoration_filter_frame_init(Yv12BufferConfig *frame,
     Av1Common *cm, int32_t optimized_lr);
+void av1_loop_restoration_filter_stripe_row(Yv12BufferConfig *frame,
+    Av1Common *cm, Yv12BufferConfig *work, int32_t *tmpbuf, int32_t stripe_row);
+void av1_loop_restoration_copy_stripe_row(Yv12BufferConfig *frame,
+    Av1Common *cm, int32_t stripe_row);
+void av1_add_film_grain_init(EbPictureBufferDesc_t *src,
+    EbPictureBufferDesc_t *dst,
+    aom_film_grain_t *film_grain_ptr,
+    aom_film_grain_synth_t *fgs);
+EbErrorType av1_add_film_grain_rows(EbPictureBufferDesc_t *src,
+    EbPictureBufferDesc_t *dst,
+    const aom_film_grain_synth_t *fgs,
+    int32_t stripe);
 void CopyStatisticsToRefObject(
     PictureControlSet_t    *picture_control_set_ptr,
     SequenceControlSet   *sequence_control_set_ptr);
 void PsnrCalculations(
     PictureControlSet_t    *picture_control_set_ptr,
     SequenceControlSet   *sequence_control_set_ptr);
-void PadRefAndSetFlags(
-    PictureControlSet_t    *picture_control_set_ptr,
-    SequenceControlSet   *sequence_control_set_ptr);
-void generate_padding(
+void SetRefFlags(
+    PictureControlSet_t    *picture_control_set_ptr);
+void generate_padding_rows(
     EbByte              src_pic,
     uint32_t            src_stride,
     uint32_t            original_src_width,
     uint32_t            original_src_height,
     uint32_t            padding_width,
-    uint32_t            padding_height);
+    uint32_t            padding_height,
+    uint32_t            row_start,
+    uint32_t            row_end,
+    EbBool              is16bit);
 void restoration_seg_search(
     RestContext          *context_ptr,
     Yv12BufferConfig       *org_fts,
@@ -62,6 +77,7 @@ EbErrorType rest_context_ctor(
     EbFifo                *rest_input_fifo_ptr,
     EbFifo                *rest_output_fifo_ptr ,
     EbFifo                *picture_demux_fifo_ptr,
+    EbFifo                *rest_feedback_fifo_ptr,
     EbBool                  is16bit,
     EbColorFormat           color_format,
     uint32_t                max_input_luma_width,
@@ -77,6 +93,7 @@ EbErrorType rest_context_ctor(
     context_ptr->rest_input_fifo_ptr = rest_input_fifo_ptr;
     context_ptr->rest_output_fifo_ptr = rest_output_fifo_ptr;
     context_ptr->picture_demux_fifo_ptr = picture_demux_fifo_ptr;
+    context_ptr->rest_feedback_fifo_ptr = rest_feedback_fifo_ptr;
 
 
     {
@@ -200,41 +217,382 @@ void   get_own_recon(
 
 
 /******************************************************
- * Rest Kernel
+ * Rest Publish Rows
+ *
+ * Publishes the stripe rows of a picture to a row
+ *   sync and lets the other rest threads join them.
+ *   The feedback is skipped rather than waited for
+ *   when the CDEF results are all in use, as only the
+ *   rest threads release them.
  ******************************************************/
-void* rest_kernel(void *input_ptr)
+static void rest_publish_rows(
+    RestContext                            *context_ptr,
+    SequenceControlSet                     *sequence_control_set_ptr,
+    SbRowSync_t                            *row_sync_ptr,
+    uint32_t                                row_count,
+    EbObjectWrapper                        *picture_control_set_wrapper_ptr)
 {
-    // Context & SCS & PCS
-    RestContext                            *context_ptr = (RestContext*)input_ptr;
-    PictureControlSet_t                     *picture_control_set_ptr;
-    SequenceControlSet                    *sequence_control_set_ptr;
+    uint32_t helper_count = MIN(row_count, sequence_control_set_ptr->rest_process_init_count) - 1;
+    uint32_t helper_index;
+
+    eb_block_on_mutex(row_sync_ptr->mutex);
+    SbRowSyncInit(row_sync_ptr, row_count, 1);
+    row_sync_ptr->readyRowCount = row_count;
+    eb_release_mutex(row_sync_ptr->mutex);
+
+    for (helper_index = 0; helper_index < helper_count; ++helper_index) {
+        EbObjectWrapper *feedback_wrapper_ptr;
+        CdefResults_t   *feedback_ptr;
+
+        eb_try_get_empty_object(
+            context_ptr->rest_feedback_fifo_ptr,
+            &feedback_wrapper_ptr);
+        if (feedback_wrapper_ptr == (EbObjectWrapper*)EB_NULL)
+            break;
+
+        // The helper releases the picture once done with it
+        eb_object_inc_live_count(
+            picture_control_set_wrapper_ptr,
+            1);
+
+        feedback_ptr = (CdefResults_t*)feedback_wrapper_ptr->object_ptr;
+        feedback_ptr->picture_control_set_wrapper_ptr = picture_control_set_wrapper_ptr;
+        feedback_ptr->segment_index = REST_FEEDBACK_SEGMENT_INDEX;
+        eb_post_full_object(feedback_wrapper_ptr);
+    }
+}
 
-    //// Input
-    EbObjectWrapper                       *cdef_results_wrapper_ptr;
-    CdefResults_t                         *cdef_results_ptr;
+/******************************************************
+ * Rest Copy Stripe Row
+ *
+ * Copies a filtered stripe row back to the recon, then
+ *   pads its rows of the reference picture and copies
+ *   and pads its rows of the denoised source.
+ ******************************************************/
+static void rest_copy_stripe_row(
+    PictureControlSet_t                     *picture_control_set_ptr,
+    SequenceControlSet                      *sequence_control_set_ptr,
+    uint32_t                                 stripe_row)
+{
+    EbBool  is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common* cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
+
+    if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+        cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+        cm->rst_info[2].frame_restoration_type != RESTORE_NONE)
+    {
+        av1_loop_restoration_copy_stripe_row(
+            cm->frame_to_show,
+            cm,
+            (int32_t)stripe_row);
+    }
+
+    if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_FALSE)
+        return;
+
+    EbReferenceObject   *referenceObject = (EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr;
+    EbPictureBufferDesc_t *refPicPtr = is16bit ? referenceObject->reference_picture16bit : referenceObject->reference_picture;
+    const int32_t  stripeStart = (int32_t)stripe_row * RESTORATION_PROC_UNIT_SIZE - RESTORATION_UNIT_OFFSET;
+    const uint32_t rowStart = (uint32_t)MAX(0, stripeStart);
+    const uint32_t rowEnd = (uint32_t)MIN((int32_t)refPicPtr->height, stripeStart + RESTORATION_PROC_UNIT_SIZE);
+    const uint32_t shift = is16bit ? 1 : 0;
+
+    // Pad the reference picture
+    generate_padding_rows(
+        refPicPtr->buffer_y,
+        refPicPtr->stride_y << shift,
+        refPicPtr->width << shift,
+        refPicPtr->height,
+        refPicPtr->origin_x << shift,
+        refPicPtr->origin_y,
+        rowStart,
+        rowEnd,
+        is16bit);
+
+    generate_padding_rows(
+        refPicPtr->bufferCb,
+        refPicPtr->strideCb << shift,
+        (refPicPtr->width >> 1) << shift,
+        refPicPtr->height >> 1,
+        (refPicPtr->origin_x >> 1) << shift,
+        refPicPtr->origin_y >> 1,
+        rowStart >> 1,
+        rowEnd >> 1,
+        is16bit);
+
+    generate_padding_rows(
+        refPicPtr->bufferCr,
+        refPicPtr->strideCr << shift,
+        (refPicPtr->width >> 1) << shift,
+        refPicPtr->height >> 1,
+        (refPicPtr->origin_x >> 1) << shift,
+        refPicPtr->origin_y >> 1,
+        rowStart >> 1,
+        rowEnd >> 1,
+        is16bit);
+
+    {
+        EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+        const uint32_t  SrclumaOffSet = input_picture_ptr->origin_x + input_picture_ptr->origin_y    *input_picture_ptr->stride_y;
+        const uint32_t  SrccbOffset = (input_picture_ptr->origin_x >> 1) + (input_picture_ptr->origin_y >> 1)*input_picture_ptr->strideCb;
+        const uint32_t  SrccrOffset = (input_picture_ptr->origin_x >> 1) + (input_picture_ptr->origin_y >> 1)*input_picture_ptr->strideCr;
+
+        EbPictureBufferDesc_t *refDenPic = referenceObject->ref_den_src_picture;
+        const uint32_t           ReflumaOffSet = refDenPic->origin_x + refDenPic->origin_y    *refDenPic->stride_y;
+        const uint32_t           RefcbOffset = (refDenPic->origin_x >> 1) + (refDenPic->origin_y >> 1)*refDenPic->strideCb;
+        const uint32_t           RefcrOffset = (refDenPic->origin_x >> 1) + (refDenPic->origin_y >> 1)*refDenPic->strideCr;
+        const uint32_t           denRowStart = (uint32_t)MAX(0, stripeStart);
+        const uint32_t           denRowEnd = (uint32_t)MIN((int32_t)refDenPic->height, stripeStart + RESTORATION_PROC_UNIT_SIZE);
+
+        uint32_t  verticalIdx;
+
+        for (verticalIdx = denRowStart; verticalIdx < denRowEnd; ++verticalIdx)
+        {
+            EB_MEMCPY(refDenPic->buffer_y + ReflumaOffSet + verticalIdx * refDenPic->stride_y,
+                input_picture_ptr->buffer_y + SrclumaOffSet + verticalIdx * input_picture_ptr->stride_y,
+                input_picture_ptr->width);
+        }
+
+        for (verticalIdx = denRowStart >> 1; verticalIdx < (denRowEnd >> 1); ++verticalIdx)
+        {
+            EB_MEMCPY(refDenPic->bufferCb + RefcbOffset + verticalIdx * refDenPic->strideCb,
+                input_picture_ptr->bufferCb + SrccbOffset + verticalIdx * input_picture_ptr->strideCb,
+                input_picture_ptr->width / 2);
+
+            EB_MEMCPY(refDenPic->bufferCr + RefcrOffset + verticalIdx * refDenPic->strideCr,
+                input_picture_ptr->bufferCr + SrccrOffset + verticalIdx * input_picture_ptr->strideCr,
+                input_picture_ptr->width / 2);
+        }
+
+        generate_padding_rows(
+            refDenPic->buffer_y,
+            refDenPic->stride_y,
+            refDenPic->width,
+            refDenPic->height,
+            refDenPic->origin_x,
+            refDenPic->origin_y,
+            denRowStart,
+            denRowEnd,
+            EB_FALSE);
+
+        generate_padding_rows(
+            refDenPic->bufferCb,
+            refDenPic->strideCb,
+            refDenPic->width >> 1,
+            refDenPic->height >> 1,
+            refDenPic->origin_x >> 1,
+            refDenPic->origin_y >> 1,
+            denRowStart >> 1,
+            denRowEnd >> 1,
+            EB_FALSE);
+
+        generate_padding_rows(
+            refDenPic->bufferCr,
+            refDenPic->strideCr,
+            refDenPic->width >> 1,
+            refDenPic->height >> 1,
+            refDenPic->origin_x >> 1,
+            refDenPic->origin_y >> 1,
+            denRowStart >> 1,
+            denRowEnd >> 1,
+            EB_FALSE);
+    }
+}
 
+/******************************************************
+ * Rest Picture Done
+ *
+ * Outputs the recon and posts the reference picture
+ *   and the picture to entropy coding once every
+ *   stripe row is copied back and padded.
+ ******************************************************/
+static void rest_picture_done(
+    RestContext                            *context_ptr,
+    PictureControlSet_t                     *picture_control_set_ptr,
+    SequenceControlSet                      *sequence_control_set_ptr,
+    EbObjectWrapper                        *picture_control_set_wrapper_ptr)
+{
     //// Output
     EbObjectWrapper                       *rest_results_wrapper_ptr;
     RestResults_t*                          rest_results_ptr;
     EbObjectWrapper                       *picture_demux_results_wrapper_ptr;
     PictureDemuxResults_t                   *picture_demux_results_rtr;
-    // SB Loop variables
+    int32_t                                 tile_count;
+    int32_t                                 tile_index;
+    uint8_t lcuSizeLog2 = (uint8_t)Log2f(sequence_control_set_ptr->sb_size_pix);
+
+    // Set up TMVP flag and ref POC of the padded reference picture
+    if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
+        SetRefFlags(
+            picture_control_set_ptr);
+
+    if (sequence_control_set_ptr->static_config.recon_enabled) {
+        ReconOutput(
+            picture_control_set_ptr,
+            sequence_control_set_ptr);
+    }
 
 
-    for (;;) {
+    if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag)
+    {
+
+        // Get Empty PicMgr Results
+        eb_get_empty_object(
+            context_ptr->picture_demux_fifo_ptr,
+            &picture_demux_results_wrapper_ptr);
+
+        picture_demux_results_rtr = (PictureDemuxResults_t*)picture_demux_results_wrapper_ptr->object_ptr;
+        picture_demux_results_rtr->reference_picture_wrapper_ptr = picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
+        picture_demux_results_rtr->sequence_control_set_wrapper_ptr = picture_control_set_ptr->sequence_control_set_wrapper_ptr;
+        picture_demux_results_rtr->picture_number = picture_control_set_ptr->picture_number;
+        picture_demux_results_rtr->pictureType = EB_PIC_REFERENCE;
+
+        // Post Reference Picture
+        eb_post_full_object(picture_demux_results_wrapper_ptr);
+    }
+
+
+
+    // Get Empty rest Results to EC, one per tile so that the tiles are coded in parallel
+    tile_count = picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_cols * picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_rows;
+    for (tile_index = 0; tile_index < tile_count; ++tile_index) {
+        eb_get_empty_object(
+            context_ptr->rest_output_fifo_ptr,
+            &rest_results_wrapper_ptr);
+        rest_results_ptr = (struct RestResults_s*)rest_results_wrapper_ptr->object_ptr;
+        rest_results_ptr->picture_control_set_wrapper_ptr = picture_control_set_wrapper_ptr;
+        rest_results_ptr->completed_lcu_row_index_start = 0;
+        rest_results_ptr->completed_lcu_row_count = ((sequence_control_set_ptr->luma_height + sequence_control_set_ptr->sb_size_pix - 1) >> lcuSizeLog2);
+        rest_results_ptr->tile_index = (uint16_t)tile_index;
+        // Post Rest Results
+        eb_post_full_object(rest_results_wrapper_ptr);
+    }
+}
+
+/******************************************************
+ * Rest Film Grain Pictures
+ *
+ * Recon the film grain of the recon output is added to,
+ *   the film grain picture and the grain parameters.
+ ******************************************************/
+static void rest_film_grain_pictures(
+    PictureControlSet_t                     *picture_control_set_ptr,
+    SequenceControlSet                      *sequence_control_set_ptr,
+    EbPictureBufferDesc_t                  **recon_ptr,
+    EbPictureBufferDesc_t                  **film_grain_picture_ptr,
+    aom_film_grain_t                       **film_grain_ptr)
+{
+    EbBool is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+
+    if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+        EbReferenceObject *reference_object = (EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr;
+        *recon_ptr = is16bit ? reference_object->reference_picture16bit : reference_object->reference_picture;
+        *film_grain_ptr = &reference_object->film_grain_params;
+    }
+    else {
+        *recon_ptr = is16bit ? picture_control_set_ptr->recon_picture16bit_ptr : picture_control_set_ptr->recon_picture_ptr;
+        *film_grain_ptr = &picture_control_set_ptr->parent_pcs_ptr->film_grain_params;
+    }
+    *film_grain_picture_ptr = is16bit ?
+        picture_control_set_ptr->film_grain_picture16bit_ptr :
+        picture_control_set_ptr->film_grain_picture_ptr;
+}
 
-        // Get Cdef Results
-        eb_get_full_object(
-            context_ptr->rest_input_fifo_ptr,
-            &cdef_results_wrapper_ptr);
+/******************************************************
+ * Rest Copy Done
+ *
+ * Once every stripe row is copied back and padded,
+ *   publishes the film grain stripes of the recon
+ *   output, or finishes the picture without them.
+ ******************************************************/
+static void rest_copy_done(
+    RestContext                            *context_ptr,
+    PictureControlSet_t                     *picture_control_set_ptr,
+    SequenceControlSet                      *sequence_control_set_ptr,
+    EbObjectWrapper                        *picture_control_set_wrapper_ptr)
+{
+    picture_control_set_ptr->film_grain_recon_flag = (EbBool)(
+        sequence_control_set_ptr->static_config.recon_enabled &&
+        sequence_control_set_ptr->film_grain_params_present);
+
+    if (picture_control_set_ptr->film_grain_recon_flag) {
+        EbPictureBufferDesc_t *recon_ptr;
+        EbPictureBufferDesc_t *film_grain_picture_ptr;
+        aom_film_grain_t      *film_grain_ptr;
+
+        rest_film_grain_pictures(
+            picture_control_set_ptr,
+            sequence_control_set_ptr,
+            &recon_ptr,
+            &film_grain_picture_ptr,
+            &film_grain_ptr);
+        av1_add_film_grain_init(
+            recon_ptr,
+            film_grain_picture_ptr,
+            film_grain_ptr,
+            picture_control_set_ptr->film_grain_synth);
+
+        rest_publish_rows(
+            context_ptr,
+            sequence_control_set_ptr,
+            picture_control_set_ptr->rest_grain_row_sync,
+            (uint32_t)av1_film_grain_stripe_count(film_grain_picture_ptr->height),
+            picture_control_set_wrapper_ptr);
+    }
+    else {
+        rest_picture_done(
+            context_ptr,
+            picture_control_set_ptr,
+            sequence_control_set_ptr,
+            picture_control_set_wrapper_ptr);
+    }
+}
+
+/******************************************************
+ * Rest Kernel
+ *
+ * CDEF posts one result per search segment. The thread
+ *   searching the last segment picks the filters and
+ *   publishes the processing stripe rows, joined by the
+ *   other rest threads through feedback results. Once
+ *   every stripe row is filtered, the rows are published
+ *   again to be copied back and padded. With film grain
+ *   on the recon output, the grain stripes are then
+ *   published too; the thread completing the last rows
+ *   outputs the picture.
+ ******************************************************/
+void rest_kernel(
+    void            *input_ptr,
+    EbObjectWrapper *cdef_results_wrapper_ptr)
+{
+    // Context & SCS & PCS
+    RestContext                            *context_ptr = (RestContext*)input_ptr;
+    PictureControlSet_t                     *picture_control_set_ptr;
+    SequenceControlSet                    *sequence_control_set_ptr;
 
-        cdef_results_ptr = (CdefResults_t*)cdef_results_wrapper_ptr->object_ptr;
-        picture_control_set_ptr = (PictureControlSet_t*)cdef_results_ptr->picture_control_set_wrapper_ptr->object_ptr;
-        sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
-        uint8_t lcuSizeLog2 = (uint8_t)Log2f(sequence_control_set_ptr->sb_size_pix);
-        EbBool  is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
-        Av1Common* cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
+    //// Input
+    CdefResults_t                         *cdef_results_ptr;
 
+    // Stripe row variables
+    SbRowSync_t                            *filter_row_sync_ptr;
+    SbRowSync_t                            *copy_row_sync_ptr;
+    SbRowSync_t                            *grain_row_sync_ptr;
+    uint32_t                                stripe_row;
+    EbBool                                  search_done_flag = EB_FALSE;
+
+    cdef_results_ptr = (CdefResults_t*)cdef_results_wrapper_ptr->object_ptr;
+    picture_control_set_ptr = (PictureControlSet_t*)cdef_results_ptr->picture_control_set_wrapper_ptr->object_ptr;
+    eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
+    sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    filter_row_sync_ptr = picture_control_set_ptr->rest_filter_row_sync;
+    copy_row_sync_ptr = picture_control_set_ptr->rest_copy_row_sync;
+    grain_row_sync_ptr = picture_control_set_ptr->rest_grain_row_sync;
+    uint64_t workStartTime = eb_deadline_work_start(sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr);
+    EbBool  is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    Av1Common* cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
+
+    // Feedback results (no segment) only join the stripe rows of the picture
+    if (cdef_results_ptr->segment_index != REST_FEEDBACK_SEGMENT_INDEX) {
 
         if (sequence_control_set_ptr->enable_restoration && picture_control_set_ptr->parent_pcs_ptr->allow_intrabc == 0)
         {
@@ -266,165 +624,158 @@ void* rest_kernel(void *input_ptr)
 
         //all seg based search is done. update total processed segments. if all done, finish the search and perfrom application.
         eb_block_on_mutex(picture_control_set_ptr->rest_search_mutex);
-
         picture_control_set_ptr->tot_seg_searched_rest++;
-        if (picture_control_set_ptr->tot_seg_searched_rest == picture_control_set_ptr->rest_segments_total_count)
-        {
-            if (sequence_control_set_ptr->enable_restoration && picture_control_set_ptr->parent_pcs_ptr->allow_intrabc == 0) {
-                rest_finish_search(
-                    picture_control_set_ptr->parent_pcs_ptr->av1x,
-                    picture_control_set_ptr->parent_pcs_ptr->av1_cm);
-
-                if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
-                    cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
-                    cm->rst_info[2].frame_restoration_type != RESTORE_NONE)
-                {
-                    av1_loop_restoration_filter_frame(
-                        cm->frame_to_show,
-                        cm,
-                        0);
-                }
-            }
-            else {
-                cm->rst_info[0].frame_restoration_type = RESTORE_NONE;
-                cm->rst_info[1].frame_restoration_type = RESTORE_NONE;
-                cm->rst_info[2].frame_restoration_type = RESTORE_NONE;
-            }
-
-            uint8_t best_ep_cnt = 0;
-            uint8_t best_ep = 0;
-            for (uint8_t i = 0; i < SGRPROJ_PARAMS; i++) {
-                if (cm->sg_frame_ep_cnt[i] > best_ep_cnt) {
-                    best_ep = i;
-                    best_ep_cnt = cm->sg_frame_ep_cnt[i];
-                }
-            }
-            cm->sg_frame_ep = best_ep;
+        search_done_flag = (EbBool)(picture_control_set_ptr->tot_seg_searched_rest == picture_control_set_ptr->rest_segments_total_count);
+        eb_release_mutex(picture_control_set_ptr->rest_search_mutex);
+    }
 
+    if (search_done_flag)
+    {
+        EbBool filter_flag = EB_FALSE;
 
-            if (picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
-                // copy stat to ref object (intra_coded_area, Luminance, Scene change detection flags)
-                CopyStatisticsToRefObject(
-                    picture_control_set_ptr,
-                    sequence_control_set_ptr);
-            }
+        if (sequence_control_set_ptr->enable_restoration && picture_control_set_ptr->parent_pcs_ptr->allow_intrabc == 0) {
+            rest_finish_search(
+                picture_control_set_ptr->parent_pcs_ptr->av1x,
+                picture_control_set_ptr->parent_pcs_ptr->av1_cm);
 
-            //// PSNR Calculation
-            //if (sequence_control_set_ptr->static_config.stat_report) {
-            //    PsnrCalculations(
-            //        picture_control_set_ptr,
-            //        sequence_control_set_ptr);
-            //}
+            filter_flag = (EbBool)(
+                cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+                cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+                cm->rst_info[2].frame_restoration_type != RESTORE_NONE);
+        }
+        else {
+            cm->rst_info[0].frame_restoration_type = RESTORE_NONE;
+            cm->rst_info[1].frame_restoration_type = RESTORE_NONE;
+            cm->rst_info[2].frame_restoration_type = RESTORE_NONE;
+        }
 
-            // Pad the reference picture and set up TMVP flag and ref POC
-            if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-                PadRefAndSetFlags(
-                    picture_control_set_ptr,
-                    sequence_control_set_ptr);
-
-            if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE && picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr)
-            {
-                EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-                const uint32_t  SrclumaOffSet = input_picture_ptr->origin_x + input_picture_ptr->origin_y    *input_picture_ptr->stride_y;
-                const uint32_t  SrccbOffset = (input_picture_ptr->origin_x >> 1) + (input_picture_ptr->origin_y >> 1)*input_picture_ptr->strideCb;
-                const uint32_t  SrccrOffset = (input_picture_ptr->origin_x >> 1) + (input_picture_ptr->origin_y >> 1)*input_picture_ptr->strideCr;
-
-                EbReferenceObject   *referenceObject = (EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr;
-                EbPictureBufferDesc_t *refDenPic = referenceObject->ref_den_src_picture;
-                const uint32_t           ReflumaOffSet = refDenPic->origin_x + refDenPic->origin_y    *refDenPic->stride_y;
-                const uint32_t           RefcbOffset = (refDenPic->origin_x >> 1) + (refDenPic->origin_y >> 1)*refDenPic->strideCb;
-                const uint32_t           RefcrOffset = (refDenPic->origin_x >> 1) + (refDenPic->origin_y >> 1)*refDenPic->strideCr;
-
-                uint16_t  verticalIdx;
-
-                for (verticalIdx = 0; verticalIdx < refDenPic->height; ++verticalIdx)
-                {
-                    EB_MEMCPY(refDenPic->buffer_y + ReflumaOffSet + verticalIdx * refDenPic->stride_y,
-                        input_picture_ptr->buffer_y + SrclumaOffSet + verticalIdx * input_picture_ptr->stride_y,
-                        input_picture_ptr->width);
-                }
-
-                for (verticalIdx = 0; verticalIdx < input_picture_ptr->height / 2; ++verticalIdx)
-                {
-                    EB_MEMCPY(refDenPic->bufferCb + RefcbOffset + verticalIdx * refDenPic->strideCb,
-                        input_picture_ptr->bufferCb + SrccbOffset + verticalIdx * input_picture_ptr->strideCb,
-                        input_picture_ptr->width / 2);
-
-                    EB_MEMCPY(refDenPic->bufferCr + RefcrOffset + verticalIdx * refDenPic->strideCr,
-                        input_picture_ptr->bufferCr + SrccrOffset + verticalIdx * input_picture_ptr->strideCr,
-                        input_picture_ptr->width / 2);
-                }
-
-                generate_padding(
-                    refDenPic->buffer_y,
-                    refDenPic->stride_y,
-                    refDenPic->width,
-                    refDenPic->height,
-                    refDenPic->origin_x,
-                    refDenPic->origin_y);
-
-                generate_padding(
-                    refDenPic->bufferCb,
-                    refDenPic->strideCb,
-                    refDenPic->width >> 1,
-                    refDenPic->height >> 1,
-                    refDenPic->origin_x >> 1,
-                    refDenPic->origin_y >> 1);
-
-                generate_padding(
-                    refDenPic->bufferCr,
-                    refDenPic->strideCr,
-                    refDenPic->width >> 1,
-                    refDenPic->height >> 1,
-                    refDenPic->origin_x >> 1,
-                    refDenPic->origin_y >> 1);
-            }
-            if (sequence_control_set_ptr->static_config.recon_enabled) {
-                ReconOutput(
-                    picture_control_set_ptr,
-                    sequence_control_set_ptr);
+        uint8_t best_ep_cnt = 0;
+        uint8_t best_ep = 0;
+        for (uint8_t i = 0; i < SGRPROJ_PARAMS; i++) {
+            if (cm->sg_frame_ep_cnt[i] > best_ep_cnt) {
+                best_ep = i;
+                best_ep_cnt = cm->sg_frame_ep_cnt[i];
             }
+        }
+        cm->sg_frame_ep = best_ep;
 
 
-            if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag)
-            {
+        if (picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
+            // copy stat to ref object (intra_coded_area, Luminance, Scene change detection flags)
+            CopyStatisticsToRefObject(
+                picture_control_set_ptr,
+                sequence_control_set_ptr);
+        }
 
-                // Get Empty PicMgr Results
-                eb_get_empty_object(
-                    context_ptr->picture_demux_fifo_ptr,
-                    &picture_demux_results_wrapper_ptr);
+        //// PSNR Calculation
+        //if (sequence_control_set_ptr->static_config.stat_report) {
+        //    PsnrCalculations(
+        //        picture_control_set_ptr,
+        //        sequence_control_set_ptr);
+        //}
+
+        // Without the filtered frame, the picture is coded unfiltered
+        if (filter_flag && av1_loop_restoration_filter_frame_init(
+            cm->frame_to_show,
+            cm,
+            0) != EB_ErrorNone) {
+            cm->rst_info[0].frame_restoration_type = RESTORE_NONE;
+            cm->rst_info[1].frame_restoration_type = RESTORE_NONE;
+            cm->rst_info[2].frame_restoration_type = RESTORE_NONE;
+            filter_flag = EB_FALSE;
+        }
 
-                picture_demux_results_rtr = (PictureDemuxResults_t*)picture_demux_results_wrapper_ptr->object_ptr;
-                picture_demux_results_rtr->reference_picture_wrapper_ptr = picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
-                picture_demux_results_rtr->sequence_control_set_wrapper_ptr = picture_control_set_ptr->sequence_control_set_wrapper_ptr;
-                picture_demux_results_rtr->picture_number = picture_control_set_ptr->picture_number;
-                picture_demux_results_rtr->pictureType = EB_PIC_REFERENCE;
+        rest_publish_rows(
+            context_ptr,
+            sequence_control_set_ptr,
+            filter_flag ? filter_row_sync_ptr : copy_row_sync_ptr,
+            (uint32_t)av1_loop_restoration_stripe_row_count(cm),
+            cdef_results_ptr->picture_control_set_wrapper_ptr);
+    }
 
-                // Post Reference Picture
-                eb_post_full_object(picture_demux_results_wrapper_ptr);
+    // Stripe row loop, the rows are copied back once they are all filtered,
+    // and the film grain is added to the recon output once they are all copied
+    for (;;) {
+        if (SbRowSyncClaimRow(filter_row_sync_ptr, &stripe_row) == EB_TRUE) {
+            Yv12BufferConfig work_frame;
+            LinkEbToAomBufferDesc(
+                context_ptr->trial_frame_rst,
+                &work_frame);
+
+            av1_loop_restoration_filter_stripe_row(
+                cm->frame_to_show,
+                cm,
+                &work_frame,
+                context_ptr->rst_tmpbuf,
+                (int32_t)stripe_row);
+
+            if (SbRowSyncCompleteRow(filter_row_sync_ptr) == EB_TRUE) {
+                rest_publish_rows(
+                    context_ptr,
+                    sequence_control_set_ptr,
+                    copy_row_sync_ptr,
+                    filter_row_sync_ptr->rowCount,
+                    cdef_results_ptr->picture_control_set_wrapper_ptr);
             }
+        }
+        else if (SbRowSyncClaimRow(copy_row_sync_ptr, &stripe_row) == EB_TRUE) {
+            rest_copy_stripe_row(
+                picture_control_set_ptr,
+                sequence_control_set_ptr,
+                stripe_row);
 
+            if (SbRowSyncCompleteRow(copy_row_sync_ptr) == EB_TRUE) {
+                rest_copy_done(
+                    context_ptr,
+                    picture_control_set_ptr,
+                    sequence_control_set_ptr,
+                    cdef_results_ptr->picture_control_set_wrapper_ptr);
+            }
+        }
+        else if (grain_row_sync_ptr && SbRowSyncClaimRow(grain_row_sync_ptr, &stripe_row) == EB_TRUE) {
+            EbPictureBufferDesc_t *recon_ptr;
+            EbPictureBufferDesc_t *film_grain_picture_ptr;
+            aom_film_grain_t      *film_grain_ptr;
 
+            rest_film_grain_pictures(
+                picture_control_set_ptr,
+                sequence_control_set_ptr,
+                &recon_ptr,
+                &film_grain_picture_ptr,
+                &film_grain_ptr);
+            // A stripe without grain sends the recon out without any,
+            // rather than with stripes missing
+            if (av1_add_film_grain_rows(
+                recon_ptr,
+                film_grain_picture_ptr,
+                picture_control_set_ptr->film_grain_synth,
+                (int32_t)stripe_row) != EB_ErrorNone) {
+                eb_block_on_mutex(grain_row_sync_ptr->mutex);
+                picture_control_set_ptr->film_grain_recon_flag = EB_FALSE;
+                eb_release_mutex(grain_row_sync_ptr->mutex);
+            }
 
-            // Get Empty rest Results to EC
-            eb_get_empty_object(
-                context_ptr->rest_output_fifo_ptr,
-                &rest_results_wrapper_ptr);
-            rest_results_ptr = (struct RestResults_s*)rest_results_wrapper_ptr->object_ptr;
-            rest_results_ptr->picture_control_set_wrapper_ptr = cdef_results_ptr->picture_control_set_wrapper_ptr;
-            rest_results_ptr->completed_lcu_row_index_start = 0;
-            rest_results_ptr->completed_lcu_row_count = ((sequence_control_set_ptr->luma_height + sequence_control_set_ptr->sb_size_pix - 1) >> lcuSizeLog2);
-            // Post Rest Results
-            eb_post_full_object(rest_results_wrapper_ptr);
-
+            if (SbRowSyncCompleteRow(grain_row_sync_ptr) == EB_TRUE) {
+                rest_picture_done(
+                    context_ptr,
+                    picture_control_set_ptr,
+                    sequence_control_set_ptr,
+                    cdef_results_ptr->picture_control_set_wrapper_ptr);
+            }
         }
-        eb_release_mutex(picture_control_set_ptr->rest_search_mutex);
-
+        else
+            break;
+    }
 
-        // Release input Results
-        eb_release_object(cdef_results_wrapper_ptr);
+    eb_deadline_work_end(
+        sequence_control_set_ptr->encode_context_ptr->deadline_control_ptr,
+        &picture_control_set_ptr->parent_pcs_ptr->encode_time_us,
+        workStartTime);
 
-    }
+    // Release the picture held for the feedback
+    if (cdef_results_ptr->segment_index == REST_FEEDBACK_SEGMENT_INDEX)
+        eb_release_object(cdef_results_ptr->picture_control_set_wrapper_ptr);
 
-    return EB_NULL;
+    // Release input Results
+    eb_release_object(cdef_results_wrapper_ptr);
 }
@@ -23,6 +23,7 @@ typedef struct RestContext
     EbFifo                       *rest_input_fifo_ptr;
     EbFifo                       *rest_output_fifo_ptr;
     EbFifo                       *picture_demux_fifo_ptr;
+    EbFifo                       *rest_feedback_fifo_ptr;   // feedback to the rest threads to filter stripe rows
 
     EbPictureBufferDesc_t          *trial_frame_rst;
 
@@ -46,12 +47,15 @@ extern EbErrorType rest_context_ctor(
     EbFifo                       *rest_input_fifo_ptr,
     EbFifo                       *rest_output_fifo_ptr,
     EbFifo                      *picture_demux_fifo_ptr,
+    EbFifo                       *rest_feedback_fifo_ptr,
     EbBool                  is16bit,
     EbColorFormat           color_format,
     uint32_t                max_input_luma_width,
     uint32_t                max_input_luma_height
    );
 
-extern void* rest_kernel(void *input_ptr);
+extern void rest_kernel(
+    void            *input_ptr,
+    EbObjectWrapper *cdef_results_wrapper_ptr);
 
 #endif
@@ -1328,6 +1328,158 @@ void av1_loop_restoration_filter_frame(Yv12BufferConfig *frame,
     }
 }
 
+// The processing stripes of a frame are 64 luma rows high, offset upwards by
+// 8 rows. A stripe row is filtered from the deblocked boundary lines around it
+// and its own rows only, so the stripe rows of a frame can be filtered in any
+// order, or by several threads.
+int32_t av1_loop_restoration_stripe_row_count(const Av1Common *cm) {
+    return (cm->frame_to_show->crop_heights[0] + RESTORATION_UNIT_OFFSET +
+        RESTORATION_PROC_UNIT_SIZE - 1) / RESTORATION_PROC_UNIT_SIZE;
+}
+
+static void stripe_row_limits(const Yv12BufferConfig *frame, int32_t is_uv,
+    int32_t ss_y, int32_t stripe_row, int32_t *v_start, int32_t *v_end) {
+    const int32_t plane_height = frame->crop_heights[is_uv];
+    const int32_t luma_start =
+        stripe_row * RESTORATION_PROC_UNIT_SIZE - RESTORATION_UNIT_OFFSET;
+
+    *v_start = AOMMAX(0, luma_start >> ss_y);
+    *v_end = AOMMIN(plane_height,
+        (luma_start + RESTORATION_PROC_UNIT_SIZE) >> ss_y);
+}
+
+// Extend the planes to filter and allocate the filtered frame before
+// av1_loop_restoration_filter_stripe_row() is called on the stripe rows.
+// Returns EB_ErrorInsufficientResources, with nothing extended, when the
+// filtered frame cannot be allocated.
+EbErrorType av1_loop_restoration_filter_frame_init(Yv12BufferConfig *frame,
+    Av1Common *cm, int32_t optimized_lr) {
+    const int32_t num_planes = 3;// av1_num_planes(cm);
+    const int32_t highbd = cm->use_highbitdepth;
+
+    if (aom_realloc_frame_buffer(&cm->rst_frame, frame->crop_widths[0],
+        frame->crop_heights[0], cm->subsampling_x, cm->subsampling_y,
+        cm->use_highbitdepth, AOM_BORDER_IN_PIXELS,
+        cm->byte_alignment, NULL, NULL, NULL) < 0)
+        return EB_ErrorInsufficientResources;
+
+    for (int32_t plane = 0; plane < num_planes; ++plane) {
+        RestorationInfo *rsi = &cm->rst_info[plane];
+        rsi->optimized_lr = optimized_lr;
+
+        if (rsi->frame_restoration_type == RESTORE_NONE)
+            continue;
+
+        const int32_t is_uv = plane > 0;
+        extend_frame(frame->buffers[plane], frame->crop_widths[is_uv],
+            frame->crop_heights[is_uv], frame->strides[is_uv],
+            RESTORATION_BORDER, RESTORATION_BORDER, highbd);
+    }
+
+    return EB_ErrorNone;
+}
+
+typedef struct {
+    FilterFrameCtxt frame_ctxt;
+    int32_t v_start, v_end;
+} FilterStripeRowCtxt;
+
+static void filter_stripe_row_on_unit(const RestorationTileLimits *limits,
+    const AV1PixelRect *tile_rect,
+    int32_t rest_unit_idx, void *priv) {
+    FilterStripeRowCtxt *ctxt = (FilterStripeRowCtxt *)priv;
+    RestorationTileLimits row_limits = *limits;
+
+    // Units start on a stripe boundary, so the part of a unit in the stripe row
+    // is filtered as the unit would filter it
+    row_limits.v_start = AOMMAX(limits->v_start, ctxt->v_start);
+    row_limits.v_end = AOMMIN(limits->v_end, ctxt->v_end);
+    if (row_limits.v_start >= row_limits.v_end)
+        return;
+
+    filter_frame_on_unit(&row_limits, tile_rect, rest_unit_idx,
+        &ctxt->frame_ctxt);
+}
+
+// Filter a stripe row of every plane into cm->rst_frame. The stripe boundaries
+// are set up in place, so the stripe row and its borders are copied to work,
+// a frame private to the caller, and filtered from there: frame is only read.
+void av1_loop_restoration_filter_stripe_row(Yv12BufferConfig *frame,
+    Av1Common *cm, Yv12BufferConfig *work, int32_t *tmpbuf, int32_t stripe_row) {
+    const int32_t num_planes = 3;// av1_num_planes(cm);
+    Yv12BufferConfig *dst = &cm->rst_frame;
+    RestorationLineBuffers rlbs;
+    const int32_t bit_depth = cm->bit_depth;
+    const int32_t highbd = cm->use_highbitdepth;
+
+    for (int32_t plane = 0; plane < num_planes; ++plane) {
+        const RestorationInfo *rsi = &cm->rst_info[plane];
+
+        if (rsi->frame_restoration_type == RESTORE_NONE)
+            continue;
+
+        const int32_t is_uv = plane > 0;
+        const int32_t ss_y = is_uv && cm->subsampling_y;
+        const int32_t plane_width = frame->crop_widths[is_uv];
+        const int32_t plane_height = frame->crop_heights[is_uv];
+        const int32_t stride = frame->strides[is_uv];
+        const int32_t work_stride = work->strides[is_uv];
+
+        FilterStripeRowCtxt ctxt;
+        stripe_row_limits(frame, is_uv, ss_y, stripe_row, &ctxt.v_start, &ctxt.v_end);
+        if (ctxt.v_start >= ctxt.v_end)
+            continue;
+
+        const int32_t copy_start = AOMMAX(-RESTORATION_BORDER, ctxt.v_start - RESTORATION_BORDER);
+        const int32_t copy_end = AOMMIN(plane_height + RESTORATION_BORDER, ctxt.v_end + RESTORATION_BORDER);
+        copy_tile(plane_width + 2 * RESTORATION_EXTRA_HORZ, copy_end - copy_start,
+            frame->buffers[plane] + copy_start * stride - RESTORATION_EXTRA_HORZ, stride,
+            work->buffers[plane] + copy_start * work_stride - RESTORATION_EXTRA_HORZ, work_stride,
+            highbd);
+
+        ctxt.frame_ctxt.rsi = rsi;
+        ctxt.frame_ctxt.rlbs = &rlbs;
+        ctxt.frame_ctxt.cm = cm;
+        ctxt.frame_ctxt.tile_stripe0 = 0;
+        ctxt.frame_ctxt.ss_x = is_uv && cm->subsampling_x;
+        ctxt.frame_ctxt.ss_y = ss_y;
+        ctxt.frame_ctxt.highbd = highbd;
+        ctxt.frame_ctxt.bit_depth = bit_depth;
+        ctxt.frame_ctxt.data8 = work->buffers[plane];
+        ctxt.frame_ctxt.dst8 = dst->buffers[plane];
+        ctxt.frame_ctxt.data_stride = work_stride;
+        ctxt.frame_ctxt.dst_stride = dst->strides[is_uv];
+        ctxt.frame_ctxt.tmpbuf = tmpbuf;
+
+        av1_foreach_rest_unit_in_frame(cm, plane, NULL, filter_stripe_row_on_unit, &ctxt);
+    }
+}
+
+// Copy a filtered stripe row of every filtered plane back to frame, once every
+// stripe row is filtered.
+void av1_loop_restoration_copy_stripe_row(Yv12BufferConfig *frame,
+    Av1Common *cm, int32_t stripe_row) {
+    const int32_t num_planes = 3;// av1_num_planes(cm);
+    const Yv12BufferConfig *dst = &cm->rst_frame;
+
+    for (int32_t plane = 0; plane < num_planes; ++plane) {
+        if (cm->rst_info[plane].frame_restoration_type == RESTORE_NONE)
+            continue;
+
+        const int32_t is_uv = plane > 0;
+        int32_t v_start, v_end;
+        stripe_row_limits(frame, is_uv, is_uv && cm->subsampling_y, stripe_row,
+            &v_start, &v_end);
+        if (v_start >= v_end)
+            continue;
+
+        copy_tile(frame->crop_widths[is_uv], v_end - v_start,
+            dst->buffers[plane] + v_start * dst->strides[is_uv], dst->strides[is_uv],
+            frame->buffers[plane] + v_start * frame->strides[is_uv], frame->strides[is_uv],
+            cm->use_highbitdepth);
+    }
+}
+
 static void foreach_rest_unit_in_tile(const AV1PixelRect *tile_rect,
     int32_t tile_row, int32_t tile_col, int32_t tile_cols,
     int32_t hunits_per_tile, int32_t units_per_tile,
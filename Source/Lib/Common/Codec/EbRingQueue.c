@@ -0,0 +1,226 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "EbRingQueue.h"
+
+/**************************************
+ * RingQueueSpinCount
+ *   Spinning only pays off when the
+ *   producer can run at the same time.
+ **************************************/
+static uint32_t RingQueueSpinCount(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return sysinfo.dwNumberOfProcessors > 1 ? RING_QUEUE_SPIN_COUNT : 0;
+#else
+    return sysconf(_SC_NPROCESSORS_ONLN) > 1 ? RING_QUEUE_SPIN_COUNT : 0;
+#endif
+}
+
+/**************************************
+ * eb_ring_queue_ctor
+ **************************************/
+EbErrorType eb_ring_queue_ctor(
+    EbRingQueue **queue_dbl_ptr,
+    uint32_t      capacity,
+    EbBool        single_consumer)
+{
+    EbRingQueue *queue_ptr;
+    uint32_t     buffer_size = 2;
+    uint32_t     cellIndex;
+
+    EB_ALLIGN_MALLOC(EbRingQueue*, queue_ptr, sizeof(EbRingQueue), EB_A_PTR);
+    *queue_dbl_ptr = queue_ptr;
+
+    while (buffer_size < capacity)
+        buffer_size <<= 1;
+
+    EB_ALLIGN_MALLOC(EbRingCell*, queue_ptr->cell_array, sizeof(EbRingCell) * buffer_size, EB_A_PTR);
+
+    // Cell i is free for the producer that claims enqueue position i
+    for (cellIndex = 0; cellIndex < buffer_size; ++cellIndex) {
+        queue_ptr->cell_array[cellIndex].sequence = (int32_t)cellIndex;
+        queue_ptr->cell_array[cellIndex].object_ptr = EB_NULL;
+    }
+
+    queue_ptr->buffer_mask = buffer_size - 1;
+    queue_ptr->single_consumer = single_consumer;
+    queue_ptr->spin_count = RingQueueSpinCount();
+    queue_ptr->enqueue_pos = 0;
+    queue_ptr->dequeue_pos = 0;
+    queue_ptr->available_count = 0;
+
+    EB_CREATESEMAPHORE(EbHandle, queue_ptr->park_semaphore, sizeof(EbHandle), EB_SEMAPHORE, 0, buffer_size);
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * RingQueueEnqueue
+ *   Returns EB_FALSE when the ring is full.
+ **************************************/
+static EbBool RingQueueEnqueue(
+    EbRingQueue *queue_ptr,
+    EbPtr        object_ptr)
+{
+    EbRingCell *cell_ptr;
+    int32_t     pos = eb_atomic_load_32(&queue_ptr->enqueue_pos);
+    int32_t     diff;
+
+    for (;;) {
+        cell_ptr = &queue_ptr->cell_array[(uint32_t)pos & queue_ptr->buffer_mask];
+        diff = (int32_t)((uint32_t)eb_atomic_load_32(&cell_ptr->sequence) - (uint32_t)pos);
+
+        if (diff == 0) {
+            if (eb_atomic_cas_32(&queue_ptr->enqueue_pos, pos, (int32_t)((uint32_t)pos + 1)))
+                break;
+            pos = eb_atomic_load_32(&queue_ptr->enqueue_pos);
+        }
+        else if (diff < 0)
+            return EB_FALSE;
+        else
+            pos = eb_atomic_load_32(&queue_ptr->enqueue_pos);
+    }
+
+    cell_ptr->object_ptr = object_ptr;
+
+    // Publish the object to the consumer of this position
+    eb_atomic_store_32(&cell_ptr->sequence, (int32_t)((uint32_t)pos + 1));
+
+    return EB_TRUE;
+}
+
+/**************************************
+ * RingQueueDequeue
+ *   Returns EB_FALSE when the head cell is not published yet.
+ **************************************/
+static EbBool RingQueueDequeue(
+    EbRingQueue *queue_ptr,
+    EbPtr       *object_dbl_ptr)
+{
+    EbRingCell *cell_ptr;
+    int32_t     pos = eb_atomic_load_32(&queue_ptr->dequeue_pos);
+    int32_t     diff;
+
+    for (;;) {
+        cell_ptr = &queue_ptr->cell_array[(uint32_t)pos & queue_ptr->buffer_mask];
+        diff = (int32_t)((uint32_t)eb_atomic_load_32(&cell_ptr->sequence) - ((uint32_t)pos + 1));
+
+        if (diff == 0) {
+            if (queue_ptr->single_consumer) {
+                eb_atomic_store_32(&queue_ptr->dequeue_pos, (int32_t)((uint32_t)pos + 1));
+                break;
+            }
+            if (eb_atomic_cas_32(&queue_ptr->dequeue_pos, pos, (int32_t)((uint32_t)pos + 1)))
+                break;
+            pos = eb_atomic_load_32(&queue_ptr->dequeue_pos);
+        }
+        else if (diff < 0)
+            return EB_FALSE;
+        else
+            pos = eb_atomic_load_32(&queue_ptr->dequeue_pos);
+    }
+
+    *object_dbl_ptr = cell_ptr->object_ptr;
+
+    // Hand the cell back to the producer one lap ahead
+    eb_atomic_store_32(&cell_ptr->sequence, (int32_t)((uint32_t)pos + queue_ptr->buffer_mask + 1));
+
+    return EB_TRUE;
+}
+
+/**************************************
+ * RingQueueTryAcquire
+ *   Claims one object from available_count
+ *   without blocking.
+ **************************************/
+static EbBool RingQueueTryAcquire(
+    EbRingQueue *queue_ptr)
+{
+    int32_t count = eb_atomic_load_32(&queue_ptr->available_count);
+
+    while (count > 0) {
+        if (eb_atomic_cas_32(&queue_ptr->available_count, count, count - 1))
+            return EB_TRUE;
+        count = eb_atomic_load_32(&queue_ptr->available_count);
+    }
+
+    return EB_FALSE;
+}
+
+/**************************************
+ * eb_ring_queue_push
+ **************************************/
+EbErrorType eb_ring_queue_push(
+    EbRingQueue *queue_ptr,
+    EbPtr        object_ptr)
+{
+    EbErrorType return_error = EB_ErrorNone;
+
+    // A full ring only happens while a consumer is still handing a cell
+    // back, so wait for it rather than failing.
+    while (RingQueueEnqueue(queue_ptr, object_ptr) == EB_FALSE)
+        eb_cpu_pause();
+
+    // Wake a parked consumer if the count was negative
+    if (eb_atomic_fetch_add_32(&queue_ptr->available_count, 1) < 0)
+        return_error = eb_post_semaphore(queue_ptr->park_semaphore);
+
+    return return_error;
+}
+
+/**************************************
+ * eb_ring_queue_pop
+ **************************************/
+EbErrorType eb_ring_queue_pop(
+    EbRingQueue *queue_ptr,
+    EbPtr       *object_dbl_ptr)
+{
+    EbErrorType return_error = EB_ErrorNone;
+    EbBool      acquired = EB_FALSE;
+    uint32_t    spinCount;
+
+    for (spinCount = 0; spinCount < queue_ptr->spin_count && !acquired; ++spinCount) {
+        acquired = RingQueueTryAcquire(queue_ptr);
+        if (!acquired)
+            eb_cpu_pause();
+    }
+
+    // Park until a producer hands over its count
+    if (!acquired && eb_atomic_fetch_add_32(&queue_ptr->available_count, -1) <= 0)
+        return_error = eb_block_on_semaphore(queue_ptr->park_semaphore);
+
+    // The count guarantees an object, but its producer may still be
+    // publishing the cell
+    while (RingQueueDequeue(queue_ptr, object_dbl_ptr) == EB_FALSE)
+        eb_cpu_pause();
+
+    return return_error;
+}
+
+/**************************************
+ * eb_ring_queue_try_pop
+ **************************************/
+EbErrorType eb_ring_queue_try_pop(
+    EbRingQueue *queue_ptr,
+    EbPtr       *object_dbl_ptr)
+{
+    if (RingQueueTryAcquire(queue_ptr) == EB_FALSE) {
+        *object_dbl_ptr = EB_NULL;
+        return EB_ErrorNone;
+    }
+
+    while (RingQueueDequeue(queue_ptr, object_dbl_ptr) == EB_FALSE)
+        eb_cpu_pause();
+
+    return EB_ErrorNone;
+}
@@ -0,0 +1,107 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbRingQueue_h
+#define EbRingQueue_h
+
+#include "EbDefinitions.h"
+#include "EbThreads.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+    /*********************************
+     * Defines
+     *********************************/
+    // Number of polling iterations a consumer performs before it parks
+    // on the queue semaphore.
+#define RING_QUEUE_SPIN_COUNT           2048
+#define RING_QUEUE_CACHE_LINE_SIZE      64
+
+    /*********************************************************************
+     * RingCell
+     *   One slot of the ring. sequence tells producers and consumers
+     *   whether the slot is free for the enqueue position or holds the
+     *   object for the dequeue position.
+     *********************************************************************/
+    typedef struct EbRingCell
+    {
+        volatile int32_t sequence;
+        EbPtr            object_ptr;
+
+    } EbRingCell;
+
+    /*********************************************************************
+     * RingQueue
+     *   Bounded, lock-free, multi-producer multi-consumer ring of object
+     *   pointers. The capacity is rounded up to a power of two. Blocking
+     *   pops spin for spin_count iterations on available_count (none on
+     *   single-processor hosts) and then park on park_semaphore; a push
+     *   only touches the semaphore when a consumer is parked.
+     *
+     *   When single_consumer is set, dequeue_pos is advanced without an
+     *   atomic read-modify-write (SPSC/MPSC case).
+     *********************************************************************/
+    typedef struct EbRingQueue
+    {
+        EbRingCell        *cell_array;
+        uint32_t           buffer_mask;
+        EbBool             single_consumer;
+        uint32_t           spin_count;
+        EbHandle           park_semaphore;
+
+        uint8_t            pad0[RING_QUEUE_CACHE_LINE_SIZE];
+        volatile int32_t   enqueue_pos;
+        uint8_t            pad1[RING_QUEUE_CACHE_LINE_SIZE - sizeof(int32_t)];
+        volatile int32_t   dequeue_pos;
+        uint8_t            pad2[RING_QUEUE_CACHE_LINE_SIZE - sizeof(int32_t)];
+
+        // available_count - number of objects that can be claimed by a
+        //   consumer. A negative value is the number of parked consumers.
+        volatile int32_t   available_count;
+        uint8_t            pad3[RING_QUEUE_CACHE_LINE_SIZE - sizeof(int32_t)];
+
+    } EbRingQueue;
+
+    /*********************************************************************
+     * eb_ring_queue_ctor
+     *   Constructs a RingQueue able to hold at least capacity objects.
+     *********************************************************************/
+    extern EbErrorType eb_ring_queue_ctor(
+        EbRingQueue **queue_dbl_ptr,
+        uint32_t      capacity,
+        EbBool        single_consumer);
+
+    /*********************************************************************
+     * eb_ring_queue_push
+     *   Appends object_ptr to the tail of the queue and wakes one parked
+     *   consumer, if any. The caller guarantees that the queue never
+     *   holds more than capacity objects.
+     *********************************************************************/
+    extern EbErrorType eb_ring_queue_push(
+        EbRingQueue *queue_ptr,
+        EbPtr        object_ptr);
+
+    /*********************************************************************
+     * eb_ring_queue_pop
+     *   Removes the head of the queue, spinning and then blocking until
+     *   an object is available.
+     *********************************************************************/
+    extern EbErrorType eb_ring_queue_pop(
+        EbRingQueue *queue_ptr,
+        EbPtr       *object_dbl_ptr);
+
+    /*********************************************************************
+     * eb_ring_queue_try_pop
+     *   Non-blocking pop. *object_dbl_ptr is set to EB_NULL when the
+     *   queue is empty.
+     *********************************************************************/
+    extern EbErrorType eb_ring_queue_try_pop(
+        EbRingQueue *queue_ptr,
+        EbPtr       *object_dbl_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //EbRingQueue_h
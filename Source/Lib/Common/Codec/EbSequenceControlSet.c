@@ -47,6 +47,7 @@ EbErrorType eb_sequence_control_set_ctor(
     sequence_control_set_ptr->static_config.sb_sz = 64;
     sequence_control_set_ptr->static_config.partition_depth = 4;
     sequence_control_set_ptr->static_config.qp = 32;
+    sequence_control_set_ptr->external_input_buffer_flag = EB_FALSE;
 
     // Segments
     for (segment_index = 0; segment_index < MAX_TEMPORAL_LAYERS; ++segment_index) {
@@ -55,6 +56,7 @@ EbErrorType eb_sequence_control_set_ctor(
         sequence_control_set_ptr->enc_dec_segment_col_count_array[segment_index] = 1;
         sequence_control_set_ptr->enc_dec_segment_row_count_array[segment_index] = 1;
     }
+    sequence_control_set_ptr->pa_segment_row_count = 1;
 
     // Encode Context
     if (scsInitData != EB_NULL) {
@@ -305,6 +307,7 @@ EbErrorType copy_sequence_control_set(
     dst->pa_reference_picture_buffer_init_count = src->pa_reference_picture_buffer_init_count; writeCount += sizeof(int32_t);
     dst->reference_picture_buffer_init_count = src->reference_picture_buffer_init_count; writeCount += sizeof(int32_t);
     dst->input_buffer_fifo_init_count = src->input_buffer_fifo_init_count; writeCount += sizeof(int32_t);
+    dst->external_input_buffer_flag = src->external_input_buffer_flag; writeCount += sizeof(EbBool);
     dst->output_stream_buffer_fifo_init_count = src->output_stream_buffer_fifo_init_count; writeCount += sizeof(int32_t);
     dst->output_recon_buffer_fifo_init_count = src->output_recon_buffer_fifo_init_count; writeCount += sizeof(int32_t);
     dst->resource_coordination_fifo_init_count = src->resource_coordination_fifo_init_count; writeCount += sizeof(int32_t);
@@ -325,6 +328,7 @@ EbErrorType copy_sequence_control_set(
     dst->enc_dec_process_init_count = src->enc_dec_process_init_count; writeCount += sizeof(int32_t);
     dst->entropy_coding_process_init_count = src->entropy_coding_process_init_count; writeCount += sizeof(int32_t);
     dst->total_process_init_count = src->total_process_init_count; writeCount += sizeof(int32_t);
+    dst->thread_pool_worker_count = src->thread_pool_worker_count; writeCount += sizeof(int32_t);
     dst->left_padding = src->left_padding; writeCount += sizeof(int16_t);
     dst->right_padding = src->right_padding; writeCount += sizeof(int16_t);
     dst->top_padding = src->top_padding; writeCount += sizeof(int16_t);
@@ -337,6 +341,7 @@ EbErrorType copy_sequence_control_set(
         dst->enc_dec_segment_row_count_array[i] = src->enc_dec_segment_row_count_array[i];
     }
 
+    dst->pa_segment_row_count = src->pa_segment_row_count;
     dst->cdef_segment_column_count = src->cdef_segment_column_count;
     dst->cdef_segment_row_count = src->cdef_segment_row_count;
 
@@ -403,7 +408,8 @@ extern EbErrorType sb_params_ctor(
 
     EbErrorType return_error = EB_ErrorNone;
 
-    EB_MALLOC(SbParams_t*, sequence_control_set_ptr->sb_params_array, sizeof(SbParams_t) * ((MAX_PICTURE_WIDTH_SIZE + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz) * ((MAX_PICTURE_HEIGHT_SIZE + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz), EB_N_PTR);
+    // Allocated by sb_params_init once the picture size is known
+    sequence_control_set_ptr->sb_params_array = (SbParams_t*)EB_NULL;
     return return_error;
 }
 
@@ -125,6 +125,7 @@ extern "C" {
         uint32_t                                me_segment_row_count_array[MAX_TEMPORAL_LAYERS];
         uint32_t                                enc_dec_segment_col_count_array[MAX_TEMPORAL_LAYERS];
         uint32_t                                enc_dec_segment_row_count_array[MAX_TEMPORAL_LAYERS];
+        uint32_t                                pa_segment_row_count;
         uint32_t                                cdef_segment_column_count;
         uint32_t                                cdef_segment_row_count;
 
@@ -137,6 +138,8 @@ extern "C" {
         uint32_t                                pa_reference_picture_buffer_init_count;
         uint32_t                                reference_picture_buffer_init_count;
         uint32_t                                input_buffer_fifo_init_count;
+        // Input pictures reference the frames of eb_svt_enc_allocate_input_frame
+        EbBool                                  external_input_buffer_flag;
         uint32_t                                output_stream_buffer_fifo_init_count;
         uint32_t                                output_recon_buffer_fifo_init_count;
         uint32_t                                resource_coordination_fifo_init_count;
@@ -164,6 +167,7 @@ extern "C" {
         uint32_t                                cdef_process_init_count;
         uint32_t                                rest_process_init_count;
         uint32_t                                total_process_init_count;
+        uint32_t                                thread_pool_worker_count;
         
         uint16_t                                film_grain_random_seed;
         SbParams_t                             *sb_params_array;
@@ -180,6 +184,7 @@ extern "C" {
         EbPmMode                                pm_mode;
         uint8_t                                 trans_coeff_shape_array[2][8][4];    // [componantTypeIndex][resolutionIndex][levelIndex][tuSizeIndex]
         EbBlockMeanPrec                         block_mean_calc_prec;
+        EbScDetectionMode                       sc_detection_mode;
 
         int32_t                                 num_bits_width;
         int32_t                                 num_bits_height;
@@ -911,6 +911,7 @@ void* source_based_operations_kernel(void *input_ptr)
 
         inputResultsPtr = (InitialRateControlResults_t*)inputResultsWrapperPtr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
+        eb_pipeline_stats_set_picture(picture_control_set_ptr->picture_number);
         sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
 
         picture_control_set_ptr->dark_back_groundlight_fore_ground = EB_FALSE;
@@ -1088,6 +1089,7 @@ void* source_based_operations_kernel(void *input_ptr)
 
         outputResultsPtr = (PictureDemuxResults_t*)outputResultsWrapperPtr->object_ptr;
         outputResultsPtr->picture_control_set_wrapper_ptr = inputResultsPtr->picture_control_set_wrapper_ptr;
+        outputResultsPtr->picture_number = picture_control_set_ptr->picture_number;
         outputResultsPtr->pictureType = EB_PIC_INPUT;
 
         // Release the Input Results
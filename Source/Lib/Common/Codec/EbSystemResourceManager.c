@@ -7,6 +7,10 @@
 
 #include "EbSystemResourceManager.h"
 
+// Per-thread callback used by eb_get_empty_object instead of blocking
+static EB_THREAD_LOCAL EbFifoWaitCallback thread_wait_callback = (EbFifoWaitCallback)EB_NULL;
+static EB_THREAD_LOCAL EbPtr              thread_wait_callback_arg = EB_NULL;
+
 /**************************************
  * EbFifoCtor
  **************************************/
@@ -18,11 +22,19 @@ static EbErrorType EbFifoCtor(
     EbObjectWrapper  *lastWrapperPtr,
     EbMuxingQueue    *queue_ptr)
 {
+#if LOCK_FREE_FIFO
+    // The objects are held by the MuxingQueue ring_queue
+    (void)initial_count;
+    (void)max_count;
+    fifoPtr->counting_semaphore = (EbHandle)EB_NULL;
+    fifoPtr->lockout_mutex = (EbHandle)EB_NULL;
+#else
     // Create Counting Semaphore
     EB_CREATESEMAPHORE(EbHandle, fifoPtr->counting_semaphore, sizeof(EbHandle), EB_SEMAPHORE, initial_count, max_count);
 
     // Create Buffer Pool Mutex
     EB_CREATEMUTEX(EbHandle, fifoPtr->lockout_mutex, sizeof(EbHandle), EB_MUTEX);
+#endif
 
     // Initialize Fifo First & Last ptrs
     fifoPtr->first_ptr = firstWrapperPtr;
@@ -35,6 +47,7 @@ static EbErrorType EbFifoCtor(
 }
 
 
+#if !LOCK_FREE_FIFO
 /**************************************
  * EbFifoPushBack
  **************************************/
@@ -184,6 +197,7 @@ static EbErrorType EbCircularBufferPushFront(
 
     return return_error;
 }
+#endif
 
 /**************************************
  * EbMuxingQueueCtor
@@ -202,10 +216,30 @@ static EbErrorType EbMuxingQueueCtor(
     *queueDblPtr = queue_ptr;
 
     queue_ptr->process_total_count = process_total_count;
+    queue_ptr->post_callback = (EbFifoPostCallback)EB_NULL;
+    queue_ptr->post_callback_arg = EB_NULL;
+    queue_ptr->stats_ptr = (EbPipelineStats*)EB_NULL;
+    queue_ptr->stats_stage_index = ~0u;
+    queue_ptr->resource_ptr = (struct EbSystemResource*)EB_NULL;
 
     // Lockout Mutex
     EB_CREATEMUTEX(EbHandle, queue_ptr->lockout_mutex, sizeof(EbHandle), EB_MUTEX);
 
+#if LOCK_FREE_FIFO
+    queue_ptr->object_queue = (EbCircularBuffer*)EB_NULL;
+    queue_ptr->process_queue = (EbCircularBuffer*)EB_NULL;
+
+    // Construct the Ring Queue shared by all process fifos
+    return_error = eb_ring_queue_ctor(
+        &queue_ptr->ring_queue,
+        object_total_count,
+        (queue_ptr->process_total_count == 1) ? EB_TRUE : EB_FALSE);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+#else
+    queue_ptr->ring_queue = (EbRingQueue*)EB_NULL;
+
     // Construct Object Circular Buffer
     return_error = EbCircularBufferCtor(
         &queue_ptr->object_queue,
@@ -220,6 +254,7 @@ static EbErrorType EbMuxingQueueCtor(
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
+#endif
     // Construct the Process Fifos
     EB_MALLOC(EbFifo**, queue_ptr->process_fifo_ptr_array, sizeof(EbFifo*) * queue_ptr->process_total_count, EB_N_PTR);
 
@@ -242,6 +277,7 @@ static EbErrorType EbMuxingQueueCtor(
     return return_error;
 }
 
+#if !LOCK_FREE_FIFO
 /**************************************
  * EbMuxingQueueAssignation
  **************************************/
@@ -318,6 +354,39 @@ static EbErrorType EbMuxingQueueObjectPushFront(
 
     return return_error;
 }
+#endif
+
+/**************************************
+* EbMuxingQueueObjectTryPop
+*   Takes an object that has not been
+*   assigned to a process fifo yet.
+**************************************/
+static EbErrorType EbMuxingQueueObjectTryPop(
+    EbMuxingQueue    *queue_ptr,
+    EbObjectWrapper **wrapper_dbl_ptr)
+{
+    EbErrorType return_error = EB_ErrorNone;
+
+#if LOCK_FREE_FIFO
+    return_error = eb_ring_queue_try_pop(
+        queue_ptr->ring_queue,
+        (EbPtr*)wrapper_dbl_ptr);
+#else
+    eb_block_on_mutex(queue_ptr->lockout_mutex);
+
+    if (EbCircularBufferEmptyCheck(queue_ptr->object_queue) == EB_FALSE) {
+        EbCircularBufferPopFront(
+            queue_ptr->object_queue,
+            (EbPtr*)wrapper_dbl_ptr);
+    }
+    else
+        *wrapper_dbl_ptr = (EbObjectWrapper*)EB_NULL;
+
+    eb_release_mutex(queue_ptr->lockout_mutex);
+#endif
+
+    return return_error;
+}
 
 /*********************************************************************
  * eb_object_release_enable
@@ -338,11 +407,15 @@ EbErrorType eb_object_release_enable(
 {
     EbErrorType return_error = EB_ErrorNone;
 
+#if LOCK_FREE_FIFO
+    wrapper_ptr->release_enable = EB_TRUE;
+#else
     eb_block_on_mutex(wrapper_ptr->system_resource_ptr->empty_queue->lockout_mutex);
 
     wrapper_ptr->release_enable = EB_TRUE;
 
     eb_release_mutex(wrapper_ptr->system_resource_ptr->empty_queue->lockout_mutex);
+#endif
 
     return return_error;
 }
@@ -366,11 +439,15 @@ EbErrorType eb_object_release_disable(
 {
     EbErrorType return_error = EB_ErrorNone;
 
+#if LOCK_FREE_FIFO
+    wrapper_ptr->release_enable = EB_FALSE;
+#else
     eb_block_on_mutex(wrapper_ptr->system_resource_ptr->empty_queue->lockout_mutex);
 
     wrapper_ptr->release_enable = EB_FALSE;
 
     eb_release_mutex(wrapper_ptr->system_resource_ptr->empty_queue->lockout_mutex);
+#endif
 
     return return_error;
 }
@@ -395,15 +472,88 @@ EbErrorType eb_object_inc_live_count(
 {
     EbErrorType return_error = EB_ErrorNone;
 
+#if LOCK_FREE_FIFO
+    eb_atomic_fetch_add_32((volatile int32_t*)&wrapper_ptr->live_count, (int32_t)increment_number);
+#else
     eb_block_on_mutex(wrapper_ptr->system_resource_ptr->empty_queue->lockout_mutex);
 
     wrapper_ptr->live_count += increment_number;
 
     eb_release_mutex(wrapper_ptr->system_resource_ptr->empty_queue->lockout_mutex);
+#endif
 
     return return_error;
 }
 
+/**************************************
+ * EbObjectWrapperCtor
+ *   Constructs the wrapper and the object
+ *   wrapperIndex of the resource.
+ **************************************/
+static EbErrorType EbObjectWrapperCtor(
+    EbSystemResource *resource_ptr,
+    uint32_t          wrapperIndex)
+{
+    EbErrorType return_error = EB_ErrorNone;
+    uint64_t    memorySize = eb_memory_arena_thread_size();
+
+    EB_MALLOC(EbObjectWrapper*, resource_ptr->wrapper_ptr_pool[wrapperIndex], sizeof(EbObjectWrapper), EB_N_PTR);
+    resource_ptr->wrapper_ptr_pool[wrapperIndex]->object_ptr = EB_NULL;
+    resource_ptr->wrapper_ptr_pool[wrapperIndex]->live_count = 0;
+    resource_ptr->wrapper_ptr_pool[wrapperIndex]->release_enable = EB_TRUE;
+    resource_ptr->wrapper_ptr_pool[wrapperIndex]->system_resource_ptr = resource_ptr;
+    resource_ptr->wrapper_ptr_pool[wrapperIndex]->next_ptr = (EbObjectWrapper*)EB_NULL;
+    resource_ptr->wrapper_ptr_pool[wrapperIndex]->post_time_us = 0;
+
+    // Call the Constructor for the element
+    if (resource_ptr->object_ctor) {
+        return_error = resource_ptr->object_ctor(
+            &resource_ptr->wrapper_ptr_pool[wrapperIndex]->object_ptr,
+            resource_ptr->object_init_data_ptr);
+    }
+
+    resource_ptr->object_memory_size += eb_memory_arena_thread_size() - memorySize;
+
+    return return_error;
+}
+
+/**************************************
+ * EbSystemResourceGrow
+ *   Constructs one more object, from any
+ *   encoder thread. Returns EB_NULL when
+ *   object_total_count was reached or
+ *   the construction failed.
+ **************************************/
+static EbObjectWrapper *EbSystemResourceGrow(
+    EbSystemResource *resource_ptr)
+{
+    EbObjectWrapper  *wrapper_ptr = (EbObjectWrapper*)EB_NULL;
+    EbMemoryArena    *savedArenaPtr;
+    uint32_t          wrapperIndex;
+
+    eb_block_on_mutex(resource_ptr->grow_mutex);
+
+    wrapperIndex = (uint32_t)resource_ptr->object_created_count;
+    if (wrapperIndex < resource_ptr->object_total_count && resource_ptr->grow_failed == EB_FALSE) {
+
+        savedArenaPtr = eb_memory_arena_set_current(resource_ptr->memory_arena);
+
+        if (EbObjectWrapperCtor(resource_ptr, wrapperIndex) == EB_ErrorNone) {
+            wrapper_ptr = resource_ptr->wrapper_ptr_pool[wrapperIndex];
+            eb_atomic_store_32(&resource_ptr->object_created_count, (int32_t)(wrapperIndex + 1));
+        }
+        else
+            // Run with the objects constructed so far
+            resource_ptr->grow_failed = EB_TRUE;
+
+        eb_memory_arena_set_current(savedArenaPtr);
+    }
+
+    eb_release_mutex(resource_ptr->grow_mutex);
+
+    return wrapper_ptr;
+}
+
 /*********************************************************************
  * eb_system_resource_ctor
  *   Constructor for EbSystemResource.  Fully constructs all members
@@ -442,6 +592,38 @@ EbErrorType eb_system_resource_ctor(
     EbBool              full_fifo_enabled,
     EB_CTOR              object_ctor,
     EbPtr               object_init_data_ptr)
+{
+    return eb_system_resource_lazy_ctor(
+        resource_dbl_ptr,
+        object_total_count,
+        object_total_count,
+        producer_process_total_count,
+        consumer_process_total_count,
+        producer_fifo_ptr_array_ptr,
+        consumer_fifo_ptr_array_ptr,
+        full_fifo_enabled,
+        object_ctor,
+        object_init_data_ptr,
+        0);
+}
+
+/*********************************************************************
+ * eb_system_resource_lazy_ctor
+ *   Same as eb_system_resource_ctor, objects past object_initial_count
+ *   are constructed on demand by eb_get_empty_object.
+ *********************************************************************/
+EbErrorType eb_system_resource_lazy_ctor(
+    EbSystemResource **resource_dbl_ptr,
+    uint32_t               object_initial_count,
+    uint32_t               object_total_count,
+    uint32_t               producer_process_total_count,
+    uint32_t               consumer_process_total_count,
+    EbFifo          ***producer_fifo_ptr_array_ptr,
+    EbFifo          ***consumer_fifo_ptr_array_ptr,
+    EbBool              full_fifo_enabled,
+    EB_CTOR              object_ctor,
+    EbPtr               object_init_data_ptr,
+    uint32_t            object_init_data_size)
 {
     uint32_t wrapperIndex;
     EbErrorType return_error = EB_ErrorNone;
@@ -452,27 +634,43 @@ EbErrorType eb_system_resource_ctor(
     *resource_dbl_ptr = resource_ptr;
 
     resource_ptr->object_total_count = object_total_count;
+    resource_ptr->release_callback = (EbObjectReleaseCallback)EB_NULL;
+    resource_ptr->object_created_count = 0;
+    resource_ptr->object_ctor = object_ctor;
+    resource_ptr->object_init_data_ptr = object_init_data_ptr;
+    resource_ptr->grow_mutex = (EbHandle)EB_NULL;
+    resource_ptr->grow_failed = EB_FALSE;
+    resource_ptr->object_memory_size = 0;
+    resource_ptr->memory_arena = eb_memory_arena_get_current();
+
+    if (object_initial_count > object_total_count)
+        object_initial_count = object_total_count;
+
+    if (object_initial_count < object_total_count) {
+        // The caller's init data does not outlive the init
+        if (object_init_data_ptr && object_init_data_size) {
+            EB_MALLOC(EbPtr, resource_ptr->object_init_data_ptr, object_init_data_size, EB_N_PTR);
+            EB_MEMCPY(resource_ptr->object_init_data_ptr, object_init_data_ptr, object_init_data_size);
+        }
+        EB_CREATEMUTEX(EbHandle, resource_ptr->grow_mutex, sizeof(EbHandle), EB_MUTEX);
+    }
 
     // Allocate array for wrapper pointers
     EB_MALLOC(EbObjectWrapper**, resource_ptr->wrapper_ptr_pool, sizeof(EbObjectWrapper*) * resource_ptr->object_total_count, EB_N_PTR);
 
     // Initialize each wrapper
-    for (wrapperIndex = 0; wrapperIndex < resource_ptr->object_total_count; ++wrapperIndex) {
-        EB_MALLOC(EbObjectWrapper*, resource_ptr->wrapper_ptr_pool[wrapperIndex], sizeof(EbObjectWrapper), EB_N_PTR);
-        resource_ptr->wrapper_ptr_pool[wrapperIndex]->live_count = 0;
-        resource_ptr->wrapper_ptr_pool[wrapperIndex]->release_enable = EB_TRUE;
-        resource_ptr->wrapper_ptr_pool[wrapperIndex]->system_resource_ptr = resource_ptr;
-
-        // Call the Constructor for each element
-        if (object_ctor) {
-            return_error = object_ctor(
-                &resource_ptr->wrapper_ptr_pool[wrapperIndex]->object_ptr,
-                object_init_data_ptr);
-            if (return_error == EB_ErrorInsufficientResources) {
-                return EB_ErrorInsufficientResources;
-            }
+    for (wrapperIndex = 0; wrapperIndex < resource_ptr->object_total_count; ++wrapperIndex)
+        resource_ptr->wrapper_ptr_pool[wrapperIndex] = (EbObjectWrapper*)EB_NULL;
+
+    for (wrapperIndex = 0; wrapperIndex < object_initial_count; ++wrapperIndex) {
+        return_error = EbObjectWrapperCtor(
+            resource_ptr,
+            wrapperIndex);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
         }
     }
+    resource_ptr->object_created_count = (int32_t)object_initial_count;
 
     // Initialize the Empty Queue
     return_error = EbMuxingQueueCtor(
@@ -483,11 +681,19 @@ EbErrorType eb_system_resource_ctor(
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
-    // Fill the Empty Fifo with every ObjectWrapper
-    for (wrapperIndex = 0; wrapperIndex < resource_ptr->object_total_count; ++wrapperIndex) {
+    resource_ptr->empty_queue->resource_ptr = resource_ptr;
+
+    // Fill the Empty Fifo with every constructed ObjectWrapper
+    for (wrapperIndex = 0; wrapperIndex < object_initial_count; ++wrapperIndex) {
+#if LOCK_FREE_FIFO
+        eb_ring_queue_push(
+            resource_ptr->empty_queue->ring_queue,
+            resource_ptr->wrapper_ptr_pool[wrapperIndex]);
+#else
         EbMuxingQueueObjectPushBack(
             resource_ptr->empty_queue,
             resource_ptr->wrapper_ptr_pool[wrapperIndex]);
+#endif
     }
 
     // Initialize the Full Queue
@@ -500,6 +706,7 @@ EbErrorType eb_system_resource_ctor(
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
+        resource_ptr->full_queue->resource_ptr = resource_ptr;
     }
     else {
         resource_ptr->full_queue = (EbMuxingQueue *)EB_NULL;
@@ -511,6 +718,7 @@ EbErrorType eb_system_resource_ctor(
 
 
 
+#if !LOCK_FREE_FIFO
 /*********************************************************************
  * EbSystemResourceReleaseProcess
  *********************************************************************/
@@ -531,6 +739,7 @@ static EbErrorType EbReleaseProcess(
 
     return return_error;
 }
+#endif
 
 /*********************************************************************
  * EbSystemResourcePostObject
@@ -551,6 +760,17 @@ EbErrorType eb_post_full_object(
 {
     EbErrorType return_error = EB_ErrorNone;
 
+    // Counted before the object can be taken
+    if (object_ptr->system_resource_ptr->full_queue->stats_ptr)
+        object_ptr->post_time_us = eb_pipeline_stats_on_post(
+            object_ptr->system_resource_ptr->full_queue->stats_ptr,
+            object_ptr->system_resource_ptr->full_queue->stats_stage_index);
+
+#if LOCK_FREE_FIFO
+    return_error = eb_ring_queue_push(
+        object_ptr->system_resource_ptr->full_queue->ring_queue,
+        object_ptr);
+#else
     eb_block_on_mutex(object_ptr->system_resource_ptr->full_queue->lockout_mutex);
 
     EbMuxingQueueObjectPushBack(
@@ -558,6 +778,11 @@ EbErrorType eb_post_full_object(
         object_ptr);
 
     eb_release_mutex(object_ptr->system_resource_ptr->full_queue->lockout_mutex);
+#endif
+
+    if (object_ptr->system_resource_ptr->full_queue->post_callback)
+        object_ptr->system_resource_ptr->full_queue->post_callback(
+            object_ptr->system_resource_ptr->full_queue->post_callback_arg);
 
     return return_error;
 }
@@ -577,6 +802,29 @@ EbErrorType eb_release_object(
 {
     EbErrorType return_error = EB_ErrorNone;
 
+#if LOCK_FREE_FIFO
+    volatile int32_t *live_count_ptr = (volatile int32_t*)&object_ptr->live_count;
+    uint32_t          old_count;
+    uint32_t          new_count;
+
+    // Decrement live_count and claim the release in one step, so that
+    // only one releasing thread queues the object
+    do {
+        old_count = (uint32_t)eb_atomic_load_32(live_count_ptr);
+        new_count = (old_count == 0) ? old_count : old_count - 1;
+        if ((object_ptr->release_enable == EB_TRUE) && (new_count == 0))
+            new_count = EB_ObjectWrapperReleasedValue;
+    } while (!eb_atomic_cas_32(live_count_ptr, (int32_t)old_count, (int32_t)new_count));
+
+    if (new_count == EB_ObjectWrapperReleasedValue) {
+        if (object_ptr->system_resource_ptr->release_callback)
+            object_ptr->system_resource_ptr->release_callback(object_ptr);
+
+        return_error = eb_ring_queue_push(
+            object_ptr->system_resource_ptr->empty_queue->ring_queue,
+            object_ptr);
+    }
+#else
     eb_block_on_mutex(object_ptr->system_resource_ptr->empty_queue->lockout_mutex);
 
     // Decrement live_count
@@ -587,6 +835,9 @@ EbErrorType eb_release_object(
         // Set live_count to EB_ObjectWrapperReleasedValue
         object_ptr->live_count = EB_ObjectWrapperReleasedValue;
 
+        if (object_ptr->system_resource_ptr->release_callback)
+            object_ptr->system_resource_ptr->release_callback(object_ptr);
+
         EbMuxingQueueObjectPushFront(
             object_ptr->system_resource_ptr->empty_queue,
             object_ptr);
@@ -594,6 +845,7 @@ EbErrorType eb_release_object(
     }
 
     eb_release_mutex(object_ptr->system_resource_ptr->empty_queue->lockout_mutex);
+#endif
 
     return return_error;
 }
@@ -617,8 +869,59 @@ EbErrorType eb_get_empty_object(
     EbFifo   *empty_fifo_ptr,
     EbObjectWrapper **wrapper_dbl_ptr)
 {
-    EbErrorType return_error = EB_ErrorNone;
+    EbErrorType       return_error = EB_ErrorNone;
+    uint32_t          statsState = PIPELINE_THREAD_BUSY;
+    EbSystemResource *resource_ptr = empty_fifo_ptr->queue_ptr->resource_ptr;
+
+    // Construct an object instead of waiting for one while the resource
+    // has not reached object_total_count
+    if ((uint32_t)resource_ptr->object_created_count < resource_ptr->object_total_count) {
+        EbMuxingQueueObjectTryPop(
+            empty_fifo_ptr->queue_ptr,
+            wrapper_dbl_ptr);
+        if (*wrapper_dbl_ptr == (EbObjectWrapper*)EB_NULL)
+            *wrapper_dbl_ptr = EbSystemResourceGrow(resource_ptr);
+        if (*wrapper_dbl_ptr != (EbObjectWrapper*)EB_NULL) {
+            (*wrapper_dbl_ptr)->live_count = 0;
+            (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+            return return_error;
+        }
+    }
+
+    if (empty_fifo_ptr->queue_ptr->stats_ptr)
+        statsState = eb_pipeline_stats_on_wait(PIPELINE_THREAD_BLOCKED);
+
+    // Run the thread's wait callback until an unassigned empty object shows up
+    if (thread_wait_callback) {
+        for (;;) {
+            EbMuxingQueueObjectTryPop(
+                empty_fifo_ptr->queue_ptr,
+                wrapper_dbl_ptr);
+            if (*wrapper_dbl_ptr != (EbObjectWrapper*)EB_NULL)
+                break;
+            thread_wait_callback(thread_wait_callback_arg);
+        }
+
+        (*wrapper_dbl_ptr)->live_count = 0;
+        (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+
+        if (empty_fifo_ptr->queue_ptr->stats_ptr)
+            eb_pipeline_stats_on_resume(statsState);
+
+        return return_error;
+    }
+
+#if LOCK_FREE_FIFO
+    return_error = eb_ring_queue_pop(
+        empty_fifo_ptr->queue_ptr->ring_queue,
+        (EbPtr*)wrapper_dbl_ptr);
+
+    // Reset the wrapper's live_count
+    (*wrapper_dbl_ptr)->live_count = 0;
 
+    // Object release enable
+    (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+#else
     // Queue the Fifo requesting the empty fifo
     EbReleaseProcess(empty_fifo_ptr);
 
@@ -641,6 +944,71 @@ EbErrorType eb_get_empty_object(
 
     // Release Mutex
     eb_release_mutex(empty_fifo_ptr->lockout_mutex);
+#endif
+
+    if (empty_fifo_ptr->queue_ptr->stats_ptr)
+        eb_pipeline_stats_on_resume(statsState);
+
+    return return_error;
+}
+
+/*********************************************************************
+ * eb_try_get_empty_object
+ *********************************************************************/
+EbErrorType eb_try_get_empty_object(
+    EbFifo   *empty_fifo_ptr,
+    EbObjectWrapper **wrapper_dbl_ptr)
+{
+    EbErrorType       return_error = EB_ErrorNone;
+    EbSystemResource *resource_ptr = empty_fifo_ptr->queue_ptr->resource_ptr;
+
+    EbMuxingQueueObjectTryPop(
+        empty_fifo_ptr->queue_ptr,
+        wrapper_dbl_ptr);
+    if (*wrapper_dbl_ptr == (EbObjectWrapper*)EB_NULL &&
+        (uint32_t)resource_ptr->object_created_count < resource_ptr->object_total_count)
+        *wrapper_dbl_ptr = EbSystemResourceGrow(resource_ptr);
+
+    if (*wrapper_dbl_ptr != (EbObjectWrapper*)EB_NULL) {
+        (*wrapper_dbl_ptr)->live_count = 0;
+        (*wrapper_dbl_ptr)->release_enable = EB_TRUE;
+    }
+
+    return return_error;
+}
+
+/**************************************
+ * EbGetFullObject
+ *   eb_get_full_object without the
+ *   pipeline stats hooks.
+ **************************************/
+static EbErrorType EbGetFullObject(
+    EbFifo   *full_fifo_ptr,
+    EbObjectWrapper **wrapper_dbl_ptr)
+{
+    EbErrorType return_error = EB_ErrorNone;
+
+#if LOCK_FREE_FIFO
+    return_error = eb_ring_queue_pop(
+        full_fifo_ptr->queue_ptr->ring_queue,
+        (EbPtr*)wrapper_dbl_ptr);
+#else
+    // Queue the Fifo requesting the full fifo
+    EbReleaseProcess(full_fifo_ptr);
+
+    // Block on the counting Semaphore until an empty buffer is available
+    eb_block_on_semaphore(full_fifo_ptr->counting_semaphore);
+
+    // Acquire lockout Mutex
+    eb_block_on_mutex(full_fifo_ptr->lockout_mutex);
+
+    EbFifoPopFront(
+        full_fifo_ptr,
+        wrapper_dbl_ptr);
+
+    // Release Mutex
+    eb_release_mutex(full_fifo_ptr->lockout_mutex);
+#endif
 
     return return_error;
 }
@@ -664,27 +1032,24 @@ EbErrorType eb_get_full_object(
     EbFifo   *full_fifo_ptr,
     EbObjectWrapper **wrapper_dbl_ptr)
 {
-    EbErrorType return_error = EB_ErrorNone;
+    EbErrorType return_error;
 
-    // Queue the Fifo requesting the full fifo
-    EbReleaseProcess(full_fifo_ptr);
+    if (full_fifo_ptr->queue_ptr->stats_ptr == (EbPipelineStats*)EB_NULL)
+        return EbGetFullObject(full_fifo_ptr, wrapper_dbl_ptr);
 
-    // Block on the counting Semaphore until an empty buffer is available
-    eb_block_on_semaphore(full_fifo_ptr->counting_semaphore);
-
-    // Acquire lockout Mutex
-    eb_block_on_mutex(full_fifo_ptr->lockout_mutex);
+    eb_pipeline_stats_on_wait(PIPELINE_THREAD_IDLE);
 
-    EbFifoPopFront(
-        full_fifo_ptr,
-        wrapper_dbl_ptr);
+    return_error = EbGetFullObject(full_fifo_ptr, wrapper_dbl_ptr);
 
-    // Release Mutex
-    eb_release_mutex(full_fifo_ptr->lockout_mutex);
+    eb_pipeline_stats_on_get(
+        full_fifo_ptr->queue_ptr->stats_ptr,
+        full_fifo_ptr->queue_ptr->stats_stage_index,
+        (*wrapper_dbl_ptr)->post_time_us);
 
     return return_error;
 }
 
+#if !LOCK_FREE_FIFO
 /**************************************
 * EbFifoPopFront
 **************************************/
@@ -700,13 +1065,18 @@ static EbBool EbFifoPeakFront(
         return EB_FALSE;
     }
 }
-
+#endif
 
 EbErrorType eb_get_full_object_non_blocking(
     EbFifo   *full_fifo_ptr,
     EbObjectWrapper **wrapper_dbl_ptr)
 {
     EbErrorType return_error = EB_ErrorNone;
+#if LOCK_FREE_FIFO
+    return_error = eb_ring_queue_try_pop(
+        full_fifo_ptr->queue_ptr->ring_queue,
+        (EbPtr*)wrapper_dbl_ptr);
+#else
     EbBool      fifoEmpty;
     // Queue the Fifo requesting the full fifo
     EbReleaseProcess(full_fifo_ptr);
@@ -721,11 +1091,87 @@ EbErrorType eb_get_full_object_non_blocking(
     eb_release_mutex(full_fifo_ptr->lockout_mutex);
 
     if (fifoEmpty == EB_FALSE)
-        eb_get_full_object(
+        EbGetFullObject(
             full_fifo_ptr,
             wrapper_dbl_ptr);
     else
         *wrapper_dbl_ptr = (EbObjectWrapper*)EB_NULL;
+#endif
+
+    if (full_fifo_ptr->queue_ptr->stats_ptr && *wrapper_dbl_ptr)
+        eb_pipeline_stats_on_get(
+            full_fifo_ptr->queue_ptr->stats_ptr,
+            full_fifo_ptr->queue_ptr->stats_stage_index,
+            (*wrapper_dbl_ptr)->post_time_us);
 
     return return_error;
-}
\ No newline at end of file
+}
+
+/*********************************************************************
+ * eb_try_get_full_object
+ *********************************************************************/
+EbErrorType eb_try_get_full_object(
+    EbFifo   *full_fifo_ptr,
+    EbObjectWrapper **wrapper_dbl_ptr)
+{
+    EbErrorType return_error = EbMuxingQueueObjectTryPop(
+        full_fifo_ptr->queue_ptr,
+        wrapper_dbl_ptr);
+
+    if (full_fifo_ptr->queue_ptr->stats_ptr && *wrapper_dbl_ptr)
+        eb_pipeline_stats_on_get(
+            full_fifo_ptr->queue_ptr->stats_ptr,
+            full_fifo_ptr->queue_ptr->stats_stage_index,
+            (*wrapper_dbl_ptr)->post_time_us);
+
+    return return_error;
+}
+
+/*********************************************************************
+ * eb_fifo_set_post_callback
+ *********************************************************************/
+void eb_fifo_set_post_callback(
+    EbFifo             *fifo_ptr,
+    EbFifoPostCallback  post_callback,
+    EbPtr               post_callback_arg)
+{
+    fifo_ptr->queue_ptr->post_callback_arg = post_callback_arg;
+    fifo_ptr->queue_ptr->post_callback = post_callback;
+}
+
+/*********************************************************************
+ * eb_system_resource_set_release_callback
+ *********************************************************************/
+void eb_system_resource_set_release_callback(
+    EbSystemResource        *resource_ptr,
+    EbObjectReleaseCallback  release_callback)
+{
+    resource_ptr->release_callback = release_callback;
+}
+
+/*********************************************************************
+ * eb_system_resource_set_stats
+ *********************************************************************/
+void eb_system_resource_set_stats(
+    EbSystemResource        *resource_ptr,
+    EbPipelineStats         *stats_ptr,
+    uint32_t                 stage_index)
+{
+    resource_ptr->empty_queue->stats_ptr = stats_ptr;
+
+    if (resource_ptr->full_queue && stage_index < stats_ptr->stage_count) {
+        resource_ptr->full_queue->stats_stage_index = stage_index;
+        resource_ptr->full_queue->stats_ptr = stats_ptr;
+    }
+}
+
+/*********************************************************************
+ * eb_set_thread_wait_callback
+ *********************************************************************/
+void eb_set_thread_wait_callback(
+    EbFifoWaitCallback  wait_callback,
+    EbPtr               wait_callback_arg)
+{
+    thread_wait_callback_arg = wait_callback_arg;
+    thread_wait_callback = wait_callback;
+}
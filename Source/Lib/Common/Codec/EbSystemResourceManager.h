@@ -8,6 +8,9 @@
 
 #include "EbDefinitions.h"
 #include "EbThreads.h"
+#include "EbRingQueue.h"
+#include "EbPipelineStats.h"
+#include "EbMemoryArena.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -16,6 +19,21 @@ extern "C" {
      *********************************/
 #define EB_ObjectWrapperReleasedValue   ~0u
 
+    /*********************************************************************
+     * Fifo Callbacks
+     *   EbFifoPostCallback is called after an object has been posted to
+     *   a MuxingQueue. EbFifoWaitCallback is called by a thread, instead
+     *   of blocking, while it waits for an empty object; it returns
+     *   EB_FALSE when it had nothing to do. EbObjectReleaseCallback is
+     *   called when the last live reference to an object is released,
+     *   before the object goes back to the empty queue.
+     *********************************************************************/
+    struct EbObjectWrapper;
+
+    typedef void(*EbFifoPostCallback)(EbPtr callback_arg);
+    typedef EbBool(*EbFifoWaitCallback)(EbPtr callback_arg);
+    typedef void(*EbObjectReleaseCallback)(struct EbObjectWrapper *wrapper_ptr);
+
      /*********************************************************************
       * Object Wrapper
       *   Provides state information for each type of object in the
@@ -45,6 +63,10 @@ extern "C" {
         //   only in the implemenation of a single-linked Fifo.
         struct EbObjectWrapper *next_ptr;
 
+        // post_time_us - time of the last post to an instrumented
+        //   full fifo, see eb_system_resource_set_stats.
+        uint64_t                post_time_us;
+
     } EbObjectWrapper;
 
     /*********************************************************************
@@ -93,6 +115,17 @@ extern "C" {
 
     /*********************************************************************
      * MuxingQueue
+     *   With LOCK_FREE_FIFO, the object and process circular buffers are
+     *   replaced by a single ring_queue shared by every process fifo of
+     *   the MuxingQueue; the fifos then only identify the MuxingQueue.
+     *
+     *   post_callback, when set, is called with post_callback_arg each
+     *   time an object is posted (see eb_fifo_set_post_callback).
+     *
+     *   stats_ptr, when set, instruments the queue for the pipeline
+     *   stage stats_stage_index (see eb_system_resource_set_stats).
+     *
+     *   resource_ptr is the SystemResource the MuxingQueue belongs to.
      *********************************************************************/
     typedef struct EbMuxingQueue 
     {
@@ -101,6 +134,12 @@ extern "C" {
         EbCircularBuffer *process_queue;
         uint32_t              process_total_count;
         EbFifo          **process_fifo_ptr_array;
+        EbRingQueue       *ring_queue;
+        EbFifoPostCallback post_callback;
+        EbPtr              post_callback_arg;
+        EbPipelineStats   *stats_ptr;
+        uint32_t           stats_stage_index;
+        struct EbSystemResource *resource_ptr;
 
     } EbMuxingQueue;
 
@@ -129,6 +168,33 @@ extern "C" {
         // The full FIFO contains a queue of completed buffers
         EbMuxingQueue     *full_queue;
 
+        // release_callback - called on the objects going back to the empty
+        //   FIFO, see eb_system_resource_set_release_callback.
+        EbObjectReleaseCallback release_callback;
+
+        // object_created_count - A count of the objects constructed so far.
+        //   Objects past object_created_count are constructed on demand,
+        //   see eb_system_resource_lazy_ctor.
+        volatile int32_t        object_created_count;
+
+        // object_ctor, object_init_data_ptr - used to construct the objects
+        //   on demand. object_init_data_ptr is a copy owned by the resource.
+        EB_CTOR                 object_ctor;
+        EbPtr                   object_init_data_ptr;
+
+        // grow_mutex - serializes the on demand constructions. grow_failed
+        //   is set when one of them ran out of memory.
+        EbHandle                grow_mutex;
+        EbBool                  grow_failed;
+
+        // object_memory_size - library memory committed by the objects
+        //   constructed so far, wrappers included.
+        uint64_t                object_memory_size;
+
+        // Memory arena of the encoder instance that owns the resource, used
+        //   by the constructions made from the encoder threads.
+        EbMemoryArena          *memory_arena;
+
     } EbSystemResource;
 
     /*********************************************************************
@@ -224,6 +290,35 @@ extern "C" {
         EB_CTOR             object_ctor,
         EbPtr               object_init_data_ptr);
 
+    /*********************************************************************
+     * eb_system_resource_lazy_ctor
+     *   Same as eb_system_resource_ctor, but only object_initial_count
+     *   objects are constructed up front. The other objects, up to
+     *   object_total_count, are constructed by eb_get_empty_object when
+     *   no empty object is available, so the resource behaves as if all
+     *   of them had been constructed at init.
+     *
+     *   object_init_data_size
+     *     Size of the data block pointed by object_init_data_ptr, which is
+     *     copied since the constructor may run after the caller returned.
+     *     The data block must not point to memory owned by the caller.
+     *
+     *   The on demand constructions allocate from the memory arena that
+     *   was current when the resource was constructed.
+     *********************************************************************/
+    extern EbErrorType eb_system_resource_lazy_ctor(
+        EbSystemResource **resource_dbl_ptr,
+        uint32_t            object_initial_count,
+        uint32_t            object_total_count,
+        uint32_t            producer_process_total_count,
+        uint32_t            consumer_process_total_count,
+        EbFifo         ***producer_fifo_ptr_array_ptr,
+        EbFifo         ***consumer_fifo_ptr_array_ptr,
+        EbBool              full_fifo_enabled,
+        EB_CTOR             object_ctor,
+        EbPtr               object_init_data_ptr,
+        uint32_t            object_init_data_size);
+
     /*********************************************************************
      * eb_system_resource_dtor
      *   Destructor for EbSystemResource.  Fully destructs all members
@@ -262,6 +357,25 @@ extern "C" {
         EbFifo           *empty_fifo_ptr,
         EbObjectWrapper **wrapper_dbl_ptr);
 
+    /*********************************************************************
+     * eb_try_get_empty_object
+     *   Takes an empty EbObjectWrapper that is not assigned to a waiting
+     *   process, or constructs one while the resource can grow, without
+     *   blocking. *wrapper_dbl_ptr is set to EB_NULL when none is
+     *   available. Used by the stages that post optional work to their
+     *   own input, which must not wait on their own consumers.
+     *
+     *   empty_fifo_ptr
+     *      pointer to one of the producer fifos of the resource.
+     *
+     *   wrapper_dbl_ptr
+     *      Double pointer used to pass the pointer to the empty
+     *      EbObjectWrapper pointer.
+     *********************************************************************/
+    extern EbErrorType eb_try_get_empty_object(
+        EbFifo           *empty_fifo_ptr,
+        EbObjectWrapper **wrapper_dbl_ptr);
+
     /*********************************************************************
      * EbSystemResourcePostObject
      *   Queues a full EbObjectWrapper to the SystemResource. This
@@ -302,6 +416,70 @@ extern "C" {
         EbFifo           *full_fifo_ptr,
         EbObjectWrapper **wrapper_dbl_ptr);
 
+    /*********************************************************************
+     * eb_try_get_full_object
+     *   Dequeues the oldest full EbObjectWrapper of the MuxingQueue that
+     *   full_fifo_ptr belongs to, without registering full_fifo_ptr as a
+     *   waiting process. *wrapper_dbl_ptr is set to EB_NULL when no
+     *   object is queued. Only meant for MuxingQueues whose consumers
+     *   never call eb_get_full_object (i.e. task scheduled stages).
+     *
+     *   full_fifo_ptr
+     *      pointer to one of the consumer fifos of the MuxingQueue.
+     *
+     *   wrapper_dbl_ptr
+     *      Double pointer used to pass the pointer to the full
+     *      EbObjectWrapper pointer.
+     *********************************************************************/
+    extern EbErrorType eb_try_get_full_object(
+        EbFifo           *full_fifo_ptr,
+        EbObjectWrapper **wrapper_dbl_ptr);
+
+    /*********************************************************************
+     * eb_fifo_set_post_callback
+     *   Sets the callback called after each eb_post_full_object to the
+     *   MuxingQueue that fifo_ptr belongs to. The callback runs on the
+     *   posting thread, outside of the MuxingQueue lockout_mutex.
+     *********************************************************************/
+    extern void eb_fifo_set_post_callback(
+        EbFifo             *fifo_ptr,
+        EbFifoPostCallback  post_callback,
+        EbPtr               post_callback_arg);
+
+    /*********************************************************************
+     * eb_system_resource_set_release_callback
+     *   Sets the callback called, on the releasing thread, each time an
+     *   object of the SystemResource is released by its last consumer.
+     *   The object is not in the empty queue yet when the callback runs.
+     *********************************************************************/
+    extern void eb_system_resource_set_release_callback(
+        EbSystemResource        *resource_ptr,
+        EbObjectReleaseCallback  release_callback);
+
+    /*********************************************************************
+     * eb_system_resource_set_stats
+     *   Instruments the SystemResource: the full fifo as the input fifo
+     *   of the pipeline stage stage_index, and the empty fifo, whose
+     *   waits count as blocked time. With stage_index ~0u only the empty
+     *   fifo is instrumented (i.e. pools of pictures and references).
+     *   Called before any object is posted.
+     *********************************************************************/
+    extern void eb_system_resource_set_stats(
+        EbSystemResource        *resource_ptr,
+        EbPipelineStats         *stats_ptr,
+        uint32_t                 stage_index);
+
+    /*********************************************************************
+     * eb_set_thread_wait_callback
+     *   Sets, for the calling thread only, the callback that
+     *   eb_get_empty_object runs in a loop instead of blocking while no
+     *   empty object is available. A NULL wait_callback restores the
+     *   blocking behaviour.
+     *********************************************************************/
+    extern void eb_set_thread_wait_callback(
+        EbFifoWaitCallback  wait_callback,
+        EbPtr               wait_callback_arg);
+
     /*********************************************************************
      * EbSystemResourceReleaseObject
      *   Queues an empty EbObjectWrapper to the SystemResource. This
@@ -0,0 +1,539 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#include "EbTaskScheduler.h"
+#include "EbUtility.h"
+
+// Pool worker running on the calling thread, if any
+static EB_THREAD_LOCAL EbSchedulerWorker *current_worker = (EbSchedulerWorker*)EB_NULL;
+
+/**************************************
+ * TaskSchedulerIdle
+ *   Gives the processor away for a short
+ *   while. Also a thread cancellation
+ *   point for eb_destroy_thread.
+ **************************************/
+static void TaskSchedulerIdle(void)
+{
+#ifdef _WIN32
+    Sleep(0);
+#else
+    struct timespec delay = { 0, 50000 };
+    nanosleep(&delay, NULL);
+#endif
+}
+
+/**************************************
+ * Deque
+ **************************************/
+static void DequeLock(
+    EbSchedulerWorker *worker_ptr)
+{
+    while (!eb_atomic_cas_32(&worker_ptr->deque_lock, 0, 1))
+        eb_cpu_pause();
+}
+
+static void DequeUnlock(
+    EbSchedulerWorker *worker_ptr)
+{
+    eb_atomic_store_32(&worker_ptr->deque_lock, 0);
+}
+
+static EbBool DequePushBottom(
+    EbSchedulerWorker *worker_ptr,
+    EbPtr              task_ptr)
+{
+    EbBool pushed = EB_FALSE;
+
+    DequeLock(worker_ptr);
+    if (worker_ptr->deque_bottom - worker_ptr->deque_top < TASK_SCHEDULER_DEQUE_SIZE) {
+        worker_ptr->deque_array[worker_ptr->deque_bottom++ & (TASK_SCHEDULER_DEQUE_SIZE - 1)] = task_ptr;
+        pushed = EB_TRUE;
+    }
+    DequeUnlock(worker_ptr);
+
+    return pushed;
+}
+
+static EbPtr DequePopBottom(
+    EbSchedulerWorker *worker_ptr)
+{
+    EbPtr task_ptr = EB_NULL;
+
+    DequeLock(worker_ptr);
+    if (worker_ptr->deque_bottom != worker_ptr->deque_top)
+        task_ptr = worker_ptr->deque_array[--worker_ptr->deque_bottom & (TASK_SCHEDULER_DEQUE_SIZE - 1)];
+    DequeUnlock(worker_ptr);
+
+    return task_ptr;
+}
+
+static EbPtr DequeStealTop(
+    EbSchedulerWorker *worker_ptr)
+{
+    EbPtr task_ptr = EB_NULL;
+
+    DequeLock(worker_ptr);
+    if (worker_ptr->deque_bottom != worker_ptr->deque_top)
+        task_ptr = worker_ptr->deque_array[worker_ptr->deque_top++ & (TASK_SCHEDULER_DEQUE_SIZE - 1)];
+    DequeUnlock(worker_ptr);
+
+    return task_ptr;
+}
+
+/**************************************
+ * TaskSchedulerPublish
+ *   Called after a task was pushed. Claims
+ *   the workers registered in
+ *   TaskSchedulerFindTask and posts the
+ *   semaphore once for each of them.
+ **************************************/
+static void TaskSchedulerPublish(
+    EbTaskScheduler   *scheduler_ptr)
+{
+    int32_t finderCount;
+
+    eb_atomic_fetch_add_32(&scheduler_ptr->publish_sequence, 1);
+
+    do {
+        finderCount = eb_atomic_load_32(&scheduler_ptr->finder_count);
+    } while (finderCount > 0 &&
+        !eb_atomic_cas_32(&scheduler_ptr->finder_count, finderCount, 0));
+
+    while (finderCount-- > 0)
+        eb_post_semaphore(scheduler_ptr->publish_semaphore);
+}
+
+/**************************************
+ * TaskSchedulerRetractFinder
+ *   Takes back the registration of a
+ *   worker that saw a publish before it
+ *   blocked. Returns EB_FALSE when a
+ *   publisher already claimed it, the
+ *   worker then owes one wait.
+ **************************************/
+static EbBool TaskSchedulerRetractFinder(
+    EbTaskScheduler   *scheduler_ptr)
+{
+    int32_t finderCount;
+
+    do {
+        finderCount = eb_atomic_load_32(&scheduler_ptr->finder_count);
+        if (finderCount == 0)
+            return EB_FALSE;
+    } while (!eb_atomic_cas_32(&scheduler_ptr->finder_count, finderCount, finderCount - 1));
+
+    return EB_TRUE;
+}
+
+/**************************************
+ * TaskSchedulerSubmit
+ *   Queues one task of stage_ptr, on the
+ *   deque of the calling worker when
+ *   there is one.
+ **************************************/
+static void TaskSchedulerSubmit(
+    EbTaskScheduler   *scheduler_ptr,
+    EbSchedulerStage  *stage_ptr)
+{
+    EbSchedulerWorker *worker_ptr = current_worker;
+
+    if (worker_ptr == (EbSchedulerWorker*)EB_NULL ||
+        worker_ptr->scheduler_ptr != scheduler_ptr ||
+        DequePushBottom(worker_ptr, stage_ptr) == EB_FALSE)
+        eb_ring_queue_push(scheduler_ptr->injection_queue, stage_ptr);
+    TaskSchedulerPublish(scheduler_ptr);
+
+    // Wake a parked worker if the count was negative
+    if (eb_atomic_fetch_add_32(&scheduler_ptr->pending_count, 1) < 0)
+        eb_post_semaphore(scheduler_ptr->park_semaphore);
+}
+
+/**************************************
+ * TaskSchedulerPostCallback
+ *   Called for each object posted to the
+ *   input fifos of a stage.
+ **************************************/
+static void TaskSchedulerPostCallback(
+    EbPtr callback_arg)
+{
+    EbSchedulerStage *stage_ptr = (EbSchedulerStage*)callback_arg;
+
+    TaskSchedulerSubmit(stage_ptr->scheduler_ptr, stage_ptr);
+}
+
+/**************************************
+ * TaskSchedulerTryAcquire
+ *   Claims one pending task.
+ **************************************/
+static EbBool TaskSchedulerTryAcquire(
+    EbTaskScheduler *scheduler_ptr)
+{
+    int32_t count = eb_atomic_load_32(&scheduler_ptr->pending_count);
+
+    while (count > 0) {
+        if (eb_atomic_cas_32(&scheduler_ptr->pending_count, count, count - 1))
+            return EB_TRUE;
+        count = eb_atomic_load_32(&scheduler_ptr->pending_count);
+    }
+
+    return EB_FALSE;
+}
+
+/**************************************
+ * TaskSchedulerFindTask
+ *   The caller owns a claim on a pending
+ *   task: look in the own deque, the
+ *   injection queue, then steal.
+ *
+ *   A scan misses the task when other
+ *   workers take the tasks it had not
+ *   reached yet and a new one is pushed
+ *   behind it. The worker then blocks
+ *   until the next task is published.
+ *   Without a push during the scan, the
+ *   task the claim stands for could not
+ *   have been missed.
+ **************************************/
+static EbSchedulerStage* TaskSchedulerFindTask(
+    EbSchedulerWorker *worker_ptr)
+{
+    EbTaskScheduler *scheduler_ptr = worker_ptr->scheduler_ptr;
+    EbPtr            task_ptr;
+    uint32_t         victimIndex;
+    int32_t          sequence;
+
+    for (;;) {
+        sequence = eb_atomic_load_32(&scheduler_ptr->publish_sequence);
+
+        task_ptr = DequePopBottom(worker_ptr);
+        if (task_ptr)
+            return (EbSchedulerStage*)task_ptr;
+
+        eb_ring_queue_try_pop(scheduler_ptr->injection_queue, &task_ptr);
+        if (task_ptr)
+            return (EbSchedulerStage*)task_ptr;
+
+        for (victimIndex = 1; victimIndex < scheduler_ptr->worker_count; ++victimIndex) {
+            task_ptr = DequeStealTop(&scheduler_ptr->worker_array[(worker_ptr->worker_index + victimIndex) % scheduler_ptr->worker_count]);
+            if (task_ptr) {
+                eb_atomic_fetch_add_64(&worker_ptr->steal_count, 1);
+                return (EbSchedulerStage*)task_ptr;
+            }
+        }
+
+        // Registrations are interchangeable: each one is either claimed
+        // by a publisher, which posts once for it, or retracted here, so
+        // the waits always match the posts.
+        eb_atomic_fetch_add_32(&scheduler_ptr->finder_count, 1);
+        if (eb_atomic_load_32(&scheduler_ptr->publish_sequence) == sequence ||
+            TaskSchedulerRetractFinder(scheduler_ptr) == EB_FALSE)
+            eb_block_on_semaphore(scheduler_ptr->publish_semaphore);
+    }
+}
+
+/**************************************
+ * TaskSchedulerRunKernel
+ *   Time spent in tasks nested inside the
+ *   kernel is only counted by their own
+ *   stage.
+ **************************************/
+static void TaskSchedulerRunKernel(
+    EbSchedulerWorker *worker_ptr,
+    EbStageContext    *stage_context_ptr,
+    EbObjectWrapper   *input_wrapper_ptr)
+{
+    EbSchedulerStage *stage_ptr = stage_context_ptr->stage_ptr;
+    uint64_t          runTimeStart = worker_ptr ? worker_ptr->run_time_us : 0;
+    uint64_t          startTime = eb_get_time_stamp_us();
+    uint64_t          elapsedTime;
+    uint64_t          nestedTime;
+
+    stage_ptr->kernel(stage_context_ptr->context_ptr, input_wrapper_ptr);
+
+    // The object taken by the stage is done
+    eb_pipeline_stats_end_object();
+
+    elapsedTime = eb_get_time_stamp_us() - startTime;
+    nestedTime = worker_ptr ? worker_ptr->run_time_us - runTimeStart : 0;
+    if (worker_ptr)
+        worker_ptr->run_time_us = runTimeStart + elapsedTime;
+
+    eb_atomic_fetch_add_64(&stage_ptr->busy_time_us, (int64_t)(elapsedTime - nestedTime));
+    eb_atomic_fetch_add_64(&stage_ptr->task_count, 1);
+}
+
+/**************************************
+ * TaskSchedulerRunTask
+ *   Returns EB_FALSE when the task had to
+ *   be requeued.
+ **************************************/
+static EbBool TaskSchedulerRunTask(
+    EbSchedulerWorker *worker_ptr,
+    EbSchedulerStage  *stage_ptr)
+{
+    EbStageContext  *stageContextPtr;
+    EbObjectWrapper *inputWrapperPtr;
+
+    eb_ring_queue_try_pop(stage_ptr->idle_context_queue, (EbPtr*)&stageContextPtr);
+    if (stageContextPtr == (EbStageContext*)EB_NULL) {
+        // Every context is held by a task waiting further up a stack
+        eb_atomic_fetch_add_64(&stage_ptr->starved_count, 1);
+        eb_ring_queue_push(worker_ptr->scheduler_ptr->injection_queue, stage_ptr);
+        TaskSchedulerPublish(worker_ptr->scheduler_ptr);
+        if (eb_atomic_fetch_add_32(&worker_ptr->scheduler_ptr->pending_count, 1) < 0)
+            eb_post_semaphore(worker_ptr->scheduler_ptr->park_semaphore);
+        return EB_FALSE;
+    }
+
+    // Each task was submitted after its object was posted
+    eb_try_get_full_object(
+        stageContextPtr->input_fifo_ptr,
+        &inputWrapperPtr);
+
+    if (inputWrapperPtr)
+        TaskSchedulerRunKernel(worker_ptr, stageContextPtr, inputWrapperPtr);
+
+    eb_ring_queue_push(stage_ptr->idle_context_queue, stageContextPtr);
+
+    return EB_TRUE;
+}
+
+/**************************************
+ * TaskSchedulerWaitCallback
+ *   Runs pending tasks while the worker
+ *   waits for an empty object inside a
+ *   kernel, so that the downstream stages
+ *   releasing it keep going.
+ **************************************/
+static EbBool TaskSchedulerWaitCallback(
+    EbPtr callback_arg)
+{
+    EbSchedulerWorker *worker_ptr = (EbSchedulerWorker*)callback_arg;
+    EbBool             ran = EB_FALSE;
+
+    if (worker_ptr->nesting_depth < TASK_SCHEDULER_MAX_NESTING &&
+        TaskSchedulerTryAcquire(worker_ptr->scheduler_ptr)) {
+        ++worker_ptr->nesting_depth;
+        ran = TaskSchedulerRunTask(worker_ptr, TaskSchedulerFindTask(worker_ptr));
+        --worker_ptr->nesting_depth;
+    }
+
+    if (ran == EB_FALSE)
+        TaskSchedulerIdle();
+
+    return ran;
+}
+
+/**************************************
+ * TaskSchedulerWorkerKernel
+ **************************************/
+static void* TaskSchedulerWorkerKernel(void *input_ptr)
+{
+    EbSchedulerWorker *worker_ptr = (EbSchedulerWorker*)input_ptr;
+    EbTaskScheduler   *scheduler_ptr = worker_ptr->scheduler_ptr;
+    uint32_t           spinCount = scheduler_ptr->worker_count > 1 ? TASK_SCHEDULER_SPIN_COUNT : 0;
+    uint32_t           spinIndex;
+    EbBool             acquired;
+
+    current_worker = worker_ptr;
+    eb_set_thread_wait_callback(TaskSchedulerWaitCallback, worker_ptr);
+
+    for (;;) {
+        acquired = EB_FALSE;
+        for (spinIndex = 0; spinIndex < spinCount && !acquired; ++spinIndex) {
+            acquired = TaskSchedulerTryAcquire(scheduler_ptr);
+            if (!acquired)
+                eb_cpu_pause();
+        }
+
+        // Park until a task is submitted
+        if (!acquired && eb_atomic_fetch_add_32(&scheduler_ptr->pending_count, -1) <= 0)
+            eb_block_on_semaphore(scheduler_ptr->park_semaphore);
+
+        if (TaskSchedulerRunTask(worker_ptr, TaskSchedulerFindTask(worker_ptr)) == EB_FALSE)
+            TaskSchedulerIdle();
+    }
+
+    return EB_NULL;
+}
+
+/**************************************
+ * TaskSchedulerStageKernel
+ *   Thread of one stage context, used
+ *   with dedicated threads.
+ **************************************/
+static void* TaskSchedulerStageKernel(void *input_ptr)
+{
+    EbStageContext  *stageContextPtr = (EbStageContext*)input_ptr;
+    EbObjectWrapper *inputWrapperPtr;
+
+    for (;;) {
+        eb_get_full_object(
+            stageContextPtr->input_fifo_ptr,
+            &inputWrapperPtr);
+
+        TaskSchedulerRunKernel((EbSchedulerWorker*)EB_NULL, stageContextPtr, inputWrapperPtr);
+    }
+
+    return EB_NULL;
+}
+
+/**************************************
+ * eb_task_scheduler_ctor
+ **************************************/
+EbErrorType eb_task_scheduler_ctor(
+    EbTaskScheduler **scheduler_dbl_ptr,
+    uint32_t          mode,
+    uint32_t          worker_count,
+    uint32_t          task_capacity)
+{
+    EbTaskScheduler *scheduler_ptr;
+    EbErrorType      return_error = EB_ErrorNone;
+
+    EB_MALLOC(EbTaskScheduler*, scheduler_ptr, sizeof(EbTaskScheduler), EB_N_PTR);
+    *scheduler_dbl_ptr = scheduler_ptr;
+
+    scheduler_ptr->mode = mode;
+    scheduler_ptr->worker_count = (mode == TASK_SCHEDULER_WORK_STEALING) ? MAX(worker_count, 1) : 0;
+    scheduler_ptr->worker_array = (EbSchedulerWorker*)EB_NULL;
+    scheduler_ptr->injection_queue = (EbRingQueue*)EB_NULL;
+    scheduler_ptr->park_semaphore = (EbHandle)EB_NULL;
+    scheduler_ptr->pending_count = 0;
+    scheduler_ptr->publish_semaphore = (EbHandle)EB_NULL;
+    scheduler_ptr->publish_sequence = 0;
+    scheduler_ptr->finder_count = 0;
+    scheduler_ptr->stage_count = 0;
+    scheduler_ptr->start_time_us = eb_get_time_stamp_us();
+
+    if (mode == TASK_SCHEDULER_WORK_STEALING) {
+        return_error = eb_ring_queue_ctor(
+            &scheduler_ptr->injection_queue,
+            task_capacity,
+            EB_FALSE);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+
+        EB_CREATESEMAPHORE(EbHandle, scheduler_ptr->park_semaphore, sizeof(EbHandle), EB_SEMAPHORE, 0, task_capacity + scheduler_ptr->worker_count);
+        EB_CREATESEMAPHORE(EbHandle, scheduler_ptr->publish_semaphore, sizeof(EbHandle), EB_SEMAPHORE, 0, scheduler_ptr->worker_count);
+    }
+
+    return return_error;
+}
+
+/**************************************
+ * eb_task_scheduler_add_stage
+ **************************************/
+EbErrorType eb_task_scheduler_add_stage(
+    EbTaskScheduler  *scheduler_ptr,
+    const char       *name,
+    EbStageKernel     kernel,
+    EbPtr            *context_ptr_array,
+    EbFifo          **input_fifo_ptr_array,
+    uint32_t          context_count)
+{
+    EbSchedulerStage *stage_ptr;
+    uint32_t          contextIndex;
+    EbErrorType       return_error = EB_ErrorNone;
+
+    if (scheduler_ptr->stage_count == TASK_SCHEDULER_MAX_STAGES)
+        return EB_ErrorInsufficientResources;
+
+    stage_ptr = &scheduler_ptr->stage_array[scheduler_ptr->stage_count++];
+    stage_ptr->name = name;
+    stage_ptr->kernel = kernel;
+    stage_ptr->context_count = context_count;
+    stage_ptr->thread_handle_array = (EbHandle*)EB_NULL;
+    stage_ptr->idle_context_queue = (EbRingQueue*)EB_NULL;
+    stage_ptr->scheduler_ptr = scheduler_ptr;
+    stage_ptr->task_count = 0;
+    stage_ptr->busy_time_us = 0;
+    stage_ptr->starved_count = 0;
+
+    EB_MALLOC(EbStageContext*, stage_ptr->context_array, sizeof(EbStageContext) * context_count, EB_N_PTR);
+
+    for (contextIndex = 0; contextIndex < context_count; ++contextIndex) {
+        stage_ptr->context_array[contextIndex].stage_ptr = stage_ptr;
+        stage_ptr->context_array[contextIndex].context_ptr = context_ptr_array[contextIndex];
+        stage_ptr->context_array[contextIndex].input_fifo_ptr = input_fifo_ptr_array[contextIndex];
+    }
+
+    if (scheduler_ptr->mode == TASK_SCHEDULER_WORK_STEALING) {
+        return_error = eb_ring_queue_ctor(
+            &stage_ptr->idle_context_queue,
+            context_count,
+            EB_FALSE);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+
+        for (contextIndex = 0; contextIndex < context_count; ++contextIndex)
+            eb_ring_queue_push(stage_ptr->idle_context_queue, &stage_ptr->context_array[contextIndex]);
+
+        // All the consumer fifos of a stage share one MuxingQueue
+        eb_fifo_set_post_callback(
+            input_fifo_ptr_array[0],
+            TaskSchedulerPostCallback,
+            stage_ptr);
+    }
+
+    return return_error;
+}
+
+/**************************************
+ * eb_task_scheduler_start
+ **************************************/
+EbErrorType eb_task_scheduler_start(
+    EbTaskScheduler  *scheduler_ptr)
+{
+    EbSchedulerStage  *stage_ptr;
+    EbSchedulerWorker *worker_ptr;
+    uint32_t           stageIndex;
+    uint32_t           contextIndex;
+    uint32_t           workerIndex;
+
+    scheduler_ptr->start_time_us = eb_get_time_stamp_us();
+
+    if (scheduler_ptr->mode == TASK_SCHEDULER_DEDICATED_THREADS) {
+        for (stageIndex = 0; stageIndex < scheduler_ptr->stage_count; ++stageIndex) {
+            stage_ptr = &scheduler_ptr->stage_array[stageIndex];
+
+            EB_MALLOC(EbHandle*, stage_ptr->thread_handle_array, sizeof(EbHandle) * stage_ptr->context_count, EB_N_PTR);
+
+            for (contextIndex = 0; contextIndex < stage_ptr->context_count; ++contextIndex) {
+                EB_CREATETHREAD(EbHandle, stage_ptr->thread_handle_array[contextIndex], sizeof(EbHandle), EB_THREAD, TaskSchedulerStageKernel, &stage_ptr->context_array[contextIndex]);
+            }
+        }
+    }
+    else {
+        EB_MALLOC(EbSchedulerWorker*, scheduler_ptr->worker_array, sizeof(EbSchedulerWorker) * scheduler_ptr->worker_count, EB_N_PTR);
+
+        for (workerIndex = 0; workerIndex < scheduler_ptr->worker_count; ++workerIndex) {
+            worker_ptr = &scheduler_ptr->worker_array[workerIndex];
+            worker_ptr->scheduler_ptr = scheduler_ptr;
+            worker_ptr->worker_index = workerIndex;
+            worker_ptr->nesting_depth = 0;
+            worker_ptr->run_time_us = 0;
+            worker_ptr->deque_lock = 0;
+            worker_ptr->deque_top = 0;
+            worker_ptr->deque_bottom = 0;
+            worker_ptr->steal_count = 0;
+        }
+
+        // Workers steal from each other: create them once all are initialized
+        for (workerIndex = 0; workerIndex < scheduler_ptr->worker_count; ++workerIndex) {
+            worker_ptr = &scheduler_ptr->worker_array[workerIndex];
+            EB_CREATETHREAD(EbHandle, worker_ptr->thread_handle, sizeof(EbHandle), EB_THREAD, TaskSchedulerWorkerKernel, worker_ptr);
+        }
+    }
+
+    return EB_ErrorNone;
+}
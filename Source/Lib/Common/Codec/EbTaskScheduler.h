@@ -0,0 +1,180 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbTaskScheduler_h
+#define EbTaskScheduler_h
+
+#include "EbDefinitions.h"
+#include "EbThreads.h"
+#include "EbRingQueue.h"
+#include "EbSystemResourceManager.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+    /*********************************
+     * Defines
+     *********************************/
+#define TASK_SCHEDULER_DEDICATED_THREADS    0   // one thread per stage context
+#define TASK_SCHEDULER_WORK_STEALING        1   // all stages share one worker pool
+
+#define TASK_SCHEDULER_MAX_STAGES           8
+#define TASK_SCHEDULER_DEQUE_SIZE           256 // power of 2
+#define TASK_SCHEDULER_SPIN_COUNT           1024
+    // Depth of the tasks a worker runs while it waits inside another task
+#define TASK_SCHEDULER_MAX_NESTING          4
+
+    /*********************************************************************
+     * StageKernel
+     *   Processes one object of the input fifo of a stage. context_ptr
+     *   is the stage context handed to the kernel, which is used by one
+     *   thread at a time.
+     *********************************************************************/
+    typedef void(*EbStageKernel)(
+        void            *context_ptr,
+        EbObjectWrapper *input_wrapper_ptr);
+
+    /*********************************************************************
+     * StageContext
+     *   One context of a stage and the consumer fifo it reads from.
+     *********************************************************************/
+    typedef struct EbStageContext
+    {
+        struct EbSchedulerStage *stage_ptr;
+        EbPtr                    context_ptr;
+        EbFifo                  *input_fifo_ptr;
+
+    } EbStageContext;
+
+    /*********************************************************************
+     * SchedulerStage
+     *   A pipeline stage driven by the scheduler. With dedicated threads
+     *   every context has its own thread blocking on its input fifo.
+     *   With work stealing each posted object becomes one task, which
+     *   runs the kernel with an idle context taken from
+     *   idle_context_queue.
+     *
+     *   The utilization counters are updated atomically:
+     *     task_count    - objects processed
+     *     busy_time_us  - time spent inside the kernel, summed over contexts
+     *     starved_count - tasks requeued because every context was busy
+     *********************************************************************/
+    typedef struct EbSchedulerStage
+    {
+        const char              *name;
+        EbStageKernel            kernel;
+        uint32_t                 context_count;
+        EbStageContext          *context_array;
+        EbHandle                *thread_handle_array;
+        EbRingQueue             *idle_context_queue;
+        struct EbTaskScheduler  *scheduler_ptr;
+
+        volatile int64_t         task_count;
+        volatile int64_t         busy_time_us;
+        volatile int64_t         starved_count;
+
+    } EbSchedulerStage;
+
+    /*********************************************************************
+     * SchedulerWorker
+     *   A pool thread and its task deque. The owner pushes and pops at
+     *   the bottom, thieves take from the top; deque_lock is a spin lock
+     *   as every critical section is a few instructions long.
+     *
+     *   run_time_us is the time spent in kernels by the worker, used to
+     *   take nested tasks out of the busy time of the task they run in.
+     *********************************************************************/
+    typedef struct EbSchedulerWorker
+    {
+        struct EbTaskScheduler  *scheduler_ptr;
+        uint32_t                 worker_index;
+        uint32_t                 nesting_depth;
+        uint64_t                 run_time_us;
+        EbHandle                 thread_handle;
+
+        volatile int32_t         deque_lock;
+        uint32_t                 deque_top;
+        uint32_t                 deque_bottom;
+        EbPtr                    deque_array[TASK_SCHEDULER_DEQUE_SIZE];
+
+        volatile int64_t         steal_count;
+
+    } EbSchedulerWorker;
+
+    /*********************************************************************
+     * TaskScheduler
+     *   Runs the kernels of the registered stages, either on dedicated
+     *   threads or as tasks on a work-stealing pool of worker_count
+     *   threads. Tasks that are not posted by a worker go to
+     *   injection_queue. pending_count counts the tasks not claimed by
+     *   a worker yet; a negative value is the number of parked workers.
+     *
+     *   publish_sequence is incremented after each task is pushed.
+     *   finder_count workers, which hold a claim but missed the task,
+     *   wait on publish_semaphore for the next push. A push claims
+     *   them all and posts once per claimed worker, so the semaphore
+     *   never holds more than worker_count posts.
+     *********************************************************************/
+    typedef struct EbTaskScheduler
+    {
+        uint32_t                 mode;
+        uint32_t                 worker_count;
+        EbSchedulerWorker       *worker_array;
+        EbRingQueue             *injection_queue;
+        EbHandle                 park_semaphore;
+        volatile int32_t         pending_count;
+        EbHandle                 publish_semaphore;
+        volatile int32_t         publish_sequence;
+        volatile int32_t         finder_count;
+
+        uint32_t                 stage_count;
+        EbSchedulerStage         stage_array[TASK_SCHEDULER_MAX_STAGES];
+
+        uint64_t                 start_time_us;
+
+    } EbTaskScheduler;
+
+    /*********************************************************************
+     * eb_task_scheduler_ctor
+     *   mode
+     *      TASK_SCHEDULER_DEDICATED_THREADS or TASK_SCHEDULER_WORK_STEALING
+     *
+     *   worker_count
+     *      Number of pool threads (work stealing only).
+     *
+     *   task_capacity
+     *      Upper bound of the tasks queued at any time, i.e. the number
+     *      of objects of the input resources of all stages.
+     *********************************************************************/
+    extern EbErrorType eb_task_scheduler_ctor(
+        EbTaskScheduler **scheduler_dbl_ptr,
+        uint32_t          mode,
+        uint32_t          worker_count,
+        uint32_t          task_capacity);
+
+    /*********************************************************************
+     * eb_task_scheduler_add_stage
+     *   Registers a stage whose kernel consumes, with context i, the
+     *   objects of input_fifo_ptr_array[i].
+     *********************************************************************/
+    extern EbErrorType eb_task_scheduler_add_stage(
+        EbTaskScheduler  *scheduler_ptr,
+        const char       *name,
+        EbStageKernel     kernel,
+        EbPtr            *context_ptr_array,
+        EbFifo          **input_fifo_ptr_array,
+        uint32_t          context_count);
+
+    /*********************************************************************
+     * eb_task_scheduler_start
+     *   Creates the stage threads or the worker pool. Called once, after
+     *   all stages have been added.
+     *********************************************************************/
+    extern EbErrorType eb_task_scheduler_start(
+        EbTaskScheduler  *scheduler_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //EbTaskScheduler_h
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include "EbDefinitions.h"
 #include "EbThreads.h"
+#include "EbMemoryArena.h"
  /****************************************
   * Win32 Includes
   ****************************************/
@@ -45,6 +46,43 @@ void printfTime(const char *fmt, ...)
 #endif
 #endif
 
+/****************************************
+ * EbThreadStart
+ *   Runs thread_function on the new thread
+ *   with the memory arena of the creating
+ *   thread, so that the allocations of the
+ *   library threads go to their encoder
+ *   instance.
+ ****************************************/
+typedef struct EbThreadStartData
+{
+    void           *(*thread_function)(void *);
+    void            *thread_context;
+    EbMemoryArena   *arena_ptr;
+} EbThreadStartData;
+
+#ifdef _WIN32
+static DWORD WINAPI EbThreadStart(
+    LPVOID start_data)
+#else
+static void *EbThreadStart(
+    void *start_data)
+#endif
+{
+    EbThreadStartData startData = *(EbThreadStartData*)start_data;
+
+    free(start_data);
+
+    eb_memory_arena_set_current(startData.arena_ptr);
+
+#ifdef _WIN32
+    startData.thread_function(startData.thread_context);
+    return 0;
+#else
+    return startData.thread_function(startData.thread_context);
+#endif
+}
+
 /****************************************
  * eb_create_thread
  ****************************************/
@@ -53,16 +91,25 @@ EbHandle eb_create_thread(
     void *thread_context)
 {
     EbHandle thread_handle = NULL;
+    EbThreadStartData *startDataPtr = (EbThreadStartData*)malloc(sizeof(EbThreadStartData));
+
+    if (startDataPtr == (EbThreadStartData*)EB_NULL)
+        return thread_handle;
+    startDataPtr->thread_function = thread_function;
+    startDataPtr->thread_context = thread_context;
+    startDataPtr->arena_ptr = eb_memory_arena_get_current();
 
 #ifdef _WIN32
 
     thread_handle = (EbHandle)CreateThread(
         NULL,                           // default security attributes
         0,                              // default stack size
-        (LPTHREAD_START_ROUTINE)thread_function, // function to be tied to the new thread
-        thread_context,                  // context to be tied to the new thread
+        EbThreadStart,                  // function to be tied to the new thread
+        startDataPtr,                   // context to be tied to the new thread
         0,                              // thread active when created
         NULL);                          // new thread ID
+    if (thread_handle == NULL)
+        free(startDataPtr);
 
 #elif defined(__linux__) || defined(__APPLE__)
 
@@ -80,8 +127,8 @@ EbHandle eb_create_thread(
     int32_t ret = pthread_create(
         (pthread_t*)thread_handle,      // Thread handle
         &attr,                       // attributes
-        thread_function,                 // function to be run by new thread
-        thread_context);
+        EbThreadStart,                   // function to be run by new thread
+        startDataPtr);
 
     if (ret != 0)
         if (ret == EPERM) {
@@ -92,12 +139,14 @@ EbHandle eb_create_thread(
 
             thread_handle = (pthread_t*)malloc(sizeof(pthread_t));
 
-            pthread_create(
+            ret = pthread_create(
                 (pthread_t*)thread_handle,      // Thread handle
                 (const pthread_attr_t*)EB_NULL,                        // attributes
-                thread_function,                 // function to be run by new thread
-                thread_context);
+                EbThreadStart,                   // function to be run by new thread
+                startDataPtr);
         }
+    if (ret != 0)
+        free(startDataPtr);
 
 #endif // _WIN32
 
@@ -70,9 +70,66 @@ extern "C" {
     extern EbErrorType eb_destroy_mutex(
         EbHandle mutex_handle);
 
-    extern    EbMemoryMapEntry *memory_map;                // library Memory table
-    extern    uint32_t         *memory_map_index;          // library memory index
-    extern    uint64_t         *total_lib_memory;          // library Memory malloc'd
+    /**************************************
+     * Atomics
+     *   Sequentially consistent operations
+     *   used by the lock-free queues and the
+     *   task scheduler. fetch_add returns the
+     *   value held before the addition.
+     **************************************/
+#ifdef _WIN32
+#define EB_THREAD_LOCAL __declspec(thread)
+
+    static INLINE int32_t eb_atomic_load_32(volatile int32_t *ptr) {
+        return InterlockedCompareExchange((volatile LONG*)ptr, 0, 0);
+    }
+
+    static INLINE void eb_atomic_store_32(volatile int32_t *ptr, int32_t value) {
+        InterlockedExchange((volatile LONG*)ptr, value);
+    }
+
+    static INLINE int32_t eb_atomic_fetch_add_32(volatile int32_t *ptr, int32_t value) {
+        return InterlockedExchangeAdd((volatile LONG*)ptr, value);
+    }
+
+    static INLINE EbBool eb_atomic_cas_32(volatile int32_t *ptr, int32_t expected, int32_t desired) {
+        return InterlockedCompareExchange((volatile LONG*)ptr, desired, expected) == expected ? EB_TRUE : EB_FALSE;
+    }
+
+    static INLINE int64_t eb_atomic_fetch_add_64(volatile int64_t *ptr, int64_t value) {
+        return InterlockedExchangeAdd64((volatile LONG64*)ptr, value);
+    }
+
+    static INLINE void eb_cpu_pause(void) {
+        YieldProcessor();
+    }
+#else
+#define EB_THREAD_LOCAL __thread
+
+    static INLINE int32_t eb_atomic_load_32(volatile int32_t *ptr) {
+        return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+    }
+
+    static INLINE void eb_atomic_store_32(volatile int32_t *ptr, int32_t value) {
+        __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+    }
+
+    static INLINE int32_t eb_atomic_fetch_add_32(volatile int32_t *ptr, int32_t value) {
+        return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+    }
+
+    static INLINE EbBool eb_atomic_cas_32(volatile int32_t *ptr, int32_t expected, int32_t desired) {
+        return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? EB_TRUE : EB_FALSE;
+    }
+
+    static INLINE int64_t eb_atomic_fetch_add_64(volatile int64_t *ptr, int64_t value) {
+        return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+    }
+
+    static INLINE void eb_cpu_pause(void) {
+        __builtin_ia32_pause();
+    }
+#endif
 
 #ifdef _WIN32
     extern    GROUP_AFFINITY    group_affinity;
@@ -85,14 +142,6 @@ extern "C" {
         return EB_ErrorInsufficientResources; \
     } \
     else { \
-        memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-        memory_map[(*(memory_map_index))++].ptr = pointer; \
-        if (n_elements % 8 == 0) { \
-            *total_lib_memory += (n_elements); \
-        } \
-        else { \
-            *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
-        } \
         if(num_groups == 1) {\
             SetThreadAffinityMask(pointer, group_affinity.Mask);\
         }\
@@ -104,7 +153,8 @@ extern "C" {
             SetThreadGroupAffinity(pointer,&group_affinity,NULL); \
         } \
     } \
-    if (*(memory_map_index) >= MAX_NUM_PTR) { \
+    if (eb_memory_arena_add_handle(pointer, pointer_class, "EbThread", n_elements) != EB_ErrorNone) { \
+        eb_destroy_thread(pointer); \
         return EB_ErrorInsufficientResources; \
     } \
     lib_thread_count++;
@@ -121,16 +171,9 @@ extern    cpu_set_t                   group_affinity;
     } \
    else { \
         pthread_setaffinity_np(*((pthread_t*)pointer),sizeof(cpu_set_t),&group_affinity); \
-        memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-        memory_map[(*(memory_map_index))++].ptr = pointer; \
-        if (n_elements % 8 == 0) { \
-            *total_lib_memory += (n_elements); \
-        } \
-        else { \
-            *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
-        } \
     } \
-    if (*(memory_map_index) >= MAX_NUM_PTR) { \
+    if (eb_memory_arena_add_handle(pointer, pointer_class, "EbThread", n_elements) != EB_ErrorNone) { \
+        eb_destroy_thread(pointer); \
         return EB_ErrorInsufficientResources; \
     } \
     lib_thread_count++;
@@ -140,17 +183,8 @@ extern    cpu_set_t                   group_affinity;
     if (pointer == (type)EB_NULL) { \
         return EB_ErrorInsufficientResources; \
     } \
-   else { \
-        memory_map[*(memory_map_index)].ptr_type = pointer_class; \
-        memory_map[(*(memory_map_index))++].ptr = pointer; \
-        if (n_elements % 8 == 0) { \
-            *total_lib_memory += (n_elements); \
-        } \
-        else { \
-            *total_lib_memory += ((n_elements) + (8 - ((n_elements) % 8))); \
-        } \
-    } \
-    if (*(memory_map_index) >= MAX_NUM_PTR) { \
+    if (eb_memory_arena_add_handle(pointer, pointer_class, "EbThread", n_elements) != EB_ErrorNone) { \
+        eb_destroy_thread(pointer); \
         return EB_ErrorInsufficientResources; \
     } \
     lib_thread_count++;
@@ -11,6 +11,7 @@
 #include <time.h>
 #include <stdio.h>
 //#endif
+#include <Windows.h>
 
 #elif defined(__linux__) || defined(__APPLE__)
 #include <stdio.h>
@@ -567,6 +568,54 @@ void EbStartTime(uint64_t *Startseconds, uint64_t *Startuseconds) {
 
 }
 
+/**************************************************************
+* eb_get_time_stamp_us
+*   Monotonic time stamp in microseconds, used for the run-time
+*   counters of the library.
+**************************************************************/
+uint64_t eb_get_time_stamp_us(void) {
+
+#if defined(__linux__) || defined(__APPLE__)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+#elif _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+        (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000 / (uint64_t)frequency.QuadPart;
+#else
+    return 0;
+#endif
+
+}
+
+/**************************************************************
+* eb_get_thread_cpu_time_us
+*   CPU time consumed by the calling thread in microseconds. It
+*   does not advance while the thread is blocked or preempted.
+**************************************************************/
+uint64_t eb_get_thread_cpu_time_us(void) {
+
+#if defined(__linux__) || defined(__APPLE__)
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+#elif _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+        return 0;
+    // Kernel and user times are in 100 ns units
+    return ((((uint64_t)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime) +
+        (((uint64_t)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime)) / 10;
+#else
+    return 0;
+#endif
+
+}
+
 void EbFinishTime(uint64_t *Finishseconds, uint64_t *Finishuseconds) {
 
 #if defined(__linux__) || defined(__APPLE__) //(LINUX_ENCODER_TIMING || LINUX_DECODER_TIMING)
@@ -287,6 +287,9 @@ extern "C" {
 
     } MiniGopStats_t;
     extern const MiniGopStats_t* get_mini_gop_stats(const uint32_t miniGopIndex);
+
+    extern uint64_t eb_get_time_stamp_us(void);
+    extern uint64_t eb_get_thread_cpu_time_us(void);
     typedef enum MiniGopIndex {
         L6_INDEX = 0,
         L5_0_INDEX = 1,
@@ -40,6 +40,7 @@
 #define HAS_AVX 0x40
 #define HAS_AVX2 0x80
 #define HAS_SSE4_2 0x100
+#define HAS_AVX512 0x200
 
 
 #ifdef __cplusplus
@@ -155,6 +156,36 @@ extern "C" {
     void av1_filter_intra_edge_high_sse4_1(uint16_t *p, int32_t sz, int32_t strength);
     RTCD_EXTERN void(*av1_filter_intra_edge_high)(uint16_t *p, int32_t sz, int32_t strength);
 
+    uint32_t av1_get_crc32c_value_c(void *crc_calculator, uint8_t *p, size_t length);
+    uint32_t av1_get_crc32c_value_sse4_2(void *crc_calculator, uint8_t *p, size_t length);
+    RTCD_EXTERN uint32_t(*av1_get_crc32c_value)(void *crc_calculator, uint8_t *p, size_t length);
+
+    uint32_t eb_count_colors_16x16_c(const uint8_t *src, int32_t stride, uint32_t limit);
+    uint32_t eb_count_colors_16x16_avx2(const uint8_t *src, int32_t stride, uint32_t limit);
+    RTCD_EXTERN uint32_t(*eb_count_colors_16x16)(const uint8_t *src, int32_t stride, uint32_t limit);
+
+    uint32_t eb_count_colors_16x16_highbd_c(const uint8_t *src, int32_t stride, const uint8_t *src_bit_inc, int32_t bit_inc_stride, uint32_t limit);
+    uint32_t eb_count_colors_16x16_highbd_avx2(const uint8_t *src, int32_t stride, const uint8_t *src_bit_inc, int32_t bit_inc_stride, uint32_t limit);
+    RTCD_EXTERN uint32_t(*eb_count_colors_16x16_highbd)(const uint8_t *src, int32_t stride, const uint8_t *src_bit_inc, int32_t bit_inc_stride, uint32_t limit);
+
+    void sad_loop_kernel_c(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t height, uint32_t width, uint64_t *best_sad, int16_t *x_search_center, int16_t *y_search_center, uint32_t src_stride_raw, int16_t search_area_width, int16_t search_area_height);
+    void sad_loop_kernel_sse4_1_intrin(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t height, uint32_t width, uint64_t *best_sad, int16_t *x_search_center, int16_t *y_search_center, uint32_t src_stride_raw, int16_t search_area_width, int16_t search_area_height);
+    void sad_loop_kernel_avx2_intrin(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t height, uint32_t width, uint64_t *best_sad, int16_t *x_search_center, int16_t *y_search_center, uint32_t src_stride_raw, int16_t search_area_width, int16_t search_area_height);
+    void sad_loop_kernel_avx512_intrin(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t height, uint32_t width, uint64_t *best_sad, int16_t *x_search_center, int16_t *y_search_center, uint32_t src_stride_raw, int16_t search_area_width, int16_t search_area_height);
+    RTCD_EXTERN void(*sad_loop_kernel)(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t height, uint32_t width, uint64_t *best_sad, int16_t *x_search_center, int16_t *y_search_center, uint32_t src_stride_raw, int16_t search_area_width, int16_t search_area_height);
+
+#if NSQ_ME_OPT
+    void ext_all_sad_calculation_8x8_16x16_c(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t mv, uint32_t *p_best_sad8x8, uint32_t *p_best_sad16x16, uint32_t *p_best_mv8x8, uint32_t *p_best_mv16x16, uint32_t p_eight_sad16x16[16][8], uint32_t p_eight_sad8x8[64][8]);
+    void ext_all_sad_calculation_8x8_16x16_avx2(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t mv, uint32_t *p_best_sad8x8, uint32_t *p_best_sad16x16, uint32_t *p_best_mv8x8, uint32_t *p_best_mv16x16, uint32_t p_eight_sad16x16[16][8], uint32_t p_eight_sad8x8[64][8]);
+    void ext_all_sad_calculation_8x8_16x16_avx512(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t mv, uint32_t *p_best_sad8x8, uint32_t *p_best_sad16x16, uint32_t *p_best_mv8x8, uint32_t *p_best_mv16x16, uint32_t p_eight_sad16x16[16][8], uint32_t p_eight_sad8x8[64][8]);
+    RTCD_EXTERN void(*ext_all_sad_calculation_8x8_16x16)(uint8_t *src, uint32_t src_stride, uint8_t *ref, uint32_t ref_stride, uint32_t mv, uint32_t *p_best_sad8x8, uint32_t *p_best_sad16x16, uint32_t *p_best_mv8x8, uint32_t *p_best_mv16x16, uint32_t p_eight_sad16x16[16][8], uint32_t p_eight_sad8x8[64][8]);
+
+    void ext_eight_sad_calculation_32x32_64x64_c(uint32_t p_sad16x16[16][8], uint32_t *p_best_sad32x32, uint32_t *p_best_sad64x64, uint32_t *p_best_mv32x32, uint32_t *p_best_mv64x64, uint32_t mv, uint32_t p_sad32x32[4][8]);
+    void ext_eight_sad_calculation_32x32_64x64_avx2(uint32_t p_sad16x16[16][8], uint32_t *p_best_sad32x32, uint32_t *p_best_sad64x64, uint32_t *p_best_mv32x32, uint32_t *p_best_mv64x64, uint32_t mv, uint32_t p_sad32x32[4][8]);
+    void ext_eight_sad_calculation_32x32_64x64_avx512(uint32_t p_sad16x16[16][8], uint32_t *p_best_sad32x32, uint32_t *p_best_sad64x64, uint32_t *p_best_mv32x32, uint32_t *p_best_mv64x64, uint32_t mv, uint32_t p_sad32x32[4][8]);
+    RTCD_EXTERN void(*ext_eight_sad_calculation_32x32_64x64)(uint32_t p_sad16x16[16][8], uint32_t *p_best_sad32x32, uint32_t *p_best_sad64x64, uint32_t *p_best_mv32x32, uint32_t *p_best_mv64x64, uint32_t mv, uint32_t p_sad32x32[4][8]);
+#endif
+
     void av1_fwd_txfm2d_4x16_c(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
     void av1_fwd_txfm2d_4x16_avx2(int16_t *input, int32_t *output, uint32_t inputStride, TxType transform_type, uint8_t  bit_depth);
     RTCD_EXTERN void(*av1_fwd_txfm2d_4x16)(int16_t *input, int32_t *output, uint32_t inputStride, TxType transform_type, uint8_t  bit_depth);
@@ -230,10 +261,12 @@ extern "C" {
 
     void Av1TransformTwoD_64x64_c(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
     void av1_fwd_txfm2d_64x64_avx2(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
+    void av1_fwd_txfm2d_64x64_avx512(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
     RTCD_EXTERN void(*av1_fwd_txfm2d_64x64)(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
 
     void Av1TransformTwoD_32x32_c(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
     void av1_fwd_txfm2d_32x32_avx2(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
+    void av1_fwd_txfm2d_32x32_avx512(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
     RTCD_EXTERN void(*av1_fwd_txfm2d_32x32)(int16_t *input, int32_t *output, uint32_t input_stride, TxType transform_type, uint8_t  bit_depth);
 
 #if PF_N2_32X32
@@ -290,6 +323,7 @@ extern "C" {
 
     void av1_convolve_2d_sr_c(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
     void av1_convolve_2d_sr_avx2(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
+    void av1_convolve_2d_sr_avx512(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
     RTCD_EXTERN void(*av1_convolve_2d_sr)(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
 
     void av1_jnt_convolve_2d_copy_c(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
@@ -361,6 +395,7 @@ extern "C" {
 
     void av1_inv_txfm2d_add_32x32_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
     void av1_inv_txfm2d_add_32x32_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
+    void av1_inv_txfm2d_add_32x32_avx512(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
     RTCD_EXTERN void(*av1_inv_txfm2d_add_32x32)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
 
     void av1_inv_txfm2d_add_64x64_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
@@ -1621,6 +1656,28 @@ extern "C" {
     void aom_fft8x8_float_avx2(const float *input, float *temp, float *output);
     RTCD_EXTERN void(*aom_fft8x8_float)(const float *input, float *temp, float *output);
 
+    void aom_noise_tx_filter_block_c(float *tx_block, const float *psd, int32_t n);
+    void aom_noise_tx_filter_block_avx2(float *tx_block, const float *psd, int32_t n);
+    RTCD_EXTERN void(*aom_noise_tx_filter_block)(float *tx_block, const float *psd, int32_t n);
+    void fgn_ar_row_sum_c(const int32_t *grain, int32_t grain_stride, const int32_t *ar_coeffs, int32_t lag, int32_t width, int32_t *wsum);
+    void fgn_ar_row_sum_avx2(const int32_t *grain, int32_t grain_stride, const int32_t *ar_coeffs, int32_t lag, int32_t width, int32_t *wsum);
+    RTCD_EXTERN void(*fgn_ar_row_sum)(const int32_t *grain, int32_t grain_stride, const int32_t *ar_coeffs, int32_t lag, int32_t width, int32_t *wsum);
+    void fgn_luma_noise_row_c(uint8_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t scaling_shift, int32_t min_luma, int32_t max_luma);
+    void fgn_luma_noise_row_avx2(uint8_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t scaling_shift, int32_t min_luma, int32_t max_luma);
+    RTCD_EXTERN void(*fgn_luma_noise_row)(uint8_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t scaling_shift, int32_t min_luma, int32_t max_luma);
+    void fgn_luma_noise_row_hbd_c(uint16_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t bit_depth, int32_t scaling_shift, int32_t min_luma, int32_t max_luma);
+    void fgn_luma_noise_row_hbd_avx2(uint16_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t bit_depth, int32_t scaling_shift, int32_t min_luma, int32_t max_luma);
+    RTCD_EXTERN void(*fgn_luma_noise_row_hbd)(uint16_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t bit_depth, int32_t scaling_shift, int32_t min_luma, int32_t max_luma);
+    void fgn_chroma_noise_row_c(uint8_t *chroma, const uint8_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset, int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma);
+    void fgn_chroma_noise_row_avx2(uint8_t *chroma, const uint8_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset, int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma);
+    RTCD_EXTERN void(*fgn_chroma_noise_row)(uint8_t *chroma, const uint8_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset, int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma);
+    void fgn_chroma_noise_row_hbd_c(uint16_t *chroma, const uint16_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset, int32_t bit_depth, int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma);
+    void fgn_chroma_noise_row_hbd_avx2(uint16_t *chroma, const uint16_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset, int32_t bit_depth, int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma);
+    RTCD_EXTERN void(*fgn_chroma_noise_row_hbd)(uint16_t *chroma, const uint16_t *luma, const int32_t *grain, int32_t width, const int32_t *scaling_lut, int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset, int32_t bit_depth, int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma);
+    void fgn_hor_boundary_overlap_c(const int32_t *top_block, int32_t top_stride, const int32_t *bottom_block, int32_t bottom_stride, int32_t *dst_block, int32_t dst_stride, int32_t width, int32_t height, int32_t grain_min, int32_t grain_max);
+    void fgn_hor_boundary_overlap_avx2(const int32_t *top_block, int32_t top_stride, const int32_t *bottom_block, int32_t bottom_stride, int32_t *dst_block, int32_t dst_stride, int32_t width, int32_t height, int32_t grain_min, int32_t grain_max);
+    RTCD_EXTERN void(*fgn_hor_boundary_overlap)(const int32_t *top_block, int32_t top_stride, const int32_t *bottom_block, int32_t bottom_stride, int32_t *dst_block, int32_t dst_stride, int32_t width, int32_t height, int32_t grain_min, int32_t grain_max);
+
     void aom_highbd_dc_128_predictor_16x16_c(uint16_t *dst, ptrdiff_t y_stride, const uint16_t *above, const uint16_t *left, int32_t bd);
     void aom_highbd_dc_128_predictor_16x16_avx2(uint16_t *dst, ptrdiff_t y_stride, const uint16_t *above, const uint16_t *left, int32_t bd);
     RTCD_EXTERN void(*aom_highbd_dc_128_predictor_16x16)(uint16_t *dst, ptrdiff_t y_stride, const uint16_t *above, const uint16_t *left, int32_t bd);
@@ -2379,20 +2436,16 @@ extern "C" {
 
     void aom_dsp_rtcd(void);
 
+    // Points every kernel above at the best version the HAS_* flags allow,
+    // flags = 0 selects the C kernels. Also used by the kernel benchmarks to
+    // walk the instruction set levels one at a time.
+    void setup_rtcd_flags(int32_t flags);
+
 
 #ifdef RTCD_C
 
-    static void setup_rtcd_internal(EbAsm asm_type)
+    void setup_rtcd_flags(int32_t flags)
     {
-        int32_t flags = HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_SSE3 | HAS_SSSE3 | HAS_SSE4_1 | HAS_SSE4_2 | HAS_AVX;
-
-        if (asm_type == ASM_AVX2)
-            flags |= HAS_AVX2;
-        //if (asm_type == ASM_NON_AVX2)
-        //    flags = ~HAS_AVX2;
-
-        //to use C: flags=0
-
         apply_selfguided_restoration = apply_selfguided_restoration_c;
         if (flags & HAS_AVX2) apply_selfguided_restoration = apply_selfguided_restoration_avx2;
 
@@ -2425,6 +2478,24 @@ extern "C" {
         if (flags & HAS_AVX2) av1_highbd_pixel_proj_error = av1_highbd_pixel_proj_error_avx2;
         av1_filter_intra_edge_high = av1_filter_intra_edge_high_c;
         if (flags & HAS_SSE4_1) av1_filter_intra_edge_high = av1_filter_intra_edge_high_sse4_1;
+        av1_get_crc32c_value = av1_get_crc32c_value_c;
+        if (flags & HAS_SSE4_2) av1_get_crc32c_value = av1_get_crc32c_value_sse4_2;
+        eb_count_colors_16x16 = eb_count_colors_16x16_c;
+        if (flags & HAS_AVX2) eb_count_colors_16x16 = eb_count_colors_16x16_avx2;
+        eb_count_colors_16x16_highbd = eb_count_colors_16x16_highbd_c;
+        if (flags & HAS_AVX2) eb_count_colors_16x16_highbd = eb_count_colors_16x16_highbd_avx2;
+        sad_loop_kernel = sad_loop_kernel_c;
+        if (flags & HAS_SSE4_1) sad_loop_kernel = sad_loop_kernel_sse4_1_intrin;
+        if (flags & HAS_AVX2) sad_loop_kernel = sad_loop_kernel_avx2_intrin;
+        if (flags & HAS_AVX512) sad_loop_kernel = sad_loop_kernel_avx512_intrin;
+#if NSQ_ME_OPT
+        ext_all_sad_calculation_8x8_16x16 = ext_all_sad_calculation_8x8_16x16_c;
+        if (flags & HAS_AVX2) ext_all_sad_calculation_8x8_16x16 = ext_all_sad_calculation_8x8_16x16_avx2;
+        if (flags & HAS_AVX512) ext_all_sad_calculation_8x8_16x16 = ext_all_sad_calculation_8x8_16x16_avx512;
+        ext_eight_sad_calculation_32x32_64x64 = ext_eight_sad_calculation_32x32_64x64_c;
+        if (flags & HAS_AVX2) ext_eight_sad_calculation_32x32_64x64 = ext_eight_sad_calculation_32x32_64x64_avx2;
+        if (flags & HAS_AVX512) ext_eight_sad_calculation_32x32_64x64 = ext_eight_sad_calculation_32x32_64x64_avx512;
+#endif
         av1_highbd_convolve_2d_copy_sr = av1_highbd_convolve_2d_copy_sr_c;
         if (flags & HAS_AVX2) av1_highbd_convolve_2d_copy_sr = av1_highbd_convolve_2d_copy_sr_avx2;
         av1_highbd_jnt_convolve_2d_copy = av1_highbd_jnt_convolve_2d_copy_c;
@@ -2476,6 +2547,7 @@ extern "C" {
 
         av1_convolve_2d_sr = av1_convolve_2d_sr_c;
         if (flags & HAS_AVX2) av1_convolve_2d_sr = av1_convolve_2d_sr_avx2;
+        if (flags & HAS_AVX512) av1_convolve_2d_sr = av1_convolve_2d_sr_avx512;
 
         av1_jnt_convolve_2d_copy = av1_jnt_convolve_2d_copy_c;
         if (flags & HAS_AVX2) av1_jnt_convolve_2d_copy = av1_jnt_convolve_2d_copy_avx2;
@@ -2509,6 +2581,7 @@ extern "C" {
         if (flags & HAS_AVX2) av1_inv_txfm2d_add_16x16 = av1_inv_txfm2d_add_16x16_avx2;
         av1_inv_txfm2d_add_32x32 = av1_inv_txfm2d_add_32x32_c;
         if (flags & HAS_AVX2) av1_inv_txfm2d_add_32x32 = av1_inv_txfm2d_add_32x32_avx2;
+        if (flags & HAS_AVX512) av1_inv_txfm2d_add_32x32 = av1_inv_txfm2d_add_32x32_avx512;
         av1_inv_txfm2d_add_4x4 = av1_inv_txfm2d_add_4x4_c;
         if (flags & HAS_AVX2) av1_inv_txfm2d_add_4x4 = av1_inv_txfm2d_add_4x4_avx2;
         av1_inv_txfm2d_add_64x64 = av1_inv_txfm2d_add_64x64_c;
@@ -3380,8 +3453,10 @@ aom_variance8x8 = aom_variance8x8_c;
         if (flags & HAS_AVX2) av1_fwd_txfm2d_64x16 = av1_fwd_txfm2d_64x16_avx2;
         av1_fwd_txfm2d_64x64 = Av1TransformTwoD_64x64_c;
         if (flags & HAS_AVX2) av1_fwd_txfm2d_64x64 = av1_fwd_txfm2d_64x64_avx2;
+        if (flags & HAS_AVX512) av1_fwd_txfm2d_64x64 = av1_fwd_txfm2d_64x64_avx512;
         av1_fwd_txfm2d_32x32 = Av1TransformTwoD_32x32_c;
         if (flags & HAS_AVX2) av1_fwd_txfm2d_32x32 = av1_fwd_txfm2d_32x32_avx2;
+        if (flags & HAS_AVX512) av1_fwd_txfm2d_32x32 = av1_fwd_txfm2d_32x32_avx512;
         av1_fwd_txfm2d_16x16 = Av1TransformTwoD_16x16_c;
 #if INTRINSIC_OPT_2
         if (flags & HAS_AVX2) av1_fwd_txfm2d_16x16 = av1_fwd_txfm2d_16x16_avx2;
@@ -3737,6 +3812,33 @@ aom_variance8x8 = aom_variance8x8_c;
         aom_ifft2x2_float = aom_ifft2x2_float_c;
         /*if (flags & HAS_SSE2)*/ aom_ifft4x4_float = aom_ifft4x4_float_sse2;
 
+        aom_noise_tx_filter_block = aom_noise_tx_filter_block_c;
+        if (flags & HAS_AVX2) aom_noise_tx_filter_block = aom_noise_tx_filter_block_avx2;
+        fgn_ar_row_sum = fgn_ar_row_sum_c;
+        if (flags & HAS_AVX2) fgn_ar_row_sum = fgn_ar_row_sum_avx2;
+        fgn_luma_noise_row = fgn_luma_noise_row_c;
+        if (flags & HAS_AVX2) fgn_luma_noise_row = fgn_luma_noise_row_avx2;
+        fgn_luma_noise_row_hbd = fgn_luma_noise_row_hbd_c;
+        if (flags & HAS_AVX2) fgn_luma_noise_row_hbd = fgn_luma_noise_row_hbd_avx2;
+        fgn_chroma_noise_row = fgn_chroma_noise_row_c;
+        if (flags & HAS_AVX2) fgn_chroma_noise_row = fgn_chroma_noise_row_avx2;
+        fgn_chroma_noise_row_hbd = fgn_chroma_noise_row_hbd_c;
+        if (flags & HAS_AVX2) fgn_chroma_noise_row_hbd = fgn_chroma_noise_row_hbd_avx2;
+        fgn_hor_boundary_overlap = fgn_hor_boundary_overlap_c;
+        if (flags & HAS_AVX2) fgn_hor_boundary_overlap = fgn_hor_boundary_overlap_avx2;
+
+    }
+
+    static void setup_rtcd_internal(EbAsm asm_type, EbBool use_avx512)
+    {
+        int32_t flags = HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_SSE3 | HAS_SSSE3 | HAS_SSE4_1 | HAS_SSE4_2 | HAS_AVX;
+
+        if (asm_type == ASM_AVX2)
+            flags |= HAS_AVX2;
+        if (asm_type == ASM_AVX2 && use_avx512)
+            flags |= HAS_AVX512;
+
+        setup_rtcd_flags(flags);
     }
 #endif
 
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include "EbDefinitions.h"
 #include "grainSynthesis.h"
+#include "aom_dsp_rtcd.h"
 
   // Samples with Gaussian distribution in the range of [-2048, 2047] (12 bits)
   // with zero mean and standard deviation of about 512.
@@ -213,13 +214,11 @@ static const int32_t gaussian_sequence[2048] = {
   428,   -484
 };
 
-static const int32_t gauss_bits = 11;
 
-static int32_t luma_subblock_size_y = 32;
-static int32_t luma_subblock_size_x = 32;
+static const int32_t gauss_bits = 11;
 
-static int32_t chroma_subblock_size_y = 16;
-static int32_t chroma_subblock_size_x = 16;
+static const int32_t luma_subblock_size_y = FILM_GRAIN_STRIPE_HEIGHT;
+static const int32_t luma_subblock_size_x = 32;
 
 static const int32_t min_luma_legal_range = 16;
 static const int32_t max_luma_legal_range = 235;
@@ -227,15 +226,17 @@ static const int32_t max_luma_legal_range = 235;
 static const int32_t min_chroma_legal_range = 16;
 static const int32_t max_chroma_legal_range = 240;
 
-static int32_t scaling_lut_y[256];
-static int32_t scaling_lut_cb[256];
-static int32_t scaling_lut_cr[256];
+// Padding of the grain templates, to offset for the AR coefficients
+static const int32_t left_pad = 3;
+static const int32_t right_pad = 3;
+static const int32_t top_pad = 3;
+static const int32_t bottom_pad = 0;
 
-static int32_t grain_center;
-static int32_t grain_min;
-static int32_t grain_max;
+static const int32_t ar_padding = 3;  // maximum lag used for stabilization of AR coefficients
+
+// Column buffer of the overlap: 2 columns of a subblock and of its overlap
+#define GRAIN_COL_BUF_SIZE ((32 + 2) * 2)
 
-static uint16_t random_register = 0;  // random number generator register
 
 
 //----------------------------------------------------------------------
@@ -302,252 +303,137 @@ void aom_free(void *memblk) {
 //--------------------------------------------------------------------
 
 
-
-static void init_arrays(aom_film_grain_t *params, int32_t luma_stride,
-    int32_t chroma_stride, int32_t ***pred_pos_luma_p,
-    int32_t ***pred_pos_chroma_p, int32_t **luma_grain_block,
-    int32_t **cb_grain_block, int32_t **cr_grain_block,
-    int32_t **y_line_buf, int32_t **cb_line_buf, int32_t **cr_line_buf,
-    int32_t **y_col_buf, int32_t **cb_col_buf, int32_t **cr_col_buf,
-    int32_t luma_grain_samples, int32_t chroma_grain_samples,
-    int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
-    memset(scaling_lut_y, 0, sizeof(*scaling_lut_y) * 256);
-    memset(scaling_lut_cb, 0, sizeof(*scaling_lut_cb) * 256);
-    memset(scaling_lut_cr, 0, sizeof(*scaling_lut_cr) * 256);
-
-    int32_t num_pos_luma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
-    int32_t num_pos_chroma = num_pos_luma;
-    if (params->num_y_points > 0) ++num_pos_chroma;
-
-    int32_t **pred_pos_luma;
-    int32_t **pred_pos_chroma;
-
-    pred_pos_luma = (int32_t**)malloc(sizeof(*pred_pos_luma) * num_pos_luma);
-    ASSERT(pred_pos_luma != NULL);
-    for (int32_t row = 0; row < num_pos_luma; row++) {
-        pred_pos_luma[row] = (int32_t *)malloc(sizeof(**pred_pos_luma) * 3);
-        ASSERT(pred_pos_luma[row]);
-    }
-
-    pred_pos_chroma =
-        (int32_t **)malloc(sizeof(*pred_pos_chroma) * num_pos_chroma);
-    ASSERT(pred_pos_chroma != NULL);
-    for (int32_t row = 0; row < num_pos_chroma; row++) {
-        pred_pos_chroma[row] = (int32_t *)malloc(sizeof(**pred_pos_chroma) * 3);
-        ASSERT(pred_pos_chroma[row]);
-    }
-
-    int32_t pos_ar_index = 0;
-
-    for (int32_t row = -params->ar_coeff_lag; row < 0; row++) {
-        for (int32_t col = -params->ar_coeff_lag; col < params->ar_coeff_lag + 1;
-            col++) {
-            pred_pos_luma[pos_ar_index][0] = row;
-            pred_pos_luma[pos_ar_index][1] = col;
-            pred_pos_luma[pos_ar_index][2] = 0;
-
-            pred_pos_chroma[pos_ar_index][0] = row;
-            pred_pos_chroma[pos_ar_index][1] = col;
-            pred_pos_chroma[pos_ar_index][2] = 0;
-            ++pos_ar_index;
-        }
-    }
-
-    for (int32_t col = -params->ar_coeff_lag; col < 0; col++) {
-        pred_pos_luma[pos_ar_index][0] = 0;
-        pred_pos_luma[pos_ar_index][1] = col;
-        pred_pos_luma[pos_ar_index][2] = 0;
-
-        pred_pos_chroma[pos_ar_index][0] = 0;
-        pred_pos_chroma[pos_ar_index][1] = col;
-        pred_pos_chroma[pos_ar_index][2] = 0;
-
-        ++pos_ar_index;
-    }
-
-    if (params->num_y_points > 0) {
-        pred_pos_chroma[pos_ar_index][0] = 0;
-        pred_pos_chroma[pos_ar_index][1] = 0;
-        pred_pos_chroma[pos_ar_index][2] = 1;
-    }
-
-    *pred_pos_luma_p = pred_pos_luma;
-    *pred_pos_chroma_p = pred_pos_chroma;
-
-    *y_line_buf = (int32_t *)malloc(sizeof(**y_line_buf) * luma_stride * 2);
-    *cb_line_buf = (int32_t *)malloc(sizeof(**cb_line_buf) * chroma_stride *
-        (2 >> chroma_subsamp_y));
-    *cr_line_buf = (int32_t *)malloc(sizeof(**cr_line_buf) * chroma_stride *
-        (2 >> chroma_subsamp_y));
-
-    *y_col_buf =
-        (int32_t *)malloc(sizeof(**y_col_buf) * (luma_subblock_size_y + 2) * 2);
-    *cb_col_buf =
-        (int32_t *)malloc(sizeof(**cb_col_buf) *
-        (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-            (2 >> chroma_subsamp_x));
-    *cr_col_buf =
-        (int32_t *)malloc(sizeof(**cr_col_buf) *
-        (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-            (2 >> chroma_subsamp_x));
-
-    *luma_grain_block =
-        (int32_t *)malloc(sizeof(**luma_grain_block) * luma_grain_samples);
-    *cb_grain_block =
-        (int32_t *)malloc(sizeof(**cb_grain_block) * chroma_grain_samples);
-    *cr_grain_block =
-        (int32_t *)malloc(sizeof(**cr_grain_block) * chroma_grain_samples);
-}
-
-static void dealloc_arrays(aom_film_grain_t *params, int32_t ***pred_pos_luma,
-    int32_t ***pred_pos_chroma, int32_t **luma_grain_block,
-    int32_t **cb_grain_block, int32_t **cr_grain_block,
-    int32_t **y_line_buf, int32_t **cb_line_buf,
-    int32_t **cr_line_buf, int32_t **y_col_buf, int32_t **cb_col_buf,
-    int32_t **cr_col_buf) {
-    int32_t num_pos_luma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
-    int32_t num_pos_chroma = num_pos_luma + 1;
-
-    for (int32_t row = 0; row < num_pos_luma; row++) {
-        free((*pred_pos_luma)[row]);
-    }
-    free(*pred_pos_luma);
-
-    for (int32_t row = 0; row < num_pos_chroma; row++) {
-        free((*pred_pos_chroma)[row]);
-    }
-    free((*pred_pos_chroma));
-
-    free(*y_line_buf);
-
-    free(*cb_line_buf);
-
-    free(*cr_line_buf);
-
-    free(*y_col_buf);
-
-    free(*cb_col_buf);
-
-    free(*cr_col_buf);
-
-    free(*luma_grain_block);
-
-    free(*cb_grain_block);
-
-    free(*cr_grain_block);
-}
-
 // get a number between 0 and 2^bits - 1
-static INLINE int32_t get_random_number(int32_t bits) {
+static INLINE int32_t get_random_number(uint16_t *random_register, int32_t bits) {
     uint16_t bit;
-    bit = ((random_register >> 0) ^ (random_register >> 1) ^
-        (random_register >> 3) ^ (random_register >> 12)) &
+    bit = ((*random_register >> 0) ^ (*random_register >> 1) ^
+        (*random_register >> 3) ^ (*random_register >> 12)) &
         1;
-    random_register = (random_register >> 1) | (bit << 15);
-    return (random_register >> (16 - bits)) & ((1 << bits) - 1);
+    *random_register = (*random_register >> 1) | (bit << 15);
+    return (*random_register >> (16 - bits)) & ((1 << bits) - 1);
 }
 
-static void init_random_generator(int32_t luma_line, uint16_t seed) {
+static uint16_t init_random_generator(int32_t luma_line, uint16_t seed) {
     // same for the picture
 
     uint16_t msb = (seed >> 8) & 255;
     uint16_t lsb = seed & 255;
 
-    random_register = (msb << 8) + lsb;
+    uint16_t random_register = (msb << 8) + lsb;
 
     //  changes for each row
     int32_t luma_num = luma_line >> 5;
 
     random_register ^= ((luma_num * 37 + 178) & 255) << 8;
     random_register ^= ((luma_num * 173 + 105) & 255);
+
+    return random_register;
 }
 
-static void generate_luma_grain_block(
-    aom_film_grain_t *params, int32_t **pred_pos_luma, int32_t *luma_grain_block,
-    int32_t luma_block_size_y, int32_t luma_block_size_x, int32_t luma_grain_stride,
-    int32_t left_pad, int32_t top_pad, int32_t right_pad, int32_t bottom_pad) {
+static void generate_gaussian_block(int32_t *grain_block, int32_t block_size_y,
+    int32_t block_size_x, int32_t grain_stride, int32_t gauss_sec_shift,
+    uint16_t *random_register) {
+    for (int32_t i = 0; i < block_size_y; i++)
+        for (int32_t j = 0; j < block_size_x; j++)
+            grain_block[i * grain_stride + j] =
+            (gaussian_sequence[get_random_number(random_register, gauss_bits)] +
+            ((1 << gauss_sec_shift) >> 1)) >>
+            gauss_sec_shift;
+}
+
+// The AR filter runs over the rows of the template: fgn_ar_row_sum() sums
+// the taps of the rows above for the whole row, then the taps to the left on
+// the row are added sample by sample, as they depend on the filtered samples
+static void generate_luma_grain_block(aom_film_grain_synth_t *fgs,
+    int32_t luma_block_size_y, int32_t luma_block_size_x) {
+    const aom_film_grain_t *params = &fgs->params;
+    int32_t *luma_grain_block = fgs->luma_grain_block;
+    int32_t luma_grain_stride = fgs->luma_grain_stride;
+
     if (params->num_y_points == 0) return;
 
     int32_t bit_depth = params->bit_depth;
     int32_t gauss_sec_shift = 12 - bit_depth + params->grain_scale_shift;
 
-    int32_t num_pos_luma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
+    int32_t lag = params->ar_coeff_lag;
+    int32_t num_pos_above = lag * (2 * lag + 1);
     int32_t rounding_offset = (1 << (params->ar_coeff_shift - 1));
+    int32_t wsum[FILM_GRAIN_BLOCK_WIDTH];
 
-    for (int32_t i = 0; i < luma_block_size_y; i++)
-        for (int32_t j = 0; j < luma_block_size_x; j++)
-            luma_grain_block[i * luma_grain_stride + j] =
-            (gaussian_sequence[get_random_number(gauss_bits)] +
-            ((1 << gauss_sec_shift) >> 1)) >>
-            gauss_sec_shift;
+    uint16_t random_register = params->random_seed;
+
+    generate_gaussian_block(luma_grain_block, luma_block_size_y,
+        luma_block_size_x, luma_grain_stride, gauss_sec_shift,
+        &random_register);
+
+    for (int32_t i = top_pad; i < luma_block_size_y - bottom_pad; i++) {
+        int32_t *grain_row = luma_grain_block + i * luma_grain_stride;
+
+        fgn_ar_row_sum(grain_row + left_pad, luma_grain_stride,
+            params->ar_coeffs_y, lag, luma_block_size_x - left_pad - right_pad,
+            wsum);
 
-    for (int32_t i = top_pad; i < luma_block_size_y - bottom_pad; i++)
         for (int32_t j = left_pad; j < luma_block_size_x - right_pad; j++) {
-            int32_t wsum = 0;
-            for (int32_t pos = 0; pos < num_pos_luma; pos++) {
-                wsum = wsum + params->ar_coeffs_y[pos] *
-                    luma_grain_block[(i + pred_pos_luma[pos][0]) *
-                    luma_grain_stride +
-                    j + pred_pos_luma[pos][1]];
-            }
-            luma_grain_block[i * luma_grain_stride + j] =
-                clamp(luma_grain_block[i * luma_grain_stride + j] +
-                ((wsum + rounding_offset) >> params->ar_coeff_shift),
-                    grain_min, grain_max);
+            int32_t sum = wsum[j - left_pad];
+            for (int32_t pos = 0; pos < lag; pos++)
+                sum += params->ar_coeffs_y[num_pos_above + pos] *
+                grain_row[j - lag + pos];
+            grain_row[j] =
+                clamp(grain_row[j] +
+                ((sum + rounding_offset) >> params->ar_coeff_shift),
+                    fgs->grain_min, fgs->grain_max);
         }
+    }
 }
 
-static void generate_chroma_grain_blocks(
-    aom_film_grain_t *params,
-    //                                  int32_t** pred_pos_luma,
-    int32_t **pred_pos_chroma, int32_t *luma_grain_block, int32_t *cb_grain_block,
-    int32_t *cr_grain_block, int32_t luma_grain_stride, int32_t chroma_block_size_y,
-    int32_t chroma_block_size_x, int32_t chroma_grain_stride, int32_t left_pad, int32_t top_pad,
-    int32_t right_pad, int32_t bottom_pad, int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
+static void generate_chroma_grain_blocks(aom_film_grain_synth_t *fgs,
+    int32_t chroma_block_size_y, int32_t chroma_block_size_x) {
+    const aom_film_grain_t *params = &fgs->params;
+    int32_t chroma_subsamp_y = fgs->chroma_subsamp_y;
+    int32_t chroma_subsamp_x = fgs->chroma_subsamp_x;
+    int32_t luma_grain_stride = fgs->luma_grain_stride;
+    int32_t chroma_grain_stride = fgs->chroma_grain_stride;
+
     int32_t bit_depth = params->bit_depth;
     int32_t gauss_sec_shift = 12 - bit_depth + params->grain_scale_shift;
 
-    int32_t num_pos_chroma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
-    if (params->num_y_points > 0) ++num_pos_chroma;
+    int32_t lag = params->ar_coeff_lag;
+    int32_t num_pos_above = lag * (2 * lag + 1);
+    // the luma tap follows the taps to the left
+    int32_t luma_pos = num_pos_above + lag;
     int32_t rounding_offset = (1 << (params->ar_coeff_shift - 1));
+    int32_t wsum[FILM_GRAIN_BLOCK_WIDTH];
 
-    if (params->num_cb_points) {
-        init_random_generator(7 << 5, params->random_seed);
+    int32_t *grain_blocks[2] = { fgs->cb_grain_block, fgs->cr_grain_block };
+    const int32_t *ar_coeffs[2] = { params->ar_coeffs_cb, params->ar_coeffs_cr };
+    const int32_t num_points[2] = { params->num_cb_points, params->num_cr_points };
+    const int32_t random_lines[2] = { 7 << 5, 11 << 5 };
 
-        for (int32_t i = 0; i < chroma_block_size_y; i++)
-            for (int32_t j = 0; j < chroma_block_size_x; j++)
-                cb_grain_block[i * chroma_grain_stride + j] =
-                (gaussian_sequence[get_random_number(gauss_bits)] +
-                ((1 << gauss_sec_shift) >> 1)) >>
-                gauss_sec_shift;
-    }
-    if (params->num_cr_points) {
-        init_random_generator(11 << 5, params->random_seed);
-
-        for (int32_t i = 0; i < chroma_block_size_y; i++)
-            for (int32_t j = 0; j < chroma_block_size_x; j++)
-                cr_grain_block[i * chroma_grain_stride + j] =
-                (gaussian_sequence[get_random_number(gauss_bits)] +
-                ((1 << gauss_sec_shift) >> 1)) >>
-                gauss_sec_shift;
-    }
+    for (int32_t plane = 0; plane < 2; plane++) {
+        int32_t *grain_block = grain_blocks[plane];
+        const int32_t *coeffs = ar_coeffs[plane];
 
-    for (int32_t i = top_pad; i < chroma_block_size_y - bottom_pad; i++)
-        for (int32_t j = left_pad; j < chroma_block_size_x - right_pad; j++) {
-            int32_t wsum_cb = 0;
-            int32_t wsum_cr = 0;
-            for (int32_t pos = 0; pos < num_pos_chroma; pos++) {
-                if (pred_pos_chroma[pos][2] == 0) {
-                    wsum_cb = wsum_cb + params->ar_coeffs_cb[pos] *
-                        cb_grain_block[(i + pred_pos_chroma[pos][0]) *
-                        chroma_grain_stride +
-                        j + pred_pos_chroma[pos][1]];
-                    wsum_cr = wsum_cr + params->ar_coeffs_cr[pos] *
-                        cr_grain_block[(i + pred_pos_chroma[pos][0]) *
-                        chroma_grain_stride +
-                        j + pred_pos_chroma[pos][1]];
-                }
-                else if (pred_pos_chroma[pos][2] == 1) {
+        if (num_points[plane] == 0) continue;
+
+        uint16_t random_register =
+            init_random_generator(random_lines[plane], params->random_seed);
+
+        generate_gaussian_block(grain_block, chroma_block_size_y,
+            chroma_block_size_x, chroma_grain_stride, gauss_sec_shift,
+            &random_register);
+
+        for (int32_t i = top_pad; i < chroma_block_size_y - bottom_pad; i++) {
+            int32_t *grain_row = grain_block + i * chroma_grain_stride;
+
+            fgn_ar_row_sum(grain_row + left_pad, chroma_grain_stride, coeffs,
+                lag, chroma_block_size_x - left_pad - right_pad, wsum);
+
+            for (int32_t j = left_pad; j < chroma_block_size_x - right_pad; j++) {
+                int32_t sum = wsum[j - left_pad];
+                for (int32_t pos = 0; pos < lag; pos++)
+                    sum += coeffs[num_pos_above + pos] * grain_row[j - lag + pos];
+
+                if (params->num_y_points > 0) {
                     int32_t av_luma = 0;
                     int32_t luma_coord_y = ((i - top_pad) << chroma_subsamp_y) + top_pad;
                     int32_t luma_coord_x = ((j - left_pad) << chroma_subsamp_x) + left_pad;
@@ -556,36 +442,25 @@ static void generate_chroma_grain_blocks(
                         k++)
                         for (int32_t l = luma_coord_x; l < luma_coord_x + chroma_subsamp_x + 1;
                             l++)
-                            av_luma += luma_grain_block[k * luma_grain_stride + l];
+                            av_luma += fgs->luma_grain_block[k * luma_grain_stride + l];
 
                     av_luma =
                         (av_luma + ((1 << (chroma_subsamp_y + chroma_subsamp_x)) >> 1)) >>
                         (chroma_subsamp_y + chroma_subsamp_x);
 
-                    wsum_cb = wsum_cb + params->ar_coeffs_cb[pos] * av_luma;
-                    wsum_cr = wsum_cr + params->ar_coeffs_cr[pos] * av_luma;
-                }
-                else {
-                    printf(
-                        "Grain synthesis: prediction between two chroma components is "
-                        "not supported!");
-                    exit(1);
+                    sum += coeffs[luma_pos] * av_luma;
                 }
+
+                grain_row[j] =
+                    clamp(grain_row[j] +
+                    ((sum + rounding_offset) >> params->ar_coeff_shift),
+                        fgs->grain_min, fgs->grain_max);
             }
-            if (params->num_cb_points)
-                cb_grain_block[i * chroma_grain_stride + j] =
-                clamp(cb_grain_block[i * chroma_grain_stride + j] +
-                ((wsum_cb + rounding_offset) >> params->ar_coeff_shift),
-                    grain_min, grain_max);
-            if (params->num_cr_points)
-                cr_grain_block[i * chroma_grain_stride + j] =
-                clamp(cr_grain_block[i * chroma_grain_stride + j] +
-                ((wsum_cr + rounding_offset) >> params->ar_coeff_shift),
-                    grain_min, grain_max);
         }
+    }
 }
 
-static void init_scaling_function(int32_t scaling_points[][2], int32_t num_points,
+static void init_scaling_function(const int32_t scaling_points[][2], int32_t num_points,
     int32_t scaling_lut[]) {
     if (num_points == 0) return;
 
@@ -610,7 +485,7 @@ static void init_scaling_function(int32_t scaling_points[][2], int32_t num_point
 
 // function that extracts samples from a LUT (and interpolates intemediate
 // frames for 10- and 12-bit video)
-static int32_t scale_LUT(int32_t *scaling_lut, int32_t index, int32_t bit_depth) {
+static INLINE int32_t scale_LUT(const int32_t *scaling_lut, int32_t index, int32_t bit_depth) {
     int32_t x = index >> (bit_depth - 8);
 
     if (!(bit_depth - 8) || x == 255)
@@ -622,222 +497,181 @@ static int32_t scale_LUT(int32_t *scaling_lut, int32_t index, int32_t bit_depth)
             (bit_depth - 8));
 }
 
-static void add_noise_to_block(aom_film_grain_t *params, uint8_t *luma,
-    uint8_t *cb, uint8_t *cr, int32_t luma_stride,
-    int32_t chroma_stride, int32_t *luma_grain,
-    int32_t *cb_grain, int32_t *cr_grain,
-    int32_t luma_grain_stride, int32_t chroma_grain_stride,
-    int32_t half_luma_height, int32_t half_luma_width,
-    int32_t bit_depth, int32_t chroma_subsamp_y,
-    int32_t chroma_subsamp_x) {
-    int32_t cb_mult = params->cb_mult - 128;            // fixed scale
-    int32_t cb_luma_mult = params->cb_luma_mult - 128;  // fixed scale
-    int32_t cb_offset = params->cb_offset - 256;
-
-    int32_t cr_mult = params->cr_mult - 128;            // fixed scale
-    int32_t cr_luma_mult = params->cr_luma_mult - 128;  // fixed scale
-    int32_t cr_offset = params->cr_offset - 256;
-
-    int32_t rounding_offset = (1 << (params->scaling_shift - 1));
-
-    int32_t apply_y = params->num_y_points > 0 ? 1 : 0;
-    int32_t apply_cb = params->num_cb_points > 0 ? 1 : 0;
-    int32_t apply_cr = params->num_cr_points > 0 ? 1 : 0;
-
-    if (params->chroma_scaling_from_luma) {
-        cb_mult = 0;        // fixed scale
-        cb_luma_mult = 64;  // fixed scale
-        cb_offset = 0;
-
-        cr_mult = 0;        // fixed scale
-        cr_luma_mult = 64;  // fixed scale
-        cr_offset = 0;
+void fgn_ar_row_sum_c(const int32_t *grain, int32_t grain_stride,
+    const int32_t *ar_coeffs, int32_t lag, int32_t width, int32_t *wsum) {
+    for (int32_t j = 0; j < width; j++) {
+        int32_t sum = 0;
+        int32_t pos = 0;
+        for (int32_t row = -lag; row < 0; row++)
+            for (int32_t col = -lag; col <= lag; col++)
+                sum += ar_coeffs[pos++] * grain[row * grain_stride + j + col];
+        wsum[j] = sum;
     }
+}
 
-    int32_t min_luma, max_luma, min_chroma, max_chroma;
-
-    if (params->clip_to_restricted_range) {
-        min_luma = min_luma_legal_range;
-        max_luma = max_luma_legal_range;
-
-        min_chroma = min_chroma_legal_range;
-        max_chroma = max_chroma_legal_range;
-    }
-    else {
-        min_luma = min_chroma = 0;
-        max_luma = max_chroma = 255;
+void fgn_luma_noise_row_c(uint8_t *luma, const int32_t *grain, int32_t width,
+    const int32_t *scaling_lut, int32_t scaling_shift, int32_t min_luma,
+    int32_t max_luma) {
+    int32_t rounding_offset = (1 << (scaling_shift - 1));
+
+    for (int32_t j = 0; j < width; j++) {
+        luma[j] = (uint8_t)clamp(luma[j] +
+            ((scale_LUT(scaling_lut, luma[j], 8) * grain[j] +
+                rounding_offset) >>
+                scaling_shift),
+            min_luma, max_luma);
     }
+}
 
-    for (int32_t i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-        for (int32_t j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
-            int32_t average_luma = 0;
-            if (chroma_subsamp_x) {
-                average_luma = (luma[(i << chroma_subsamp_y) * luma_stride +
-                    (j << chroma_subsamp_x)] +
-                    luma[(i << chroma_subsamp_y) * luma_stride +
-                    (j << chroma_subsamp_x) + 1] +
-                    1) >>
-                    1;
-            }
-            else {
-                average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-            }
-
-            if (apply_cb) {
-                cb[i * chroma_stride + j] = clamp(
-                    cb[i * chroma_stride + j] +
-                    ((scale_LUT(scaling_lut_cb,
-                        clamp(((average_luma * cb_luma_mult +
-                            cb_mult * cb[i * chroma_stride + j]) >>
-                            6) +
-                            cb_offset,
-                            0, (256 << (bit_depth - 8)) - 1),
-                        8) *
-                        cb_grain[i * chroma_grain_stride + j] +
-                        rounding_offset) >>
-                        params->scaling_shift),
-                    min_chroma, max_chroma);
-            }
-
-            if (apply_cr) {
-                cr[i * chroma_stride + j] = clamp(
-                    cr[i * chroma_stride + j] +
-                    ((scale_LUT(scaling_lut_cr,
-                        clamp(((average_luma * cr_luma_mult +
-                            cr_mult * cr[i * chroma_stride + j]) >>
-                            6) +
-                            cr_offset,
-                            0, (256 << (bit_depth - 8)) - 1),
-                        8) *
-                        cr_grain[i * chroma_grain_stride + j] +
-                        rounding_offset) >>
-                        params->scaling_shift),
-                    min_chroma, max_chroma);
-            }
-        }
+void fgn_luma_noise_row_hbd_c(uint16_t *luma, const int32_t *grain,
+    int32_t width, const int32_t *scaling_lut, int32_t bit_depth,
+    int32_t scaling_shift, int32_t min_luma, int32_t max_luma) {
+    int32_t rounding_offset = (1 << (scaling_shift - 1));
+
+    for (int32_t j = 0; j < width; j++) {
+        luma[j] = (uint16_t)clamp(luma[j] +
+            ((scale_LUT(scaling_lut, luma[j], bit_depth) * grain[j] +
+                rounding_offset) >>
+                scaling_shift),
+            min_luma, max_luma);
     }
+}
 
-    if (apply_y) {
-        for (int32_t i = 0; i < (half_luma_height << 1); i++) {
-            for (int32_t j = 0; j < (half_luma_width << 1); j++) {
-                luma[i * luma_stride + j] =
-                    clamp(luma[i * luma_stride + j] +
-                    ((scale_LUT(scaling_lut_y, luma[i * luma_stride + j], 8) *
-                        luma_grain[i * luma_grain_stride + j] +
-                        rounding_offset) >>
-                        params->scaling_shift),
-                        min_luma, max_luma);
-            }
-        }
+void fgn_chroma_noise_row_c(uint8_t *chroma, const uint8_t *luma,
+    const int32_t *grain, int32_t width, const int32_t *scaling_lut,
+    int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset,
+    int32_t scaling_shift, int32_t min_chroma, int32_t max_chroma) {
+    int32_t rounding_offset = (1 << (scaling_shift - 1));
+
+    for (int32_t j = 0; j < width; j++) {
+        int32_t average_luma = 0;
+        if (chroma_subsamp_x)
+            average_luma = (luma[j << 1] + luma[(j << 1) + 1] + 1) >> 1;
+        else
+            average_luma = luma[j];
+
+        chroma[j] = (uint8_t)clamp(
+            chroma[j] +
+            ((scale_LUT(scaling_lut,
+                clamp(((average_luma * luma_mult + mult * chroma[j]) >> 6) +
+                    offset,
+                    0, 255),
+                8) *
+                grain[j] +
+                rounding_offset) >>
+                scaling_shift),
+            min_chroma, max_chroma);
     }
 }
 
-static void add_noise_to_block_hbd(
-    aom_film_grain_t *params, uint16_t *luma, uint16_t *cb, uint16_t *cr,
-    int32_t luma_stride, int32_t chroma_stride, int32_t *luma_grain, int32_t *cb_grain,
-    int32_t *cr_grain, int32_t luma_grain_stride, int32_t chroma_grain_stride,
-    int32_t half_luma_height, int32_t half_luma_width, int32_t bit_depth,
-    int32_t chroma_subsamp_y, int32_t chroma_subsamp_x) {
-    int32_t cb_mult = params->cb_mult - 128;            // fixed scale
-    int32_t cb_luma_mult = params->cb_luma_mult - 128;  // fixed scale
-    // offset value depends on the bit depth
-    int32_t cb_offset = (params->cb_offset << (bit_depth - 8)) - (1 << bit_depth);
-
-    int32_t cr_mult = params->cr_mult - 128;            // fixed scale
-    int32_t cr_luma_mult = params->cr_luma_mult - 128;  // fixed scale
-    // offset value depends on the bit depth
-    int32_t cr_offset = (params->cr_offset << (bit_depth - 8)) - (1 << bit_depth);
+void fgn_chroma_noise_row_hbd_c(uint16_t *chroma, const uint16_t *luma,
+    const int32_t *grain, int32_t width, const int32_t *scaling_lut,
+    int32_t chroma_subsamp_x, int32_t mult, int32_t luma_mult, int32_t offset,
+    int32_t bit_depth, int32_t scaling_shift, int32_t min_chroma,
+    int32_t max_chroma) {
+    int32_t rounding_offset = (1 << (scaling_shift - 1));
+
+    for (int32_t j = 0; j < width; j++) {
+        int32_t average_luma = 0;
+        if (chroma_subsamp_x)
+            average_luma = (luma[j << 1] + luma[(j << 1) + 1] + 1) >> 1;
+        else
+            average_luma = luma[j];
+
+        chroma[j] = (uint16_t)clamp(
+            chroma[j] +
+            ((scale_LUT(scaling_lut,
+                clamp(((average_luma * luma_mult + mult * chroma[j]) >> 6) +
+                    offset,
+                    0, (256 << (bit_depth - 8)) - 1),
+                bit_depth) *
+                grain[j] +
+                rounding_offset) >>
+                scaling_shift),
+            min_chroma, max_chroma);
+    }
+}
 
-    int32_t rounding_offset = (1 << (params->scaling_shift - 1));
+// Adds the noise to the block at (y, x), in units of 2 luma samples. The
+// chroma is processed first, as it is scaled by the luma without noise
+static void add_noise_to_block(const aom_film_grain_synth_t *fgs,
+    uint8_t *luma, uint8_t *cb, uint8_t *cr, int32_t luma_stride,
+    int32_t chroma_stride, int32_t y, int32_t x, const int32_t *luma_grain,
+    const int32_t *cb_grain, const int32_t *cr_grain,
+    int32_t luma_grain_stride, int32_t chroma_grain_stride,
+    int32_t half_luma_height, int32_t half_luma_width) {
+    const aom_film_grain_t *params = &fgs->params;
+    int32_t chroma_subsamp_y = fgs->chroma_subsamp_y;
+    int32_t chroma_subsamp_x = fgs->chroma_subsamp_x;
+    int32_t bit_depth = params->bit_depth;
 
     int32_t apply_y = params->num_y_points > 0 ? 1 : 0;
     int32_t apply_cb = params->num_cb_points > 0 ? 1 : 0;
     int32_t apply_cr = params->num_cr_points > 0 ? 1 : 0;
 
-    if (params->chroma_scaling_from_luma) {
-        cb_mult = 0;        // fixed scale
-        cb_luma_mult = 64;  // fixed scale
-        cb_offset = 0;
-
-        cr_mult = 0;        // fixed scale
-        cr_luma_mult = 64;  // fixed scale
-        cr_offset = 0;
-    }
-
-    int32_t min_luma, max_luma, min_chroma, max_chroma;
-
-    if (params->clip_to_restricted_range) {
-        min_luma = min_luma_legal_range << (bit_depth - 8);
-        max_luma = max_luma_legal_range << (bit_depth - 8);
+    int32_t luma_offset = (y << 1) * luma_stride + (x << 1);
+    int32_t chroma_offset = (y << (1 - chroma_subsamp_y)) * chroma_stride +
+        (x << (1 - chroma_subsamp_x));
+    int32_t chroma_height = half_luma_height << (1 - chroma_subsamp_y);
+    int32_t chroma_width = half_luma_width << (1 - chroma_subsamp_x);
+
+    if (fgs->use_high_bit_depth) {
+        uint16_t *luma16 = (uint16_t *)luma + luma_offset;
+        uint16_t *cb16 = (uint16_t *)cb + chroma_offset;
+        uint16_t *cr16 = (uint16_t *)cr + chroma_offset;
+
+        for (int32_t i = 0; i < chroma_height; i++) {
+            const uint16_t *luma_row =
+                luma16 + (i << chroma_subsamp_y) * luma_stride;
+            if (apply_cb)
+                fgn_chroma_noise_row_hbd(cb16 + i * chroma_stride, luma_row,
+                    cb_grain + i * chroma_grain_stride, chroma_width,
+                    fgs->scaling_lut_cb, chroma_subsamp_x, fgs->cb_mult,
+                    fgs->cb_luma_mult, fgs->cb_offset, bit_depth,
+                    params->scaling_shift, fgs->min_chroma, fgs->max_chroma);
+            if (apply_cr)
+                fgn_chroma_noise_row_hbd(cr16 + i * chroma_stride, luma_row,
+                    cr_grain + i * chroma_grain_stride, chroma_width,
+                    fgs->scaling_lut_cr, chroma_subsamp_x, fgs->cr_mult,
+                    fgs->cr_luma_mult, fgs->cr_offset, bit_depth,
+                    params->scaling_shift, fgs->min_chroma, fgs->max_chroma);
+        }
 
-        min_chroma = min_chroma_legal_range << (bit_depth - 8);
-        max_chroma = max_chroma_legal_range << (bit_depth - 8);
+        if (apply_y) {
+            for (int32_t i = 0; i < (half_luma_height << 1); i++)
+                fgn_luma_noise_row_hbd(luma16 + i * luma_stride,
+                    luma_grain + i * luma_grain_stride, half_luma_width << 1,
+                    fgs->scaling_lut_y, bit_depth, params->scaling_shift,
+                    fgs->min_luma, fgs->max_luma);
+        }
     }
     else {
-        min_luma = min_chroma = 0;
-        max_luma = max_chroma = (256 << (bit_depth - 8)) - 1;
-    }
-
-    for (int32_t i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-        for (int32_t j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
-            int32_t average_luma = 0;
-            if (chroma_subsamp_x) {
-                average_luma = (luma[(i << chroma_subsamp_y) * luma_stride +
-                    (j << chroma_subsamp_x)] +
-                    luma[(i << chroma_subsamp_y) * luma_stride +
-                    (j << chroma_subsamp_x) + 1] +
-                    1) >>
-                    1;
-            }
-            else {
-                average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-            }
-
-            if (apply_cb) {
-                cb[i * chroma_stride + j] = clamp(
-                    cb[i * chroma_stride + j] +
-                    ((scale_LUT(scaling_lut_cb,
-                        clamp(((average_luma * cb_luma_mult +
-                            cb_mult * cb[i * chroma_stride + j]) >>
-                            6) +
-                            cb_offset,
-                            0, (256 << (bit_depth - 8)) - 1),
-                        bit_depth) *
-                        cb_grain[i * chroma_grain_stride + j] +
-                        rounding_offset) >>
-                        params->scaling_shift),
-                    min_chroma, max_chroma);
-            }
-            if (apply_cr) {
-                cr[i * chroma_stride + j] = clamp(
-                    cr[i * chroma_stride + j] +
-                    ((scale_LUT(scaling_lut_cr,
-                        clamp(((average_luma * cr_luma_mult +
-                            cr_mult * cr[i * chroma_stride + j]) >>
-                            6) +
-                            cr_offset,
-                            0, (256 << (bit_depth - 8)) - 1),
-                        bit_depth) *
-                        cr_grain[i * chroma_grain_stride + j] +
-                        rounding_offset) >>
-                        params->scaling_shift),
-                    min_chroma, max_chroma);
-            }
+        luma += luma_offset;
+        cb += chroma_offset;
+        cr += chroma_offset;
+
+        for (int32_t i = 0; i < chroma_height; i++) {
+            const uint8_t *luma_row = luma + (i << chroma_subsamp_y) * luma_stride;
+            if (apply_cb)
+                fgn_chroma_noise_row(cb + i * chroma_stride, luma_row,
+                    cb_grain + i * chroma_grain_stride, chroma_width,
+                    fgs->scaling_lut_cb, chroma_subsamp_x, fgs->cb_mult,
+                    fgs->cb_luma_mult, fgs->cb_offset, params->scaling_shift,
+                    fgs->min_chroma, fgs->max_chroma);
+            if (apply_cr)
+                fgn_chroma_noise_row(cr + i * chroma_stride, luma_row,
+                    cr_grain + i * chroma_grain_stride, chroma_width,
+                    fgs->scaling_lut_cr, chroma_subsamp_x, fgs->cr_mult,
+                    fgs->cr_luma_mult, fgs->cr_offset, params->scaling_shift,
+                    fgs->min_chroma, fgs->max_chroma);
         }
-    }
 
-    if (apply_y) {
-        for (int32_t i = 0; i < (half_luma_height << 1); i++) {
-            for (int32_t j = 0; j < (half_luma_width << 1); j++) {
-                luma[i * luma_stride + j] =
-                    clamp(luma[i * luma_stride + j] +
-                    ((scale_LUT(scaling_lut_y, luma[i * luma_stride + j],
-                        bit_depth) *
-                        luma_grain[i * luma_grain_stride + j] +
-                        rounding_offset) >>
-                        params->scaling_shift),
-                        min_luma, max_luma);
-            }
+        if (apply_y) {
+            for (int32_t i = 0; i < (half_luma_height << 1); i++)
+                fgn_luma_noise_row(luma + i * luma_stride,
+                    luma_grain + i * luma_grain_stride, half_luma_width << 1,
+                    fgs->scaling_lut_y, params->scaling_shift, fgs->min_luma,
+                    fgs->max_luma);
         }
     }
 }
@@ -917,7 +751,7 @@ void fgn_copy_rect(uint8_t *src, int32_t src_stride, uint8_t *dst,
     return;
 }
 
-static void copy_area(int32_t *src, int32_t src_stride, int32_t *dst, int32_t dst_stride,
+static void copy_area(const int32_t *src, int32_t src_stride, int32_t *dst, int32_t dst_stride,
     int32_t width, int32_t height) {
     while (height) {
         memcpy(dst, src, width * sizeof(*src));
@@ -928,10 +762,10 @@ static void copy_area(int32_t *src, int32_t src_stride, int32_t *dst, int32_t ds
     return;
 }
 
-static void ver_boundary_overlap(int32_t *left_block, int32_t left_stride,
-    int32_t *right_block, int32_t right_stride,
+static void ver_boundary_overlap(const int32_t *left_block, int32_t left_stride,
+    const int32_t *right_block, int32_t right_stride,
     int32_t *dst_block, int32_t dst_stride, int32_t width,
-    int32_t height) {
+    int32_t height, int32_t grain_min, int32_t grain_max) {
     if (width == 1) {
         while (height) {
             *dst_block = clamp((*left_block * 23 + *right_block * 22 + 16) >> 5,
@@ -958,10 +792,10 @@ static void ver_boundary_overlap(int32_t *left_block, int32_t left_stride,
     }
 }
 
-static void hor_boundary_overlap(int32_t *top_block, int32_t top_stride,
-    int32_t *bottom_block, int32_t bottom_stride,
+void fgn_hor_boundary_overlap_c(const int32_t *top_block, int32_t top_stride,
+    const int32_t *bottom_block, int32_t bottom_stride,
     int32_t *dst_block, int32_t dst_stride, int32_t width,
-    int32_t height) {
+    int32_t height, int32_t grain_min, int32_t grain_max) {
     if (height == 1) {
         while (width) {
             *dst_block = clamp((*top_block * 23 + *bottom_block * 22 + 16) >> 5,
@@ -990,41 +824,14 @@ static void hor_boundary_overlap(int32_t *top_block, int32_t top_stride,
     }
 }
 
-
-
-void av1_add_film_grain_run(aom_film_grain_t *params, uint8_t *luma,
-    uint8_t *cb, uint8_t *cr, int32_t height, int32_t width,
-    int32_t luma_stride, int32_t chroma_stride,
+void av1_film_grain_synth_init(aom_film_grain_synth_t *fgs,
+    const aom_film_grain_t *grain_params, int32_t height, int32_t width,
     int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
     int32_t chroma_subsamp_x) {
-    int32_t **pred_pos_luma;
-    int32_t **pred_pos_chroma;
-    int32_t *luma_grain_block;
-    int32_t *cb_grain_block;
-    int32_t *cr_grain_block;
-
-    int32_t *y_line_buf;
-    int32_t *cb_line_buf;
-    int32_t *cr_line_buf;
-
-    int32_t *y_col_buf;
-    int32_t *cb_col_buf;
-    int32_t *cr_col_buf;
-
-    random_register = params->random_seed;
+    const aom_film_grain_t *params = &fgs->params;
 
-    int32_t left_pad = 3;
-    int32_t right_pad = 3;  // padding to offset for AR coefficients
-    int32_t top_pad = 3;
-    int32_t bottom_pad = 0;
-
-    int32_t ar_padding = 3;  // maximum lag used for stabilization of AR coefficients
-
-    luma_subblock_size_y = 32;
-    luma_subblock_size_x = 32;
-
-    chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
-    chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+    int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+    int32_t chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
 
     // Initial padding is only needed for generation of
     // film grain templates (to stabilize the AR process)
@@ -1042,345 +849,482 @@ void av1_add_film_grain_run(aom_film_grain_t *params, uint8_t *luma,
         chroma_subblock_size_x * 2 +
         (2 >> chroma_subsamp_x) * ar_padding + right_pad;
 
-    int32_t luma_grain_stride = luma_block_size_x;
-    int32_t chroma_grain_stride = chroma_block_size_x;
+    int32_t bit_depth = grain_params->bit_depth;
 
-    int32_t overlap = params->overlap_flag;
-    int32_t bit_depth = params->bit_depth;
+    ASSERT(luma_block_size_y == FILM_GRAIN_BLOCK_HEIGHT);
+    ASSERT(luma_block_size_x == FILM_GRAIN_BLOCK_WIDTH);
 
-    grain_center = 128 << (bit_depth - 8);
-    grain_min = 0 - grain_center;
-    grain_max = (256 << (bit_depth - 8)) - 1 - grain_center;
-
-    init_arrays(params, luma_stride, chroma_stride, &pred_pos_luma,
-        &pred_pos_chroma, &luma_grain_block, &cb_grain_block,
-        &cr_grain_block, &y_line_buf, &cb_line_buf, &cr_line_buf,
-        &y_col_buf, &cb_col_buf, &cr_col_buf,
-        luma_block_size_y * luma_block_size_x,
-        chroma_block_size_y * chroma_block_size_x, chroma_subsamp_y,
-        chroma_subsamp_x);
-
-    generate_luma_grain_block(params, pred_pos_luma, luma_grain_block,
-        luma_block_size_y, luma_block_size_x,
-        luma_grain_stride, left_pad, top_pad, right_pad,
-        bottom_pad);
-
-    generate_chroma_grain_blocks(
-        params,
-        //                               pred_pos_luma,
-        pred_pos_chroma, luma_grain_block, cb_grain_block, cr_grain_block,
-        luma_grain_stride, chroma_block_size_y, chroma_block_size_x,
-        chroma_grain_stride, left_pad, top_pad, right_pad, bottom_pad,
-        chroma_subsamp_y, chroma_subsamp_x);
+    fgs->params = *grain_params;
+    fgs->width = width;
+    fgs->height = height;
+    fgs->use_high_bit_depth = use_high_bit_depth;
+    fgs->chroma_subsamp_y = chroma_subsamp_y;
+    fgs->chroma_subsamp_x = chroma_subsamp_x;
+    fgs->luma_grain_stride = luma_block_size_x;
+    fgs->chroma_grain_stride = chroma_block_size_x;
+
+    fgs->grain_min = 0 - (128 << (bit_depth - 8));
+    fgs->grain_max = (256 << (bit_depth - 8)) - 1 - (128 << (bit_depth - 8));
+
+    // The templates of the planes without grain are still copied to the
+    // overlap buffers
+    memset(fgs->luma_grain_block, 0, sizeof(fgs->luma_grain_block));
+    memset(fgs->cb_grain_block, 0, sizeof(fgs->cb_grain_block));
+    memset(fgs->cr_grain_block, 0, sizeof(fgs->cr_grain_block));
+
+    generate_luma_grain_block(fgs, luma_block_size_y, luma_block_size_x);
+
+    generate_chroma_grain_blocks(fgs, chroma_block_size_y,
+        chroma_block_size_x);
+
+    memset(fgs->scaling_lut_y, 0, sizeof(fgs->scaling_lut_y));
+    memset(fgs->scaling_lut_cb, 0, sizeof(fgs->scaling_lut_cb));
+    memset(fgs->scaling_lut_cr, 0, sizeof(fgs->scaling_lut_cr));
 
     init_scaling_function(params->scaling_points_y, params->num_y_points,
-        scaling_lut_y);
+        fgs->scaling_lut_y);
 
     if (params->chroma_scaling_from_luma) {
-        memcpy(scaling_lut_cb, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
-        memcpy(scaling_lut_cr, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
+        memcpy(fgs->scaling_lut_cb, fgs->scaling_lut_y, sizeof(fgs->scaling_lut_y));
+        memcpy(fgs->scaling_lut_cr, fgs->scaling_lut_y, sizeof(fgs->scaling_lut_y));
     }
     else {
         init_scaling_function(params->scaling_points_cb, params->num_cb_points,
-            scaling_lut_cb);
+            fgs->scaling_lut_cb);
         init_scaling_function(params->scaling_points_cr, params->num_cr_points,
-            scaling_lut_cr);
+            fgs->scaling_lut_cr);
     }
-    for (int32_t y = 0; y < height / 2; y += (luma_subblock_size_y >> 1)) {
-        init_random_generator(y * 2, params->random_seed);
-
-        for (int32_t x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
-            int32_t offset_y = get_random_number(8);
-            int32_t offset_x = (offset_y >> 4) & 15;
-            offset_y &= 15;
-
-            int32_t luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
-            int32_t luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
-
-            int32_t chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
-                offset_y * (2 >> chroma_subsamp_y);
-            int32_t chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
-                offset_x * (2 >> chroma_subsamp_x);
-
-            if (overlap && x) {
-                ver_boundary_overlap(
-                    y_col_buf, 2,
-                    luma_grain_block + luma_offset_y * luma_grain_stride +
-                    luma_offset_x,
-                    luma_grain_stride, y_col_buf, 2, 2,
-                    AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
-
-                ver_boundary_overlap(
-                    cb_col_buf, 2 >> chroma_subsamp_x,
-                    cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                    chroma_offset_x,
-                    chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
-                    2 >> chroma_subsamp_x,
-                    AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                    (height - (y << 1)) >> chroma_subsamp_y));
-
-                ver_boundary_overlap(
-                    cr_col_buf, 2 >> chroma_subsamp_x,
-                    cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                    chroma_offset_x,
-                    chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
-                    2 >> chroma_subsamp_x,
-                    AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                    (height - (y << 1)) >> chroma_subsamp_y));
-
-                int32_t i = y ? 1 : 0;
-
-                if (use_high_bit_depth) {
-                    add_noise_to_block_hbd(
-                        params,
-                        (uint16_t *)luma + ((y + i) << 1) * luma_stride + (x << 1),
-                        (uint16_t *)cb +
-                        ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        (x << (1 - chroma_subsamp_x)),
-                        (uint16_t *)cr +
-                        ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        (x << (1 - chroma_subsamp_x)),
-                        luma_stride, chroma_stride, y_col_buf + i * 4,
-                        cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        2, (2 - chroma_subsamp_x),
-                        AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i, 1,
-                        bit_depth, chroma_subsamp_y, chroma_subsamp_x);
-                }
-                else {
-                    add_noise_to_block(
-                        params, luma + ((y + i) << 1) * luma_stride + (x << 1),
-                        cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        (x << (1 - chroma_subsamp_x)),
-                        cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                        (x << (1 - chroma_subsamp_x)),
-                        luma_stride, chroma_stride, y_col_buf + i * 4,
-                        cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
-                        2, (2 - chroma_subsamp_x),
-                        AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i, 1,
-                        bit_depth, chroma_subsamp_y, chroma_subsamp_x);
-                }
-            }
+    fgs->scaling_lut_y[256] = fgs->scaling_lut_y[255];
+    fgs->scaling_lut_cb[256] = fgs->scaling_lut_cb[255];
+    fgs->scaling_lut_cr[256] = fgs->scaling_lut_cr[255];
 
-            if (overlap && y) {
-                if (x) {
-                    ASSERT(y_col_buf != NULL);
-                    hor_boundary_overlap(y_line_buf + (x << 1), luma_stride, y_col_buf, 2,
-                        y_line_buf + (x << 1), luma_stride, 2, 2);
-
-                    hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
-                        chroma_stride, cb_col_buf, 2 >> chroma_subsamp_x,
-                        cb_line_buf + x * (2 >> chroma_subsamp_x),
-                        chroma_stride, 2 >> chroma_subsamp_x,
-                        2 >> chroma_subsamp_y);
-
-                    hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
-                        chroma_stride, cr_col_buf, 2 >> chroma_subsamp_x,
-                        cr_line_buf + x * (2 >> chroma_subsamp_x),
-                        chroma_stride, 2 >> chroma_subsamp_x,
-                        2 >> chroma_subsamp_y);
-                }
+    fgs->cb_mult = params->cb_mult - 128;            // fixed scale
+    fgs->cb_luma_mult = params->cb_luma_mult - 128;  // fixed scale
+    // offset value depends on the bit depth
+    fgs->cb_offset = (params->cb_offset << (bit_depth - 8)) - (1 << bit_depth);
 
-                hor_boundary_overlap(
-                    y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-                    luma_grain_block + luma_offset_y * luma_grain_stride +
-                    luma_offset_x + (x ? 2 : 0),
-                    luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-                    AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
-                        width - ((x ? x + 1 : 0) << 1)),
-                    2);
-
-                hor_boundary_overlap(
-                    cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                    chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_grain_stride,
-                    cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    AOMMIN(chroma_subblock_size_x -
-                    ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                        (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-                    2 >> chroma_subsamp_y);
-
-                hor_boundary_overlap(
-                    cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                    chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_grain_stride,
-                    cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    AOMMIN(chroma_subblock_size_x -
-                    ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                        (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-                    2 >> chroma_subsamp_y);
-
-                if (use_high_bit_depth) {
-                    add_noise_to_block_hbd(
-                        params, (uint16_t *)luma + (y << 1) * luma_stride + (x << 1),
-                        (uint16_t *)cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                        (x << ((1 - chroma_subsamp_x))),
-                        (uint16_t *)cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                        (x << ((1 - chroma_subsamp_x))),
-                        luma_stride, chroma_stride, y_line_buf + (x << 1),
-                        cb_line_buf + (x << (1 - chroma_subsamp_x)),
-                        cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
-                        chroma_stride, 1,
-                        AOMMIN(luma_subblock_size_x >> 1, width / 2 - x), bit_depth,
-                        chroma_subsamp_y, chroma_subsamp_x);
-                }
-                else {
-                    add_noise_to_block(
-                        params, luma + (y << 1) * luma_stride + (x << 1),
-                        cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                        (x << ((1 - chroma_subsamp_x))),
-                        cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                        (x << ((1 - chroma_subsamp_x))),
-                        luma_stride, chroma_stride, y_line_buf + (x << 1),
-                        cb_line_buf + (x << (1 - chroma_subsamp_x)),
-                        cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
-                        chroma_stride, 1,
-                        AOMMIN(luma_subblock_size_x >> 1, width / 2 - x), bit_depth,
-                        chroma_subsamp_y, chroma_subsamp_x);
-                }
-            }
+    fgs->cr_mult = params->cr_mult - 128;            // fixed scale
+    fgs->cr_luma_mult = params->cr_luma_mult - 128;  // fixed scale
+    // offset value depends on the bit depth
+    fgs->cr_offset = (params->cr_offset << (bit_depth - 8)) - (1 << bit_depth);
 
-            int32_t i = overlap && y ? 1 : 0;
-            int32_t j = overlap && x ? 1 : 0;
-
-            if (use_high_bit_depth) {
-                add_noise_to_block_hbd(
-                    params,
-                    (uint16_t *)luma + ((y + i) << 1) * luma_stride + ((x + j) << 1),
-                    (uint16_t *)cb +
-                    ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                    ((x + j) << (1 - chroma_subsamp_x)),
-                    (uint16_t *)cr +
-                    ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                    ((x + j) << (1 - chroma_subsamp_x)),
-                    luma_stride, chroma_stride,
-                    luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
-                    luma_offset_x + (j << 1),
-                    cb_grain_block +
-                    (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
-                    chroma_grain_stride +
-                    chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    cr_grain_block +
-                    (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
-                    chroma_grain_stride +
-                    chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    luma_grain_stride, chroma_grain_stride,
-                    AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                    AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j, bit_depth,
-                    chroma_subsamp_y, chroma_subsamp_x);
-            }
-            else {
-                add_noise_to_block(
-                    params, luma + ((y + i) << 1) * luma_stride + ((x + j) << 1),
-                    cb + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                    ((x + j) << (1 - chroma_subsamp_x)),
-                    cr + ((y + i) << (1 - chroma_subsamp_y)) * chroma_stride +
-                    ((x + j) << (1 - chroma_subsamp_x)),
-                    luma_stride, chroma_stride,
-                    luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
-                    luma_offset_x + (j << 1),
-                    cb_grain_block +
-                    (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
-                    chroma_grain_stride +
-                    chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    cr_grain_block +
-                    (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
-                    chroma_grain_stride +
-                    chroma_offset_x + (j << (1 - chroma_subsamp_x)),
-                    luma_grain_stride, chroma_grain_stride,
-                    AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
-                    AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j, bit_depth,
-                    chroma_subsamp_y, chroma_subsamp_x);
+    if (params->chroma_scaling_from_luma) {
+        fgs->cb_mult = 0;        // fixed scale
+        fgs->cb_luma_mult = 64;  // fixed scale
+        fgs->cb_offset = 0;
+
+        fgs->cr_mult = 0;        // fixed scale
+        fgs->cr_luma_mult = 64;  // fixed scale
+        fgs->cr_offset = 0;
+    }
+
+    if (params->clip_to_restricted_range) {
+        fgs->min_luma = min_luma_legal_range << (bit_depth - 8);
+        fgs->max_luma = max_luma_legal_range << (bit_depth - 8);
+
+        fgs->min_chroma = min_chroma_legal_range << (bit_depth - 8);
+        fgs->max_chroma = max_chroma_legal_range << (bit_depth - 8);
+    }
+    else {
+        fgs->min_luma = fgs->min_chroma = 0;
+        fgs->max_luma = fgs->max_chroma = (256 << (bit_depth - 8)) - 1;
+    }
+}
+
+int32_t av1_film_grain_stripe_count(int32_t height) {
+    return AOMMAX(1, (height / 2 + (FILM_GRAIN_STRIPE_HEIGHT >> 1) - 1) /
+        (FILM_GRAIN_STRIPE_HEIGHT >> 1));
+}
+
+// Rebuilds the line buffers the stripe at y leaves for the overlap with the
+// stripe below: the bottom rows of its subblocks, blended with their left
+// neighbours. They only depend on the random offsets of the stripe.
+static void init_line_buffers(const aom_film_grain_synth_t *fgs, int32_t y,
+    int32_t *y_line_buf, int32_t *cb_line_buf, int32_t *cr_line_buf,
+    int32_t luma_stride, int32_t chroma_stride) {
+    const aom_film_grain_t *params = &fgs->params;
+    int32_t width = fgs->width;
+    int32_t chroma_subsamp_y = fgs->chroma_subsamp_y;
+    int32_t chroma_subsamp_x = fgs->chroma_subsamp_x;
+    int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+    int32_t chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+    int32_t luma_grain_stride = fgs->luma_grain_stride;
+    int32_t chroma_grain_stride = fgs->chroma_grain_stride;
+
+    // Bottom rows of the 2 right columns of the previous subblock
+    int32_t y_col_buf[4];
+    int32_t cb_col_buf[4];
+    int32_t cr_col_buf[4];
+
+    uint16_t random_register = init_random_generator(y * 2, params->random_seed);
+
+    for (int32_t x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
+        int32_t offset_y = get_random_number(&random_register, 8);
+        int32_t offset_x = (offset_y >> 4) & 15;
+        offset_y &= 15;
+
+        int32_t luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
+        int32_t luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
+
+        int32_t chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
+            offset_y * (2 >> chroma_subsamp_y);
+        int32_t chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
+            offset_x * (2 >> chroma_subsamp_x);
+
+        const int32_t *luma_bottom = fgs->luma_grain_block +
+            (luma_offset_y + luma_subblock_size_y) * luma_grain_stride + luma_offset_x;
+        const int32_t *cb_bottom = fgs->cb_grain_block +
+            (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
+            chroma_offset_x;
+        const int32_t *cr_bottom = fgs->cr_grain_block +
+            (chroma_offset_y + chroma_subblock_size_y) * chroma_grain_stride +
+            chroma_offset_x;
+
+        if (x) {
+            ver_boundary_overlap(y_col_buf, 2, luma_bottom, luma_grain_stride,
+                y_line_buf + (x << 1), luma_stride, 2, 2, fgs->grain_min,
+                fgs->grain_max);
+
+            ver_boundary_overlap(cb_col_buf, 2 >> chroma_subsamp_x, cb_bottom,
+                chroma_grain_stride, cb_line_buf + (x << (1 - chroma_subsamp_x)),
+                chroma_stride, 2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y,
+                fgs->grain_min, fgs->grain_max);
+
+            ver_boundary_overlap(cr_col_buf, 2 >> chroma_subsamp_x, cr_bottom,
+                chroma_grain_stride, cr_line_buf + (x << (1 - chroma_subsamp_x)),
+                chroma_stride, 2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y,
+                fgs->grain_min, fgs->grain_max);
+        }
+
+        copy_area(luma_bottom + (x ? 2 : 0), luma_grain_stride,
+            y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+            AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0), 2);
+
+        copy_area(cb_bottom + (x ? 2 >> chroma_subsamp_x : 0),
+            chroma_grain_stride,
+            cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+            chroma_stride,
+            AOMMIN(chroma_subblock_size_x,
+            ((width - (x << 1)) >> chroma_subsamp_x)) -
+                (x ? 2 >> chroma_subsamp_x : 0),
+            2 >> chroma_subsamp_y);
+
+        copy_area(cr_bottom + (x ? 2 >> chroma_subsamp_x : 0),
+            chroma_grain_stride,
+            cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+            chroma_stride,
+            AOMMIN(chroma_subblock_size_x,
+            ((width - (x << 1)) >> chroma_subsamp_x)) -
+                (x ? 2 >> chroma_subsamp_x : 0),
+            2 >> chroma_subsamp_y);
+
+        copy_area(luma_bottom + luma_subblock_size_x, luma_grain_stride,
+            y_col_buf, 2, 2, 2);
+
+        copy_area(cb_bottom + chroma_subblock_size_x, chroma_grain_stride,
+            cb_col_buf, 2 >> chroma_subsamp_x, 2 >> chroma_subsamp_x,
+            2 >> chroma_subsamp_y);
+
+        copy_area(cr_bottom + chroma_subblock_size_x, chroma_grain_stride,
+            cr_col_buf, 2 >> chroma_subsamp_x, 2 >> chroma_subsamp_x,
+            2 >> chroma_subsamp_y);
+    }
+}
+
+int32_t av1_add_film_grain_stripe(const aom_film_grain_synth_t *fgs,
+    uint8_t *luma, uint8_t *cb, uint8_t *cr, int32_t luma_stride,
+    int32_t chroma_stride, int32_t stripe) {
+    const aom_film_grain_t *params = &fgs->params;
+    const int32_t *luma_grain_block = fgs->luma_grain_block;
+    const int32_t *cb_grain_block = fgs->cb_grain_block;
+    const int32_t *cr_grain_block = fgs->cr_grain_block;
+
+    int32_t *y_line_buf;
+    int32_t *cb_line_buf;
+    int32_t *cr_line_buf;
+
+    int32_t y_col_buf[GRAIN_COL_BUF_SIZE];
+    int32_t cb_col_buf[GRAIN_COL_BUF_SIZE];
+    int32_t cr_col_buf[GRAIN_COL_BUF_SIZE];
+
+    int32_t height = fgs->height;
+    int32_t width = fgs->width;
+    int32_t chroma_subsamp_y = fgs->chroma_subsamp_y;
+    int32_t chroma_subsamp_x = fgs->chroma_subsamp_x;
+
+    int32_t chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+    int32_t chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+
+    int32_t luma_grain_stride = fgs->luma_grain_stride;
+    int32_t chroma_grain_stride = fgs->chroma_grain_stride;
+
+    int32_t overlap = params->overlap_flag;
+    int32_t grain_min = fgs->grain_min;
+    int32_t grain_max = fgs->grain_max;
+
+    int32_t y = stripe * (luma_subblock_size_y >> 1);
+    uint16_t random_register;
+
+    if (y >= height / 2) return 0;
+
+    y_line_buf = (int32_t *)malloc(sizeof(*y_line_buf) * luma_stride * 2);
+    cb_line_buf = (int32_t *)malloc(sizeof(*cb_line_buf) * chroma_stride *
+        (2 >> chroma_subsamp_y));
+    cr_line_buf = (int32_t *)malloc(sizeof(*cr_line_buf) * chroma_stride *
+        (2 >> chroma_subsamp_y));
+    if (y_line_buf == NULL || cb_line_buf == NULL || cr_line_buf == NULL) {
+        free(y_line_buf);
+        free(cb_line_buf);
+        free(cr_line_buf);
+        return -1;
+    }
+
+    if (overlap && y) {
+        init_line_buffers(fgs, y - (luma_subblock_size_y >> 1), y_line_buf,
+            cb_line_buf, cr_line_buf, luma_stride, chroma_stride);
+    }
+
+    random_register = init_random_generator(y * 2, params->random_seed);
+
+    for (int32_t x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
+        int32_t offset_y = get_random_number(&random_register, 8);
+        int32_t offset_x = (offset_y >> 4) & 15;
+        offset_y &= 15;
+
+        int32_t luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
+        int32_t luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
+
+        int32_t chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
+            offset_y * (2 >> chroma_subsamp_y);
+        int32_t chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
+            offset_x * (2 >> chroma_subsamp_x);
+
+        if (overlap && x) {
+            ver_boundary_overlap(
+                y_col_buf, 2,
+                luma_grain_block + luma_offset_y * luma_grain_stride +
+                luma_offset_x,
+                luma_grain_stride, y_col_buf, 2, 2,
+                AOMMIN(luma_subblock_size_y + 2, height - (y << 1)),
+                grain_min, grain_max);
+
+            ver_boundary_overlap(
+                cb_col_buf, 2 >> chroma_subsamp_x,
+                cb_grain_block + chroma_offset_y * chroma_grain_stride +
+                chroma_offset_x,
+                chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                (height - (y << 1)) >> chroma_subsamp_y),
+                grain_min, grain_max);
+
+            ver_boundary_overlap(
+                cr_col_buf, 2 >> chroma_subsamp_x,
+                cr_grain_block + chroma_offset_y * chroma_grain_stride +
+                chroma_offset_x,
+                chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                (height - (y << 1)) >> chroma_subsamp_y),
+                grain_min, grain_max);
+
+            int32_t i = y ? 1 : 0;
+
+            add_noise_to_block(
+                fgs, luma, cb, cr, luma_stride, chroma_stride, y + i, x,
+                y_col_buf + i * 4,
+                cb_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
+                cr_col_buf + i * (2 - chroma_subsamp_y) * (2 - chroma_subsamp_x),
+                2, (2 - chroma_subsamp_x),
+                AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i, 1);
+        }
+
+        if (overlap && y) {
+            if (x) {
+                fgn_hor_boundary_overlap(y_line_buf + (x << 1), luma_stride,
+                    y_col_buf, 2, y_line_buf + (x << 1), luma_stride, 2, 2,
+                    grain_min, grain_max);
+
+                fgn_hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
+                    chroma_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+                    cb_line_buf + x * (2 >> chroma_subsamp_x),
+                    chroma_stride, 2 >> chroma_subsamp_x,
+                    2 >> chroma_subsamp_y, grain_min, grain_max);
+
+                fgn_hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
+                    chroma_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+                    cr_line_buf + x * (2 >> chroma_subsamp_x),
+                    chroma_stride, 2 >> chroma_subsamp_x,
+                    2 >> chroma_subsamp_y, grain_min, grain_max);
             }
 
-            if (overlap) {
-                if (x) {
-                    // Copy overlapped column bufer to line buffer
-                    copy_area(y_col_buf + (luma_subblock_size_y << 1), 2,
-                        y_line_buf + (x << 1), luma_stride, 2, 2);
-
-                    copy_area(
-                        cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-                        2 >> chroma_subsamp_x,
-                        cb_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
-                        2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
-
-                    copy_area(
-                        cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-                        2 >> chroma_subsamp_x,
-                        cr_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
-                        2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
-                }
+            fgn_hor_boundary_overlap(
+                y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+                luma_grain_block + luma_offset_y * luma_grain_stride +
+                luma_offset_x + (x ? 2 : 0),
+                luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+                AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
+                    width - ((x ? x + 1 : 0) << 1)),
+                2, grain_min, grain_max);
+
+            fgn_hor_boundary_overlap(
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                cb_grain_block + chroma_offset_y * chroma_grain_stride +
+                chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_grain_stride,
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x -
+                ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                    (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+                2 >> chroma_subsamp_y, grain_min, grain_max);
+
+            fgn_hor_boundary_overlap(
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                cr_grain_block + chroma_offset_y * chroma_grain_stride +
+                chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_grain_stride,
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x -
+                ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                    (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+                2 >> chroma_subsamp_y, grain_min, grain_max);
+
+            add_noise_to_block(
+                fgs, luma, cb, cr, luma_stride, chroma_stride, y, x,
+                y_line_buf + (x << 1),
+                cb_line_buf + (x << (1 - chroma_subsamp_x)),
+                cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
+                chroma_stride, 1,
+                AOMMIN(luma_subblock_size_x >> 1, width / 2 - x));
+        }
+
+        int32_t i = overlap && y ? 1 : 0;
+        int32_t j = overlap && x ? 1 : 0;
+
+        add_noise_to_block(
+            fgs, luma, cb, cr, luma_stride, chroma_stride, y + i, x + j,
+            luma_grain_block + (luma_offset_y + (i << 1)) * luma_grain_stride +
+            luma_offset_x + (j << 1),
+            cb_grain_block +
+            (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
+            chroma_grain_stride +
+            chroma_offset_x + (j << (1 - chroma_subsamp_x)),
+            cr_grain_block +
+            (chroma_offset_y + (i << (1 - chroma_subsamp_y))) *
+            chroma_grain_stride +
+            chroma_offset_x + (j << (1 - chroma_subsamp_x)),
+            luma_grain_stride, chroma_grain_stride,
+            AOMMIN(luma_subblock_size_y >> 1, height / 2 - y) - i,
+            AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j);
+
+        if (overlap) {
+            if (x) {
+                // Copy overlapped column bufer to line buffer
+                copy_area(y_col_buf + (luma_subblock_size_y << 1), 2,
+                    y_line_buf + (x << 1), luma_stride, 2, 2);
 
-                // Copy grain to the line buffer for overlap with a bottom block
                 copy_area(
-                    luma_grain_block +
-                    (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
-                    luma_offset_x + ((x ? 2 : 0)),
-                    luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-                    AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0), 2);
-
-                copy_area(cb_grain_block +
-                    (chroma_offset_y + chroma_subblock_size_y) *
-                    chroma_grain_stride +
-                    chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                    chroma_grain_stride,
-                    cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    AOMMIN(chroma_subblock_size_x,
-                    ((width - (x << 1)) >> chroma_subsamp_x)) -
-                        (x ? 2 >> chroma_subsamp_x : 0),
-                    2 >> chroma_subsamp_y);
-
-                copy_area(cr_grain_block +
-                    (chroma_offset_y + chroma_subblock_size_y) *
-                    chroma_grain_stride +
-                    chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                    chroma_grain_stride,
-                    cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                    chroma_stride,
-                    AOMMIN(chroma_subblock_size_x,
-                    ((width - (x << 1)) >> chroma_subsamp_x)) -
-                        (x ? 2 >> chroma_subsamp_x : 0),
-                    2 >> chroma_subsamp_y);
-
-                // Copy grain to the column buffer for overlap with the next block to
-                // the right
-
-                copy_area(luma_grain_block + luma_offset_y * luma_grain_stride +
-                    luma_offset_x + luma_subblock_size_x,
-                    luma_grain_stride, y_col_buf, 2, 2,
-                    AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
-
-                copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                    chroma_offset_x + chroma_subblock_size_x,
-                    chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+                    cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
                     2 >> chroma_subsamp_x,
-                    AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                    (height - (y << 1)) >> chroma_subsamp_y));
+                    cb_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
+                    2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
 
-                copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                    chroma_offset_x + chroma_subblock_size_x,
-                    chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+                copy_area(
+                    cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
                     2 >> chroma_subsamp_x,
-                    AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                    (height - (y << 1)) >> chroma_subsamp_y));
+                    cr_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
+                    2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
             }
+
+            // Copy grain to the line buffer for overlap with a bottom block
+            copy_area(
+                luma_grain_block +
+                (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
+                luma_offset_x + ((x ? 2 : 0)),
+                luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+                AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0), 2);
+
+            copy_area(cb_grain_block +
+                (chroma_offset_y + chroma_subblock_size_y) *
+                chroma_grain_stride +
+                chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                chroma_grain_stride,
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x,
+                ((width - (x << 1)) >> chroma_subsamp_x)) -
+                    (x ? 2 >> chroma_subsamp_x : 0),
+                2 >> chroma_subsamp_y);
+
+            copy_area(cr_grain_block +
+                (chroma_offset_y + chroma_subblock_size_y) *
+                chroma_grain_stride +
+                chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                chroma_grain_stride,
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x,
+                ((width - (x << 1)) >> chroma_subsamp_x)) -
+                    (x ? 2 >> chroma_subsamp_x : 0),
+                2 >> chroma_subsamp_y);
+
+            // Copy grain to the column buffer for overlap with the next block to
+            // the right
+
+            copy_area(luma_grain_block + luma_offset_y * luma_grain_stride +
+                luma_offset_x + luma_subblock_size_x,
+                luma_grain_stride, y_col_buf, 2, 2,
+                AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
+
+            copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride +
+                chroma_offset_x + chroma_subblock_size_x,
+                chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                (height - (y << 1)) >> chroma_subsamp_y));
+
+            copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride +
+                chroma_offset_x + chroma_subblock_size_x,
+                chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                (height - (y << 1)) >> chroma_subsamp_y));
         }
     }
 
-    dealloc_arrays(params, &pred_pos_luma, &pred_pos_chroma, &luma_grain_block,
-        &cb_grain_block, &cr_grain_block, &y_line_buf, &cb_line_buf,
-        &cr_line_buf, &y_col_buf, &cb_col_buf, &cr_col_buf);
+    free(y_line_buf);
+    free(cb_line_buf);
+    free(cr_line_buf);
+    return 0;
+}
+
+int32_t av1_add_film_grain_run(aom_film_grain_t *params, uint8_t *luma,
+    uint8_t *cb, uint8_t *cr, int32_t height, int32_t width,
+    int32_t luma_stride, int32_t chroma_stride,
+    int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
+    int32_t chroma_subsamp_x) {
+    aom_film_grain_synth_t *fgs =
+        (aom_film_grain_synth_t *)malloc(sizeof(*fgs));
+    int32_t status = 0;
+    if (fgs == NULL) return -1;
+
+    av1_film_grain_synth_init(fgs, params, height, width, use_high_bit_depth,
+        chroma_subsamp_y, chroma_subsamp_x);
+
+    for (int32_t stripe = 0;
+        stripe < av1_film_grain_stripe_count(height) && status == 0; stripe++)
+        status = av1_add_film_grain_stripe(fgs, luma, cb, cr, luma_stride,
+            chroma_stride, stripe);
+
+    free(fgs);
+    return status;
 }
 
+
 /*
 void av1_film_grain_write_updated(const aom_film_grain_t *pars,
                                   int32_t monochrome,
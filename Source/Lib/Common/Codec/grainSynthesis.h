@@ -80,8 +80,99 @@ extern "C" {
         uint16_t random_seed;
     } aom_film_grain_t;
 
+    // Luma rows of a film grain stripe, a row of 32x32 grain subblocks
+#define FILM_GRAIN_STRIPE_HEIGHT 32
+
+    // Size of the luma grain template, the largest one: the 64x64 samples
+    // the subblocks are taken from, padded to stabilize the AR filter
+#define FILM_GRAIN_BLOCK_HEIGHT 73
+#define FILM_GRAIN_BLOCK_WIDTH 82
+
+    /*!\brief Film grain synthesis state of a picture
+     *
+     * Grain templates and scaling functions of a picture, generated once by
+     * av1_film_grain_synth_init() and only read while the stripes of the
+     * picture are synthesized, so that the stripes can run on any thread
+     */
+    typedef struct {
+        aom_film_grain_t params;
+
+        int32_t width;
+        int32_t height;
+        int32_t use_high_bit_depth;
+        int32_t chroma_subsamp_y;
+        int32_t chroma_subsamp_x;
+
+        int32_t grain_min;
+        int32_t grain_max;
+
+        // Entry 256 repeats entry 255, for the interpolation of high bit
+        // depths
+        int32_t scaling_lut_y[257];
+        int32_t scaling_lut_cb[257];
+        int32_t scaling_lut_cr[257];
+
+        // Noise application constants, at the bit depth
+        int32_t cb_mult;
+        int32_t cb_luma_mult;
+        int32_t cb_offset;
+        int32_t cr_mult;
+        int32_t cr_luma_mult;
+        int32_t cr_offset;
+        int32_t min_luma;
+        int32_t max_luma;
+        int32_t min_chroma;
+        int32_t max_chroma;
+
+        int32_t luma_grain_stride;
+        int32_t chroma_grain_stride;
+        int32_t luma_grain_block[FILM_GRAIN_BLOCK_HEIGHT * FILM_GRAIN_BLOCK_WIDTH];
+        int32_t cb_grain_block[FILM_GRAIN_BLOCK_HEIGHT * FILM_GRAIN_BLOCK_WIDTH];
+        int32_t cr_grain_block[FILM_GRAIN_BLOCK_HEIGHT * FILM_GRAIN_BLOCK_WIDTH];
+    } aom_film_grain_synth_t;
+
     int32_t film_grain_params_equal(aom_film_grain_t *pars_a, aom_film_grain_t *pars_b);
 
+    /*!\brief Initialize the film grain synthesis of a picture
+     *
+     * Generates the grain templates and the scaling functions
+     *
+     * \param[out]   fgs              Synthesis state of the picture
+     * \param[in]    grain_params     Grain parameters
+     * \param[in]    height           luma plane height
+     * \param[in]    width            luma plane width
+     */
+    void av1_film_grain_synth_init(aom_film_grain_synth_t *fgs,
+        const aom_film_grain_t *grain_params, int32_t height, int32_t width,
+        int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
+        int32_t chroma_subsamp_x);
+
+    /*!\brief Number of stripes of FILM_GRAIN_STRIPE_HEIGHT luma rows of a
+     * picture, at least 1
+     */
+    int32_t av1_film_grain_stripe_count(int32_t height);
+
+    /*!\brief Add film grain to a stripe
+     *
+     * Adds the film grain to the rows of one stripe. The stripes only write
+     * their own rows and do not depend on each other, so they can be
+     * synthesized in any order and in parallel.
+     *
+     * \param[in]    fgs              Synthesis state of the picture
+     * \param[in]    luma             luma plane
+     * \param[in]    cb               cb plane
+     * \param[in]    cr               cr plane
+     * \param[in]    luma_stride      luma plane stride
+     * \param[in]    chroma_stride    chroma plane stride
+     * \param[in]    stripe           index of the stripe
+     *
+     * \return 0, or -1 with the stripe left unchanged when its line buffers
+     * cannot be allocated
+     */
+    int32_t av1_add_film_grain_stripe(const aom_film_grain_synth_t *fgs,
+        uint8_t *luma, uint8_t *cb, uint8_t *cr, int32_t luma_stride,
+        int32_t chroma_stride, int32_t stripe);
+
     /*!\brief Add film grain
      *
      * Add film grain to an image
@@ -94,8 +185,11 @@ extern "C" {
      * \param[in]    width            luma plane width
      * \param[in]    luma_stride      luma plane stride
      * \param[in]    chroma_stride    chroma plane stride
+     *
+     * \return 0, or -1 when the synthesis state or line buffers cannot be
+     * allocated, with the grain missing from some stripes
      */
-    void av1_add_film_grain_run(aom_film_grain_t *grain_params, uint8_t *luma,
+    int32_t av1_add_film_grain_run(aom_film_grain_t *grain_params, uint8_t *luma,
         uint8_t *cb, uint8_t *cr, int32_t height, int32_t width,
         int32_t luma_stride, int32_t chroma_stride,
         int32_t use_high_bit_depth, int32_t chroma_subsamp_y,
@@ -15,6 +15,7 @@
 #include "hash.h"
 #include "hash_motion.h"
 #include "EbPictureControlSet.h"
+#include "aom_dsp_rtcd.h"
 
 
 void aom_free(void *memblk);
@@ -62,6 +63,14 @@ static void get_pixels_in_1D_short_array_by_block_2x2(uint16_t *y_src,
   }
 }
 
+// Turns the pixels of a 2x2 block from row order into column order
+#define SWAP_2X2_ANTI_DIAGONAL(p) \
+  do {                            \
+    const int tmp = (p)[1];       \
+    (p)[1] = (p)[2];              \
+    (p)[2] = tmp;                 \
+  } while (0)
+
 static int is_block_2x2_row_same_value(uint8_t *p) {
   if (p[0] != p[1] || p[2] != p[3]) {
     return 0;
@@ -184,20 +193,24 @@ int32_t av1_has_exact_match(hash_table *p_hash_table, uint32_t hash_value1,
   return 0;
 }
 
+// The second hash is the hash of the transposed block: a CRC of the same
+// data with another seed would only be an affine function of the first one.
 void av1_generate_block_2x2_hash_value(const Yv12BufferConfig *picture,
                                        uint32_t *pic_block_hash[2],
                                        int8_t *pic_block_same_info[3],
-                                       PictureControlSet_t * pcs) {
+                                       CRC32C *crc_calculator,
+                                       int row_start, int row_end) {
   const int width = 2;
   const int height = 2;
+  const int pic_width = picture->y_crop_width;
   const int x_end = picture->y_crop_width - width + 1;
-  const int y_end = picture->y_crop_height - height + 1;
+  const int y_end = AOMMIN(picture->y_crop_height - height + 1, row_end);
 
   const int length = width * 2;
   if (picture->flags & YV12_FLAG_HIGHBITDEPTH) {
     uint16_t p[4];
-    int pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
+    for (int y_pos = row_start; y_pos < y_end; y_pos++) {
+      int pos = y_pos * pic_width;
       for (int x_pos = 0; x_pos < x_end; x_pos++) {
         get_pixels_in_1D_short_array_by_block_2x2(
             CONVERT_TO_SHORTPTR(picture->y_buffer) + y_pos * picture->y_stride +
@@ -206,18 +219,18 @@ void av1_generate_block_2x2_hash_value(const Yv12BufferConfig *picture,
         pic_block_same_info[0][pos] = is_block16_2x2_row_same_value(p);
         pic_block_same_info[1][pos] = is_block16_2x2_col_same_value(p);
 
-        pic_block_hash[0][pos] = av1_get_crc_value(
-            &pcs->crc_calculator1, (uint8_t *)p, length * sizeof(p[0]));
-        pic_block_hash[1][pos] = av1_get_crc_value(
-            &pcs->crc_calculator2, (uint8_t *)p, length * sizeof(p[0]));
+        pic_block_hash[0][pos] = av1_get_crc32c_value(
+            crc_calculator, (uint8_t *)p, length * sizeof(p[0]));
+        SWAP_2X2_ANTI_DIAGONAL(p);
+        pic_block_hash[1][pos] = av1_get_crc32c_value(
+            crc_calculator, (uint8_t *)p, length * sizeof(p[0]));
         pos++;
       }
-      pos += width - 1;
     }
   } else {
     uint8_t p[4];
-    int pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
+    for (int y_pos = row_start; y_pos < y_end; y_pos++) {
+      int pos = y_pos * pic_width;
       for (int x_pos = 0; x_pos < x_end; x_pos++) {
         get_pixels_in_1D_char_array_by_block_2x2(
             picture->y_buffer + y_pos * picture->y_stride + x_pos,
@@ -226,12 +239,12 @@ void av1_generate_block_2x2_hash_value(const Yv12BufferConfig *picture,
         pic_block_same_info[1][pos] = is_block_2x2_col_same_value(p);
 
         pic_block_hash[0][pos] =
-            av1_get_crc_value(&pcs->crc_calculator1, p, length * sizeof(p[0]));
+            av1_get_crc32c_value(crc_calculator, p, length * sizeof(p[0]));
+        SWAP_2X2_ANTI_DIAGONAL(p);
         pic_block_hash[1][pos] =
-            av1_get_crc_value(&pcs->crc_calculator2, p, length * sizeof(p[0]));
+            av1_get_crc32c_value(crc_calculator, p, length * sizeof(p[0]));
         pos++;
       }
-      pos += width - 1;
     }
   }
 }
@@ -242,10 +255,11 @@ void av1_generate_block_hash_value(const Yv12BufferConfig *picture,
                                    uint32_t *dst_pic_block_hash[2],
                                    int8_t *src_pic_block_same_info[3],
                                    int8_t *dst_pic_block_same_info[3],
-                                   PictureControlSet_t * pcs  ) {
+                                   CRC32C *crc_calculator,
+                                   int row_start, int row_end) {
   const int pic_width = picture->y_crop_width;
   const int x_end = picture->y_crop_width - block_size + 1;
-  const int y_end = picture->y_crop_height - block_size + 1;
+  const int y_end = AOMMIN(picture->y_crop_height - block_size + 1, row_end);
 
   const int src_size = block_size >> 1;
   const int quad_size = block_size >> 2;
@@ -253,22 +267,22 @@ void av1_generate_block_hash_value(const Yv12BufferConfig *picture,
   uint32_t p[4];
   const int length = sizeof(p);
 
-  int pos = 0;
-  for (int y_pos = 0; y_pos < y_end; y_pos++) {
+  for (int y_pos = row_start; y_pos < y_end; y_pos++) {
+    int pos = y_pos * pic_width;
     for (int x_pos = 0; x_pos < x_end; x_pos++) {
       p[0] = src_pic_block_hash[0][pos];
       p[1] = src_pic_block_hash[0][pos + src_size];
       p[2] = src_pic_block_hash[0][pos + src_size * pic_width];
       p[3] = src_pic_block_hash[0][pos + src_size * pic_width + src_size];
       dst_pic_block_hash[0][pos] =
-          av1_get_crc_value(&pcs->crc_calculator1, (uint8_t *)p, length);
+          av1_get_crc32c_value(crc_calculator, (uint8_t *)p, length);
 
       p[0] = src_pic_block_hash[1][pos];
-      p[1] = src_pic_block_hash[1][pos + src_size];
-      p[2] = src_pic_block_hash[1][pos + src_size * pic_width];
+      p[1] = src_pic_block_hash[1][pos + src_size * pic_width];
+      p[2] = src_pic_block_hash[1][pos + src_size];
       p[3] = src_pic_block_hash[1][pos + src_size * pic_width + src_size];
       dst_pic_block_hash[1][pos] =
-          av1_get_crc_value(&pcs->crc_calculator2, (uint8_t *)p, length);
+          av1_get_crc32c_value(crc_calculator, (uint8_t *)p, length);
 
       dst_pic_block_same_info[0][pos] =
           src_pic_block_same_info[0][pos] &&
@@ -287,13 +301,12 @@ void av1_generate_block_hash_value(const Yv12BufferConfig *picture,
           src_pic_block_same_info[1][pos + src_size * pic_width + src_size];
       pos++;
     }
-    pos += block_size - 1;
   }
 
   if (block_size >= 4) {
     const int size_minus_1 = block_size - 1;
-    pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
+    for (int y_pos = row_start; y_pos < y_end; y_pos++) {
+      int pos = y_pos * pic_width;
       for (int x_pos = 0; x_pos < x_end; x_pos++) {
         dst_pic_block_same_info[2][pos] =
             (!dst_pic_block_same_info[0][pos] &&
@@ -301,7 +314,6 @@ void av1_generate_block_hash_value(const Yv12BufferConfig *picture,
             (((x_pos & size_minus_1) == 0) && ((y_pos & size_minus_1) == 0));
         pos++;
       }
-      pos += block_size - 1;
     }
   }
 }
@@ -416,10 +428,11 @@ void av1_get_block_hash_value(uint8_t *y_src, int stride, int block_size,
             y16_src + y_pos * stride + x_pos, stride, pixel_to_hash);
         assert(pos < AOM_BUFFER_SIZE_FOR_BLOCK_HASH);
         x->hash_value_buffer[0][0][pos] =
-            av1_get_crc_value(&x->crc_calculator1, (uint8_t *)pixel_to_hash,
+            av1_get_crc32c_value(x->crc_calculator, (uint8_t *)pixel_to_hash,
                 sizeof(pixel_to_hash));
+        SWAP_2X2_ANTI_DIAGONAL(pixel_to_hash);
         x->hash_value_buffer[1][0][pos] =
-            av1_get_crc_value(&x->crc_calculator2, (uint8_t *)pixel_to_hash,
+            av1_get_crc32c_value(x->crc_calculator, (uint8_t *)pixel_to_hash,
                 sizeof(pixel_to_hash));
       }
     }
@@ -431,10 +444,11 @@ void av1_get_block_hash_value(uint8_t *y_src, int stride, int block_size,
         get_pixels_in_1D_char_array_by_block_2x2(y_src + y_pos * stride + x_pos,
                                                  stride, pixel_to_hash);
         assert(pos < AOM_BUFFER_SIZE_FOR_BLOCK_HASH);
-        x->hash_value_buffer[0][0][pos] = av1_get_crc_value(
-            &x->crc_calculator1, pixel_to_hash, sizeof(pixel_to_hash));
-        x->hash_value_buffer[1][0][pos] = av1_get_crc_value(
-            &x->crc_calculator2, pixel_to_hash, sizeof(pixel_to_hash));
+        x->hash_value_buffer[0][0][pos] = av1_get_crc32c_value(
+            x->crc_calculator, pixel_to_hash, sizeof(pixel_to_hash));
+        SWAP_2X2_ANTI_DIAGONAL(pixel_to_hash);
+        x->hash_value_buffer[1][0][pos] = av1_get_crc32c_value(
+            x->crc_calculator, pixel_to_hash, sizeof(pixel_to_hash));
       }
     }
   }
@@ -465,17 +479,17 @@ void av1_get_block_hash_value(uint8_t *y_src, int stride, int block_size,
             x->hash_value_buffer[0][src_idx][srcPos + src_sub_block_in_width];
         to_hash[3] = x->hash_value_buffer[0][src_idx]
                                          [srcPos + src_sub_block_in_width + 1];
-        x->hash_value_buffer[0][dst_idx][dst_pos] = av1_get_crc_value(
-            &x->crc_calculator1, (uint8_t *)to_hash, sizeof(to_hash));
+        x->hash_value_buffer[0][dst_idx][dst_pos] = av1_get_crc32c_value(
+            x->crc_calculator, (uint8_t *)to_hash, sizeof(to_hash));
 
         to_hash[0] = x->hash_value_buffer[1][src_idx][srcPos];
-        to_hash[1] = x->hash_value_buffer[1][src_idx][srcPos + 1];
-        to_hash[2] =
+        to_hash[1] =
             x->hash_value_buffer[1][src_idx][srcPos + src_sub_block_in_width];
+        to_hash[2] = x->hash_value_buffer[1][src_idx][srcPos + 1];
         to_hash[3] = x->hash_value_buffer[1][src_idx]
                                          [srcPos + src_sub_block_in_width + 1];
-        x->hash_value_buffer[1][dst_idx][dst_pos] = av1_get_crc_value(
-            &x->crc_calculator2, (uint8_t *)to_hash, sizeof(to_hash));
+        x->hash_value_buffer[1][dst_idx][dst_pos] = av1_get_crc32c_value(
+            x->crc_calculator, (uint8_t *)to_hash, sizeof(to_hash));
         dst_pos++;
       }
     }
@@ -26,6 +26,9 @@
 extern "C" {
 #endif
 
+// Hash levels of a picture: 2x2, then 4x4 to 128x128
+#define INTRABC_HASH_LEVEL_COUNT 7
+
 // store a block's hash info.
 // x and y are the position from the top left of the picture
 // hash_value2 is used to store the second hash value
@@ -48,17 +51,21 @@ Iterator av1_hash_get_first_iterator(hash_table *p_hash_table,
                                      uint32_t hash_value);
 int32_t av1_has_exact_match(hash_table *p_hash_table, uint32_t hash_value1,
                             uint32_t hash_value2);
+// Hash the blocks whose top row is in [row_start, row_end); rows of
+// different calls can be hashed concurrently.
 void av1_generate_block_2x2_hash_value(const Yv12BufferConfig *picture,
                                        uint32_t *pic_block_hash[2],
                                        int8_t *pic_block_same_info[3],
-                                      struct PictureControlSet_s * pcs);
+                                       CRC32C *crc_calculator,
+                                       int row_start, int row_end);
 void av1_generate_block_hash_value(const Yv12BufferConfig *picture,
                                    int block_size,
                                    uint32_t *src_pic_block_hash[2],
                                    uint32_t *dst_pic_block_hash[2],
                                    int8_t *src_pic_block_same_info[3],
                                    int8_t *dst_pic_block_same_info[3],
-                                   struct PictureControlSet_s * pcs);
+                                   CRC32C *crc_calculator,
+                                   int row_start, int row_end);
 void av1_add_to_hash_map_by_row_with_precal_data(hash_table *p_hash_table,
                                                  uint32_t *pic_hash[2],
                                                  int8_t *pic_is_same,
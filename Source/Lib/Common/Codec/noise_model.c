@@ -169,7 +169,7 @@ static int32_t equation_system_solve(aom_equation_system_t *eqns) {
     }
     return 1;
 }
-/*
+
 static void equation_system_add(aom_equation_system_t *dest,
                                 aom_equation_system_t *src) {
   const int32_t n = dest->n;
@@ -181,7 +181,7 @@ static void equation_system_add(aom_equation_system_t *dest,
     dest->b[i] += src->b[i];
   }
 }
-*/
+
 static void equation_system_free(aom_equation_system_t *eqns) {
     if (!eqns) return;
     free(eqns->A);
@@ -567,19 +567,12 @@ typedef struct {
     float score;
 } index_and_score_t;
 
-static int32_t compare_scores(const void *a, const void *b) {
-    const float diff =
-        ((index_and_score_t *)a)->score - ((index_and_score_t *)b)->score;
-    if (diff < 0)
-        return -1;
-    else if (diff > 0)
-        return 1;
-    return 0;
-}
-
-int32_t aom_flat_block_finder_run(const aom_flat_block_finder_t *block_finder,
-    const uint8_t *const data, int32_t w, int32_t h,
-    int32_t stride, uint8_t *flat_blocks) {
+// Scores the blocks of the block row by and marks the ones passing the
+// flatness thresholds in flat_blocks. Returns the number of flat blocks.
+static int32_t flat_block_finder_score_row(
+    const aom_flat_block_finder_t *block_finder, const uint8_t *const data,
+    int32_t w, int32_t h, int32_t stride, int32_t by, uint8_t *flat_blocks,
+    index_and_score_t *scores, double *plane, double *block) {
     // The gradient-based features used in this code are based on:
     //  A. Kokaram, D. Kelly, H. Denman and A. Crawford, "Measuring noise
     //  correlation for improved video denoising," 2012 19th, ICIP.
@@ -592,9 +585,131 @@ int32_t aom_flat_block_finder_run(const aom_flat_block_finder_t *block_finder,
     const double kNormThreshold = 0.08 / (32 * 32);
     const double kVarThreshold = 0.005 / (double)n;
     const int32_t num_blocks_w = (w + block_size - 1) / block_size;
+    int32_t num_flat = 0;
+    int32_t bx = 0;
+
+    for (bx = 0; bx < num_blocks_w; ++bx) {
+        // Compute gradient covariance matrix.
+        double Gxx = 0, Gxy = 0, Gyy = 0;
+        double var = 0;
+        double mean = 0;
+        int32_t xi, yi;
+        aom_flat_block_finder_extract_block(block_finder, data, w, h, stride,
+            bx * block_size, by * block_size,
+            plane, block);
+
+        for (yi = 1; yi < block_size - 1; ++yi) {
+            for (xi = 1; xi < block_size - 1; ++xi) {
+                const double gx = (block[yi * block_size + xi + 1] -
+                    block[yi * block_size + xi - 1]) /
+                    2;
+                const double gy = (block[yi * block_size + xi + block_size] -
+                    block[yi * block_size + xi - block_size]) /
+                    2;
+                Gxx += gx * gx;
+                Gxy += gx * gy;
+                Gyy += gy * gy;
+
+                mean += block[yi * block_size + xi];
+                var += block[yi * block_size + xi] * block[yi * block_size + xi];
+            }
+        }
+        mean /= (block_size - 2) * (block_size - 2);
+
+        // Normalize gradients by block_size.
+        Gxx /= ((block_size - 2) * (block_size - 2));
+        Gxy /= ((block_size - 2) * (block_size - 2));
+        Gyy /= ((block_size - 2) * (block_size - 2));
+        var = var / ((block_size - 2) * (block_size - 2)) - mean * mean;
+
+        {
+            const double trace = Gxx + Gyy;
+            const double det = Gxx * Gyy - Gxy * Gxy;
+            const double e1 = (trace + sqrt(trace * trace - 4 * det)) / 2.;
+            const double e2 = (trace - sqrt(trace * trace - 4 * det)) / 2.;
+            const double norm = e1;  // Spectral norm
+            const double ratio = (e1 / AOMMAX(e2, 1e-6));
+            const int32_t is_flat = (trace < kTraceThreshold) &&
+                (ratio < kRatioThreshold) &&
+                (norm < kNormThreshold) && (var > kVarThreshold);
+            // The following weights are used to combine the above features to give
+            // a sigmoid score for flatness. If the input was normalized to [0,100]
+            // the magnitude of these values would be close to 1 (e.g., weights
+            // corresponding to variance would be a factor of 10000x smaller).
+            // The weights are given in the following order:
+            //    [{var}, {ratio}, {trace}, {norm}, offset]
+            // with one of the most discriminative being simply the variance.
+            const double weights[5] = { -6682, -0.2056, 13087, -12434, 2.5694 };
+            const float score =
+                (float)(1.0 / (1 + exp(-(weights[0] * var + weights[1] * ratio +
+                    weights[2] * trace + weights[3] * norm +
+                    weights[4]))));
+            flat_blocks[by * num_blocks_w + bx] = is_flat ? 255 : 0;
+            scores[by * num_blocks_w + bx].score = var > kVarThreshold ? score : 0;
+            scores[by * num_blocks_w + bx].index = by * num_blocks_w + bx;
+#ifdef NOISE_MODEL_LOG_SCORE
+            fprintf(stderr, "%g %g %g %g %g %d ", score, var, ratio, trace, norm,
+                is_flat);
+#endif
+            num_flat += is_flat;
+        }
+    }
+    return num_flat;
+}
+
+// Returns the k-th smallest score, the scores are partially reordered.
+// Same value as scores[k] once sorted, without sorting all the blocks.
+static float select_score(index_and_score_t *scores, int32_t n, int32_t k) {
+    int32_t lo = 0, hi = n - 1;
+    while (lo < hi) {
+        const float pivot = scores[lo + (hi - lo) / 2].score;
+        int32_t i = lo, j = hi;
+        while (i <= j) {
+            while (scores[i].score < pivot) ++i;
+            while (scores[j].score > pivot) --j;
+            if (i <= j) {
+                const index_and_score_t tmp = scores[i];
+                scores[i++] = scores[j];
+                scores[j--] = tmp;
+            }
+        }
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            break;  // scores[k] equals the pivot
+    }
+    return scores[k].score;
+}
+
+// Find the top-scored blocks (most likely to be flat) and set the flat blocks
+// be the union of the thresholded results and the top 10th percentile of the
+// scored results. Returns the number of blocks added.
+static int32_t flat_block_finder_add_top_scores(index_and_score_t *scores,
+    int32_t num_blocks, uint8_t *flat_blocks) {
+    const int32_t top_nth_percentile = num_blocks * 90 / 100;
+    const float score_threshold =
+        select_score(scores, num_blocks, top_nth_percentile);
+    int32_t num_flat = 0;
+    for (int32_t i = 0; i < num_blocks; ++i) {
+        if (scores[i].score >= score_threshold) {
+            num_flat += flat_blocks[scores[i].index] == 0;
+            flat_blocks[scores[i].index] |= 1;
+        }
+    }
+    return num_flat;
+}
+
+int32_t aom_flat_block_finder_run(const aom_flat_block_finder_t *block_finder,
+    const uint8_t *const data, int32_t w, int32_t h,
+    int32_t stride, uint8_t *flat_blocks) {
+    const int32_t block_size = block_finder->block_size;
+    const int32_t n = block_size * block_size;
+    const int32_t num_blocks_w = (w + block_size - 1) / block_size;
     const int32_t num_blocks_h = (h + block_size - 1) / block_size;
     int32_t num_flat = 0;
-    int32_t bx = 0, by = 0;
+    int32_t by = 0;
     double *plane = (double *)malloc(n * sizeof(*plane));
     double *block = (double *)malloc(n * sizeof(*block));
     index_and_score_t *scores = (index_and_score_t *)malloc(
@@ -611,72 +726,8 @@ int32_t aom_flat_block_finder_run(const aom_flat_block_finder_t *block_finder,
     fprintf(stderr, "score = [");
 #endif
     for (by = 0; by < num_blocks_h; ++by) {
-        for (bx = 0; bx < num_blocks_w; ++bx) {
-            // Compute gradient covariance matrix.
-            double Gxx = 0, Gxy = 0, Gyy = 0;
-            double var = 0;
-            double mean = 0;
-            int32_t xi, yi;
-            aom_flat_block_finder_extract_block(block_finder, data, w, h, stride,
-                bx * block_size, by * block_size,
-                plane, block);
-
-            for (yi = 1; yi < block_size - 1; ++yi) {
-                for (xi = 1; xi < block_size - 1; ++xi) {
-                    const double gx = (block[yi * block_size + xi + 1] -
-                        block[yi * block_size + xi - 1]) /
-                        2;
-                    const double gy = (block[yi * block_size + xi + block_size] -
-                        block[yi * block_size + xi - block_size]) /
-                        2;
-                    Gxx += gx * gx;
-                    Gxy += gx * gy;
-                    Gyy += gy * gy;
-
-                    mean += block[yi * block_size + xi];
-                    var += block[yi * block_size + xi] * block[yi * block_size + xi];
-                }
-            }
-            mean /= (block_size - 2) * (block_size - 2);
-
-            // Normalize gradients by block_size.
-            Gxx /= ((block_size - 2) * (block_size - 2));
-            Gxy /= ((block_size - 2) * (block_size - 2));
-            Gyy /= ((block_size - 2) * (block_size - 2));
-            var = var / ((block_size - 2) * (block_size - 2)) - mean * mean;
-
-            {
-                const double trace = Gxx + Gyy;
-                const double det = Gxx * Gyy - Gxy * Gxy;
-                const double e1 = (trace + sqrt(trace * trace - 4 * det)) / 2.;
-                const double e2 = (trace - sqrt(trace * trace - 4 * det)) / 2.;
-                const double norm = e1;  // Spectral norm
-                const double ratio = (e1 / AOMMAX(e2, 1e-6));
-                const int32_t is_flat = (trace < kTraceThreshold) &&
-                    (ratio < kRatioThreshold) &&
-                    (norm < kNormThreshold) && (var > kVarThreshold);
-                // The following weights are used to combine the above features to give
-                // a sigmoid score for flatness. If the input was normalized to [0,100]
-                // the magnitude of these values would be close to 1 (e.g., weights
-                // corresponding to variance would be a factor of 10000x smaller).
-                // The weights are given in the following order:
-                //    [{var}, {ratio}, {trace}, {norm}, offset]
-                // with one of the most discriminative being simply the variance.
-                const double weights[5] = { -6682, -0.2056, 13087, -12434, 2.5694 };
-                const float score =
-                    (float)(1.0 / (1 + exp(-(weights[0] * var + weights[1] * ratio +
-                        weights[2] * trace + weights[3] * norm +
-                        weights[4]))));
-                flat_blocks[by * num_blocks_w + bx] = is_flat ? 255 : 0;
-                scores[by * num_blocks_w + bx].score = var > kVarThreshold ? score : 0;
-                scores[by * num_blocks_w + bx].index = by * num_blocks_w + bx;
-#ifdef NOISE_MODEL_LOG_SCORE
-                fprintf(stderr, "%g %g %g %g %g %d ", score, var, ratio, trace, norm,
-                    is_flat);
-#endif
-                num_flat += is_flat;
-            }
-        }
+        num_flat += flat_block_finder_score_row(block_finder, data, w, h, stride,
+            by, flat_blocks, scores, plane, block);
 #ifdef NOISE_MODEL_LOG_SCORE
         fprintf(stderr, "\n");
 #endif
@@ -684,18 +735,8 @@ int32_t aom_flat_block_finder_run(const aom_flat_block_finder_t *block_finder,
 #ifdef NOISE_MODEL_LOG_SCORE
     fprintf(stderr, "];\n");
 #endif
-    // Find the top-scored blocks (most likely to be flat) and set the flat blocks
-    // be the union of the thresholded results and the top 10th percentile of the
-    // scored results.
-    qsort(scores, num_blocks_w * num_blocks_h, sizeof(*scores), &compare_scores);
-    const int32_t top_nth_percentile = num_blocks_w * num_blocks_h * 90 / 100;
-    const float score_threshold = scores[top_nth_percentile].score;
-    for (int32_t i = 0; i < num_blocks_w * num_blocks_h; ++i) {
-        if (scores[i].score >= score_threshold) {
-            num_flat += flat_blocks[scores[i].index] == 0;
-            flat_blocks[scores[i].index] |= 1;
-        }
-    }
+    num_flat += flat_block_finder_add_top_scores(scores,
+        num_blocks_w * num_blocks_h, flat_blocks);
     free(block);
     free(plane);
     free(scores);
@@ -815,25 +856,28 @@ void aom_noise_model_free(aom_noise_model_t *model) {
 EXTRACT_AR_ROW(uint8_t, lowbd);
 EXTRACT_AR_ROW(uint16_t, highbd);
 
+// Adds the observations of the flat blocks of block rows [by_start, by_end)
+// to eqns, the systems of disjoint block rows can be built concurrently.
 static int32_t add_block_observations(
-    aom_noise_model_t *noise_model, int32_t c, const uint8_t *const data,
+    const aom_noise_model_t *noise_model, aom_equation_system_t *eqns,
+    int32_t *num_observations, const uint8_t *const data,
     const uint8_t *const denoised, int32_t w, int32_t h, int32_t stride, int32_t sub_log2[2],
     const uint8_t *const alt_data, const uint8_t *const alt_denoised,
     int32_t alt_stride, const uint8_t *const flat_blocks, int32_t block_size,
-    int32_t num_blocks_w, int32_t num_blocks_h) {
+    int32_t num_blocks_w, int32_t by_start, int32_t by_end) {
     const int32_t lag = noise_model->params.lag;
     const int32_t num_coords = noise_model->n;
     const double normalization = (1 << noise_model->params.bit_depth) - 1;
-    double *A = noise_model->latest_state[c].eqns.A;
-    double *b = noise_model->latest_state[c].eqns.b;
+    double *A = eqns->A;
+    double *b = eqns->b;
     double *buffer = (double *)malloc(sizeof(*buffer) * (num_coords + 1));
-    const int32_t n = noise_model->latest_state[c].eqns.n;
+    const int32_t n = eqns->n;
 
     if (!buffer) {
         fprintf(stderr, "Unable to allocate buffer of size %d\n", num_coords + 1);
         return 0;
     }
-    for (int32_t by = 0; by < num_blocks_h; ++by) {
+    for (int32_t by = by_start; by < by_end; ++by) {
         const int32_t y_o = by * (block_size >> sub_log2[1]);
         for (int32_t bx = 0; bx < num_blocks_w; ++bx) {
             const int32_t x_o = bx * (block_size >> sub_log2[0]);
@@ -873,7 +917,7 @@ static int32_t add_block_observations(
                         }
                         b[i] += (buffer[i] * val) / (normalization * normalization);
                     }
-                    noise_model->latest_state[c].num_observations++;
+                    (*num_observations)++;
                 }
             }
         }
@@ -1027,15 +1071,12 @@ static int32_t ar_equation_system_solve(aom_noise_state_t *state, int32_t is_chr
     return ret;
 }
 
-aom_noise_status_t aom_noise_model_update(
-    aom_noise_model_t *const noise_model, const uint8_t *const data[3],
-    const uint8_t *const denoised[3], int32_t w, int32_t h, int32_t stride[3],
-    int32_t chroma_sub_log2[2], const uint8_t *const flat_blocks, int32_t block_size) {
-    const int32_t num_blocks_w = (w + block_size - 1) / block_size;
-    const int32_t num_blocks_h = (h + block_size - 1) / block_size;
-    //  int32_t y_model_different = 0;
+// Checks the arguments of an update and clears the latest state.
+static aom_noise_status_t noise_model_update_begin(
+    aom_noise_model_t *const noise_model, const uint8_t *const flat_blocks,
+    int32_t num_blocks_w, int32_t num_blocks_h, int32_t block_size) {
     int32_t num_blocks = 0;
-    int32_t i = 0, channel = 0;
+    int32_t i = 0;
 
     if (block_size <= 1) {
         fprintf(stderr, "block_size = %d must be > 1\n", block_size);
@@ -1066,80 +1107,113 @@ aom_noise_status_t aom_noise_model_update(
         fprintf(stderr, "Not enough flat blocks to update noise estimate\n");
         return AOM_NOISE_STATUS_INSUFFICIENT_FLAT_BLOCKS;
     }
+    return AOM_NOISE_STATUS_OK;
+}
 
-    for (channel = 0; channel < 3; ++channel) {
-        int32_t no_subsampling[2] = { 0, 0 };
-        const uint8_t *alt_data = channel > 0 ? data[0] : 0;
-        const uint8_t *alt_denoised = channel > 0 ? denoised[0] : 0;
-        int32_t *sub = channel > 0 ? chroma_sub_log2 : no_subsampling;
-        const int32_t is_chroma = channel != 0;
-        if (!data[channel] || !denoised[channel]) break;
-        if (!add_block_observations(noise_model, channel, data[channel],
-            denoised[channel], w, h, stride[channel], sub,
-            alt_data, alt_denoised, stride[0], flat_blocks,
-            block_size, num_blocks_w, num_blocks_h)) {
-            fprintf(stderr, "Adding block observation failed\n");
+// Solves the latest state of a channel once its block observations are added
+// and copies it to the combined state.
+static aom_noise_status_t noise_model_update_channel(
+    aom_noise_model_t *const noise_model, int32_t channel,
+    const uint8_t *const data[3], const uint8_t *const denoised[3], int32_t w,
+    int32_t h, int32_t stride[3], int32_t *sub, const uint8_t *const flat_blocks,
+    int32_t block_size, int32_t num_blocks_w, int32_t num_blocks_h) {
+    const uint8_t *alt_data = channel > 0 ? data[0] : 0;
+    const int32_t is_chroma = channel != 0;
+
+    if (!ar_equation_system_solve(&noise_model->latest_state[channel],
+        is_chroma)) {
+        if (is_chroma) {
+            set_chroma_coefficient_fallback_soln(
+                &noise_model->latest_state[channel].eqns);
+        }
+        else {
+            fprintf(stderr, "Solving latest noise equation system failed %d!\n",
+                channel);
             return AOM_NOISE_STATUS_INTERNAL_ERROR;
         }
+    }
 
-        if (!ar_equation_system_solve(&noise_model->latest_state[channel],
-            is_chroma)) {
-            if (is_chroma) {
-                set_chroma_coefficient_fallback_soln(
-                    &noise_model->latest_state[channel].eqns);
-            }
-            else {
-                fprintf(stderr, "Solving latest noise equation system failed %d!\n",
-                    channel);
-                return AOM_NOISE_STATUS_INTERNAL_ERROR;
-            }
-        }
+    add_noise_std_observations(
+        noise_model, channel, noise_model->latest_state[channel].eqns.x,
+        data[channel], denoised[channel], w, h, stride[channel], sub, alt_data,
+        stride[0], flat_blocks, block_size, num_blocks_w, num_blocks_h);
 
-        add_noise_std_observations(
-            noise_model, channel, noise_model->latest_state[channel].eqns.x,
-            data[channel], denoised[channel], w, h, stride[channel], sub, alt_data,
-            stride[0], flat_blocks, block_size, num_blocks_w, num_blocks_h);
+    if (!aom_noise_strength_solver_solve(
+        &noise_model->latest_state[channel].strength_solver)) {
+        fprintf(stderr, "Solving latest noise strength failed!\n");
+        return AOM_NOISE_STATUS_INTERNAL_ERROR;
+    }
+
+    // Check noise characteristics and return if error.
+//    if (channel == 0 &&
+//        noise_model->combined_state[channel].strength_solver.num_equations >
+//            0 &&
+//        is_noise_model_different(noise_model)) {
+//      y_model_different = 1;
+//    }
 
-        if (!aom_noise_strength_solver_solve(
-            &noise_model->latest_state[channel].strength_solver)) {
-            fprintf(stderr, "Solving latest noise strength failed!\n");
+    noise_model->combined_state[channel].num_observations =
+        noise_model->latest_state[channel].num_observations;
+    equation_system_copy(&noise_model->combined_state[channel].eqns,
+        &noise_model->latest_state[channel].eqns);
+    if (!ar_equation_system_solve(&noise_model->combined_state[channel],
+        is_chroma)) {
+        if (is_chroma) {
+            set_chroma_coefficient_fallback_soln(
+                &noise_model->combined_state[channel].eqns);
+        }
+        else {
+            fprintf(stderr, "Solving combined noise equation system failed %d!\n",
+                channel);
             return AOM_NOISE_STATUS_INTERNAL_ERROR;
         }
+    }
 
-        // Check noise characteristics and return if error.
-    //    if (channel == 0 &&
-    //        noise_model->combined_state[channel].strength_solver.num_equations >
-    //            0 &&
-    //        is_noise_model_different(noise_model)) {
-    //      y_model_different = 1;
-    //    }
-
-        noise_model->combined_state[channel].num_observations =
-            noise_model->latest_state[channel].num_observations;
-        equation_system_copy(&noise_model->combined_state[channel].eqns,
-            &noise_model->latest_state[channel].eqns);
-        if (!ar_equation_system_solve(&noise_model->combined_state[channel],
-            is_chroma)) {
-            if (is_chroma) {
-                set_chroma_coefficient_fallback_soln(
-                    &noise_model->combined_state[channel].eqns);
-            }
-            else {
-                fprintf(stderr, "Solving combined noise equation system failed %d!\n",
-                    channel);
-                return AOM_NOISE_STATUS_INTERNAL_ERROR;
-            }
-        }
+    noise_strength_solver_copy(
+        &noise_model->combined_state[channel].strength_solver,
+        &noise_model->latest_state[channel].strength_solver);
 
-        noise_strength_solver_copy(
-            &noise_model->combined_state[channel].strength_solver,
-            &noise_model->latest_state[channel].strength_solver);
+    if (!aom_noise_strength_solver_solve(
+        &noise_model->combined_state[channel].strength_solver)) {
+        fprintf(stderr, "Solving combined noise strength failed!\n");
+        return AOM_NOISE_STATUS_INTERNAL_ERROR;
+    }
+    return AOM_NOISE_STATUS_OK;
+}
 
-        if (!aom_noise_strength_solver_solve(
-            &noise_model->combined_state[channel].strength_solver)) {
-            fprintf(stderr, "Solving combined noise strength failed!\n");
+aom_noise_status_t aom_noise_model_update(
+    aom_noise_model_t *const noise_model, const uint8_t *const data[3],
+    const uint8_t *const denoised[3], int32_t w, int32_t h, int32_t stride[3],
+    int32_t chroma_sub_log2[2], const uint8_t *const flat_blocks, int32_t block_size) {
+    const int32_t num_blocks_w = (w + block_size - 1) / block_size;
+    const int32_t num_blocks_h = (h + block_size - 1) / block_size;
+    //  int32_t y_model_different = 0;
+    int32_t channel = 0;
+    aom_noise_status_t status = noise_model_update_begin(
+        noise_model, flat_blocks, num_blocks_w, num_blocks_h, block_size);
+    if (status != AOM_NOISE_STATUS_OK)
+        return status;
+
+    for (channel = 0; channel < 3; ++channel) {
+        int32_t no_subsampling[2] = { 0, 0 };
+        const uint8_t *alt_data = channel > 0 ? data[0] : 0;
+        const uint8_t *alt_denoised = channel > 0 ? denoised[0] : 0;
+        int32_t *sub = channel > 0 ? chroma_sub_log2 : no_subsampling;
+        if (!data[channel] || !denoised[channel]) break;
+        if (!add_block_observations(noise_model,
+            &noise_model->latest_state[channel].eqns,
+            &noise_model->latest_state[channel].num_observations, data[channel],
+            denoised[channel], w, h, stride[channel], sub,
+            alt_data, alt_denoised, stride[0], flat_blocks,
+            block_size, num_blocks_w, 0, num_blocks_h)) {
+            fprintf(stderr, "Adding block observation failed\n");
             return AOM_NOISE_STATUS_INTERNAL_ERROR;
         }
+        status = noise_model_update_channel(noise_model, channel, data,
+            denoised, w, h, stride, sub, flat_blocks, block_size, num_blocks_w,
+            num_blocks_h);
+        if (status != AOM_NOISE_STATUS_OK)
+            return status;
     }
 
     return AOM_NOISE_STATUS_OK;
@@ -1360,23 +1434,103 @@ static float *get_half_cos_window(int32_t block_size) {
 DITHER_AND_QUANTIZE(uint8_t, lowbd);
 DITHER_AND_QUANTIZE(uint16_t, highbd);
 
+struct aom_denoise_row_buffers_t {
+    float *plane;
+    float *block;  // 32-byte aligned, room for the complex coefficients
+    double *plane_d;
+    double *block_d;
+    // Transforms of the luma blocks and of the chroma blocks of half the size
+    struct aom_noise_tx_t *tx[2];
+};
+
+EbErrorType aom_denoise_row_buffers_ctor(
+    struct aom_denoise_row_buffers_t **buffers_dbl_ptr, int32_t block_size) {
+    struct aom_denoise_row_buffers_t *buffers;
+    const int32_t pixels_per_block = block_size * block_size;
+    EbErrorType return_error;
+    EB_MALLOC(struct aom_denoise_row_buffers_t *, buffers,
+        sizeof(struct aom_denoise_row_buffers_t), EB_N_PTR);
+    EB_MALLOC(float *, buffers->plane, pixels_per_block * sizeof(float),
+        EB_N_PTR);
+    EB_ALLIGN_MALLOC(float *, buffers->block,
+        2 * pixels_per_block * sizeof(float), EB_A_PTR);
+    EB_MALLOC(double *, buffers->plane_d, pixels_per_block * sizeof(double),
+        EB_N_PTR);
+    EB_MALLOC(double *, buffers->block_d, pixels_per_block * sizeof(double),
+        EB_N_PTR);
+    return_error = aom_noise_tx_ctor(&buffers->tx[0], block_size);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    return_error = aom_noise_tx_ctor(&buffers->tx[1], block_size >> 1);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    *buffers_dbl_ptr = buffers;
+    return EB_ErrorNone;
+}
+
+// Filters the half overlapped blocks of block row by (-1 is the padding row
+// above the picture) at the vertical offset offsy and adds them to result.
+// The block rows at the same offsy do not overlap and can be filtered
+// concurrently, both horizontal offsets are done here so that every result
+// sample gets its terms in the same order as a plane at a time. The buffers
+// hold at least a block, tx is for block_size.
+static void wiener_denoise_block_row(
+    const aom_flat_block_finder_t *block_finder, const uint8_t *const data,
+    int32_t w, int32_t h, int32_t stride, const float *window_function,
+    float *noise_psd, int32_t block_size, int32_t num_blocks_w, int32_t by,
+    int32_t offsy, float *result, int32_t result_stride,
+    const struct aom_denoise_row_buffers_t *buffers,
+    struct aom_noise_tx_t *tx) {
+    const int32_t pixels_per_block = block_size * block_size;
+    float *plane = buffers->plane;
+    float *block = buffers->block;
+    double *block_d = buffers->block_d;
+    double *plane_d = buffers->plane_d;
+
+    for (int32_t offsx = 0; offsx < block_size; offsx += block_size / 2) {
+        for (int32_t bx = -1; bx < num_blocks_w; ++bx) {
+            aom_flat_block_finder_extract_block(
+                block_finder, data, w, h, stride, bx * block_size + offsx,
+                by * block_size + offsy, plane_d, block_d);
+            for (int32_t j = 0; j < pixels_per_block; ++j) {
+                block[j] = (float)block_d[j];
+                plane[j] = (float)plane_d[j];
+            }
+            pointwise_multiply(window_function, block, pixels_per_block);
+            aom_noise_tx_forward(tx, block);
+            aom_noise_tx_filter(tx, noise_psd);
+            aom_noise_tx_inverse(tx, block);
+
+            // Apply window function to the plane approximation (we will apply
+            // it to the sum of plane + block when composing the results).
+            pointwise_multiply(window_function, plane, pixels_per_block);
+
+            for (int32_t y = 0; y < block_size; ++y) {
+                const int32_t y_result = y + (by + 1) * block_size + offsy;
+                for (int32_t x = 0; x < block_size; ++x) {
+                    const int32_t x_result = x + (bx + 1) * block_size + offsx;
+                    result[y_result * result_stride + x_result] +=
+                        (block[y * block_size + x] + plane[y * block_size + x]) *
+                        window_function[y * block_size + x];
+                }
+            }
+        }
+    }
+}
+
 int32_t aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3],
     int32_t w, int32_t h, int32_t stride[3], int32_t chroma_sub[2],
     float *noise_psd[3], int32_t block_size, int32_t bit_depth,
     int32_t use_highbd) {
-    float *plane = NULL, *window_full = NULL,
-        *window_chroma = NULL;
-    DECLARE_ALIGNED(32, float, *block);
-    block = NULL;
-    double *block_d = NULL, *plane_d = NULL;
-    struct aom_noise_tx_t *tx_full = NULL;
-    struct aom_noise_tx_t *tx_chroma = NULL;
+    float *window_full = NULL, *window_chroma = NULL;
     const int32_t num_blocks_w = (w + block_size - 1) / block_size;
     const int32_t num_blocks_h = (h + block_size - 1) / block_size;
     const int32_t result_stride = (num_blocks_w + 2) * block_size;
     const int32_t result_height = (num_blocks_h + 2) * block_size;
     float *result = NULL;
     int32_t init_success = 1;
+    const int32_t pixels_per_block = block_size * block_size;
+    struct aom_denoise_row_buffers_t buffers;
     aom_flat_block_finder_t block_finder_full;
     aom_flat_block_finder_t block_finder_chroma;
     const float kBlockNormalization = (float)((1 << bit_depth) - 1);
@@ -1390,84 +1544,54 @@ int32_t aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3]
         bit_depth, use_highbd);
     result = (float *)malloc((num_blocks_h + 2) * block_size * result_stride *
         sizeof(*result));
-    plane = (float *)malloc(block_size * block_size * sizeof(*plane));
-    block =
-        (float *)aom_memalign(32, 2 * block_size * block_size * sizeof(*block));
-    block_d = (double *)malloc(block_size * block_size * sizeof(*block_d));
-    plane_d = (double *)malloc(block_size * block_size * sizeof(*plane_d));
     window_full = get_half_cos_window(block_size);
-    tx_full = aom_noise_tx_malloc(block_size);
+    buffers.plane = (float *)malloc(pixels_per_block * sizeof(*buffers.plane));
+    buffers.block = (float *)aom_memalign(32,
+        2 * pixels_per_block * sizeof(*buffers.block));
+    buffers.plane_d =
+        (double *)malloc(pixels_per_block * sizeof(*buffers.plane_d));
+    buffers.block_d =
+        (double *)malloc(pixels_per_block * sizeof(*buffers.block_d));
+    buffers.tx[0] = aom_noise_tx_malloc(block_size);
+    buffers.tx[1] = chroma_sub[0] != 0 ?
+        aom_noise_tx_malloc(block_size >> chroma_sub[0]) : NULL;
+    init_success &= (int32_t)((buffers.plane != NULL) &&
+        (buffers.block != NULL) && (buffers.plane_d != NULL) &&
+        (buffers.block_d != NULL) && (buffers.tx[0] != NULL) &&
+        (chroma_sub[0] == 0 || buffers.tx[1] != NULL));
 
     if (chroma_sub[0] != 0) {
         init_success &= aom_flat_block_finder_init(&block_finder_chroma,
             block_size >> chroma_sub[0],
             bit_depth, use_highbd);
         window_chroma = get_half_cos_window(block_size >> chroma_sub[0]);
-        tx_chroma = aom_noise_tx_malloc(block_size >> chroma_sub[0]);
     }
-    else {
+    else
         window_chroma = window_full;
-        tx_chroma = tx_full;
-    }
 
-    init_success &= (int32_t)((tx_full != NULL) && (tx_chroma != NULL) && (plane != NULL) &&
-        (plane_d != NULL) && (block != NULL) && (block_d != NULL) &&
-        (window_full != NULL) && (window_chroma != NULL) &&
+    init_success &= (int32_t)((window_full != NULL) && (window_chroma != NULL) &&
         (result != NULL));
     for (int32_t c = init_success ? 0 : 3; c < 3; ++c) {
         float *window_function = c == 0 ? window_full : window_chroma;
         aom_flat_block_finder_t *block_finder = &block_finder_full;
+        struct aom_noise_tx_t *tx = buffers.tx[c > 0 && chroma_sub[0] != 0];
         const int32_t chroma_sub_h = c > 0 ? chroma_sub[1] : 0;
         const int32_t chroma_sub_w = c > 0 ? chroma_sub[0] : 0;
-        struct aom_noise_tx_t *tx =
-            (c > 0 && chroma_sub[0] > 0) ? tx_chroma : tx_full;
         if (!data[c] || !denoised[c]) continue;
         if (c > 0 && chroma_sub[0] != 0) {
             block_finder = &block_finder_chroma;
         }
         memset(result, 0, sizeof(*result) * result_stride * result_height);
-        // Do overlapped block processing (half overlapped). The block rows can
-        // easily be done in parallel
+        // Do overlapped block processing (half overlapped).
         for (int32_t offsy = 0; offsy < (block_size >> chroma_sub_h);
             offsy += (block_size >> chroma_sub_h) / 2) {
-            for (int32_t offsx = 0; offsx < (block_size >> chroma_sub_w);
-                offsx += (block_size >> chroma_sub_w) / 2) {
-                // Pad the boundary when processing each block-set.
-                for (int32_t by = -1; by < num_blocks_h; ++by) {
-                    for (int32_t bx = -1; bx < num_blocks_w; ++bx) {
-                        const int32_t pixels_per_block =
-                            (block_size >> chroma_sub_w) * (block_size >> chroma_sub_h);
-                        aom_flat_block_finder_extract_block(
-                            block_finder, data[c], w >> chroma_sub_w, h >> chroma_sub_h,
-                            stride[c], bx * (block_size >> chroma_sub_w) + offsx,
-                            by * (block_size >> chroma_sub_h) + offsy, plane_d, block_d);
-                        for (int32_t j = 0; j < pixels_per_block; ++j) {
-                            block[j] = (float)block_d[j];
-                            plane[j] = (float)plane_d[j];
-                        }
-                        pointwise_multiply(window_function, block, pixels_per_block);
-                        aom_noise_tx_forward(tx, block);
-                        aom_noise_tx_filter(tx, noise_psd[c]);
-                        aom_noise_tx_inverse(tx, block);
-
-                        // Apply window function to the plane approximation (we will apply
-                        // it to the sum of plane + block when composing the results).
-                        pointwise_multiply(window_function, plane, pixels_per_block);
-
-                        for (int32_t y = 0; y < (block_size >> chroma_sub_h); ++y) {
-                            const int32_t y_result =
-                                y + (by + 1) * (block_size >> chroma_sub_h) + offsy;
-                            for (int32_t x = 0; x < (block_size >> chroma_sub_w); ++x) {
-                                const int32_t x_result =
-                                    x + (bx + 1) * (block_size >> chroma_sub_w) + offsx;
-                                result[y_result * result_stride + x_result] +=
-                                    (block[y * (block_size >> chroma_sub_w) + x] +
-                                        plane[y * (block_size >> chroma_sub_w) + x]) *
-                                    window_function[y * (block_size >> chroma_sub_w) + x];
-                            }
-                        }
-                    }
-                }
+            // Pad the boundary when processing each block-set.
+            for (int32_t by = -1; by < num_blocks_h; ++by) {
+                wiener_denoise_block_row(block_finder, data[c],
+                    w >> chroma_sub_w, h >> chroma_sub_h, stride[c],
+                    window_function, noise_psd[c], block_size >> chroma_sub_w,
+                    num_blocks_w, by, offsy, result, result_stride, &buffers,
+                    tx);
             }
         }
         if (use_highbd) {
@@ -1482,19 +1606,18 @@ int32_t aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3]
         }
     }
     free(result);
-    free(plane);
-    aom_free(block);
-    free(plane_d);
-    free(block_d);
     free(window_full);
-
-    aom_noise_tx_free(tx_full);
+    free(buffers.plane);
+    aom_free(buffers.block);
+    free(buffers.plane_d);
+    free(buffers.block_d);
+    aom_noise_tx_free(buffers.tx[0]);
+    aom_noise_tx_free(buffers.tx[1]);
 
     aom_flat_block_finder_free(&block_finder_full);
     if (chroma_sub[0] != 0) {
         aom_flat_block_finder_free(&block_finder_chroma);
         free(window_chroma);
-        aom_noise_tx_free(tx_chroma);
     }
     return init_success;
 }
@@ -1522,6 +1645,27 @@ struct aom_denoise_and_model_t {
 
     aom_flat_block_finder_t flat_block_finder;
     aom_noise_model_t noise_model;
+
+    // State of the picture between aom_denoise_and_model_start() and
+    // aom_denoise_and_model_finish(), shared by the threads running its rows
+    volatile int32_t failed;
+    int32_t use_highbd;
+    int32_t pic_width;
+    int32_t pic_height;
+    int32_t strides[3];
+    int32_t chroma_sub_log2[2];
+    uint8_t *raw_data[3];
+    float *window[2];
+    aom_flat_block_finder_t chroma_block_finder;
+    float *result[3];
+    int32_t result_stride;
+    index_and_score_t *scores;
+    aom_equation_system_t *row_eqns;
+    int32_t *row_num_observations;
+    aom_noise_status_t noise_status;
+
+    // Buffers of aom_denoise_and_model_run(), built on its first call
+    struct aom_denoise_row_buffers_t *row_buffers;
 };
 
 
@@ -1596,16 +1740,39 @@ EbErrorType denoise_and_model_ctor(EbPtr *object_dbl_ptr,
     return return_error;
 }
 
-void aom_denoise_and_model_free(struct aom_denoise_and_model_t *ctx, int32_t use_highbd) {
+static void denoise_and_model_free_picture_buffers(
+    struct aom_denoise_and_model_t *ctx) {
+    for (int32_t i = 0; i < 3 * ctx->num_blocks_h && ctx->row_eqns; ++i)
+        equation_system_free(&ctx->row_eqns[i]);
+    free(ctx->row_eqns);
+    free(ctx->row_num_observations);
+    free(ctx->scores);
+    for (int32_t i = 0; i < 3; ++i) {
+        free(ctx->result[i]);
+        ctx->result[i] = NULL;
+    }
+    for (int32_t i = 0; i < 2; ++i) {
+        free(ctx->window[i]);
+        ctx->window[i] = NULL;
+    }
+    ctx->row_eqns = NULL;
+    ctx->row_num_observations = NULL;
+    ctx->scores = NULL;
+    aom_flat_block_finder_free(&ctx->chroma_block_finder);
+    aom_flat_block_finder_free(&ctx->flat_block_finder);
+    aom_noise_model_free(&ctx->noise_model);
     free(ctx->flat_blocks);
+    ctx->flat_blocks = NULL;
+}
+
+void aom_denoise_and_model_free(struct aom_denoise_and_model_t *ctx, int32_t use_highbd) {
+    denoise_and_model_free_picture_buffers(ctx);
     for (int32_t i = 0; i < 3; ++i) {
         free(ctx->denoised[i]);
         free(ctx->noise_psd[i]);
         if (use_highbd)
             free(ctx->packed[i]);
     }
-    aom_noise_model_free(&ctx->noise_model);
-    aom_flat_block_finder_free(&ctx->flat_block_finder);
     free(ctx);
 }
 
@@ -1616,16 +1783,35 @@ static int32_t denoise_and_model_realloc_if_necessary(struct aom_denoise_and_mod
 
     const int32_t block_size = ctx->block_size;
 
-    free(ctx->flat_blocks);
-    ctx->flat_blocks = NULL;
+    denoise_and_model_free_picture_buffers(ctx);
 
     ctx->num_blocks_w = (sd->width + ctx->block_size - 1) / ctx->block_size;
     ctx->num_blocks_h = (sd->height + ctx->block_size - 1) / ctx->block_size;
     ctx->flat_blocks = malloc(ctx->num_blocks_w * ctx->num_blocks_h);
+    ctx->scores = (index_and_score_t *)malloc(
+        ctx->num_blocks_w * ctx->num_blocks_h * sizeof(*ctx->scores));
+
+    // Each plane keeps its overlapped block sums until it is dithered, so the
+    // planes can be filtered at the same time
+    ctx->result_stride = (ctx->num_blocks_w + 2) * block_size;
+    for (int32_t c = 0; c < 3; ++c) {
+        const int32_t result_height =
+            (ctx->num_blocks_h + 2) * (block_size >> (c > 0 ? chroma_sub_log2[1] : 0));
+        ctx->result[c] = (float *)malloc(
+            result_height * ctx->result_stride * sizeof(*ctx->result[c]));
+    }
+    ctx->window[0] = get_half_cos_window(block_size);
+    ctx->window[1] = get_half_cos_window(block_size >> chroma_sub_log2[0]);
+    if (!ctx->flat_blocks || !ctx->scores || !ctx->result[0] ||
+        !ctx->result[1] || !ctx->result[2] || !ctx->window[0] || !ctx->window[1]) {
+        fprintf(stderr, "Unable to allocate denoising buffers\n");
+        return 0;
+    }
 
-    aom_flat_block_finder_free(&ctx->flat_block_finder);
     if (!aom_flat_block_finder_init(&ctx->flat_block_finder, ctx->block_size,
-        ctx->bit_depth, use_highbd)) {
+        ctx->bit_depth, use_highbd) ||
+        !aom_flat_block_finder_init(&ctx->chroma_block_finder,
+        ctx->block_size >> chroma_sub_log2[0], ctx->bit_depth, use_highbd)) {
         fprintf(stderr, "Unable to init flat block finder\n");
         return 0;
     }
@@ -1638,6 +1824,22 @@ static int32_t denoise_and_model_realloc_if_necessary(struct aom_denoise_and_mod
         return 0;
     }
 
+    // Equation systems of the block rows of each channel, summed once all the
+    // rows are observed
+    ctx->row_eqns = (aom_equation_system_t *)calloc(3 * ctx->num_blocks_h,
+        sizeof(*ctx->row_eqns));
+    ctx->row_num_observations = (int32_t *)malloc(3 * ctx->num_blocks_h *
+        sizeof(*ctx->row_num_observations));
+    if (!ctx->row_eqns || !ctx->row_num_observations) {
+        fprintf(stderr, "Unable to allocate block row equation systems\n");
+        return 0;
+    }
+    for (int32_t i = 0; i < 3 * ctx->num_blocks_h; ++i) {
+        if (!equation_system_init(&ctx->row_eqns[i],
+            ctx->noise_model.latest_state[i / ctx->num_blocks_h].eqns.n))
+            return 0;
+    }
+
     // Simply use a flat PSD (although we could use the flat blocks to estimate
     // PSD) those to estimate an actual noise PSD)
     const float y_noise_level =
@@ -1743,19 +1945,49 @@ static void unpack_2d_pic(uint8_t *packed[3],
 
 }
 
-int32_t aom_denoise_and_model_run(struct aom_denoise_and_model_t *ctx,
+int32_t aom_denoise_and_model_max_row_count(
+    const struct aom_denoise_and_model_t *ctx) {
+    const int32_t num_blocks_h =
+        (ctx->height + ctx->block_size - 1) / ctx->block_size;
+    return 4 * num_blocks_h + 3;
+}
+
+int32_t aom_denoise_and_model_row_count(const struct aom_denoise_and_model_t *ctx,
+    aom_denoise_phase_t phase) {
+    const int32_t num_blocks_h = ctx->num_blocks_h;
+    switch (phase) {
+    case AOM_DENOISE_PHASE_FILTER_EVEN:
+        return num_blocks_h + 3 * (num_blocks_h + 1);
+    case AOM_DENOISE_PHASE_FILTER_ODD:
+        return 3 * (num_blocks_h + 1);
+    case AOM_DENOISE_PHASE_DITHER:
+        return 3;
+    default:
+        return 3 * num_blocks_h;
+    }
+}
+
+int32_t aom_denoise_and_model_start(struct aom_denoise_and_model_t *ctx,
     EbPictureBufferDesc_t *sd,
-    aom_film_grain_t *film_grain,
     int32_t use_highbd,
     EbAsm asm_type) {
 
-    const int32_t block_size = ctx->block_size;
-    uint8_t *raw_data[3];
-    int32_t chroma_sub_log2[2] = { 1, 1 };  //todo: send chroma subsampling
-    int32_t strides[3] = { sd->stride_y, sd->strideCb, sd->strideCr };
+    int32_t *chroma_sub_log2 = ctx->chroma_sub_log2;
+    uint8_t **raw_data = ctx->raw_data;
+
+    chroma_sub_log2[0] = chroma_sub_log2[1] = 1;  //todo: send chroma subsampling
+    ctx->failed = 0;
+    ctx->noise_status = AOM_NOISE_STATUS_INTERNAL_ERROR;
+    ctx->use_highbd = use_highbd;
+    ctx->pic_width = sd->width;
+    ctx->pic_height = sd->height;
+    ctx->strides[0] = sd->stride_y;
+    ctx->strides[1] = sd->strideCb;
+    ctx->strides[2] = sd->strideCr;
 
     if (!denoise_and_model_realloc_if_necessary(ctx, sd, use_highbd)) {
         fprintf(stderr, "Unable to realloc buffers\n");
+        ctx->failed = 1;
         return 0;
     }
 
@@ -1773,26 +2005,157 @@ int32_t aom_denoise_and_model_run(struct aom_denoise_and_model_t *ctx,
         raw_data[1] = (uint8_t *)(ctx->packed[1]);
         raw_data[2] = (uint8_t *)(ctx->packed[2]);
     }
+    return 1;
+}
 
-    const uint8_t *const data[3] = { raw_data[0], raw_data[1], raw_data[2] };
+static void denoise_and_model_score_row(struct aom_denoise_and_model_t *ctx,
+    const struct aom_denoise_row_buffers_t *buffers, int32_t by) {
+    flat_block_finder_score_row(&ctx->flat_block_finder, ctx->raw_data[0],
+        ctx->pic_width, ctx->pic_height, ctx->strides[0], by,
+        ctx->flat_blocks, ctx->scores, buffers->plane_d, buffers->block_d);
+}
 
-    aom_flat_block_finder_run(&ctx->flat_block_finder, data[0], sd->width,
-        sd->height, strides[0], ctx->flat_blocks);
+// Row of FILTER_EVEN (odd = 0) or FILTER_ODD (odd = 1), the rows are the
+// block rows -1 to num_blocks_h - 1 of the planes one after the other.
+static void denoise_and_model_filter_row(struct aom_denoise_and_model_t *ctx,
+    const struct aom_denoise_row_buffers_t *buffers, int32_t row, int32_t odd) {
+    const int32_t c = row / (ctx->num_blocks_h + 1);
+    const int32_t by = row % (ctx->num_blocks_h + 1) - 1;
+    const int32_t sub = c > 0 ? ctx->chroma_sub_log2[0] : 0;
+    const int32_t block_size = ctx->block_size >> sub;
+    float *result = ctx->result[c];
+
+    if (!odd) {
+        // The even block rows tile the result, each clears its band before
+        // adding to it and the last one the band the odd rows spill into
+        const int32_t band_rows = by + 1 == ctx->num_blocks_h ? 2 * block_size : block_size;
+        memset(result + (by + 1) * block_size * ctx->result_stride, 0,
+            sizeof(*result) * band_rows * ctx->result_stride);
+    }
+    wiener_denoise_block_row(
+        c > 0 ? &ctx->chroma_block_finder : &ctx->flat_block_finder,
+        ctx->raw_data[c], ctx->pic_width >> sub, ctx->pic_height >> sub,
+        ctx->strides[c], ctx->window[c > 0], ctx->noise_psd[c], block_size,
+        ctx->num_blocks_w, by, odd ? block_size / 2 : 0, result,
+        ctx->result_stride, buffers, buffers->tx[block_size != ctx->block_size]);
+}
 
-    if (!aom_wiener_denoise_2d(data, ctx->denoised, sd->width, sd->height,
-        strides, chroma_sub_log2, ctx->noise_psd,
-        block_size, ctx->bit_depth, use_highbd)) {
-        fprintf(stderr, "Unable to denoise image\n");
-        return 0;
+static void denoise_and_model_dither_plane(struct aom_denoise_and_model_t *ctx,
+    int32_t c) {
+    const int32_t chroma_sub_w = c > 0 ? ctx->chroma_sub_log2[0] : 0;
+    const int32_t chroma_sub_h = c > 0 ? ctx->chroma_sub_log2[1] : 0;
+    const float kBlockNormalization = (float)((1 << ctx->bit_depth) - 1);
+    if (ctx->use_highbd) {
+        dither_and_quantize_highbd(ctx->result[c], ctx->result_stride,
+            (uint16_t *)ctx->denoised[c], ctx->pic_width, ctx->pic_height,
+            ctx->strides[c], chroma_sub_w, chroma_sub_h, ctx->block_size,
+            kBlockNormalization);
+    }
+    else {
+        dither_and_quantize_lowbd(ctx->result[c], ctx->result_stride,
+            ctx->denoised[c], ctx->pic_width, ctx->pic_height, ctx->strides[c],
+            chroma_sub_w, chroma_sub_h, ctx->block_size, kBlockNormalization);
+    }
+}
+
+static void denoise_and_model_observe_row(struct aom_denoise_and_model_t *ctx,
+    int32_t c, int32_t by) {
+    int32_t no_subsampling[2] = { 0, 0 };
+    aom_equation_system_t *eqns = &ctx->row_eqns[c * ctx->num_blocks_h + by];
+    int32_t *num_observations =
+        &ctx->row_num_observations[c * ctx->num_blocks_h + by];
+
+    equation_system_clear(eqns);
+    *num_observations = 0;
+    if (!add_block_observations(&ctx->noise_model, eqns, num_observations,
+        ctx->raw_data[c], ctx->denoised[c], ctx->pic_width, ctx->pic_height,
+        ctx->strides[c], c > 0 ? ctx->chroma_sub_log2 : no_subsampling,
+        c > 0 ? ctx->raw_data[0] : 0, c > 0 ? ctx->denoised[0] : 0,
+        ctx->strides[0], ctx->flat_blocks, ctx->block_size, ctx->num_blocks_w,
+        by, by + 1)) {
+        fprintf(stderr, "Adding block observation failed\n");
+        ctx->failed = 1;
+    }
+}
+
+void aom_denoise_and_model_run_row(struct aom_denoise_and_model_t *ctx,
+    const struct aom_denoise_row_buffers_t *buffers, aom_denoise_phase_t phase,
+    int32_t row) {
+    const int32_t num_blocks_h = ctx->num_blocks_h;
+    if (ctx->failed)
+        return;
+    switch (phase) {
+    case AOM_DENOISE_PHASE_FILTER_EVEN:
+        if (row < num_blocks_h)
+            denoise_and_model_score_row(ctx, buffers, row);
+        else
+            denoise_and_model_filter_row(ctx, buffers, row - num_blocks_h, 0);
+        break;
+    case AOM_DENOISE_PHASE_FILTER_ODD:
+        denoise_and_model_filter_row(ctx, buffers, row, 1);
+        break;
+    case AOM_DENOISE_PHASE_DITHER:
+        denoise_and_model_dither_plane(ctx, row);
+        break;
+    default:
+        denoise_and_model_observe_row(ctx, row / num_blocks_h, row % num_blocks_h);
+        break;
     }
+}
 
-    const aom_noise_status_t status = aom_noise_model_update(
-        &ctx->noise_model, data, (const uint8_t *const *)ctx->denoised,
-        sd->width, sd->height, strides, chroma_sub_log2, ctx->flat_blocks,
-        block_size);
+// Sums the block row systems in block row order, so the model does not depend
+// on the threads the rows ran on, and solves the channels.
+static aom_noise_status_t denoise_and_model_update(
+    struct aom_denoise_and_model_t *ctx) {
+    aom_noise_model_t *const noise_model = &ctx->noise_model;
+    const uint8_t *const data[3] = { ctx->raw_data[0], ctx->raw_data[1],
+        ctx->raw_data[2] };
+    const uint8_t *const denoised[3] = { ctx->denoised[0], ctx->denoised[1],
+        ctx->denoised[2] };
+    aom_noise_status_t status = noise_model_update_begin(noise_model,
+        ctx->flat_blocks, ctx->num_blocks_w, ctx->num_blocks_h, ctx->block_size);
+
+    for (int32_t c = 0; c < 3 && status == AOM_NOISE_STATUS_OK; ++c) {
+        int32_t no_subsampling[2] = { 0, 0 };
+        for (int32_t by = 0; by < ctx->num_blocks_h; ++by) {
+            equation_system_add(&noise_model->latest_state[c].eqns,
+                &ctx->row_eqns[c * ctx->num_blocks_h + by]);
+            noise_model->latest_state[c].num_observations +=
+                ctx->row_num_observations[c * ctx->num_blocks_h + by];
+        }
+        status = noise_model_update_channel(noise_model, c, data, denoised,
+            ctx->pic_width, ctx->pic_height, ctx->strides,
+            c > 0 ? ctx->chroma_sub_log2 : no_subsampling, ctx->flat_blocks,
+            ctx->block_size, ctx->num_blocks_w, ctx->num_blocks_h);
+    }
+    return status;
+}
 
+void aom_denoise_and_model_end_phase(struct aom_denoise_and_model_t *ctx,
+    aom_denoise_phase_t phase) {
+    if (ctx->failed)
+        return;
+    if (phase == AOM_DENOISE_PHASE_FILTER_EVEN) {
+        flat_block_finder_add_top_scores(ctx->scores,
+            ctx->num_blocks_w * ctx->num_blocks_h, ctx->flat_blocks);
+    }
+    else if (phase == AOM_DENOISE_PHASE_MODEL)
+        ctx->noise_status = denoise_and_model_update(ctx);
+}
+
+int32_t aom_denoise_and_model_finish(struct aom_denoise_and_model_t *ctx,
+    EbPictureBufferDesc_t *sd,
+    aom_film_grain_t *film_grain,
+    EbAsm asm_type) {
+
+    const int32_t use_highbd = ctx->use_highbd;
+    const int32_t *strides = ctx->strides;
+    const int32_t *chroma_sub_log2 = ctx->chroma_sub_log2;
+    uint8_t **raw_data = ctx->raw_data;
+    int32_t ret = !ctx->failed;
     int32_t have_noise_estimate = 0;
-    if (status == AOM_NOISE_STATUS_OK || status == AOM_NOISE_STATUS_DIFFERENT_NOISE_TYPE) {
+    if (ret && (ctx->noise_status == AOM_NOISE_STATUS_OK ||
+        ctx->noise_status == AOM_NOISE_STATUS_DIFFERENT_NOISE_TYPE)) {
         aom_noise_model_save_latest(&ctx->noise_model);
         have_noise_estimate = 1;
     }
@@ -1801,25 +2164,52 @@ int32_t aom_denoise_and_model_run(struct aom_denoise_and_model_t *ctx,
     if (have_noise_estimate) {
         if (!aom_noise_model_get_grain_parameters(&ctx->noise_model, film_grain)) {
             fprintf(stderr, "Unable to get grain parameters.\n");
-            return 0;
-        }
-        film_grain->apply_grain = 1;
-
-        if (!use_highbd) {
-            memcpy(raw_data[0], ctx->denoised[0],
-                (strides[0] * sd->height) << use_highbd);
-            memcpy(raw_data[1], ctx->denoised[1],
-                (strides[1] * (sd->height >> chroma_sub_log2[0])) << use_highbd);
-            memcpy(raw_data[2], ctx->denoised[2],
-                (strides[2] * (sd->height >> chroma_sub_log2[0])) << use_highbd);
+            ret = 0;
         }
         else {
-            unpack_2d_pic(ctx->denoised, sd, asm_type);
+            film_grain->apply_grain = 1;
+
+            if (!use_highbd) {
+                memcpy(raw_data[0], ctx->denoised[0],
+                    (strides[0] * sd->height) << use_highbd);
+                memcpy(raw_data[1], ctx->denoised[1],
+                    (strides[1] * (sd->height >> chroma_sub_log2[0])) << use_highbd);
+                memcpy(raw_data[2], ctx->denoised[2],
+                    (strides[2] * (sd->height >> chroma_sub_log2[0])) << use_highbd);
+            }
+            else {
+                unpack_2d_pic(ctx->denoised, sd, asm_type);
+            }
         }
     }
-    aom_flat_block_finder_free(&ctx->flat_block_finder);
-    aom_noise_model_free(&ctx->noise_model);
-    free(ctx->flat_blocks);
+    denoise_and_model_free_picture_buffers(ctx);
 
-    return 1;
+    return ret;
+}
+
+int32_t aom_denoise_and_model_run(struct aom_denoise_and_model_t *ctx,
+    EbPictureBufferDesc_t *sd,
+    aom_film_grain_t *film_grain,
+    int32_t use_highbd,
+    EbAsm asm_type) {
+
+    // The rows all run on the calling thread, which builds its buffers once
+    if (!ctx->row_buffers) {
+        struct aom_denoise_row_buffers_t *row_buffers = NULL;
+        if (aom_denoise_row_buffers_ctor(&row_buffers, ctx->block_size) !=
+            EB_ErrorNone)
+            return 0;
+        ctx->row_buffers = row_buffers;
+    }
+    if (aom_denoise_and_model_start(ctx, sd, use_highbd, asm_type)) {
+        for (int32_t phase = 0; phase < AOM_DENOISE_PHASE_COUNT; ++phase) {
+            const int32_t row_count =
+                aom_denoise_and_model_row_count(ctx, (aom_denoise_phase_t)phase);
+            for (int32_t row = 0; row < row_count; ++row)
+                aom_denoise_and_model_run_row(ctx, ctx->row_buffers,
+                    (aom_denoise_phase_t)phase, row);
+            aom_denoise_and_model_end_phase(ctx, (aom_denoise_phase_t)phase);
+        }
+    }
+    return aom_denoise_and_model_finish(ctx, sd, film_grain, asm_type);
 }
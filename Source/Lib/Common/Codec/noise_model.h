@@ -306,6 +306,19 @@ extern "C" {
 
     struct aom_denoise_and_model_t;
 
+    /*!\brief Buffers a thread filters and scores the blocks of the rows of
+     * aom_denoise_and_model_run_row() with, built once per thread rather than
+     * per row.
+     */
+    struct aom_denoise_row_buffers_t;
+
+    /*!\brief Allocates the row buffers of a thread from its memory arena.
+     *
+     * \param[in]  block_size  Block size of the denoise and model context
+     */
+    EbErrorType aom_denoise_row_buffers_ctor(
+        struct aom_denoise_row_buffers_t **buffers_dbl_ptr, int32_t block_size);
+
     /*!\brief Denoise the buffer and model the residual noise.
      *
      * This is meant to be called sequentially on input frames. The input buffer
@@ -326,6 +339,62 @@ extern "C" {
         int32_t use_highbd,
         EbAsm asm_type);
 
+    /*!\brief Phases of aom_denoise_and_model_run(). The rows of a phase are
+     * independent and can run on several threads, a phase starts once
+     * aom_denoise_and_model_end_phase() returned for the previous one.
+     */
+    typedef enum {
+        AOM_DENOISE_PHASE_FILTER_EVEN,  // flat block scores, block rows
+        AOM_DENOISE_PHASE_FILTER_ODD,   // half overlapped block rows
+        AOM_DENOISE_PHASE_DITHER,       // one row per plane
+        AOM_DENOISE_PHASE_MODEL,        // noise observations of the block rows
+        AOM_DENOISE_PHASE_COUNT
+    } aom_denoise_phase_t;
+
+    /*!\brief Starts denoising and modeling a picture by phases. The rows of
+     * the phases are skipped once a step failed.
+     *
+     * \param[in]      ctx   Struct allocated with aom_denoise_and_model_alloc
+     * \param[in]      sd    The raw input buffer to be denoised.
+     *
+     * Returns false when the picture buffers can not be allocated, the phases
+     * can then be skipped up to aom_denoise_and_model_finish().
+     */
+    int32_t aom_denoise_and_model_start(struct aom_denoise_and_model_t *ctx,
+        EbPictureBufferDesc_t *sd,
+        int32_t use_highbd,
+        EbAsm asm_type);
+
+    /*!\brief Number of rows of a phase of the started picture.
+     */
+    int32_t aom_denoise_and_model_row_count(const struct aom_denoise_and_model_t *ctx,
+        aom_denoise_phase_t phase);
+
+    /*!\brief Most rows a phase has over the pictures of the context.
+     */
+    int32_t aom_denoise_and_model_max_row_count(
+        const struct aom_denoise_and_model_t *ctx);
+
+    /*!\brief Runs a row of a phase with the buffers of the calling thread.
+     */
+    void aom_denoise_and_model_run_row(struct aom_denoise_and_model_t *ctx,
+        const struct aom_denoise_row_buffers_t *buffers,
+        aom_denoise_phase_t phase, int32_t row);
+
+    /*!\brief Runs the serial part of a phase once all its rows are done.
+     */
+    void aom_denoise_and_model_end_phase(struct aom_denoise_and_model_t *ctx,
+        aom_denoise_phase_t phase);
+
+    /*!\brief Writes the denoised picture back to sd and the noise estimate to
+     * film_grain once all the phases ended. Returns as
+     * aom_denoise_and_model_run().
+     */
+    int32_t aom_denoise_and_model_finish(struct aom_denoise_and_model_t *ctx,
+        EbPictureBufferDesc_t *sd,
+        aom_film_grain_t *film_grain,
+        EbAsm asm_type);
+
     /*!\brief Allocates a context that can be used for denoising and noise modeling.
      *
      * \param[in]  bit_depth   Bit depth of buffers this will be run on.
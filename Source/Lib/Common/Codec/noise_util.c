@@ -37,11 +37,9 @@ struct aom_noise_tx_t {
     void(*ifft)(const float *, float *, float *);
 };
 
-struct aom_noise_tx_t *aom_noise_tx_malloc(int32_t block_size) {
-    struct aom_noise_tx_t *noise_tx =
-        (struct aom_noise_tx_t *)malloc(sizeof(struct aom_noise_tx_t));
-    if (!noise_tx) return NULL;
-    memset(noise_tx, 0, sizeof(*noise_tx));
+// Picks the transforms of the block size, returns 0 if it is unsupported
+static int32_t noise_tx_set_block_size(struct aom_noise_tx_t *noise_tx,
+    int32_t block_size) {
     switch (block_size) {
     case 2:
         noise_tx->fft = aom_fft2x2_float;
@@ -64,11 +62,22 @@ struct aom_noise_tx_t *aom_noise_tx_malloc(int32_t block_size) {
         noise_tx->ifft = aom_ifft32x32_float;
         break;
     default:
-        free(noise_tx);
         fprintf(stderr, "Unsupported block size %d\n", block_size);
-        return NULL;
+        return 0;
     }
     noise_tx->block_size = block_size;
+    return 1;
+}
+
+struct aom_noise_tx_t *aom_noise_tx_malloc(int32_t block_size) {
+    struct aom_noise_tx_t *noise_tx =
+        (struct aom_noise_tx_t *)malloc(sizeof(struct aom_noise_tx_t));
+    if (!noise_tx) return NULL;
+    memset(noise_tx, 0, sizeof(*noise_tx));
+    if (!noise_tx_set_block_size(noise_tx, block_size)) {
+        free(noise_tx);
+        return NULL;
+    }
     noise_tx->tx_block = (float *)aom_memalign(
         32, 2 * sizeof(*noise_tx->tx_block) * block_size * block_size);
     noise_tx->temp = (float *)aom_memalign(
@@ -86,31 +95,50 @@ struct aom_noise_tx_t *aom_noise_tx_malloc(int32_t block_size) {
     return noise_tx;
 }
 
+EbErrorType aom_noise_tx_ctor(struct aom_noise_tx_t **noise_tx_dbl_ptr,
+    int32_t block_size) {
+    struct aom_noise_tx_t *noise_tx;
+    EB_MALLOC(struct aom_noise_tx_t *, noise_tx, sizeof(struct aom_noise_tx_t),
+        EB_N_PTR);
+    if (!noise_tx_set_block_size(noise_tx, block_size))
+        return EB_ErrorBadParameter;
+    // Arena memory is zeroed, which the forward transform relies on as above
+    EB_ALLIGN_MALLOC(float *, noise_tx->tx_block,
+        2 * sizeof(*noise_tx->tx_block) * block_size * block_size, EB_A_PTR);
+    EB_ALLIGN_MALLOC(float *, noise_tx->temp,
+        2 * sizeof(*noise_tx->temp) * block_size * block_size, EB_A_PTR);
+    *noise_tx_dbl_ptr = noise_tx;
+    return EB_ErrorNone;
+}
+
 void aom_noise_tx_forward(struct aom_noise_tx_t *noise_tx, const float *data) {
     noise_tx->fft(data, noise_tx->temp, noise_tx->tx_block);
 }
 
-void aom_noise_tx_filter(struct aom_noise_tx_t *noise_tx, const float *psd) {
-    const int32_t block_size = noise_tx->block_size;
+// Wiener filter of the n complex coefficients of tx_block (interleaved real
+// and imaginary parts) with the noise power spectral density psd
+void aom_noise_tx_filter_block_c(float *tx_block, const float *psd, int32_t n) {
     const float kBeta = 1.1f;
     const float kEps = 1e-6f;
-    for (int32_t y = 0; y < block_size; ++y) {
-        for (int32_t x = 0; x < block_size; ++x) {
-            int32_t i = y * block_size + x;
-            float *c = noise_tx->tx_block + 2 * i;
-            const float p = c[0] * c[0] + c[1] * c[1];
-            if (p > kBeta * psd[i] && p > 1e-6) {
-                noise_tx->tx_block[2 * i + 0] *= (p - psd[i]) / AOMMAX(p, kEps);
-                noise_tx->tx_block[2 * i + 1] *= (p - psd[i]) / AOMMAX(p, kEps);
-            }
-            else {
-                noise_tx->tx_block[2 * i + 0] *= (kBeta - 1.0f) / kBeta;
-                noise_tx->tx_block[2 * i + 1] *= (kBeta - 1.0f) / kBeta;
-            }
+    for (int32_t i = 0; i < n; ++i) {
+        float *c = tx_block + 2 * i;
+        const float p = c[0] * c[0] + c[1] * c[1];
+        if (p > kBeta * psd[i] && p > 1e-6) {
+            tx_block[2 * i + 0] *= (p - psd[i]) / AOMMAX(p, kEps);
+            tx_block[2 * i + 1] *= (p - psd[i]) / AOMMAX(p, kEps);
+        }
+        else {
+            tx_block[2 * i + 0] *= (kBeta - 1.0f) / kBeta;
+            tx_block[2 * i + 1] *= (kBeta - 1.0f) / kBeta;
         }
     }
 }
 
+void aom_noise_tx_filter(struct aom_noise_tx_t *noise_tx, const float *psd) {
+    aom_noise_tx_filter_block(noise_tx->tx_block, psd,
+        noise_tx->block_size * noise_tx->block_size);
+}
+
 void aom_noise_tx_inverse(struct aom_noise_tx_t *noise_tx, float *data) {
     const int32_t n = noise_tx->block_size * noise_tx->block_size;
     noise_tx->ifft(noise_tx->tx_block, noise_tx->temp, data);
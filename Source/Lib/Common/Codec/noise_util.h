@@ -12,6 +12,8 @@
 #ifndef AOM_AOM_DSP_NOISE_UTIL_H_
 #define AOM_AOM_DSP_NOISE_UTIL_H_
 
+#include "EbDefinitions.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -27,6 +29,11 @@ extern "C" {
     struct aom_noise_tx_t *aom_noise_tx_malloc(int32_t block_size);
     void aom_noise_tx_free(struct aom_noise_tx_t *aom_noise_tx);
 
+    // Builds an aom_noise_tx_t like aom_noise_tx_malloc, allocated from the
+    // memory arena of the calling thread rather than free'd.
+    EbErrorType aom_noise_tx_ctor(struct aom_noise_tx_t **noise_tx_dbl_ptr,
+        int32_t block_size);
+
     // Transforms the internal data and holds it in the aom_noise_tx's internal
     // buffer. For compatibility with existing SIMD implementations, "data" must
     // be 32-byte aligned.
@@ -66,6 +66,7 @@
 #include "EbUtility.h"
 #include "EbEncHandle.h"
 #include "EbSystemResourceManager.h"
+#include "EbTaskScheduler.h"
 #include "EbPictureControlSet.h"
 #include "EbPictureOperators.h"
 #include "EbSequenceControlSet.h"
@@ -98,6 +99,7 @@
 #include "EbDlfProcess.h"
 #include "EbCdefProcess.h"
 #include "EbRestProcess.h"
+#include "EbPipelineStats.h"
 
 
 #ifdef _WIN32
@@ -136,10 +138,9 @@
 
 // Output Buffer Transfer Parameters
 #define EB_OUTPUTSTREAMBUFFERSIZE                                       0x2DC6C0   //0x7D00        // match MTU Size
-#define EB_OUTPUTRECONBUFFERSIZE                                        (MAX_PICTURE_WIDTH_SIZE*MAX_PICTURE_HEIGHT_SIZE*2)   // Recon Slice Size
 #define EB_OUTPUTSTATISTICSBUFFERSIZE                                   0x30            // 6X8 (8 Bytes for Y, U, V, number of bits, picture number, QP)
 #define EOS_NAL_BUFFER_SIZE                                             0x0010 // Bitstream used to code EOS NAL
-#define EB_OUTPUTSTREAMBUFFERSIZE_MACRO(ResolutionSize)                ((ResolutionSize) < (INPUT_SIZE_1080i_TH) ? 0x1E8480 : (ResolutionSize) < (INPUT_SIZE_1080p_TH) ? 0x2DC6C0 : (ResolutionSize) < (INPUT_SIZE_4K_TH) ? 0x2DC6C0 : 0x2DC6C0  )
+#define EB_OUTPUTSTREAMBUFFERSIZE_MACRO(ResolutionSize)                ((ResolutionSize) < (INPUT_SIZE_1080i_TH) ? 0x1E8480 : (ResolutionSize) < (INPUT_SIZE_1080p_TH) ? 0x2DC6C0 : (ResolutionSize) < (INPUT_SIZE_4K_TH) ? 0x2DC6C0 : (ResolutionSize) < (INPUT_SIZE_8K_TH) ? 0x2DC6C0 : 0x7A1200  )
 
 #define ENCDEC_INPUT_PORT_MDC                                0
 #define ENCDEC_INPUT_PORT_ENCDEC                             1
@@ -147,14 +148,17 @@
 
 #define SCD_LAD                                              6
 
+// Objects constructed at init in each pool with lazy_pool_allocation
+#define LAZY_POOL_INIT_COUNT                                 4
+
+// Alignment of the planes of the input frames allocated by the application
+#define INPUT_FRAME_ALIGNMENT                                64
+#define INPUT_FRAME_ALIGN(size)                              (((size) + INPUT_FRAME_ALIGNMENT - 1) & ~(INPUT_FRAME_ALIGNMENT - 1))
+
 /**************************************
  * Globals
  **************************************/
 
-EbMemoryMapEntry                 *memory_map;
-uint32_t                         *memory_map_index;
-uint64_t                         *total_lib_memory;
-
 uint32_t                         libMallocCount = 0;
 uint32_t                         lib_thread_count = 0;
 uint32_t                         libSemaphoreCount = 0;
@@ -174,6 +178,95 @@ typedef struct logicalProcessorGroup {
 processorGroup                   lp_group[MAX_PROCESSOR_GROUP];
 #endif
 
+/**************************************
+ * Input Frame Header
+ *   Start of the input frames allocated with
+ *   eb_svt_enc_allocate_input_frame, followed by
+ *   the planes. The blank frame has no
+ *   release_buffer.
+ **************************************/
+typedef struct EbInputFrameHeader
+{
+    EbExtFrameBuf                 frame_buf;
+    eb_release_frame_buffer       release_buffer;
+    void                         *priv_data;
+} EbInputFrameHeader;
+
+/**************************************
+ * Input Frame Layout
+ *   Offsets of the padded Y, Cb and Cr planes,
+ *   then of the 2 bit Y, Cb and Cr planes of
+ *   compressed 10 bit input, from the start of
+ *   the frame.
+ **************************************/
+typedef struct EbInputFrameLayout
+{
+    uint32_t                      luma_stride;
+    uint32_t                      chroma_stride;
+    uint32_t                      plane_offset[6];
+    uint32_t                      frame_size;
+} EbInputFrameLayout;
+
+static void InputFrameLayout(
+    SequenceControlSet           *sequence_control_set_ptr,
+    EbInputFrameLayout           *layout_ptr)
+{
+    EbBool   is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    uint32_t maxWidth = sequence_control_set_ptr->max_input_luma_width;
+    uint32_t maxHeight = sequence_control_set_ptr->max_input_luma_height;
+    uint32_t lumaSize;
+    uint32_t planeSize[6];
+    uint32_t planeIndex;
+    uint32_t offset = INPUT_FRAME_ALIGN((uint32_t)sizeof(EbInputFrameHeader));
+
+    layout_ptr->luma_stride = maxWidth + sequence_control_set_ptr->left_padding + sequence_control_set_ptr->right_padding;
+    layout_ptr->chroma_stride = layout_ptr->luma_stride >> 1;
+
+    // Same sizes as allocate_frame_buffer
+    lumaSize = layout_ptr->luma_stride * (maxHeight + sequence_control_set_ptr->top_padding + sequence_control_set_ptr->bot_padding);
+    planeSize[0] = lumaSize;
+    planeSize[1] = lumaSize >> 2;
+    planeSize[2] = lumaSize >> 2;
+    planeSize[3] = is16bit ? (maxWidth / 4) * maxHeight : 0;
+    planeSize[4] = is16bit ? (maxWidth / 8) * (maxHeight / 2) : 0;
+    planeSize[5] = is16bit ? (maxWidth / 8) * (maxHeight / 2) : 0;
+
+    for (planeIndex = 0; planeIndex < 6; ++planeIndex) {
+        layout_ptr->plane_offset[planeIndex] = offset;
+        offset += INPUT_FRAME_ALIGN(planeSize[planeIndex]);
+    }
+    layout_ptr->frame_size = offset;
+}
+
+/**************************************
+ * Input Frame Release Callback
+ *   Hands the frame referenced by an input
+ *   buffer back to the application once the
+ *   last stage has released the buffer.
+ **************************************/
+static void InputFrameReleaseCallback(
+    EbObjectWrapper              *wrapper_ptr)
+{
+    EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)((EbBufferHeaderType*)wrapper_ptr->object_ptr)->p_buffer;
+    EbInputFrameHeader    *frameHeaderPtr;
+
+    if (input_picture_ptr->buffer_y == NULL)
+        return;
+
+    // The luma plane follows the header
+    frameHeaderPtr = (EbInputFrameHeader*)(input_picture_ptr->buffer_y - INPUT_FRAME_ALIGN((uint32_t)sizeof(EbInputFrameHeader)));
+
+    input_picture_ptr->buffer_y = (EbByte)EB_NULL;
+    input_picture_ptr->bufferCb = (EbByte)EB_NULL;
+    input_picture_ptr->bufferCr = (EbByte)EB_NULL;
+    input_picture_ptr->bufferBitIncY = (EbByte)EB_NULL;
+    input_picture_ptr->bufferBitIncCb = (EbByte)EB_NULL;
+    input_picture_ptr->bufferBitIncCr = (EbByte)EB_NULL;
+
+    if (frameHeaderPtr->release_buffer)
+        frameHeaderPtr->release_buffer(&frameHeaderPtr->frame_buf, frameHeaderPtr->priv_data);
+}
+
 /**************************************
 * Instruction Set Support
 **************************************/
@@ -244,6 +337,47 @@ static int32_t CanUseIntelCore4thGenFeatures()
         the_4th_gen_features_available = Check4thGenIntelCoreFeatures();
     return the_4th_gen_features_available;
 }
+int32_t CheckXcr0Zmm()
+{
+    uint32_t xcr0;
+    uint32_t zmm_ymm_xmm = (7 << 5) | (1 << 2) | (1 << 1);
+#if defined(_MSC_VER)
+    xcr0 = (uint32_t)_xgetbv(0);  /* min VS2010 SP1 compiler is required */
+#else
+    __asm__("xgetbv" : "=a" (xcr0) : "c" (0) : "%edx");
+#endif
+    return ((xcr0 & zmm_ymm_xmm) == zmm_ymm_xmm); /* checking if xmm, ymm, opmask and zmm states are enabled in XCR0 */
+}
+int32_t CheckAvx512Features()
+{
+    int32_t abcd[4];
+    int32_t avx512_mask = (1 << 16) | (1 << 17) | (1 << 30) | (1 << 31);
+
+    /* The OSXSAVE and XCR0 ymm checks are part of the 4th gen test */
+    if (!CanUseIntelCore4thGenFeatures())
+        return 0;
+
+    /* The OS must save the opmask and zmm registers on context switches */
+    if (!CheckXcr0Zmm())
+        return 0;
+
+    /*  CPUID.(EAX=07H, ECX=0H):EBX.AVX512F[bit 16]==1  &&
+        CPUID.(EAX=07H, ECX=0H):EBX.AVX512DQ[bit 17]==1 &&
+        CPUID.(EAX=07H, ECX=0H):EBX.AVX512BW[bit 30]==1 &&
+        CPUID.(EAX=07H, ECX=0H):EBX.AVX512VL[bit 31]==1 */
+    RunCpuid(7, 0, abcd);
+    if ((abcd[1] & avx512_mask) != avx512_mask)
+        return 0;
+    return 1;
+}
+static int32_t CanUseIntelAvx512()
+{
+    static int32_t the_avx512_features_available = -1;
+    /* test is performed once */
+    if (the_avx512_features_available < 0)
+        the_avx512_features_available = CheckAvx512Features();
+    return the_avx512_features_available;
+}
 EbAsm GetCpuAsmType()
 {
     EbAsm asm_type = ASM_NON_AVX2;
@@ -521,6 +655,9 @@ EbErrorType LoadDefaultBufferConfigurationSettings(
     sequence_control_set_ptr->enc_dec_segment_col_count_array[4] = encDecSegW;
     sequence_control_set_ptr->enc_dec_segment_col_count_array[5] = encDecSegW;
 
+    // PA segments, one per SB row
+    sequence_control_set_ptr->pa_segment_row_count = (sequence_control_set_ptr->max_input_luma_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+
     sequence_control_set_ptr->cdef_segment_column_count = meSegW;
     sequence_control_set_ptr->cdef_segment_row_count    = meSegH;
 
@@ -581,6 +718,31 @@ EbErrorType LoadDefaultBufferConfigurationSettings(
     sequence_control_set_ptr->total_process_init_count +=(sequence_control_set_ptr->cdef_process_init_count                          = MAX(MIN(40, coreCount), coreCount));
     sequence_control_set_ptr->total_process_init_count +=(sequence_control_set_ptr->rest_process_init_count                          = MAX(MIN(40, coreCount), coreCount));
 
+    // With the work-stealing pool, the contexts of the task scheduled stages
+    // are only borrowed by the workers: one context per worker and stage
+    sequence_control_set_ptr->thread_pool_worker_count = 0;
+    if (sequence_control_set_ptr->static_config.thread_pool_mode) {
+        sequence_control_set_ptr->total_process_init_count -=
+            sequence_control_set_ptr->picture_analysis_process_init_count +
+            sequence_control_set_ptr->motion_estimation_process_init_count +
+            sequence_control_set_ptr->enc_dec_process_init_count +
+            sequence_control_set_ptr->entropy_coding_process_init_count +
+            sequence_control_set_ptr->dlf_process_init_count +
+            sequence_control_set_ptr->cdef_process_init_count +
+            sequence_control_set_ptr->rest_process_init_count;
+
+        sequence_control_set_ptr->thread_pool_worker_count                = coreCount;
+        sequence_control_set_ptr->picture_analysis_process_init_count     = coreCount;
+        sequence_control_set_ptr->motion_estimation_process_init_count    = coreCount;
+        sequence_control_set_ptr->enc_dec_process_init_count              = coreCount;
+        sequence_control_set_ptr->entropy_coding_process_init_count       = coreCount;
+        sequence_control_set_ptr->dlf_process_init_count                  = coreCount;
+        sequence_control_set_ptr->cdef_process_init_count                 = coreCount;
+        sequence_control_set_ptr->rest_process_init_count                 = coreCount;
+
+        sequence_control_set_ptr->total_process_init_count += 7 * coreCount;
+    }
+
 
     sequence_control_set_ptr->total_process_init_count += 6; // single processes count
     printf("Number of logical cores available: %u\nNumber of PPCS %u\n", coreCount, inputPic);
@@ -682,23 +844,18 @@ static EbErrorType eb_enc_handle_ctor(
     if (encHandlePtr == (EbEncHandle_t*)EB_NULL) {
         return EB_ErrorInsufficientResources;
     }
-    encHandlePtr->memory_map = (EbMemoryMapEntry*)malloc(sizeof(EbMemoryMapEntry) * MAX_NUM_PTR);
-    encHandlePtr->memory_map_index = 0;
-    encHandlePtr->total_lib_memory = sizeof(EbEncHandle_t) + sizeof(EbMemoryMapEntry) * MAX_NUM_PTR;
+    return_error = eb_memory_arena_ctor(&encHandlePtr->memory_arena);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
 
-    // Save Memory Map Pointers
-    total_lib_memory = &encHandlePtr->total_lib_memory;
-    memory_map = encHandlePtr->memory_map;
-    memory_map_index = &encHandlePtr->memory_map_index;
+    // Every allocation of the instance comes from its arena
+    eb_memory_arena_set_current(encHandlePtr->memory_arena);
     libMallocCount = 0;
     lib_thread_count = 0;
     libMutexCount = 0;
     libSemaphoreCount = 0;
 
-    if (memory_map == (EbMemoryMapEntry*)EB_NULL) {
-        return EB_ErrorInsufficientResources;
-    }
-
     return_error = InitThreadManagmentParams();
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
@@ -729,20 +886,21 @@ static EbErrorType eb_enc_handle_ctor(
 
     // Threads
     encHandlePtr->resourceCoordinationThreadHandle = (EbHandle)EB_NULL;
-    encHandlePtr->pictureAnalysisThreadHandleArray = (EbHandle*)EB_NULL;
     encHandlePtr->pictureDecisionThreadHandle = (EbHandle)EB_NULL;
-    encHandlePtr->motionEstimationThreadHandleArray = (EbHandle*)EB_NULL;
     encHandlePtr->initialRateControlThreadHandle = (EbHandle)EB_NULL;
     encHandlePtr->sourceBasedOperationsThreadHandleArray = (EbHandle*)EB_NULL;
     encHandlePtr->pictureManagerThreadHandle = (EbHandle)EB_NULL;
     encHandlePtr->rateControlThreadHandle = (EbHandle)EB_NULL;
     encHandlePtr->modeDecisionConfigurationThreadHandleArray = (EbHandle*)EB_NULL;
-    encHandlePtr->encDecThreadHandleArray = (EbHandle*)EB_NULL;
-    encHandlePtr->entropyCodingThreadHandleArray = (EbHandle*)EB_NULL;
     encHandlePtr->packetizationThreadHandle = (EbHandle)EB_NULL;
-    encHandlePtr->dlfThreadHandleArray = (EbHandle*)EB_NULL;
-    encHandlePtr->cdefThreadHandleArray = (EbHandle*)EB_NULL;
-    encHandlePtr->restThreadHandleArray = (EbHandle*)EB_NULL;
+    encHandlePtr->taskSchedulerPtr = (EbPtr)EB_NULL;
+    encHandlePtr->pipelineStatsPtr = (EbPtr)EB_NULL;
+
+    // Input frames allocated by the application
+    encHandlePtr->allocate_input_buffer = (eb_allocate_frame_buffer)EB_NULL;
+    encHandlePtr->release_input_buffer = (eb_release_frame_buffer)EB_NULL;
+    encHandlePtr->input_buffer_priv_data = EB_NULL;
+    encHandlePtr->blank_input_frame_ptr = (EbByte)EB_NULL;
 
     // Contexts
     encHandlePtr->resourceCoordinationContextPtr = (EbPtr)EB_NULL;
@@ -775,6 +933,7 @@ static EbErrorType eb_enc_handle_ctor(
     encHandlePtr->encDecTasksResourcePtr = (EbSystemResource*)EB_NULL;
     encHandlePtr->encDecResultsResourcePtr = (EbSystemResource*)EB_NULL;
     encHandlePtr->entropyCodingResultsResourcePtr = (EbSystemResource*)EB_NULL;
+    encHandlePtr->intrabcHashBuffersResourcePtr = (EbSystemResource*)EB_NULL;
 
     // Inter-Process Producer Fifos
     encHandlePtr->input_buffer_producer_fifo_ptr_array = (EbFifo**)EB_NULL;
@@ -790,6 +949,7 @@ static EbErrorType eb_enc_handle_ctor(
     encHandlePtr->dlfResultsProducerFifoPtrArray = (EbFifo**)EB_NULL;
     encHandlePtr->cdefResultsProducerFifoPtrArray = (EbFifo**)EB_NULL;
     encHandlePtr->restResultsProducerFifoPtrArray = (EbFifo**)EB_NULL;
+    encHandlePtr->intrabcHashBuffersProducerFifoPtrArray = (EbFifo**)EB_NULL;
 
     encHandlePtr->dlfResultsConsumerFifoPtrArray = (EbFifo**)EB_NULL;
     encHandlePtr->cdefResultsConsumerFifoPtrArray = (EbFifo**)EB_NULL;
@@ -882,6 +1042,72 @@ EbErrorType RestResultsCtor(
     return EB_ErrorNone;
 }
 
+/**********************************
+* Pipeline Stats
+*   Instruments the input fifo of every
+*   stage, in pipeline order, and the
+*   pools the stages wait on.
+**********************************/
+static EbErrorType EbPipelineStatsCtor(
+    EbEncHandle_t *encHandlePtr)
+{
+    SequenceControlSet *sequence_control_set_ptr = encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr;
+    EbPipelineStats    *statsPtr;
+    uint32_t            instance_index;
+    EbErrorType         return_error;
+
+    // Dedicated stage threads, pool workers and the single thread stages
+    return_error = eb_pipeline_stats_ctor(
+        (EbPipelineStats**)&encHandlePtr->pipelineStatsPtr,
+        sequence_control_set_ptr->total_process_init_count + sequence_control_set_ptr->thread_pool_worker_count + 8);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+    statsPtr = (EbPipelineStats*)encHandlePtr->pipelineStatsPtr;
+
+    eb_system_resource_set_stats(encHandlePtr->input_buffer_resource_ptr,                statsPtr, eb_pipeline_stats_add_stage(statsPtr, "ResourceCoordination"));
+    eb_system_resource_set_stats(encHandlePtr->resourceCoordinationResultsResourcePtr,   statsPtr, eb_pipeline_stats_add_stage(statsPtr, "PictureAnalysis"));
+    eb_system_resource_set_stats(encHandlePtr->pictureAnalysisResultsResourcePtr,        statsPtr, eb_pipeline_stats_add_stage(statsPtr, "PictureDecision"));
+    eb_system_resource_set_stats(encHandlePtr->pictureDecisionResultsResourcePtr,        statsPtr, eb_pipeline_stats_add_stage(statsPtr, "MotionEstimation"));
+    eb_system_resource_set_stats(encHandlePtr->motionEstimationResultsResourcePtr,       statsPtr, eb_pipeline_stats_add_stage(statsPtr, "InitialRateControl"));
+    eb_system_resource_set_stats(encHandlePtr->initialRateControlResultsResourcePtr,     statsPtr, eb_pipeline_stats_add_stage(statsPtr, "SourceBasedOperations"));
+    eb_system_resource_set_stats(encHandlePtr->pictureDemuxResultsResourcePtr,           statsPtr, eb_pipeline_stats_add_stage(statsPtr, "PictureManager"));
+    eb_system_resource_set_stats(encHandlePtr->rateControlTasksResourcePtr,              statsPtr, eb_pipeline_stats_add_stage(statsPtr, "RateControl"));
+    eb_system_resource_set_stats(encHandlePtr->rateControlResultsResourcePtr,            statsPtr, eb_pipeline_stats_add_stage(statsPtr, "ModeDecisionConfiguration"));
+    eb_system_resource_set_stats(encHandlePtr->encDecTasksResourcePtr,                   statsPtr, eb_pipeline_stats_add_stage(statsPtr, "EncDec"));
+    eb_system_resource_set_stats(encHandlePtr->encDecResultsResourcePtr,                 statsPtr, eb_pipeline_stats_add_stage(statsPtr, "Dlf"));
+    eb_system_resource_set_stats(encHandlePtr->dlfResultsResourcePtr,                    statsPtr, eb_pipeline_stats_add_stage(statsPtr, "Cdef"));
+    eb_system_resource_set_stats(encHandlePtr->cdefResultsResourcePtr,                   statsPtr, eb_pipeline_stats_add_stage(statsPtr, "Rest"));
+    eb_system_resource_set_stats(encHandlePtr->restResultsResourcePtr,                   statsPtr, eb_pipeline_stats_add_stage(statsPtr, "EntropyCoding"));
+    eb_system_resource_set_stats(encHandlePtr->entropyCodingResultsResourcePtr,          statsPtr, eb_pipeline_stats_add_stage(statsPtr, "Packetization"));
+
+    for (instance_index = 0; instance_index < encHandlePtr->encodeInstanceTotalCount; ++instance_index) {
+        eb_system_resource_set_stats(encHandlePtr->pictureParentControlSetPoolPtrArray[instance_index], statsPtr, ~0u);
+        eb_system_resource_set_stats(encHandlePtr->pictureControlSetPoolPtrArray[instance_index], statsPtr, ~0u);
+        eb_system_resource_set_stats(encHandlePtr->referencePicturePoolPtrArray[instance_index], statsPtr, ~0u);
+        eb_system_resource_set_stats(encHandlePtr->paReferencePicturePoolPtrArray[instance_index], statsPtr, ~0u);
+        eb_system_resource_set_stats(encHandlePtr->output_stream_buffer_resource_ptr_array[instance_index], statsPtr, ~0u);
+    }
+
+    return EB_ErrorNone;
+}
+
+/**********************************
+* PoolInitialCount
+*   Objects of a pool of object_total_count
+*   objects constructed at init, the others
+*   are constructed on demand.
+**********************************/
+static uint32_t PoolInitialCount(
+    EbEncHandle_t *encHandlePtr,
+    uint32_t       object_total_count)
+{
+    if (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.lazy_pool_allocation)
+        return MIN(object_total_count, LAZY_POOL_INIT_COUNT);
+
+    return object_total_count;
+}
+
 void init_fn_ptr(void);
 
 /**********************************
@@ -901,9 +1127,18 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     uint32_t max_picture_width;
     uint32_t maxLookAheadDistance = 0;
 
+    // The application thread may differ from the one that created the handle
+    eb_memory_arena_set_current(encHandlePtr->memory_arena);
+
     EbBool is16bit = (EbBool)(encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
     EbColorFormat color_format = encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.encoder_color_format;
 
+    // 10 bit input in 16 bit samples is unpacked into the library buffers
+    if (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->external_input_buffer_flag &&
+        is16bit && encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.compressed_ten_bit_format != 1) {
+        return EB_ErrorBadParameter;
+    }
+
     /************************************
     * Plateform detection
     ************************************/
@@ -914,7 +1149,12 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         encHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr->asm_type = encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.asm_type;
     }
 
-    setup_rtcd_internal(encHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr->asm_type);
+    // AVX-512 kernels are picked at run time on top of the AVX2 set, only when
+    // the highest instruction set is requested
+    setup_rtcd_internal(
+        encHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr->asm_type,
+        (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.asm_type == 1 &&
+         CanUseIntelAvx512() == 1) ? EB_TRUE : EB_FALSE);
     asmSetConvolveAsmTable();
 
     init_intra_dc_predictors_c_internal();
@@ -989,8 +1229,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
 
         inputData.in_loop_me_flag = (uint8_t)encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.in_loop_me_flag;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &(encHandlePtr->pictureParentControlSetPoolPtrArray[instance_index]),
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->picture_control_set_pool_init_count),
             encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->picture_control_set_pool_init_count,//encHandlePtr->pictureControlSetPoolTotalCount,
             1,
             0,
@@ -998,7 +1239,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             (EbFifo ***)EB_NULL,
             EB_FALSE,
             picture_parent_control_set_ctor,
-            &inputData);
+            &inputData,
+            sizeof(inputData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1038,8 +1280,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         inputData.sb_sz = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->sb_sz;
         inputData.sb_size_pix = scs_init.sb_size;
         inputData.max_depth = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->max_sb_depth;
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &(encHandlePtr->pictureControlSetPoolPtrArray[instance_index]),
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->picture_control_set_pool_init_count_child),
             encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->picture_control_set_pool_init_count_child, //EB_PictureControlSetPoolInitCountChild,
             1,
             0,
@@ -1047,7 +1290,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             (EbFifo ***)EB_NULL,
             EB_FALSE,
             picture_control_set_ctor,
-            &inputData);
+            &inputData,
+            sizeof(inputData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1081,6 +1325,11 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         EbPictureBufferDescInitData_t       referencePictureBufferDescInitData;
         EbPictureBufferDescInitData_t       quarterDecimPictureBufferDescInitData;
         EbPictureBufferDescInitData_t       sixteenthDecimPictureBufferDescInitData;
+        SequenceControlSet                 *instanceScsPtr = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr;
+        // SB based arrays of the references are sized from the actual picture
+        const uint32_t                      sbTotalCount =
+            ((instanceScsPtr->max_input_luma_width + instanceScsPtr->sb_sz - 1) / instanceScsPtr->sb_sz) *
+            ((instanceScsPtr->max_input_luma_height + instanceScsPtr->sb_sz - 1) / instanceScsPtr->sb_sz);
 
         // Initialize the various Picture types
         referencePictureBufferDescInitData.maxWidth = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->max_input_luma_width;
@@ -1097,10 +1346,12 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         referencePictureBufferDescInitData.splitMode = EB_FALSE;
 
         EbReferenceObjectDescInitDataStructure.reference_picture_desc_init_data = referencePictureBufferDescInitData;
+        EbReferenceObjectDescInitDataStructure.sb_total_count = sbTotalCount;
 
         // Reference Picture Buffers
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->referencePicturePoolPtrArray[instance_index],
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->reference_picture_buffer_init_count),
             encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->reference_picture_buffer_init_count,//encHandlePtr->referencePicturePoolTotalCount,
             EB_PictureManagerProcessInitCount,
             0,
@@ -1108,7 +1359,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             (EbFifo ***)EB_NULL,
             EB_FALSE,
             eb_reference_object_ctor,
-            &(EbReferenceObjectDescInitDataStructure));
+            &(EbReferenceObjectDescInitDataStructure),
+            sizeof(EbReferenceObjectDescInitDataStructure));
 
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
@@ -1154,10 +1406,12 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         EbPaReferenceObjectDescInitDataStructure.reference_picture_desc_init_data = referencePictureBufferDescInitData;
         EbPaReferenceObjectDescInitDataStructure.quarter_picture_desc_init_data = quarterDecimPictureBufferDescInitData;
         EbPaReferenceObjectDescInitDataStructure.sixteenth_picture_desc_init_data = sixteenthDecimPictureBufferDescInitData;
+        EbPaReferenceObjectDescInitDataStructure.sb_total_count = sbTotalCount;
 
         // Reference Picture Buffers
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->paReferencePicturePoolPtrArray[instance_index],
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->pa_reference_picture_buffer_init_count),
             encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->pa_reference_picture_buffer_init_count,
             EB_PictureDecisionProcessInitCount,
             0,
@@ -1165,7 +1419,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             (EbFifo ***)EB_NULL,
             EB_FALSE,
             eb_pa_reference_object_ctor,
-            &(EbPaReferenceObjectDescInitDataStructure));
+            &(EbPaReferenceObjectDescInitDataStructure),
+            sizeof(EbPaReferenceObjectDescInitDataStructure));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1194,6 +1449,24 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
+
+    if (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->external_input_buffer_flag) {
+        EbInputFrameLayout     blankFrameLayout;
+        EbInputFrameHeader    *blankFrameHeaderPtr;
+
+        // Referenced by the input buffers sent without a picture (EOS)
+        InputFrameLayout(
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr,
+            &blankFrameLayout);
+        EB_ALLIGN_MALLOC(EbByte, encHandlePtr->blank_input_frame_ptr, blankFrameLayout.frame_size, EB_A_PTR);
+        memset(encHandlePtr->blank_input_frame_ptr, 0, blankFrameLayout.frame_size);
+        blankFrameHeaderPtr = (EbInputFrameHeader*)encHandlePtr->blank_input_frame_ptr;
+        blankFrameHeaderPtr->release_buffer = (eb_release_frame_buffer)EB_NULL;
+
+        eb_system_resource_set_release_callback(
+            encHandlePtr->input_buffer_resource_ptr,
+            InputFrameReleaseCallback);
+    }
     // EbBufferHeaderType Output Stream
     EB_MALLOC(EbSystemResource**, encHandlePtr->output_stream_buffer_resource_ptr_array, sizeof(EbSystemResource*) * encHandlePtr->encodeInstanceTotalCount, EB_N_PTR);
     EB_MALLOC(EbFifo***, encHandlePtr->output_stream_buffer_producer_fifo_ptr_dbl_array, sizeof(EbFifo**)          * encHandlePtr->encodeInstanceTotalCount, EB_N_PTR);
@@ -1221,8 +1494,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         EB_MALLOC(EbFifo***, encHandlePtr->output_recon_buffer_consumer_fifo_ptr_dbl_array, sizeof(EbFifo**)          * encHandlePtr->encodeInstanceTotalCount, EB_N_PTR);
 
         for (instance_index = 0; instance_index < encHandlePtr->encodeInstanceTotalCount; ++instance_index) {
-            return_error = eb_system_resource_ctor(
+            return_error = eb_system_resource_lazy_ctor(
                 &encHandlePtr->output_recon_buffer_resource_ptr_array[instance_index],
+                PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->output_recon_buffer_fifo_init_count),
                 encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->output_recon_buffer_fifo_init_count,
                 encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->enc_dec_process_init_count,
                 1,
@@ -1230,7 +1504,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
                 &encHandlePtr->output_recon_buffer_consumer_fifo_ptr_dbl_array[instance_index],
                 EB_TRUE,
                 EbOutputReconBufferHeaderCtor,
-                encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr);
+                encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr,
+                0);
             if (return_error == EB_ErrorInsufficientResources) {
                 return EB_ErrorInsufficientResources;
             }
@@ -1241,16 +1516,19 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         ResourceCoordinationResultInitData resourceCoordinationResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->resourceCoordinationResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->resource_coordination_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->resource_coordination_fifo_init_count,
-            EB_ResourceCoordinationProcessInitCount,
+            EB_ResourceCoordinationProcessInitCount +                                                                           // RC
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_analysis_process_init_count, // PA feedback
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_analysis_process_init_count,
             &encHandlePtr->resourceCoordinationResultsProducerFifoPtrArray,
             &encHandlePtr->resourceCoordinationResultsConsumerFifoPtrArray,
             EB_TRUE,
             resource_coordination_result_ctor,
-            &resourceCoordinationResultInitData);
+            &resourceCoordinationResultInitData,
+            sizeof(resourceCoordinationResultInitData));
 
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
@@ -1262,8 +1540,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         PictureAnalysisResultInitData_t pictureAnalysisResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->pictureAnalysisResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_analysis_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_analysis_fifo_init_count,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_analysis_process_init_count,
             EB_PictureDecisionProcessInitCount,
@@ -1271,7 +1550,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->pictureAnalysisResultsConsumerFifoPtrArray,
             EB_TRUE,
             picture_analysis_result_ctor,
-            &pictureAnalysisResultInitData);
+            &pictureAnalysisResultInitData,
+            sizeof(pictureAnalysisResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1281,8 +1561,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         PictureDecisionResultInitData_t pictureDecisionResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->pictureDecisionResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_decision_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_decision_fifo_init_count,
             EB_PictureDecisionProcessInitCount,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->motion_estimation_process_init_count,
@@ -1290,7 +1571,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->pictureDecisionResultsConsumerFifoPtrArray,
             EB_TRUE,
             picture_decision_result_ctor,
-            &pictureDecisionResultInitData);
+            &pictureDecisionResultInitData,
+            sizeof(pictureDecisionResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1300,8 +1582,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         MotionEstimationResultsInitData_t motionEstimationResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->motionEstimationResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->motion_estimation_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->motion_estimation_fifo_init_count,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->motion_estimation_process_init_count,
             EB_InitialRateControlProcessInitCount,
@@ -1309,7 +1592,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->motionEstimationResultsConsumerFifoPtrArray,
             EB_TRUE,
             MotionEstimationResultsCtor,
-            &motionEstimationResultInitData);
+            &motionEstimationResultInitData,
+            sizeof(motionEstimationResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1319,8 +1603,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         InitialRateControlResultInitData_t initialRateControlResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->initialRateControlResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->initial_rate_control_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->initial_rate_control_fifo_init_count,
             EB_InitialRateControlProcessInitCount,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->source_based_operations_process_init_count,
@@ -1328,7 +1613,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->initialRateControlResultsConsumerFifoPtrArray,
             EB_TRUE,
             InitialRateControlResultsCtor,
-            &initialRateControlResultInitData);
+            &initialRateControlResultInitData,
+            sizeof(initialRateControlResultInitData));
 
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
@@ -1339,8 +1625,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         PictureResultInitData_t pictureResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->pictureDemuxResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_demux_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_demux_fifo_init_count,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->source_based_operations_process_init_count + encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_process_init_count,
             EB_PictureManagerProcessInitCount,
@@ -1348,7 +1635,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->pictureDemuxResultsConsumerFifoPtrArray,
             EB_TRUE,
             picture_results_ctor,
-            &pictureResultInitData);
+            &pictureResultInitData,
+            sizeof(pictureResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1358,8 +1646,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         RateControlTasksInitData rateControlTasksInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->rateControlTasksResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rate_control_tasks_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rate_control_tasks_fifo_init_count,
             RateControlPortTotalCount(),
             EB_RateControlProcessInitCount,
@@ -1367,7 +1656,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->rateControlTasksConsumerFifoPtrArray,
             EB_TRUE,
             rate_control_tasks_ctor,
-            &rateControlTasksInitData);
+            &rateControlTasksInitData,
+            sizeof(rateControlTasksInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1377,16 +1667,48 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         RateControlResultsInitData rateControlResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->rateControlResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rate_control_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rate_control_fifo_init_count,
-            EB_RateControlProcessInitCount,
+            EB_RateControlProcessInitCount +                                                                                        // RC
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->mode_decision_configuration_process_init_count, // MDC feedback
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->mode_decision_configuration_process_init_count,
             &encHandlePtr->rateControlResultsProducerFifoPtrArray,
             &encHandlePtr->rateControlResultsConsumerFifoPtrArray,
             EB_TRUE,
             rate_control_results_ctor,
-            &rateControlResultInitData);
+            &rateControlResultInitData,
+            sizeof(rateControlResultInitData));
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
+    // Intra Block Copy Hash Buffers
+    // Intra block copy is off from M3, unless the speed control can lower
+    // the encoder mode. The buffers are only held while an MDC thread
+    // hashes a picture, so one set per MDC thread is enough.
+    if (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.enc_mode < ENC_M3 ||
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.speed_control_flag == 1)
+    {
+        IntraBcHashBuffersInitData_t intrabcHashBuffersInitData;
+
+        intrabcHashBuffersInitData.picture_width = encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_width;
+        intrabcHashBuffersInitData.picture_height = encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_height;
+
+        return_error = eb_system_resource_lazy_ctor(
+            &encHandlePtr->intrabcHashBuffersResourcePtr,
+            0,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->mode_decision_configuration_process_init_count,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->mode_decision_configuration_process_init_count,
+            0,
+            &encHandlePtr->intrabcHashBuffersProducerFifoPtrArray,
+            (EbFifo ***)EB_NULL,
+            EB_FALSE,
+            intrabc_hash_buffers_ctor,
+            &intrabcHashBuffersInitData,
+            sizeof(intrabcHashBuffersInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1404,8 +1726,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
                 encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_segment_row_count_array[i]);
         }
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->encDecTasksResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->mode_decision_configuration_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->mode_decision_configuration_fifo_init_count,
             EncDecPortTotalCount(),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_process_init_count,
@@ -1413,7 +1736,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->encDecTasksConsumerFifoPtrArray,
             EB_TRUE,
             EncDecTasksCtor,
-            &ModeDecisionResultInitData);
+            &ModeDecisionResultInitData,
+            sizeof(ModeDecisionResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1423,16 +1747,19 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         EncDecResultsInitData_t encDecResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->encDecResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_fifo_init_count,
-            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_process_init_count,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_process_init_count + // EncDec
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_process_init_count,      // DLF feedback
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_process_init_count,
             &encHandlePtr->encDecResultsProducerFifoPtrArray,
             &encHandlePtr->encDecResultsConsumerFifoPtrArray,
             EB_TRUE,
             EncDecResultsCtor,
-            &encDecResultInitData);
+            &encDecResultInitData,
+            sizeof(encDecResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1442,16 +1769,19 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         EntropyCodingResultsInitData_t dlfResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->dlfResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_fifo_init_count,
-            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_process_init_count,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_process_init_count +  // DLF
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_process_init_count,  // CDEF feedback
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_process_init_count,
             &encHandlePtr->dlfResultsProducerFifoPtrArray,
             &encHandlePtr->dlfResultsConsumerFifoPtrArray,
             EB_TRUE,
             DlfResultsCtor,
-            &dlfResultInitData);
+            &dlfResultInitData,
+            sizeof(dlfResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1460,16 +1790,19 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         EntropyCodingResultsInitData_t cdefResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->cdefResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_fifo_init_count,
-            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_process_init_count,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_process_init_count +  // CDEF
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_process_init_count,   // Rest feedback
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_process_init_count,
             &encHandlePtr->cdefResultsProducerFifoPtrArray,
             &encHandlePtr->cdefResultsConsumerFifoPtrArray,
             EB_TRUE,
             CdefResultsCtor,
-            &cdefResultInitData);
+            &cdefResultInitData,
+            sizeof(cdefResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1479,8 +1812,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         EntropyCodingResultsInitData_t restResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->restResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_fifo_init_count,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_process_init_count,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->entropy_coding_process_init_count,
@@ -1488,7 +1822,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->restResultsConsumerFifoPtrArray,
             EB_TRUE,
             RestResultsCtor,
-            &restResultInitData);
+            &restResultInitData,
+            sizeof(restResultInitData));
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1499,8 +1834,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     {
         EntropyCodingResultsInitData_t entropyCodingResultInitData;
 
-        return_error = eb_system_resource_ctor(
+        return_error = eb_system_resource_lazy_ctor(
             &encHandlePtr->entropyCodingResultsResourcePtr,
+            PoolInitialCount(encHandlePtr, encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->entropy_coding_fifo_init_count),
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->entropy_coding_fifo_init_count,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->entropy_coding_process_init_count,
             EB_PacketizationProcessInitCount,
@@ -1508,7 +1844,18 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             &encHandlePtr->entropyCodingResultsConsumerFifoPtrArray,
             EB_TRUE,
             EntropyCodingResultsCtor,
-            &entropyCodingResultInitData);
+            &entropyCodingResultInitData,
+            sizeof(entropyCodingResultInitData));
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
+    /************************************
+    * Pipeline Stats
+    ************************************/
+    if (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.enable_pipeline_stats) {
+        return_error = EbPipelineStatsCtor(encHandlePtr);
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1528,6 +1875,23 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             encHandlePtr->sequence_control_set_instance_array[instance_index]->encode_context_ptr->recon_output_fifo_ptr      = (encHandlePtr->output_recon_buffer_producer_fifo_ptr_dbl_array[instance_index])[0];
     }
 
+    // Deadline Speed Control
+    for (instance_index = 0; instance_index < encHandlePtr->encodeInstanceTotalCount; ++instance_index) {
+        EbSvtAv1EncConfiguration *config_ptr = &encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config;
+        if (config_ptr->speed_control_flag == 2) {
+            uint32_t coreCount = GetNumProcessors();
+            if (config_ptr->logical_processors && config_ptr->logical_processors < coreCount)
+                coreCount = config_ptr->logical_processors;
+            return_error = eb_deadline_control_ctor(
+                &encHandlePtr->sequence_control_set_instance_array[instance_index]->encode_context_ptr->deadline_control_ptr,
+                config_ptr->frame_rate,
+                coreCount);
+            if (return_error != EB_ErrorNone) {
+                return return_error;
+            }
+        }
+    }
+
     /************************************
     * Contexts
     ************************************/
@@ -1568,6 +1932,7 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             EB_TRUE,
             (PictureAnalysisContext_t**)&encHandlePtr->pictureAnalysisContextPtrArray[processIndex],
             encHandlePtr->resourceCoordinationResultsConsumerFifoPtrArray[processIndex],
+            encHandlePtr->resourceCoordinationResultsProducerFifoPtrArray[EB_ResourceCoordinationProcessInitCount + processIndex],
             encHandlePtr->pictureAnalysisResultsProducerFifoPtrArray[processIndex]);
 
         if (return_error == EB_ErrorInsufficientResources) {
@@ -1660,7 +2025,8 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             return_error = ModeDecisionConfigurationContextCtor(
                 (ModeDecisionConfigurationContext_t**)&encHandlePtr->modeDecisionConfigurationContextPtrArray[processIndex],
                 encHandlePtr->rateControlResultsConsumerFifoPtrArray[processIndex],
-
+                encHandlePtr->rateControlResultsProducerFifoPtrArray[EB_RateControlProcessInitCount + processIndex],
+                encHandlePtr->intrabcHashBuffersProducerFifoPtrArray ? encHandlePtr->intrabcHashBuffersProducerFifoPtrArray[processIndex] : (EbFifo*)EB_NULL,
                 encHandlePtr->encDecTasksProducerFifoPtrArray[EncDecPortLookup(ENCDEC_INPUT_PORT_MDC, processIndex)],
                 ((encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_width + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64) *
                 ((encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64));
@@ -1711,6 +2077,7 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             (DlfContext_t**)&encHandlePtr->dlfContextPtrArray[processIndex],
             encHandlePtr->encDecResultsConsumerFifoPtrArray[processIndex],
             encHandlePtr->dlfResultsProducerFifoPtrArray[processIndex],             //output to EC
+            encHandlePtr->encDecResultsProducerFifoPtrArray[encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_process_init_count + processIndex],
             is16bit,
             color_format,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_width,
@@ -1730,6 +2097,7 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             (CdefContext_t**)&encHandlePtr->cdefContextPtrArray[processIndex],
             encHandlePtr->dlfResultsConsumerFifoPtrArray[processIndex],
             encHandlePtr->cdefResultsProducerFifoPtrArray[processIndex],
+            encHandlePtr->dlfResultsProducerFifoPtrArray[encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_process_init_count + processIndex],
             is16bit,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_width,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_height
@@ -1749,6 +2117,7 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             encHandlePtr->restResultsProducerFifoPtrArray[processIndex],
             encHandlePtr->pictureDemuxResultsProducerFifoPtrArray[
                 /*encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->source_based_operations_process_init_count*/ 1+ processIndex],
+            encHandlePtr->cdefResultsProducerFifoPtrArray[encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_process_init_count + processIndex],
             is16bit,
             color_format,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_width,
@@ -1770,7 +2139,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             encHandlePtr->restResultsConsumerFifoPtrArray[processIndex],
             encHandlePtr->entropyCodingResultsProducerFifoPtrArray[processIndex],
             encHandlePtr->rateControlTasksProducerFifoPtrArray[RateControlPortLookup(RATE_CONTROL_INPUT_PORT_ENTROPY_CODING, processIndex)],
-            is16bit);
+            is16bit,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_width,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_height);
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
         }
@@ -1795,23 +2166,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     // Resource Coordination
     EB_CREATETHREAD(EbHandle, encHandlePtr->resourceCoordinationThreadHandle, sizeof(EbHandle), EB_THREAD, resource_coordination_kernel, encHandlePtr->resourceCoordinationContextPtr);
 
-    // Picture Analysis
-    EB_MALLOC(EbHandle*, encHandlePtr->pictureAnalysisThreadHandleArray, sizeof(EbHandle) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_analysis_process_init_count, EB_N_PTR);
-
-    for (processIndex = 0; processIndex < encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_analysis_process_init_count; ++processIndex) {
-        EB_CREATETHREAD(EbHandle, encHandlePtr->pictureAnalysisThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, picture_analysis_kernel, encHandlePtr->pictureAnalysisContextPtrArray[processIndex]);
-    }
-
     // Picture Decision
     EB_CREATETHREAD(EbHandle, encHandlePtr->pictureDecisionThreadHandle, sizeof(EbHandle), EB_THREAD, picture_decision_kernel, encHandlePtr->pictureDecisionContextPtr);
 
-    // Motion Estimation
-    EB_MALLOC(EbHandle*, encHandlePtr->motionEstimationThreadHandleArray, sizeof(EbHandle) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->motion_estimation_process_init_count, EB_N_PTR);
-
-    for (processIndex = 0; processIndex < encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->motion_estimation_process_init_count; ++processIndex) {
-        EB_CREATETHREAD(EbHandle, encHandlePtr->motionEstimationThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, MotionEstimationKernel, encHandlePtr->motionEstimationContextPtrArray[processIndex]);
-    }
-
     // Initial Rate Control
     EB_CREATETHREAD(EbHandle, encHandlePtr->initialRateControlThreadHandle, sizeof(EbHandle), EB_THREAD, InitialRateControlKernel, encHandlePtr->initialRateControlContextPtr);
 
@@ -1835,40 +2192,102 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         EB_CREATETHREAD(EbHandle, encHandlePtr->modeDecisionConfigurationThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, ModeDecisionConfigurationKernel, encHandlePtr->modeDecisionConfigurationContextPtrArray[processIndex]);
     }
 
-    // EncDec Process
-    EB_MALLOC(EbHandle*, encHandlePtr->encDecThreadHandleArray, sizeof(EbHandle) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_process_init_count, EB_N_PTR);
-
-    for (processIndex = 0; processIndex < encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_process_init_count; ++processIndex) {
-        EB_CREATETHREAD(EbHandle, encHandlePtr->encDecThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, EncDecKernel, encHandlePtr->encDecContextPtrArray[processIndex]);
+    // Task Scheduler: Picture Analysis, Motion Estimation, EncDec, Dlf, Cdef, Rest and Entropy Coding
+    return_error = eb_task_scheduler_ctor(
+        (EbTaskScheduler**)&encHandlePtr->taskSchedulerPtr,
+        config_ptr->thread_pool_mode ? TASK_SCHEDULER_WORK_STEALING : TASK_SCHEDULER_DEDICATED_THREADS,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->thread_pool_worker_count,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->resource_coordination_fifo_init_count +
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_decision_fifo_init_count +
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->mode_decision_configuration_fifo_init_count +
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_fifo_init_count +
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_fifo_init_count +
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_fifo_init_count +
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_fifo_init_count);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
     }
 
-    // Dlf Process
-    EB_MALLOC(EbHandle*, encHandlePtr->dlfThreadHandleArray, sizeof(EbHandle) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_process_init_count, EB_N_PTR);
-
-    for (processIndex = 0; processIndex < encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_process_init_count; ++processIndex) {
-        EB_CREATETHREAD(EbHandle, encHandlePtr->dlfThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, dlf_kernel, encHandlePtr->dlfContextPtrArray[processIndex]);
+    return_error = eb_task_scheduler_add_stage(
+        (EbTaskScheduler*)encHandlePtr->taskSchedulerPtr,
+        "PictureAnalysis",
+        picture_analysis_kernel,
+        encHandlePtr->pictureAnalysisContextPtrArray,
+        encHandlePtr->resourceCoordinationResultsConsumerFifoPtrArray,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->picture_analysis_process_init_count);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
     }
 
+    return_error = eb_task_scheduler_add_stage(
+        (EbTaskScheduler*)encHandlePtr->taskSchedulerPtr,
+        "MotionEstimation",
+        MotionEstimationKernel,
+        encHandlePtr->motionEstimationContextPtrArray,
+        encHandlePtr->pictureDecisionResultsConsumerFifoPtrArray,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->motion_estimation_process_init_count);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
 
-    // Cdef Process
-    EB_MALLOC(EbHandle*, encHandlePtr->cdefThreadHandleArray, sizeof(EbHandle) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_process_init_count, EB_N_PTR);
+    return_error = eb_task_scheduler_add_stage(
+        (EbTaskScheduler*)encHandlePtr->taskSchedulerPtr,
+        "EncDec",
+        EncDecKernel,
+        encHandlePtr->encDecContextPtrArray,
+        encHandlePtr->encDecTasksConsumerFifoPtrArray,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->enc_dec_process_init_count);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
 
-    for (processIndex = 0; processIndex < encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_process_init_count; ++processIndex) {
-        EB_CREATETHREAD(EbHandle, encHandlePtr->cdefThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, cdef_kernel, encHandlePtr->cdefContextPtrArray[processIndex]);
+    return_error = eb_task_scheduler_add_stage(
+        (EbTaskScheduler*)encHandlePtr->taskSchedulerPtr,
+        "Dlf",
+        dlf_kernel,
+        encHandlePtr->dlfContextPtrArray,
+        encHandlePtr->encDecResultsConsumerFifoPtrArray,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->dlf_process_init_count);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
     }
 
-    // Rest Process
-    EB_MALLOC(EbHandle*, encHandlePtr->restThreadHandleArray, sizeof(EbHandle) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_process_init_count, EB_N_PTR);
+    return_error = eb_task_scheduler_add_stage(
+        (EbTaskScheduler*)encHandlePtr->taskSchedulerPtr,
+        "Cdef",
+        cdef_kernel,
+        encHandlePtr->cdefContextPtrArray,
+        encHandlePtr->dlfResultsConsumerFifoPtrArray,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->cdef_process_init_count);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
 
-    for (processIndex = 0; processIndex < encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_process_init_count; ++processIndex) {
-        EB_CREATETHREAD(EbHandle, encHandlePtr->restThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, rest_kernel, encHandlePtr->restContextPtrArray[processIndex]);
+    return_error = eb_task_scheduler_add_stage(
+        (EbTaskScheduler*)encHandlePtr->taskSchedulerPtr,
+        "Rest",
+        rest_kernel,
+        encHandlePtr->restContextPtrArray,
+        encHandlePtr->cdefResultsConsumerFifoPtrArray,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_process_init_count);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
     }
 
-    // Entropy Coding Process
-    EB_MALLOC(EbHandle*, encHandlePtr->entropyCodingThreadHandleArray, sizeof(EbHandle) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->entropy_coding_process_init_count, EB_N_PTR);
+    return_error = eb_task_scheduler_add_stage(
+        (EbTaskScheduler*)encHandlePtr->taskSchedulerPtr,
+        "EntropyCoding",
+        EntropyCodingKernel,
+        encHandlePtr->entropyCodingContextPtrArray,
+        encHandlePtr->restResultsConsumerFifoPtrArray,
+        encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->entropy_coding_process_init_count);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
 
-    for (processIndex = 0; processIndex < encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->entropy_coding_process_init_count; ++processIndex) {
-        EB_CREATETHREAD(EbHandle, encHandlePtr->entropyCodingThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, EntropyCodingKernel, encHandlePtr->entropyCodingContextPtrArray[processIndex]);
+    return_error = eb_task_scheduler_start((EbTaskScheduler*)encHandlePtr->taskSchedulerPtr);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
     }
 
     // Packetization
@@ -1893,45 +2312,37 @@ EB_API EbErrorType eb_deinit_encoder(EbComponentType *svt_enc_component)
         return EB_ErrorBadParameter;
     EbEncHandle_t *encHandlePtr = (EbEncHandle_t*)svt_enc_component->p_component_private;
     EbErrorType return_error = EB_ErrorNone;
-    int32_t              ptrIndex = 0;
-    EbMemoryMapEntry*   memoryEntry = (EbMemoryMapEntry*)EB_NULL;
-
-    if (encHandlePtr) {
-        if (encHandlePtr->memory_map_index) {
-            // Loop through the ptr table and free all malloc'd pointers per channel
-            for (ptrIndex = (encHandlePtr->memory_map_index) - 1; ptrIndex >= 0; --ptrIndex) {
-                memoryEntry = &encHandlePtr->memory_map[ptrIndex];
-                switch (memoryEntry->ptr_type) {
-                case EB_N_PTR:
-                    free(memoryEntry->ptr);
-                    break;
-                case EB_A_PTR:
-#ifdef _WIN32
-                    _aligned_free(memoryEntry->ptr);
-#else
-                    free(memoryEntry->ptr);
-#endif
-                    break;
-                case EB_SEMAPHORE:
-                    eb_destroy_semaphore(memoryEntry->ptr);
-                    break;
-                case EB_THREAD:
-                    eb_destroy_thread(memoryEntry->ptr);
-                    break;
-                case EB_MUTEX:
-                    eb_destroy_mutex(memoryEntry->ptr);
-                    break;
-                default:
-                    return_error = EB_ErrorMax;
-                    break;
-                }
-            }
-            if (encHandlePtr->memory_map != (EbMemoryMapEntry*)NULL) {
-                free(encHandlePtr->memory_map);
+    EbAnalysisShare *analysisSharePtr = (EbAnalysisShare*)EB_NULL;
+
+    if (encHandlePtr && encHandlePtr->memory_arena && encHandlePtr->sequence_control_set_instance_array) {
+        EncodeContext_t *encode_context_ptr = encHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr;
+
+        // The inputs held for the followers of a ladder go to their pipelines,
+        // and a follower drops the inputs still held before its pipeline goes
+        analysisSharePtr = encode_context_ptr->analysis_share_ptr;
+        if (analysisSharePtr && encode_context_ptr->analysis_share_lead)
+            eb_analysis_share_close_lead(analysisSharePtr);
+        else if (analysisSharePtr) {
+            eb_analysis_share_remove_follower(analysisSharePtr, encode_context_ptr->analysis_share_follower_index);
+            if (encode_context_ptr->analysis_share_scene_fallback_count || encode_context_ptr->analysis_share_hme_fallback_count) {
+                SVT_LOG("SVT [WARNING]: the lead of the ladder closed before providing the scene changes of %d pictures and the HME of %d pictures, the rendition analysed them\n",
+                    encode_context_ptr->analysis_share_scene_fallback_count,
+                    encode_context_ptr->analysis_share_hme_fallback_count);
             }
-
         }
+        encode_context_ptr->analysis_share_ptr = (EbAnalysisShare*)EB_NULL;
+        encode_context_ptr->analysis_share_lead = EB_FALSE;
     }
+
+    if (encHandlePtr && encHandlePtr->memory_arena) {
+        // Destroys the threads first, then releases every allocation at once
+        eb_memory_arena_dtor(encHandlePtr->memory_arena);
+        encHandlePtr->memory_arena = (EbMemoryArena*)EB_NULL;
+    }
+
+    // Allocated outside the arenas, shared with the other encoders of the ladder
+    if (analysisSharePtr)
+        eb_analysis_share_release(analysisSharePtr);
     return return_error;
 }
 
@@ -2244,6 +2655,7 @@ void CopyApiFromApp(
     sequence_control_set_ptr->static_config.hme_level0_total_search_area_height = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->hme_level0_total_search_area_height;
     sequence_control_set_ptr->static_config.ext_block_flag = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->ext_block_flag;
     sequence_control_set_ptr->static_config.in_loop_me_flag = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->in_loop_me_flag;
+    sequence_control_set_ptr->static_config.md_recon_cache_flag = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->md_recon_cache_flag;
 
     for (hmeRegionIndex = 0; hmeRegionIndex < sequence_control_set_ptr->static_config.number_hme_search_region_in_width; ++hmeRegionIndex) {
         sequence_control_set_ptr->static_config.hme_level0_search_area_in_width_array[hmeRegionIndex] = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->hme_level0_search_area_in_width_array[hmeRegionIndex];
@@ -2326,6 +2738,9 @@ void CopyApiFromApp(
     sequence_control_set_ptr->static_config.active_channel_count = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->active_channel_count;
     sequence_control_set_ptr->static_config.logical_processors = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->logical_processors;
     sequence_control_set_ptr->static_config.target_socket = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->target_socket;
+    sequence_control_set_ptr->static_config.thread_pool_mode = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->thread_pool_mode;
+    sequence_control_set_ptr->static_config.lazy_pool_allocation = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->lazy_pool_allocation;
+    sequence_control_set_ptr->static_config.enable_pipeline_stats = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->enable_pipeline_stats;
     sequence_control_set_ptr->qp = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->qp;
     sequence_control_set_ptr->static_config.recon_enabled = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->recon_enabled;
 
@@ -2408,6 +2823,11 @@ static EbErrorType VerifySettings(
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->md_recon_cache_flag > 1) {
+        SVT_LOG("Error instance %u: MdReconCacheFlag must be [0-1]\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (sequence_control_set_ptr->max_input_luma_width < 64) {
         SVT_LOG("Error instance %u: Source Width must be at least 64\n", channelNumber + 1);
         return_error = EB_ErrorBadParameter;
@@ -2446,13 +2866,13 @@ static EbErrorType VerifySettings(
         return_error = EB_ErrorBadParameter;
     }
 
-    if (sequence_control_set_ptr->max_input_luma_width > 4096) {
-        SVT_LOG("Error instance %u: Source Width must be less than 4096\n", channelNumber + 1);
+    if (sequence_control_set_ptr->max_input_luma_width > MAX_SOURCE_WIDTH) {
+        SVT_LOG("Error instance %u: Source Width must be less than %u\n", channelNumber + 1, MAX_SOURCE_WIDTH);
         return_error = EB_ErrorBadParameter;
     }
 
-    if (sequence_control_set_ptr->max_input_luma_height > 2160) {
-        SVT_LOG("Error instance %u: Source Height must be less than 2160\n", channelNumber + 1);
+    if (sequence_control_set_ptr->max_input_luma_height > MAX_SOURCE_HEIGHT) {
+        SVT_LOG("Error instance %u: Source Height must be less than %u\n", channelNumber + 1, MAX_SOURCE_HEIGHT);
         return_error = EB_ErrorBadParameter;
     }
 
@@ -2668,8 +3088,8 @@ static EbErrorType VerifySettings(
         return_error = EB_ErrorBadParameter;
     }
 
-    if (config->speed_control_flag > 1) {
-        SVT_LOG("Error Instance %u: Invalid Speed Control flag [0 - 1]\n", channelNumber + 1);
+    if (config->speed_control_flag > 2) {
+        SVT_LOG("Error Instance %u: Invalid Speed Control flag [0 - 2]\n", channelNumber + 1);
         return_error = EB_ErrorBadParameter;
     }
 
@@ -2684,6 +3104,21 @@ static EbErrorType VerifySettings(
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->thread_pool_mode > 1) {
+        SVT_LOG("Error instance %u: Invalid thread_pool_mode. thread_pool_mode must be [0 - 1] \n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->lazy_pool_allocation != 0 && config->lazy_pool_allocation != 1) {
+        SVT_LOG("Error instance %u: Invalid lazy_pool_allocation. lazy_pool_allocation must be [0 - 1] \n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->enable_pipeline_stats != 0 && config->enable_pipeline_stats != 1) {
+        SVT_LOG("Error instance %u: Invalid enable_pipeline_stats. enable_pipeline_stats must be [0 - 1] \n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     return return_error;
 }
 
@@ -2734,6 +3169,7 @@ EbErrorType eb_svt_enc_init_parameter(
     config_ptr->disable_dlf_flag = EB_FALSE;
     config_ptr->enable_warped_motion = EB_FALSE;
     config_ptr->in_loop_me_flag = EB_TRUE;
+    config_ptr->md_recon_cache_flag = EB_TRUE;
     config_ptr->ext_block_flag = EB_FALSE;
     config_ptr->use_default_me_hme = EB_TRUE;
     config_ptr->enable_hme_flag = EB_TRUE;
@@ -2789,10 +3225,15 @@ EbErrorType eb_svt_enc_init_parameter(
     // Channel info
     config_ptr->logical_processors = 0;
     config_ptr->target_socket = -1;
+    config_ptr->thread_pool_mode = 0;
     config_ptr->channel_id = 0;
     config_ptr->active_channel_count = 1;
 
+    // Memory management
+    config_ptr->lazy_pool_allocation = EB_FALSE;
+
     // Debug info
+    config_ptr->enable_pipeline_stats = EB_FALSE;
     config_ptr->recon_enabled = 0;
 
     return return_error;
@@ -2946,6 +3387,77 @@ EB_API EbErrorType eb_svt_enc_set_parameter(
 
     return return_error;
 }
+
+/**********************************
+* Share Analysis
+*   Links a rendition of a ladder to
+*   the encoder of the top rendition.
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_share_analysis(
+    EbComponentType *lead_component,
+    EbComponentType *svt_enc_component)
+{
+    if (lead_component == NULL || svt_enc_component == NULL || lead_component == svt_enc_component)
+        return EB_ErrorBadParameter;
+
+    EbEncHandle_t        *leadEncHandlePtr = (EbEncHandle_t*)lead_component->p_component_private;
+    EbEncHandle_t        *encHandlePtr = (EbEncHandle_t*)svt_enc_component->p_component_private;
+    EncodeContext_t      *leadEncodeContextPtr = leadEncHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr;
+    EncodeContext_t      *encode_context_ptr = encHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr;
+    SequenceControlSet   *leadSequenceControlSetPtr = leadEncHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr;
+    SequenceControlSet   *sequence_control_set_ptr = encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr;
+    EbErrorType           return_error;
+
+    // A rendition follows one lead, and a lead follows none; the lead must not have
+    // started, or the rendition would wait for pictures it analysed already
+    if (encode_context_ptr->analysis_share_ptr != (EbAnalysisShare*)EB_NULL ||
+        (leadEncodeContextPtr->analysis_share_ptr != (EbAnalysisShare*)EB_NULL && !leadEncodeContextPtr->analysis_share_lead) ||
+        !leadEncodeContextPtr->initial_picture)
+        return EB_ErrorBadParameter;
+
+    // The renditions must share the GOP structure, and the lead be the largest
+    if (sequence_control_set_ptr->luma_width > leadSequenceControlSetPtr->luma_width ||
+        sequence_control_set_ptr->luma_height > leadSequenceControlSetPtr->luma_height ||
+        sequence_control_set_ptr->static_config.intra_period_length != leadSequenceControlSetPtr->static_config.intra_period_length ||
+        sequence_control_set_ptr->static_config.hierarchical_levels != leadSequenceControlSetPtr->static_config.hierarchical_levels ||
+        sequence_control_set_ptr->static_config.pred_structure != leadSequenceControlSetPtr->static_config.pred_structure)
+        return EB_ErrorBadParameter;
+
+    if (leadEncodeContextPtr->analysis_share_ptr == (EbAnalysisShare*)EB_NULL) {
+        return_error = eb_analysis_share_ctor(
+            &leadEncodeContextPtr->analysis_share_ptr,
+            leadSequenceControlSetPtr->luma_width,
+            leadSequenceControlSetPtr->luma_height,
+            leadSequenceControlSetPtr->picture_control_set_pool_init_count);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+        leadEncodeContextPtr->analysis_share_lead = EB_TRUE;
+    }
+
+    // The rendition holds its inputs until the lead analysed them: as many as the
+    // lead has queued or in flight, on top of its own
+    return_error = eb_analysis_share_add_follower(
+        leadEncodeContextPtr->analysis_share_ptr,
+        sequence_control_set_ptr->input_buffer_fifo_init_count +
+            leadSequenceControlSetPtr->input_buffer_fifo_init_count +
+            leadSequenceControlSetPtr->picture_control_set_pool_init_count,
+        &encode_context_ptr->analysis_share_follower_index);
+    if (return_error != EB_ErrorNone)
+        return return_error;
+    sequence_control_set_ptr->input_buffer_fifo_init_count +=
+        leadSequenceControlSetPtr->input_buffer_fifo_init_count +
+        leadSequenceControlSetPtr->picture_control_set_pool_init_count;
+
+    eb_analysis_share_retain(leadEncodeContextPtr->analysis_share_ptr);
+    encode_context_ptr->analysis_share_ptr = leadEncodeContextPtr->analysis_share_ptr;
+    encode_context_ptr->analysis_share_lead = EB_FALSE;
+
+    return EB_ErrorNone;
+}
+
 #if defined(__linux__) || defined(__APPLE__)
 __attribute__((visibility("default")))
 #endif
@@ -2973,6 +3485,43 @@ EB_API EbErrorType eb_svt_enc_eos_nal(
     return return_error;
 }
 
+/***********************************************
+**** Reference the frame allocated by the
+**** application from the library buffers
+************************************************/
+static void ReferenceFrameBuffer(
+    EbEncHandle_t                 *encHandlePtr,
+    SequenceControlSet            *sequence_control_set_ptr,
+    uint8_t                       *dst,
+    uint8_t                       *src)
+{
+    EbPictureBufferDesc_t           *input_picture_ptr = (EbPictureBufferDesc_t*)dst;
+    EbSvtIOFormat                   *inputPtr = (EbSvtIOFormat*)src;
+    EbInputFrameLayout               frameLayout;
+    EbByte                           frameBase;
+
+    InputFrameLayout(sequence_control_set_ptr, &frameLayout);
+
+    if (inputPtr == NULL) {
+        frameBase = encHandlePtr->blank_input_frame_ptr;
+    }
+    else {
+        frameBase = inputPtr->luma -
+            (frameLayout.luma_stride * sequence_control_set_ptr->top_padding + sequence_control_set_ptr->left_padding) -
+            frameLayout.plane_offset[0];
+    }
+
+    input_picture_ptr->buffer_y = frameBase + frameLayout.plane_offset[0];
+    input_picture_ptr->bufferCb = frameBase + frameLayout.plane_offset[1];
+    input_picture_ptr->bufferCr = frameBase + frameLayout.plane_offset[2];
+
+    if (sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT) {
+        input_picture_ptr->bufferBitIncY = frameBase + frameLayout.plane_offset[3];
+        input_picture_ptr->bufferBitIncCb = frameBase + frameLayout.plane_offset[4];
+        input_picture_ptr->bufferBitIncCr = frameBase + frameLayout.plane_offset[5];
+    }
+}
+
 /***********************************************
 **** Copy the input buffer from the
 **** sample application to the library buffers
@@ -3141,6 +3690,7 @@ static EbErrorType CopyFrameBuffer(
     return return_error;
 }
 static void CopyInputBuffer(
+    EbEncHandle_t*          encHandlePtr,
     SequenceControlSet*    sequenceControlSet,
     EbBufferHeaderType*     dst,
     EbBufferHeaderType*     src
@@ -3157,7 +3707,9 @@ static void CopyInputBuffer(
     dst->pic_type = src->pic_type;
 
     // Copy the picture buffer
-    if (src->p_buffer != NULL)
+    if (sequenceControlSet->external_input_buffer_flag)
+        ReferenceFrameBuffer(encHandlePtr, sequenceControlSet, dst->p_buffer, src->p_buffer);
+    else if (src->p_buffer != NULL)
         CopyFrameBuffer(sequenceControlSet, dst->p_buffer, src->p_buffer);
 }
 
@@ -3172,24 +3724,139 @@ EB_API EbErrorType eb_svt_enc_send_picture(
     EbBufferHeaderType   *p_buffer)
 {
     EbEncHandle_t          *encHandlePtr = (EbEncHandle_t*)svt_enc_component->p_component_private;
+    EncodeContext_t        *encode_context_ptr = encHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr;
+    EbAnalysisShare        *analysisSharePtr = encode_context_ptr->analysis_share_lead ? (EbAnalysisShare*)EB_NULL : encode_context_ptr->analysis_share_ptr;
     EbObjectWrapper      *ebWrapperPtr;
 
-    // Take the buffer and put it into our internal queue structure
+    // Take the buffer and put it into our internal queue structure; a follower
+    // of a ladder waits here while the lead has not analysed its inputs
     eb_get_empty_object(
         encHandlePtr->input_buffer_producer_fifo_ptr_array[0],
         &ebWrapperPtr);
 
     if (p_buffer != NULL) {
         CopyInputBuffer(
+            encHandlePtr,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr,
             (EbBufferHeaderType*)ebWrapperPtr->object_ptr,
             p_buffer);
     }
 
-    eb_post_full_object(ebWrapperPtr);
+    if (analysisSharePtr) {
+        eb_analysis_share_send_picture(
+            analysisSharePtr,
+            encode_context_ptr->analysis_share_follower_index,
+            ebWrapperPtr,
+            (EbBool)(p_buffer != NULL && (p_buffer->flags & EB_BUFFERFLAG_EOS)));
+    }
+    else
+        eb_post_full_object(ebWrapperPtr);
 
     return EB_ErrorNone;
 }
+
+/**********************************
+* Set Frame Buffer Callbacks
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_set_frame_buffer_callbacks(
+    EbComponentType             *svt_enc_component,
+    eb_allocate_frame_buffer    allocate_buffer,
+    eb_release_frame_buffer     release_buffer,
+    void                        *priv_data)
+{
+    EbEncHandle_t          *encHandlePtr;
+
+    if (svt_enc_component == NULL || allocate_buffer == NULL || release_buffer == NULL)
+        return EB_ErrorBadParameter;
+
+    encHandlePtr = (EbEncHandle_t*)svt_enc_component->p_component_private;
+
+    // The input buffers are constructed by eb_init_encoder
+    if (encHandlePtr->input_buffer_resource_ptr != NULL)
+        return EB_ErrorBadParameter;
+
+    encHandlePtr->allocate_input_buffer = allocate_buffer;
+    encHandlePtr->release_input_buffer = release_buffer;
+    encHandlePtr->input_buffer_priv_data = priv_data;
+    encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->external_input_buffer_flag = EB_TRUE;
+
+    return EB_ErrorNone;
+}
+
+/**********************************
+* Allocate Input Frame
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_allocate_input_frame(
+    EbComponentType             *svt_enc_component,
+    EbSvtIOFormat               *frame)
+{
+    EbEncHandle_t          *encHandlePtr;
+    SequenceControlSet     *sequence_control_set_ptr;
+    EbInputFrameLayout      frameLayout;
+    EbInputFrameHeader     *frameHeaderPtr;
+    EbExtFrameBuf           frameBuf;
+    EbByte                  frameBase;
+    uint32_t                lumaOrigin;
+    uint32_t                chromaOrigin;
+
+    if (svt_enc_component == NULL || frame == NULL)
+        return EB_ErrorBadParameter;
+
+    encHandlePtr = (EbEncHandle_t*)svt_enc_component->p_component_private;
+    sequence_control_set_ptr = encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr;
+    if (encHandlePtr->blank_input_frame_ptr == NULL)
+        return EB_ErrorBadParameter;
+
+    InputFrameLayout(sequence_control_set_ptr, &frameLayout);
+
+    // Room to align the start of the frame
+    frameBuf.buffer = NULL;
+    frameBuf.buffer_size = 0;
+    frameBuf.private_data = NULL;
+    if (encHandlePtr->allocate_input_buffer(&frameBuf, frameLayout.frame_size + INPUT_FRAME_ALIGNMENT - 1, encHandlePtr->input_buffer_priv_data) != 0 ||
+        frameBuf.buffer == NULL ||
+        frameBuf.buffer_size < frameLayout.frame_size + INPUT_FRAME_ALIGNMENT - 1)
+        return EB_ErrorInsufficientResources;
+
+    frameBase = (EbByte)(((uintptr_t)frameBuf.buffer + INPUT_FRAME_ALIGNMENT - 1) & ~(uintptr_t)(INPUT_FRAME_ALIGNMENT - 1));
+    frameHeaderPtr = (EbInputFrameHeader*)frameBase;
+    frameHeaderPtr->frame_buf = frameBuf;
+    frameHeaderPtr->release_buffer = encHandlePtr->release_input_buffer;
+    frameHeaderPtr->priv_data = encHandlePtr->input_buffer_priv_data;
+
+    lumaOrigin = frameLayout.luma_stride * sequence_control_set_ptr->top_padding + sequence_control_set_ptr->left_padding;
+    chromaOrigin = frameLayout.chroma_stride * (sequence_control_set_ptr->top_padding >> 1) + (sequence_control_set_ptr->left_padding >> 1);
+
+    frame->luma = frameBase + frameLayout.plane_offset[0] + lumaOrigin;
+    frame->cb = frameBase + frameLayout.plane_offset[1] + chromaOrigin;
+    frame->cr = frameBase + frameLayout.plane_offset[2] + chromaOrigin;
+    if (sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT) {
+        frame->luma_ext = frameBase + frameLayout.plane_offset[3];
+        frame->cb_ext = frameBase + frameLayout.plane_offset[4];
+        frame->cr_ext = frameBase + frameLayout.plane_offset[5];
+    }
+    else {
+        frame->luma_ext = NULL;
+        frame->cb_ext = NULL;
+        frame->cr_ext = NULL;
+    }
+    frame->y_stride = frameLayout.luma_stride;
+    frame->cb_stride = frameLayout.chroma_stride;
+    frame->cr_stride = frameLayout.chroma_stride;
+    frame->width = sequence_control_set_ptr->max_input_luma_width;
+    frame->height = sequence_control_set_ptr->max_input_luma_height;
+    frame->origin_x = sequence_control_set_ptr->left_padding;
+    frame->origin_y = sequence_control_set_ptr->top_padding;
+
+    return EB_ErrorNone;
+}
+
 static void CopyOutputReconBuffer(
     EbBufferHeaderType   *dst,
     EbBufferHeaderType   *src
@@ -3318,6 +3985,180 @@ EB_API EbErrorType eb_svt_get_recon(
     return return_error;
 }
 
+/**********************************
+* Stage Utilization
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_get_stage_utilization(
+    EbComponentType      *svt_enc_component,
+    EbStageUtilization   *stage_array,
+    uint32_t             *stage_count)
+{
+    EbEncHandle_t          *pEncCompData;
+    EbTaskScheduler        *schedulerPtr;
+    EbSchedulerStage       *stagePtr;
+    uint64_t                wallTime;
+    uint32_t                stageIndex;
+
+    if (svt_enc_component == NULL || stage_array == NULL || stage_count == NULL)
+        return EB_ErrorBadParameter;
+
+    pEncCompData = (EbEncHandle_t*)svt_enc_component->p_component_private;
+    schedulerPtr = (EbTaskScheduler*)pEncCompData->taskSchedulerPtr;
+    if (schedulerPtr == NULL) {
+        *stage_count = 0;
+        return EB_ErrorNone;
+    }
+
+    wallTime = eb_get_time_stamp_us() - schedulerPtr->start_time_us;
+
+    for (stageIndex = 0; stageIndex < schedulerPtr->stage_count && stageIndex < EB_MAX_STAGE_UTILIZATION_COUNT; ++stageIndex) {
+        stagePtr = &schedulerPtr->stage_array[stageIndex];
+        stage_array[stageIndex].stage_name    = stagePtr->name;
+        stage_array[stageIndex].context_count = stagePtr->context_count;
+        stage_array[stageIndex].task_count    = (uint64_t)eb_atomic_fetch_add_64(&stagePtr->task_count, 0);
+        stage_array[stageIndex].busy_time_us  = (uint64_t)eb_atomic_fetch_add_64(&stagePtr->busy_time_us, 0);
+        stage_array[stageIndex].wall_time_us  = wallTime;
+        stage_array[stageIndex].starved_count = (uint64_t)eb_atomic_fetch_add_64(&stagePtr->starved_count, 0);
+    }
+    *stage_count = stageIndex;
+
+    return EB_ErrorNone;
+}
+
+/**********************************
+* Pipeline Stats
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_get_stats(
+    EbComponentType      *svt_enc_component,
+    EbSvtEncStats        *stats)
+{
+    EbEncHandle_t          *pEncCompData;
+
+    if (svt_enc_component == NULL || stats == NULL)
+        return EB_ErrorBadParameter;
+
+    pEncCompData = (EbEncHandle_t*)svt_enc_component->p_component_private;
+    if (pEncCompData->pipelineStatsPtr == NULL) {
+        EB_MEMSET(stats, 0, sizeof(EbSvtEncStats));
+        return EB_ErrorNone;
+    }
+
+    eb_pipeline_stats_get(
+        (EbPipelineStats*)pEncCompData->pipelineStatsPtr,
+        stats);
+
+    return EB_ErrorNone;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_write_trace(
+    EbComponentType      *svt_enc_component,
+    const char           *file_name)
+{
+    EbEncHandle_t          *pEncCompData;
+
+    if (svt_enc_component == NULL || file_name == NULL)
+        return EB_ErrorBadParameter;
+
+    pEncCompData = (EbEncHandle_t*)svt_enc_component->p_component_private;
+    if (pEncCompData->pipelineStatsPtr == NULL)
+        return EB_ErrorBadParameter;
+
+    return eb_pipeline_stats_write_trace(
+        (EbPipelineStats*)pEncCompData->pipelineStatsPtr,
+        file_name);
+}
+
+/**********************************
+* Memory Usage
+**********************************/
+static void MemoryPoolUsageAdd(
+    EbSvtMemoryUsage     *usage_ptr,
+    const char           *pool_name,
+    EbSystemResource     *resource_ptr)
+{
+    EbMemoryPoolUsage    *poolPtr;
+
+    if (resource_ptr == (EbSystemResource*)EB_NULL || usage_ptr->pool_count == EB_MAX_MEMORY_POOL_COUNT)
+        return;
+
+    poolPtr = &usage_ptr->pool_array[usage_ptr->pool_count++];
+    poolPtr->pool_name = pool_name;
+    poolPtr->object_count = (uint32_t)resource_ptr->object_created_count;
+    poolPtr->object_max_count = resource_ptr->object_total_count;
+    poolPtr->committed_bytes = resource_ptr->object_memory_size;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_get_memory_usage(
+    EbComponentType      *svt_enc_component,
+    EbSvtMemoryUsage     *usage)
+{
+    EbEncHandle_t          *pEncCompData;
+    EbMemoryArenaType       typeArray[EB_MAX_MEMORY_TYPE_COUNT];
+    uint32_t                instance_index;
+    uint32_t                typeIndex;
+
+    if (svt_enc_component == NULL || usage == NULL)
+        return EB_ErrorBadParameter;
+
+    pEncCompData = (EbEncHandle_t*)svt_enc_component->p_component_private;
+
+    // The pools are constructed by eb_init_encoder
+    if (pEncCompData->sequenceControlSetPoolPtr == (EbSystemResource*)EB_NULL)
+        return EB_ErrorBadParameter;
+
+    usage->total_committed_bytes = pEncCompData->memory_arena->committed_size;
+    usage->total_reserved_bytes = pEncCompData->memory_arena->reserved_size;
+    usage->pool_count = 0;
+
+    MemoryPoolUsageAdd(usage, "SequenceControlSet", pEncCompData->sequenceControlSetPoolPtr);
+    for (instance_index = 0; instance_index < pEncCompData->encodeInstanceTotalCount; ++instance_index) {
+        MemoryPoolUsageAdd(usage, "PictureParentControlSet", pEncCompData->pictureParentControlSetPoolPtrArray[instance_index]);
+        MemoryPoolUsageAdd(usage, "PictureControlSet", pEncCompData->pictureControlSetPoolPtrArray[instance_index]);
+        MemoryPoolUsageAdd(usage, "ReferencePicture", pEncCompData->referencePicturePoolPtrArray[instance_index]);
+        MemoryPoolUsageAdd(usage, "PaReferencePicture", pEncCompData->paReferencePicturePoolPtrArray[instance_index]);
+        MemoryPoolUsageAdd(usage, "OutputStreamBuffer", pEncCompData->output_stream_buffer_resource_ptr_array[instance_index]);
+        if (pEncCompData->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.recon_enabled)
+            MemoryPoolUsageAdd(usage, "OutputReconBuffer", pEncCompData->output_recon_buffer_resource_ptr_array[instance_index]);
+    }
+    MemoryPoolUsageAdd(usage, "InputBuffer", pEncCompData->input_buffer_resource_ptr);
+    MemoryPoolUsageAdd(usage, "ResourceCoordinationResults", pEncCompData->resourceCoordinationResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "PictureAnalysisResults", pEncCompData->pictureAnalysisResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "PictureDecisionResults", pEncCompData->pictureDecisionResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "MotionEstimationResults", pEncCompData->motionEstimationResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "InitialRateControlResults", pEncCompData->initialRateControlResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "PictureDemuxResults", pEncCompData->pictureDemuxResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "RateControlTasks", pEncCompData->rateControlTasksResourcePtr);
+    MemoryPoolUsageAdd(usage, "RateControlResults", pEncCompData->rateControlResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "EncDecTasks", pEncCompData->encDecTasksResourcePtr);
+    MemoryPoolUsageAdd(usage, "EncDecResults", pEncCompData->encDecResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "DlfResults", pEncCompData->dlfResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "CdefResults", pEncCompData->cdefResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "RestResults", pEncCompData->restResultsResourcePtr);
+    MemoryPoolUsageAdd(usage, "IntraBcHashBuffers", pEncCompData->intrabcHashBuffersResourcePtr);
+    MemoryPoolUsageAdd(usage, "EntropyCodingResults", pEncCompData->entropyCodingResultsResourcePtr);
+
+    usage->type_count = eb_memory_arena_get_types(pEncCompData->memory_arena, typeArray, EB_MAX_MEMORY_TYPE_COUNT);
+    for (typeIndex = 0; typeIndex < usage->type_count; ++typeIndex) {
+        usage->type_array[typeIndex].type_name = typeArray[typeIndex].type_name;
+        usage->type_array[typeIndex].allocation_count = typeArray[typeIndex].allocation_count;
+        usage->type_array[typeIndex].committed_bytes = typeArray[typeIndex].size;
+    }
+
+    return EB_ErrorNone;
+}
+
 /**********************************
 * Encoder Error Handling
 **********************************/
@@ -3411,6 +4252,12 @@ static EbErrorType allocate_frame_buffer(
         input_picture_buffer_desc_init_data.splitMode = EB_FALSE;  //do special allocation for 2bit data down below.
     }
 
+    // The planes are those of the frames sent by the application
+    if (sequence_control_set_ptr->external_input_buffer_flag) {
+        input_picture_buffer_desc_init_data.bufferEnableMask = 0;
+        input_picture_buffer_desc_init_data.splitMode = EB_FALSE;
+    }
+
     // Enhanced Picture Buffer
     return_error = eb_picture_buffer_desc_ctor(
         (EbPtr*) &(inputBuffer->p_buffer),
@@ -3420,7 +4267,7 @@ static EbErrorType allocate_frame_buffer(
         return EB_ErrorInsufficientResources;
     }
 
-    if (is16bit && config->compressed_ten_bit_format == 1) {
+    if (is16bit && config->compressed_ten_bit_format == 1 && !sequence_control_set_ptr->external_input_buffer_flag) {
         //pack 4 2bit pixels into 1Byte
         EB_ALLIGN_MALLOC(uint8_t*, ((EbPictureBufferDesc_t*)(inputBuffer->p_buffer))->bufferBitIncY, sizeof(uint8_t) * (input_picture_buffer_desc_init_data.maxWidth / 4)*(input_picture_buffer_desc_init_data.maxHeight), EB_A_PTR);
         EB_ALLIGN_MALLOC(uint8_t*, ((EbPictureBufferDesc_t*)(inputBuffer->p_buffer))->bufferBitIncCb, sizeof(uint8_t) * (input_picture_buffer_desc_init_data.maxWidth / 8)*(input_picture_buffer_desc_init_data.maxHeight / 2), EB_A_PTR);
@@ -10,6 +10,7 @@
 #include "EbSvtAv1Enc.h"
 #include "EbPictureBufferDesc.h"
 #include "EbSystemResourceManager.h"
+#include "EbMemoryArena.h"
 #include "EbSequenceControlSet.h"
 
 #include "EbResourceCoordinationResults.h"
@@ -61,22 +62,21 @@ typedef struct EbEncHandle_s
     // Thread Handles
     EbHandle                               resourceCoordinationThreadHandle;
     EbHandle                               pictureEnhancementThreadHandle;
-    EbHandle                              *pictureAnalysisThreadHandleArray;
     EbHandle                               pictureDecisionThreadHandle;
-    EbHandle                              *motionEstimationThreadHandleArray;
     EbHandle                               initialRateControlThreadHandle;
     EbHandle                              *sourceBasedOperationsThreadHandleArray;
     EbHandle                               pictureManagerThreadHandle;
     EbHandle                               rateControlThreadHandle;
     EbHandle                              *modeDecisionConfigurationThreadHandleArray;
-    EbHandle                              *encDecThreadHandleArray;
-    EbHandle                              *entropyCodingThreadHandleArray;
-    EbHandle                              *dlfThreadHandleArray;
-    EbHandle                              *cdefThreadHandleArray;
-    EbHandle                              *restThreadHandleArray;
 
     EbHandle                               packetizationThreadHandle;
 
+    // Task Scheduler running the analysis, encode and filter stages
+    EbPtr                                  taskSchedulerPtr;
+
+    // Pipeline instrumentation, when enable_pipeline_stats is set
+    EbPtr                                  pipelineStatsPtr;
+
     // Contexts
     EbPtr                                  resourceCoordinationContextPtr;
     EbPtr                                  pictureEnhancementContextPtr;
@@ -114,6 +114,7 @@ typedef struct EbEncHandle_s
     EbSystemResource                     *dlfResultsResourcePtr;
     EbSystemResource                     *cdefResultsResourcePtr;
     EbSystemResource                     *restResultsResourcePtr;
+    EbSystemResource                     *intrabcHashBuffersResourcePtr;
 
     // Inter-Process Producer Fifos
     EbFifo                              **input_buffer_producer_fifo_ptr_array;
@@ -135,6 +136,7 @@ typedef struct EbEncHandle_s
     EbFifo                              **dlfResultsProducerFifoPtrArray;
     EbFifo                              **cdefResultsProducerFifoPtrArray;
     EbFifo                              **restResultsProducerFifoPtrArray;
+    EbFifo                              **intrabcHashBuffersProducerFifoPtrArray;
 
 
     // Inter-Process Consumer Fifos
@@ -160,10 +162,14 @@ typedef struct EbEncHandle_s
     // Callbacks
     EbCallback_t                          **app_callback_ptr_array;
 
-    // Memory Map
-    EbMemoryMapEntry                       *memory_map;
-    uint32_t                                memory_map_index;
-    uint64_t                                total_lib_memory;
+    // Input frames allocated by the application
+    eb_allocate_frame_buffer                allocate_input_buffer;
+    eb_release_frame_buffer                 release_input_buffer;
+    void                                   *input_buffer_priv_data;
+    EbByte                                  blank_input_frame_ptr;
+
+    // Memory Arena
+    EbMemoryArena                          *memory_arena;
 
 } EbEncHandle_t;
 
@@ -0,0 +1,271 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file AnalysisShareTest.cc
+ *
+ * @brief Unit test for the analysis shared by the encoders of an ABR ladder:
+ * - scene change decisions read without waiting for the lead
+ * - HME seeds scaled to the follower resolution
+ * - follower inputs held until the lead analysed the pictures, in order
+ * - records kept until the slowest follower is through Motion Estimation
+ * - follower inputs released when the lead closes
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbAnalysisShare.h"
+#include "EbMemoryArena.h"
+#include "EbSystemResourceManager.h"
+
+namespace {
+
+const uint32_t kLeadWidth = 1920;
+const uint32_t kLeadHeight = 1080;
+const uint32_t kLeadPictures = 40;
+const uint32_t kInputs = 8;
+
+/**
+ * @brief Each test shares the analysis of a 1080p lead with one follower,
+ * whose inputs are the objects of a resource allocated from the arena of
+ * the test, as the input buffers of an encoder.
+ */
+class AnalysisShareTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        ASSERT_EQ(eb_system_resource_ctor(&inputs_,
+                                          kInputs,
+                                          1,
+                                          1,
+                                          &producer_fifos_,
+                                          &consumer_fifos_,
+                                          EB_TRUE,
+                                          nullptr,
+                                          nullptr),
+                  EB_ErrorNone);
+        ASSERT_EQ(eb_analysis_share_ctor(&share_, kLeadWidth, kLeadHeight,
+                                         kLeadPictures),
+                  EB_ErrorNone);
+        ASSERT_EQ(eb_analysis_share_add_follower(share_, kInputs, &follower_),
+                  EB_ErrorNone);
+        next_input_ = 0;
+    }
+
+    void TearDown() override {
+        eb_analysis_share_remove_follower(share_, follower_);
+        eb_analysis_share_release(share_);
+        eb_memory_arena_dtor(arena_);
+    }
+
+    // Sends the next input of the follower, tagged with its picture number
+    void send_input(bool end_of_sequence) {
+        EbObjectWrapper *wrapper;
+        eb_get_empty_object(producer_fifos_[0], &wrapper);
+        wrapper->object_ptr = (EbPtr)(uintptr_t)(next_input_++ + 1);
+        eb_analysis_share_send_picture(share_, follower_, wrapper,
+                                       end_of_sequence ? EB_TRUE : EB_FALSE);
+    }
+
+    // Picture number of the next input posted to the follower pipeline, -1
+    // when none is
+    int64_t posted_input() {
+        EbObjectWrapper *wrapper = nullptr;
+        eb_try_get_full_object(consumer_fifos_[0], &wrapper);
+        if (wrapper == nullptr)
+            return -1;
+        int64_t picture_number = (int64_t)(uintptr_t)wrapper->object_ptr - 1;
+        eb_release_object(wrapper);
+        return picture_number;
+    }
+
+    // The lead runs Picture Decision and Motion Estimation on the picture
+    void analyse(uint64_t picture_number) {
+        eb_analysis_share_open_picture(share_, picture_number);
+        eb_analysis_share_set_scene_change(share_, picture_number, EB_FALSE);
+        eb_analysis_share_add_hme_sbs(
+            share_, picture_number,
+            share_->picture_width_in_sb * share_->picture_height_in_sb);
+    }
+
+    // The follower runs Motion Estimation on the picture, in two segments
+    void follower_done(uint32_t follower, uint64_t picture_number) {
+        eb_analysis_share_follower_hme_sbs(share_, follower, picture_number,
+                                           10, 24);
+        eb_analysis_share_follower_hme_sbs(share_, follower, picture_number,
+                                           14, 24);
+    }
+
+    EbMemoryArena *arena_;
+    EbSystemResource *inputs_;
+    EbFifo **producer_fifos_;
+    EbFifo **consumer_fifos_;
+    EbAnalysisShare *share_;
+    uint32_t follower_;
+    uint64_t next_input_;
+};
+
+TEST_F(AnalysisShareTest, SceneChangeNotWaited) {
+    EbBool flag = EB_FALSE;
+
+    // Nothing published yet: the follower does not wait
+    EXPECT_FALSE(eb_analysis_share_get_scene_change(share_, 7, &flag));
+
+    eb_analysis_share_open_picture(share_, 7);
+    EXPECT_FALSE(eb_analysis_share_get_scene_change(share_, 7, &flag));
+    eb_analysis_share_set_scene_change(share_, 7, EB_TRUE);
+    ASSERT_TRUE(eb_analysis_share_get_scene_change(share_, 7, &flag));
+    EXPECT_EQ(flag, EB_TRUE);
+
+    // Once the follower is through, the record of picture 7 holds a later
+    // picture
+    ASSERT_GT(share_->record_count, kLeadPictures);
+    follower_done(follower_, 7);
+    eb_analysis_share_open_picture(share_, 7 + share_->record_count);
+    EXPECT_FALSE(eb_analysis_share_get_scene_change(share_, 7, &flag));
+    EXPECT_EQ(eb_analysis_share_get_hme(share_, 7),
+              (EbAnalysisShareRecord *)NULL);
+}
+
+TEST_F(AnalysisShareTest, SeedScaling) {
+    const uint32_t sb_total =
+        share_->picture_width_in_sb * share_->picture_height_in_sb;
+    EbAnalysisShareRecord *record = eb_analysis_share_open_picture(share_, 5);
+
+    for (uint32_t sb = 0; sb < sb_total; ++sb) {
+        EbAnalysisShareSeed *seed =
+            &record->seed_array[sb * MAX_NUM_OF_REF_PIC_LIST + REF_LIST_0];
+        seed->x_search_center = (int16_t)(sb % share_->picture_width_in_sb);
+        seed->y_search_center = -(int16_t)(sb / share_->picture_width_in_sb);
+        seed->valid = (sb != 0);
+    }
+    eb_analysis_share_add_hme_sbs(share_, 5, sb_total);
+    ASSERT_EQ(eb_analysis_share_get_hme(share_, 5), record);
+
+    int16_t x = 0, y = 0;
+    // Half resolution: SB (2, 1) at 960x540 maps to lead SB (5, 3), seeds
+    // are halved
+    ASSERT_TRUE(eb_analysis_share_get_seed(share_, record, 5, REF_LIST_0,
+                                           128, 64, 960, 540, &x, &y));
+    EXPECT_EQ(x, 5 / 2);
+    EXPECT_EQ(y, -3 / 2);
+
+    // Same resolution, no seed for lead SB 0
+    EXPECT_FALSE(eb_analysis_share_get_seed(share_, record, 5, REF_LIST_0, 0,
+                                            0, kLeadWidth, kLeadHeight, &x,
+                                            &y));
+
+    // Bottom right SB of a 640x360 follower maps to lead SB (28, 16), the
+    // last SB row of the lead
+    ASSERT_TRUE(eb_analysis_share_get_seed(share_, record, 5, REF_LIST_0,
+                                           640 - 64, 320, 640, 360, &x, &y));
+    EXPECT_EQ(x, 28 / 3);
+    EXPECT_EQ(y, -16 / 3);
+}
+
+TEST_F(AnalysisShareTest, InputsHeldUntilAnalysed) {
+    for (int i = 0; i < 3; ++i)
+        send_input(false);
+    EXPECT_EQ(posted_input(), -1);
+
+    // Released in input order, whatever order the lead finishes in
+    analyse(1);
+    EXPECT_EQ(posted_input(), -1);
+    analyse(0);
+    EXPECT_EQ(posted_input(), 0);
+    EXPECT_EQ(posted_input(), 1);
+    EXPECT_EQ(posted_input(), -1);
+
+    // The end of sequence follows the last picture, without an analysis
+    send_input(true);
+    EXPECT_EQ(posted_input(), -1);
+    analyse(2);
+    EXPECT_EQ(posted_input(), 2);
+    EXPECT_EQ(posted_input(), 3);
+
+    // A follower behind the lead is not held
+    analyse(4);
+    send_input(false);
+    EXPECT_EQ(posted_input(), 4);
+}
+
+/**
+ * @brief The lead reuses a record once every follower ran Motion Estimation
+ * on its picture, or left the ladder.
+ */
+TEST_F(AnalysisShareTest, LeadWaitsForSlowestFollower) {
+    uint32_t second;
+    ASSERT_EQ(eb_analysis_share_add_follower(share_, kInputs, &second),
+              EB_ErrorNone);
+
+    analyse(3);
+    std::atomic<int> opened(0);
+    std::thread lead([&]() {
+        eb_analysis_share_open_picture(share_, 3 + share_->record_count);
+        opened = 1;
+    });
+
+    // One follower through, in two segments, does not release the record
+    eb_analysis_share_follower_hme_sbs(share_, follower_, 3, 10, 24);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(opened, 0);
+    eb_analysis_share_follower_hme_sbs(share_, follower_, 3, 14, 24);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(opened, 0);
+    EXPECT_NE(eb_analysis_share_get_hme(share_, 3),
+              (EbAnalysisShareRecord *)NULL);
+
+    follower_done(second, 3);
+    lead.join();
+    EXPECT_EQ(opened, 1);
+    EXPECT_EQ(eb_analysis_share_get_hme(share_, 3),
+              (EbAnalysisShareRecord *)NULL);
+
+    // A follower leaving the ladder releases the records it holds
+    analyse(5);
+    follower_done(follower_, 5);
+    std::thread next_lead([&]() {
+        eb_analysis_share_open_picture(share_, 5 + share_->record_count);
+        opened = 2;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(opened, 1);
+    eb_analysis_share_remove_follower(share_, second);
+    next_lead.join();
+    EXPECT_EQ(opened, 2);
+}
+
+TEST_F(AnalysisShareTest, InputsReleasedWithoutLead) {
+    send_input(false);
+    send_input(false);
+    EXPECT_EQ(posted_input(), -1);
+
+    // Everything goes through once the lead is closed, without its analysis
+    eb_analysis_share_close_lead(share_);
+    EXPECT_EQ(posted_input(), 0);
+    EXPECT_EQ(posted_input(), 1);
+    EXPECT_EQ(eb_analysis_share_get_hme(share_, 1),
+              (EbAnalysisShareRecord *)NULL);
+    send_input(true);
+    EXPECT_EQ(posted_input(), 2);
+}
+
+}  // namespace
@@ -0,0 +1,314 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file Avx512AsmTest.cc
+ *
+ * @brief Unit test for the AVX-512 kernels:
+ * - ext_all_sad_calculation_8x8_16x16_avx512,
+ *   ext_eight_sad_calculation_32x32_64x64_avx512 and
+ *   sad_loop_kernel_avx512_intrin against the C version
+ * - av1_fwd_txfm2d_{32x32, 64x64}_avx512, av1_inv_txfm2d_add_32x32_avx512
+ *   and av1_convolve_2d_sr_avx512 against the AVX2 version
+ *
+ * The tests are skipped on processors without AVX-512 F, DQ, BW and VL.
+ *
+ ******************************************************************************/
+#include "gtest/gtest.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+#include "EbDefinitions.h"
+#include "EbTransforms.h"
+#include "convolve.h"
+#include "random.h"
+#include "util.h"
+#include "aom_dsp_rtcd.h"
+
+extern "C" {
+int32_t CheckAvx512Features(void);
+InterpFilterParams av1_get_interp_filter_params_with_block_size(
+    const InterpFilter interp_filter, const int32_t w);
+}
+
+using svt_av1_test_tool::SVTRandom;
+namespace {
+
+#define SKIP_WITHOUT_AVX512()                                \
+    do {                                                     \
+        if (!CheckAvx512Features()) {                        \
+            printf("AVX-512 is not available, skipped\n");   \
+            return;                                          \
+        }                                                    \
+    } while (0)
+
+#if NSQ_ME_OPT
+TEST(Avx512AsmTest, MeSadCalculation) {
+    SKIP_WITHOUT_AVX512();
+
+    const uint32_t src_stride = 64;
+    const uint32_t ref_stride = 64 + 16;
+    DECLARE_ALIGNED(32, uint8_t, src[64 * 64]);
+    DECLARE_ALIGNED(32, uint8_t, ref[(64 + 16) * (64 + 16)]);
+    uint32_t best_sad8x8[2][64], best_sad16x16[2][16], best_mv8x8[2][64],
+        best_mv16x16[2][16];
+    uint32_t best_sad32x32[2][4], best_sad64x64[2][1], best_mv32x32[2][4],
+        best_mv64x64[2][1];
+    uint32_t eight_sad8x8[2][64][8], eight_sad16x16[2][16][8],
+        eight_sad32x32[2][4][8];
+    SVTRandom rnd(0, 255);
+
+    for (int loop = 0; loop < 20; loop++) {
+        // Flat pictures in some loops make ties between search positions
+        const int range = (loop % 4 == 3) ? 1 : 256;
+        for (uint32_t i = 0; i < sizeof(src); i++)
+            src[i] = (uint8_t)(rnd.random() % range);
+        for (uint32_t i = 0; i < sizeof(ref); i++)
+            ref[i] = (uint8_t)(rnd.random() % range);
+
+        for (int k = 0; k < 2; k++) {
+            for (int i = 0; i < 64; i++) {
+                best_sad8x8[k][i] = (loop & 1) ? 0xFFFFFFFF : 4000;
+                best_mv8x8[k][i] = 0;
+            }
+            for (int i = 0; i < 16; i++) {
+                best_sad16x16[k][i] = (loop & 1) ? 0xFFFFFFFF : 16000;
+                best_mv16x16[k][i] = 0;
+            }
+            for (int i = 0; i < 4; i++) {
+                best_sad32x32[k][i] = (loop & 1) ? 0xFFFFFFFF : 64000;
+                best_mv32x32[k][i] = 0;
+            }
+            best_sad64x64[k][0] = (loop & 1) ? 0xFFFFFFFF : 256000;
+            best_mv64x64[k][0] = 0;
+        }
+
+        // Several search positions accumulate the best values
+        for (int pos = 0; pos < 8; pos++) {
+            const int16_t x = (int16_t)(pos * 8 - 32);
+            const int16_t y = (int16_t)(-pos * 3 + loop);
+            const uint32_t mv =
+                ((uint32_t)(uint16_t)y << 18) | (uint16_t)(x << 2);
+            uint8_t *r = ref + (pos & 1) * ref_stride + (pos >> 1);
+
+            ext_all_sad_calculation_8x8_16x16_c(
+                src, src_stride, r, ref_stride, mv, best_sad8x8[0],
+                best_sad16x16[0], best_mv8x8[0], best_mv16x16[0],
+                eight_sad16x16[0], eight_sad8x8[0]);
+            ext_all_sad_calculation_8x8_16x16_avx512(
+                src, src_stride, r, ref_stride, mv, best_sad8x8[1],
+                best_sad16x16[1], best_mv8x8[1], best_mv16x16[1],
+                eight_sad16x16[1], eight_sad8x8[1]);
+            ext_eight_sad_calculation_32x32_64x64_c(
+                eight_sad16x16[0], best_sad32x32[0], best_sad64x64[0],
+                best_mv32x32[0], best_mv64x64[0], mv, eight_sad32x32[0]);
+            ext_eight_sad_calculation_32x32_64x64_avx512(
+                eight_sad16x16[1], best_sad32x32[1], best_sad64x64[1],
+                best_mv32x32[1], best_mv64x64[1], mv, eight_sad32x32[1]);
+
+            ASSERT_EQ(0, memcmp(eight_sad8x8[0], eight_sad8x8[1],
+                                sizeof(eight_sad8x8[0])))
+                << "loop " << loop << " pos " << pos;
+            ASSERT_EQ(0, memcmp(eight_sad16x16[0], eight_sad16x16[1],
+                                sizeof(eight_sad16x16[0])))
+                << "loop " << loop << " pos " << pos;
+            ASSERT_EQ(0, memcmp(eight_sad32x32[0], eight_sad32x32[1],
+                                sizeof(eight_sad32x32[0])))
+                << "loop " << loop << " pos " << pos;
+        }
+
+        ASSERT_EQ(0, memcmp(best_sad8x8[0], best_sad8x8[1], sizeof(best_sad8x8[0])));
+        ASSERT_EQ(0, memcmp(best_mv8x8[0], best_mv8x8[1], sizeof(best_mv8x8[0])));
+        ASSERT_EQ(0, memcmp(best_sad16x16[0], best_sad16x16[1], sizeof(best_sad16x16[0])));
+        ASSERT_EQ(0, memcmp(best_mv16x16[0], best_mv16x16[1], sizeof(best_mv16x16[0])));
+        ASSERT_EQ(0, memcmp(best_sad32x32[0], best_sad32x32[1], sizeof(best_sad32x32[0])));
+        ASSERT_EQ(0, memcmp(best_mv32x32[0], best_mv32x32[1], sizeof(best_mv32x32[0])));
+        ASSERT_EQ(best_sad64x64[0][0], best_sad64x64[1][0]);
+        ASSERT_EQ(best_mv64x64[0][0], best_mv64x64[1][0]);
+    }
+}
+#endif
+
+TEST(Avx512AsmTest, SadLoopKernel) {
+    SKIP_WITHOUT_AVX512();
+
+    const uint32_t widths[] = {4, 8, 12, 16, 24, 32, 40, 48, 56, 64};
+    const uint32_t heights[] = {2, 8, 15, 32, 64};
+    const int16_t search_widths[] = {1, 7, 8, 31, 33, 64, 100};
+    const int16_t search_height = 5;
+    SVTRandom rnd(0, 255);
+
+    for (int loop = 0; loop < 3; loop++) {
+        for (uint32_t width : widths) {
+            for (uint32_t height : heights) {
+                for (int16_t search_width : search_widths) {
+                    const uint32_t src_stride = 64;
+                    const uint32_t ref_stride = search_width + width - 1;
+                    // Only the pixels the C version reads
+                    std::vector<uint8_t> src(src_stride * height);
+                    std::vector<uint8_t> ref(
+                        ref_stride * (height + search_height - 1));
+                    uint64_t best_sad[2];
+                    int16_t x_best[2] = {-1, -1}, y_best[2] = {-1, -1};
+
+                    // Flat pictures make ties, extreme ones the largest SADs
+                    for (uint8_t &pixel : src)
+                        pixel = loop == 0 ? (uint8_t)rnd.random()
+                                          : (uint8_t)(loop == 1 ? 0 : 255);
+                    for (uint8_t &pixel : ref)
+                        pixel = loop == 0 ? (uint8_t)rnd.random()
+                                          : (uint8_t)(loop == 1 ? rnd.random() & 1 : 0);
+
+                    sad_loop_kernel_c(src.data(), src_stride, ref.data(),
+                                      ref_stride, height, width, &best_sad[0],
+                                      &x_best[0], &y_best[0], ref_stride,
+                                      search_width, search_height);
+                    sad_loop_kernel_avx512_intrin(
+                        src.data(), src_stride, ref.data(), ref_stride, height,
+                        width, &best_sad[1], &x_best[1], &y_best[1],
+                        ref_stride, search_width, search_height);
+
+                    ASSERT_EQ(best_sad[0], best_sad[1])
+                        << "loop " << loop << " " << width << "x" << height
+                        << " search width " << search_width;
+                    ASSERT_EQ(x_best[0], x_best[1])
+                        << "loop " << loop << " " << width << "x" << height
+                        << " search width " << search_width;
+                    ASSERT_EQ(y_best[0], y_best[1])
+                        << "loop " << loop << " " << width << "x" << height
+                        << " search width " << search_width;
+                }
+            }
+        }
+    }
+}
+
+TEST(Avx512AsmTest, FwdTxfm2d) {
+    SKIP_WITHOUT_AVX512();
+
+    const TxType tx_types[] = {DCT_DCT, IDTX};
+    const int stride = MAX_TX_SIZE;
+    DECLARE_ALIGNED(32, int16_t, input[MAX_TX_SQUARE]);
+    DECLARE_ALIGNED(32, int32_t, output_ref[MAX_TX_SQUARE]);
+    DECLARE_ALIGNED(32, int32_t, output_test[MAX_TX_SQUARE]);
+
+    for (int bd = AOM_BITS_8; bd <= AOM_BITS_10; bd += 2) {
+        SVTRandom rnd(-(1 << bd) + 1, (1 << bd) - 1);
+        for (int t = 0; t < 2; t++) {
+            for (int loop = 0; loop < 20; loop++) {
+                for (int i = 0; i < MAX_TX_SQUARE; i++)
+                    input[i] = (int16_t)rnd.random();
+
+                av1_fwd_txfm2d_32x32_avx2(input, output_ref, stride, tx_types[t], (uint8_t)bd);
+                av1_fwd_txfm2d_32x32_avx512(input, output_test, stride, tx_types[t], (uint8_t)bd);
+                ASSERT_EQ(0, memcmp(output_ref, output_test, 32 * 32 * sizeof(int32_t)))
+                    << "32x32 tx_type " << tx_types[t] << " bd " << bd;
+
+                av1_fwd_txfm2d_64x64_avx2(input, output_ref, stride, tx_types[t], (uint8_t)bd);
+                av1_fwd_txfm2d_64x64_avx512(input, output_test, stride, tx_types[t], (uint8_t)bd);
+                ASSERT_EQ(0, memcmp(output_ref, output_test, 64 * 64 * sizeof(int32_t)))
+                    << "64x64 tx_type " << tx_types[t] << " bd " << bd;
+            }
+        }
+    }
+}
+
+TEST(Avx512AsmTest, InvTxfm2dAdd32x32) {
+    SKIP_WITHOUT_AVX512();
+
+    const TxType tx_types[] = {DCT_DCT, IDTX};
+    DECLARE_ALIGNED(32, int16_t, residual[32 * 32]);
+    DECLARE_ALIGNED(32, int32_t, coeff[32 * 32]);
+    DECLARE_ALIGNED(32, uint16_t, output_ref[32 * 64]);
+    DECLARE_ALIGNED(32, uint16_t, output_test[32 * 64]);
+
+    for (int bd = AOM_BITS_8; bd <= AOM_BITS_10; bd += 2) {
+        SVTRandom rnd_pixel(0, (1 << bd) - 1);
+        SVTRandom rnd_residual(-(1 << bd) + 1, (1 << bd) - 1);
+        for (int t = 0; t < 2; t++) {
+            for (int loop = 0; loop < 20; loop++) {
+                for (int i = 0; i < 32 * 32; i++)
+                    residual[i] = (int16_t)rnd_residual.random();
+                av1_fwd_txfm2d_32x32_avx2(residual, coeff, 32, tx_types[t], (uint8_t)bd);
+
+                for (int i = 0; i < 32 * 64; i++)
+                    output_ref[i] = output_test[i] = (uint16_t)rnd_pixel.random();
+
+                av1_inv_txfm2d_add_32x32_avx2(coeff, output_ref, 64, tx_types[t], bd);
+                av1_inv_txfm2d_add_32x32_avx512(coeff, output_test, 64, tx_types[t], bd);
+                ASSERT_EQ(0, memcmp(output_ref, output_test, sizeof(output_ref)))
+                    << "tx_type " << tx_types[t] << " bd " << bd;
+            }
+        }
+    }
+}
+
+TEST(Avx512AsmTest, Convolve2dSr) {
+    SKIP_WITHOUT_AVX512();
+
+    const int src_stride = MAX_SB_SIZE + 16;
+    const int dst_stride = MAX_SB_SIZE;
+    const int block_sizes[] = {4, 8, 16, 32, 64, 128};
+    DECLARE_ALIGNED(32, uint8_t, src[(MAX_SB_SIZE + 16) * (MAX_SB_SIZE + 16)]);
+    DECLARE_ALIGNED(32, uint8_t, dst_ref[MAX_SB_SIZE * MAX_SB_SIZE]);
+    DECLARE_ALIGNED(32, uint8_t, dst_test[MAX_SB_SIZE * MAX_SB_SIZE]);
+    SVTRandom rnd(0, 255);
+
+    for (uint32_t i = 0; i < sizeof(src); i++)
+        src[i] = (uint8_t)rnd.random();
+    // Block origin leaves room for the filter taps
+    const uint8_t *const src_ptr = src + 3 * src_stride + 3;
+
+    for (int wi = 0; wi < 6; wi++) {
+        for (int hi = 0; hi < 6; hi++) {
+            const int w = block_sizes[wi];
+            const int h = block_sizes[hi];
+            if (w > 4 * h || h > 4 * w)
+                continue;
+            for (int filter = EIGHTTAP_REGULAR; filter < BILINEAR; filter++) {
+                InterpFilterParams filter_params_x =
+                    av1_get_interp_filter_params_with_block_size(
+                        (InterpFilter)filter, w);
+                InterpFilterParams filter_params_y =
+                    av1_get_interp_filter_params_with_block_size(
+                        (InterpFilter)filter, h);
+                for (int subpel_x = 1; subpel_x < 16; subpel_x += 5) {
+                    for (int subpel_y = 1; subpel_y < 16; subpel_y += 7) {
+                        ConvolveParams conv_params_ref =
+                            get_conv_params_no_round(0, 0, 0, NULL, 0, 0, 8);
+                        ConvolveParams conv_params_test =
+                            get_conv_params_no_round(0, 0, 0, NULL, 0, 0, 8);
+
+                        memset(dst_ref, 0, sizeof(dst_ref));
+                        memset(dst_test, 0, sizeof(dst_test));
+                        av1_convolve_2d_sr_avx2(
+                            src_ptr, src_stride, dst_ref, dst_stride, w, h,
+                            &filter_params_x, &filter_params_y, subpel_x,
+                            subpel_y, &conv_params_ref);
+                        av1_convolve_2d_sr_avx512(
+                            src_ptr, src_stride, dst_test, dst_stride, w, h,
+                            &filter_params_x, &filter_params_y, subpel_x,
+                            subpel_y, &conv_params_test);
+                        ASSERT_EQ(0, memcmp(dst_ref, dst_test, sizeof(dst_ref)))
+                            << "w " << w << " h " << h << " filter " << filter
+                            << " subpel " << subpel_x << " " << subpel_y;
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
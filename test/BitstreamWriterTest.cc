@@ -16,6 +16,8 @@
 #include <random>
 #include "BitstreamReaderMock.h"
 #include "EbCabacContextModel.h"
+#include "EbEntropyCodingObject.h"
+#include "EbMemoryArena.h"
 #include "gtest/gtest.h"
 #include "random.h"
 /**
@@ -87,7 +89,7 @@ class BitstreamWriterTest : public ::testing::Test {
                 aom_stop_encode(&bw);
 
                 // read out the bits and verify
-                aom_reader br;
+                aom_reader br = {0};
                 aom_reader_init(&br, bw_buffer, bw.pos);
                 for (int i = 0; i < total_bits; ++i) {
                     GTEST_ASSERT_EQ(aom_read(&br, probas[i], nullptr),
@@ -186,7 +188,7 @@ TEST(Entropy_BitstreamWriter, write_literal_extreme_int) {
     aom_write_literal(&bw, min_int, 32);
     aom_stop_encode(&bw);
 
-    aom_reader br;
+    aom_reader br = {0};
     aom_reader_init(&br, stream_buffer, bw.pos);
     EXPECT_EQ(aom_read_literal(&br, 32, nullptr), max_int)
         << "read max_int fail";
@@ -220,7 +222,7 @@ TEST(Entropy_BitstreamWriter, write_symbol_no_update) {
     rnd.reset();
     gen.seed(deterministic_seeds);
 
-    aom_reader br;
+    aom_reader br = {0};
     aom_reader_init(&br, stream_buffer, bw.pos);
     for (int i = 0; i < 500; ++i) {
         ASSERT_EQ(aom_read_symbol(&br, fc.txb_skip_cdf[0][0], 2, nullptr),
@@ -257,7 +259,7 @@ TEST(Entropy_BitstreamWriter, write_symbol_with_update) {
     rnd.reset();
     gen.seed(deterministic_seeds);
 
-    aom_reader br;
+    aom_reader br = {0};
     aom_reader_init(&br, stream_buffer, bw.pos);
     br.allow_update_cdf = 1;
     av1_default_coef_probs(&fc, base_qindex);  // reset cdf
@@ -268,4 +270,110 @@ TEST(Entropy_BitstreamWriter, write_symbol_with_update) {
                   rnd(gen));
     }
 }
+
+/**
+ * @brief Codes the symbols of one tile, from the default CDFs as every tile
+ * does. Tile tile_idx has 200 + 400 * tile_idx symbol pairs.
+ */
+static void write_tile_symbols(aom_writer *bw, int tile_idx) {
+    FRAME_CONTEXT fc = {0};
+    av1_default_coef_probs(&fc, 20);
+    std::bernoulli_distribution rnd(0.3);
+    std::mt19937 gen(deterministic_seeds + tile_idx);
+
+    bw->allow_update_cdf = 1;
+    for (int i = 0; i < 200 + 400 * tile_idx; ++i) {
+        aom_write_symbol(bw, rnd(gen), fc.txb_skip_cdf[0][0], 2);
+        aom_write_symbol(bw, rnd(gen), fc.txb_skip_cdf[1][0], 2);
+    }
+}
+
+/**
+ * @brief Tiles coded in reverse order into their slices of the picture
+ * entropy coder buffer, then stitched with copy_tile_bitstream, must give
+ * the bytes of the serial tile loop: the tiles in order, each but the last
+ * preceded by its size field. The slices hold 60 bytes of tile data, so the
+ * longer tiles go to the overflow buffers of the entropy coder, which are
+ * reused by a second picture.
+ */
+TEST(Entropy_BitstreamWriter, tile_slices_match_serial) {
+    const int tile_count = 5;
+    const int slice_size = 64;
+    const int buffer_size = 4096;
+
+    uint8_t serial[buffer_size];
+    uint32_t serial_size = 0;
+    for (int tile_idx = 0; tile_idx < tile_count; ++tile_idx) {
+        const bool size_field = tile_idx < tile_count - 1;
+        aom_writer bw = {0};
+        aom_start_encode(&bw,
+                         serial + serial_size +
+                             (size_field ? AV1_TILE_SIZE_BYTES : 0));
+        write_tile_symbols(&bw, tile_idx);
+        aom_stop_encode(&bw);
+        if (size_field) {
+            mem_put_le32(serial + serial_size,
+                         bw.pos - AV1_MIN_TILE_SIZE_BYTES);
+            serial_size += AV1_TILE_SIZE_BYTES;
+        }
+        serial_size += bw.pos;
+    }
+
+    // The picture entropy coder only needs its output buffer
+    uint8_t slices[slice_size * tile_count];
+    OutputBitstreamUnit_t output_bitstream = {0};
+    output_bitstream.bufferBeginAv1 = slices;
+    output_bitstream.size = sizeof(slices);
+    EntropyCoder_t entropy_coder = {0};
+    entropy_coder.ecOutputBitstreamPtr = &output_bitstream;
+
+    // The overflow buffers grow from the arena of the calling thread
+    EbMemoryArena *arena;
+    ASSERT_EQ(eb_memory_arena_ctor(&arena), EB_ErrorNone);
+    EbMemoryArena *saved_arena = eb_memory_arena_set_current(arena);
+    ASSERT_EQ(entropy_coder_tile_overflow_ctor(&entropy_coder, tile_count),
+              EB_ErrorNone);
+
+    for (int picture = 0; picture < 2; ++picture) {
+        memset(slices, 0, sizeof(slices));
+
+        int overflow_count = 0;
+        for (int tile_idx = tile_count - 1; tile_idx >= 0; --tile_idx) {
+            uint8_t *tile_buffer = get_tile_bitstream_buffer(
+                &entropy_coder, tile_count, tile_idx);
+            aom_writer bw = {0};
+            aom_start_encode(&bw, tile_buffer + AV1_TILE_SIZE_BYTES);
+            bw.buffer_size =
+                get_tile_bitstream_capacity(&entropy_coder, tile_count);
+            bw.overflow_ptr = &entropy_coder.tile_overflow_array[tile_idx];
+            write_tile_symbols(&bw, tile_idx);
+            aom_stop_encode(&bw);
+            overflow_count += bw.pos > bw.buffer_size;
+            set_tile_bitstream_size(tile_buffer, &bw);
+        }
+        EXPECT_GT(overflow_count, 0);
+        EXPECT_LT(overflow_count, tile_count);
+
+        uint8_t stitched[buffer_size];
+        uint32_t stitched_size = 0;
+        for (int tile_idx = 0; tile_idx < tile_count; ++tile_idx)
+            stitched_size +=
+                copy_tile_bitstream(&entropy_coder,
+                                    tile_count,
+                                    tile_idx,
+                                    (EbBool)(tile_idx < tile_count - 1),
+                                    stitched + stitched_size);
+
+        ASSERT_EQ(stitched_size, serial_size);
+        EXPECT_EQ(memcmp(stitched, serial, serial_size), 0);
+    }
+
+    // Only the tiles which did not fit their slice got a buffer
+    EXPECT_EQ(entropy_coder.tile_overflow_array[0].buffer, nullptr);
+    EXPECT_NE(entropy_coder.tile_overflow_array[tile_count - 1].buffer,
+              nullptr);
+
+    eb_memory_arena_set_current(saved_arena);
+    eb_memory_arena_dtor(arena);
+}
 }  // namespace
@@ -0,0 +1,266 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file CdefRowTest.cc
+ *
+ * @brief Unit test of the CDEF application by 64x64 filter block rows:
+ * - rows filtered in any order, on several threads, match the serial
+ *   filtering the encoder did before the rows were split (cdef_frame_ref)
+ * - the same holds for 10 bit pictures against the rows filtered in order
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbCdef.h"
+#include "EbEncDecSegments.h"
+#include "EbMemoryArena.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+#include "aom_dsp_rtcd.h"
+#include "CdefRef.h"
+#include "random.h"
+
+/* Defined in EbCdef.c */
+extern "C" void av1_cdef_save_boundary_lines(SequenceControlSet *scs,
+                                             PictureControlSet_t *pcs);
+extern "C" void av1_cdef_frame_row(SequenceControlSet *scs,
+                                   PictureControlSet_t *pcs, int32_t fbr);
+
+using svt_av1_test_reference::cdef_frame_ref;
+using svt_av1_test_tool::SVTRandom;
+
+namespace CdefRowTest {
+
+// 4 filter block rows and 5 columns, the last ones partial
+const int32_t width = 296;
+const int32_t height = 216;
+const int32_t border = 16;
+const int32_t thread_count = 4;
+
+/**
+ * @brief Each test gets a picture with random pixels, skip flags and CDEF
+ * strengths, allocated from its own memory arena.
+ */
+class CdefRowTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        setup_rtcd_flags(HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_AVX | HAS_AVX2);
+
+        memset(&scs_, 0, sizeof(scs_));
+        memset(&pcs_, 0, sizeof(pcs_));
+        memset(&ppcs_, 0, sizeof(ppcs_));
+        memset(&cm_, 0, sizeof(cm_));
+        memset(&recon_, 0, sizeof(recon_));
+        bytes_ = 1;
+
+        cm_.mi_rows = height >> MI_SIZE_LOG2;
+        cm_.mi_cols = width >> MI_SIZE_LOG2;
+        cm_.mi_stride = cm_.mi_cols;
+        ppcs_.av1_cm = &cm_;
+        ppcs_.is_used_as_reference_flag = EB_FALSE;
+        ppcs_.cdef_pri_damping = 5;
+        ppcs_.cdef_sec_damping = 5;
+        pcs_.parent_pcs_ptr = &ppcs_;
+        pcs_.mi_stride = cm_.mi_stride;
+
+        row_count_ = (cm_.mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+        ASSERT_EQ(SbRowSyncCtor(&pcs_.cdef_row_sync, row_count_),
+                  EB_ErrorNone);
+        for (int32_t pli = 0; pli < 3; pli++) {
+            line_buf_[pli].resize(row_count_ * 2 * CDEF_VBORDER * width);
+            pcs_.cdef_line_buf[pli] = line_buf_[pli].data();
+        }
+
+        make_mode_info();
+    }
+
+    void TearDown() override {
+        eb_memory_arena_dtor(arena_);
+    }
+
+    /** A strength index per 64x64 block and a skip flag per 4x4 block */
+    void make_mode_info() {
+        SVTRandom rnd_strength(0, CDEF_MAX_STRENGTHS - 1);
+        SVTRandom rnd_skip(0, 3);
+        const int32_t count = cm_.mi_rows * cm_.mi_cols;
+
+        for (int32_t i = 0; i < CDEF_MAX_STRENGTHS; i++) {
+            // Strength 0 leaves the blocks using it unfiltered
+            ppcs_.cdef_strengths[i] = i ? 4 * i - 1 : 0;
+            ppcs_.cdef_uv_strengths[i] = i ? 4 * (CDEF_MAX_STRENGTHS - i) : 0;
+        }
+        ppcs_.nb_cdef_strengths = CDEF_MAX_STRENGTHS;
+
+        mode_info_.resize(count);
+        mi_grid_.resize(count);
+        for (int32_t mi_row = 0; mi_row < cm_.mi_rows; mi_row++) {
+            for (int32_t mi_col = 0; mi_col < cm_.mi_cols; mi_col++) {
+                ModeInfo &mi = mode_info_[mi_row * cm_.mi_cols + mi_col];
+                memset(&mi, 0, sizeof(mi));
+                mi.mbmi.skip = rnd_skip.random() == 0;
+                mi_grid_[mi_row * cm_.mi_stride + mi_col] = &mi;
+            }
+        }
+        // The strength is read from the top left block of each 64x64 block
+        for (int32_t mi_row = 0; mi_row < cm_.mi_rows;
+             mi_row += MI_SIZE_64X64) {
+            for (int32_t mi_col = 0; mi_col < cm_.mi_cols;
+                 mi_col += MI_SIZE_64X64) {
+                mi_grid_[mi_row * cm_.mi_stride + mi_col]->mbmi.cdef_strength =
+                    (int8_t)rnd_strength.random();
+            }
+        }
+        pcs_.mi_grid_base = mi_grid_.data();
+    }
+
+    /** Random planes with a border, in bytes of 8 bit or 16 bit samples */
+    void make_recon(uint32_t bit_depth, std::vector<uint8_t> &buf) {
+        const size_t sample_count = luma_size() + 2 * (luma_size() >> 2);
+        SVTRandom rnd(0, (1 << bit_depth) - 1);
+
+        scs_.static_config.encoder_bit_depth = bit_depth;
+        bytes_ = bit_depth > 8 ? 2 : 1;
+        buf.resize(bytes_ * sample_count);
+        for (size_t i = 0; i < sample_count; i++) {
+            if (bytes_ == 2)
+                ((uint16_t *)buf.data())[i] = (uint16_t)rnd.random();
+            else
+                buf[i] = (uint8_t)rnd.random();
+        }
+    }
+
+    /** Points the recon of the picture at the planes in buf */
+    void set_recon(std::vector<uint8_t> &buf) {
+        const size_t chroma_size = luma_size() >> 2;
+
+        recon_.buffer_y = buf.data();
+        recon_.bufferCb = buf.data() + bytes_ * luma_size();
+        recon_.bufferCr = buf.data() + bytes_ * (luma_size() + chroma_size);
+        recon_.stride_y = width + 2 * border;
+        recon_.strideCb = recon_.stride_y >> 1;
+        recon_.strideCr = recon_.stride_y >> 1;
+        recon_.origin_x = border;
+        recon_.origin_y = border;
+        recon_.width = width;
+        recon_.height = height;
+        pcs_.recon_picture_ptr = &recon_;
+        pcs_.recon_picture16bit_ptr = &recon_;
+    }
+
+    static size_t luma_size() {
+        return (size_t)(width + 2 * border) * (height + 2 * border);
+    }
+
+    /** Filters the rows claimed from the row sync on several threads, as the
+     * CDEF threads do once the strengths are picked */
+    void filter_rows_in_parallel() {
+        SbRowSync_t *row_sync = pcs_.cdef_row_sync;
+        std::vector<std::thread> threads;
+
+        av1_cdef_save_boundary_lines(&scs_, &pcs_);
+        SbRowSyncInit(row_sync,
+                      row_count_,
+                      (cm_.mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64);
+        row_sync->readyRowCount = row_count_;
+
+        for (int32_t i = 0; i < thread_count; i++) {
+            threads.push_back(std::thread([this, row_sync]() {
+                uint32_t fbr;
+                while (SbRowSyncClaimRow(row_sync, &fbr) == EB_TRUE) {
+                    av1_cdef_frame_row(&scs_, &pcs_, (int32_t)fbr);
+                    SbRowSyncCompleteRow(row_sync);
+                }
+            }));
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+        EXPECT_EQ(row_sync->doneRowCount, (uint32_t)row_count_);
+    }
+
+    /** Filters the rows on the calling thread, from the top down as
+     * av1_cdef_frame does or from the bottom up */
+    void filter_rows_serial(bool bottom_up) {
+        av1_cdef_save_boundary_lines(&scs_, &pcs_);
+        for (int32_t i = 0; i < row_count_; i++) {
+            av1_cdef_frame_row(
+                &scs_, &pcs_, bottom_up ? row_count_ - 1 - i : i);
+        }
+    }
+
+    EbMemoryArena *arena_;
+    SequenceControlSet scs_;
+    PictureControlSet_t pcs_;
+    PictureParentControlSet_t ppcs_;
+    Av1Common cm_;
+    EbPictureBufferDesc_t recon_;
+    std::vector<ModeInfo> mode_info_;
+    std::vector<ModeInfo *> mi_grid_;
+    std::vector<uint16_t> line_buf_[3];
+    int32_t row_count_;
+    uint32_t bytes_;
+};
+
+/**
+ * @brief The rows of an 8 bit picture filtered on several threads, or from
+ * the bottom up, match the serial filtering of the whole picture.
+ */
+TEST_F(CdefRowTest, rows_match_serial_reference) {
+    std::vector<uint8_t> input, ref, tst;
+
+    make_recon(8, input);
+    ref = input;
+    set_recon(ref);
+    cdef_frame_ref(&scs_, &pcs_);
+    ASSERT_FALSE(ref == input) << "no block filtered";
+
+    tst = input;
+    set_recon(tst);
+    filter_rows_in_parallel();
+    EXPECT_TRUE(ref == tst) << "rows filtered in parallel";
+
+    tst = input;
+    set_recon(tst);
+    filter_rows_serial(true);
+    EXPECT_TRUE(ref == tst) << "rows filtered bottom up";
+}
+
+/**
+ * @brief The rows of a 10 bit picture filtered on several threads match the
+ * rows filtered in order.
+ */
+TEST_F(CdefRowTest, rows_match_serial_10bit) {
+    std::vector<uint8_t> input, ref, tst;
+
+    make_recon(10, input);
+    ref = input;
+    set_recon(ref);
+    filter_rows_serial(false);
+    ASSERT_FALSE(ref == input) << "no block filtered";
+
+    tst = input;
+    set_recon(tst);
+    filter_rows_in_parallel();
+    EXPECT_TRUE(ref == tst);
+}
+
+}  // namespace CdefRowTest
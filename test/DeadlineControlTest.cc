@@ -0,0 +1,167 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file DeadlineControlTest.cc
+ *
+ * @brief Unit test of the effort level changes of EbDeadlineControl:
+ * - escalation when the output is late or the cores are overloaded
+ * - back-off once the output is on time with spare cores
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDeadlineControl.h"
+#include "EbMemoryArena.h"
+
+namespace DeadlineControlTest {
+
+// 1000 fps on one core: the picture budget, and the core budget, are 1 ms
+const uint32_t frame_rate = 1000;
+const uint64_t budget_us = 1000;
+
+/**
+ * @brief Each test gets a deadline control allocated from its own memory
+ * arena. The first picture, output on time, anchors the timeline at the
+ * current time.
+ */
+class DeadlineControlTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        ASSERT_EQ(eb_deadline_control_ctor(&control_, frame_rate, 1),
+                  EB_ErrorNone);
+        picture_number_ = 0;
+    }
+
+    void TearDown() override {
+        eb_memory_arena_dtor(arena_);
+    }
+
+    // Starts and outputs the next picture, in decode order
+    uint8_t output_picture(uint64_t decode_order, uint64_t arrival_time_us,
+                           uint64_t work_us) {
+        uint8_t effort_level =
+            eb_deadline_control_start_picture(control_, picture_number_);
+        eb_deadline_control_output_picture(control_,
+                                           picture_number_,
+                                           decode_order,
+                                           arrival_time_us,
+                                           work_us);
+        ++picture_number_;
+        return effort_level;
+    }
+
+    // Arrival time of a picture output well before it is due
+    static uint64_t early_arrival_us() {
+        return eb_get_time_stamp_us() + 1000 * budget_us;
+    }
+
+    EbMemoryArena *arena_;
+    EbDeadlineControl *control_;
+    uint64_t picture_number_;
+};
+
+TEST_F(DeadlineControlTest, rejects_zero_frame_rate) {
+    EbDeadlineControl *control = nullptr;
+
+    EXPECT_EQ(eb_deadline_control_ctor(&control, 0, 1), EB_ErrorBadParameter);
+    EXPECT_EQ(control, nullptr);
+}
+
+TEST_F(DeadlineControlTest, first_picture_anchors_the_timeline) {
+    EXPECT_EQ(eb_deadline_control_get_deadline(control_, 0, 0), 0u);
+
+    output_picture(0, eb_get_time_stamp_us(), 0);
+
+    EXPECT_NE(eb_deadline_control_get_deadline(control_, 1, 0), 0u);
+    EXPECT_EQ(eb_atomic_load_32(&control_->effort_level), 0);
+}
+
+/**
+ * @brief Work above the core budget raises the effort level once, then the
+ * level holds until the pictures started with it are output.
+ */
+TEST_F(DeadlineControlTest, escalates_on_overloaded_cores) {
+    output_picture(0, early_arrival_us(), 0);
+
+    // The average moves by 1/8 of the new work: 16 budgets give 200%
+    output_picture(1, early_arrival_us(), 16 * budget_us);
+    EXPECT_EQ(eb_atomic_load_32(&control_->effort_level), 1);
+    EXPECT_EQ(control_->change_picture_number, 1u);
+
+    // The next pictures started at level 1 raise it again
+    output_picture(2, early_arrival_us(), 16 * budget_us);
+    EXPECT_EQ(eb_atomic_load_32(&control_->effort_level), 2);
+}
+
+/**
+ * @brief A picture output more than the tolerance after it was due raises
+ * the effort level, even with idle cores.
+ */
+TEST_F(DeadlineControlTest, escalates_on_late_output) {
+    // Anchored so that decode order 1 was due 99 budgets ago
+    output_picture(100, eb_get_time_stamp_us(), 0);
+
+    output_picture(1, 0, 0);
+    EXPECT_EQ(eb_atomic_load_32(&control_->effort_level), 1);
+    EXPECT_GT(control_->change_lateness_us,
+              (int64_t)(budget_us * DEADLINE_TOLERANCE_PICTURES));
+}
+
+/**
+ * @brief Once on time with the cores below the low utilization, the effort
+ * level comes back down one level at a time, to 0 and no further. The
+ * level keeps rising while the average work decays below the core budget.
+ */
+TEST_F(DeadlineControlTest, backs_off_when_on_time) {
+    uint32_t picture_index;
+    int32_t previous_level;
+    bool backing_off = false;
+
+    output_picture(0, early_arrival_us(), 0);
+    for (picture_index = 1; picture_index < 4; ++picture_index)
+        output_picture(picture_index, early_arrival_us(), 16 * budget_us);
+    previous_level = eb_atomic_load_32(&control_->effort_level);
+    ASSERT_EQ(previous_level, 3);
+
+    for (; picture_index < 64; ++picture_index) {
+        output_picture(picture_index, early_arrival_us(), 0);
+
+        int32_t level = eb_atomic_load_32(&control_->effort_level);
+        EXPECT_GE(level, previous_level - 1);
+        if (level < previous_level)
+            backing_off = true;
+        if (backing_off)
+            EXPECT_LE(level, previous_level);
+        previous_level = level;
+    }
+    EXPECT_TRUE(backing_off);
+    EXPECT_EQ(previous_level, 0);
+}
+
+/**
+ * @brief Effort levels past the table are clamped to the lowest effort.
+ */
+TEST_F(DeadlineControlTest, clamps_effort_settings) {
+    EXPECT_EQ(eb_deadline_control_get_effort(DEADLINE_EFFORT_LEVEL_COUNT + 3),
+              eb_deadline_control_get_effort(DEADLINE_EFFORT_LEVEL_COUNT - 1));
+    EXPECT_EQ(eb_deadline_control_get_effort(0)->nsq_max_shapes, 6);
+}
+
+}  // namespace DeadlineControlTest
@@ -0,0 +1,290 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file DlfSearchTest.cc
+ *
+ * @brief Unit test of the deblocking filter level search split by SB rows:
+ * - the levels picked from the full image and from the sampled SB rows
+ *   (LPF_PICK_FROM_SUBIMAGE, used by loop_filter_mode 2) on a fixed
+ *   picture, so a change of the picked levels shows up here
+ * - the levels do not depend on the DLF threads joining the search
+ * - the recon is left as it was before the search
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDeblockingFilter.h"
+#include "EbDlfProcess.h"
+#include "EbEncDecSegments.h"
+#include "EbMemoryArena.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+#include "EbThreads.h"
+#include "aom_dsp_rtcd.h"
+
+namespace DlfSearchTest {
+
+// 4 SB columns and 5 SB rows, the last one partial
+const uint32_t width = 256;
+const uint32_t height = 296;
+const uint32_t border = 32;
+const uint32_t sb_size = 64;
+const int32_t thread_count = 4;
+
+/** Picked levels: luma vertical, luma horizontal, Cb, Cr */
+struct FilterLevels {
+    int32_t level[4];
+
+    bool operator==(const FilterLevels &other) const {
+        return memcmp(level, other.level, sizeof(level)) == 0;
+    }
+};
+
+static std::ostream &operator<<(std::ostream &os, const FilterLevels &l) {
+    return os << "{" << l.level[0] << ", " << l.level[1] << ", "
+              << l.level[2] << ", " << l.level[3] << "}";
+}
+
+/**
+ * @brief Each test gets a smooth source and a recon of 16x16 transform
+ * blocks, each off the source by its own offset plus some noise, allocated
+ * from its own memory arena. The pixels come from a fixed linear
+ * congruential generator so the picked levels are the same on every
+ * platform.
+ */
+class DlfSearchTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        setup_rtcd_flags(HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_AVX | HAS_AVX2);
+
+        memset(&scs_, 0, sizeof(scs_));
+        memset(&pcs_, 0, sizeof(pcs_));
+        memset(&ppcs_, 0, sizeof(ppcs_));
+        memset(&scs_wrapper_, 0, sizeof(scs_wrapper_));
+        memset(&context_, 0, sizeof(context_));
+        seed_ = 1;
+
+        scs_.static_config.encoder_bit_depth = 8;
+        scs_.luma_width = width;
+        scs_.luma_height = height;
+        scs_.chroma_width = width >> 1;
+        scs_.chroma_height = height >> 1;
+        scs_.sb_size = BLOCK_64X64;
+        scs_.sb_size_pix = sb_size;
+        scs_.picture_width_in_sb = (uint8_t)(width / sb_size);
+        scs_wrapper_.object_ptr = &scs_;
+
+        ppcs_.sequence_control_set_ptr = &scs_;
+        ppcs_.sequence_control_set_wrapper_ptr = &scs_wrapper_;
+        ppcs_.is_used_as_reference_flag = EB_FALSE;
+        ppcs_.av1FrameType = KEY_FRAME;
+        ppcs_.tx_mode = TX_MODE_SELECT;
+        ppcs_.base_qindex = 160;
+        pcs_.parent_pcs_ptr = &ppcs_;
+
+        row_count_ = (height + sb_size - 1) / sb_size;
+        ASSERT_EQ(SbRowSyncCtor(&pcs_.dlf_search_row_sync, row_count_),
+                  EB_ErrorNone);
+        row_sse_.resize(row_count_);
+        pcs_.dlf_search_row_sse = row_sse_.data();
+
+        make_mode_info();
+        make_pictures();
+    }
+
+    void TearDown() override {
+        eb_memory_arena_dtor(arena_);
+    }
+
+    uint32_t next_random(uint32_t range) {
+        seed_ = seed_ * 1103515245 + 12345;
+        return (seed_ >> 16) % range;
+    }
+
+    /** Intra 16x16 blocks with 16x16 transforms, none skipped */
+    void make_mode_info() {
+        const uint32_t mi_stride = scs_.picture_width_in_sb * (sb_size >> MI_SIZE_LOG2);
+        const uint32_t mi_rows = row_count_ * (sb_size >> MI_SIZE_LOG2);
+
+        mode_info_.resize(mi_stride * mi_rows);
+        mi_grid_.resize(mi_stride * mi_rows);
+        for (uint32_t i = 0; i < mi_stride * mi_rows; i++) {
+            ModeInfo &mi = mode_info_[i];
+            memset(&mi, 0, sizeof(mi));
+            mi.mbmi.sb_type = BLOCK_16X16;
+            mi.mbmi.tx_size = TX_16X16;
+            mi.mbmi.mode = DC_PRED;
+            mi.mbmi.ref_frame[0] = INTRA_FRAME;
+            mi_grid_[i] = &mi;
+        }
+        pcs_.mi_grid_base = mi_grid_.data();
+    }
+
+    static void set_planes(EbPictureBufferDesc_t &pic,
+                           std::vector<uint8_t> &buf) {
+        const uint32_t stride = width + 2 * border;
+        const size_t luma_size = (size_t)stride * (height + 2 * border);
+
+        buf.resize(luma_size + 2 * (luma_size >> 2));
+        memset(&pic, 0, sizeof(pic));
+        pic.buffer_y = buf.data();
+        pic.bufferCb = buf.data() + luma_size;
+        pic.bufferCr = buf.data() + luma_size + (luma_size >> 2);
+        pic.stride_y = (uint16_t)stride;
+        pic.strideCb = (uint16_t)(stride >> 1);
+        pic.strideCr = (uint16_t)(stride >> 1);
+        pic.origin_x = (uint16_t)border;
+        pic.origin_y = (uint16_t)border;
+        pic.width = (uint16_t)width;
+        pic.height = (uint16_t)height;
+        pic.bit_depth = EB_8BIT;
+    }
+
+    void make_plane(const EbPictureBufferDesc_t &pic, uint8_t *src_buf,
+                    uint8_t *rec_buf, uint16_t stride, uint32_t w,
+                    uint32_t h, uint32_t ss, uint32_t max_offset) {
+        const uint32_t block = 16 >> ss;
+        const uint32_t blocks_wide = (w + block - 1) / block;
+        const size_t origin = (pic.origin_x >> ss) + (pic.origin_y >> ss) * stride;
+        std::vector<int32_t> offsets(blocks_wide * ((h + block - 1) / block));
+
+        for (size_t i = 0; i < offsets.size(); i++)
+            offsets[i] = (int32_t)next_random(2 * max_offset + 1) - (int32_t)max_offset;
+
+        for (uint32_t y = 0; y < h; y++) {
+            for (uint32_t x = 0; x < w; x++) {
+                const int32_t s = 40 + (int32_t)((x << ss) + 2 * (y << ss)) / 4;
+                const int32_t r = s + offsets[(y / block) * blocks_wide + x / block] +
+                    (int32_t)next_random(3) - 1;
+                src_buf[origin + y * stride + x] = (uint8_t)s;
+                rec_buf[origin + y * stride + x] = (uint8_t)CLIP3(0, 255, r);
+            }
+        }
+    }
+
+    void make_pictures() {
+        set_planes(source_, source_buf_);
+        set_planes(recon_, recon_buf_);
+        set_planes(backup_, backup_buf_);
+
+        make_plane(recon_, source_.buffer_y, recon_.buffer_y,
+                   recon_.stride_y, width, height, 0, 6);
+        make_plane(recon_, source_.bufferCb, recon_.bufferCb,
+                   recon_.strideCb, width >> 1, height >> 1, 1, 4);
+        make_plane(recon_, source_.bufferCr, recon_.bufferCr,
+                   recon_.strideCr, width >> 1, height >> 1, 1, 2);
+
+        ppcs_.enhanced_picture_ptr = &source_;
+        pcs_.recon_picture_ptr = &recon_;
+        context_.temp_lf_recon_picture_ptr = &backup_;
+    }
+
+    /** Picks the levels as DlfPickFilterLevel does, with the given number
+     * of threads joining the search */
+    FilterLevels pick_levels(uint8_t loop_filter_mode, int32_t helpers) {
+        struct loopfilter *lf = &ppcs_.lf;
+        std::vector<std::thread> threads;
+        FilterLevels levels;
+
+        memset(lf, 0, sizeof(*lf));
+        ppcs_.loop_filter_mode = loop_filter_mode;
+
+        eb_atomic_store_32(&pcs_.dlf_search_active, 1);
+        for (int32_t i = 0; i < helpers; i++) {
+            threads.push_back(std::thread([this]() {
+                av1_pick_filter_level_join(&pcs_);
+            }));
+        }
+
+        av1_loop_filter_init(&pcs_);
+        if (loop_filter_mode == 2)
+            av1_pick_filter_level(&context_, &source_, &pcs_, LPF_PICK_FROM_Q);
+        av1_pick_filter_level(
+            &context_,
+            &source_,
+            &pcs_,
+            loop_filter_mode == 2 ? LPF_PICK_FROM_SUBIMAGE : LPF_PICK_FROM_FULL_IMAGE);
+
+        eb_atomic_store_32(&pcs_.dlf_search_active, 0);
+        for (std::thread &thread : threads)
+            thread.join();
+
+        levels.level[0] = lf->filter_level[0];
+        levels.level[1] = lf->filter_level[1];
+        levels.level[2] = lf->filter_level_u;
+        levels.level[3] = lf->filter_level_v;
+        return levels;
+    }
+
+    EbMemoryArena *arena_;
+    SequenceControlSet scs_;
+    PictureControlSet_t pcs_;
+    PictureParentControlSet_t ppcs_;
+    EbObjectWrapper scs_wrapper_;
+    DlfContext_t context_;
+    EbPictureBufferDesc_t source_;
+    EbPictureBufferDesc_t recon_;
+    EbPictureBufferDesc_t backup_;
+    std::vector<uint8_t> source_buf_;
+    std::vector<uint8_t> recon_buf_;
+    std::vector<uint8_t> backup_buf_;
+    std::vector<ModeInfo> mode_info_;
+    std::vector<ModeInfo *> mi_grid_;
+    std::vector<uint64_t> row_sse_;
+    uint32_t row_count_;
+    uint32_t seed_;
+};
+
+/**
+ * @brief The levels searched on the full image (loop_filter_mode 3 and up)
+ * and on the sampled SB rows (loop_filter_mode 2), with and without the DLF
+ * threads joining, match the levels recorded for this picture. The search
+ * leaves the recon as it found it.
+ */
+TEST_F(DlfSearchTest, picked_levels_match_recorded) {
+    const FilterLevels full_ref = {{16, 16, 8, 6}};
+    const FilterLevels sub_ref = {{10, 10, 8, 6}};
+    const std::vector<uint8_t> recon = recon_buf_;
+
+    EXPECT_EQ(pick_levels(3, 0), full_ref);
+    EXPECT_EQ(pick_levels(3, thread_count - 1), full_ref);
+    EXPECT_EQ(pick_levels(2, 0), sub_ref);
+    EXPECT_EQ(pick_levels(2, thread_count - 1), sub_ref);
+    EXPECT_TRUE(recon_buf_ == recon) << "recon changed by the search";
+}
+
+/**
+ * @brief Threads joining the search in any number pick the levels of the
+ * search run alone, over several searches of the same picture.
+ */
+TEST_F(DlfSearchTest, joined_threads_match_single_thread) {
+    for (uint8_t mode = 2; mode <= 3; mode++) {
+        const FilterLevels ref = pick_levels(mode, 0);
+
+        for (int32_t run = 0; run < 10; run++)
+            ASSERT_EQ(pick_levels(mode, 1 + run % thread_count), ref)
+                << "loop_filter_mode " << (int32_t)mode << " run " << run;
+    }
+}
+
+}  // namespace DlfSearchTest
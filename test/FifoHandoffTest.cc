@@ -0,0 +1,448 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file FifoHandoffTest.cc
+ *
+ * @brief Unit test and micro-benchmark for the inter-process FIFOs:
+ * - EbRingQueue (lock-free ring buffer)
+ * - EbSystemResource empty/full object handoff
+ * - EbTaskScheduler work-stealing pool
+ *
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "EbMemoryArena.h"
+#include "EbRingQueue.h"
+#include "EbSystemResourceManager.h"
+#include "EbTaskScheduler.h"
+
+namespace FifoHandoffTest {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief The library allocation macros allocate from the memory arena of
+ * the calling thread, so each test gets its own arena, released like
+ * eb_deinit_encoder does.
+ */
+class FifoHandoffTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+    }
+
+    void TearDown() override {
+        eb_memory_arena_dtor(arena_);
+    }
+
+    EbMemoryArena *arena_;
+};
+
+/**
+ * @brief Reference handoff with the same primitives as EbFifo before
+ * LOCK_FREE_FIFO: a counting semaphore plus a mutex protected list.
+ */
+struct MutexQueue {
+    EbHandle semaphore;
+    EbHandle mutex;
+    std::vector<EbPtr> items;
+    size_t head;
+};
+
+static EbErrorType mutex_queue_ctor(MutexQueue *q, uint32_t capacity) {
+    EB_CREATESEMAPHORE(
+        EbHandle, q->semaphore, sizeof(EbHandle), EB_SEMAPHORE, 0, capacity);
+    EB_CREATEMUTEX(EbHandle, q->mutex, sizeof(EbHandle), EB_MUTEX);
+    q->head = 0;
+    return EB_ErrorNone;
+}
+
+static void mutex_queue_push(MutexQueue *q, EbPtr object) {
+    eb_block_on_mutex(q->mutex);
+    q->items.push_back(object);
+    eb_release_mutex(q->mutex);
+    eb_post_semaphore(q->semaphore);
+}
+
+static EbPtr mutex_queue_pop(MutexQueue *q) {
+    eb_block_on_semaphore(q->semaphore);
+    eb_block_on_mutex(q->mutex);
+    EbPtr object = q->items[q->head++];
+    eb_release_mutex(q->mutex);
+    return object;
+}
+
+/**
+ * @brief Each of the producers pushes a disjoint range of tokens and the
+ * consumers must receive every token exactly once.
+ */
+static void run_ring_queue_mpmc(uint32_t producers, uint32_t consumers) {
+    const uint32_t per_producer = 20000;
+    const uint32_t total = per_producer * producers;
+    EbRingQueue *queue = nullptr;
+    ASSERT_EQ(eb_ring_queue_ctor(&queue, 64, consumers == 1 ? EB_TRUE : EB_FALSE),
+              EB_ErrorNone);
+
+    std::vector<std::atomic<uint32_t>> seen(total);
+    for (auto &s : seen)
+        s = 0;
+    std::atomic<uint32_t> in_flight(0);
+    std::vector<std::thread> threads;
+
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (uint32_t i = 0; i < per_producer; ++i) {
+                // Keep within the ring capacity like the resource pools do
+                while (in_flight.fetch_add(1) >= 64) {
+                    in_flight.fetch_sub(1);
+                    std::this_thread::yield();
+                }
+                uintptr_t token = (uintptr_t)(p * per_producer + i) + 1;
+                eb_ring_queue_push(queue, (EbPtr)token);
+            }
+        });
+    }
+    for (uint32_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c]() {
+            for (uint32_t i = c; i < total; i += consumers) {
+                EbPtr object;
+                eb_ring_queue_pop(queue, &object);
+                in_flight.fetch_sub(1);
+                seen[(uintptr_t)object - 1].fetch_add(1);
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    for (uint32_t i = 0; i < total; ++i)
+        ASSERT_EQ(seen[i].load(), 1u) << "token " << i;
+
+    EbPtr object;
+    eb_ring_queue_try_pop(queue, &object);
+    EXPECT_EQ(object, nullptr);
+}
+
+TEST_F(FifoHandoffTest, ring_queue_spsc) {
+    run_ring_queue_mpmc(1, 1);
+}
+
+TEST_F(FifoHandoffTest, ring_queue_mpmc) {
+    run_ring_queue_mpmc(4, 3);
+}
+
+/**
+ * @brief Runs a producer -> consumer pipeline through an EbSystemResource:
+ * the producer gets empty objects and posts them full, the consumers get
+ * the full objects and release them. Every object must come back to the
+ * empty queue.
+ */
+TEST_F(FifoHandoffTest, system_resource_pipeline) {
+    const uint32_t object_count = 8;
+    const uint32_t consumer_count = 3;
+    const uint32_t pictures = 30000;
+    EbSystemResource *resource = nullptr;
+    EbFifo **producer_fifos = nullptr;
+    EbFifo **consumer_fifos = nullptr;
+
+    ASSERT_EQ(eb_system_resource_ctor(&resource,
+                                      object_count,
+                                      1,
+                                      consumer_count,
+                                      &producer_fifos,
+                                      &consumer_fifos,
+                                      EB_TRUE,
+                                      nullptr,
+                                      nullptr),
+              EB_ErrorNone);
+
+    std::atomic<uint32_t> consumed(0);
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        for (uint32_t i = 0; i < pictures + consumer_count; ++i) {
+            EbObjectWrapper *wrapper;
+            eb_get_empty_object(producer_fifos[0], &wrapper);
+            // The trailing objects tell the consumers to stop
+            wrapper->object_ptr = (EbPtr)(uintptr_t)(i < pictures);
+            eb_post_full_object(wrapper);
+        }
+    });
+    for (uint32_t c = 0; c < consumer_count; ++c) {
+        threads.emplace_back([&, c]() {
+            for (;;) {
+                EbObjectWrapper *wrapper;
+                eb_get_full_object(consumer_fifos[c], &wrapper);
+                const bool stop = wrapper->object_ptr == nullptr;
+                eb_release_object(wrapper);
+                if (stop)
+                    break;
+                consumed.fetch_add(1);
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    EXPECT_EQ(consumed.load(), pictures);
+
+    // All objects are back in the empty queue
+    for (uint32_t i = 0; i < object_count; ++i) {
+        EbObjectWrapper *wrapper;
+        eb_get_empty_object(producer_fifos[0], &wrapper);
+        EXPECT_EQ(wrapper->live_count, 0u);
+    }
+}
+
+/**
+ * @brief The release callback of a resource, which hands the input frames
+ * back to the application, runs once per object, when the last of the
+ * consumers sharing it releases it.
+ */
+static std::atomic<uint32_t> released_count;
+
+static void count_release(EbObjectWrapper *wrapper) {
+    EXPECT_EQ(wrapper->object_ptr, (EbPtr)&released_count);
+    released_count.fetch_add(1);
+}
+
+TEST_F(FifoHandoffTest, release_callback_on_last_release) {
+    const uint32_t consumer_count = 3;
+    EbSystemResource *resource = nullptr;
+    EbFifo **producer_fifos = nullptr;
+    EbFifo **consumer_fifos = nullptr;
+    EbObjectWrapper *wrapper;
+
+    ASSERT_EQ(eb_system_resource_ctor(&resource,
+                                      2,
+                                      1,
+                                      1,
+                                      &producer_fifos,
+                                      &consumer_fifos,
+                                      EB_TRUE,
+                                      nullptr,
+                                      nullptr),
+              EB_ErrorNone);
+    eb_system_resource_set_release_callback(resource, count_release);
+    released_count = 0;
+
+    eb_get_empty_object(producer_fifos[0], &wrapper);
+    wrapper->object_ptr = (EbPtr)&released_count;
+    eb_post_full_object(wrapper);
+
+    // Each of the consumers holds a live reference to the object
+    eb_get_full_object(consumer_fifos[0], &wrapper);
+    eb_object_inc_live_count(wrapper, consumer_count);
+    std::vector<std::thread> threads;
+    for (uint32_t c = 0; c < consumer_count; ++c)
+        threads.emplace_back([wrapper]() { eb_release_object(wrapper); });
+    for (auto &t : threads)
+        t.join();
+
+    EXPECT_EQ(released_count.load(), 1u);
+    EXPECT_EQ(wrapper->live_count, (uint32_t)EB_ObjectWrapperReleasedValue);
+}
+
+/**
+ * @brief Two stages on a work-stealing pool. Stage A forwards each object
+ * through a pool of two objects to stage B, so its tasks wait for empty
+ * objects and run stage B tasks nested. Every object must reach stage B,
+ * which fails by timeout if a worker holding a claim never finds its task.
+ */
+struct ForwardContext {
+    EbFifo *output_fifo;
+};
+
+static std::atomic<uint32_t> forwarded_count;
+
+static void forward_kernel(void *context_ptr, EbObjectWrapper *input) {
+    ForwardContext *context = (ForwardContext *)context_ptr;
+    EbObjectWrapper *output;
+    eb_get_empty_object(context->output_fifo, &output);
+    output->object_ptr = input->object_ptr;
+    eb_release_object(input);
+    eb_post_full_object(output);
+}
+
+static void count_kernel(void *, EbObjectWrapper *input) {
+    eb_release_object(input);
+    forwarded_count.fetch_add(1);
+}
+
+TEST_F(FifoHandoffTest, task_scheduler_work_stealing) {
+    const uint32_t pictures = 20000;
+    const uint32_t forward_count = 3;
+    const uint32_t sink_count = 2;
+    EbSystemResource *input_resource, *forward_resource;
+    EbFifo **producer_fifos, **forward_input_fifos;
+    EbFifo **forward_output_fifos, **sink_input_fifos;
+
+    ASSERT_EQ(eb_system_resource_ctor(&input_resource, 8, 1, forward_count,
+                                      &producer_fifos, &forward_input_fifos,
+                                      EB_TRUE, nullptr, nullptr),
+              EB_ErrorNone);
+    ASSERT_EQ(eb_system_resource_ctor(&forward_resource, 2, forward_count,
+                                      sink_count, &forward_output_fifos,
+                                      &sink_input_fifos, EB_TRUE, nullptr,
+                                      nullptr),
+              EB_ErrorNone);
+
+    EbTaskScheduler *scheduler;
+    ASSERT_EQ(eb_task_scheduler_ctor(
+                  &scheduler, TASK_SCHEDULER_WORK_STEALING, 4, 8 + 2),
+              EB_ErrorNone);
+
+    ForwardContext forward_contexts[forward_count];
+    EbPtr forward_context_ptrs[forward_count];
+    for (uint32_t i = 0; i < forward_count; ++i) {
+        forward_contexts[i].output_fifo = forward_output_fifos[i];
+        forward_context_ptrs[i] = &forward_contexts[i];
+    }
+    EbPtr sink_context_ptrs[sink_count] = {nullptr, nullptr};
+    ASSERT_EQ(eb_task_scheduler_add_stage(scheduler, "forward",
+                                          forward_kernel,
+                                          forward_context_ptrs,
+                                          forward_input_fifos,
+                                          forward_count),
+              EB_ErrorNone);
+    ASSERT_EQ(eb_task_scheduler_add_stage(scheduler, "sink", count_kernel,
+                                          sink_context_ptrs,
+                                          sink_input_fifos, sink_count),
+              EB_ErrorNone);
+
+    forwarded_count = 0;
+    ASSERT_EQ(eb_task_scheduler_start(scheduler), EB_ErrorNone);
+
+    for (uint32_t i = 0; i < pictures; ++i) {
+        EbObjectWrapper *wrapper;
+        eb_get_empty_object(producer_fifos[0], &wrapper);
+        wrapper->object_ptr = (EbPtr)(uintptr_t)i;
+        eb_post_full_object(wrapper);
+    }
+
+    const Clock::time_point deadline = Clock::now() + std::chrono::seconds(30);
+    while (forwarded_count.load() < pictures && Clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(forwarded_count.load(), pictures);
+}
+
+/**
+ * @brief Micro-benchmark of the stage-to-stage handoff. Reports the
+ * round-trip latency of a ping-pong between two threads and the throughput
+ * of a streaming producer/consumer pair, for the semaphore + mutex reference
+ * and for EbRingQueue. Run with --gtest_also_run_disabled_tests.
+ */
+template <typename Push, typename Pop>
+static void measure_handoff(const char *name, Push push_fn, Pop pop_fn) {
+    const uint32_t round_trips = 200000;
+    EbPtr token = (EbPtr)(uintptr_t)1;
+
+    // Latency: 0 -> 1 -> 0
+    Clock::time_point start = Clock::now();
+    std::thread echo([&]() {
+        for (uint32_t i = 0; i < round_trips; ++i)
+            push_fn(1, pop_fn(0));
+    });
+    for (uint32_t i = 0; i < round_trips; ++i) {
+        push_fn(0, token);
+        pop_fn(1);
+    }
+    echo.join();
+    const double latency_ns =
+        std::chrono::duration<double, std::nano>(Clock::now() - start)
+            .count() /
+        round_trips;
+
+    // Throughput: queue 0 streams objects, queue 1 returns them (pool of 32)
+    start = Clock::now();
+    std::thread sink([&]() {
+        for (uint32_t i = 0; i < round_trips; ++i)
+            push_fn(1, pop_fn(0));
+    });
+    for (uint32_t i = 0; i < 32; ++i)
+        push_fn(1, token);
+    for (uint32_t i = 0; i < round_trips; ++i)
+        push_fn(0, pop_fn(1));
+    sink.join();
+    for (uint32_t i = 0; i < 32; ++i)
+        pop_fn(1);
+    const double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    printf("%-24s latency %8.1f ns/round-trip, throughput %8.2f Mobjects/s\n",
+           name,
+           latency_ns,
+           round_trips / seconds / 1e6);
+}
+
+TEST_F(FifoHandoffTest, DISABLED_handoff_benchmark) {
+    MutexQueue mutex_queues[2];
+    for (MutexQueue &q : mutex_queues)
+        ASSERT_EQ(mutex_queue_ctor(&q, 64), EB_ErrorNone);
+    measure_handoff(
+        "semaphore + mutex",
+        [&](int q, EbPtr object) { mutex_queue_push(&mutex_queues[q], object); },
+        [&](int q) { return mutex_queue_pop(&mutex_queues[q]); });
+
+    EbRingQueue *ring_queues[2];
+    for (EbRingQueue *&q : ring_queues)
+        ASSERT_EQ(eb_ring_queue_ctor(&q, 64, EB_TRUE), EB_ErrorNone);
+    measure_handoff(
+        "EbRingQueue",
+        [&](int q, EbPtr object) { eb_ring_queue_push(ring_queues[q], object); },
+        [&](int q) {
+            EbPtr object;
+            eb_ring_queue_pop(ring_queues[q], &object);
+            return object;
+        });
+
+    // The EbSystemResource path, as configured by LOCK_FREE_FIFO. Each
+    // direction is one resource: get empty + post full, then get full +
+    // release.
+    EbSystemResource *resources[2];
+    EbFifo **producer_fifos[2], **consumer_fifos[2];
+    for (int q = 0; q < 2; ++q)
+        ASSERT_EQ(eb_system_resource_ctor(&resources[q], 64, 1, 1,
+                                          &producer_fifos[q],
+                                          &consumer_fifos[q], EB_TRUE,
+                                          nullptr, nullptr),
+                  EB_ErrorNone);
+    measure_handoff(
+        LOCK_FREE_FIFO ? "EbSystemResource (ring)" : "EbSystemResource (mutex)",
+        [&](int q, EbPtr object) {
+            EbObjectWrapper *wrapper;
+            eb_get_empty_object(producer_fifos[q][0], &wrapper);
+            wrapper->object_ptr = object;
+            eb_post_full_object(wrapper);
+        },
+        [&](int q) {
+            EbObjectWrapper *wrapper;
+            eb_get_full_object(consumer_fifos[q][0], &wrapper);
+            EbPtr object = wrapper->object_ptr;
+            eb_release_object(wrapper);
+            return object;
+        });
+}
+
+}  // namespace FifoHandoffTest
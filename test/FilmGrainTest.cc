@@ -14,9 +14,17 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
 #include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
 #include "grainSynthesis.h"
 #include "gtest/gtest.h"
+#include "random.h"
+
+using svt_av1_test_tool::SVTRandom;
 
 static aom_film_grain_t film_grain_test_vectors[3] = {
     /* Test 1 */
@@ -186,3 +194,243 @@ TEST(FilmGrain, parameters_equality) {
                                       film_grain_test_vectors + 2),
               0);
 }
+
+/** Random scaling function, with entry 256 repeating entry 255 */
+static void random_scaling_lut(int32_t *scaling_lut) {
+    SVTRandom rnd(0, 255);
+    for (int32_t i = 0; i < 256; i++)
+        scaling_lut[i] = rnd.random();
+    scaling_lut[256] = scaling_lut[255];
+}
+
+TEST(FilmGrain, noise_rows_match_c) {
+    SVTRandom rnd8(0, 255);
+    SVTRandom rnd10(0, 1023);
+    SVTRandom rnd_grain(-512, 511);
+    // Full vectors and partial ones
+    const int32_t widths[] = {1, 7, 8, 13, 32, 64};
+    int32_t scaling_lut[257];
+
+    for (const int32_t width : widths) {
+        for (int i = 0; i < 20; i++) {
+            std::vector<int32_t> grain(width);
+            std::vector<uint8_t> luma(2 * width), ref(width), tst(width);
+            std::vector<uint16_t> luma16(2 * width), ref16(width), tst16(width);
+            const int32_t chroma_subsamp_x = i & 1;
+            const int32_t scaling_shift = 8 + i % 4;
+            random_scaling_lut(scaling_lut);
+            for (int32_t j = 0; j < width; j++) {
+                grain[j] = rnd_grain.random();
+                ref[j] = tst[j] = (uint8_t)rnd8.random();
+                ref16[j] = tst16[j] = (uint16_t)rnd10.random();
+            }
+            for (int32_t j = 0; j < 2 * width; j++) {
+                luma[j] = (uint8_t)rnd8.random();
+                luma16[j] = (uint16_t)rnd10.random();
+            }
+
+            fgn_luma_noise_row_c(ref.data(), grain.data(), width, scaling_lut,
+                scaling_shift, 16, 235);
+            fgn_luma_noise_row_avx2(tst.data(), grain.data(), width,
+                scaling_lut, scaling_shift, 16, 235);
+            ASSERT_EQ(ref, tst) << "luma width " << width;
+
+            fgn_luma_noise_row_hbd_c(ref16.data(), grain.data(), width,
+                scaling_lut, 10, scaling_shift, 0, 1023);
+            fgn_luma_noise_row_hbd_avx2(tst16.data(), grain.data(), width,
+                scaling_lut, 10, scaling_shift, 0, 1023);
+            ASSERT_EQ(ref16, tst16) << "luma hbd width " << width;
+
+            fgn_chroma_noise_row_c(ref.data(), luma.data(), grain.data(),
+                width, scaling_lut, chroma_subsamp_x, 119, 64, -238,
+                scaling_shift, 16, 240);
+            fgn_chroma_noise_row_avx2(tst.data(), luma.data(), grain.data(),
+                width, scaling_lut, chroma_subsamp_x, 119, 64, -238,
+                scaling_shift, 16, 240);
+            ASSERT_EQ(ref, tst) << "chroma width " << width;
+
+            fgn_chroma_noise_row_hbd_c(ref16.data(), luma16.data(),
+                grain.data(), width, scaling_lut, chroma_subsamp_x, -20, 101,
+                -952, 10, scaling_shift, 64, 960);
+            fgn_chroma_noise_row_hbd_avx2(tst16.data(), luma16.data(),
+                grain.data(), width, scaling_lut, chroma_subsamp_x, -20, 101,
+                -952, 10, scaling_shift, 64, 960);
+            ASSERT_EQ(ref16, tst16) << "chroma hbd width " << width;
+        }
+    }
+}
+
+TEST(FilmGrain, grain_rows_match_c) {
+    SVTRandom rnd_grain(-512, 511);
+    SVTRandom rnd_coeff(-128, 127);
+    const int32_t stride = 82;
+    const int32_t widths[] = {1, 7, 8, 13, 32, 76};
+    int32_t coeffs[24];
+
+    for (const int32_t width : widths) {
+        for (int32_t lag = 0; lag <= 3; lag++) {
+            std::vector<int32_t> block(4 * stride), top(2 * stride);
+            std::vector<int32_t> ref(2 * stride), tst(2 * stride);
+            for (auto &v : block)
+                v = rnd_grain.random();
+            for (auto &v : top)
+                v = rnd_grain.random();
+            for (auto &v : coeffs)
+                v = rnd_coeff.random();
+
+            // Rows above the last row of the block, from its column 3
+            const int32_t *row = block.data() + 3 * stride + 3;
+            fgn_ar_row_sum_c(row, stride, coeffs, lag, width, ref.data());
+            fgn_ar_row_sum_avx2(row, stride, coeffs, lag, width, tst.data());
+            ASSERT_EQ(memcmp(ref.data(), tst.data(), width * sizeof(int32_t)),
+                      0)
+                << "ar width " << width << " lag " << lag;
+
+            // Overlap of 1 and 2 rows, in place on the top rows
+            const int32_t height = 1 + (lag & 1);
+            ref = tst = top;
+            fgn_hor_boundary_overlap_c(ref.data(), stride, block.data(),
+                stride, ref.data(), stride, width, height, -512, 511);
+            fgn_hor_boundary_overlap_avx2(tst.data(), stride, block.data(),
+                stride, tst.data(), stride, width, height, -512, 511);
+            ASSERT_EQ(ref, tst) << "overlap width " << width;
+        }
+    }
+}
+
+/** Adds the grain to a random picture, as a whole and by stripes in reverse
+ * order */
+static void test_stripes(const aom_film_grain_t *params, int32_t width,
+                         int32_t height, int32_t use_high_bit_depth) {
+    const int32_t luma_stride = width + 5;
+    const int32_t chroma_stride = ((width + 1) >> 1) + 3;
+    const int32_t chroma_height = (height + 1) >> 1;
+    const size_t bytes = use_high_bit_depth ? 2 : 1;
+    const size_t luma_size = luma_stride * height * bytes;
+    const size_t chroma_size = chroma_stride * chroma_height * bytes;
+    std::vector<uint8_t> ref(luma_size + 2 * chroma_size);
+    SVTRandom rnd(0, 255);
+    aom_film_grain_t grain = *params;
+
+    grain.bit_depth = use_high_bit_depth ? 10 : 8;
+    for (auto &v : ref)
+        v = (uint8_t)rnd.random();
+    if (use_high_bit_depth) {
+        uint16_t *samples = (uint16_t *)ref.data();
+        for (size_t i = 0; i < ref.size() / 2; i++)
+            samples[i] &= 1023;
+    }
+    std::vector<uint8_t> tst = ref;
+
+    ASSERT_EQ(av1_add_film_grain_run(&grain, ref.data(),
+        ref.data() + luma_size, ref.data() + luma_size + chroma_size, height,
+        width, luma_stride, chroma_stride, use_high_bit_depth, 1, 1), 0);
+
+    aom_film_grain_synth_t *fgs = new aom_film_grain_synth_t;
+    av1_film_grain_synth_init(fgs, &grain, height, width, use_high_bit_depth,
+        1, 1);
+    for (int32_t stripe = av1_film_grain_stripe_count(height) - 1;
+         stripe >= 0; stripe--)
+        EXPECT_EQ(av1_add_film_grain_stripe(fgs, tst.data(),
+            tst.data() + luma_size, tst.data() + luma_size + chroma_size,
+            luma_stride, chroma_stride, stripe), 0);
+    delete fgs;
+
+    EXPECT_EQ(ref, tst) << "width " << width << " height " << height
+                        << " hbd " << use_high_bit_depth;
+}
+
+TEST(FilmGrain, stripes_match_picture) {
+    setup_rtcd_flags(HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_AVX | HAS_AVX2);
+    for (int32_t hbd = 0; hbd <= 1; hbd++) {
+        // With and without overlap, and a picture smaller than a stripe
+        test_stripes(film_grain_test_vectors, 328, 200, hbd);
+        test_stripes(film_grain_test_vectors + 2, 328, 200, hbd);
+        test_stripes(film_grain_test_vectors + 2, 157, 99, hbd);
+        test_stripes(film_grain_test_vectors + 2, 40, 17, hbd);
+    }
+}
+
+/** Golden checksum of a picture with grain, the grain settings changed from
+ * those of the test vector */
+typedef struct {
+    int32_t vector;
+    int32_t width;
+    int32_t height;
+    int32_t use_high_bit_depth;
+    int32_t chroma_scaling_from_luma;
+    int32_t grain_scale_shift;
+    int32_t clip_to_restricted_range;
+    uint32_t checksum;
+} GrainChecksum;
+
+// Checksums of the grain synthesized for the whole picture at once, before
+// the picture was split into stripes
+static const GrainChecksum grain_checksums[] = {
+    // Each vector in 8 and 10 bit, with and without overlap
+    {0, 328, 200, 0, 0, 0, 0, 0xf244bd28},
+    {0, 328, 200, 1, 0, 0, 0, 0xbf146ae5},
+    {1, 328, 200, 0, 0, 0, 0, 0xe3d74d06},
+    {1, 328, 200, 1, 0, 0, 0, 0x43168dac},
+    {2, 328, 200, 0, 0, 0, 0, 0x061da1d7},
+    {2, 328, 200, 1, 0, 0, 0, 0x86e1b296},
+    // Partial blocks, and a picture smaller than a stripe
+    {2, 157, 99, 0, 0, 0, 0, 0xbbfe50b2},
+    {2, 157, 99, 1, 0, 0, 0, 0x555e6718},
+    {2, 40, 17, 0, 0, 0, 0, 0x96802932},
+    // Chroma scaled from luma, scaled down grain and restricted range
+    {0, 328, 200, 1, 1, 0, 0, 0xa7167c0f},
+    {1, 328, 200, 0, 0, 2, 0, 0xb51d7d79},
+    {2, 328, 200, 1, 0, 0, 1, 0x9dfb5efe},
+    {2, 157, 99, 0, 1, 0, 1, 0x3a90662b},
+};
+
+/** FNV-1a hash of the picture, after adding the grain to samples from a
+ * fixed generator, so that the checksum does not depend on the standard
+ * library */
+static uint32_t grain_checksum(const GrainChecksum *c) {
+    const int32_t luma_stride = c->width + 5;
+    const int32_t chroma_stride = ((c->width + 1) >> 1) + 3;
+    const int32_t chroma_height = (c->height + 1) >> 1;
+    const size_t bytes = c->use_high_bit_depth ? 2 : 1;
+    const size_t luma_size = luma_stride * c->height * bytes;
+    const size_t chroma_size = chroma_stride * chroma_height * bytes;
+    std::vector<uint8_t> buf(luma_size + 2 * chroma_size);
+    aom_film_grain_t grain = film_grain_test_vectors[c->vector];
+    uint32_t seed = 12345;
+    uint32_t hash = 2166136261u;
+
+    grain.bit_depth = c->use_high_bit_depth ? 10 : 8;
+    grain.chroma_scaling_from_luma = c->chroma_scaling_from_luma;
+    grain.grain_scale_shift = c->grain_scale_shift;
+    grain.clip_to_restricted_range = c->clip_to_restricted_range;
+    for (size_t i = 0; i < buf.size(); i += bytes) {
+        seed = seed * 1103515245u + 12345u;
+        if (c->use_high_bit_depth)
+            *(uint16_t *)&buf[i] = (uint16_t)((seed >> 16) & 1023);
+        else
+            buf[i] = (uint8_t)(seed >> 16);
+    }
+
+    EXPECT_EQ(av1_add_film_grain_run(&grain, buf.data(),
+        buf.data() + luma_size, buf.data() + luma_size + chroma_size,
+        c->height, c->width, luma_stride, chroma_stride,
+        c->use_high_bit_depth, 1, 1), 0);
+
+    for (uint8_t v : buf)
+        hash = (hash ^ v) * 16777619u;
+    return hash;
+}
+
+TEST(FilmGrain, picture_matches_golden_checksums) {
+    for (int32_t simd = 0; simd <= 1; simd++) {
+        setup_rtcd_flags(
+            simd ? HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_AVX | HAS_AVX2 : 0);
+        for (const GrainChecksum &c : grain_checksums) {
+            EXPECT_EQ(grain_checksum(&c), c.checksum)
+                << "vector " << c.vector + 1 << " " << c.width << "x"
+                << c.height << " hbd " << c.use_high_bit_depth << " simd "
+                << simd;
+        }
+    }
+}
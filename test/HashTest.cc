@@ -0,0 +1,103 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file HashTest.cc
+ *
+ * @brief Unit test for the CRC-32C used by the intra block copy hash:
+ * - av1_get_crc32c_value_sse4_2
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "hash.h"
+#include "aom_dsp_rtcd.h"
+#include "random.h"
+
+namespace {
+
+using svt_av1_test_tool::SVTRandom;
+
+const int kMaxLength = 256;
+
+/**
+ * @brief Unit test for av1_get_crc32c_value_sse4_2
+ *
+ * Test strategy:
+ * Compute the CRC of the same data with the table driven C function and
+ * the SSE4.2 function, at every length up to kMaxLength and every start
+ * alignment of an 8-byte word.
+ *
+ * Expect result:
+ * The CRCs are exactly the same.
+ *
+ * Test cases:
+ * - Crc32cTest.MatchC_Random
+ * - Crc32cTest.MatchC_Extreme
+ * - Crc32cTest.KnownValue
+ */
+class Crc32cTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        av1_crc32c_calculator_init(&crc_calculator_);
+    }
+
+    void run_match(void) {
+        for (int offset = 0; offset < 8; ++offset) {
+            for (int length = 0; length <= kMaxLength; ++length) {
+                const uint32_t crc_ref = av1_get_crc32c_value_c(
+                    &crc_calculator_, data_ + offset, length);
+                const uint32_t crc_test = av1_get_crc32c_value_sse4_2(
+                    &crc_calculator_, data_ + offset, length);
+                ASSERT_EQ(crc_ref, crc_test)
+                    << "offset " << offset << " length " << length;
+            }
+        }
+    }
+
+    CRC32C crc_calculator_;
+    uint8_t data_[kMaxLength + 8];
+};
+
+TEST_F(Crc32cTest, MatchC_Random) {
+    SVTRandom rnd(0, 255);
+    for (int i = 0; i < 10; ++i) {
+        for (size_t j = 0; j < sizeof(data_); ++j)
+            data_[j] = (uint8_t)rnd.random();
+        run_match();
+    }
+}
+
+TEST_F(Crc32cTest, MatchC_Extreme) {
+    memset(data_, 0, sizeof(data_));
+    run_match();
+    memset(data_, 255, sizeof(data_));
+    run_match();
+}
+
+// CRC-32C check value of the 9 bytes "123456789"
+TEST_F(Crc32cTest, KnownValue) {
+    uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(0xE3069283u,
+              av1_get_crc32c_value_c(&crc_calculator_, check, sizeof(check)));
+    EXPECT_EQ(0xE3069283u, av1_get_crc32c_value_sse4_2(
+                               &crc_calculator_, check, sizeof(check)));
+}
+
+}  // namespace
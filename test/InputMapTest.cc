@@ -0,0 +1,209 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file InputMapTest.cc
+ *
+ * @brief Unit test for the memory mapped input reader of the encoder app:
+ * - input_map_open / input_map_close
+ * - input_map_read_frame, with and without the prefetch thread
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "random.h"
+
+extern "C" {
+#include "EbAppInputMap.h"
+}
+
+namespace InputMapTest {
+
+static const uint32_t clip_width = 64;
+static const uint32_t clip_height = 32;
+static const uint32_t clip_frames = 5;
+static const uint32_t clip_frame_size = clip_width * clip_height * 3 / 2;
+
+/**
+ * @brief Writes a clip of random 8 bit 4:2:0 frames to a temporary file
+ * and reads it back through the mapping, comparing each plane with the
+ * bytes written.
+ */
+class InputMapTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        svt_av1_test_tool::SVTRandom rnd(0, 255);
+
+        clip_.resize(clip_frame_size * clip_frames);
+        for (size_t i = 0; i < clip_.size(); ++i)
+            clip_[i] = (uint8_t)rnd.random();
+
+        memset(&config_, 0, sizeof(config_));
+        config_.error_log_file = stderr;
+        config_.encoder_bit_depth = 8;
+        config_.encoder_color_format = EB_YUV420;
+        config_.input_padded_width = clip_width;
+        config_.input_padded_height = clip_height;
+
+        memset(&header_, 0, sizeof(header_));
+        memset(&io_, 0, sizeof(io_));
+        header_.p_buffer = (uint8_t *)&io_;
+    }
+
+    void TearDown() override {
+        input_map_close(&config_);
+        if (config_.input_file)
+            fclose(config_.input_file);
+    }
+
+    // Writes the clip, with a y4m header and delimiters when y4m is set
+    void write_clip(bool y4m) {
+        config_.input_file = tmpfile();
+        ASSERT_NE(config_.input_file, nullptr);
+        config_.y4m_input = y4m ? EB_TRUE : EB_FALSE;
+
+        if (y4m)
+            fputs("YUV4MPEG2 W64 H32 F30:1 Ip C420jpeg\n", config_.input_file);
+        header_size_ = ftell(config_.input_file);
+        for (uint32_t f = 0; f < clip_frames; ++f) {
+            if (y4m)
+                fputs("FRAME\n", config_.input_file);
+            fwrite(&clip_[f * clip_frame_size], 1, clip_frame_size,
+                   config_.input_file);
+        }
+        fflush(config_.input_file);
+
+        // The app parses the header before opening the map
+        fseek(config_.input_file, header_size_, SEEK_SET);
+    }
+
+    // Reads frames from the start, wrapping at the end of the clip
+    void check_frames(uint32_t count) {
+        for (uint32_t n = 0; n < count; ++n) {
+            const uint8_t *frame = &clip_[(n % clip_frames) * clip_frame_size];
+            const uint32_t luma_size = clip_width * clip_height;
+
+            config_.processed_frame_count = n;
+            ASSERT_EQ(input_map_read_frame(&config_, 0, &header_),
+                      EB_ErrorNone);
+            ASSERT_EQ(io_.y_stride, clip_width);
+            ASSERT_EQ(io_.cb_stride, clip_width / 2);
+            ASSERT_EQ(io_.cr_stride, clip_width / 2);
+            ASSERT_EQ(header_.n_filled_len, clip_frame_size);
+            ASSERT_EQ(memcmp(io_.luma, frame, luma_size), 0) << "frame " << n;
+            ASSERT_EQ(memcmp(io_.cb, frame + luma_size, luma_size / 4), 0)
+                << "frame " << n;
+            ASSERT_EQ(memcmp(io_.cr,
+                             frame + luma_size + luma_size / 4,
+                             luma_size / 4),
+                      0)
+                << "frame " << n;
+        }
+    }
+
+    std::vector<uint8_t> clip_;
+    long header_size_;
+    EbConfig config_;
+    EbBufferHeaderType header_;
+    EbSvtIOFormat io_;
+};
+
+TEST_F(InputMapTest, yuv_frames_match_file) {
+    write_clip(false);
+    config_.mmap_input = INPUT_MAP_ON;
+    ASSERT_EQ(input_map_open(&config_), EB_ErrorNone);
+    ASSERT_EQ(config_.input_map->frame_count, clip_frames);
+    check_frames(3 * clip_frames);
+}
+
+TEST_F(InputMapTest, y4m_frames_match_file) {
+    write_clip(true);
+    config_.mmap_input = INPUT_MAP_ON;
+    ASSERT_EQ(input_map_open(&config_), EB_ErrorNone);
+    ASSERT_EQ(config_.input_map->frame_count, clip_frames);
+    check_frames(2 * clip_frames);
+}
+
+TEST_F(InputMapTest, y4m_broken_delimiter_is_reported) {
+    write_clip(true);
+    config_.error_log_file = tmpfile();
+    fseek(config_.input_file,
+          header_size_ + INPUT_MAP_Y4M_DELIMITER_SIZE + clip_frame_size,
+          SEEK_SET);
+    fputs("FRAMX\n", config_.input_file);
+    fflush(config_.input_file);
+    fseek(config_.input_file, header_size_, SEEK_SET);
+    config_.mmap_input = INPUT_MAP_ON;
+    ASSERT_EQ(input_map_open(&config_), EB_ErrorNone);
+
+    config_.processed_frame_count = 0;
+    EXPECT_EQ(input_map_read_frame(&config_, 0, &header_), EB_ErrorNone);
+    config_.processed_frame_count = 1;
+    EXPECT_EQ(input_map_read_frame(&config_, 0, &header_),
+              EB_ErrorBadParameter);
+    fclose(config_.error_log_file);
+}
+
+TEST_F(InputMapTest, separate_fields_take_alternate_rows) {
+    write_clip(false);
+    config_.mmap_input = INPUT_MAP_ON;
+    config_.separate_fields = EB_TRUE;
+    config_.input_padded_height = clip_height / 2;
+    ASSERT_EQ(input_map_open(&config_), EB_ErrorNone);
+
+    for (uint32_t n = 0; n < 2 * clip_frames; ++n) {
+        const uint8_t *frame = &clip_[(n / 2) * clip_frame_size];
+
+        config_.processed_frame_count = n;
+        ASSERT_EQ(input_map_read_frame(&config_, 0, &header_), EB_ErrorNone);
+        ASSERT_EQ(io_.y_stride, 2 * clip_width);
+        for (uint32_t y = 0; y < clip_height / 2; ++y) {
+            ASSERT_EQ(memcmp(io_.luma + y * io_.y_stride,
+                             frame + (2 * y + (n & 1)) * clip_width,
+                             clip_width),
+                      0)
+                << "field " << n << " row " << y;
+        }
+    }
+}
+
+/**
+ * @brief The prefetch thread only touches the mapping; the planes must be
+ * the same, and closing while it runs ahead must not hang.
+ */
+TEST_F(InputMapTest, prefetch_frames_match_file) {
+    write_clip(false);
+    for (int run = 0; run < 20; ++run) {
+        fseek(config_.input_file, header_size_, SEEK_SET);
+        config_.mmap_input = INPUT_MAP_PREFETCH;
+        ASSERT_EQ(input_map_open(&config_), EB_ErrorNone);
+        ASSERT_EQ(config_.input_map->mode, (uint32_t)INPUT_MAP_PREFETCH);
+        check_frames(run % 2 ? 4 * clip_frames : 1);
+        input_map_close(&config_);
+        ASSERT_EQ(config_.input_map, nullptr);
+    }
+}
+
+TEST_F(InputMapTest, rejects_unmappable_input) {
+    config_.mmap_input = INPUT_MAP_ON;
+    config_.input_file = stdin;
+    EXPECT_EQ(input_map_open(&config_), EB_ErrorBadParameter);
+
+    // Shorter than one frame
+    config_.input_file = tmpfile();
+    ASSERT_NE(config_.input_file, nullptr);
+    fwrite(clip_.data(), 1, clip_frame_size - 1, config_.input_file);
+    fflush(config_.input_file);
+    fseek(config_.input_file, 0, SEEK_SET);
+    EXPECT_EQ(input_map_open(&config_), EB_ErrorBadParameter);
+    EXPECT_EQ(config_.input_map, nullptr);
+}
+
+}  // namespace InputMapTest
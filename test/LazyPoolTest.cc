@@ -0,0 +1,246 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file LazyPoolTest.cc
+ *
+ * @brief Unit test for the EbSystemResource pools constructed on demand
+ * (eb_system_resource_lazy_ctor, used with lazy_pool_allocation):
+ * - the pool grows one object at a time up to object_total_count
+ * - eb_try_get_empty_object stops at the cap, released objects are reused
+ * - object_memory_size follows the constructions
+ * - a failed construction stops the growth
+ * - the growth allocates from the arena of the pool, whatever the thread
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "EbMemoryArena.h"
+#include "EbSystemResourceManager.h"
+
+namespace LazyPoolTest {
+
+const uint32_t initial_count = 2;
+const uint32_t total_count = 8;
+
+/** Init data of the test objects */
+struct ObjectInitData {
+    uint32_t object_size;
+    uint32_t fail_after;  // constructions allowed, 0 for no limit
+};
+
+static uint32_t ctor_count;
+
+/** Allocates object_size bytes filled with the construction index */
+static EbErrorType object_ctor(EbPtr *object_dbl_ptr,
+                               EbPtr object_init_data_ptr) {
+    const ObjectInitData *init_data = (const ObjectInitData *)object_init_data_ptr;
+    uint8_t *object_ptr;
+
+    if (init_data->fail_after && ctor_count >= init_data->fail_after)
+        return EB_ErrorInsufficientResources;
+
+    EB_MALLOC(uint8_t *, object_ptr, init_data->object_size, EB_N_PTR);
+    memset(object_ptr, (int)ctor_count, init_data->object_size);
+    *object_dbl_ptr = object_ptr;
+    ++ctor_count;
+    return EB_ErrorNone;
+}
+
+/**
+ * @brief Each test constructs its pool from its own memory arena, released
+ * like eb_deinit_encoder does.
+ */
+class LazyPoolTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        ctor_count = 0;
+        init_data_.object_size = 4096;
+        init_data_.fail_after = 0;
+    }
+
+    void TearDown() override {
+        eb_memory_arena_set_current(nullptr);
+        eb_memory_arena_dtor(arena_);
+    }
+
+    void make_pool(uint32_t initial) {
+        ASSERT_EQ(eb_system_resource_lazy_ctor(&resource_,
+                                               initial,
+                                               total_count,
+                                               1,
+                                               0,
+                                               &producer_fifos_,
+                                               nullptr,
+                                               EB_FALSE,
+                                               object_ctor,
+                                               &init_data_,
+                                               sizeof(init_data_)),
+                  EB_ErrorNone);
+    }
+
+    /** Takes every object the pool can give without blocking */
+    std::vector<EbObjectWrapper *> take_all() {
+        std::vector<EbObjectWrapper *> wrappers;
+        EbObjectWrapper *wrapper;
+
+        for (;;) {
+            eb_try_get_empty_object(producer_fifos_[0], &wrapper);
+            if (wrapper == nullptr)
+                break;
+            wrappers.push_back(wrapper);
+        }
+        return wrappers;
+    }
+
+    EbMemoryArena *arena_;
+    EbSystemResource *resource_;
+    EbFifo **producer_fifos_;
+    ObjectInitData init_data_;
+};
+
+TEST_F(LazyPoolTest, grows_one_object_at_a_time_up_to_the_cap) {
+    make_pool(initial_count);
+    ASSERT_EQ(resource_->object_created_count, (int32_t)initial_count);
+    ASSERT_EQ(ctor_count, initial_count);
+
+    // The memory of an object, wrapper included
+    const uint64_t object_size = resource_->object_memory_size / initial_count;
+    EXPECT_GE(object_size, init_data_.object_size);
+
+    std::vector<EbObjectWrapper *> wrappers;
+    for (uint32_t i = 0; i < total_count; ++i) {
+        EbObjectWrapper *wrapper;
+
+        eb_get_empty_object(producer_fifos_[0], &wrapper);
+        ASSERT_NE(wrapper, nullptr);
+        wrappers.push_back(wrapper);
+
+        // The constructed objects are taken first
+        const uint32_t created = i < initial_count ? initial_count : i + 1;
+        EXPECT_EQ(resource_->object_created_count, (int32_t)created);
+        EXPECT_EQ(ctor_count, created);
+        EXPECT_EQ(resource_->object_memory_size, created * object_size);
+    }
+
+    // Every object is distinct and was constructed once
+    for (uint32_t i = 0; i < total_count; ++i) {
+        for (uint32_t j = i + 1; j < total_count; ++j)
+            ASSERT_NE(wrappers[i]->object_ptr, wrappers[j]->object_ptr);
+    }
+
+    EbObjectWrapper *wrapper;
+    eb_try_get_empty_object(producer_fifos_[0], &wrapper);
+    EXPECT_EQ(wrapper, nullptr) << "pool grew past object_total_count";
+    EXPECT_EQ(resource_->object_created_count, (int32_t)total_count);
+}
+
+TEST_F(LazyPoolTest, released_objects_are_reused_before_growing) {
+    make_pool(initial_count);
+
+    std::vector<EbObjectWrapper *> wrappers = take_all();
+    ASSERT_EQ(wrappers.size(), total_count);
+    const uint64_t memory_size = resource_->object_memory_size;
+
+    for (uint32_t run = 0; run < 3; ++run) {
+        EbObjectWrapper *wrapper;
+
+        eb_release_object(wrappers[run]);
+        eb_try_get_empty_object(producer_fifos_[0], &wrapper);
+        EXPECT_EQ(wrapper, wrappers[run]);
+    }
+    EXPECT_EQ(ctor_count, total_count);
+    EXPECT_EQ(resource_->object_memory_size, memory_size);
+
+    // A pool that was not full reuses the released object too
+    eb_memory_arena_dtor(arena_);
+    ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+    eb_memory_arena_set_current(arena_);
+    ctor_count = 0;
+    make_pool(0);
+    EXPECT_EQ(resource_->object_created_count, 0);
+
+    EbObjectWrapper *first, *second;
+    eb_get_empty_object(producer_fifos_[0], &first);
+    eb_release_object(first);
+    eb_get_empty_object(producer_fifos_[0], &second);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(ctor_count, 1u);
+}
+
+TEST_F(LazyPoolTest, init_data_outlives_the_caller) {
+    make_pool(initial_count);
+
+    // The caller's copy goes away after the init
+    init_data_.object_size = 0;
+    init_data_.fail_after = 1;
+
+    std::vector<EbObjectWrapper *> wrappers = take_all();
+    EXPECT_EQ(wrappers.size(), total_count);
+    EXPECT_EQ(resource_->grow_failed, EB_FALSE);
+}
+
+TEST_F(LazyPoolTest, failed_construction_stops_the_growth) {
+    init_data_.fail_after = initial_count + 2;
+    make_pool(initial_count);
+
+    std::vector<EbObjectWrapper *> wrappers = take_all();
+    EXPECT_EQ(wrappers.size(), initial_count + 2);
+    EXPECT_EQ(resource_->grow_failed, EB_TRUE);
+    EXPECT_EQ(resource_->object_created_count, (int32_t)(initial_count + 2));
+
+    // The pool runs with what was constructed
+    eb_release_object(wrappers[0]);
+    EbObjectWrapper *wrapper;
+    eb_get_empty_object(producer_fifos_[0], &wrapper);
+    EXPECT_EQ(wrapper, wrappers[0]);
+}
+
+TEST_F(LazyPoolTest, grows_in_the_arena_of_the_pool) {
+    make_pool(initial_count);
+    const uint64_t pool_committed = arena_->committed_size;
+
+    // Another encoder instance is current on the thread that takes the
+    // objects
+    std::thread thread([this]() {
+        EbMemoryArena *other_arena;
+
+        ASSERT_EQ(eb_memory_arena_ctor(&other_arena), EB_ErrorNone);
+        eb_memory_arena_set_current(other_arena);
+        const uint64_t other_committed = other_arena->committed_size;
+
+        std::vector<EbObjectWrapper *> wrappers = take_all();
+        EXPECT_EQ(wrappers.size(), total_count);
+        EXPECT_EQ(other_arena->committed_size, other_committed);
+        EXPECT_EQ(eb_memory_arena_get_current(), other_arena);
+
+        eb_memory_arena_set_current(nullptr);
+        eb_memory_arena_dtor(other_arena);
+    });
+    thread.join();
+
+    EXPECT_GE(arena_->committed_size - pool_committed,
+              (uint64_t)(total_count - initial_count) * init_data_.object_size);
+}
+
+}  // namespace LazyPoolTest
@@ -0,0 +1,281 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file MdRateEstimationCacheTest.cc
+ *
+ * @brief Unit test of the MD rate tables of av1_estimate_picture_rate:
+ * - the tables copied from the cache match the tables estimated afresh
+ * - pictures with the same CDF estimated at once share a single entry
+ * - a miss only builds the rates the picture reads
+ * - the entries are allocated when first filled
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbCabacContextModel.h"
+#include "EbEntropyCodingObject.h"
+#include "EbMdRateEstimation.h"
+#include "EbMemoryArena.h"
+#include "EbPictureControlSet.h"
+
+namespace MdRateEstimationCacheTest {
+
+// One base_qindex in each range of the default coefficient CDFs
+const int32_t qindexes[] = {10, 50, 100, 200};
+const int32_t thread_count = 4;
+
+/**
+ * @brief Each test gets a rate cache allocated from its own memory arena,
+ * and a picture whose coefficient estimation CDF is set up like
+ * ResetEntropyCoder does.
+ */
+class MdRateEstimationCacheTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        ASSERT_EQ(md_rate_estimation_cache_ctor(&cache_), EB_ErrorNone);
+
+        memset(&pcs_, 0, sizeof(pcs_));
+        memset(&ppcs_, 0, sizeof(ppcs_));
+        memset(&coder_, 0, sizeof(coder_));
+        fc_.resize(1);
+        coder_.fc = fc_.data();
+        pcs_.parent_pcs_ptr = &ppcs_;
+        pcs_.coeff_est_entropy_coder_ptr = &coder_;
+    }
+
+    void TearDown() override {
+        eb_memory_arena_dtor(arena_);
+    }
+
+    /** Default CDFs of a picture */
+    void set_picture(int32_t qindex, EB_SLICE slice_type,
+                     int32_t allow_intrabc) {
+        memset(coder_.fc, 0, sizeof(FRAME_CONTEXT));
+        init_mode_probs(coder_.fc);
+        av1_default_coef_probs(coder_.fc, qindex);
+        pcs_.slice_type = slice_type;
+        ppcs_.allow_intrabc = allow_intrabc;
+    }
+
+    /** The rates estimated without the cache */
+    void estimate_fresh(MdRateEstimationContext_t *rates) {
+        memset(rates, 0, sizeof(*rates));
+        av1_estimate_syntax_rate(
+            rates, pcs_.slice_type == I_SLICE ? EB_TRUE : EB_FALSE, coder_.fc);
+        av1_estimate_mv_rate(&pcs_, rates, &coder_.fc->nmvc);
+        av1_estimate_coefficients_rate(rates, coder_.fc);
+    }
+
+    /** Size of the rates built for the picture */
+    size_t built_size() {
+        return md_rate_estimation_size(
+            pcs_.slice_type == I_SLICE ? EB_TRUE : EB_FALSE,
+            ppcs_.allow_intrabc ? EB_TRUE : EB_FALSE);
+    }
+
+    /** Compares the rates that are built for the picture, after checking the
+     * MV cost stack points into the table it belongs to */
+    void expect_rates_eq(const MdRateEstimationContext_t &ref,
+                         MdRateEstimationContext_t &tst) {
+        const size_t size = built_size();
+
+        if (size > offsetof(MdRateEstimationContext_t, nmvcoststack)) {
+            EXPECT_EQ(tst.nmvcoststack[0], &tst.nmv_costs[0][MV_MAX]);
+            EXPECT_EQ(tst.nmvcoststack[1], &tst.nmv_costs[1][MV_MAX]);
+            tst.nmvcoststack[0] = ref.nmvcoststack[0];
+            tst.nmvcoststack[1] = ref.nmvcoststack[1];
+        }
+        EXPECT_EQ(memcmp(&ref, &tst, size), 0)
+            << "slice type " << (int)pcs_.slice_type << " intrabc "
+            << ppcs_.allow_intrabc;
+    }
+
+    /** Entries built from the CDF and the flags of the picture */
+    int32_t count_entries() {
+        const EbBool is_i_slice = pcs_.slice_type == I_SLICE ? EB_TRUE
+                                                             : EB_FALSE;
+        const EbBool allow_intrabc = ppcs_.allow_intrabc ? EB_TRUE : EB_FALSE;
+        int32_t count = 0;
+
+        for (const MdRateEstimationCacheEntry_t &entry : cache_->entry_array) {
+            if (entry.valid && entry.is_i_slice == is_i_slice &&
+                entry.allow_intrabc == allow_intrabc &&
+                memcmp(entry.fc, coder_.fc, sizeof(FRAME_CONTEXT)) == 0)
+                count++;
+        }
+        return count;
+    }
+
+    EbMemoryArena *arena_;
+    MdRateEstimationCache_t *cache_;
+    PictureControlSet_t pcs_;
+    PictureParentControlSet_t ppcs_;
+    EntropyCoder_t coder_;
+    std::vector<FRAME_CONTEXT> fc_;
+};
+
+/**
+ * @brief The rates of a miss, and of the following hit, match the fresh
+ * estimation, with more CDFs than entries evicting each other.
+ */
+TEST_F(MdRateEstimationCacheTest, hit_matches_fresh_estimation) {
+    std::vector<MdRateEstimationContext_t> rates(3);
+    MdRateEstimationContext_t &ref = rates[0];
+    MdRateEstimationContext_t &miss = rates[1];
+    MdRateEstimationContext_t &hit = rates[2];
+
+    // B slice, I slice, I slice with intra block copy
+    for (int32_t round = 0; round < 2; round++) {
+        for (int32_t qindex : qindexes) {
+            for (int32_t kind = 0; kind < 3; kind++) {
+                const EB_SLICE slice_type = kind ? I_SLICE : B_SLICE;
+                const int32_t intrabc = kind == 2;
+
+                set_picture(qindex, slice_type, intrabc);
+                estimate_fresh(&ref);
+
+                memset(&miss, 0, sizeof(miss));
+                av1_estimate_picture_rate(cache_, &pcs_, &miss, coder_.fc);
+                expect_rates_eq(ref, miss);
+
+                // Stale rates in the table are all overwritten by the copy
+                memset(&hit, 0xa5, sizeof(hit));
+                av1_estimate_picture_rate(cache_, &pcs_, &hit, coder_.fc);
+                expect_rates_eq(ref, hit);
+                EXPECT_EQ(count_entries(), 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief The MV rates are only built for the pictures that read them, and
+ * the intra block copy rates for the pictures that allow it.
+ */
+TEST_F(MdRateEstimationCacheTest, miss_builds_rates_read_by_picture) {
+    std::vector<MdRateEstimationContext_t> rates(1);
+    MdRateEstimationContext_t &tst = rates[0];
+    const uint8_t *bytes = (const uint8_t *)&tst;
+    const size_t mv_offset = offsetof(MdRateEstimationContext_t, nmv_vec_cost);
+    const size_t dv_offset = offsetof(MdRateEstimationContext_t, dv_cost);
+
+    // Missed, then hit
+    for (int32_t run = 0; run < 2; run++) {
+        set_picture(qindexes[2], I_SLICE, 0);
+        EXPECT_EQ(built_size(), mv_offset);
+        memset(&tst, 0xa5, sizeof(tst));
+        av1_estimate_picture_rate(cache_, &pcs_, &tst, coder_.fc);
+        for (size_t i = mv_offset; i < sizeof(tst); i++)
+            ASSERT_EQ(bytes[i], 0xa5) << "byte " << i << " of an I slice";
+
+        set_picture(qindexes[2], B_SLICE, 0);
+        EXPECT_EQ(built_size(), dv_offset);
+        memset(&tst, 0xa5, sizeof(tst));
+        av1_estimate_picture_rate(cache_, &pcs_, &tst, coder_.fc);
+        for (size_t i = dv_offset; i < sizeof(tst); i++)
+            ASSERT_EQ(bytes[i], 0xa5) << "byte " << i << " of a B slice";
+    }
+}
+
+/**
+ * @brief The entries are allocated as the pictures fill them, and reused
+ * once all of them are allocated.
+ */
+TEST_F(MdRateEstimationCacheTest, entries_allocated_when_filled) {
+    std::vector<MdRateEstimationContext_t> rates(1);
+    const size_t entry_count = MD_RATE_ESTIMATION_CACHE_SIZE;
+
+    auto allocated_entries = [this]() {
+        size_t count = 0;
+        for (const MdRateEstimationCacheEntry_t &entry : cache_->entry_array) {
+            EXPECT_EQ(entry.fc == nullptr, entry.md_rate_estimation_ptr == nullptr);
+            count += entry.md_rate_estimation_ptr != nullptr;
+        }
+        return count;
+    };
+
+    EXPECT_EQ(allocated_entries(), 0u);
+    for (size_t i = 0; i < 2 * entry_count; i++) {
+        const uint64_t committed = arena_->committed_size;
+
+        set_picture(qindexes[i % 4], (i / 4) % 2 ? I_SLICE : B_SLICE, 0);
+        av1_estimate_picture_rate(cache_, &pcs_, &rates[0], coder_.fc);
+        EXPECT_EQ(allocated_entries(), std::min(i + 1, entry_count));
+        if (i >= entry_count)
+            EXPECT_EQ(arena_->committed_size, committed);
+    }
+}
+
+/**
+ * @brief An I slice and a B slice with the same CDF do not share rates.
+ */
+TEST_F(MdRateEstimationCacheTest, slice_type_is_part_of_the_key) {
+    std::vector<MdRateEstimationContext_t> rates(2);
+    MdRateEstimationContext_t &ref = rates[0];
+    MdRateEstimationContext_t &tst = rates[1];
+
+    set_picture(qindexes[0], I_SLICE, 0);
+    av1_estimate_picture_rate(cache_, &pcs_, &tst, coder_.fc);
+
+    set_picture(qindexes[0], B_SLICE, 0);
+    estimate_fresh(&ref);
+    memset(&tst, 0, sizeof(tst));
+    av1_estimate_picture_rate(cache_, &pcs_, &tst, coder_.fc);
+    expect_rates_eq(ref, tst);
+    EXPECT_EQ(count_entries(), 1);
+}
+
+/**
+ * @brief Pictures with the same CDF missing the cache at once all get the
+ * fresh rates, and leave a single entry behind.
+ */
+TEST_F(MdRateEstimationCacheTest, concurrent_misses_insert_once) {
+    std::vector<MdRateEstimationContext_t> rates(thread_count + 1);
+    std::vector<std::thread> threads;
+    std::atomic<int32_t> started(0);
+
+    set_picture(qindexes[1], B_SLICE, 0);
+    estimate_fresh(&rates[thread_count]);
+
+    for (int32_t i = 0; i < thread_count; i++) {
+        threads.push_back(std::thread([this, &rates, &started, i]() {
+            memset(&rates[i], 0, sizeof(rates[i]));
+            // All threads look the CDF up before any of them inserts it
+            ++started;
+            while (started.load() < thread_count)
+                std::this_thread::yield();
+            av1_estimate_picture_rate(cache_, &pcs_, &rates[i], coder_.fc);
+        }));
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    for (int32_t i = 0; i < thread_count; i++)
+        expect_rates_eq(rates[thread_count], rates[i]);
+    EXPECT_EQ(count_entries(), 1);
+}
+
+}  // namespace MdRateEstimationCacheTest
@@ -0,0 +1,238 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file NoiseModelTest.cc
+ *
+ * @brief Unit test for the film grain denoising and noise model:
+ * - aom_noise_tx_filter_block_avx2 against the C filter
+ * - the rows of the denoising phases run on several threads, and the serial
+ *   aom_denoise_and_model_run, denoise the picture as the encoder did before
+ *   the block rows were split (wiener_denoise_2d_ref)
+ * - the threaded rows give the same grain parameters as the serial run
+ *
+ ******************************************************************************/
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "EbMemoryArena.h"
+#include "aom_dsp_rtcd.h"
+#include "noise_model.h"
+#include "noise_util.h"
+#include "NoiseModelRef.h"
+#include "random.h"
+
+namespace NoiseModelTest {
+
+using svt_av1_test_reference::wiener_denoise_2d_ref;
+using svt_av1_test_tool::SVTRandom;
+
+TEST(NoiseTxFilterTest, MatchC) {
+    SVTRandom rnd_coeff(-1024, 1023);
+    SVTRandom rnd_psd(1, 4096);
+    // Block sizes of the transforms, and sizes with a partial vector
+    const int32_t sizes[] = {4, 13, 64, 256, 1024};
+
+    for (const int32_t n : sizes) {
+        std::vector<float> ref(2 * n), tst(2 * n), psd(n);
+        for (int i = 0; i < 10; i++) {
+            for (int32_t j = 0; j < 2 * n; j++)
+                ref[j] = tst[j] = rnd_coeff.random() / 8.0f;
+            for (int32_t j = 0; j < n; j++)
+                psd[j] = rnd_psd.random() / 16.0f;
+            // Some coefficients below the noise and some exactly zero
+            tst[0] = ref[0] = tst[1] = ref[1] = 0;
+
+            aom_noise_tx_filter_block_c(ref.data(), psd.data(), n);
+            aom_noise_tx_filter_block_avx2(tst.data(), psd.data(), n);
+            ASSERT_EQ(memcmp(ref.data(), tst.data(), 2 * n * sizeof(float)), 0)
+                << "n " << n;
+        }
+    }
+}
+
+/**
+ * @brief Each test denoises a 420 8 bit picture whose flat half gives the
+ * noise model its flat blocks, with contexts and row buffers allocated from
+ * the memory arena of the test.
+ */
+class DenoiseAndModelTest : public ::testing::Test {
+  protected:
+    static const int32_t kWidth = 328;
+    static const int32_t kHeight = 200;
+    static const int32_t kNoiseLevel = 25;
+    static const int kThreads = 4;
+
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        setup_rtcd_flags(HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_AVX | HAS_AVX2);
+    }
+
+    void TearDown() override {
+        eb_memory_arena_dtor(arena_);
+    }
+
+    /** A flat and a textured half, with noise on both */
+    void make_picture(EbPictureBufferDesc_t *pic, std::vector<uint8_t> &buf) {
+        const int32_t stride = kWidth + 16;
+        const int32_t chroma_stride = stride >> 1;
+        SVTRandom rnd_noise(-10, 10);
+
+        buf.resize(stride * kHeight + 2 * chroma_stride * (kHeight >> 1));
+        memset(pic, 0, sizeof(*pic));
+        pic->width = kWidth;
+        pic->height = kHeight;
+        pic->stride_y = stride;
+        pic->strideCb = pic->strideCr = chroma_stride;
+        pic->buffer_y = buf.data();
+        pic->bufferCb = pic->buffer_y + stride * kHeight;
+        pic->bufferCr = pic->bufferCb + chroma_stride * (kHeight >> 1);
+        for (int32_t y = 0; y < kHeight; y++) {
+            for (int32_t x = 0; x < kWidth; x++) {
+                const int32_t base =
+                    x < kWidth / 2 ? 100 : (x * 3 + y * 5) % 200;
+                pic->buffer_y[y * stride + x] =
+                    (uint8_t)(base + 20 + rnd_noise.random());
+            }
+        }
+        for (int32_t y = 0; y < (kHeight >> 1); y++) {
+            for (int32_t x = 0; x < (kWidth >> 1); x++) {
+                pic->bufferCb[y * chroma_stride + x] =
+                    (uint8_t)(128 + rnd_noise.random() / 2);
+                pic->bufferCr[y * chroma_stride + x] =
+                    (uint8_t)(110 + (x + y) % 40 + rnd_noise.random() / 2);
+            }
+        }
+    }
+
+    struct aom_denoise_and_model_t *make_context() {
+        denoise_and_model_init_data_t init_data;
+        EbPtr ctx = NULL;
+        memset(&init_data, 0, sizeof(init_data));
+        init_data.noise_level = kNoiseLevel;
+        init_data.encoder_bit_depth = EB_8BIT;
+        init_data.encoder_color_format = EB_YUV420;
+        init_data.width = kWidth;
+        init_data.height = kHeight;
+        init_data.stride_y = kWidth + 16;
+        init_data.stride_cb = init_data.stride_cr = (kWidth + 16) >> 1;
+        EXPECT_EQ(denoise_and_model_ctor(&ctx, &init_data), EB_ErrorNone);
+        return (struct aom_denoise_and_model_t *)ctx;
+    }
+
+    /** Runs the phases as the picture analysis threads do, each thread
+     * with its own row buffers */
+    void run_threaded(struct aom_denoise_and_model_t *ctx,
+                      EbPictureBufferDesc_t *pic, aom_film_grain_t *grain) {
+        std::vector<struct aom_denoise_row_buffers_t *> buffers(kThreads);
+        for (int t = 0; t < kThreads; t++) {
+            ASSERT_EQ(
+                aom_denoise_row_buffers_ctor(&buffers[t], DENOISING_BlockSize),
+                EB_ErrorNone);
+        }
+
+        ASSERT_EQ(aom_denoise_and_model_start(ctx, pic, 0, ASM_AVX2), 1);
+        for (int phase = 0; phase < AOM_DENOISE_PHASE_COUNT; phase++) {
+            const aom_denoise_phase_t p = (aom_denoise_phase_t)phase;
+            const int32_t row_count = aom_denoise_and_model_row_count(ctx, p);
+            std::atomic<int32_t> next_row(0);
+            std::vector<std::thread> threads;
+            ASSERT_LE(row_count, aom_denoise_and_model_max_row_count(ctx));
+            for (int t = 0; t < kThreads; t++) {
+                threads.push_back(std::thread([&, t]() {
+                    int32_t row;
+                    while ((row = next_row++) < row_count)
+                        aom_denoise_and_model_run_row(ctx, buffers[t], p, row);
+                }));
+            }
+            for (auto &thread : threads)
+                thread.join();
+            aom_denoise_and_model_end_phase(ctx, p);
+        }
+        ASSERT_EQ(aom_denoise_and_model_finish(ctx, pic, grain, ASM_AVX2), 1);
+    }
+
+    /** The picture denoised by the serial denoiser, with the flat noise
+     * spectrum aom_denoise_and_model_start sets up */
+    void denoise_ref(EbPictureBufferDesc_t *pic, std::vector<uint8_t> &buf) {
+        const int32_t n = DENOISING_BlockSize * DENOISING_BlockSize;
+        const float noise_level = (float)(kNoiseLevel / 10.0);
+        std::vector<float> psd_y(n, aom_noise_psd_get_default_value(
+                                        DENOISING_BlockSize, noise_level));
+        std::vector<float> psd_uv(n, aom_noise_psd_get_default_value(
+                                         DENOISING_BlockSize >> 1, noise_level));
+        float *noise_psd[3] = {psd_y.data(), psd_uv.data(), psd_uv.data()};
+        int32_t strides[3] = {pic->stride_y, pic->strideCb, pic->strideCr};
+        int32_t chroma_sub[2] = {1, 1};
+        // The planes of pic point into buf, they are read from a copy
+        const std::vector<uint8_t> input = buf;
+        const uint8_t *const data[3] = {
+            input.data(),
+            input.data() + (pic->bufferCb - pic->buffer_y),
+            input.data() + (pic->bufferCr - pic->buffer_y)};
+        uint8_t *denoised[3] = {pic->buffer_y, pic->bufferCb, pic->bufferCr};
+
+        ASSERT_EQ(wiener_denoise_2d_ref(data, denoised, kWidth, kHeight,
+                                        strides, chroma_sub, noise_psd,
+                                        DENOISING_BlockSize, 8, 0),
+                  1);
+    }
+
+    EbMemoryArena *arena_;
+};
+
+/**
+ * @brief The rows run on several threads denoise the picture as the serial
+ * denoiser did, and give the grain parameters of the serial run.
+ */
+TEST_F(DenoiseAndModelTest, ThreadedRowsMatchSerial) {
+    EbPictureBufferDesc_t ref_pic, run_pic, tst_pic;
+    std::vector<uint8_t> ref_buf, run_buf, tst_buf;
+    aom_film_grain_t run_grain, tst_grain;
+    struct aom_denoise_and_model_t *run_ctx = make_context();
+    struct aom_denoise_and_model_t *tst_ctx = make_context();
+    ASSERT_NE(run_ctx, nullptr);
+    ASSERT_NE(tst_ctx, nullptr);
+    make_picture(&ref_pic, ref_buf);
+    make_picture(&run_pic, run_buf);
+    make_picture(&tst_pic, tst_buf);
+    ASSERT_EQ(ref_buf, run_buf);
+    ASSERT_EQ(ref_buf, tst_buf);
+    memset(&run_grain, 0, sizeof(run_grain));
+    memset(&tst_grain, 0, sizeof(tst_grain));
+
+    denoise_ref(&ref_pic, ref_buf);
+    ASSERT_NE(ref_buf, tst_buf) << "picture not denoised";
+
+    ASSERT_EQ(aom_denoise_and_model_run(
+                  run_ctx, &run_pic, &run_grain, 0, ASM_AVX2),
+              1);
+    run_threaded(tst_ctx, &tst_pic, &tst_grain);
+
+    // The denoised picture is written back once the grain is modelled
+    EXPECT_EQ(run_grain.apply_grain, 1);
+    EXPECT_EQ(ref_buf, run_buf) << "serial run";
+    EXPECT_EQ(ref_buf, tst_buf) << "threaded rows";
+    EXPECT_EQ(memcmp(&run_grain, &tst_grain, sizeof(run_grain)), 0);
+}
+
+}  // namespace NoiseModelTest
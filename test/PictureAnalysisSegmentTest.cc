@@ -0,0 +1,308 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file PictureAnalysisSegmentTest.cc
+ *
+ * @brief Unit test of the picture analysis split in SB row segments:
+ * - the SB statistics (variance, luma and chroma means, screen content
+ *   block counts) computed by segments on several threads match the ones
+ *   of a single segment covering the picture, the serial path
+ * - the same holds for the 1/4 and 1/16 decimated pictures
+ * - exactly one thread completes the last segment
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbMemoryArena.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+#include "EbThreads.h"
+#include "aom_dsp_rtcd.h"
+#include "random.h"
+
+/* Defined in EbPictureAnalysisProcess.c */
+extern "C" EbBool AnalyzePictureSegments(
+    SequenceControlSet *sequence_control_set_ptr,
+    PictureParentControlSet_t *picture_control_set_ptr,
+    EbPictureBufferDesc_t *input_padded_picture_ptr,
+    EbPictureBufferDesc_t *quarter_decimated_picture_ptr,
+    EbPictureBufferDesc_t *sixteenth_decimated_picture_ptr,
+    uint32_t picture_width_in_sb, uint32_t pictureHeighInLcu,
+    EbAsm asm_type);
+
+using svt_av1_test_tool::SVTRandom;
+
+namespace PictureAnalysisSegmentTest {
+
+// 5 SB columns and 5 SB rows, the last ones partial
+const uint32_t width = 312;
+const uint32_t height = 296;
+const uint32_t sb_size = 64;
+const uint32_t sb_cols = (width + sb_size - 1) / sb_size;
+const uint32_t sb_rows = (height + sb_size - 1) / sb_size;
+const uint32_t sb_count = sb_cols * sb_rows;
+const uint32_t padded_width = sb_cols * sb_size;
+const uint32_t padded_height = sb_rows * sb_size;
+const uint32_t border = 32;
+const int32_t thread_count = 4;
+
+/** A picture with its own planes and padding */
+struct Picture {
+    EbPictureBufferDesc_t desc;
+    std::vector<uint8_t> buf;
+
+    void alloc(uint32_t w, uint32_t h, uint32_t pad) {
+        const uint32_t stride = w + 2 * pad;
+        const size_t luma_size = (size_t)stride * (h + 2 * pad);
+
+        buf.assign(luma_size + 2 * (luma_size >> 2), 0);
+        memset(&desc, 0, sizeof(desc));
+        desc.buffer_y = buf.data();
+        desc.bufferCb = buf.data() + luma_size;
+        desc.bufferCr = buf.data() + luma_size + (luma_size >> 2);
+        desc.stride_y = (uint16_t)stride;
+        desc.strideCb = (uint16_t)(stride >> 1);
+        desc.strideCr = (uint16_t)(stride >> 1);
+        desc.origin_x = (uint16_t)pad;
+        desc.origin_y = (uint16_t)pad;
+        desc.width = (uint16_t)w;
+        desc.height = (uint16_t)h;
+        desc.bit_depth = EB_8BIT;
+        desc.color_format = EB_YUV420;
+    }
+};
+
+/** What the analysis of the segments leaves in the picture */
+struct AnalysisResult {
+    std::vector<uint16_t> variance;
+    std::vector<uint8_t> y_mean;
+    std::vector<uint8_t> cb_mean;
+    std::vector<uint8_t> cr_mean;
+    int32_t sc_block_count;
+    int32_t sc_tested_area;
+    std::vector<uint8_t> quarter;
+    std::vector<uint8_t> sixteenth;
+};
+
+/**
+ * @brief Each test gets a random 8 bit picture, some 16x16 blocks of two
+ * colors so the screen content counts are not zero, and the SB arrays of
+ * the parent picture control set, allocated from its own memory arena.
+ */
+class PictureAnalysisSegmentTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        setup_rtcd_flags(HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_AVX | HAS_AVX2);
+
+        memset(&scs_, 0, sizeof(scs_));
+        memset(&ppcs_, 0, sizeof(ppcs_));
+
+        scs_.static_config.encoder_bit_depth = 8;
+        scs_.luma_width = width;
+        scs_.luma_height = height;
+        scs_.sb_sz = sb_size;
+        scs_.input_resolution = INPUT_SIZE_576p_RANGE_OR_LOWER;
+        scs_.block_mean_calc_prec = BLOCK_MEAN_PREC_FULL;
+        scs_.sc_detection_mode = SC_DETECTION_FULL;
+        ASSERT_EQ(sb_params_init(&scs_), EB_ErrorNone);
+
+        ppcs_.sb_total_count = (uint16_t)sb_count;
+        ppcs_.enable_hme_flag = EB_TRUE;
+        ppcs_.enable_hme_level0_flag = EB_TRUE;
+        ppcs_.enable_hme_level1_flag = EB_TRUE;
+        variance_.resize(sb_count);
+        y_mean_.resize(sb_count);
+        cb_mean_.resize(sb_count);
+        cr_mean_.resize(sb_count);
+        for (uint32_t i = 0; i < sb_count; i++) {
+            variance_[i].resize(MAX_ME_PU_COUNT);
+            y_mean_[i].resize(MAX_ME_PU_COUNT);
+            cb_mean_[i].resize(21);
+            cr_mean_[i].resize(21);
+            variance_ptr_.push_back(variance_[i].data());
+            y_mean_ptr_.push_back(y_mean_[i].data());
+            cb_mean_ptr_.push_back(cb_mean_[i].data());
+            cr_mean_ptr_.push_back(cr_mean_[i].data());
+        }
+        ppcs_.variance = variance_ptr_.data();
+        ppcs_.y_mean = y_mean_ptr_.data();
+        ppcs_.cbMean = cb_mean_ptr_.data();
+        ppcs_.crMean = cr_mean_ptr_.data();
+
+        make_pictures();
+    }
+
+    void TearDown() override {
+        eb_memory_arena_dtor(arena_);
+    }
+
+    void make_pictures() {
+        SVTRandom rnd(0, 255);
+        SVTRandom rnd_block(0, 2);
+
+        input_.alloc(width, height, border);
+        padded_.alloc(padded_width, padded_height, border);
+        for (size_t i = 0; i < input_.buf.size(); i++)
+            input_.buf[i] = (uint8_t)rnd.random();
+
+        // One 16x16 block out of three of two colors
+        for (uint32_t y = 0; y < padded_height; y += 16) {
+            for (uint32_t x = 0; x < padded_width; x += 16) {
+                const bool two_colors = rnd_block.random() == 0;
+                const uint8_t colors[2] = {(uint8_t)rnd.random(),
+                                           (uint8_t)rnd.random()};
+                for (uint32_t j = 0; j < 16; j++) {
+                    uint8_t *row = padded_.desc.buffer_y +
+                        (padded_.desc.origin_y + y + j) * padded_.desc.stride_y +
+                        padded_.desc.origin_x + x;
+                    for (uint32_t i = 0; i < 16; i++) {
+                        row[i] = two_colors ? colors[(i ^ j) & 1]
+                                            : (uint8_t)rnd.random();
+                    }
+                }
+            }
+        }
+
+        ppcs_.enhanced_picture_ptr = &input_.desc;
+        ppcs_.chroma_downsampled_picture_ptr = &input_.desc;
+    }
+
+    /** Analyzes the picture in segment_count segments, claimed by
+     * thread_count threads, from clean decimated pictures */
+    AnalysisResult analyze(uint16_t segment_count, int32_t threads_used) {
+        std::vector<std::thread> threads;
+        volatile int32_t last_segment_count = 0;
+        AnalysisResult result;
+
+        quarter_.alloc(padded_width >> 1, padded_height >> 1, border >> 1);
+        sixteenth_.alloc(padded_width >> 2, padded_height >> 2, border >> 2);
+        for (uint32_t i = 0; i < sb_count; i++) {
+            memset(variance_[i].data(), 0, MAX_ME_PU_COUNT * sizeof(uint16_t));
+            memset(y_mean_[i].data(), 0, MAX_ME_PU_COUNT);
+            memset(cb_mean_[i].data(), 0xFF, 21);
+            memset(cr_mean_[i].data(), 0xFF, 21);
+        }
+
+        ppcs_.pa_segments_row_count = segment_count;
+        eb_atomic_store_32(&ppcs_.pa_next_segment, 0);
+        eb_atomic_store_32(&ppcs_.pa_done_segment_count, 0);
+        eb_atomic_store_32(&ppcs_.sc_block_count, 0);
+        eb_atomic_store_32(&ppcs_.sc_tested_area, 0);
+
+        for (int32_t i = 0; i < threads_used; i++) {
+            threads.push_back(std::thread([this, &last_segment_count]() {
+                if (AnalyzePictureSegments(&scs_,
+                                           &ppcs_,
+                                           &padded_.desc,
+                                           &quarter_.desc,
+                                           &sixteenth_.desc,
+                                           sb_cols,
+                                           sb_rows,
+                                           ASM_AVX2))
+                    eb_atomic_fetch_add_32(&last_segment_count, 1);
+            }));
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+        EXPECT_EQ(last_segment_count, 1) << "threads ending the analysis";
+
+        for (uint32_t i = 0; i < sb_count; i++) {
+            result.variance.insert(result.variance.end(),
+                                   variance_[i].begin(),
+                                   variance_[i].end());
+            result.y_mean.insert(
+                result.y_mean.end(), y_mean_[i].begin(), y_mean_[i].end());
+            result.cb_mean.insert(
+                result.cb_mean.end(), cb_mean_[i].begin(), cb_mean_[i].end());
+            result.cr_mean.insert(
+                result.cr_mean.end(), cr_mean_[i].begin(), cr_mean_[i].end());
+        }
+        result.sc_block_count = eb_atomic_load_32(&ppcs_.sc_block_count);
+        result.sc_tested_area = eb_atomic_load_32(&ppcs_.sc_tested_area);
+        result.quarter = quarter_.buf;
+        result.sixteenth = sixteenth_.buf;
+        return result;
+    }
+
+    static void check_equal(const AnalysisResult &ref,
+                            const AnalysisResult &tst) {
+        EXPECT_TRUE(ref.variance == tst.variance) << "variance";
+        EXPECT_TRUE(ref.y_mean == tst.y_mean) << "luma mean";
+        EXPECT_TRUE(ref.cb_mean == tst.cb_mean) << "Cb mean";
+        EXPECT_TRUE(ref.cr_mean == tst.cr_mean) << "Cr mean";
+        EXPECT_EQ(ref.sc_block_count, tst.sc_block_count);
+        EXPECT_EQ(ref.sc_tested_area, tst.sc_tested_area);
+        EXPECT_TRUE(ref.quarter == tst.quarter) << "1/4 decimated picture";
+        EXPECT_TRUE(ref.sixteenth == tst.sixteenth)
+            << "1/16 decimated picture";
+    }
+
+    EbMemoryArena *arena_;
+    SequenceControlSet scs_;
+    PictureParentControlSet_t ppcs_;
+    Picture input_;
+    Picture padded_;
+    Picture quarter_;
+    Picture sixteenth_;
+    std::vector<std::vector<uint16_t>> variance_;
+    std::vector<std::vector<uint8_t>> y_mean_;
+    std::vector<std::vector<uint8_t>> cb_mean_;
+    std::vector<std::vector<uint8_t>> cr_mean_;
+    std::vector<uint16_t *> variance_ptr_;
+    std::vector<uint8_t *> y_mean_ptr_;
+    std::vector<uint8_t *> cb_mean_ptr_;
+    std::vector<uint8_t *> cr_mean_ptr_;
+};
+
+/**
+ * @brief Every segment count from one per picture to one per SB row, on one
+ * thread and on several, matches the single segment of the serial path.
+ */
+TEST_F(PictureAnalysisSegmentTest, segments_match_serial) {
+    const AnalysisResult ref = analyze(1, 1);
+
+    ASSERT_GT(ref.sc_block_count, 0) << "no screen content block";
+    ASSERT_EQ(ref.sc_tested_area, (int32_t)(width * height));
+
+    for (uint16_t segments = 1; segments <= sb_rows; segments++) {
+        SCOPED_TRACE(testing::Message() << segments << " segments");
+        check_equal(ref, analyze(segments, 1));
+        check_equal(ref, analyze(segments, thread_count));
+    }
+}
+
+/**
+ * @brief With the screen content detection sampled on every other SB, the
+ * counts of the segments add up to the ones of the serial path.
+ */
+TEST_F(PictureAnalysisSegmentTest, sampled_detection_matches_serial) {
+    scs_.sc_detection_mode = SC_DETECTION_SAMPLED;
+    const AnalysisResult ref = analyze(1, 1);
+
+    for (int32_t run = 0; run < 10; run++) {
+        check_equal(ref, analyze(sb_rows, thread_count));
+        check_equal(ref, analyze(2, thread_count));
+    }
+}
+
+}  // namespace PictureAnalysisSegmentTest
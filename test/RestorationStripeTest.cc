@@ -0,0 +1,337 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file RestorationStripeTest.cc
+ *
+ * @brief Unit test of the loop restoration by processing stripe rows:
+ * - stripe rows filtered and copied back in any order, on several threads,
+ *   match the serial av1_loop_restoration_filter_frame(), for 8 and 10 bit
+ * - the padding of a picture by stripe rows matches generate_padding() and
+ *   generate_padding16_bit()
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbEncDecSegments.h"
+#include "EbMcp.h"
+#include "EbMemoryArena.h"
+#include "EbPictureControlSet.h"
+#include "EbRestoration.h"
+#include "aom_dsp_rtcd.h"
+#include "random.h"
+
+/* Defined in EbPictureBufferDesc.c and EbRestoration.c */
+extern "C" {
+int32_t aom_realloc_frame_buffer(Yv12BufferConfig *ybf, int32_t width,
+                                 int32_t height, int32_t ss_x, int32_t ss_y,
+                                 int32_t use_highbitdepth, int32_t border,
+                                 int32_t byte_alignment,
+                                 aom_codec_frame_buffer_t *fb,
+                                 aom_get_frame_buffer_cb_fn_t cb,
+                                 void *cb_priv);
+EbErrorType av1_alloc_restoration_buffers(Av1Common *cm);
+void av1_loop_restoration_save_boundary_lines(const Yv12BufferConfig *frame,
+                                              Av1Common *cm,
+                                              int32_t after_cdef);
+void av1_loop_restoration_filter_frame(Yv12BufferConfig *frame, Av1Common *cm,
+                                       int32_t optimized_lr);
+int32_t av1_loop_restoration_stripe_row_count(const Av1Common *cm);
+EbErrorType av1_loop_restoration_filter_frame_init(Yv12BufferConfig *frame,
+                                                   Av1Common *cm,
+                                                   int32_t optimized_lr);
+void av1_loop_restoration_filter_stripe_row(Yv12BufferConfig *frame,
+                                            Av1Common *cm,
+                                            Yv12BufferConfig *work,
+                                            int32_t *tmpbuf,
+                                            int32_t stripe_row);
+void av1_loop_restoration_copy_stripe_row(Yv12BufferConfig *frame,
+                                          Av1Common *cm, int32_t stripe_row);
+}
+
+using svt_av1_test_tool::SVTRandom;
+
+namespace RestorationStripeTest {
+
+// 4 stripe rows, the last one partial, and units of 64 luma samples that
+// straddle the stripe rows in chroma
+const int32_t width = 296;
+const int32_t height = 216;
+const int32_t thread_count = 4;
+
+/**
+ * @brief Each test gets a picture with random samples and random Wiener and
+ * self-guided units, allocated from its own memory arena.
+ */
+class RestorationStripeTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_EQ(eb_memory_arena_ctor(&arena_), EB_ErrorNone);
+        eb_memory_arena_set_current(arena_);
+        setup_rtcd_flags(HAS_MMX | HAS_SSE | HAS_SSE2 | HAS_AVX | HAS_AVX2);
+
+        memset(&cm_, 0, sizeof(cm_));
+        memset(&input_, 0, sizeof(input_));
+        memset(&ref_, 0, sizeof(ref_));
+        memset(&tst_, 0, sizeof(tst_));
+    }
+
+    void TearDown() override {
+        eb_memory_arena_dtor(arena_);
+    }
+
+    /** Sets up the frame, its units and its saved boundary lines */
+    void make_frame(int32_t bit_depth) {
+        cm_.width = width;
+        cm_.height = height;
+        cm_.superres_upscaled_width = width;
+        cm_.superres_upscaled_height = height;
+        cm_.mi_cols = width >> MI_SIZE_LOG2;
+        cm_.mi_rows = height >> MI_SIZE_LOG2;
+        cm_.subsampling_x = 1;
+        cm_.subsampling_y = 1;
+        cm_.bit_depth = bit_depth;
+        cm_.use_highbitdepth = bit_depth > 8;
+        cm_.rst_info[0].restoration_unit_size = RESTORATION_UNITSIZE_MAX >> 2;
+        cm_.rst_info[1].restoration_unit_size = RESTORATION_UNITSIZE_MAX >> 2;
+        cm_.rst_info[2].restoration_unit_size = RESTORATION_UNITSIZE_MAX >> 2;
+        ASSERT_EQ(av1_alloc_restoration_buffers(&cm_), EB_ErrorNone);
+
+        alloc_frame(&input_);
+        alloc_frame(&ref_);
+        alloc_frame(&tst_);
+        fill_frame(&input_, bit_depth);
+
+        for (int32_t plane = 0; plane < 3; plane++)
+            make_units(&cm_.rst_info[plane]);
+
+        // The deblocked and the CDEF lines, both taken from the input here
+        av1_loop_restoration_save_boundary_lines(&input_, &cm_, 0);
+        av1_loop_restoration_save_boundary_lines(&input_, &cm_, 1);
+    }
+
+    void alloc_frame(Yv12BufferConfig *frame) {
+        ASSERT_EQ(aom_realloc_frame_buffer(frame,
+                                           width,
+                                           height,
+                                           cm_.subsampling_x,
+                                           cm_.subsampling_y,
+                                           cm_.use_highbitdepth,
+                                           AOM_BORDER_IN_PIXELS,
+                                           cm_.byte_alignment,
+                                           NULL,
+                                           NULL,
+                                           NULL),
+                  0);
+    }
+
+    /** Random samples over the whole buffer, borders included */
+    static void fill_frame(Yv12BufferConfig *frame, int32_t bit_depth) {
+        SVTRandom rnd(0, (1 << bit_depth) - 1);
+
+        if (bit_depth > 8) {
+            uint16_t *buf = (uint16_t *)frame->buffer_alloc;
+            for (size_t i = 0; i < frame->buffer_alloc_sz / 2; i++)
+                buf[i] = (uint16_t)rnd.random();
+        } else {
+            for (size_t i = 0; i < frame->buffer_alloc_sz; i++)
+                frame->buffer_alloc[i] = (uint8_t)rnd.random();
+        }
+    }
+
+    static void copy_frame(const Yv12BufferConfig *src,
+                           Yv12BufferConfig *dst) {
+        memcpy(dst->buffer_alloc, src->buffer_alloc, src->buffer_alloc_sz);
+    }
+
+    static bool frames_match(const Yv12BufferConfig *a,
+                             const Yv12BufferConfig *b) {
+        return memcmp(a->buffer_alloc, b->buffer_alloc, a->buffer_alloc_sz) ==
+               0;
+    }
+
+    /** Switchable units, each unfiltered, Wiener or self-guided with random
+     * taps and projections */
+    static void make_units(RestorationInfo *rsi) {
+        SVTRandom rnd_type(RESTORE_NONE, RESTORE_SGRPROJ);
+        SVTRandom rnd_tap0(WIENER_FILT_TAP0_MINV, WIENER_FILT_TAP0_MAXV);
+        SVTRandom rnd_tap1(WIENER_FILT_TAP1_MINV, WIENER_FILT_TAP1_MAXV);
+        SVTRandom rnd_tap2(WIENER_FILT_TAP2_MINV, WIENER_FILT_TAP2_MAXV);
+        SVTRandom rnd_ep(0, SGRPROJ_PARAMS - 1);
+        SVTRandom rnd_xqd0(SGRPROJ_PRJ_MIN0, SGRPROJ_PRJ_MAX0);
+        SVTRandom rnd_xqd1(SGRPROJ_PRJ_MIN1, SGRPROJ_PRJ_MAX1);
+
+        rsi->frame_restoration_type = RESTORE_SWITCHABLE;
+        for (int32_t i = 0; i < rsi->units_per_tile; i++) {
+            RestorationUnitInfo *rui = &rsi->unit_info[i];
+            InterpKernel *filters[2] = {&rui->wiener_info.vfilter,
+                                        &rui->wiener_info.hfilter};
+
+            rui->restoration_type = (RestorationType)rnd_type.random();
+            for (InterpKernel *filter : filters) {
+                int16_t *taps = *filter;
+                taps[0] = taps[6] = (int16_t)rnd_tap0.random();
+                taps[1] = taps[5] = (int16_t)rnd_tap1.random();
+                taps[2] = taps[4] = (int16_t)rnd_tap2.random();
+                taps[3] = (int16_t)(-2 * (taps[0] + taps[1] + taps[2]));
+                taps[7] = 0;
+            }
+            rui->sgrproj_info.ep = rnd_ep.random();
+            rui->sgrproj_info.xqd[0] = rnd_xqd0.random();
+            rui->sgrproj_info.xqd[1] = rnd_xqd1.random();
+        }
+    }
+
+    /** Runs the stripe rows claimed from a row sync on several threads, as the
+     * rest threads do, with a trial frame and a buffer per thread */
+    void run_rows_in_parallel(bool filter) {
+        const uint32_t row_count =
+            (uint32_t)av1_loop_restoration_stripe_row_count(&cm_);
+        SbRowSync_t *row_sync;
+        std::vector<std::thread> threads;
+        Yv12BufferConfig work[thread_count];
+        std::vector<int32_t> tmpbuf[thread_count];
+
+        ASSERT_EQ(SbRowSyncCtor(&row_sync, row_count), EB_ErrorNone);
+        SbRowSyncInit(row_sync, row_count, 1);
+        row_sync->readyRowCount = row_count;
+
+        for (int32_t i = 0; i < thread_count; i++) {
+            memset(&work[i], 0, sizeof(work[i]));
+            alloc_frame(&work[i]);
+            tmpbuf[i].resize(RESTORATION_TMPBUF_SIZE / sizeof(int32_t));
+        }
+        for (int32_t i = 0; i < thread_count; i++) {
+            threads.push_back(std::thread([&, i]() {
+                uint32_t stripe_row;
+                while (SbRowSyncClaimRow(row_sync, &stripe_row) == EB_TRUE) {
+                    if (filter) {
+                        av1_loop_restoration_filter_stripe_row(
+                            &tst_,
+                            &cm_,
+                            &work[i],
+                            tmpbuf[i].data(),
+                            (int32_t)stripe_row);
+                    } else {
+                        av1_loop_restoration_copy_stripe_row(
+                            &tst_, &cm_, (int32_t)stripe_row);
+                    }
+                    SbRowSyncCompleteRow(row_sync);
+                }
+            }));
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+        EXPECT_EQ(row_sync->doneRowCount, row_count);
+    }
+
+    void run_filter_test(int32_t bit_depth) {
+        make_frame(bit_depth);
+
+        copy_frame(&input_, &ref_);
+        cm_.frame_to_show = &ref_;
+        av1_loop_restoration_filter_frame(&ref_, &cm_, 0);
+        ASSERT_FALSE(frames_match(&input_, &ref_)) << "no unit filtered";
+
+        copy_frame(&input_, &tst_);
+        cm_.frame_to_show = &tst_;
+        ASSERT_EQ(av1_loop_restoration_filter_frame_init(&tst_, &cm_, 0),
+                  EB_ErrorNone);
+        run_rows_in_parallel(true);
+        run_rows_in_parallel(false);
+        EXPECT_TRUE(frames_match(&ref_, &tst_));
+    }
+
+    EbMemoryArena *arena_;
+    Av1Common cm_;
+    Yv12BufferConfig input_;
+    Yv12BufferConfig ref_;
+    Yv12BufferConfig tst_;
+};
+
+TEST_F(RestorationStripeTest, stripe_rows_match_frame_filter) {
+    run_filter_test(8);
+}
+
+TEST_F(RestorationStripeTest, stripe_rows_match_frame_filter_10bit) {
+    run_filter_test(10);
+}
+
+/**
+ * @brief Padding the rows of the stripe rows of a picture, from the bottom
+ * up as the rest threads may, gives the padding of the whole picture.
+ */
+TEST(RestorationPaddingTest, stripe_rows_match_picture_padding) {
+    const uint32_t pad = 32;
+    const uint32_t pic_width = width >> 1;
+    const uint32_t pic_height = height >> 1;
+    const uint32_t stride = pic_width + 2 * pad;
+    const uint32_t row_count = (height + RESTORATION_UNIT_OFFSET +
+                                RESTORATION_PROC_UNIT_SIZE - 1) /
+                               RESTORATION_PROC_UNIT_SIZE;
+    SVTRandom rnd(0, 1023);
+
+    for (int32_t is16bit = 0; is16bit < 2; is16bit++) {
+        const uint32_t shift = is16bit;
+        std::vector<uint8_t> input((stride * (pic_height + 2 * pad)) << shift);
+        std::vector<uint8_t> ref, tst;
+
+        for (size_t i = 0; i < input.size(); i++)
+            input[i] = (uint8_t)rnd.random();
+
+        ref = input;
+        if (is16bit) {
+            generate_padding16_bit(ref.data(),
+                                   stride << 1,
+                                   pic_width << 1,
+                                   pic_height,
+                                   pad << 1,
+                                   pad);
+        } else {
+            generate_padding(
+                ref.data(), stride, pic_width, pic_height, pad, pad);
+        }
+        ASSERT_FALSE(ref == input);
+
+        // The chroma rows of the stripe rows, as rest_copy_stripe_row() pads
+        tst = input;
+        for (uint32_t i = 0; i < row_count; i++) {
+            const int32_t stripe_start =
+                (int32_t)(row_count - 1 - i) * RESTORATION_PROC_UNIT_SIZE -
+                RESTORATION_UNIT_OFFSET;
+            const uint32_t row_start = (uint32_t)AOMMAX(0, stripe_start);
+            const uint32_t row_end = (uint32_t)AOMMIN(
+                height, stripe_start + RESTORATION_PROC_UNIT_SIZE);
+
+            generate_padding_rows(tst.data(),
+                                  stride << shift,
+                                  pic_width << shift,
+                                  pic_height,
+                                  pad << shift,
+                                  pad,
+                                  row_start >> 1,
+                                  row_end >> 1,
+                                  (EbBool)is16bit);
+        }
+        EXPECT_TRUE(ref == tst) << (is16bit ? "16 bit" : "8 bit");
+    }
+}
+
+}  // namespace RestorationStripeTest
@@ -0,0 +1,118 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file ScreenContentTest.cc
+ *
+ * @brief Unit test for the color count of the screen content detection:
+ * - eb_count_colors_16x16_avx2
+ * - eb_count_colors_16x16_highbd_avx2
+ *
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "gtest/gtest.h"
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+#include "random.h"
+
+namespace {
+
+using svt_av1_test_tool::SVTRandom;
+
+const int kBlockSize = 16;
+const int kStride = 40;
+const uint32_t kLimit = 4;
+
+/**
+ * @brief Unit test for eb_count_colors_16x16_avx2 and
+ * eb_count_colors_16x16_highbd_avx2
+ *
+ * Test strategy:
+ * Fill 16x16 blocks with 1 to 8 colors picked from a small palette, at
+ * random positions, and count the colors with the C and AVX2 functions.
+ *
+ * Expect result:
+ * The counts are the same, and equal the number of colors up to the
+ * limit, limit + 1 above.
+ *
+ * Test cases:
+ * - CountColorsTest.MatchC
+ * - CountColorsTest.MatchC_HighBitDepth
+ */
+class CountColorsTest : public ::testing::Test {
+  protected:
+    // Fills the block with color_count distinct colors, each used at least
+    // once. With share_8bit, up to 4 colors differ by the 2-bit
+    // increment only.
+    void fill_block(SVTRandom &rnd, int color_count, bool share_8bit) {
+        uint8_t palette[8];
+        uint8_t palette_bit_inc[8];
+
+        memset(src_, 0, sizeof(src_));
+        memset(src_bit_inc_, 0, sizeof(src_bit_inc_));
+        for (int i = 0; i < color_count; ++i) {
+            palette[i] = (uint8_t)(rnd.random() & 0xF8) |
+                         (uint8_t)(share_8bit ? i >> 2 : i);
+            palette_bit_inc[i] = (uint8_t)((i & 3) << 6);
+        }
+        for (int y = 0; y < kBlockSize; ++y) {
+            for (int x = 0; x < kBlockSize; ++x) {
+                const int pos = y * kBlockSize + x;
+                const int i = pos < color_count ? pos
+                                                : rnd.random() % color_count;
+                src_[y * kStride + x] = palette[i];
+                src_bit_inc_[y * kStride + x] = palette_bit_inc[i];
+            }
+        }
+    }
+
+    uint8_t src_[kBlockSize * kStride];
+    uint8_t src_bit_inc_[kBlockSize * kStride];
+};
+
+TEST_F(CountColorsTest, MatchC) {
+    SVTRandom rnd(0, 255);
+    for (int color_count = 1; color_count <= 8; ++color_count) {
+        for (int i = 0; i < 100; ++i) {
+            fill_block(rnd, color_count, false);
+            const uint32_t count_ref =
+                eb_count_colors_16x16_c(src_, kStride, kLimit);
+            const uint32_t count_test =
+                eb_count_colors_16x16_avx2(src_, kStride, kLimit);
+            ASSERT_EQ(count_ref, count_test);
+            ASSERT_EQ(count_ref, AOMMIN((uint32_t)color_count, kLimit + 1));
+        }
+    }
+}
+
+TEST_F(CountColorsTest, MatchC_HighBitDepth) {
+    SVTRandom rnd(0, 255);
+    for (int color_count = 1; color_count <= 8; ++color_count) {
+        for (int i = 0; i < 100; ++i) {
+            fill_block(rnd, color_count, true);
+            const uint32_t count_ref = eb_count_colors_16x16_highbd_c(
+                src_, kStride, src_bit_inc_, kStride, kLimit);
+            const uint32_t count_test = eb_count_colors_16x16_highbd_avx2(
+                src_, kStride, src_bit_inc_, kStride, kLimit);
+            ASSERT_EQ(count_ref, count_test);
+            ASSERT_EQ(count_ref, AOMMIN((uint32_t)color_count, kLimit + 1));
+        }
+    }
+}
+
+}  // namespace
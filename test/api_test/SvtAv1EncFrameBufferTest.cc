@@ -0,0 +1,247 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file SvtAv1EncFrameBufferTest.cc
+ *
+ * @brief SVT-AV1 encoder api test, check the input frames allocated by the
+ * application through eb_svt_enc_set_frame_buffer_callbacks
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+const uint32_t frame_width = 128;
+const uint32_t frame_height = 128;
+const uint32_t frame_count = 8;
+
+/** FrameBufferCount counts the frames handed out and given back by the
+ * encoder, as the private data of the callbacks */
+typedef struct {
+    uint32_t allocated;
+    uint32_t released;
+} FrameBufferCount;
+
+static int allocate_frame_buffer(EbExtFrameBuf *frame_buf, uint32_t min_size,
+                                 void *private_data) {
+    FrameBufferCount *count = (FrameBufferCount *)private_data;
+
+    frame_buf->buffer = (uint8_t *)malloc(min_size);
+    if (frame_buf->buffer == nullptr)
+        return -1;
+    frame_buf->buffer_size = min_size;
+    frame_buf->private_data = nullptr;
+    count->allocated++;
+    return 0;
+}
+
+static int release_frame_buffer(EbExtFrameBuf *frame_buf, void *private_data) {
+    FrameBufferCount *count = (FrameBufferCount *)private_data;
+
+    free(frame_buf->buffer);
+    count->released++;
+    return 0;
+}
+
+/** Writes a different gradient in each frame, at the strides of the frame */
+static void fill_frame(EbSvtIOFormat *frame, uint32_t frame_index) {
+    for (uint32_t y = 0; y < frame_height; ++y) {
+        for (uint32_t x = 0; x < frame_width; ++x)
+            frame->luma[y * frame->y_stride + x] =
+                (uint8_t)(x * 3 + y * 5 + frame_index * 7);
+    }
+    for (uint32_t y = 0; y < frame_height / 2; ++y) {
+        for (uint32_t x = 0; x < frame_width / 2; ++x) {
+            frame->cb[y * frame->cb_stride + x] =
+                (uint8_t)(128 + x - y + frame_index);
+            frame->cr[y * frame->cr_stride + x] =
+                (uint8_t)(128 - x + y - frame_index);
+        }
+    }
+}
+
+/** Encodes frame_count frames, copied by the encoder or referenced from
+ * frames allocated through the callbacks, and returns the bitstream */
+static void encode_frames(bool external_frames, FrameBufferCount *count,
+                          std::vector<uint8_t> &bitstream) {
+    SvtAv1Context context = {0};
+    std::vector<uint8_t> planes(frame_width * frame_height * 3 / 2);
+    EbSvtIOFormat frame;
+    EbBufferHeaderType input_buffer;
+
+    ASSERT_EQ(EB_ErrorNone,
+              eb_init_handle(&context.enc_handle, &context,
+                             &context.enc_params));
+    context.enc_params.source_width = frame_width;
+    context.enc_params.source_height = frame_height;
+    context.enc_params.enc_mode = MAX_ENC_PRESET;
+    ASSERT_EQ(EB_ErrorNone, eb_svt_enc_set_parameter(context.enc_handle,
+                                                     &context.enc_params));
+    if (external_frames) {
+        ASSERT_EQ(EB_ErrorNone,
+                  eb_svt_enc_set_frame_buffer_callbacks(context.enc_handle,
+                                                        allocate_frame_buffer,
+                                                        release_frame_buffer,
+                                                        count));
+    }
+    ASSERT_EQ(EB_ErrorNone, eb_init_encoder(context.enc_handle));
+
+    // The callbacks cannot change once the input buffers are constructed
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_set_frame_buffer_callbacks(context.enc_handle,
+                                                    allocate_frame_buffer,
+                                                    release_frame_buffer,
+                                                    count));
+
+    for (uint32_t frame_index = 0; frame_index < frame_count; ++frame_index) {
+        if (external_frames) {
+            ASSERT_EQ(EB_ErrorNone, eb_svt_enc_allocate_input_frame(
+                                        context.enc_handle, &frame));
+        } else {
+            memset(&frame, 0, sizeof(frame));
+            frame.luma = planes.data();
+            frame.cb = frame.luma + frame_width * frame_height;
+            frame.cr = frame.cb + frame_width * frame_height / 4;
+            frame.y_stride = frame_width;
+            frame.cb_stride = frame_width / 2;
+            frame.cr_stride = frame_width / 2;
+            frame.width = frame_width;
+            frame.height = frame_height;
+        }
+        fill_frame(&frame, frame_index);
+
+        memset(&input_buffer, 0, sizeof(input_buffer));
+        input_buffer.size = sizeof(EbBufferHeaderType);
+        input_buffer.p_buffer = (uint8_t *)&frame;
+        input_buffer.n_filled_len = frame_width * frame_height * 3 / 2;
+        input_buffer.pts = frame_index;
+        input_buffer.pic_type = EB_AV1_INVALID_PICTURE;
+        ASSERT_EQ(EB_ErrorNone,
+                  eb_svt_enc_send_picture(context.enc_handle, &input_buffer));
+    }
+
+    memset(&input_buffer, 0, sizeof(input_buffer));
+    input_buffer.flags = EB_BUFFERFLAG_EOS;
+    input_buffer.pic_type = EB_AV1_INVALID_PICTURE;
+    ASSERT_EQ(EB_ErrorNone,
+              eb_svt_enc_send_picture(context.enc_handle, &input_buffer));
+
+    for (;;) {
+        EbBufferHeaderType *output_buffer = nullptr;
+        EbErrorType return_error =
+            eb_svt_get_packet(context.enc_handle, &output_buffer, 1);
+        ASSERT_NE(EB_ErrorMax, return_error);
+        if (return_error == EB_NoErrorEmptyQueue || output_buffer == nullptr)
+            continue;
+
+        EbBool eos = (EbBool)(output_buffer->flags & EB_BUFFERFLAG_EOS);
+        bitstream.insert(bitstream.end(),
+                         output_buffer->p_buffer,
+                         output_buffer->p_buffer + output_buffer->n_filled_len);
+        eb_svt_release_out_buffer(&output_buffer);
+        if (eos)
+            break;
+    }
+
+    EXPECT_EQ(EB_ErrorNone, eb_deinit_encoder(context.enc_handle));
+    EXPECT_EQ(EB_ErrorNone, eb_deinit_handle(context.enc_handle));
+}
+
+/** @brief check_callback_parameters is a api test case
+ * EncApiTest.check_callback_parameters checks the parameters of
+ * eb_svt_enc_set_frame_buffer_callbacks and eb_svt_enc_allocate_input_frame
+ *
+ * Test strategy: <br>
+ * Set missing callbacks, allocate a frame before eb_init_encoder and request
+ * unpacked 10 bit input with the callbacks set.
+ *
+ * Expected result: <br>
+ * Every call reports EB_ErrorBadParameter and no frame is allocated.
+ *
+ * Test coverage:
+ * eb_svt_enc_set_frame_buffer_callbacks, eb_svt_enc_allocate_input_frame.
+ */
+TEST(EncApiTest, check_callback_parameters) {
+    SvtAv1Context context = {0};
+    FrameBufferCount count = {0, 0};
+    EbSvtIOFormat frame;
+
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_set_frame_buffer_callbacks(
+                  nullptr, allocate_frame_buffer, release_frame_buffer, &count));
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_allocate_input_frame(nullptr, &frame));
+
+    ASSERT_EQ(EB_ErrorNone,
+              eb_init_handle(&context.enc_handle, &context,
+                             &context.enc_params));
+    context.enc_params.source_width = frame_width;
+    context.enc_params.source_height = frame_height;
+    context.enc_params.encoder_bit_depth = 10;
+    context.enc_params.compressed_ten_bit_format = 0;
+    ASSERT_EQ(EB_ErrorNone, eb_svt_enc_set_parameter(context.enc_handle,
+                                                     &context.enc_params));
+
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_set_frame_buffer_callbacks(
+                  context.enc_handle, nullptr, release_frame_buffer, &count));
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_set_frame_buffer_callbacks(
+                  context.enc_handle, allocate_frame_buffer, nullptr, &count));
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_allocate_input_frame(context.enc_handle, &frame));
+
+    // Unpacked 10 bit input is split into the library buffers
+    EXPECT_EQ(EB_ErrorNone,
+              eb_svt_enc_set_frame_buffer_callbacks(context.enc_handle,
+                                                    allocate_frame_buffer,
+                                                    release_frame_buffer,
+                                                    &count));
+    EXPECT_EQ(EB_ErrorBadParameter, eb_init_encoder(context.enc_handle));
+
+    EXPECT_EQ(EB_ErrorNone, eb_deinit_handle(context.enc_handle));
+    EXPECT_EQ(0u, count.allocated);
+}
+
+/** @brief external_frames_match_copy is a api test case
+ * EncApiTest.external_frames_match_copy encodes the same frames copied by
+ * the encoder and referenced from frames allocated by the application
+ *
+ * Test strategy: <br>
+ * Encode frame_count frames with each input path and compare the
+ * bitstreams, then count the frames given back through release_buffer.
+ *
+ * Expected result: <br>
+ * The bitstreams are identical and every allocated frame is released once.
+ *
+ * Test coverage:
+ * eb_svt_enc_set_frame_buffer_callbacks, eb_svt_enc_allocate_input_frame,
+ * eb_svt_enc_send_picture.
+ */
+TEST(EncApiTest, external_frames_match_copy) {
+    FrameBufferCount copy_count = {0, 0};
+    FrameBufferCount external_count = {0, 0};
+    std::vector<uint8_t> copy_bitstream;
+    std::vector<uint8_t> external_bitstream;
+
+    encode_frames(false, &copy_count, copy_bitstream);
+    encode_frames(true, &external_count, external_bitstream);
+
+    EXPECT_EQ(0u, copy_count.allocated);
+    EXPECT_EQ(frame_count, external_count.allocated);
+    EXPECT_EQ(external_count.allocated, external_count.released);
+    ASSERT_FALSE(copy_bitstream.empty());
+    EXPECT_TRUE(copy_bitstream == external_bitstream);
+}
+
+}  // namespace
@@ -0,0 +1,292 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file SvtAv1EncMemoryUsageTest.cc
+ *
+ * @brief SVT-AV1 encoder api test, check the memory reported by
+ * eb_svt_enc_get_memory_usage with and without lazy_pool_allocation
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <string.h>
+#include <vector>
+#include "EbSvtAv1Enc.h"
+#include "gtest/gtest.h"
+#include "SvtAv1EncApiTest.h"
+
+using namespace svt_av1_test;
+
+namespace {
+
+const uint32_t frame_width = 128;
+const uint32_t frame_height = 128;
+const uint32_t frame_count = 8;
+
+// Objects of each pool constructed by eb_init_encoder with
+// lazy_pool_allocation, LAZY_POOL_INIT_COUNT in EbEncHandle.c
+const uint32_t lazy_pool_init_count = 4;
+
+static void init_encoder(SvtAv1Context &context, bool lazy_pools) {
+    ASSERT_EQ(EB_ErrorNone,
+              eb_init_handle(&context.enc_handle, &context,
+                             &context.enc_params));
+    context.enc_params.source_width = frame_width;
+    context.enc_params.source_height = frame_height;
+    context.enc_params.enc_mode = MAX_ENC_PRESET;
+    context.enc_params.lazy_pool_allocation = lazy_pools ? EB_TRUE : EB_FALSE;
+    ASSERT_EQ(EB_ErrorNone, eb_svt_enc_set_parameter(context.enc_handle,
+                                                     &context.enc_params));
+    ASSERT_EQ(EB_ErrorNone, eb_init_encoder(context.enc_handle));
+}
+
+static void deinit_encoder(SvtAv1Context &context) {
+    EXPECT_EQ(EB_ErrorNone, eb_deinit_encoder(context.enc_handle));
+    EXPECT_EQ(EB_ErrorNone, eb_deinit_handle(context.enc_handle));
+}
+
+/** Sends frame_count gray frames and EOS, and drains the packets */
+static void encode_frames(SvtAv1Context &context) {
+    std::vector<uint8_t> planes(frame_width * frame_height * 3 / 2, 128);
+    EbSvtIOFormat frame;
+    EbBufferHeaderType input_buffer;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.luma = planes.data();
+    frame.cb = frame.luma + frame_width * frame_height;
+    frame.cr = frame.cb + frame_width * frame_height / 4;
+    frame.y_stride = frame_width;
+    frame.cb_stride = frame_width / 2;
+    frame.cr_stride = frame_width / 2;
+    frame.width = frame_width;
+    frame.height = frame_height;
+
+    for (uint32_t frame_index = 0; frame_index < frame_count; ++frame_index) {
+        // Vertical bars moving right, so the frames are not all skipped
+        for (uint32_t y = 0; y < frame_height; ++y) {
+            for (uint32_t x = 0; x < frame_width; ++x)
+                frame.luma[y * frame_width + x] =
+                    (uint8_t)(((x + 4 * frame_index) & 16) ? 200 : 50);
+        }
+
+        memset(&input_buffer, 0, sizeof(input_buffer));
+        input_buffer.size = sizeof(EbBufferHeaderType);
+        input_buffer.p_buffer = (uint8_t *)&frame;
+        input_buffer.n_filled_len = frame_width * frame_height * 3 / 2;
+        input_buffer.pts = frame_index;
+        input_buffer.pic_type = EB_AV1_INVALID_PICTURE;
+        ASSERT_EQ(EB_ErrorNone,
+                  eb_svt_enc_send_picture(context.enc_handle, &input_buffer));
+    }
+
+    memset(&input_buffer, 0, sizeof(input_buffer));
+    input_buffer.flags = EB_BUFFERFLAG_EOS;
+    input_buffer.pic_type = EB_AV1_INVALID_PICTURE;
+    ASSERT_EQ(EB_ErrorNone,
+              eb_svt_enc_send_picture(context.enc_handle, &input_buffer));
+
+    for (;;) {
+        EbBufferHeaderType *output_buffer = nullptr;
+        EbErrorType return_error =
+            eb_svt_get_packet(context.enc_handle, &output_buffer, 1);
+        ASSERT_NE(EB_ErrorMax, return_error);
+        if (return_error == EB_NoErrorEmptyQueue || output_buffer == nullptr)
+            continue;
+
+        EbBool eos = (EbBool)(output_buffer->flags & EB_BUFFERFLAG_EOS);
+        eb_svt_release_out_buffer(&output_buffer);
+        if (eos)
+            break;
+    }
+}
+
+/** Checks what holds for any report: the pools within their caps and
+ * committed by the instance, the types sorted biggest first */
+static void check_usage(const EbSvtMemoryUsage &usage) {
+    uint64_t pool_bytes = 0;
+
+    EXPECT_GT(usage.total_committed_bytes, 0u);
+    EXPECT_GE(usage.total_reserved_bytes, usage.total_committed_bytes);
+    ASSERT_GT(usage.pool_count, 0u);
+    ASSERT_LE(usage.pool_count, (uint32_t)EB_MAX_MEMORY_POOL_COUNT);
+    for (uint32_t i = 0; i < usage.pool_count; ++i) {
+        const EbMemoryPoolUsage &pool = usage.pool_array[i];
+
+        ASSERT_NE(pool.pool_name, nullptr);
+        EXPECT_LE(pool.object_count, pool.object_max_count) << pool.pool_name;
+        if (pool.object_count)
+            EXPECT_GT(pool.committed_bytes, 0u) << pool.pool_name;
+        pool_bytes += pool.committed_bytes;
+    }
+    EXPECT_LE(pool_bytes, usage.total_committed_bytes);
+
+    ASSERT_LE(usage.type_count, (uint32_t)EB_MAX_MEMORY_TYPE_COUNT);
+    for (uint32_t i = 1; i < usage.type_count; ++i) {
+        EXPECT_GE(usage.type_array[i - 1].committed_bytes,
+                  usage.type_array[i].committed_bytes)
+            << usage.type_array[i].type_name;
+    }
+}
+
+static const EbMemoryPoolUsage *find_pool(const EbSvtMemoryUsage &usage,
+                                          const char *pool_name) {
+    for (uint32_t i = 0; i < usage.pool_count; ++i) {
+        if (strcmp(usage.pool_array[i].pool_name, pool_name) == 0)
+            return &usage.pool_array[i];
+    }
+    return nullptr;
+}
+
+/** @brief check_memory_usage_parameters is a api test case
+ * EncApiTest.check_memory_usage_parameters checks the parameters of
+ * eb_svt_enc_get_memory_usage
+ *
+ * Test strategy: <br>
+ * Request the usage without a handle, without a report and before
+ * eb_init_encoder.
+ *
+ * Expected result: <br>
+ * Every call reports EB_ErrorBadParameter.
+ *
+ * Test coverage:
+ * eb_svt_enc_get_memory_usage.
+ */
+TEST(EncApiTest, check_memory_usage_parameters) {
+    SvtAv1Context context = {0};
+    EbSvtMemoryUsage usage;
+
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_get_memory_usage(nullptr, &usage));
+
+    ASSERT_EQ(EB_ErrorNone,
+              eb_init_handle(&context.enc_handle, &context,
+                             &context.enc_params));
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_get_memory_usage(context.enc_handle, nullptr));
+    EXPECT_EQ(EB_ErrorBadParameter,
+              eb_svt_enc_get_memory_usage(context.enc_handle, &usage));
+    EXPECT_EQ(EB_ErrorNone, eb_deinit_handle(context.enc_handle));
+}
+
+/** @brief eager_pools_are_full is a api test case
+ * EncApiTest.eager_pools_are_full checks the report of an encoder that
+ * constructs its pools at init
+ *
+ * Test strategy: <br>
+ * Request the usage after eb_init_encoder and after encoding frame_count
+ * frames, without lazy_pool_allocation.
+ *
+ * Expected result: <br>
+ * Every pool holds object_max_count objects and keeps its size.
+ *
+ * Test coverage:
+ * eb_svt_enc_get_memory_usage.
+ */
+TEST(EncApiTest, eager_pools_are_full) {
+    SvtAv1Context context = {0};
+    EbSvtMemoryUsage init_usage, usage;
+
+    init_encoder(context, false);
+    ASSERT_EQ(EB_ErrorNone,
+              eb_svt_enc_get_memory_usage(context.enc_handle, &init_usage));
+    check_usage(init_usage);
+    for (uint32_t i = 0; i < init_usage.pool_count; ++i) {
+        EXPECT_EQ(init_usage.pool_array[i].object_count,
+                  init_usage.pool_array[i].object_max_count)
+            << init_usage.pool_array[i].pool_name;
+    }
+
+    encode_frames(context);
+    ASSERT_EQ(EB_ErrorNone,
+              eb_svt_enc_get_memory_usage(context.enc_handle, &usage));
+    check_usage(usage);
+    ASSERT_EQ(usage.pool_count, init_usage.pool_count);
+    for (uint32_t i = 0; i < usage.pool_count; ++i) {
+        EXPECT_EQ(usage.pool_array[i].committed_bytes,
+                  init_usage.pool_array[i].committed_bytes)
+            << usage.pool_array[i].pool_name;
+    }
+    deinit_encoder(context);
+}
+
+/** @brief lazy_pools_grow_within_caps is a api test case
+ * EncApiTest.lazy_pools_grow_within_caps checks the report of an encoder
+ * that constructs its pools on demand
+ *
+ * Test strategy: <br>
+ * Request the usage after eb_init_encoder and after encoding frame_count
+ * frames with lazy_pool_allocation, and compare with an encoder of the
+ * same configuration that constructs its pools at init.
+ *
+ * Expected result: <br>
+ * At init each pool holds at most lazy_pool_init_count objects and the
+ * encoder commits less than the eager one. While encoding the pools grow
+ * but never past object_max_count, nor past the committed size of the
+ * eager pools.
+ *
+ * Test coverage:
+ * eb_svt_enc_get_memory_usage, lazy_pool_allocation.
+ */
+TEST(EncApiTest, lazy_pools_grow_within_caps) {
+    SvtAv1Context eager_context = {0};
+    SvtAv1Context context = {0};
+    EbSvtMemoryUsage eager_usage, init_usage, usage;
+
+    init_encoder(eager_context, false);
+    ASSERT_EQ(EB_ErrorNone,
+              eb_svt_enc_get_memory_usage(eager_context.enc_handle,
+                                          &eager_usage));
+    deinit_encoder(eager_context);
+
+    init_encoder(context, true);
+    ASSERT_EQ(EB_ErrorNone,
+              eb_svt_enc_get_memory_usage(context.enc_handle, &init_usage));
+    check_usage(init_usage);
+    ASSERT_EQ(init_usage.pool_count, eager_usage.pool_count);
+    EXPECT_LT(init_usage.total_committed_bytes,
+              eager_usage.total_committed_bytes);
+
+    bool any_partial = false;
+    for (uint32_t i = 0; i < init_usage.pool_count; ++i) {
+        const EbMemoryPoolUsage &pool = init_usage.pool_array[i];
+
+        EXPECT_STREQ(pool.pool_name, eager_usage.pool_array[i].pool_name);
+        EXPECT_EQ(pool.object_max_count,
+                  eager_usage.pool_array[i].object_max_count)
+            << pool.pool_name;
+        EXPECT_GE(pool.object_count,
+                  std::min(pool.object_max_count, lazy_pool_init_count))
+            << pool.pool_name;
+        any_partial |= pool.object_count < pool.object_max_count;
+    }
+    EXPECT_TRUE(any_partial);
+
+    // The biggest pools are the ones worth growing on demand
+    const EbMemoryPoolUsage *pcs = find_pool(init_usage, "PictureParentControlSet");
+    ASSERT_NE(pcs, nullptr);
+    EXPECT_LT(pcs->object_count, pcs->object_max_count);
+
+    encode_frames(context);
+    ASSERT_EQ(EB_ErrorNone,
+              eb_svt_enc_get_memory_usage(context.enc_handle, &usage));
+    check_usage(usage);
+    ASSERT_EQ(usage.pool_count, init_usage.pool_count);
+    for (uint32_t i = 0; i < usage.pool_count; ++i) {
+        const EbMemoryPoolUsage &pool = usage.pool_array[i];
+
+        EXPECT_GE(pool.object_count, init_usage.pool_array[i].object_count)
+            << pool.pool_name;
+        EXPECT_GE(pool.committed_bytes,
+                  init_usage.pool_array[i].committed_bytes)
+            << pool.pool_name;
+        EXPECT_LE(pool.committed_bytes,
+                  eager_usage.pool_array[i].committed_bytes)
+            << pool.pool_name;
+    }
+    EXPECT_GE(usage.total_committed_bytes, init_usage.total_committed_bytes);
+    deinit_encoder(context);
+}
+
+}  // namespace
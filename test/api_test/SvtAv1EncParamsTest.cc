@@ -282,6 +282,10 @@ PARAM_TEST(EncParamExtBlockTest);
 DEFINE_PARAM_TEST_CLASS(EncParamInLoopMeTest, in_loop_me_flag);
 PARAM_TEST(EncParamInLoopMeTest);
 
+/** Test case for md_recon_cache_flag*/
+DEFINE_PARAM_TEST_CLASS(EncParamMdReconCacheTest, md_recon_cache_flag);
+PARAM_TEST(EncParamMdReconCacheTest);
+
 /** Test case for search_area_width*/
 DEFINE_PARAM_TEST_CLASS(EncParamSearchAreaWidthTest, search_area_width);
 PARAM_TEST(EncParamSearchAreaWidthTest);
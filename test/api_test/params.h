@@ -595,6 +595,21 @@ static const vector<EbBool> invalid_in_loop_me_flag = {
     // none
 };
 
+/* Flag to let the encode pass reuse the luma transform results of mode
+ * decision
+ *
+ * Default is 1. */
+static const vector<EbBool> default_md_recon_cache_flag = {
+    EB_TRUE,
+};
+static const vector<EbBool> valid_md_recon_cache_flag = {
+    EB_FALSE,
+    EB_TRUE,
+};
+static const vector<EbBool> invalid_md_recon_cache_flag = {
+    // none
+};
+
 // ME Parameters
 /* Number of search positions in the horizontal direction.
  *
@@ -0,0 +1,258 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file AsmTableKernelBench.cc
+ *
+ * @brief Kernels of the EbAsm indexed function tables, timed at both table
+ * indices:
+ * - motion estimation SAD, averaging SAD and search loop kernels
+ * - residual, addition, distortion and mean kernels of the picture operators
+ * - the encode pass transforms and AVC style sub-pel interpolation
+ *
+ * The ASM_NON_AVX2 entries mix C, SSE2, SSSE3 and SSE4.1 kernels; the kernel
+ * names in the source tables tell which.
+ *
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in the C++ headers
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "EbComputeSAD.h"
+#include "EbComputeMean.h"
+#include "EbPictureOperators.h"
+#include "EbTransforms.h"
+#include "EbAvcStyleMcp.h"
+#include "KernelBench.h"
+
+namespace svt_av1_bench {
+
+namespace {
+
+struct AsmTableState {
+    int16_t *transform_inner;
+    uint8_t *avc_temp;
+
+    uint32_t best_sad8x8[64], best_mv8x8[64];
+    uint32_t best_sad16x16[16], best_mv16x16[16];
+    uint32_t best_sad32x32[4], best_mv32x32[4];
+    uint32_t best_sad64x64, best_mv64x64;
+    uint16_t *eight_sad16x16;  // [16][8], stored with aligned stores
+};
+
+AsmTableState *state;
+
+void setup_state(BenchBuffers &b) {
+    state = new AsmTableState();
+    state->transform_inner = (int16_t *)b.alloc(64 * 64 * sizeof(int16_t));
+    // The diagonal AVC positions keep three intermediate blocks
+    state->avc_temp = (uint8_t *)b.alloc(4 * 72 * 72);
+    state->eight_sad16x16 = (uint16_t *)b.alloc(16 * 8 * sizeof(uint16_t));
+}
+
+std::string table_name(const char *table, int index) {
+    char name[128];
+    snprintf(name, sizeof(name), "%s[%d]", table, index);
+    return name;
+}
+
+}  // namespace
+
+/**
+ * Registers the kernel entry selects for asm_type, the arguments see b
+ * (BenchBuffers), s (AsmTableState) and k (the kernel).
+ */
+#define ASM_TABLE_KERNEL(name, type, w, h, units, entry, ...)               \
+    entries.push_back(KernelEntry(                                         \
+        name, w, h, units,                                                 \
+        [=](int asm_type) { return (GenericFunc)(entry); },                \
+        [=](GenericFunc func) -> KernelRun {                               \
+            const type k = (type)func;                                     \
+            return [=](uint64_t iterations) {                              \
+                BenchBuffers &b = bench_buffers();                         \
+                AsmTableState &s = *state;                                 \
+                (void)b;                                                   \
+                (void)s;                                                   \
+                for (uint64_t i = 0; i < iterations; i++) {                \
+                    __VA_ARGS__;                                           \
+                }                                                          \
+            };                                                             \
+        }))
+
+void register_asm_table_kernels(std::vector<KernelEntry> &entries) {
+    // Widths of the [width >> 3] indexed SAD tables
+    static const int sad_widths[] = {4, 8, 16, 24, 32, 48, 64};
+    static const int loop_sizes[] = {8, 16, 32, 64};
+    static const int square_sizes[] = {4, 8, 16, 32, 64};
+
+    setup_state(bench_buffers());
+
+    // Motion estimation
+    for (int w : sad_widths) {
+        const int idx = w >> 3;
+        ASM_TABLE_KERNEL(table_name("NxMSadKernel_funcPtrArray", idx),
+                         EB_SADKERNELNxM_TYPE, w, w, w * w,
+                         NxMSadKernel_funcPtrArray[asm_type][idx],
+                         k(b.src8, kPicStride, b.ref8, kPicStride, w, w));
+        ASM_TABLE_KERNEL(
+            table_name("NxMSadKernelSubSampled_funcPtrArray", idx),
+            EB_SADKERNELNxM_TYPE, w, w, w * w,
+            NxMSadKernelSubSampled_funcPtrArray[asm_type][idx],
+            k(b.src8, 2 * kPicStride, b.ref8, 2 * kPicStride, w / 2, w));
+        ASM_TABLE_KERNEL(
+            table_name("NxMSadAveragingKernel_funcPtrArray", idx),
+            EB_SADAVGKERNELNxM_TYPE, w, w, w * w,
+            NxMSadAveragingKernel_funcPtrArray[asm_type][idx],
+            k(b.src8, kPicStride, b.ref8, kPicStride, b.dst8, kPicStride, w,
+              w));
+        ASM_TABLE_KERNEL("combined_averaging_ssd_func_ptr_array",
+                         CombinedAveragingSsd, w, w, w * w,
+                         combined_averaging_ssd_func_ptr_array[asm_type],
+                         k(b.src8, kPicStride, b.ref8, kPicStride, b.dst8,
+                           kPicStride, w, w));
+    }
+    ASM_TABLE_KERNEL(table_name("NxMSadKernelSubSampled_funcPtrArray", 16),
+                     EB_SADKERNELNxM_TYPE, 128, 128, 128 * 128,
+                     NxMSadKernelSubSampled_funcPtrArray[asm_type][16],
+                     k(b.src8, 2 * kPicStride, b.ref8, 2 * kPicStride, 64,
+                       128));
+    // Every position of the search area
+    for (int w : loop_sizes) {
+        const uint64_t units =
+            (uint64_t)w * w * kSearchAreaWidth * kSearchAreaHeight;
+        ASM_TABLE_KERNEL("NxMSadLoopKernelSparse_funcPtrArray",
+                         EB_SADLOOPKERNELNxM_TYPE, w, w, units,
+                         NxMSadLoopKernelSparse_funcPtrArray[asm_type],
+                         uint64_t best_sad = UINT64_MAX;
+                         int16_t x = 0; int16_t y = 0;
+                         k(b.src8, kPicStride, b.ref8, kPicStride, w, w,
+                           &best_sad, &x, &y, kPicStride, kSearchAreaWidth,
+                           kSearchAreaHeight));
+    }
+    // Eight horizontal search positions of a 16x16 block, then of the
+    // 32x32 and 64x64 blocks from the sixteen 16x16 results
+    ASM_TABLE_KERNEL(
+        "GetEightHorizontalSearchPointResults_8x8_16x16_funcPtrArray",
+        EB_GETEIGHTSAD8x8, 16, 16, 8 * 16 * 16,
+        GetEightHorizontalSearchPointResults_8x8_16x16_funcPtrArray[asm_type],
+        k(b.src8, kPicStride, b.ref8, kPicStride, s.best_sad8x8,
+          s.best_mv8x8, s.best_sad16x16, s.best_mv16x16, 0,
+          s.eight_sad16x16));
+    ASM_TABLE_KERNEL(
+        "GetEightHorizontalSearchPointResults_32x32_64x64_funcPtrArray",
+        EB_GETEIGHTSAD32x32, 64, 64, 8 * 64 * 64,
+        GetEightHorizontalSearchPointResults_32x32_64x64_funcPtrArray
+            [asm_type],
+        k(s.eight_sad16x16, s.best_sad32x32, &s.best_sad64x64,
+          s.best_mv32x32, &s.best_mv64x64, 0));
+    ASM_TABLE_KERNEL("ComputeMeanFunc[0]", EB_COMPUTE_MEAN_FUNC, 8, 8, 8 * 8,
+                     ComputeMeanFunc[0][asm_type],
+                     k(b.src8, kPicStride, 8, 8));
+    ASM_TABLE_KERNEL("ComputeMeanFunc[1]", EB_COMPUTE_MEAN_FUNC, 8, 8, 8 * 8,
+                     ComputeMeanFunc[1][asm_type],
+                     k(b.src8, kPicStride, 8, 8));
+
+    // Picture operators
+    for (int w : square_sizes) {
+        const int idx = w >> 3;
+        if (w <= 64) {
+            ASM_TABLE_KERNEL(
+                table_name("addition_kernel_func_ptr_array", idx),
+                EB_ADDDKERNEL_TYPE, w, w, w * w,
+                addition_kernel_func_ptr_array[asm_type][idx],
+                k(b.ref8, kPicStride, b.residual, w, b.dst8, kPicStride, w,
+                  w));
+        }
+        if (w <= 32) {
+            ASM_TABLE_KERNEL(
+                table_name("pic_zero_out_coef_func_ptr_array", idx),
+                EB_ZEROCOEFF_TYPE, w, w, w * w,
+                pic_zero_out_coef_func_ptr_array[asm_type][idx],
+                k(b.coeff16, 64, 0, w, w));
+        }
+        ASM_TABLE_KERNEL("sum_residual_func_ptr_array", EB_SUM_RES, w, w,
+                         w * w, sum_residual_func_ptr_array[asm_type],
+                         k(b.residual, w, w));
+        ASM_TABLE_KERNEL("memset16bit_block_func_ptr_array",
+                         EB_MEMSET16bitBLK, w, w, w * w,
+                         memset16bit_block_func_ptr_array[asm_type],
+                         k(b.coeff16, w, w, 1));
+        ASM_TABLE_KERNEL(
+            "full_distortion_kernel32_bits_func_ptr_array",
+            EB_FUllDISTORTIONKERNEL32BITS, w, w, w * w,
+            full_distortion_kernel32_bits_func_ptr_array[asm_type],
+            uint64_t dist[DIST_CALC_TOTAL];
+            k(b.coeff, 64, b.coeff_out, 64, dist, w, w));
+        ASM_TABLE_KERNEL(
+            "full_distortion_kernel_cbf_zero32_bits_func_ptr_array",
+            EB_FUllDISTORTIONKERNELCBFZERO32BITS, w, w, w * w,
+            full_distortion_kernel_cbf_zero32_bits_func_ptr_array[asm_type],
+            uint64_t dist[DIST_CALC_TOTAL];
+            k(b.coeff, 64, b.coeff_out, 64, dist, w, w));
+    }
+    for (int l = 0; l < 6; l++) {
+        const int w = 4 << l;
+        ASM_TABLE_KERNEL(
+            table_name("spatial_full_distortion_kernel_func_ptr_array", l),
+            EB_SPATIALFULLDIST_TYPE, w, w, w * w,
+            spatial_full_distortion_kernel_func_ptr_array[asm_type][l],
+            k(b.src8, kPicStride, b.dst8, kPicStride, w, w));
+    }
+    ASM_TABLE_KERNEL("compute8x8_satd_u8_func_ptr_array", EB_SATD_U8_TYPE, 8,
+                     8, 8 * 8, compute8x8_satd_u8_func_ptr_array[asm_type],
+                     uint64_t dc = 0; k(b.src8, &dc, kPicStride));
+
+    // Encode pass transforms, [0] 32x32 to [3] 4x4, [4] the 4x4 DST
+    for (int idx = 0; idx < 5; idx++) {
+        const int w = idx == 4 ? 4 : 32 >> idx;
+        ASM_TABLE_KERNEL(table_name("transform_function_table_encode", idx),
+                         EbTransformFunc, w, w, w * w,
+                         transform_function_table_encode[asm_type][idx],
+                         k(b.residual, w, b.coeff16, w, s.transform_inner,
+                           0));
+        ASM_TABLE_KERNEL(table_name("pfreq_n2_transform_table", idx),
+                         EbTransformFunc, w, w, w * w,
+                         pfreq_n2_transform_table[asm_type][idx],
+                         k(b.residual, w, b.coeff16, w, s.transform_inner,
+                           0));
+        ASM_TABLE_KERNEL(table_name("pfreq_n4_transform_table", idx),
+                         EbTransformFunc, w, w, w * w,
+                         pfreq_n4_transform_table[asm_type][idx],
+                         k(b.residual, w, b.coeff16, w, s.transform_inner,
+                           0));
+        ASM_TABLE_KERNEL(
+            table_name("inv_transform_function_table_encode", idx),
+            EbInvTransformFunc, w, w, w * w,
+            inv_transform_function_table_encode[asm_type][idx],
+            k(b.residual, w, b.coeff16, w, s.transform_inner, 0));
+    }
+
+    // AVC style interpolation of a 64x64 block at each quarter pel position
+    for (int pos = 0; pos < 16; pos++) {
+        const uint32_t frac_pos = (pos & 3) ? (pos & 3) : (pos >> 2);
+        ASM_TABLE_KERNEL(
+            table_name("avc_style_uni_pred_luma_if_function_ptr_array", pos),
+            AvcStyleInterpolationFilterNew, 64, 64, 64 * 64,
+            avc_style_uni_pred_luma_if_function_ptr_array[asm_type][pos],
+            k(b.ref8, kPicStride, b.dst8, kPicStride, 64, 64, s.avc_temp,
+              EB_FALSE, frac_pos));
+    }
+    ASM_TABLE_KERNEL("picture_average_array", PictureAverage, 64, 64,
+                     64 * 64, picture_average_array[asm_type],
+                     k(b.src8, kPicStride, b.ref8, kPicStride, b.dst8,
+                       kPicStride, 64, 64));
+}
+
+}  // namespace svt_av1_bench
@@ -0,0 +1,274 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file KernelBench.cc
+ *
+ * @brief Kernel micro-benchmarks, times every kernel of the RTCD and of the
+ * EbAsm indexed function tables at every instruction set level the
+ * processor supports and reports time stamp counter cycles per pixel.
+ *
+ * Usage: SvtAv1KernelBench [filter]
+ * where filter keeps the kernels whose name contains it.
+ *
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in the C++ headers
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+#include "random.h"
+#include "KernelBench.h"
+
+extern "C" {
+EbAsm GetCpuAsmType(void);
+int32_t CheckAvx512Features(void);
+}
+
+using svt_av1_test_tool::SVTRandom;
+
+namespace svt_av1_bench {
+
+/** Cycles one timed run of a kernel lasts at least */
+const uint64_t kMinRunCycles = 1 << 20;
+/** Timed runs of a kernel, the fastest is reported */
+const int kRuns = 5;
+
+BenchBuffers::BenchBuffers() {
+    const size_t pic_size = (size_t)kPicStride * kPicRows;
+    const size_t pic_origin = (size_t)kPicBorder * kPicStride + kPicBorder;
+    SVTRandom rnd8(0, 255);
+    SVTRandom rnd10(0, (1 << 10) - 1);
+
+    uint8_t *pic8[3];
+    uint16_t *pic16[3];
+    for (int i = 0; i < 3; i++) {
+        pic8[i] = (uint8_t *)alloc(pic_size);
+        pic16[i] = (uint16_t *)alloc(pic_size * sizeof(uint16_t));
+        for (size_t j = 0; j < pic_size; j++) {
+            pic8[i][j] = (uint8_t)rnd8.random();
+            pic16[i][j] = (uint16_t)rnd10.random();
+        }
+    }
+    src8 = pic8[0] + pic_origin;
+    ref8 = pic8[1] + pic_origin;
+    dst8 = pic8[2] + pic_origin;
+    src16 = pic16[0] + pic_origin;
+    ref16 = pic16[1] + pic_origin;
+    dst16 = pic16[2] + pic_origin;
+    conv16 = (uint16_t *)alloc(128 * 128 * sizeof(uint16_t));
+
+    uint8_t *edge8[2];
+    uint16_t *edge16[2];
+    for (int i = 0; i < 2; i++) {
+        edge8[i] = (uint8_t *)alloc(kEdgeSize);
+        edge16[i] = (uint16_t *)alloc(kEdgeSize * sizeof(uint16_t));
+        for (int j = 0; j < kEdgeSize; j++) {
+            edge8[i][j] = (uint8_t)rnd8.random();
+            edge16[i][j] = (uint16_t)rnd10.random();
+        }
+    }
+    above8 = edge8[0] + kEdgeBorder;
+    left8 = edge8[1] + kEdgeBorder;
+    above16 = edge16[0] + kEdgeBorder;
+    left16 = edge16[1] + kEdgeBorder;
+
+    SVTRandom rnd_residual(-255, 255);
+    SVTRandom rnd_coeff(-64, 63);
+    residual = (int16_t *)alloc(128 * 128 * sizeof(int16_t));
+    coeff16 = (int16_t *)alloc(128 * 128 * sizeof(int16_t));
+    coeff = (int32_t *)alloc(64 * 64 * sizeof(int32_t));
+    coeff_out = (int32_t *)alloc(128 * 128 * sizeof(int32_t));
+    for (int i = 0; i < 128 * 128; i++)
+        residual[i] = (int16_t)rnd_residual.random();
+    for (int i = 0; i < 64 * 64; i++)
+        coeff[i] = rnd_coeff.random();
+
+    fft_in = (float *)alloc(32 * 32 * 2 * sizeof(float));
+    fft_tmp = (float *)alloc(32 * 32 * 2 * sizeof(float));
+    fft_out = (float *)alloc(32 * 32 * 2 * sizeof(float));
+    for (int i = 0; i < 32 * 32 * 2; i++)
+        fft_in[i] = (float)rnd_residual.random();
+}
+
+BenchBuffers::~BenchBuffers() {
+    for (size_t i = 0; i < allocations_.size(); i++)
+        free(allocations_[i]);
+}
+
+void *BenchBuffers::alloc(size_t size) {
+    void *buf = calloc(size + 64, 1);
+    if (buf == NULL) {
+        fprintf(stderr, "SvtAv1KernelBench: out of memory\n");
+        exit(1);
+    }
+    allocations_.push_back(buf);
+    return (void *)(((uintptr_t)buf + 63) & ~(uintptr_t)63);
+}
+
+BenchBuffers &bench_buffers() {
+    static BenchBuffers buffers;
+    return buffers;
+}
+
+namespace {
+
+struct Level {
+    const char *name;
+    int value;
+};
+
+/**
+ * @brief Kernels resolved the same way at each of the levels, setup points
+ * the section at a level before the entries are resolved.
+ */
+struct Section {
+    const char *title;
+    std::vector<Level> levels;
+    std::function<void(int)> setup;
+    std::vector<KernelEntry> entries;
+};
+
+uint64_t time_run(const KernelRun &run, uint64_t iterations) {
+    const uint64_t start = __rdtsc();
+    run(iterations);
+    return __rdtsc() - start;
+}
+
+/** Fastest run of the kernel, in cycles per unit */
+double time_kernel(const KernelRun &run, uint64_t units) {
+    uint64_t iterations = 1;
+
+    // Warm the caches up, then size the runs
+    run(1);
+    while (time_run(run, iterations) < kMinRunCycles && iterations < (1 << 24))
+        iterations *= 2;
+
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < kRuns; i++) {
+        const uint64_t cycles = time_run(run, iterations);
+        if (cycles < best)
+            best = cycles;
+    }
+    return (double)best / (double)(iterations * units);
+}
+
+void run_section(Section &section, const char *filter) {
+    const size_t level_count = section.levels.size();
+    std::vector<std::vector<double> > results(section.entries.size());
+    std::vector<GenericFunc> last(section.entries.size(), (GenericFunc)NULL);
+
+    for (size_t l = 0; l < level_count; l++) {
+        section.setup(section.levels[l].value);
+        for (size_t e = 0; e < section.entries.size(); e++) {
+            const KernelEntry &entry = section.entries[e];
+            results[e].resize(level_count, -1.0);
+            if (filter && !strstr(entry.name.c_str(), filter))
+                continue;
+            // Only time the functions a lower level did not select already
+            const GenericFunc func = entry.get(section.levels[l].value);
+            if (func == NULL || func == last[e])
+                continue;
+            last[e] = func;
+            results[e][l] = time_kernel(entry.bind(func), entry.units);
+        }
+    }
+
+    printf("\n%s, cycles per pixel\n", section.title);
+    printf("%-62s %-10s", "kernel", "size");
+    for (size_t l = 0; l < level_count; l++)
+        printf(" %9s", section.levels[l].name);
+    printf(" %9s\n", "speedup");
+
+    for (size_t e = 0; e < section.entries.size(); e++) {
+        const KernelEntry &entry = section.entries[e];
+        if (filter && !strstr(entry.name.c_str(), filter))
+            continue;
+        char size[32];
+        double first = -1.0, best = -1.0;
+        snprintf(size, sizeof(size), "%ux%u", entry.width, entry.height);
+        printf("%-62s %-10s", entry.name.c_str(), size);
+        for (size_t l = 0; l < level_count; l++) {
+            const double cpp = results[e][l];
+            if (cpp < 0) {
+                printf(" %9s", "-");
+                continue;
+            }
+            printf(" %9.3f", cpp);
+            if (first < 0)
+                first = cpp;
+            if (best < 0 || cpp < best)
+                best = cpp;
+        }
+        if (first < 0)
+            printf(" %9s\n", "-");
+        else
+            printf(" %8.2fx\n", first / best);
+    }
+    fflush(stdout);
+}
+
+}  // namespace
+
+}  // namespace svt_av1_bench
+
+using namespace svt_av1_bench;
+
+int main(int argc, char **argv) {
+    const char *filter = argc > 1 ? argv[1] : NULL;
+    const bool has_avx2 = GetCpuAsmType() == ASM_AVX2;
+    const bool has_avx512 = has_avx2 && CheckAvx512Features();
+    const int sse2 = HAS_MMX | HAS_SSE | HAS_SSE2;
+    const int ssse3 = sse2 | HAS_SSE3 | HAS_SSSE3;
+    const int sse4_1 = ssse3 | HAS_SSE4_1 | HAS_SSE4_2;
+    const int avx2 = sse4_1 | HAS_AVX | HAS_AVX2;
+
+    // Allocate the buffers before any timing
+    bench_buffers();
+
+    Section rtcd;
+    rtcd.title = "aom_dsp_rtcd.h";
+    rtcd.levels.push_back(Level{"c", 0});
+    rtcd.levels.push_back(Level{"sse2", sse2});
+    rtcd.levels.push_back(Level{"ssse3", ssse3});
+    rtcd.levels.push_back(Level{"sse4_1", sse4_1});
+    if (has_avx2)
+        rtcd.levels.push_back(Level{"avx2", avx2});
+    if (has_avx512)
+        rtcd.levels.push_back(Level{"avx512", avx2 | HAS_AVX512});
+    rtcd.setup = [](int flags) { setup_rtcd_flags(flags); };
+    register_rtcd_kernels(rtcd.entries);
+
+    Section asm_table;
+    asm_table.title = "EbAsm function tables";
+    asm_table.levels.push_back(Level{"non_avx2", ASM_NON_AVX2});
+    if (has_avx2)
+        asm_table.levels.push_back(Level{"avx2", ASM_AVX2});
+    asm_table.setup = [](int) {};
+    register_asm_table_kernels(asm_table.entries);
+
+    printf("SvtAv1KernelBench: avx2 %s, avx512 %s\n", has_avx2 ? "yes" : "no",
+           has_avx512 ? "yes" : "no");
+    run_section(rtcd, filter);
+    run_section(asm_table, filter);
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file KernelBench.h
+ *
+ * @brief Harness of the kernel micro-benchmarks:
+ * - BenchBuffers, the pictures, edges and coefficient buffers the kernels
+ *   read and write
+ * - KernelEntry, one kernel at one block size, resolved per instruction set
+ *   level and bound to its arguments
+ *
+ * Every level of a section (RTCD flags or EbAsm table index) is resolved in
+ * turn; a kernel is timed at a level only when the level selects a function
+ * the previous levels did not, so missing SIMD versions show up as holes in
+ * the report.
+ *
+ ******************************************************************************/
+#ifndef KERNEL_BENCH_H_
+#define KERNEL_BENCH_H_
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace svt_av1_bench {
+
+typedef void (*GenericFunc)(void);
+
+/** Runs the kernel a given number of times */
+typedef std::function<void(uint64_t iterations)> KernelRun;
+
+/** Luma line of a 1080p picture with 64 pixels of padding on each side */
+const int kPicStride = 1920 + 2 * 64;
+/** Rows and columns available above and left of the block origin */
+const int kPicBorder = 64;
+const int kPicRows = 128 + 2 * kPicBorder;
+/** Samples available before the intra edge pointers */
+const int kEdgeBorder = 32;
+const int kEdgeSize = kEdgeBorder + 4 * 128;
+/** Search area of the SAD loop kernels */
+const int16_t kSearchAreaWidth = 64;
+const int16_t kSearchAreaHeight = 16;
+
+/**
+ * @brief Random 8-bit and 10-bit pictures, intra edges and residual and
+ * coefficient blocks. The picture pointers point at the block origin, with
+ * kPicBorder rows and columns of valid samples around a 128x128 block.
+ */
+struct BenchBuffers {
+    BenchBuffers();
+    ~BenchBuffers();
+
+    uint8_t *src8;
+    uint8_t *ref8;
+    uint8_t *dst8;
+    uint16_t *src16;
+    uint16_t *ref16;
+    uint16_t *dst16;
+    uint16_t *conv16;  // compound convolve destination, 128x128
+
+    uint8_t *above8;
+    uint8_t *left8;
+    uint16_t *above16;
+    uint16_t *left16;
+
+    int16_t *residual;  // 128x128, [-255, 255]
+    int16_t *coeff16;   // 128x128 output of the int16_t transforms
+    int32_t *coeff;     // 64x64 coefficients, [-64, 63]
+    int32_t *coeff_out; // 128x128 output of the int32_t transforms
+
+    float *fft_in;
+    float *fft_tmp;
+    float *fft_out;
+
+    /** Zeroed buffer aligned to 64 bytes, freed with the BenchBuffers */
+    void *alloc(size_t size);
+
+  private:
+    std::vector<void *> allocations_;
+};
+
+/** Buffers shared by all the kernels */
+BenchBuffers &bench_buffers();
+
+/**
+ * @brief One kernel at one block size. get returns the function the level
+ * selects, bind returns the run loop of that function.
+ */
+struct KernelEntry {
+    KernelEntry(const std::string &name, uint32_t width, uint32_t height,
+                uint64_t units, const std::function<GenericFunc(int)> &get,
+                const std::function<KernelRun(GenericFunc)> &bind)
+        : name(name),
+          width(width),
+          height(height),
+          units(units),
+          get(get),
+          bind(bind) {
+    }
+
+    std::string name;
+    uint32_t width;
+    uint32_t height;
+    uint64_t units;  // pixels (or elements) one call processes
+    std::function<GenericFunc(int)> get;
+    std::function<KernelRun(GenericFunc)> bind;
+};
+
+/** Kernels behind the function pointers of aom_dsp_rtcd.h */
+void register_rtcd_kernels(std::vector<KernelEntry> &entries);
+
+/** Kernels of the EbAsm indexed function tables, get takes the EbAsm */
+void register_asm_table_kernels(std::vector<KernelEntry> &entries);
+
+}  // namespace svt_av1_bench
+
+#endif  // KERNEL_BENCH_H_
@@ -0,0 +1,674 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file RtcdKernelBench.cc
+ *
+ * @brief Kernels behind the function pointers of aom_dsp_rtcd.h, with the
+ * block sizes and strides the encoder calls them with:
+ * - intra predictors, SAD, variance, forward and inverse transforms,
+ *   quantizers and convolutions at every block size they exist for
+ * - CDEF, loop restoration, CfL, FFT, motion estimation, coefficient
+ *   coding, film grain synthesis and noise model kernels at their typical
+ *   sizes
+ *
+ ******************************************************************************/
+#include <stdint.h>
+#include <string.h>
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in the C++ headers
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+#include "EbTransforms.h"
+#include "EbPictureControlSet.h"
+#include "EbCdef.h"
+#include "EbRestoration.h"
+#include "convolve.h"
+#include "hash.h"
+#include "aom_dsp_rtcd.h"
+#include "random.h"
+#include "KernelBench.h"
+
+extern "C" {
+void av1_build_quantizer(aom_bit_depth_t bit_depth, int32_t y_dc_delta_q,
+                         int32_t u_dc_delta_q, int32_t u_ac_delta_q,
+                         int32_t v_dc_delta_q, int32_t v_ac_delta_q,
+                         Quants *const quants, Dequants *const deq);
+InterpFilterParams av1_get_interp_filter_params_with_block_size(
+    const InterpFilter interp_filter, const int32_t w);
+void av1_upsample_intra_edge_high_c(uint16_t *p, int32_t sz, int32_t bd);
+}
+
+using svt_av1_test_tool::SVTRandom;
+
+namespace svt_av1_bench {
+
+namespace {
+
+/** Quantizer index of the quantizer kernels */
+const int kQIndex = 128;
+/** Zero sum taps, the kernels add the source on the center tap */
+const int16_t kWienerTaps[8] = {3, -7, 15, -22, 15, -7, 3, 0};
+/** Film grain template, luma subblock width and largest AR lag */
+const int kGrainStride = 82;
+const int kGrainRows = 73;
+const int kGrainBlockWidth = 32;
+const int kGrainLag = 3;
+/** Noise model transform block, 32x32 complex values */
+const int kNoiseBlockSize = 32;
+
+/** Not an RTCD pointer yet, the encoder calls the C version directly */
+void (*const av1_upsample_intra_edge_high)(uint16_t *p, int32_t sz,
+                                           int32_t bd) =
+    av1_upsample_intra_edge_high_c;
+
+/**
+ * @brief State of the kernels beyond the pictures of BenchBuffers, set up
+ * once before the kernels are registered.
+ */
+struct RtcdState {
+    Quants quants[2];  // 8-bit, 10-bit
+    Dequants dequants[2];
+    int32_t *qcoeff_in;
+    int32_t *qcoeff;
+    int32_t *dqcoeff;
+
+    InterpFilterParams filter_params[8];  // by log2 of the block size
+    ConvolveParams conv_sr[2];            // 8-bit, 10-bit
+    ConvolveParams conv_compound[2];
+    ConvolveParams conv_wiener[2];
+
+    uint16_t *cdef_in;
+    uint8_t *edge;
+    uint16_t *edge16;
+    int16_t *cfl;
+    uint8_t *bit_inc;
+    uint8_t *levels;
+    int8_t *coeff_contexts;
+
+    int32_t *grain;
+    int32_t *grain_line;
+    int32_t grain_ar_coeffs[24];
+    int32_t grain_scaling_lut[257];
+    int32_t grain_wsum[kGrainStride];
+    float *noise_tx_block;
+    float *noise_psd;
+
+    int32_t *flt0;
+    int32_t *flt1;
+    int32_t *sgr_tmp;
+    int64_t *stats_m;
+    int64_t *stats_h;
+
+    uint64_t (*cdef_mse[2])[TOTAL_STRENGTHS];
+    int cdef_lev[2][8];
+
+    uint32_t me_best_sad8x8[64], me_best_mv8x8[64];
+    uint32_t me_best_sad16x16[16], me_best_mv16x16[16];
+    uint32_t me_best_sad32x32[4], me_best_mv32x32[4];
+    uint32_t me_best_sad64x64, me_best_mv64x64;
+    uint32_t me_eight_sad8x8[64][8];
+    uint32_t me_eight_sad16x16[16][8];
+    uint32_t me_eight_sad32x32[4][8];
+
+    CRC32C crc;
+    TxfmParam txfm_param[TX_SIZES_ALL];
+};
+
+RtcdState *state;
+
+int log2_size(int size) {
+    int log2 = 0;
+    while ((1 << log2) < size)
+        log2++;
+    return log2;
+}
+
+void setup_state(BenchBuffers &b) {
+    SVTRandom rnd_coeff(-1024, 1023);
+    SVTRandom rnd8(0, 255);
+
+    state = new RtcdState;
+    memset(state, 0, sizeof(*state));
+
+    av1_build_quantizer(AOM_BITS_8, 0, 0, 0, 0, 0, &state->quants[0],
+                        &state->dequants[0]);
+    av1_build_quantizer(AOM_BITS_10, 0, 0, 0, 0, 0, &state->quants[1],
+                        &state->dequants[1]);
+    state->qcoeff_in = (int32_t *)b.alloc(64 * 64 * sizeof(int32_t));
+    state->qcoeff = (int32_t *)b.alloc(64 * 64 * sizeof(int32_t));
+    state->dqcoeff = (int32_t *)b.alloc(64 * 64 * sizeof(int32_t));
+    for (int i = 0; i < 64 * 64; i++)
+        state->qcoeff_in[i] = rnd_coeff.random();
+
+    for (int i = 0; i < 8; i++) {
+        state->filter_params[i] = av1_get_interp_filter_params_with_block_size(
+            EIGHTTAP_REGULAR, 1 << i);
+    }
+    state->conv_sr[0] = get_conv_params_no_round(0, 0, 0, NULL, 0, 0, 8);
+    state->conv_sr[1] = get_conv_params_no_round(0, 0, 0, NULL, 0, 0, 10);
+    state->conv_compound[0] =
+        get_conv_params_no_round(0, 0, 0, b.conv16, 128, 1, 8);
+    state->conv_compound[1] =
+        get_conv_params_no_round(0, 0, 0, b.conv16, 128, 1, 10);
+    state->conv_wiener[0] = get_conv_params_wiener(8);
+    state->conv_wiener[1] = get_conv_params_wiener(10);
+
+    state->cdef_in = (uint16_t *)b.alloc(CDEF_INBUF_SIZE * sizeof(uint16_t));
+    for (int i = 0; i < CDEF_INBUF_SIZE; i++)
+        state->cdef_in[i] = (uint16_t)rnd8.random();
+    state->edge = (uint8_t *)b.alloc(kEdgeSize);
+    state->edge16 = (uint16_t *)b.alloc(kEdgeSize * sizeof(uint16_t));
+    state->cfl = (int16_t *)b.alloc(CFL_BUF_SQUARE * sizeof(int16_t));
+    memcpy(state->cfl, b.residual, CFL_BUF_SQUARE * sizeof(int16_t));
+    state->bit_inc = (uint8_t *)b.alloc((size_t)kPicStride * 16);
+    state->levels = (uint8_t *)b.alloc(TX_PAD_2D);
+    for (int i = 0; i < TX_PAD_2D; i++)
+        state->levels[i] = (uint8_t)(rnd8.random() & 15);
+    state->coeff_contexts = (int8_t *)b.alloc(64 * 64);
+
+    state->grain = (int32_t *)b.alloc(kGrainStride * kGrainRows *
+                                      sizeof(int32_t));
+    state->grain_line = (int32_t *)b.alloc(2 * kGrainStride *
+                                           sizeof(int32_t));
+    for (int i = 0; i < kGrainStride * kGrainRows; i++)
+        state->grain[i] = rnd8.random() - 128;
+    for (int i = 0; i < 2 * kGrainStride; i++)
+        state->grain_line[i] = rnd8.random() - 128;
+    for (int i = 0; i < 24; i++)
+        state->grain_ar_coeffs[i] = (rnd8.random() & 63) - 32;
+    for (int i = 0; i < 257; i++)
+        state->grain_scaling_lut[i] = rnd8.random();
+    state->noise_tx_block = (float *)b.alloc(
+        2 * kNoiseBlockSize * kNoiseBlockSize * sizeof(float));
+    state->noise_psd =
+        (float *)b.alloc(kNoiseBlockSize * kNoiseBlockSize * sizeof(float));
+    for (int i = 0; i < kNoiseBlockSize * kNoiseBlockSize; i++) {
+        state->noise_tx_block[2 * i] = (float)(rnd8.random() - 128);
+        state->noise_tx_block[2 * i + 1] = (float)(rnd8.random() - 128);
+        state->noise_psd[i] = (float)rnd8.random() * 16.0f;
+    }
+
+    state->flt0 = (int32_t *)b.alloc(64 * 64 * sizeof(int32_t));
+    state->flt1 = (int32_t *)b.alloc(64 * 64 * sizeof(int32_t));
+    for (int i = 0; i < 64 * 64; i++) {
+        state->flt0[i] = b.src8[i & 63] << SGRPROJ_RST_BITS;
+        state->flt1[i] = b.ref8[i & 63] << SGRPROJ_RST_BITS;
+    }
+    state->sgr_tmp = (int32_t *)b.alloc(RESTORATION_TMPBUF_SIZE);
+    state->stats_m = (int64_t *)b.alloc(WIENER_WIN2 * sizeof(int64_t));
+    state->stats_h =
+        (int64_t *)b.alloc(WIENER_WIN2 * WIENER_WIN2 * sizeof(int64_t));
+
+    for (int i = 0; i < 2; i++) {
+        state->cdef_mse[i] = (uint64_t(*)[TOTAL_STRENGTHS])b.alloc(
+            64 * TOTAL_STRENGTHS * sizeof(uint64_t));
+        for (int j = 0; j < 64 * TOTAL_STRENGTHS; j++)
+            state->cdef_mse[i][j / TOTAL_STRENGTHS][j % TOTAL_STRENGTHS] =
+                (uint64_t)rnd8.random() << 8;
+        for (int j = 0; j < 8; j++)
+            state->cdef_lev[i][j] = (j * 7 + i) % TOTAL_STRENGTHS;
+    }
+
+    av1_crc32c_calculator_init(&state->crc);
+
+    for (int tx_size = 0; tx_size < TX_SIZES_ALL; tx_size++) {
+        TxfmParam *param = &state->txfm_param[tx_size];
+        param->tx_type = DCT_DCT;
+        param->tx_size = (TxSize)tx_size;
+        param->lossless = 0;
+        param->bd = 8;
+        param->is_hbd = 0;
+        param->tx_set_type = EXT_TX_SET_DCTONLY;
+        param->eob = av1_get_max_eob((TxSize)tx_size);
+    }
+}
+
+}  // namespace
+
+/**
+ * Registers the kernel fn points at, the arguments see b (BenchBuffers),
+ * s (RtcdState) and k (the kernel).
+ */
+#define RTCD_KERNEL(fn, w, h, units, ...)                                   \
+    entries.push_back(KernelEntry(                                         \
+        #fn, w, h, units, [](int) { return (GenericFunc)fn; },             \
+        [=](GenericFunc func) -> KernelRun {                               \
+            const auto k = (decltype(fn))func;                             \
+            return [=](uint64_t iterations) {                              \
+                BenchBuffers &b = bench_buffers();                         \
+                RtcdState &s = *state;                                     \
+                (void)b;                                                   \
+                (void)s;                                                   \
+                for (uint64_t i = 0; i < iterations; i++) {                \
+                    __VA_ARGS__;                                           \
+                }                                                          \
+            };                                                             \
+        }))
+
+/** The 19 block and transform sizes from 4x4 to 64x64 */
+#define BLOCK_SIZES(X, a)                                                    \
+    X(a, 4, 4) X(a, 4, 8) X(a, 4, 16) X(a, 8, 4) X(a, 8, 8) X(a, 8, 16)      \
+    X(a, 8, 32) X(a, 16, 4) X(a, 16, 8) X(a, 16, 16) X(a, 16, 32)            \
+    X(a, 16, 64) X(a, 32, 8) X(a, 32, 16) X(a, 32, 32) X(a, 32, 64)          \
+    X(a, 64, 16) X(a, 64, 32) X(a, 64, 64)
+#define BLOCK_SIZES_128(X, a) \
+    BLOCK_SIZES(X, a) X(a, 64, 128) X(a, 128, 64) X(a, 128, 128)
+
+#define LOWBD_PRED(type, w, h)                                           \
+    RTCD_KERNEL(aom_##type##_predictor_##w##x##h, w, h, w * h,           \
+                k(b.dst8, kPicStride, b.above8, b.left8));
+#define HIGHBD_PRED(type, w, h)                                          \
+    RTCD_KERNEL(aom_highbd_##type##_predictor_##w##x##h, w, h, w * h,    \
+                k(b.dst16, kPicStride, b.above16, b.left16, 10));
+#define SAD(a, w, h)                                                     \
+    RTCD_KERNEL(aom_sad##w##x##h, w, h, w * h,                           \
+                k(b.src8, kPicStride, b.ref8, kPicStride));
+#define SAD_X4D(a, w, h)                                                 \
+    RTCD_KERNEL(aom_sad##w##x##h##x4d, w, h, 4 * w * h,                  \
+                const uint8_t *const refs[4] = {                         \
+                    b.ref8, b.ref8 + 1, b.ref8 + 2, b.ref8 + 3};         \
+                uint32_t sad[4];                                         \
+                k(b.src8, kPicStride, refs, kPicStride, sad));
+#define VARIANCE(a, w, h)                                                \
+    RTCD_KERNEL(aom_variance##w##x##h, w, h, w * h, unsigned int sse;    \
+                k(b.src8, kPicStride, b.ref8, kPicStride, &sse));
+#define FWD_TXFM(a, w, h)                                                \
+    RTCD_KERNEL(av1_fwd_txfm2d_##w##x##h, w, h, w * h,                   \
+                k(b.residual, b.coeff_out, w, DCT_DCT, 8));
+#define INV_TXFM_SQUARE(w)                                               \
+    RTCD_KERNEL(av1_inv_txfm2d_add_##w##x##w, w, w, w * w,               \
+                k(b.coeff, b.dst16, kPicStride, DCT_DCT, 10));
+#define INV_TXFM_EOB(w, h)                                               \
+    RTCD_KERNEL(av1_inv_txfm2d_add_##w##x##h, w, h, w * h,               \
+                k(b.coeff, b.dst16, kPicStride, DCT_DCT, TX_##w##X##h,   \
+                  av1_get_max_eob(TX_##w##X##h), 10));
+#define INV_TXFM_SMALL(w, h)                                             \
+    RTCD_KERNEL(av1_inv_txfm2d_add_##w##x##h, w, h, w * h,               \
+                k(b.coeff, b.dst16, kPicStride, DCT_DCT, TX_##w##X##h,   \
+                  10));
+#define FFT(n)                                                           \
+    RTCD_KERNEL(aom_fft##n##x##n##_float, n, n, n * n,                   \
+                k(b.fft_in, b.fft_tmp, b.fft_out));                      \
+    RTCD_KERNEL(aom_ifft##n##x##n##_float, n, n, n * n,                  \
+                k(b.fft_in, b.fft_tmp, b.fft_out));
+
+void register_rtcd_kernels(std::vector<KernelEntry> &entries) {
+    static const int square_sizes[] = {4, 8, 16, 32, 64};
+    static const int convolve_sizes[] = {4, 8, 16, 32, 64, 128};
+    static const int cfl_sizes[] = {4, 8, 16, 32};
+    static const int restoration_sizes[] = {32, 64};
+
+    setup_state(bench_buffers());
+
+    // Intra prediction
+    BLOCK_SIZES(LOWBD_PRED, dc)
+    BLOCK_SIZES(LOWBD_PRED, dc_left)
+    BLOCK_SIZES(LOWBD_PRED, dc_top)
+    BLOCK_SIZES(LOWBD_PRED, dc_128)
+    BLOCK_SIZES(LOWBD_PRED, v)
+    BLOCK_SIZES(LOWBD_PRED, h)
+    BLOCK_SIZES(LOWBD_PRED, smooth)
+    BLOCK_SIZES(LOWBD_PRED, smooth_v)
+    BLOCK_SIZES(LOWBD_PRED, smooth_h)
+    BLOCK_SIZES(LOWBD_PRED, paeth)
+    BLOCK_SIZES(HIGHBD_PRED, dc)
+    BLOCK_SIZES(HIGHBD_PRED, dc_left)
+    BLOCK_SIZES(HIGHBD_PRED, dc_top)
+    BLOCK_SIZES(HIGHBD_PRED, dc_128)
+    BLOCK_SIZES(HIGHBD_PRED, v)
+    BLOCK_SIZES(HIGHBD_PRED, h)
+    BLOCK_SIZES(HIGHBD_PRED, smooth)
+    BLOCK_SIZES(HIGHBD_PRED, smooth_v)
+    BLOCK_SIZES(HIGHBD_PRED, smooth_h)
+    HIGHBD_PRED(dc, 2, 2)
+    HIGHBD_PRED(dc_left, 2, 2)
+    HIGHBD_PRED(dc_top, 2, 2)
+    HIGHBD_PRED(dc_128, 2, 2)
+    HIGHBD_PRED(v, 2, 2)
+    HIGHBD_PRED(h, 2, 2)
+    HIGHBD_PRED(smooth, 2, 2)
+    HIGHBD_PRED(smooth_v, 2, 2)
+    HIGHBD_PRED(smooth_h, 2, 2)
+
+    for (int w : square_sizes) {
+        RTCD_KERNEL(eb_smooth_v_predictor, w, w, w * w,
+                    k(b.dst8, kPicStride, w, w, b.above8, b.left8));
+        RTCD_KERNEL(eb_smooth_h_predictor, w, w, w * w,
+                    k(b.dst8, kPicStride, w, w, b.above8, b.left8));
+    }
+    // 45, 135 and 225 degrees
+    for (int w : square_sizes) {
+        RTCD_KERNEL(av1_dr_prediction_z1, w, w, w * w,
+                    k(b.dst8, kPicStride, w, w, b.above8, b.left8, 0, 64, 1));
+        RTCD_KERNEL(
+            av1_dr_prediction_z2, w, w, w * w,
+            k(b.dst8, kPicStride, w, w, b.above8, b.left8, 0, 0, 64, 64));
+        RTCD_KERNEL(av1_dr_prediction_z3, w, w, w * w,
+                    k(b.dst8, kPicStride, w, w, b.above8, b.left8, 0, 1, 64));
+        RTCD_KERNEL(av1_highbd_dr_prediction_z1, w, w, w * w,
+                    k(b.dst16, kPicStride, w, w, b.above16, b.left16, 0, 64,
+                      1, 10));
+        RTCD_KERNEL(av1_highbd_dr_prediction_z2, w, w, w * w,
+                    k(b.dst16, kPicStride, w, w, b.above16, b.left16, 0, 0,
+                      64, 64, 10));
+        RTCD_KERNEL(av1_highbd_dr_prediction_z3, w, w, w * w,
+                    k(b.dst16, kPicStride, w, w, b.above16, b.left16, 0, 1,
+                      64, 10));
+    }
+    for (int w : square_sizes) {
+        RTCD_KERNEL(av1_filter_intra_edge, 2 * w + 1, 1, 2 * w + 1,
+                    k(s.edge + kEdgeBorder, 2 * w + 1, 3));
+        RTCD_KERNEL(av1_filter_intra_edge_high, 2 * w + 1, 1, 2 * w + 1,
+                    k(s.edge16 + kEdgeBorder, 2 * w + 1, 3));
+    }
+    for (int sz = 8; sz <= 16; sz += 8) {
+        RTCD_KERNEL(av1_upsample_intra_edge, sz, 1, sz,
+                    memcpy(s.edge, b.above8 - kEdgeBorder, 2 * kEdgeBorder);
+                    k(s.edge + kEdgeBorder, sz));
+        RTCD_KERNEL(av1_upsample_intra_edge_high, sz, 1, sz,
+                    memcpy(s.edge16, b.above16 - kEdgeBorder,
+                           2 * kEdgeBorder * sizeof(uint16_t));
+                    k(s.edge16 + kEdgeBorder, sz, 10));
+    }
+
+    // Chroma from luma
+    for (int w : cfl_sizes) {
+        const int log2 = 2 * log2_size(w);
+        RTCD_KERNEL(subtract_average, w, w, w * w,
+                    k(s.cfl, w, w, 1 << (log2 - 1), log2));
+        RTCD_KERNEL(cfl_predict_lbd, w, w, w * w,
+                    k(s.cfl, b.dst8, kPicStride, b.dst8, kPicStride, 3, 8, w,
+                      w));
+        RTCD_KERNEL(cfl_predict_hbd, w, w, w * w,
+                    k(s.cfl, b.dst16, kPicStride, b.dst16, kPicStride, 3, 10,
+                      w, w));
+    }
+
+    // Motion estimation and distortion
+    BLOCK_SIZES_128(SAD, _)
+    BLOCK_SIZES_128(SAD_X4D, _)
+    BLOCK_SIZES_128(VARIANCE, _)
+    RTCD_KERNEL(aom_mse16x16, 16, 16, 16 * 16, uint32_t sse;
+                k(b.src8, kPicStride, b.ref8, kPicStride, &sse));
+    RTCD_KERNEL(aom_highbd_8_mse16x16, 16, 16, 16 * 16, uint32_t sse;
+                k(CONVERT_TO_BYTEPTR(b.src16), kPicStride,
+                  CONVERT_TO_BYTEPTR(b.ref16), kPicStride, &sse));
+    for (int w = 8; w <= 128; w *= 2) {
+        RTCD_KERNEL(highbd_variance64, w, w, w * w, uint64_t sse;
+                    k(b.src8, kPicStride, b.ref8, kPicStride, w, w, &sse));
+    }
+    // Every position of the search area
+    for (int w = 8; w <= 64; w *= 2) {
+        RTCD_KERNEL(sad_loop_kernel, w, w,
+                    (uint64_t)w * w * kSearchAreaWidth * kSearchAreaHeight,
+                    uint64_t best_sad; int16_t x = 0; int16_t y = 0;
+                    k(b.src8, kPicStride, b.ref8, kPicStride, w, w,
+                      &best_sad, &x, &y, kPicStride, kSearchAreaWidth,
+                      kSearchAreaHeight));
+    }
+#if NSQ_ME_OPT
+    // Eight horizontal search positions of a 64x64 block
+    RTCD_KERNEL(ext_all_sad_calculation_8x8_16x16, 64, 64, 8 * 64 * 64,
+                k(b.src8, kPicStride, b.ref8, kPicStride, 0,
+                  s.me_best_sad8x8, s.me_best_sad16x16, s.me_best_mv8x8,
+                  s.me_best_mv16x16, s.me_eight_sad16x16,
+                  s.me_eight_sad8x8));
+    RTCD_KERNEL(ext_eight_sad_calculation_32x32_64x64, 64, 64, 8 * 64 * 64,
+                k(s.me_eight_sad16x16, s.me_best_sad32x32,
+                  &s.me_best_sad64x64, s.me_best_mv32x32,
+                  &s.me_best_mv64x64, 0, s.me_eight_sad32x32));
+#endif
+    RTCD_KERNEL(eb_count_colors_16x16, 16, 16, 16 * 16,
+                k(b.src8, kPicStride, 64));
+    RTCD_KERNEL(eb_count_colors_16x16_highbd, 16, 16, 16 * 16,
+                k(b.src8, kPicStride, s.bit_inc, kPicStride, 64));
+    for (int w = 4; w <= 128; w *= 2) {
+        RTCD_KERNEL(ResidualKernel, w, w, w * w,
+                    k(b.src8, kPicStride, b.ref8, kPicStride, b.residual, w,
+                      w, w));
+    }
+    RTCD_KERNEL(av1_get_crc32c_value, 64, 64, 64 * 64,
+                k(&s.crc, b.src8, 64 * 64));
+
+    // Transforms and quantization
+    BLOCK_SIZES(FWD_TXFM, _)
+    INV_TXFM_SQUARE(4)
+    INV_TXFM_SQUARE(8)
+    INV_TXFM_SQUARE(16)
+    INV_TXFM_SQUARE(32)
+    INV_TXFM_SQUARE(64)
+    INV_TXFM_EOB(8, 16)
+    INV_TXFM_EOB(16, 8)
+    INV_TXFM_EOB(16, 32)
+    INV_TXFM_EOB(32, 16)
+    INV_TXFM_EOB(32, 8)
+    INV_TXFM_EOB(8, 32)
+    INV_TXFM_EOB(32, 64)
+    INV_TXFM_EOB(64, 32)
+    INV_TXFM_EOB(16, 64)
+    INV_TXFM_EOB(64, 16)
+    INV_TXFM_SMALL(4, 8)
+    INV_TXFM_SMALL(8, 4)
+    INV_TXFM_SMALL(4, 16)
+    INV_TXFM_SMALL(16, 4)
+    for (int w : square_sizes) {
+        const TxSize tx_size = (TxSize)(TX_4X4 + log2_size(w) - 2);
+        RTCD_KERNEL(av1_inv_txfm_add, w, w, w * w,
+                    k(b.coeff, b.dst8, kPicStride, &s.txfm_param[tx_size]));
+    }
+    for (int bd = 0; bd < 2; bd++) {
+        const SCAN_ORDER *const sc16 = &av1_scan_orders[TX_16X16][DCT_DCT];
+        const SCAN_ORDER *const sc32 = &av1_scan_orders[TX_32X32][DCT_DCT];
+        const SCAN_ORDER *const sc64 = &av1_scan_orders[TX_64X64][DCT_DCT];
+#define QUANTIZE(fn, w, n, sc)                                               \
+    RTCD_KERNEL(fn, w, w, w * w, uint16_t eob;                               \
+                k(s.qcoeff_in, n, 0, s.quants[bd].y_zbin[kQIndex],           \
+                  s.quants[bd].y_round[kQIndex],                             \
+                  s.quants[bd].y_quant[kQIndex],                             \
+                  s.quants[bd].y_quant_shift[kQIndex], s.qcoeff, s.dqcoeff, \
+                  s.dequants[bd].y_dequant_QTX[kQIndex], &eob, sc->scan,     \
+                  sc->iscan))
+        if (bd == 0) {
+            QUANTIZE(aom_quantize_b, 16, 256, sc16);
+            QUANTIZE(aom_quantize_b_32x32, 32, 1024, sc32);
+            QUANTIZE(aom_quantize_b_64x64, 64, 1024, sc64);
+        } else {
+            QUANTIZE(aom_highbd_quantize_b, 16, 256, sc16);
+            QUANTIZE(aom_highbd_quantize_b_32x32, 32, 1024, sc32);
+            QUANTIZE(aom_highbd_quantize_b_64x64, 64, 1024, sc64);
+        }
+#undef QUANTIZE
+    }
+    for (int w = 4; w <= 32; w *= 2) {
+        const TxSize tx_size = (TxSize)(TX_4X4 + log2_size(w) - 2);
+        const int16_t *const scan = av1_scan_orders[tx_size][DCT_DCT].scan;
+        RTCD_KERNEL(av1_txb_init_levels, w, w, w * w,
+                    k(b.coeff, w, w,
+                      s.levels + TX_PAD_TOP * (w + TX_PAD_HOR)));
+        RTCD_KERNEL(av1_get_nz_map_contexts, w, w, w * w,
+                    k(s.levels + TX_PAD_TOP * (w + TX_PAD_HOR), scan,
+                      (uint16_t)(w * w), tx_size, TX_CLASS_2D,
+                      s.coeff_contexts));
+    }
+    FFT(2)
+    FFT(4)
+    FFT(8)
+    FFT(16)
+    FFT(32)
+
+    // Inter prediction, half pel in both directions
+    for (int w : convolve_sizes) {
+        const int l = log2_size(w);
+        RTCD_KERNEL(av1_convolve_2d_copy_sr, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 0, 0,
+                      &s.conv_sr[0]));
+        RTCD_KERNEL(av1_convolve_2d_sr, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 8, 8,
+                      &s.conv_sr[0]));
+        RTCD_KERNEL(av1_convolve_x_sr, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 8, 0,
+                      &s.conv_sr[0]));
+        RTCD_KERNEL(av1_convolve_y_sr, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 0, 8,
+                      &s.conv_sr[0]));
+        RTCD_KERNEL(av1_jnt_convolve_2d_copy, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 0, 0,
+                      &s.conv_compound[0]));
+        RTCD_KERNEL(av1_jnt_convolve_2d, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 8, 8,
+                      &s.conv_compound[0]));
+        RTCD_KERNEL(av1_jnt_convolve_x, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 8, 0,
+                      &s.conv_compound[0]));
+        RTCD_KERNEL(av1_jnt_convolve_y, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 0, 8,
+                      &s.conv_compound[0]));
+    }
+    for (int w : convolve_sizes) {
+        const int l = log2_size(w);
+        RTCD_KERNEL(av1_highbd_convolve_2d_copy_sr, w, w, w * w,
+                    k(b.src16, kPicStride, b.dst16, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 0, 0,
+                      &s.conv_sr[1], 10));
+        RTCD_KERNEL(av1_highbd_convolve_2d_sr, w, w, w * w,
+                    k(b.src16, kPicStride, b.dst16, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 8, 8,
+                      &s.conv_sr[1], 10));
+        RTCD_KERNEL(av1_highbd_convolve_x_sr, w, w, w * w,
+                    k(b.src16, kPicStride, b.dst16, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 8, 0,
+                      &s.conv_sr[1], 10));
+        RTCD_KERNEL(av1_highbd_convolve_y_sr, w, w, w * w,
+                    k(b.src16, kPicStride, b.dst16, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 0, 8,
+                      &s.conv_sr[1], 10));
+        RTCD_KERNEL(av1_highbd_jnt_convolve_2d_copy, w, w, w * w,
+                    k(b.src16, kPicStride, b.dst16, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 0, 0,
+                      &s.conv_compound[1], 10));
+        RTCD_KERNEL(av1_highbd_jnt_convolve_2d, w, w, w * w,
+                    k(b.src16, kPicStride, b.dst16, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 8, 8,
+                      &s.conv_compound[1], 10));
+        RTCD_KERNEL(av1_highbd_jnt_convolve_x, w, w, w * w,
+                    k(b.src16, kPicStride, b.dst16, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 8, 0,
+                      &s.conv_compound[1], 10));
+        RTCD_KERNEL(av1_highbd_jnt_convolve_y, w, w, w * w,
+                    k(b.src16, kPicStride, b.dst16, kPicStride, w, w,
+                      &s.filter_params[l], &s.filter_params[l], 0, 8,
+                      &s.conv_compound[1], 10));
+    }
+
+    // CDEF, on 10-bit samples for the search kernels
+    RTCD_KERNEL(cdef_find_dir, 8, 8, 8 * 8, int32_t var;
+                k(b.src16, kPicStride, &var, 2));
+    RTCD_KERNEL(cdef_filter_block, 8, 8, 8 * 8,
+                k(b.dst8, NULL, kPicStride,
+                  s.cdef_in + CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER, 4,
+                  2, 3, 5, 5, BLOCK_8X8, 0, 0));
+    RTCD_KERNEL(cdef_filter_block, 4, 4, 4 * 4,
+                k(b.dst8, NULL, kPicStride,
+                  s.cdef_in + CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER, 4,
+                  2, 3, 5, 5, BLOCK_4X4, 0, 0));
+    RTCD_KERNEL(copy_rect8_8bit_to_16bit, 64, 64, 64 * 64,
+                k(s.cdef_in, CDEF_BSTRIDE, b.src8, kPicStride, 64, 64));
+    RTCD_KERNEL(mse_4x4_16bit, 4, 4, 4 * 4,
+                k(b.dst16, kPicStride, b.src16, kPicStride));
+    RTCD_KERNEL(dist_8x8_16bit, 8, 8, 8 * 8,
+                k(b.dst16, kPicStride, b.src16, kPicStride, 2));
+    // 64 SBs by 64 strengths
+    RTCD_KERNEL(search_one_dual, 64, 64, 64 * TOTAL_STRENGTHS,
+                k(s.cdef_lev[0], s.cdef_lev[1], 4, s.cdef_mse, 64, 0, 0,
+                  TOTAL_STRENGTHS));
+
+    // Film grain synthesis: the AR filter over a template row, the noise
+    // of a luma and a 4:2:0 chroma subblock row, and the overlap of the
+    // subblock rows
+    RTCD_KERNEL(fgn_ar_row_sum, kGrainStride - 2 * kGrainLag, 1,
+                kGrainStride - 2 * kGrainLag,
+                k(s.grain + kGrainLag * kGrainStride + kGrainLag,
+                  kGrainStride, s.grain_ar_coeffs, kGrainLag,
+                  kGrainStride - 2 * kGrainLag, s.grain_wsum));
+    RTCD_KERNEL(fgn_luma_noise_row, kGrainBlockWidth, 1, kGrainBlockWidth,
+                k(b.dst8, s.grain, kGrainBlockWidth, s.grain_scaling_lut, 11,
+                  16, 235));
+    RTCD_KERNEL(fgn_luma_noise_row_hbd, kGrainBlockWidth, 1,
+                kGrainBlockWidth,
+                k(b.dst16, s.grain, kGrainBlockWidth, s.grain_scaling_lut, 10,
+                  11, 64, 940));
+    RTCD_KERNEL(fgn_chroma_noise_row, kGrainBlockWidth / 2, 1,
+                kGrainBlockWidth / 2,
+                k(b.dst8, b.src8, s.grain, kGrainBlockWidth / 2,
+                  s.grain_scaling_lut, 1, 10, 64, 16, 11, 16, 240));
+    RTCD_KERNEL(fgn_chroma_noise_row_hbd, kGrainBlockWidth / 2, 1,
+                kGrainBlockWidth / 2,
+                k(b.dst16, b.src16, s.grain, kGrainBlockWidth / 2,
+                  s.grain_scaling_lut, 1, 10, 64, 64, 10, 11, 64, 960));
+    RTCD_KERNEL(fgn_hor_boundary_overlap, kGrainBlockWidth, 2,
+                2 * kGrainBlockWidth,
+                k(s.grain_line, kGrainStride, s.grain, kGrainStride,
+                  s.grain_line, kGrainStride, kGrainBlockWidth, 2, -512,
+                  511));
+    // Wiener filter of a noise model transform block
+    RTCD_KERNEL(aom_noise_tx_filter_block, kNoiseBlockSize, kNoiseBlockSize,
+                kNoiseBlockSize * kNoiseBlockSize,
+                k(s.noise_tx_block, s.noise_psd,
+                  kNoiseBlockSize * kNoiseBlockSize));
+
+    // Loop restoration, on restoration processing units
+    for (int w : restoration_sizes) {
+        RTCD_KERNEL(av1_wiener_convolve_add_src, w, w, w * w,
+                    k(b.src8, kPicStride, b.dst8, kPicStride, kWienerTaps, 16,
+                      kWienerTaps, 16, w, w, &s.conv_wiener[0]));
+        RTCD_KERNEL(av1_highbd_wiener_convolve_add_src, w, w, w * w,
+                    k(CONVERT_TO_BYTEPTR(b.src16), kPicStride,
+                      CONVERT_TO_BYTEPTR(b.dst16), kPicStride, kWienerTaps,
+                      16, kWienerTaps, 16, w, w, &s.conv_wiener[1], 10));
+        RTCD_KERNEL(av1_compute_stats, w, w, w * w,
+                    k(WIENER_WIN, b.ref8, b.src8, 0, w, 0, w, kPicStride,
+                      kPicStride, s.stats_m, s.stats_h));
+        RTCD_KERNEL(av1_compute_stats_highbd, w, w, w * w,
+                    k(WIENER_WIN, CONVERT_TO_BYTEPTR(b.ref16),
+                      CONVERT_TO_BYTEPTR(b.src16), 0, w, 0, w, kPicStride,
+                      kPicStride, s.stats_m, s.stats_h, AOM_BITS_10));
+        RTCD_KERNEL(av1_selfguided_restoration, w, w, w * w,
+                    k(b.src8, w, w, kPicStride, s.flt0, s.flt1, w, 0, 8, 0));
+        RTCD_KERNEL(apply_selfguided_restoration, w, w, w * w,
+                    const int32_t xqd[2] = {-32, 31};
+                    k(b.src8, w, w, kPicStride, 0, xqd, b.dst8, kPicStride,
+                      s.sgr_tmp, 8, 0));
+        RTCD_KERNEL(av1_lowbd_pixel_proj_error, w, w, w * w,
+                    int32_t xq[2] = {-32, 31};
+                    k(b.src8, w, w, kPicStride, b.ref8, kPicStride, s.flt0,
+                      w, s.flt1, w, xq, &sgr_params[0]));
+        RTCD_KERNEL(av1_highbd_pixel_proj_error, w, w, w * w,
+                    int32_t xq[2] = {-32, 31};
+                    k(CONVERT_TO_BYTEPTR(b.src16), w, w, kPicStride,
+                      CONVERT_TO_BYTEPTR(b.ref16), kPicStride, s.flt0, w,
+                      s.flt1, w, xq, &sgr_params[0]));
+        RTCD_KERNEL(get_proj_subspace, w, w, w * w, int xq[2];
+                    k(b.src8, w, w, kPicStride, b.ref8, kPicStride, 0,
+                      s.flt0, w, s.flt1, w, xq, &sgr_params[0]));
+    }
+}
+
+}  // namespace svt_av1_bench
@@ -10,6 +10,7 @@
  *        source file.
  *        Dummy source will generate a color bars and keep moving to right side,
  *        FRAME_PER_LOOP defined the frame count in on loop.
+ *        10 bit sources hold the same bars, in 16 bit samples.
  *
  * @author Cidana-Ryan
  *
@@ -56,8 +57,12 @@ class DummyVideoSource : public VideoSource {
     }
     EbErrorType open_source(const uint32_t init_pos,
                             const uint32_t frame_count) override {
-        if (image_format_ != IMG_FMT_420) {
-            printf("Open dummy source error, support YUV420 8bit only\r\n");
+        if (image_format_ != IMG_FMT_420 &&
+            (image_format_ != IMG_FMT_420P10_PACKED ||
+             svt_compressed_2bit_plane_)) {
+            printf(
+                "Open dummy source error, support YUV420 8bit or unpacked "
+                "10bit only\r\n");
             return EB_ErrorBadParameter;
         }
         init_pos_ = init_pos;
@@ -107,6 +112,21 @@ class DummyVideoSource : public VideoSource {
     }
 
   protected:
+    /*!\brief Draw the 8 bars of a 10 bit plane, starting offset samples from
+     * the left and wrapping around the right edge. */
+    static void draw_color_bars_10bit(uint8_t *plane, const uint32_t width,
+                                      const uint32_t height,
+                                      const uint8_t *colors,
+                                      const uint32_t offset) {
+        uint16_t *row = (uint16_t *)plane;
+        const uint32_t single_width = width / 8;
+
+        for (uint32_t x = 0; x < width; x++)
+            row[(x + offset) % width] = colors[x / single_width] << 2;
+        for (uint32_t l = 1; l < height; l++)
+            memcpy(row + l * width, row, width * sizeof(uint16_t));
+    }
+
     void generate_frame(const uint32_t index) {
         // generate a color bar pattern, moving with FRAME_PER_LOOP frame as one
         // loop.
@@ -118,7 +138,25 @@ class DummyVideoSource : public VideoSource {
         offset =
             (index % FRAME_PER_LOOP) * width_with_padding_ / FRAME_PER_LOOP;
         offset -= offset % 2;
-        // Support yuv420 8bit only.
+        if (is_10bit_mode()) {
+            draw_color_bars_10bit(frame_buffer_->luma,
+                                  width_with_padding_,
+                                  height_with_padding_,
+                                  color_bar_luma,
+                                  offset);
+            draw_color_bars_10bit(frame_buffer_->cb,
+                                  width_with_padding_ / 2,
+                                  height_with_padding_ / 2,
+                                  color_bar_cb,
+                                  offset / 2);
+            draw_color_bars_10bit(frame_buffer_->cr,
+                                  width_with_padding_ / 2,
+                                  height_with_padding_ / 2,
+                                  color_bar_cr,
+                                  offset / 2);
+            return;
+        }
+        // yuv420 8bit
         // luma
         src_p = frame_buffer_->luma;
         p = src_p + offset;
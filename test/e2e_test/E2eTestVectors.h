@@ -99,6 +99,12 @@ static const TestVideoVector smoking_vectors[] = {
                     0},
 };
 
+/** 8K source, checks the per picture arrays are sized from the picture */
+static const TestVideoVector resolution_8k_vectors[] = {
+    TestVideoVector{
+        "color_bar", DUMMY_SOURCE, IMG_FMT_420, 7680, 4320, 8, false, 0, 3},
+};
+
 static const TestVideoVector partial_src_frame_vectors[] = {
     TestVideoVector{"kirland_640_480_30.yuv",
                     YUV_VIDEO_FILE,
@@ -204,6 +210,35 @@ static const TestVideoVector src_resolution_death_test_vectors[] = {
                     100},
 };
 
+/** Sources of the throughput benchmark, the frames to encode are set by the
+ * benchmark */
+static const TestVideoVector benchmark_vectors[] = {
+    TestVideoVector{
+        "color_bar", DUMMY_SOURCE, IMG_FMT_420, 640, 480, 8, false, 0, 0},
+    TestVideoVector{
+        "color_bar", DUMMY_SOURCE, IMG_FMT_420, 1280, 720, 8, false, 0, 0},
+    TestVideoVector{
+        "color_bar", DUMMY_SOURCE, IMG_FMT_420, 1920, 1080, 8, false, 0, 0},
+    TestVideoVector{"color_bar",
+                    DUMMY_SOURCE,
+                    IMG_FMT_420P10_PACKED,
+                    1920,
+                    1080,
+                    10,
+                    false,
+                    0,
+                    0},
+    TestVideoVector{"park_joy_90p_10_420.y4m",
+                    Y4M_VIDEO_FILE,
+                    IMG_FMT_420P10_PACKED,
+                    160,
+                    90,
+                    10,
+                    false,
+                    0,
+                    0},
+};
+
 /** MultiInstVector */
 typedef std::tuple<TestVideoVector, /**< video source */
                    uint32_t>        /**< instance number for test */
@@ -0,0 +1,320 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file PerformanceBaseline.cc
+ *
+ * @brief Implementation of the JSON baseline of the encoder throughput
+ * benchmark
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+#include "PerformanceBaseline.h"
+
+using namespace svt_av1_e2e_tools;
+
+namespace {
+
+/** JsonValue is a parsed JSON value, enough for the files save() writes */
+typedef struct JsonValue {
+    enum Type { JSON_NULL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+    Type type;
+    double number;
+    std::string string;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue> > members;
+    JsonValue() : type(JSON_NULL), number(0) {
+    }
+    const JsonValue *member(const std::string &key) const {
+        for (const auto &m : members) {
+            if (m.first == key)
+                return &m.second;
+        }
+        return nullptr;
+    }
+    double get_number(const std::string &key) const {
+        const JsonValue *v = member(key);
+        return (v && v->type == JSON_NUMBER) ? v->number : 0;
+    }
+    std::string get_string(const std::string &key) const {
+        const JsonValue *v = member(key);
+        return (v && v->type == JSON_STRING) ? v->string : std::string();
+    }
+} JsonValue;
+
+class JsonParser {
+  public:
+    JsonParser(const std::string &text) : text_(text), pos_(0) {
+    }
+    bool parse(JsonValue &value) {
+        return parse_value(value) && (skip_space(), pos_ == text_.size());
+    }
+
+  private:
+    void skip_space() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' ||
+                text_[pos_] == '\n' || text_[pos_] == '\r'))
+            pos_++;
+    }
+    bool expect(const char c) {
+        skip_space();
+        if (pos_ >= text_.size() || text_[pos_] != c)
+            return false;
+        pos_++;
+        return true;
+    }
+    bool parse_string(std::string &str) {
+        if (!expect('"'))
+            return false;
+        str.clear();
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            if (text_[pos_] == '\\') {
+                if (++pos_ >= text_.size())
+                    return false;
+                switch (text_[pos_]) {
+                case 'n': str += '\n'; break;
+                case 't': str += '\t'; break;
+                case 'r': str += '\r'; break;
+                default: str += text_[pos_]; break;
+                }
+            } else
+                str += text_[pos_];
+            pos_++;
+        }
+        return expect('"');
+    }
+    bool parse_value(JsonValue &value) {
+        skip_space();
+        if (pos_ >= text_.size())
+            return false;
+        const char c = text_[pos_];
+        if (c == '{') {
+            value.type = JsonValue::JSON_OBJECT;
+            pos_++;
+            if (expect('}'))
+                return true;
+            do {
+                std::pair<std::string, JsonValue> m;
+                if (!parse_string(m.first) || !expect(':') ||
+                    !parse_value(m.second))
+                    return false;
+                value.members.push_back(m);
+            } while (expect(','));
+            return expect('}');
+        }
+        if (c == '[') {
+            value.type = JsonValue::JSON_ARRAY;
+            pos_++;
+            if (expect(']'))
+                return true;
+            do {
+                JsonValue item;
+                if (!parse_value(item))
+                    return false;
+                value.items.push_back(item);
+            } while (expect(','));
+            return expect(']');
+        }
+        if (c == '"') {
+            value.type = JsonValue::JSON_STRING;
+            return parse_string(value.string);
+        }
+        if (text_.compare(pos_, 4, "null") == 0) {
+            value.type = JsonValue::JSON_NULL;
+            pos_ += 4;
+            return true;
+        }
+        const char *start = text_.c_str() + pos_;
+        char *end = nullptr;
+        value.type = JsonValue::JSON_NUMBER;
+        value.number = strtod(start, &end);
+        if (end == start)
+            return false;
+        pos_ += end - start;
+        return true;
+    }
+
+    const std::string &text_;
+    size_t pos_;
+};
+
+std::string json_escape(const std::string &str) {
+    std::string out;
+    for (const char c : str) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::string format_double(const double value) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.3f", value);
+    return buf;
+}
+
+/** Writes the per-stage times as a JSON object member, without the comma */
+void write_stage_times(
+    std::ofstream &file, const char *key,
+    const std::vector<std::pair<std::string, double> > &times) {
+    file << "      \"" << key << "\": {";
+    for (size_t s = 0; s < times.size(); s++) {
+        file << (s ? ",\n" : "\n") << "        \""
+             << json_escape(times[s].first)
+             << "\": " << format_double(times[s].second);
+    }
+    file << (times.empty() ? "}" : "\n      }");
+}
+
+/** Reads the per-stage times written by write_stage_times(), if present */
+void read_stage_times(const JsonValue &item, const char *key,
+                      std::vector<std::pair<std::string, double> > &times) {
+    const JsonValue *stages = item.member(key);
+    if (stages && stages->type == JsonValue::JSON_OBJECT) {
+        for (const auto &s : stages->members)
+            times.push_back(std::make_pair(s.first, s.second.number));
+    }
+}
+
+}  // namespace
+
+void PerformanceBaseline::add(const BenchResult &result) {
+    for (BenchResult &r : results_) {
+        if (r.name == result.name) {
+            r = result;
+            return;
+        }
+    }
+    results_.push_back(result);
+}
+
+const BenchResult *PerformanceBaseline::find(const std::string &name) const {
+    for (const BenchResult &r : results_) {
+        if (r.name == name)
+            return &r;
+    }
+    return nullptr;
+}
+
+bool PerformanceBaseline::save(const std::string &path) const {
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+    file << "{\n  \"svt_av1_benchmark\": 1,\n  \"results\": [";
+    for (size_t i = 0; i < results_.size(); i++) {
+        const BenchResult &r = results_[i];
+        file << (i ? ",\n" : "\n") << "    {\n";
+        file << "      \"name\": \"" << json_escape(r.name) << "\",\n";
+        file << "      \"source\": \"" << json_escape(r.source) << "\",\n";
+        file << "      \"width\": " << r.width << ",\n";
+        file << "      \"height\": " << r.height << ",\n";
+        file << "      \"bit_depth\": " << r.bit_depth << ",\n";
+        file << "      \"enc_mode\": " << r.enc_mode << ",\n";
+        file << "      \"tile_columns\": " << r.tile_columns << ",\n";
+        file << "      \"tile_rows\": " << r.tile_rows << ",\n";
+        file << "      \"logical_processors\": " << r.logical_processors
+             << ",\n";
+        file << "      \"frames\": " << r.frames << ",\n";
+        file << "      \"fps\": " << format_double(r.fps) << ",\n";
+        file << "      \"cpu_time_ms\": " << format_double(r.cpu_time_ms)
+             << ",\n";
+        file << "      \"speedup\": " << format_double(r.speedup) << ",\n";
+        file << "      \"peak_rss_kb\": " << r.peak_rss_kb << ",\n";
+        file << "      \"committed_kb\": " << r.committed_kb << ",\n";
+        write_stage_times(file, "stage_time_ms", r.stage_time_ms);
+        file << ",\n";
+        write_stage_times(file, "stage_cpu_time_ms", r.stage_cpu_time_ms);
+        file << "\n    }";
+    }
+    file << "\n  ]\n}\n";
+    return file.good();
+}
+
+bool PerformanceBaseline::load(const std::string &path) {
+    std::ifstream file(path.c_str());
+    if (!file.is_open())
+        return false;
+    std::stringstream text;
+    text << file.rdbuf();
+
+    JsonValue root;
+    const std::string str = text.str();
+    if (!JsonParser(str).parse(root) || root.type != JsonValue::JSON_OBJECT)
+        return false;
+    const JsonValue *results = root.member("results");
+    if (results == nullptr || results->type != JsonValue::JSON_ARRAY)
+        return false;
+
+    results_.clear();
+    for (const JsonValue &item : results->items) {
+        if (item.type != JsonValue::JSON_OBJECT)
+            return false;
+        BenchResult r;
+        r.name = item.get_string("name");
+        r.source = item.get_string("source");
+        r.width = (uint32_t)item.get_number("width");
+        r.height = (uint32_t)item.get_number("height");
+        r.bit_depth = (uint32_t)item.get_number("bit_depth");
+        r.enc_mode = (uint32_t)item.get_number("enc_mode");
+        r.tile_columns = (uint32_t)item.get_number("tile_columns");
+        r.tile_rows = (uint32_t)item.get_number("tile_rows");
+        r.logical_processors = (uint32_t)item.get_number("logical_processors");
+        r.frames = (uint32_t)item.get_number("frames");
+        r.fps = item.get_number("fps");
+        r.cpu_time_ms = item.get_number("cpu_time_ms");
+        r.speedup = item.get_number("speedup");
+        r.peak_rss_kb = (uint64_t)item.get_number("peak_rss_kb");
+        r.committed_kb = (uint64_t)item.get_number("committed_kb");
+        read_stage_times(item, "stage_time_ms", r.stage_time_ms);
+        read_stage_times(item, "stage_cpu_time_ms", r.stage_cpu_time_ms);
+        if (r.name.empty())
+            return false;
+        add(r);
+    }
+    return true;
+}
+
+std::vector<std::string> PerformanceBaseline::compare(
+    const PerformanceBaseline &baseline, const double fps_tolerance,
+    const double rss_tolerance) const {
+    std::vector<std::string> regressions;
+    for (const BenchResult &r : results_) {
+        const BenchResult *base = baseline.find(r.name);
+        if (base == nullptr)
+            continue;
+        std::string report;
+        if (base->fps > 0 && r.fps < base->fps * (1.0 - fps_tolerance)) {
+            report += " fps " + format_double(base->fps) + " -> " +
+                      format_double(r.fps);
+        }
+        // peak RSS is 0 where the platform can not measure it
+        if (base->peak_rss_kb && r.peak_rss_kb &&
+            r.peak_rss_kb > base->peak_rss_kb * (1.0 + rss_tolerance)) {
+            report += " peak_rss_kb " + std::to_string(base->peak_rss_kb) +
+                      " -> " + std::to_string(r.peak_rss_kb);
+        }
+        if (report.empty())
+            continue;
+        // the stages that slowed down the most explain the regression
+        for (const auto &stage : r.stage_time_ms) {
+            for (const auto &base_stage : base->stage_time_ms) {
+                if (stage.first == base_stage.first && base_stage.second > 0 &&
+                    stage.second > base_stage.second * (1.0 + fps_tolerance)) {
+                    report += " " + stage.first + "_ms " +
+                              format_double(base_stage.second) + " -> " +
+                              format_double(stage.second);
+                }
+            }
+        }
+        regressions.push_back(r.name + ":" + report);
+    }
+    return regressions;
+}
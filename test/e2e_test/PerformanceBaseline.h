@@ -0,0 +1,109 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file PerformanceBaseline.h
+ *
+ * @brief Defines the results of the encoder throughput benchmark, their JSON
+ * baseline file and the comparison of a run against a baseline
+ *
+ ******************************************************************************/
+
+#ifndef _PERFORMANCE_BASELINE_H_
+#define _PERFORMANCE_BASELINE_H_
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace svt_av1_e2e_tools {
+
+/** BenchResult is the measure of one encoder configuration in the benchmark */
+typedef struct BenchResult {
+    std::string name;   /**< unique key of the configuration */
+    std::string source; /**< name of the test vector */
+    uint32_t width;
+    uint32_t height;
+    uint32_t bit_depth;
+    uint32_t enc_mode;
+    uint32_t tile_columns; /**< log2 of the tile columns */
+    uint32_t tile_rows;    /**< log2 of the tile rows */
+    uint32_t logical_processors;
+    uint32_t frames;      /**< frames encoded */
+    double fps;           /**< frames per second of wall-clock time */
+    double cpu_time_ms;   /**< CPU time of the process while encoding */
+    double speedup;       /**< fps over the fps of the fewest processors */
+    uint64_t peak_rss_kb; /**< peak resident set size, 0 if unknown */
+    uint64_t committed_kb; /**< memory committed by the encoder */
+    /** wall-clock processing time of each pipeline stage, summed over its
+     * threads */
+    std::vector<std::pair<std::string, double> > stage_time_ms;
+    /** CPU time of each pipeline stage, summed over its threads */
+    std::vector<std::pair<std::string, double> > stage_cpu_time_ms;
+    BenchResult()
+        : width(0),
+          height(0),
+          bit_depth(0),
+          enc_mode(0),
+          tile_columns(0),
+          tile_rows(0),
+          logical_processors(0),
+          frames(0),
+          fps(0),
+          cpu_time_ms(0),
+          speedup(0),
+          peak_rss_kb(0),
+          committed_kb(0) {
+    }
+} BenchResult;
+
+/** PerformanceBaseline is a set of benchmark results, saved to and loaded from
+ * a JSON file. A baseline is only meaningful on the machine it was recorded
+ * on. */
+class PerformanceBaseline {
+  public:
+    /** Add a result, replacing the one with the same name */
+    void add(const BenchResult &result);
+    /** Find the result of a configuration
+     * @param name the key of the configuration
+     * @return
+     * the result -- found <br>
+     * nullptr -- not in the baseline
+     */
+    const BenchResult *find(const std::string &name) const;
+    const std::vector<BenchResult> &results() const {
+        return results_;
+    }
+    /** Write the results as JSON
+     * @return
+     * true -- written <br>
+     * false -- the file can not be written
+     */
+    bool save(const std::string &path) const;
+    /** Read the results of a JSON file written by save()
+     * @return
+     * true -- read <br>
+     * false -- the file is missing or malformed
+     */
+    bool load(const std::string &path);
+    /** Compare results with a baseline, a configuration regresses when its fps
+     * drops by more than fps_tolerance or its peak RSS grows by more than
+     * rss_tolerance (both fractions of the baseline). Configurations missing
+     * from the baseline are skipped.
+     * @return
+     * descriptions of the regressions, empty when there is none
+     */
+    std::vector<std::string> compare(const PerformanceBaseline &baseline,
+                                     const double fps_tolerance,
+                                     const double rss_tolerance) const;
+
+  private:
+    std::vector<BenchResult> results_;
+};
+
+}  // namespace svt_av1_e2e_tools
+
+#endif  // !_PERFORMANCE_BASELINE_H_
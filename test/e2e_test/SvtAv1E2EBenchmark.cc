@@ -0,0 +1,357 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file SvtAv1E2EBenchmark.cc
+ *
+ * @brief Encoder throughput regression benchmark. Encodes the benchmark
+ * vectors for every enc_mode, tile configuration and logical_processors and
+ * records the fps, CPU time, processing time of each pipeline stage, peak RSS
+ * and the speedup over the fewest logical processors (the thread scaling
+ * curve). The results are written to a JSON baseline, and a later run
+ * compared with a baseline fails when a configuration regressed.
+ *
+ * The benchmark is disabled, run it with
+ *   SvtAv1E2ETests --gtest_also_run_disabled_tests
+ *                  --gtest_filter=SvtAv1E2EBenchmark.*
+ * and the environment variables:
+ *   SVT_AV1_BENCH_OUTPUT         JSON file the results are written to
+ *   SVT_AV1_BENCH_BASELINE       JSON file of a previous run to compare with
+ *   SVT_AV1_BENCH_FRAMES         frames to encode per configuration, 30
+ *   SVT_AV1_BENCH_ENC_MODES      enc_mode list, "8,5"
+ *   SVT_AV1_BENCH_LP             logical_processors list, powers of 2 up to
+ *                                the processor count
+ *   SVT_AV1_BENCH_FPS_TOLERANCE  fps drop tolerated, 0.05
+ *   SVT_AV1_BENCH_RSS_TOLERANCE  peak RSS growth tolerated, 0.10
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#ifdef _WIN32
+#define NOMINMAX  // keep std::max usable
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "gtest/gtest.h"
+#include "EbSvtAv1Enc.h"
+#include "SvtAv1E2EFramework.h"
+#include "PerformanceBaseline.h"
+
+using namespace svt_av1_e2e_test;
+using namespace svt_av1_e2e_tools;
+
+namespace {
+
+/** Tile configurations of the sweep, log2 of the columns and rows */
+static const uint32_t bench_tiles[][2] = {{0, 0}, {1, 0}, {1, 1}};
+
+std::vector<uint32_t> get_env_list(const char *name,
+                                   const std::vector<uint32_t> &def) {
+    const char *const str = getenv(name);
+    if (str == nullptr || *str == '\0')
+        return def;
+    std::vector<uint32_t> list;
+    std::stringstream stream(str);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        list.push_back((uint32_t)strtoul(item.c_str(), nullptr, 10));
+    return list;
+}
+
+double get_env_double(const char *name, const double def) {
+    const char *const str = getenv(name);
+    return (str == nullptr || *str == '\0') ? def : strtod(str, nullptr);
+}
+
+std::vector<uint32_t> default_lp_list() {
+    const uint32_t processors =
+        std::max(1u, (uint32_t)std::thread::hardware_concurrency());
+    std::vector<uint32_t> list;
+    for (uint32_t lp = 1; lp < processors; lp *= 2)
+        list.push_back(lp);
+    list.push_back(processors);
+    return list;
+}
+
+/** Restart the peak RSS of the process, Linux only */
+void reset_peak_rss() {
+#ifdef __linux__
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs.is_open())
+        clear_refs << "5";
+#endif
+}
+
+/** Peak RSS of the process since reset_peak_rss(), in kB, 0 if unknown */
+uint64_t read_peak_rss_kb() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return strtoull(line.c_str() + 6, nullptr, 10);
+    }
+#endif
+    return 0;
+}
+
+/** CPU time of all the threads of the process, in ms, 0 if unknown */
+double read_cpu_time_ms() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (GetProcessTimes(
+            GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        // kernel and user times are in 100 ns units
+        return ((((uint64_t)kernel.dwHighDateTime << 32) |
+                 kernel.dwLowDateTime) +
+                (((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime)) /
+               10000.0;
+    }
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+               (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+    }
+#endif
+    return 0;
+}
+
+std::string config_name(const TestVideoVector &vector, const uint32_t enc_mode,
+                        const uint32_t tile_columns, const uint32_t tile_rows,
+                        const uint32_t lp) {
+    char name[256];
+    snprintf(name,
+             sizeof(name),
+             "%s_%ux%u_%ubit_m%u_tile%ux%u_lp%u",
+             std::get<0>(vector).c_str(),
+             std::get<3>(vector),
+             std::get<4>(vector),
+             (uint32_t)std::get<5>(vector),
+             enc_mode,
+             tile_columns,
+             tile_rows,
+             lp);
+    return name;
+}
+
+/** Encode the frames of a source with one configuration and measure it. The
+ * result is left with no frame when the source can not be opened. */
+void run_config(const TestVideoVector &vector, const uint32_t frames,
+                const uint32_t enc_mode, const uint32_t tile_columns,
+                const uint32_t tile_rows, const uint32_t lp,
+                BenchResult &result) {
+    EbErrorType return_error = EB_ErrorNone;
+    VideoSource *video_src = SvtAv1E2ETestFramework::prepare_video_src(vector);
+    ASSERT_NE(video_src, nullptr) << "video source create failed!";
+    if (video_src->open_source(0, frames) != EB_ErrorNone) {
+        printf("skip %s, source not available\n",
+               std::get<0>(vector).c_str());
+        delete video_src;
+        return;
+    }
+    const uint32_t width = video_src->get_width_with_padding();
+    const uint32_t height = video_src->get_height_with_padding();
+
+    SvtAv1Context ctxt;
+    memset(&ctxt, 0, sizeof(ctxt));
+    return_error = eb_init_handle(&ctxt.enc_handle, &ctxt, &ctxt.enc_params);
+    ASSERT_EQ(return_error, EB_ErrorNone)
+        << "eb_init_handle return error:" << return_error;
+    SvtAv1E2ETestFramework::setup_src_param(video_src, ctxt.enc_params);
+    ctxt.enc_params.enc_mode = (uint8_t)enc_mode;
+    ctxt.enc_params.logical_processors = lp;
+#if TILES
+    ctxt.enc_params.tile_columns = tile_columns;
+    ctxt.enc_params.tile_rows = tile_rows;
+#endif
+    ctxt.enc_params.enable_pipeline_stats = EB_TRUE;
+    ctxt.enc_params.recon_enabled = 0;
+    return_error = eb_svt_enc_set_parameter(ctxt.enc_handle, &ctxt.enc_params);
+    ASSERT_EQ(return_error, EB_ErrorNone)
+        << "eb_svt_enc_set_parameter return error:" << return_error;
+
+    // the peak RSS covers the allocations of the encoder
+    reset_peak_rss();
+    return_error = eb_init_encoder(ctxt.enc_handle);
+    ASSERT_EQ(return_error, EB_ErrorNone)
+        << "eb_init_encoder return error:" << return_error;
+
+    EbBufferHeaderType input_buffer;
+    memset(&input_buffer, 0, sizeof(input_buffer));
+    input_buffer.size = sizeof(EbBufferHeaderType);
+    input_buffer.pic_type = EB_AV1_INVALID_PICTURE;
+    ctxt.input_picture_buffer = &input_buffer;
+
+    const auto start = std::chrono::steady_clock::now();
+    const double start_cpu_ms = read_cpu_time_ms();
+    uint32_t frame_count = 0;
+    bool src_eos = false;
+    bool enc_eos = false;
+    while (!enc_eos) {
+        if (!src_eos) {
+            uint8_t *frame = (uint8_t *)video_src->get_next_frame();
+            if (frame) {
+                input_buffer.p_buffer = frame;
+                input_buffer.n_filled_len = video_src->get_frame_size();
+                input_buffer.flags = 0;
+                input_buffer.pts = video_src->get_frame_index();
+                input_buffer.pic_type = EB_AV1_INVALID_PICTURE;
+                EXPECT_EQ(EB_ErrorNone,
+                          return_error = eb_svt_enc_send_picture(
+                              ctxt.enc_handle, &input_buffer))
+                    << "eb_svt_enc_send_picture error at: "
+                    << input_buffer.pts;
+                frame_count++;
+            } else {
+                src_eos = true;
+                EbBufferHeaderType header_last;
+                memset(&header_last, 0, sizeof(header_last));
+                header_last.flags = EB_BUFFERFLAG_EOS;
+                header_last.pic_type = EB_AV1_INVALID_PICTURE;
+                EXPECT_EQ(EB_ErrorNone,
+                          return_error = eb_svt_enc_send_picture(
+                              ctxt.enc_handle, &header_last))
+                    << "eb_svt_enc_send_picture EOS error";
+            }
+        }
+
+        // drain the packets, blocking once every picture was sent
+        do {
+            EbBufferHeaderType *enc_out = nullptr;
+            return_error = eb_svt_get_packet(
+                ctxt.enc_handle, &enc_out, src_eos ? 1 : 0);
+            ASSERT_NE(return_error, EB_ErrorMax) << "Error while encoding";
+            if (return_error != EB_NoErrorEmptyQueue && enc_out) {
+                if (enc_out->flags & EB_BUFFERFLAG_EOS)
+                    enc_eos = true;
+                eb_svt_release_out_buffer(&enc_out);
+            }
+        } while (return_error != EB_NoErrorEmptyQueue && !enc_eos);
+    }
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count();
+
+    result.name = config_name(vector, enc_mode, tile_columns, tile_rows, lp);
+    result.source = std::get<0>(vector);
+    result.width = width;
+    result.height = height;
+    result.bit_depth = video_src->get_bit_depth();
+    result.enc_mode = enc_mode;
+    result.tile_columns = tile_columns;
+    result.tile_rows = tile_rows;
+    result.logical_processors = lp;
+    result.frames = frame_count;
+    result.fps = elapsed_ms > 0 ? frame_count * 1000.0 / elapsed_ms : 0;
+    result.cpu_time_ms = read_cpu_time_ms() - start_cpu_ms;
+    result.peak_rss_kb = read_peak_rss_kb();
+
+    EbSvtEncStats *stats = new EbSvtEncStats;
+    if (eb_svt_enc_get_stats(ctxt.enc_handle, stats) == EB_ErrorNone) {
+        for (uint32_t i = 0; i < stats->stage_count; i++) {
+            const EbPipelineStageStats &stage = stats->stage_array[i];
+            result.stage_time_ms.push_back(std::make_pair(
+                std::string(stage.stage_name),
+                stage.processing_time_us / 1000.0));
+            result.stage_cpu_time_ms.push_back(std::make_pair(
+                std::string(stage.stage_name), stage.cpu_time_us / 1000.0));
+        }
+    }
+    delete stats;
+    EbSvtMemoryUsage *usage = new EbSvtMemoryUsage;
+    if (eb_svt_enc_get_memory_usage(ctxt.enc_handle, usage) == EB_ErrorNone)
+        result.committed_kb = usage->total_committed_bytes / 1024;
+    delete usage;
+
+    return_error = eb_deinit_encoder(ctxt.enc_handle);
+    EXPECT_EQ(return_error, EB_ErrorNone)
+        << "eb_deinit_encoder return error:" << return_error;
+    return_error = eb_deinit_handle(ctxt.enc_handle);
+    EXPECT_EQ(return_error, EB_ErrorNone)
+        << "eb_deinit_handle return error:" << return_error;
+    video_src->close_source();
+    delete video_src;
+}
+
+}  // namespace
+
+TEST(SvtAv1E2EBenchmark, DISABLED_throughput_sweep) {
+    const uint32_t frames =
+        (uint32_t)get_env_double("SVT_AV1_BENCH_FRAMES", 30);
+    const std::vector<uint32_t> enc_modes =
+        get_env_list("SVT_AV1_BENCH_ENC_MODES", {8, 5});
+    const std::vector<uint32_t> lp_list =
+        get_env_list("SVT_AV1_BENCH_LP", default_lp_list());
+    const double fps_tolerance =
+        get_env_double("SVT_AV1_BENCH_FPS_TOLERANCE", 0.05);
+    const double rss_tolerance =
+        get_env_double("SVT_AV1_BENCH_RSS_TOLERANCE", 0.10);
+
+    PerformanceBaseline run;
+    for (const TestVideoVector &vector : benchmark_vectors) {
+        for (const uint32_t enc_mode : enc_modes) {
+            for (const auto &tiles : bench_tiles) {
+                double first_fps = 0;
+                for (const uint32_t lp : lp_list) {
+                    BenchResult result;
+                    run_config(
+                        vector, frames, enc_mode, tiles[0], tiles[1], lp,
+                        result);
+                    if (::testing::Test::HasFatalFailure())
+                        return;
+                    if (result.frames == 0)
+                        break;
+                    // speedup over the first (fewest) logical processors
+                    if (first_fps == 0)
+                        first_fps = result.fps;
+                    result.speedup = first_fps > 0 ? result.fps / first_fps : 0;
+                    printf("%-48s fps %8.2f speedup %5.2fx cpu %10.1fms "
+                           "rss %8lukB\n",
+                           result.name.c_str(),
+                           result.fps,
+                           result.speedup,
+                           result.cpu_time_ms,
+                           (unsigned long)result.peak_rss_kb);
+                    // wall-clock and CPU time of each stage
+                    for (size_t s = 0; s < result.stage_time_ms.size(); s++)
+                        printf("    %-24s wall %10.1fms cpu %10.1fms\n",
+                               result.stage_time_ms[s].first.c_str(),
+                               result.stage_time_ms[s].second,
+                               result.stage_cpu_time_ms[s].second);
+                    run.add(result);
+                }
+            }
+        }
+    }
+
+    const char *const output = getenv("SVT_AV1_BENCH_OUTPUT");
+    if (output && *output) {
+        EXPECT_TRUE(run.save(output))
+            << "can not write benchmark results to " << output;
+    }
+
+    const char *const baseline_path = getenv("SVT_AV1_BENCH_BASELINE");
+    if (baseline_path && *baseline_path) {
+        PerformanceBaseline baseline;
+        ASSERT_TRUE(baseline.load(baseline_path))
+            << "can not read benchmark baseline " << baseline_path;
+        const std::vector<std::string> regressions =
+            run.compare(baseline, fps_tolerance, rss_tolerance);
+        for (const std::string &regression : regressions)
+            printf("regression %s\n", regression.c_str());
+        EXPECT_TRUE(regressions.empty())
+            << regressions.size() << " configurations regressed against "
+            << baseline_path;
+    }
+}
@@ -489,6 +489,10 @@ PARAM_TEST(SvtAv1E2EParamExtBlockTest);
 DEFINE_PARAM_TEST_CLASS(SvtAv1E2EParamInLoopMeTest, in_loop_me_flag);
 PARAM_TEST(SvtAv1E2EParamInLoopMeTest);
 
+/** Test case for md_recon_cache_flag*/
+DEFINE_PARAM_TEST_CLASS(SvtAv1E2EParamMdReconCacheTest, md_recon_cache_flag);
+PARAM_TEST(SvtAv1E2EParamMdReconCacheTest);
+
 /** Test case for search_area_width*/
 DEFINE_PARAM_TEST_CLASS(SvtAv1E2EParamSearchAreaWidthTest, search_area_width);
 PARAM_TEST(SvtAv1E2EParamSearchAreaWidthTest);
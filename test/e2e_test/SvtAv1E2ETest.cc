@@ -12,6 +12,9 @@
  *
  ******************************************************************************/
 
+#include <stdio.h>
+#include <string>
+#include <vector>
 #include "EbSvtAv1Enc.h"
 #include "gtest/gtest.h"
 #include "SvtAv1E2EFramework.h"
@@ -231,6 +234,38 @@ TEST_P(SvtAv1E2ELongTimeConformanceTest, run_conformance_test) {
 INSTANTIATE_TEST_CASE_P(SVT_AV1, SvtAv1E2ELongTimeConformanceTest,
                         ::testing::ValuesIn(longtime_comformance_test_vectors));
 
+/**
+ * @brief SVT-AV1 encoder E2E test with comparing the reconstructed frames with
+ * output frames from decoder buffer list at 8K
+ *
+ * Test strategy:
+ * Setup SVT-AV1 encoder with enc_mode 8, and encode 3 frames of a 7680x4320
+ * source. Collect the reconstructed frames and compared them with reference
+ * decoder output.
+ *
+ * Expected result:
+ * No error is reported in encoding progress. The reconstructed frame
+ * data is same as the output frame from reference decoder.
+ *
+ * Test coverage:
+ * 8K test vectors
+ */
+class SvtAv1E2E8KConformanceTest : public SvtAv1E2EConformanceTest {
+  protected:
+    /** initialization for test */
+    void init_test() override {
+        av1enc_ctx_.enc_params.enc_mode = 8;
+        SvtAv1E2EConformanceTest::init_test();
+    }
+};
+
+TEST_P(SvtAv1E2E8KConformanceTest, run_conformance_test) {
+    run_encode_process();
+}
+
+INSTANTIATE_TEST_CASE_P(SVT_AV1, SvtAv1E2E8KConformanceTest,
+                        ::testing::ValuesIn(resolution_8k_vectors));
+
 /* @brief SVT-AV1 encoder E2E test by comparing the reconstruction frames with
  * output frame from decoder buffer list, but found dead in linux
  *
@@ -306,3 +341,74 @@ TEST_P(SvtAv1E2ERepeatConformanceTest, repeat_encode_process) {
 
 INSTANTIATE_TEST_CASE_P(SVT_AV1, SvtAv1E2ERepeatConformanceTest,
                         ::testing::ValuesIn(comformance_test_vectors));
+
+/**
+ * @brief SVT-AV1 encoder E2E test of the MD recon cache
+ *
+ * Test strategy:
+ * Encode the input YUV data frames with md_recon_cache_flag on, then again
+ * with it off, saving the compressed data of each encode into an IVF file.
+ *
+ * Expected result:
+ * No error is reported in encoding progress. The two IVF files are the
+ * same byte for byte: the encode pass only commits the luma of MD when
+ * coding it again would give the same result.
+ *
+ * Test coverage:
+ * Smoking test vectors
+ */
+class SvtAv1E2EMdReconCacheTest : public SvtAv1E2ETestFramework {
+  protected:
+    SvtAv1E2EMdReconCacheTest() : md_recon_cache_flag_(EB_TRUE) {
+    }
+    /** initialization for test */
+    void init_test() override {
+        if (output_file_)
+            delete output_file_;
+        output_file_ = new IvfFile(output_path(md_recon_cache_flag_));
+        av1enc_ctx_.enc_params.md_recon_cache_flag = md_recon_cache_flag_;
+        SvtAv1E2ETestFramework::init_test();
+    }
+    static std::string output_path(EbBool md_recon_cache_flag) {
+        return md_recon_cache_flag ? "md_recon_cache_on.av1"
+                                   : "md_recon_cache_off.av1";
+    }
+    static std::vector<uint8_t> read_file(const std::string &path) {
+        std::vector<uint8_t> data;
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file) {
+            uint8_t buffer[4096];
+            size_t size;
+            while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+                data.insert(data.end(), buffer, buffer + size);
+            fclose(file);
+        }
+        return data;
+    }
+
+  protected:
+    EbBool md_recon_cache_flag_;
+};
+
+TEST_P(SvtAv1E2EMdReconCacheTest, bitstream_matches_without_cache) {
+    run_encode_process();
+    TearDown();
+
+    md_recon_cache_flag_ = EB_FALSE;
+    SetUp();
+    run_encode_process();
+    // close the file to flush it
+    delete output_file_;
+    output_file_ = nullptr;
+
+    const std::vector<uint8_t> with_cache = read_file(output_path(EB_TRUE));
+    const std::vector<uint8_t> without_cache =
+        read_file(output_path(EB_FALSE));
+    ASSERT_GT(with_cache.size(), 0u);
+    EXPECT_TRUE(with_cache == without_cache)
+        << "bitstream changes with the MD recon cache: " << with_cache.size()
+        << " bytes with it, " << without_cache.size() << " without";
+}
+
+INSTANTIATE_TEST_CASE_P(SVT_AV1, SvtAv1E2EMdReconCacheTest,
+                        ::testing::ValuesIn(smoking_vectors));
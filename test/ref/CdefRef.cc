@@ -0,0 +1,359 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file CdefRef.cc
+ *
+ * @brief reference implementation for the CDEF application, including :
+ * - cdef_frame_ref
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <vector>
+#include "CdefRef.h"
+#include "EbCdef.h"
+#include "aom_dsp_rtcd.h"
+
+/* Defined in EbCdef.c */
+extern "C" int32_t sb_compute_cdef_list(PictureControlSet_t *pcs,
+                                        const Av1Common *const cm,
+                                        int32_t mi_row, int32_t mi_col,
+                                        cdef_list *dlist, block_size bs);
+
+namespace svt_av1_test_reference {
+
+static void copy_sb8_16(uint16_t *dst, int32_t dstride, const uint8_t *src,
+                        int32_t src_voffset, int32_t src_hoffset,
+                        int32_t sstride, int32_t vsize, int32_t hsize) {
+    const uint8_t *base = &src[src_voffset * sstride + src_hoffset];
+
+    copy_rect8_8bit_to_16bit(dst, dstride, base, sstride, vsize, hsize);
+}
+
+static void fill_rect(uint16_t *dst, int32_t dstride, int32_t v, int32_t h,
+                      uint16_t x) {
+    for (int32_t i = 0; i < v; i++) {
+        for (int32_t j = 0; j < h; j++)
+            dst[i * dstride + j] = x;
+    }
+}
+
+static void copy_rect(uint16_t *dst, int32_t dstride, const uint16_t *src,
+                      int32_t sstride, int32_t v, int32_t h) {
+    for (int32_t i = 0; i < v; i++) {
+        for (int32_t j = 0; j < h; j++)
+            dst[i * dstride + j] = src[i * sstride + j];
+    }
+}
+
+void cdef_frame_ref(SequenceControlSet *scs, PictureControlSet_t *pcs) {
+    PictureParentControlSet_t *ppcs = pcs->parent_pcs_ptr;
+    Av1Common *cm = ppcs->av1_cm;
+    EbPictureBufferDesc_t *recon = pcs->recon_picture_ptr;
+    EbByte rec_buf[3] = {
+        &recon->buffer_y[recon->origin_x + recon->origin_y * recon->stride_y],
+        &recon->bufferCb[recon->origin_x / 2 +
+                         recon->origin_y / 2 * recon->strideCb],
+        &recon->bufferCr[recon->origin_x / 2 +
+                         recon->origin_y / 2 * recon->strideCr]};
+    const int32_t rec_stride[3] = {
+        recon->stride_y, recon->strideCb, recon->strideCr};
+
+    DECLARE_ALIGNED(16, uint16_t, src[CDEF_INBUF_SIZE]);
+    cdef_list dlist[MI_SIZE_64X64 * MI_SIZE_64X64];
+    int32_t cdef_count;
+    int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS] = {{0}};
+    int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS] = {{0}};
+    int32_t mi_wide_l2[3];
+    int32_t mi_high_l2[3];
+    int32_t dec[3];
+    const int32_t coeff_shift =
+        AOMMAX((int32_t)scs->static_config.encoder_bit_depth - 8, 0);
+    const int32_t nvfb = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+    const int32_t nhfb = (cm->mi_cols + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+    const int32_t stride = (cm->mi_cols << MI_SIZE_LOG2) + 2 * CDEF_HBORDER;
+
+    // Whether each filter block of the previous and current rows is filtered,
+    // with a column of padding on each side
+    std::vector<uint8_t> row_cdef((nhfb + 2) * 2, 1);
+    uint8_t *prev_row_cdef = row_cdef.data() + 1;
+    uint8_t *curr_row_cdef = prev_row_cdef + nhfb + 2;
+    std::vector<uint16_t> linebuf[3];
+    std::vector<uint16_t> colbuf[3];
+
+    for (int32_t pli = 0; pli < 3; pli++) {
+        dec[pli] = pli ? 1 : 0;
+        mi_wide_l2[pli] = MI_SIZE_LOG2 - dec[pli];
+        mi_high_l2[pli] = MI_SIZE_LOG2 - dec[pli];
+        linebuf[pli].resize(CDEF_VBORDER * stride);
+        colbuf[pli].resize(((CDEF_BLOCKSIZE << mi_high_l2[pli]) +
+                            2 * CDEF_VBORDER) *
+                           CDEF_HBORDER);
+    }
+
+    for (int32_t fbr = 0; fbr < nvfb; fbr++) {
+        for (int32_t pli = 0; pli < 3; pli++) {
+            const int32_t block_height =
+                (MI_SIZE_64X64 << mi_high_l2[pli]) + 2 * CDEF_VBORDER;
+            fill_rect(colbuf[pli].data(),
+                      CDEF_HBORDER,
+                      block_height,
+                      CDEF_HBORDER,
+                      CDEF_VERY_LARGE);
+        }
+
+        int32_t cdef_left = 1;
+        for (int32_t fbc = 0; fbc < nhfb; fbc++) {
+            int32_t level, sec_strength;
+            int32_t uv_level, uv_sec_strength;
+            int32_t cstart = 0;
+            ModeInfo *mi =
+                pcs->mi_grid_base[MI_SIZE_64X64 * fbr * cm->mi_stride +
+                                  MI_SIZE_64X64 * fbc];
+            curr_row_cdef[fbc] = 0;
+
+            if (mi == NULL || mi->mbmi.cdef_strength == -1) {
+                cdef_left = 0;
+                continue;
+            }
+            if (!cdef_left)
+                cstart = -CDEF_HBORDER;
+
+            const int32_t nhb =
+                AOMMIN(MI_SIZE_64X64, cm->mi_cols - MI_SIZE_64X64 * fbc);
+            const int32_t nvb =
+                AOMMIN(MI_SIZE_64X64, cm->mi_rows - MI_SIZE_64X64 * fbr);
+            const int32_t mi_row = MI_SIZE_64X64 * fbr;
+            const int32_t mi_col = MI_SIZE_64X64 * fbc;
+            const int32_t frame_top = mi_row == 0;
+            const int32_t frame_left = mi_col == 0;
+            const int32_t frame_bottom =
+                fbr == nvfb - 1 || mi_row + MI_SIZE_64X64 == cm->mi_rows;
+            const int32_t frame_right =
+                fbc == nhfb - 1 || mi_col + MI_SIZE_64X64 == cm->mi_cols;
+
+            const int32_t strength = mi->mbmi.cdef_strength;
+            level = ppcs->cdef_strengths[strength] / CDEF_SEC_STRENGTHS;
+            sec_strength = ppcs->cdef_strengths[strength] % CDEF_SEC_STRENGTHS;
+            sec_strength += sec_strength == 3;
+            uv_level = ppcs->cdef_uv_strengths[strength] / CDEF_SEC_STRENGTHS;
+            uv_sec_strength =
+                ppcs->cdef_uv_strengths[strength] % CDEF_SEC_STRENGTHS;
+            uv_sec_strength += uv_sec_strength == 3;
+            if ((level == 0 && sec_strength == 0 && uv_level == 0 &&
+                 uv_sec_strength == 0) ||
+                (cdef_count = sb_compute_cdef_list(
+                     pcs, cm, mi_row, mi_col, dlist, BLOCK_64X64)) == 0) {
+                cdef_left = 0;
+                continue;
+            }
+
+            curr_row_cdef[fbc] = 1;
+            for (int32_t pli = 0; pli < 3; pli++) {
+                const int32_t hsize = nhb << mi_wide_l2[pli];
+                const int32_t vsize = nvb << mi_high_l2[pli];
+                const int32_t cend =
+                    fbc == nhfb - 1 ? hsize : hsize + CDEF_HBORDER;
+                const int32_t rend =
+                    fbr == nvfb - 1 ? vsize : vsize + CDEF_VBORDER;
+                const int32_t coffset = fbc * MI_SIZE_64X64 << mi_wide_l2[pli];
+                const int32_t block_rows = MI_SIZE_64X64 << mi_high_l2[pli];
+                const int32_t row_offset = block_rows * fbr;
+                uint16_t *line = linebuf[pli].data();
+                uint16_t *col = colbuf[pli].data();
+
+                if (pli) {
+                    level = uv_level;
+                    sec_strength = uv_sec_strength;
+                }
+
+                if (fbc == nhfb - 1) {
+                    fill_rect(&src[cend + CDEF_HBORDER],
+                              CDEF_BSTRIDE,
+                              rend + CDEF_VBORDER,
+                              hsize + CDEF_HBORDER - cend,
+                              CDEF_VERY_LARGE);
+                }
+                if (fbr == nvfb - 1) {
+                    fill_rect(&src[(rend + CDEF_VBORDER) * CDEF_BSTRIDE],
+                              CDEF_BSTRIDE,
+                              CDEF_VBORDER,
+                              hsize + 2 * CDEF_HBORDER,
+                              CDEF_VERY_LARGE);
+                }
+
+                // The current block and the unfiltered lines below it
+                copy_sb8_16(
+                    &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER + cstart],
+                    CDEF_BSTRIDE,
+                    rec_buf[pli],
+                    row_offset,
+                    coffset + cstart,
+                    rec_stride[pli],
+                    rend,
+                    cend - cstart);
+
+                // The lines above, from the recon where the row above was not
+                // filtered and from the saved lines where it was
+                if (!prev_row_cdef[fbc]) {
+                    copy_sb8_16(&src[CDEF_HBORDER],
+                                CDEF_BSTRIDE,
+                                rec_buf[pli],
+                                row_offset - CDEF_VBORDER,
+                                coffset,
+                                rec_stride[pli],
+                                CDEF_VBORDER,
+                                hsize);
+                } else if (fbr > 0) {
+                    copy_rect(&src[CDEF_HBORDER],
+                              CDEF_BSTRIDE,
+                              &line[coffset],
+                              stride,
+                              CDEF_VBORDER,
+                              hsize);
+                } else {
+                    fill_rect(&src[CDEF_HBORDER],
+                              CDEF_BSTRIDE,
+                              CDEF_VBORDER,
+                              hsize,
+                              CDEF_VERY_LARGE);
+                }
+
+                if (!prev_row_cdef[fbc - 1]) {
+                    copy_sb8_16(src,
+                                CDEF_BSTRIDE,
+                                rec_buf[pli],
+                                row_offset - CDEF_VBORDER,
+                                coffset - CDEF_HBORDER,
+                                rec_stride[pli],
+                                CDEF_VBORDER,
+                                CDEF_HBORDER);
+                } else if (fbr > 0 && fbc > 0) {
+                    copy_rect(src,
+                              CDEF_BSTRIDE,
+                              &line[coffset - CDEF_HBORDER],
+                              stride,
+                              CDEF_VBORDER,
+                              CDEF_HBORDER);
+                } else {
+                    fill_rect(src,
+                              CDEF_BSTRIDE,
+                              CDEF_VBORDER,
+                              CDEF_HBORDER,
+                              CDEF_VERY_LARGE);
+                }
+
+                if (!prev_row_cdef[fbc + 1]) {
+                    copy_sb8_16(&src[CDEF_HBORDER + hsize],
+                                CDEF_BSTRIDE,
+                                rec_buf[pli],
+                                row_offset - CDEF_VBORDER,
+                                coffset + hsize,
+                                rec_stride[pli],
+                                CDEF_VBORDER,
+                                CDEF_HBORDER);
+                } else if (fbr > 0 && fbc < nhfb - 1) {
+                    copy_rect(&src[hsize + CDEF_HBORDER],
+                              CDEF_BSTRIDE,
+                              &line[coffset + hsize],
+                              stride,
+                              CDEF_VBORDER,
+                              CDEF_HBORDER);
+                } else {
+                    fill_rect(&src[hsize + CDEF_HBORDER],
+                              CDEF_BSTRIDE,
+                              CDEF_VBORDER,
+                              CDEF_HBORDER,
+                              CDEF_VERY_LARGE);
+                }
+
+                // The unfiltered columns of the block on the left
+                if (cdef_left) {
+                    copy_rect(src,
+                              CDEF_BSTRIDE,
+                              col,
+                              CDEF_HBORDER,
+                              rend + CDEF_VBORDER,
+                              CDEF_HBORDER);
+                }
+                if (fbc < nhfb - 1) {
+                    copy_rect(col,
+                              CDEF_HBORDER,
+                              src + hsize,
+                              CDEF_BSTRIDE,
+                              rend + CDEF_VBORDER,
+                              CDEF_HBORDER);
+                }
+
+                // Save the lines above the next row before filtering them
+                if (fbr < nvfb - 1) {
+                    copy_sb8_16(&line[coffset],
+                                stride,
+                                rec_buf[pli],
+                                row_offset + block_rows - CDEF_VBORDER,
+                                coffset,
+                                rec_stride[pli],
+                                CDEF_VBORDER,
+                                hsize);
+                }
+
+                if (frame_top) {
+                    fill_rect(src,
+                              CDEF_BSTRIDE,
+                              CDEF_VBORDER,
+                              hsize + 2 * CDEF_HBORDER,
+                              CDEF_VERY_LARGE);
+                }
+                if (frame_left) {
+                    fill_rect(src,
+                              CDEF_BSTRIDE,
+                              vsize + 2 * CDEF_VBORDER,
+                              CDEF_HBORDER,
+                              CDEF_VERY_LARGE);
+                }
+                if (frame_bottom) {
+                    fill_rect(&src[(vsize + CDEF_VBORDER) * CDEF_BSTRIDE],
+                              CDEF_BSTRIDE,
+                              CDEF_VBORDER,
+                              hsize + 2 * CDEF_HBORDER,
+                              CDEF_VERY_LARGE);
+                }
+                if (frame_right) {
+                    fill_rect(&src[hsize + CDEF_HBORDER],
+                              CDEF_BSTRIDE,
+                              vsize + 2 * CDEF_VBORDER,
+                              CDEF_HBORDER,
+                              CDEF_VERY_LARGE);
+                }
+
+                cdef_filter_fb(&rec_buf[pli][rec_stride[pli] * row_offset +
+                                             coffset],
+                               NULL,
+                               rec_stride[pli],
+                               &src[CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER],
+                               dec[pli],
+                               dec[pli],
+                               dir,
+                               NULL,
+                               var,
+                               pli,
+                               dlist,
+                               cdef_count,
+                               level,
+                               sec_strength,
+                               ppcs->cdef_pri_damping,
+                               ppcs->cdef_sec_damping,
+                               coeff_shift);
+            }
+            cdef_left = 1;
+        }
+
+        uint8_t *tmp = prev_row_cdef;
+        prev_row_cdef = curr_row_cdef;
+        curr_row_cdef = tmp;
+    }
+}
+
+}  // namespace svt_av1_test_reference
@@ -0,0 +1,38 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file CdefRef.h
+ *
+ * @brief reference implementation for the CDEF application, including :
+ * - cdef_frame_ref
+ *
+ ******************************************************************************/
+#ifndef _TEST_CDEF_REFERENCE_H_
+#define _TEST_CDEF_REFERENCE_H_
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+
+namespace svt_av1_test_reference {
+
+/** Filters the 8 bit deblocked recon of pcs in place, one 64x64 filter block
+ * row after the other, as the encoder did before the rows were filtered in
+ * parallel: each row saves the deblocked lines its filtering overwrites for
+ * the row below. */
+void cdef_frame_ref(SequenceControlSet *scs, PictureControlSet_t *pcs);
+
+}  // namespace svt_av1_test_reference
+
+#endif  // _TEST_CDEF_REFERENCE_H_
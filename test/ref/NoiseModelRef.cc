@@ -0,0 +1,178 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file NoiseModelRef.cc
+ *
+ * @brief reference implementation for the film grain denoising, including :
+ * - wiener_denoise_2d_ref
+ *
+ ******************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "NoiseModelRef.h"
+#include "noise_model.h"
+#include "noise_util.h"
+
+/* Aligned allocation of the library */
+extern "C" void *aom_memalign(size_t align, size_t size);
+extern "C" void aom_free(void *memblk);
+
+namespace svt_av1_test_reference {
+
+static void pointwise_multiply(const float *a, float *b, int32_t n) {
+    for (int32_t i = 0; i < n; ++i)
+        b[i] *= a[i];
+}
+
+static std::vector<float> get_half_cos_window(int32_t block_size) {
+    const double pi = 3.141592653589793238462643383279502884;
+    std::vector<float> window_function(block_size * block_size);
+
+    for (int32_t y = 0; y < block_size; ++y) {
+        const double cos_yd = cos((.5 + y) * pi / block_size - pi / 2);
+        for (int32_t x = 0; x < block_size; ++x) {
+            const double cos_xd = cos((.5 + x) * pi / block_size - pi / 2);
+            window_function[y * block_size + x] = (float)(cos_yd * cos_xd);
+        }
+    }
+    return window_function;
+}
+
+template <typename Sample>
+static void dither_and_quantize(float *result, int32_t result_stride,
+                                Sample *denoised, int32_t w, int32_t h,
+                                int32_t stride, int32_t chroma_sub_w,
+                                int32_t chroma_sub_h, int32_t block_size,
+                                float block_normalization) {
+    for (int32_t y = 0; y < (h >> chroma_sub_h); ++y) {
+        for (int32_t x = 0; x < (w >> chroma_sub_w); ++x) {
+            const int32_t result_idx =
+                (y + (block_size >> chroma_sub_h)) * result_stride + x +
+                (block_size >> chroma_sub_w);
+            Sample new_val = (Sample)AOMMIN(
+                AOMMAX(result[result_idx] * block_normalization + 0.5f, 0),
+                block_normalization);
+            const float err =
+                -(((float)new_val) / block_normalization - result[result_idx]);
+            denoised[y * stride + x] = new_val;
+            if (x + 1 < (w >> chroma_sub_w))
+                result[result_idx + 1] += err * 7.0f / 16.0f;
+            if (y + 1 < (h >> chroma_sub_h)) {
+                if (x > 0)
+                    result[result_idx + result_stride - 1] +=
+                        err * 3.0f / 16.0f;
+                result[result_idx + result_stride] += err * 5.0f / 16.0f;
+                if (x + 1 < (w >> chroma_sub_w))
+                    result[result_idx + result_stride + 1] +=
+                        err * 1.0f / 16.0f;
+            }
+        }
+    }
+}
+
+int32_t wiener_denoise_2d_ref(const uint8_t *const data[3],
+                              uint8_t *denoised[3], int32_t w, int32_t h,
+                              int32_t stride[3], int32_t chroma_sub[2],
+                              float *noise_psd[3], int32_t block_size,
+                              int32_t bit_depth, int32_t use_highbd) {
+    const int32_t num_blocks_w = (w + block_size - 1) / block_size;
+    const int32_t num_blocks_h = (h + block_size - 1) / block_size;
+    const int32_t result_stride = (num_blocks_w + 2) * block_size;
+    const int32_t result_height = (num_blocks_h + 2) * block_size;
+    const int32_t chroma_block_size = block_size >> chroma_sub[0];
+    const float block_normalization = (float)((1 << bit_depth) - 1);
+    std::vector<float> result(result_height * result_stride);
+    std::vector<float> plane(block_size * block_size);
+    std::vector<double> plane_d(block_size * block_size);
+    std::vector<double> block_d(block_size * block_size);
+    std::vector<float> window_full = get_half_cos_window(block_size);
+    std::vector<float> window_chroma = get_half_cos_window(chroma_block_size);
+    float *block = (float *)aom_memalign(
+        32, 2 * block_size * block_size * sizeof(*block));
+    struct aom_noise_tx_t *tx_full = aom_noise_tx_malloc(block_size);
+    struct aom_noise_tx_t *tx_chroma = aom_noise_tx_malloc(chroma_block_size);
+    aom_flat_block_finder_t block_finder_full;
+    aom_flat_block_finder_t block_finder_chroma;
+    int32_t init_success = chroma_sub[0] == chroma_sub[1] && block &&
+                           tx_full && tx_chroma;
+
+    init_success &= aom_flat_block_finder_init(
+        &block_finder_full, block_size, bit_depth, use_highbd);
+    init_success &= aom_flat_block_finder_init(
+        &block_finder_chroma, chroma_block_size, bit_depth, use_highbd);
+
+    for (int32_t c = init_success ? 0 : 3; c < 3; ++c) {
+        const int32_t chroma_sub_w = c > 0 ? chroma_sub[0] : 0;
+        const int32_t chroma_sub_h = c > 0 ? chroma_sub[1] : 0;
+        const int32_t size = block_size >> chroma_sub_w;
+        const int32_t pixels_per_block = size * size;
+        const float *window_function =
+            c > 0 ? window_chroma.data() : window_full.data();
+        aom_flat_block_finder_t *block_finder =
+            c > 0 ? &block_finder_chroma : &block_finder_full;
+        struct aom_noise_tx_t *tx = c > 0 ? tx_chroma : tx_full;
+
+        memset(result.data(), 0, sizeof(float) * result.size());
+        // Half overlapped blocks, the boundary padded with a block
+        for (int32_t offsy = 0; offsy < size; offsy += size / 2) {
+            for (int32_t offsx = 0; offsx < size; offsx += size / 2) {
+                for (int32_t by = -1; by < num_blocks_h; ++by) {
+                    for (int32_t bx = -1; bx < num_blocks_w; ++bx) {
+                        aom_flat_block_finder_extract_block(
+                            block_finder, data[c], w >> chroma_sub_w,
+                            h >> chroma_sub_h, stride[c],
+                            bx * size + offsx, by * size + offsy,
+                            plane_d.data(), block_d.data());
+                        for (int32_t j = 0; j < pixels_per_block; ++j) {
+                            block[j] = (float)block_d[j];
+                            plane[j] = (float)plane_d[j];
+                        }
+                        pointwise_multiply(
+                            window_function, block, pixels_per_block);
+                        aom_noise_tx_forward(tx, block);
+                        aom_noise_tx_filter(tx, noise_psd[c]);
+                        aom_noise_tx_inverse(tx, block);
+                        pointwise_multiply(
+                            window_function, plane.data(), pixels_per_block);
+
+                        for (int32_t y = 0; y < size; ++y) {
+                            const int32_t y_result =
+                                y + (by + 1) * size + offsy;
+                            for (int32_t x = 0; x < size; ++x) {
+                                const int32_t x_result =
+                                    x + (bx + 1) * size + offsx;
+                                result[y_result * result_stride + x_result] +=
+                                    (block[y * size + x] + plane[y * size + x]) *
+                                    window_function[y * size + x];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        if (use_highbd) {
+            dither_and_quantize(result.data(), result_stride,
+                                (uint16_t *)denoised[c], w, h, stride[c],
+                                chroma_sub_w, chroma_sub_h, block_size,
+                                block_normalization);
+        } else {
+            dither_and_quantize(result.data(), result_stride, denoised[c], w,
+                                h, stride[c], chroma_sub_w, chroma_sub_h,
+                                block_size, block_normalization);
+        }
+    }
+
+    aom_flat_block_finder_free(&block_finder_full);
+    aom_flat_block_finder_free(&block_finder_chroma);
+    aom_noise_tx_free(tx_full);
+    aom_noise_tx_free(tx_chroma);
+    aom_free(block);
+    return init_success;
+}
+
+}  // namespace svt_av1_test_reference
@@ -0,0 +1,41 @@
+/*
+ * Copyright(c) 2019 Netflix, Inc.
+ * SPDX - License - Identifier: BSD - 2 - Clause - Patent
+ */
+
+/******************************************************************************
+ * @file NoiseModelRef.h
+ *
+ * @brief reference implementation for the film grain denoising, including :
+ * - wiener_denoise_2d_ref
+ *
+ ******************************************************************************/
+#ifndef _TEST_NOISE_MODEL_REFERENCE_H_
+#define _TEST_NOISE_MODEL_REFERENCE_H_
+
+// Workaround to eliminate the compiling warning on linux
+// The macro will conflict with definition in gtest.h
+#ifdef __USE_GNU
+#undef __USE_GNU  // defined in EbThreads.h
+#endif
+#ifdef _GNU_SOURCE
+#undef _GNU_SOURCE  // defined in EbThreads.h
+#endif
+
+#include "EbDefinitions.h"
+
+namespace svt_av1_test_reference {
+
+/** Denoises the planes of data into denoised as aom_wiener_denoise_2d did
+ * before the block rows were split: a plane at a time, the half overlapped
+ * blocks of each offset one block row after the other, with the buffers
+ * allocated once for the picture. */
+int32_t wiener_denoise_2d_ref(const uint8_t *const data[3],
+                              uint8_t *denoised[3], int32_t w, int32_t h,
+                              int32_t stride[3], int32_t chroma_sub[2],
+                              float *noise_psd[3], int32_t block_size,
+                              int32_t bit_depth, int32_t use_highbd);
+
+}  // namespace svt_av1_test_reference
+
+#endif  // _TEST_NOISE_MODEL_REFERENCE_H_